@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Heap allocations made by the process so far, counted by the global
+ * operator new replacements in allocation_counter.cpp. Benchmarks that link
+ * that file report the difference across their loop as allocs/op.
+ */
+uint64_t allocation_count();
@@ -0,0 +1,134 @@
+#include "allocation_counter.hpp"
+#include "coinbase_dtc_core/exchanges/coinbase/coinbase_feed.hpp"
+#include "coinbase_dtc_core/core/util/advanced_log.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace open_dtc_server::exchanges;
+
+namespace
+{
+    using MessagesByType = std::map<std::string, std::vector<std::string>>;
+
+    /**
+     * Load JSON lines, optionally prefixed with "<time_us>\t" as written by
+     * SSLWebSocketClient::start_capture, grouped by their "type" field.
+     * "all" keeps every message in capture order.
+     */
+    bool load_messages(const std::string &path, MessagesByType &messages)
+    {
+        std::ifstream file(path);
+        if (!file)
+            return false;
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            size_t tab = line.find('\t');
+            if (tab != std::string::npos && !line.empty() && line[0] != '{')
+                line.erase(0, tab + 1);
+            if (line.empty() || line[0] != '{')
+                continue;
+
+            // Cheap type sniff; the benchmark is about the handlers, not the loader
+            std::string type = "other";
+            size_t key = line.find("\"type\":\"");
+            if (key != std::string::npos)
+            {
+                size_t start = key + 8;
+                type = line.substr(start, line.find('"', start) - start);
+            }
+            messages[type].push_back(line);
+            messages["all"].push_back(line);
+        }
+        return !messages.empty();
+    }
+
+    base::ExchangeConfig bench_config()
+    {
+        base::ExchangeConfig config;
+        config.name = "coinbase";
+        return config;
+    }
+
+    /** Runs one group through CoinbaseFeed::on_websocket_message_received per iteration */
+    void run_messages(benchmark::State &state, const std::vector<std::string> &messages,
+                      const std::vector<std::string> &snapshots)
+    {
+        coinbase::CoinbaseFeed feed(bench_config());
+
+        uint64_t events = 0;
+        feed.set_trade_callback([&events](const base::MarketTrade &)
+                                { events++; });
+        feed.set_level2_callback([&events](const base::MarketLevel2 &)
+                                 { events++; });
+        feed.set_depth_callback([&events](const base::MarketDepthUpdate &)
+                                { events++; });
+
+        // Books exist before incremental updates arrive, as on a live connection
+        for (const auto &snapshot : snapshots)
+            feed.inject_websocket_message(snapshot);
+        events = 0;
+
+        uint64_t bytes = 0;
+        uint64_t allocations = allocation_count();
+        for (auto _ : state)
+        {
+            for (const auto &message : messages)
+            {
+                feed.inject_websocket_message(message);
+                bytes += message.size();
+            }
+        }
+        allocations = allocation_count() - allocations;
+
+        uint64_t processed = state.iterations() * messages.size();
+        state.SetItemsProcessed(static_cast<int64_t>(processed));
+        state.SetBytesProcessed(static_cast<int64_t>(bytes));
+        state.counters["allocs/msg"] = benchmark::Counter(static_cast<double>(allocations) / static_cast<double>(processed));
+        state.counters["events/msg"] = benchmark::Counter(static_cast<double>(events) / static_cast<double>(processed));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    // Handlers log heartbeats and subscriptions at INFO; keep the report readable
+    open_dtc_server::util::Logger::getInstance().setLogLevel(open_dtc_server::util::LogLevel::LOG_WARN);
+
+    // COINBASE_CAPTURE points at a raw capture (server --capture) instead of the bundled fixture
+    const char *capture = std::getenv("COINBASE_CAPTURE");
+    std::string path = capture ? capture : std::string(BENCH_FIXTURE_DIR) + "/coinbase_feed.jsonl";
+
+    static MessagesByType messages;
+    if (!load_messages(path, messages))
+    {
+        std::cerr << "No messages loaded from " << path << std::endl;
+        return 1;
+    }
+    std::cerr << "Loaded " << messages["all"].size() << " messages from " << path << std::endl;
+
+    static const std::vector<std::string> snapshots = messages.count("snapshot") ? messages["snapshot"] : std::vector<std::string>();
+    static const std::vector<std::string> none;
+    for (const auto &group : messages)
+    {
+        const std::string &type = group.first;
+        // Snapshot and mixed runs start from an empty feed; incremental types start from the snapshots
+        const auto &preload = (type == "snapshot" || type == "all") ? none : snapshots;
+        benchmark::RegisterBenchmark(("BM_CoinbaseFeedMessage/" + type).c_str(),
+                                     [&group, &preload](benchmark::State &state)
+                                     { run_messages(state, group.second, preload); });
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
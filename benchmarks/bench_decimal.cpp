@@ -0,0 +1,152 @@
+#include "coinbase_dtc_core/exchanges/base/decimal.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace open_dtc_server::exchanges::base;
+
+namespace
+{
+    /**
+     * Every quoted decimal ("43250.12", "0.015") in a capture: prices and sizes
+     * from matches, tickers, l2update changes and snapshots, in capture order.
+     */
+    std::vector<std::string> load_decimals(const std::string &path)
+    {
+        std::vector<std::string> decimals;
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            size_t pos = 0;
+            while ((pos = line.find('"', pos)) != std::string::npos)
+            {
+                size_t end = line.find('"', pos + 1);
+                if (end == std::string::npos)
+                    break;
+
+                std::string token = line.substr(pos + 1, end - pos - 1);
+                bool numeric = !token.empty() && token.find_first_not_of("0123456789.") == std::string::npos &&
+                               token.find('.') != std::string::npos;
+                if (numeric)
+                    decimals.push_back(std::move(token));
+                pos = end + 1;
+            }
+        }
+        return decimals;
+    }
+
+    std::vector<std::string> &decimals()
+    {
+        static std::vector<std::string> values;
+        return values;
+    }
+
+    void finish(benchmark::State &state)
+    {
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * decimals().size()));
+    }
+}
+
+static void BM_Stod(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        double sum = 0.0;
+        for (const auto &text : decimals())
+            sum += std::stod(text);
+        benchmark::DoNotOptimize(sum);
+    }
+    finish(state);
+}
+BENCHMARK(BM_Stod);
+
+static void BM_Strtod(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        double sum = 0.0;
+        for (const auto &text : decimals())
+            sum += std::strtod(text.c_str(), nullptr);
+        benchmark::DoNotOptimize(sum);
+    }
+    finish(state);
+}
+BENCHMARK(BM_Strtod);
+
+static void BM_FromChars(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        double sum = 0.0;
+        for (const auto &text : decimals())
+        {
+            double value = 0.0;
+            std::from_chars(text.data(), text.data() + text.size(), value);
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    finish(state);
+}
+BENCHMARK(BM_FromChars);
+
+static void BM_ParseDecimal(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        double sum = 0.0;
+        for (const auto &text : decimals())
+        {
+            double value = 0.0;
+            decimal::parse_decimal(text, value);
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    finish(state);
+}
+BENCHMARK(BM_ParseDecimal);
+
+static void BM_ParseFixed(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        int64_t sum = 0;
+        for (const auto &text : decimals())
+        {
+            int64_t value = 0;
+            decimal::parse_fixed(text, 8, value);
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    finish(state);
+}
+BENCHMARK(BM_ParseFixed);
+
+int main(int argc, char **argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    // COINBASE_CAPTURE points at a raw capture (server --capture) instead of the bundled fixture
+    const char *capture = std::getenv("COINBASE_CAPTURE");
+    std::string path = capture ? capture : std::string(BENCH_FIXTURE_DIR) + "/coinbase_feed.jsonl";
+
+    decimals() = load_decimals(path);
+    if (decimals().empty())
+    {
+        std::cerr << "No decimals loaded from " << path << std::endl;
+        return 1;
+    }
+    std::cerr << "Loaded " << decimals().size() << " decimals from " << path << std::endl;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,423 @@
+#include "allocation_counter.hpp"
+#include "coinbase_dtc_core/core/dtc/protocol.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+using namespace open_dtc_server::core::dtc;
+
+namespace
+{
+    // Representative field values, matching what the server and clients put on the wire
+
+    void fill(LogonRequest &message)
+    {
+        message.username = "loadtest";
+        message.client_name = "bench_dtc_protocol";
+        message.heartbeat_interval_in_seconds = 10;
+    }
+
+    void fill(LogonResponse &message)
+    {
+        message.result = 1;
+        message.server_name = "Open DTC Server";
+    }
+
+    void fill(Heartbeat &message)
+    {
+        message.current_date_time = 1700000000;
+    }
+
+    void fill(MarketDataRequest &message)
+    {
+        message.symbol_id = 1;
+        message.symbol = "BTC-USD";
+        message.exchange = "coinbase";
+    }
+
+    void fill(MarketDataResponse &message)
+    {
+        message.symbol_id = 1;
+        message.symbol = "BTC-USD";
+        message.exchange = "coinbase";
+    }
+
+    void fill(MarketDataReject &message)
+    {
+        message.symbol_id = 1;
+        message.reject_text = "Symbol not available on this exchange";
+    }
+
+    void fill(MarketDataUpdateTrade &message)
+    {
+        message.symbol_id = 1;
+        message.at_bid_or_ask = 1;
+        message.price = 65432.51;
+        message.volume = 0.025;
+        message.date_time = 1700000000;
+    }
+
+    void fill(MarketDataUpdateBidAsk &message)
+    {
+        message.symbol_id = 1;
+        message.bid_price = 65432.50;
+        message.bid_quantity = 1.25f;
+        message.ask_price = 65432.51;
+        message.ask_quantity = 0.75f;
+        message.date_time = 1700000000;
+    }
+
+    void fill(MarketDepthSnapshot &message)
+    {
+        message.symbol_id = 1;
+        message.side = 1;
+        message.level = 3;
+        message.price = 65430.00;
+        message.quantity = 2.5;
+        message.date_time = 1700000000;
+    }
+
+    void fill(MarketDepthIncrementalUpdate &message)
+    {
+        message.symbol_id = 1;
+        message.side = 2;
+        message.position = 0;
+        message.update_type = static_cast<uint8_t>(DepthUpdateTypeEnum::DEPTH_UPDATE);
+        message.price = 65432.51;
+        message.size = 0.5;
+        message.date_time = 1700000000;
+    }
+
+    void fill(MarketDataSnapshot &message)
+    {
+        message.symbol_id = 1;
+        message.session_open_price = 65000.0;
+        message.session_high_price = 65500.0;
+        message.session_low_price = 64800.0;
+        message.session_volume = 1234.5;
+        message.session_num_trades = 4321;
+        message.bid_price = 65432.50;
+        message.ask_price = 65432.51;
+        message.bid_quantity = 1.25;
+        message.ask_quantity = 0.75;
+        message.last_trade_price = 65432.50;
+        message.last_trade_volume = 0.025;
+        message.last_trade_date_time = 1700000000;
+        message.trading_session_date = 1699920000;
+    }
+
+    void fill(MarketDataUpdateSessionHigh &message)
+    {
+        message.symbol_id = 1;
+        message.price = 65500.0;
+        message.trading_session_date = 1699920000;
+    }
+
+    void fill(MarketDataUpdateSessionVolume &message)
+    {
+        message.symbol_id = 1;
+        message.volume = 1234.5;
+        message.trading_session_date = 1699920000;
+    }
+
+    void fill(SubmitNewSingleOrder &message)
+    {
+        message.symbol = "BTC-USD";
+        message.exchange = "coinbase";
+        message.trade_account = "default";
+        message.client_order_id = "order-1";
+        message.order_type = OrderTypeEnum::ORDER_TYPE_LIMIT;
+        message.buy_sell = BuySellEnum::BUY;
+        message.price1 = 65432.50;
+        message.quantity = 0.025;
+        message.time_in_force = TimeInForceEnum::TIF_GOOD_TILL_CANCELED;
+    }
+
+    void fill(OrderUpdate &message)
+    {
+        message.total_num_messages = 1;
+        message.message_number = 1;
+        message.symbol = "BTC-USD";
+        message.exchange = "coinbase";
+        message.server_order_id = "dtc-1700000000-1";
+        message.client_order_id = "order-1";
+        message.exchange_order_id = "0000-000000-000000";
+        message.order_status = OrderStatusEnum::ORDER_STATUS_OPEN;
+        message.order_type = OrderTypeEnum::ORDER_TYPE_LIMIT;
+        message.buy_sell = BuySellEnum::BUY;
+        message.price1 = 65432.50;
+        message.order_quantity = 0.025;
+        message.remaining_quantity = 0.025;
+        message.order_received_date_time = 1700000000;
+        message.trade_account = "default";
+    }
+
+    void fill(HistoricalPriceDataRequest &message)
+    {
+        message.request_id = 7;
+        message.symbol = "BTC-USD";
+        message.exchange = "coinbase";
+        message.record_interval = 60;
+        message.max_days_to_return = 30;
+    }
+
+    void fill(HistoricalPriceDataResponseHeader &message)
+    {
+        message.request_id = 7;
+        message.record_interval = 60;
+    }
+
+    void fill(HistoricalPriceDataReject &message)
+    {
+        message.request_id = 7;
+        message.reject_reason_code = 2;
+        message.reject_text = "No historical data for this symbol";
+    }
+
+    void fill(HistoricalPriceDataRecordResponse &message)
+    {
+        message.request_id = 7;
+        message.start_date_time = 1700000000000000;
+        message.open_price = 65400.0;
+        message.high_price = 65500.0;
+        message.low_price = 65350.0;
+        message.last_price = 65432.51;
+        message.volume = 12.5;
+        message.num_trades = 420;
+    }
+
+    void fill(HistoricalPriceDataTickRecordResponse &message)
+    {
+        message.request_id = 7;
+        message.date_time = 1700000000.125;
+        message.at_bid_or_ask = 2;
+        message.price = 65432.51;
+        message.volume = 0.025;
+    }
+
+    void fill(PositionUpdate &message)
+    {
+        message.trade_account = "coinbase-main";
+        message.symbol = "BTC-USD";
+        message.quantity = 0.5;
+        message.average_price = 61000.0;
+        message.position_identifier = "BTC-USD-LONG";
+    }
+
+    void fill(SecurityDefinitionForSymbolRequest &message)
+    {
+        message.request_id = 9;
+        message.symbol = "BTC-USD";
+        message.exchange = "coinbase";
+        message.product_type = "SPOT";
+    }
+
+    void fill(SecurityDefinitionResponse &message)
+    {
+        Protocol protocol;
+        message = *protocol.create_security_definition_response(9, "BTC-USD", "coinbase");
+        message.display_name = "Bitcoin / USD";
+        message.base_currency = "BTC";
+        message.quote_currency = "USD";
+    }
+
+    template <typename Message>
+    Message make_message()
+    {
+        Message message;
+        fill(message);
+        return message;
+    }
+
+    void report(benchmark::State &state, uint64_t bytes, uint64_t allocations)
+    {
+        state.SetBytesProcessed(static_cast<int64_t>(bytes));
+        state.counters["bytes/op"] = benchmark::Counter(static_cast<double>(bytes), benchmark::Counter::kAvgIterations);
+        state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+    }
+
+    /**
+     * Market data heavy stream in the proportions the server sends:
+     * mostly depth updates, then trades and top of book, with the odd
+     * snapshot level and control message.
+     */
+    std::vector<uint8_t> make_stream(size_t count, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> pick(0, 99);
+
+        std::vector<uint8_t> stream;
+        for (size_t i = 0; i < count; ++i)
+        {
+            int roll = pick(rng);
+            std::vector<uint8_t> bytes;
+            if (roll < 60)
+                bytes = make_message<MarketDepthIncrementalUpdate>().serialize();
+            else if (roll < 80)
+                bytes = make_message<MarketDataUpdateTrade>().serialize();
+            else if (roll < 95)
+                bytes = make_message<MarketDataUpdateBidAsk>().serialize();
+            else if (roll < 98)
+                bytes = make_message<MarketDepthSnapshot>().serialize();
+            else
+                bytes = make_message<MarketDataResponse>().serialize();
+            stream.insert(stream.end(), bytes.begin(), bytes.end());
+        }
+        return stream;
+    }
+}
+
+template <typename Message>
+static void BM_Serialize(benchmark::State &state)
+{
+    const Message message = make_message<Message>();
+    uint64_t bytes = 0;
+    uint64_t allocations = allocation_count();
+    for (auto _ : state)
+    {
+        auto buffer = message.serialize();
+        bytes += buffer.size();
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    report(state, bytes, allocation_count() - allocations);
+}
+
+template <typename Message>
+static void BM_Deserialize(benchmark::State &state)
+{
+    const auto buffer = make_message<Message>().serialize();
+    Message message;
+    uint64_t bytes = 0;
+    uint64_t allocations = allocation_count();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(message.deserialize(buffer.data(), static_cast<uint16_t>(buffer.size())));
+        benchmark::ClobberMemory();
+        bytes += buffer.size();
+    }
+    report(state, bytes, allocation_count() - allocations);
+}
+
+#define DTC_CODEC_BENCHMARKS(Message)            \
+    BENCHMARK_TEMPLATE(BM_Serialize, Message);   \
+    BENCHMARK_TEMPLATE(BM_Deserialize, Message);
+
+DTC_CODEC_BENCHMARKS(LogonRequest)
+DTC_CODEC_BENCHMARKS(LogonResponse)
+DTC_CODEC_BENCHMARKS(Heartbeat)
+DTC_CODEC_BENCHMARKS(MarketDataRequest)
+DTC_CODEC_BENCHMARKS(MarketDataResponse)
+DTC_CODEC_BENCHMARKS(MarketDataReject)
+DTC_CODEC_BENCHMARKS(MarketDataUpdateTrade)
+DTC_CODEC_BENCHMARKS(MarketDataUpdateBidAsk)
+DTC_CODEC_BENCHMARKS(MarketDepthSnapshot)
+DTC_CODEC_BENCHMARKS(MarketDepthIncrementalUpdate)
+DTC_CODEC_BENCHMARKS(MarketDataSnapshot)
+DTC_CODEC_BENCHMARKS(MarketDataUpdateSessionHigh)
+DTC_CODEC_BENCHMARKS(MarketDataUpdateSessionVolume)
+DTC_CODEC_BENCHMARKS(SubmitNewSingleOrder)
+DTC_CODEC_BENCHMARKS(OrderUpdate)
+DTC_CODEC_BENCHMARKS(HistoricalPriceDataRequest)
+DTC_CODEC_BENCHMARKS(HistoricalPriceDataResponseHeader)
+DTC_CODEC_BENCHMARKS(HistoricalPriceDataReject)
+DTC_CODEC_BENCHMARKS(HistoricalPriceDataRecordResponse)
+DTC_CODEC_BENCHMARKS(HistoricalPriceDataTickRecordResponse)
+DTC_CODEC_BENCHMARKS(PositionUpdate)
+DTC_CODEC_BENCHMARKS(SecurityDefinitionForSymbolRequest)
+DTC_CODEC_BENCHMARKS(SecurityDefinitionResponse)
+
+static void BM_ParseMixedStream(benchmark::State &state)
+{
+    const auto stream = make_stream(static_cast<size_t>(state.range(0)), 42);
+    Protocol protocol;
+    uint64_t messages = 0;
+    uint64_t allocations = allocation_count();
+    for (auto _ : state)
+    {
+        // Framed the same way the server's receive loop walks its buffer
+        size_t offset = 0;
+        while (offset + sizeof(MessageHeader) <= stream.size())
+        {
+            uint16_t size = reinterpret_cast<const MessageHeader *>(stream.data() + offset)->size;
+            auto message = protocol.parse_message(stream.data() + offset, size);
+            benchmark::DoNotOptimize(message.get());
+            offset += size;
+            ++messages;
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(messages));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * stream.size()));
+    state.counters["bytes/op"] = benchmark::Counter(static_cast<double>(state.iterations() * stream.size()),
+                                                    benchmark::Counter::kAvgIterations);
+    state.counters["allocs/msg"] = benchmark::Counter(static_cast<double>(allocation_count() - allocations) /
+                                                      static_cast<double>(messages ? messages : 1));
+}
+BENCHMARK(BM_ParseMixedStream)->Arg(1000)->Arg(100000);
+
+static void BM_CreateMessage(benchmark::State &state)
+{
+    Protocol protocol;
+    auto trade = protocol.create_trade_update(1, 65432.51, 0.025, Protocol::get_current_timestamp());
+    uint64_t bytes = 0;
+    uint64_t allocations = allocation_count();
+    for (auto _ : state)
+    {
+        auto buffer = protocol.create_message(*trade);
+        bytes += buffer.size();
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    report(state, bytes, allocation_count() - allocations);
+}
+BENCHMARK(BM_CreateMessage);
+
+static void BM_CreateTradeUpdateMessage(benchmark::State &state)
+{
+    // Factory plus serialization, as the server does for every broadcast trade
+    Protocol protocol;
+    uint64_t bytes = 0;
+    uint64_t allocations = allocation_count();
+    for (auto _ : state)
+    {
+        auto trade = protocol.create_trade_update(1, 65432.51, 0.025, 1700000000);
+        auto buffer = protocol.create_message(*trade);
+        bytes += buffer.size();
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    report(state, bytes, allocation_count() - allocations);
+}
+BENCHMARK(BM_CreateTradeUpdateMessage);
+
+static void BM_WriteDtcString(benchmark::State &state)
+{
+    const std::string value(static_cast<size_t>(state.range(0)), 'x');
+    std::vector<uint8_t> buffer;
+    buffer.reserve(value.size() + 1);
+    uint64_t bytes = 0;
+    uint64_t allocations = allocation_count();
+    for (auto _ : state)
+    {
+        buffer.clear();
+        Protocol::write_dtc_string(buffer, value);
+        bytes += buffer.size();
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    report(state, bytes, allocation_count() - allocations);
+}
+BENCHMARK(BM_WriteDtcString)->Arg(7)->Arg(64);
+
+static void BM_ReadDtcString(benchmark::State &state)
+{
+    std::vector<uint8_t> buffer;
+    Protocol::write_dtc_string(buffer, std::string(static_cast<size_t>(state.range(0)), 'x'));
+    uint64_t bytes = 0;
+    uint64_t allocations = allocation_count();
+    for (auto _ : state)
+    {
+        uint16_t offset = 0;
+        auto value = Protocol::read_dtc_string(buffer.data(), offset, static_cast<uint16_t>(buffer.size()));
+        bytes += offset;
+        benchmark::DoNotOptimize(value.data());
+    }
+    report(state, bytes, allocation_count() - allocations);
+}
+BENCHMARK(BM_ReadDtcString)->Arg(7)->Arg(64);
@@ -0,0 +1,189 @@
+#include "coinbase_dtc_core/exchanges/coinbase/permessage_deflate.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+using namespace open_dtc_server::feed::coinbase;
+
+namespace
+{
+    using Payload = std::vector<uint8_t>;
+
+    struct Corpus
+    {
+        std::vector<std::string> messages;
+        std::vector<Payload> independent; // server_no_context_takeover
+        std::vector<Payload> takeover;    // One compressor for the whole session
+        size_t plain_bytes = 0;
+        size_t independent_bytes = 0;
+        size_t takeover_bytes = 0;
+    };
+
+    Corpus &corpus()
+    {
+        static Corpus value;
+        return value;
+    }
+
+    // As a permessage-deflate server sends it: sync flush, 00 00 ff ff stripped
+    std::vector<Payload> compress_all(const std::vector<std::string> &messages, bool takeover, size_t &bytes)
+    {
+        z_stream stream{};
+        deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+        std::vector<Payload> out;
+        bytes = 0;
+        for (const auto &message : messages)
+        {
+            if (!takeover)
+                deflateReset(&stream);
+            Payload payload(deflateBound(&stream, message.size()) + 16);
+            stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(message.data()));
+            stream.avail_in = static_cast<uInt>(message.size());
+            stream.next_out = payload.data();
+            stream.avail_out = static_cast<uInt>(payload.size());
+            deflate(&stream, Z_SYNC_FLUSH);
+            payload.resize(payload.size() - stream.avail_out - 4);
+            bytes += payload.size();
+            out.push_back(std::move(payload));
+        }
+        deflateEnd(&stream);
+        return out;
+    }
+
+    // What SSLWebSocketClient did before: a new stream and a new string for every message
+    std::string inflate_per_message(const Payload &compressed)
+    {
+        z_stream stream = {};
+        stream.next_in = const_cast<Bytef *>(compressed.data());
+        stream.avail_in = static_cast<uInt>(compressed.size());
+        if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+            return "";
+
+        std::string result;
+        char buffer[4096];
+        do
+        {
+            stream.next_out = reinterpret_cast<Bytef *>(buffer);
+            stream.avail_out = sizeof(buffer);
+            int ret = inflate(&stream, Z_NO_FLUSH);
+            if (ret == Z_STREAM_ERROR || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR)
+            {
+                inflateEnd(&stream);
+                return "";
+            }
+            result.append(buffer, sizeof(buffer) - stream.avail_out);
+        } while (stream.avail_out == 0);
+
+        inflateEnd(&stream);
+        return result;
+    }
+
+    void finish(benchmark::State &state, size_t wire_bytes)
+    {
+        const auto &c = corpus();
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * c.messages.size()));
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * c.plain_bytes));
+        state.counters["wire_bytes/msg"] = static_cast<double>(wire_bytes) / static_cast<double>(c.messages.size());
+        state.counters["ratio"] = static_cast<double>(c.plain_bytes) / static_cast<double>(wire_bytes);
+    }
+}
+
+static void BM_InflatePerMessageInit(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        size_t total = 0;
+        for (const auto &payload : corpus().independent)
+            total += inflate_per_message(payload).size();
+        benchmark::DoNotOptimize(total);
+    }
+    finish(state, corpus().independent_bytes);
+}
+BENCHMARK(BM_InflatePerMessageInit);
+
+static void BM_InflaterNoContextTakeover(benchmark::State &state)
+{
+    Inflater inflater;
+    DeflateParameters parameters;
+    parameters.server_no_context_takeover = true;
+    inflater.start(parameters);
+    std::string out;
+    for (auto _ : state)
+    {
+        size_t total = 0;
+        for (const auto &payload : corpus().independent)
+        {
+            inflater.inflate(payload.data(), payload.size(), out);
+            total += out.size();
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    finish(state, corpus().independent_bytes);
+}
+BENCHMARK(BM_InflaterNoContextTakeover);
+
+static void BM_InflaterContextTakeover(benchmark::State &state)
+{
+    Inflater inflater;
+    std::string out;
+    for (auto _ : state)
+    {
+        // The session has to be inflated from its first message
+        inflater.start(DeflateParameters());
+        size_t total = 0;
+        for (const auto &payload : corpus().takeover)
+        {
+            inflater.inflate(payload.data(), payload.size(), out);
+            total += out.size();
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    finish(state, corpus().takeover_bytes);
+}
+BENCHMARK(BM_InflaterContextTakeover);
+
+int main(int argc, char **argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    // COINBASE_CAPTURE points at a raw capture (server --capture) instead of the bundled fixture
+    const char *capture = std::getenv("COINBASE_CAPTURE");
+    std::string path = capture ? capture : std::string(BENCH_FIXTURE_DIR) + "/coinbase_feed.jsonl";
+
+    auto &c = corpus();
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        // Capture lines are "<receive time>\t<payload>"
+        size_t tab = line.find('\t');
+        if (tab != std::string::npos && line.find('{') > tab)
+            line.erase(0, tab + 1);
+        if (line.empty())
+            continue;
+        c.plain_bytes += line.size();
+        c.messages.push_back(std::move(line));
+    }
+    if (c.messages.empty())
+    {
+        std::cerr << "No messages loaded from " << path << std::endl;
+        return 1;
+    }
+
+    c.independent = compress_all(c.messages, false, c.independent_bytes);
+    c.takeover = compress_all(c.messages, true, c.takeover_bytes);
+    std::cerr << "Loaded " << c.messages.size() << " messages (" << c.plain_bytes << " bytes) from " << path
+              << "; on the wire: " << c.independent_bytes << " bytes without context takeover, "
+              << c.takeover_bytes << " with" << std::endl;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include "coinbase_dtc_core/exchanges/base/order_book.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace open_dtc_server::exchanges::base;
+
+namespace
+{
+    struct BookChange
+    {
+        BookSide side;
+        double price;
+        double size;
+    };
+
+    /**
+     * Deterministic stand-in for a recorded level2 session: a drifting mid price,
+     * most changes within a few ticks of the touch, and roughly a third removals.
+     */
+    std::vector<BookChange> make_replay(size_t count, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::exponential_distribution<double> distance(0.15);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+        const double tick = 0.01;
+        double mid = 30000.0;
+
+        std::vector<BookChange> replay;
+        replay.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (unit(rng) < 0.05)
+                mid += (unit(rng) < 0.5 ? -tick : tick);
+
+            BookChange change;
+            change.side = unit(rng) < 0.5 ? BookSide::BID : BookSide::ASK;
+            double ticks = 1.0 + std::floor(distance(rng));
+            change.price = std::round((change.side == BookSide::BID ? mid - ticks * tick : mid + ticks * tick) / tick) * tick;
+            change.size = unit(rng) < 0.35 ? 0.0 : 0.001 + unit(rng) * 2.0;
+            replay.push_back(change);
+        }
+        return replay;
+    }
+
+    OrderBook make_book(size_t levels_per_side)
+    {
+        OrderBook book;
+        std::vector<PriceLevel> bids, asks;
+        for (size_t i = 1; i <= levels_per_side; ++i)
+        {
+            bids.emplace_back(30000.0 - i * 0.01, 1.0);
+            asks.emplace_back(30000.0 + i * 0.01, 1.0);
+        }
+        book.load(BookSide::BID, std::move(bids));
+        book.load(BookSide::ASK, std::move(asks));
+        return book;
+    }
+}
+
+static void BM_OrderBookReplay(benchmark::State &state)
+{
+    auto replay = make_replay(1 << 16, 42);
+    OrderBook seed_book = make_book(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        OrderBook book = seed_book;
+        state.ResumeTiming();
+
+        for (const auto &change : replay)
+            benchmark::DoNotOptimize(book.apply(change.side, change.price, change.size));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * replay.size()));
+}
+BENCHMARK(BM_OrderBookReplay)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void BM_OrderBookApplyDelta(benchmark::State &state)
+{
+    auto replay = make_replay(1 << 16, 42);
+    OrderBook seed_book = make_book(static_cast<size_t>(state.range(0)));
+
+    // Deltas recorded from a source book, replayed into a mirror as the DTC layer does
+    std::vector<BookDelta> deltas;
+    OrderBook source = seed_book;
+    for (const auto &change : replay)
+    {
+        auto delta = source.apply(change.side, change.price, change.size);
+        if (delta.type != BookDelta::Type::NONE)
+            deltas.push_back(delta);
+    }
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        OrderBook mirror = seed_book;
+        state.ResumeTiming();
+
+        for (const auto &delta : deltas)
+            benchmark::DoNotOptimize(mirror.apply_delta(delta));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * deltas.size()));
+}
+BENCHMARK(BM_OrderBookApplyDelta)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void BM_OrderBookTopOfBook(benchmark::State &state)
+{
+    OrderBook book = make_book(10000);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(book.best_bid());
+        benchmark::DoNotOptimize(book.best_ask());
+    }
+}
+BENCHMARK(BM_OrderBookTopOfBook);
+
+static void BM_OrderBookDepthQuery(benchmark::State &state)
+{
+    OrderBook book = make_book(10000);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(book.get_depth(BookSide::BID, static_cast<size_t>(state.range(0))));
+}
+BENCHMARK(BM_OrderBookDepthQuery)->Arg(10)->Arg(100);
+
+static void BM_OrderBookSnapshotLoad(benchmark::State &state)
+{
+    std::vector<PriceLevel> levels;
+    std::mt19937 rng(7);
+    for (int64_t i = 0; i < state.range(0); ++i)
+        levels.emplace_back(30000.0 - i * 0.01, 1.0);
+    std::shuffle(levels.begin(), levels.end(), rng);
+
+    for (auto _ : state)
+    {
+        OrderBook book;
+        book.load(BookSide::BID, levels);
+        benchmark::DoNotOptimize(book.best_bid());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_OrderBookSnapshotLoad)->Arg(1000)->Arg(30000);
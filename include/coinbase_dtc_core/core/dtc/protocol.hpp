@@ -27,6 +27,7 @@ namespace open_dtc_server
                 DISCONNECT_FROM_SERVER_NO_RECONNECT = 6,
 
                 // Market Data Messages
+                MARKET_DATA_FEED_STATUS = 100,
                 MARKET_DATA_REQUEST = 101,
                 MARKET_DATA_RESPONSE = 102,
                 MARKET_DATA_REJECT = 103,
@@ -68,6 +69,13 @@ namespace open_dtc_server
                 SYMBOL_SEARCH_REQUEST = 503,
                 SYMBOL_SEARCH_RESPONSE = 504,
 
+                // Historical Price Data Messages
+                HISTORICAL_PRICE_DATA_REQUEST = 800,
+                HISTORICAL_PRICE_DATA_RESPONSE_HEADER = 801,
+                HISTORICAL_PRICE_DATA_REJECT = 802,
+                HISTORICAL_PRICE_DATA_RECORD_RESPONSE = 803,
+                HISTORICAL_PRICE_DATA_TICK_RECORD_RESPONSE = 804,
+
                 // System Messages
                 GENERAL_LOG_MESSAGE = 700,
                 ALERT_MESSAGE = 701,
@@ -130,6 +138,31 @@ namespace open_dtc_server
                 TIF_GOOD_TILL_CROSSING = 6
             };
 
+            // Depth side enumeration
+            enum class DepthSideEnum : uint8_t
+            {
+                SIDE_UNSET = 0,
+                SIDE_BID = 1,
+                SIDE_ASK = 2
+            };
+
+            // Positional depth update type
+            enum class DepthUpdateTypeEnum : uint8_t
+            {
+                DEPTH_UNSET = 0,
+                DEPTH_INSERT = 1, // Level inserted at position, deeper levels shift down
+                DEPTH_UPDATE = 2, // Size changed at position
+                DEPTH_DELETE = 3  // Level removed at position, deeper levels shift up
+            };
+
+            // Whether the server's market data is flowing
+            enum class MarketDataFeedStatusEnum : int32_t
+            {
+                MARKET_DATA_FEED_STATUS_UNSET = 0,
+                MARKET_DATA_FEED_UNAVAILABLE = 1,
+                MARKET_DATA_FEED_AVAILABLE = 2
+            };
+
 // DTC Message Header (all messages start with this)
 #pragma pack(push, 1)
             struct MessageHeader
@@ -237,6 +270,19 @@ namespace open_dtc_server
                 bool deserialize(const uint8_t *data, uint16_t size) override;
             };
 
+            // Market Data Feed Status Message: the server's upstream feed went down or came back.
+            // Clients told resubscribe_when_market_data_feed_available resubscribe on AVAILABLE.
+            class MarketDataFeedStatus : public DTCMessage
+            {
+            public:
+                MarketDataFeedStatusEnum status = MarketDataFeedStatusEnum::MARKET_DATA_FEED_STATUS_UNSET;
+
+                MessageType get_type() const override { return MessageType::MARKET_DATA_FEED_STATUS; }
+                uint16_t get_size() const override;
+                std::vector<uint8_t> serialize() const override;
+                bool deserialize(const uint8_t *data, uint16_t size) override;
+            };
+
             // Market Data Request Message
             class MarketDataRequest : public DTCMessage
             {
@@ -288,7 +334,7 @@ namespace open_dtc_server
                 double at_bid_or_ask = 0;
                 double price = 0.0;
                 double volume = 0.0;
-                uint64_t date_time = 0;
+                uint64_t date_time = 0; // Microseconds since epoch (DTC t_DateTimeWithMicrosecondsInt)
 
                 MessageType get_type() const override { return MessageType::MARKET_DATA_UPDATE_TRADE; }
                 uint16_t get_size() const override;
@@ -305,7 +351,7 @@ namespace open_dtc_server
                 float bid_quantity = 0.0f;
                 double ask_price = 0.0;
                 float ask_quantity = 0.0f;
-                uint64_t date_time = 0;
+                uint64_t date_time = 0; // Microseconds since epoch (DTC t_DateTimeWithMicrosecondsInt)
                 uint8_t is_bid_change = 0;
                 uint8_t is_ask_change = 0;
 
@@ -315,6 +361,25 @@ namespace open_dtc_server
                 bool deserialize(const uint8_t *data, uint16_t size) override;
             };
 
+            // Market Depth Snapshot Message (DOM) - one level per message, sent as a batch
+            class MarketDepthSnapshot : public DTCMessage
+            {
+            public:
+                uint16_t symbol_id = 0;
+                uint8_t side = 0;   // 1 = Bid, 2 = Ask
+                uint16_t level = 0; // Level index (0 = best)
+                double price = 0.0;
+                double quantity = 0.0;
+                uint8_t is_first_message_in_batch = 0;
+                uint8_t is_last_message_in_batch = 0;
+                uint64_t date_time = 0; // Microseconds since epoch
+
+                MessageType get_type() const override { return MessageType::MARKET_DEPTH_SNAPSHOT; }
+                uint16_t get_size() const override;
+                std::vector<uint8_t> serialize() const override;
+                bool deserialize(const uint8_t *data, uint16_t size) override;
+            };
+
             // Market Depth Incremental Update Message (DOM)
             class MarketDepthIncrementalUpdate : public DTCMessage
             {
@@ -322,9 +387,10 @@ namespace open_dtc_server
                 uint16_t symbol_id = 0;
                 uint8_t side = 0;      // 1 = Bid, 2 = Ask
                 uint16_t position = 0; // Level index (0 = best)
+                uint8_t update_type = static_cast<uint8_t>(DepthUpdateTypeEnum::DEPTH_UNSET);
                 double price = 0.0;
                 double size = 0.0;
-                uint64_t date_time = 0;
+                uint64_t date_time = 0; // Microseconds since epoch
 
                 MessageType get_type() const override { return MessageType::MARKET_DEPTH_INCREMENTAL_UPDATE; }
                 uint16_t get_size() const override;
@@ -332,6 +398,186 @@ namespace open_dtc_server
                 bool deserialize(const uint8_t *data, uint16_t size) override;
             };
 
+            // Market Data Snapshot Message - session statistics and last trade, sent on subscribe or snapshot request
+            class MarketDataSnapshot : public DTCMessage
+            {
+            public:
+                uint16_t symbol_id = 0;
+                double session_open_price = 0.0;
+                double session_high_price = 0.0;
+                double session_low_price = 0.0;
+                double session_volume = 0.0;
+                uint32_t session_num_trades = 0;
+                double bid_price = 0.0;
+                double ask_price = 0.0;
+                double bid_quantity = 0.0;
+                double ask_quantity = 0.0;
+                double last_trade_price = 0.0;
+                double last_trade_volume = 0.0;
+                uint64_t last_trade_date_time = 0;
+                uint64_t trading_session_date = 0;
+
+                MessageType get_type() const override { return MessageType::MARKET_DATA_SNAPSHOT; }
+                uint16_t get_size() const override;
+                std::vector<uint8_t> serialize() const override;
+                bool deserialize(const uint8_t *data, uint16_t size) override;
+            };
+
+            // Session Open/High/Low Messages - symbol_id, price, trading_session_date
+            class MarketDataUpdateSessionOpen : public DTCMessage
+            {
+            public:
+                uint16_t symbol_id = 0;
+                double price = 0.0;
+                uint64_t trading_session_date = 0;
+
+                MessageType get_type() const override { return MessageType::MARKET_DATA_UPDATE_SESSION_OPEN; }
+                uint16_t get_size() const override;
+                std::vector<uint8_t> serialize() const override;
+                bool deserialize(const uint8_t *data, uint16_t size) override;
+            };
+
+            class MarketDataUpdateSessionHigh : public DTCMessage
+            {
+            public:
+                uint16_t symbol_id = 0;
+                double price = 0.0;
+                uint64_t trading_session_date = 0;
+
+                MessageType get_type() const override { return MessageType::MARKET_DATA_UPDATE_SESSION_HIGH; }
+                uint16_t get_size() const override;
+                std::vector<uint8_t> serialize() const override;
+                bool deserialize(const uint8_t *data, uint16_t size) override;
+            };
+
+            class MarketDataUpdateSessionLow : public DTCMessage
+            {
+            public:
+                uint16_t symbol_id = 0;
+                double price = 0.0;
+                uint64_t trading_session_date = 0;
+
+                MessageType get_type() const override { return MessageType::MARKET_DATA_UPDATE_SESSION_LOW; }
+                uint16_t get_size() const override;
+                std::vector<uint8_t> serialize() const override;
+                bool deserialize(const uint8_t *data, uint16_t size) override;
+            };
+
+            // Session Volume Message - symbol_id, volume, trading_session_date
+            class MarketDataUpdateSessionVolume : public DTCMessage
+            {
+            public:
+                uint16_t symbol_id = 0;
+                double volume = 0.0;
+                uint64_t trading_session_date = 0;
+
+                MessageType get_type() const override { return MessageType::MARKET_DATA_UPDATE_SESSION_VOLUME; }
+                uint16_t get_size() const override;
+                std::vector<uint8_t> serialize() const override;
+                bool deserialize(const uint8_t *data, uint16_t size) override;
+            };
+
+            // Historical Price Data Request Message
+            class HistoricalPriceDataRequest : public DTCMessage
+            {
+            public:
+                int32_t request_id = 0;
+                std::string symbol;
+                std::string exchange;
+                int32_t record_interval = 0;  // Bar length in seconds, 0 = ticks
+                int64_t start_date_time = 0;  // Seconds since epoch, 0 = use max_days_to_return
+                int64_t end_date_time = 0;    // Seconds since epoch, 0 = now
+                uint32_t max_days_to_return = 0;
+                uint8_t use_zlib_compression = 0;
+                uint8_t request_dividend_adjusted_stock_data = 0;
+                uint16_t integer_1 = 0;
+
+                MessageType get_type() const override { return MessageType::HISTORICAL_PRICE_DATA_REQUEST; }
+                uint16_t get_size() const override;
+                std::vector<uint8_t> serialize() const override;
+                bool deserialize(const uint8_t *data, uint16_t size) override;
+            };
+
+            // Historical Price Data Response Header Message
+            // When use_zlib_compression is set, every message after this header is one zlib stream
+            class HistoricalPriceDataResponseHeader : public DTCMessage
+            {
+            public:
+                int32_t request_id = 0;
+                int32_t record_interval = 0;
+                uint8_t use_zlib_compression = 0;
+                uint8_t no_records_to_return = 0;
+                float int_to_float_price_divisor = 1.0f;
+
+                MessageType get_type() const override { return MessageType::HISTORICAL_PRICE_DATA_RESPONSE_HEADER; }
+                uint16_t get_size() const override;
+                std::vector<uint8_t> serialize() const override;
+                bool deserialize(const uint8_t *data, uint16_t size) override;
+            };
+
+            // Historical Price Data Reject Message
+            class HistoricalPriceDataReject : public DTCMessage
+            {
+            public:
+                int32_t request_id = 0;
+                int16_t reject_reason_code = 0;
+                uint16_t retry_time_in_seconds = 0;
+                std::string reject_text;
+
+                MessageType get_type() const override { return MessageType::HISTORICAL_PRICE_DATA_REJECT; }
+                uint16_t get_size() const override;
+                std::vector<uint8_t> serialize() const override;
+                bool deserialize(const uint8_t *data, uint16_t size) override;
+            };
+
+            // Historical Price Data Record (bar) Message
+            class HistoricalPriceDataRecordResponse : public DTCMessage
+            {
+            public:
+                int32_t request_id = 0;
+                int64_t start_date_time = 0; // Microseconds since epoch
+                double open_price = 0.0;
+                double high_price = 0.0;
+                double low_price = 0.0;
+                double last_price = 0.0;
+                double volume = 0.0;
+                uint32_t num_trades = 0;
+                double bid_volume = 0.0;
+                double ask_volume = 0.0;
+                uint8_t is_final_record = 0;
+
+                MessageType get_type() const override { return MessageType::HISTORICAL_PRICE_DATA_RECORD_RESPONSE; }
+                uint16_t get_size() const override;
+                std::vector<uint8_t> serialize() const override;
+                bool deserialize(const uint8_t *data, uint16_t size) override;
+            };
+
+            // Historical Price Data Tick Record Message (fixed size, laid out field by field)
+            class HistoricalPriceDataTickRecordResponse : public DTCMessage
+            {
+            public:
+                int32_t request_id = 0;
+                double date_time = 0.0;     // Seconds since epoch with millisecond fraction
+                uint8_t at_bid_or_ask = 0;  // 1 = Bid, 2 = Ask, 0 = unknown
+                double price = 0.0;
+                double volume = 0.0;
+                uint8_t is_final_record = 0;
+
+                // Field offsets, used to encode record batches without building objects
+                static constexpr size_t REQUEST_ID_OFFSET = sizeof(uint16_t) * 2;
+                static constexpr size_t DATE_TIME_OFFSET = REQUEST_ID_OFFSET + sizeof(int32_t);
+                static constexpr size_t AT_BID_OR_ASK_OFFSET = DATE_TIME_OFFSET + sizeof(double);
+                static constexpr size_t PRICE_OFFSET = AT_BID_OR_ASK_OFFSET + sizeof(uint8_t);
+                static constexpr size_t VOLUME_OFFSET = PRICE_OFFSET + sizeof(double);
+                static constexpr size_t IS_FINAL_RECORD_OFFSET = VOLUME_OFFSET + sizeof(double);
+                static constexpr size_t RECORD_SIZE = IS_FINAL_RECORD_OFFSET + sizeof(uint8_t);
+
+                MessageType get_type() const override { return MessageType::HISTORICAL_PRICE_DATA_TICK_RECORD_RESPONSE; }
+                uint16_t get_size() const override;
+                std::vector<uint8_t> serialize() const override;
+                bool deserialize(const uint8_t *data, uint16_t size) override;
+            };
+
             // Submit New Single Order Message
             class SubmitNewSingleOrder : public DTCMessage
             {
@@ -415,6 +661,19 @@ namespace open_dtc_server
                 bool deserialize(const uint8_t *data, uint16_t size) override;
             };
 
+            // Open Orders Reject Message
+            class OpenOrdersReject : public DTCMessage
+            {
+            public:
+                uint32_t request_id = 0;
+                std::string reject_text;
+
+                MessageType get_type() const override { return MessageType::OPEN_ORDERS_REJECT; }
+                uint16_t get_size() const override;
+                std::vector<uint8_t> serialize() const override;
+                bool deserialize(const uint8_t *data, uint16_t size) override;
+            };
+
             // Current Positions Request Message
             class CurrentPositionsRequest : public DTCMessage
             {
@@ -532,11 +791,13 @@ namespace open_dtc_server
                     uint16_t symbol_id, double bid_price, float bid_qty,
                     double ask_price, float ask_qty, uint64_t timestamp);
                 std::unique_ptr<Heartbeat> create_heartbeat(uint32_t num_drops = 0);
+                std::unique_ptr<MarketDataFeedStatus> create_market_data_feed_status(bool available);
                 std::unique_ptr<SecurityDefinitionResponse> create_security_definition_response(
                     uint32_t request_id, const std::string &symbol, const std::string &exchange);
 
                 // Utility functions
-                static uint64_t get_current_timestamp();
+                static uint64_t get_current_timestamp();    // Seconds since epoch
+                static uint64_t get_current_timestamp_us(); // Microseconds since epoch, for market data date_time
                 static MessageType get_message_type(const uint8_t *data, uint16_t size);
                 static bool validate_message_header(const uint8_t *data, uint16_t size);
                 static std::string message_type_to_string(MessageType type);
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace open_dtc_server
+{
+    namespace core
+    {
+        namespace history
+        {
+
+            /**
+             * Column-oriented tick batch. Each column is a plain array so a range
+             * read is a few large sequential reads, one per column file.
+             */
+            struct TickColumns
+            {
+                std::vector<int64_t> time_us;   // Microseconds since epoch (UTC)
+                std::vector<double> price;
+                std::vector<double> volume;
+                std::vector<uint8_t> side;      // DTC AtBidOrAsk: 1 = bid, 2 = ask, 0 = unknown
+
+                size_t size() const { return time_us.size(); }
+                bool empty() const { return time_us.empty(); }
+                void clear();
+                void reserve(size_t count);
+                void push_back(int64_t t, double p, double v, uint8_t s);
+            };
+
+            /**
+             * Local columnar tick store populated by the live feed.
+             *
+             * Layout: <root>/<symbol>/<YYYYMMDD>/{time,price,volume,side}.col plus
+             * index.idx, a sparse index holding (time, record) for every
+             * INDEX_STRIDE-th record of the day. Range reads binary-search the
+             * index, seek every column to the same record and stream from there,
+             * so times never go backwards within a symbol, and a failed write is
+             * truncated away so the columns stay record-aligned.
+             *
+             * append() only buffers: full batches are handed to a writer thread,
+             * which owns every file operation, so the feed thread never waits on disk.
+             */
+            class TickStore
+            {
+            public:
+                static constexpr uint64_t INDEX_STRIDE = 1024;
+                static constexpr size_t FLUSH_THRESHOLD = 4096;
+
+                explicit TickStore(const std::string &root_path);
+                ~TickStore();
+
+                /**
+                 * Buffer one tick; every FLUSH_THRESHOLD ticks the batch goes to the writer thread.
+                 * A tick older than the symbol's latest is stored at that latest time.
+                 */
+                void append(const std::string &symbol, int64_t time_us, double price, double volume, uint8_t side);
+
+                /** Hand all buffered ticks to the writer and wait until they are on disk */
+                void flush();
+
+                /**
+                 * Read ticks with start_us <= time <= end_us, oldest first.
+                 * @return false if the symbol has no stored data in the range
+                 */
+                bool read_range(const std::string &symbol, int64_t start_us, int64_t end_us, TickColumns &out);
+
+                const std::string &get_root_path() const { return root_path_; }
+
+            private:
+                // Appender side, under mutex_
+                struct SymbolBuffer
+                {
+                    int64_t day = -1;                 // Days since epoch of the buffered ticks
+                    int64_t last_time_us = INT64_MIN; // Latest time buffered
+                    TickColumns pending;
+                };
+
+                // One symbol-day run of ticks queued for the writer
+                struct Batch
+                {
+                    std::string symbol;
+                    int64_t day;
+                    TickColumns ticks;
+                };
+
+                // Writer thread only
+                struct DayFile
+                {
+                    int64_t day = -1;
+                    uint64_t records_on_disk = 0;
+                    int64_t last_time_us = INT64_MIN; // Latest time stored
+                };
+
+                struct IndexEntry
+                {
+                    int64_t time_us;
+                    uint64_t record;
+                };
+
+                void queue_locked(const std::string &symbol, SymbolBuffer &buffer);
+                void wait_written(std::unique_lock<std::mutex> &lock, uint64_t batch);
+                void writer_loop();
+                bool write_batch(Batch &batch);
+                bool read_day(const std::string &symbol, int64_t day, int64_t start_us, int64_t end_us, TickColumns &out) const;
+                std::string day_directory(const std::string &symbol, int64_t day) const;
+
+                static int64_t day_of(int64_t time_us);
+                static std::string sanitize_symbol(const std::string &symbol);
+
+                std::string root_path_;
+                std::unordered_map<std::string, SymbolBuffer> buffers_;
+                std::deque<Batch> queue_;
+                std::vector<TickColumns> spare_; // Written batches, reused by append
+                uint64_t queued_ = 0;            // Batches handed to the writer
+                uint64_t written_ = 0;           // Batches the writer has finished
+                bool stopping_ = false;
+                std::mutex mutex_;
+                std::condition_variable work_cv_;
+                std::condition_variable written_cv_;
+
+                std::unordered_map<std::string, DayFile> files_;
+                std::thread writer_;
+            };
+
+        } // namespace history
+    } // namespace core
+} // namespace open_dtc_server
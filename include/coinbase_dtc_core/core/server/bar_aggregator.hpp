@@ -0,0 +1,133 @@
+#pragma once
+
+#include "coinbase_dtc_core/exchanges/base/symbol_registry.hpp"
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace coinbase_dtc_core
+{
+    namespace core
+    {
+        namespace server
+        {
+
+            /**
+             * Incremental session statistics and rolling time bars per instrument.
+             *
+             * Fed one trade at a time from the live feed. Each instrument keeps its session
+             * OHLCV plus one fixed-size ring of bars per configured interval; the rings
+             * are allocated on the instrument's first trade, so later trades cost O(1) per
+             * interval and allocate nothing. on_trade reports which session fields
+             * changed, so MARKET_DATA_UPDATE_SESSION_* messages go out only on a change,
+             * and the current state is always ready for a MARKET_DATA_SNAPSHOT.
+             */
+            class BarAggregator
+            {
+            public:
+                // Bits returned by on_trade, one per session update message
+                enum SessionField : uint8_t
+                {
+                    SESSION_OPEN = 1,
+                    SESSION_HIGH = 2,
+                    SESSION_LOW = 4,
+                    SESSION_VOLUME = 8
+                };
+
+                struct Bar
+                {
+                    uint64_t start_ms = 0;
+                    double open = 0.0;
+                    double high = 0.0;
+                    double low = 0.0;
+                    double close = 0.0;
+                    double volume = 0.0;
+                    uint32_t num_trades = 0;
+                    double bid_volume = 0.0; // Volume of trades at the bid (sells)
+                    double ask_volume = 0.0; // Volume of trades at the ask (buys)
+                };
+
+                struct SessionStats
+                {
+                    uint64_t session_start_ms = 0;
+                    double open = 0.0;
+                    double high = 0.0;
+                    double low = 0.0;
+                    double volume = 0.0;
+                    uint32_t num_trades = 0;
+                    double last_price = 0.0;
+                    double last_volume = 0.0;
+                    uint64_t last_trade_ms = 0;
+                };
+
+                /**
+                 * @param interval_seconds Bar lengths to maintain (e.g. {1, 60})
+                 * @param history Completed bars kept per interval, plus the one in progress
+                 * @param session_offset_seconds Session start relative to 00:00 UTC
+                 */
+                explicit BarAggregator(std::vector<uint32_t> interval_seconds = {1, 60}, size_t history = 120,
+                                       int64_t session_offset_seconds = 0);
+
+                /**
+                 * Fold one trade into the instrument's session and bars.
+                 * Trades older than the current session or bar only count where they still fit.
+                 * @param at_bid_or_ask 1 = at bid (sell), 2 = at ask (buy), 0 = unknown
+                 * @param session Receives the session state after the trade when not null
+                 * @return SessionField bits for the values that changed; all bits on a new session
+                 */
+                uint8_t on_trade(open_dtc_server::exchanges::base::InstrumentId instrument, double price, double volume, uint64_t timestamp_ms,
+                                 uint8_t at_bid_or_ask, SessionStats *session = nullptr);
+
+                /** Current session state; false when the instrument has not traded */
+                bool get_session(open_dtc_server::exchanges::base::InstrumentId instrument, SessionStats &session) const;
+
+                /**
+                 * Bars for one interval, oldest first; the last one is still in progress.
+                 * Intervals without trades have no bar.
+                 * @param count Most recent bars to return, 0 for all kept
+                 */
+                std::vector<Bar> get_bars(open_dtc_server::exchanges::base::InstrumentId instrument, uint32_t interval_seconds,
+                                          size_t count = 0) const;
+
+                const std::vector<uint32_t> &get_intervals() const { return intervals_; }
+
+                /**
+                 * Encode the session update messages for the changed fields.
+                 * The symbol ID is left 0; patch it per client with with_symbol_id.
+                 */
+                static std::vector<std::vector<uint8_t>> encode_session_updates(const SessionStats &session, uint8_t changed);
+
+                /** Encode a MARKET_DATA_SNAPSHOT of the session, empty stats when the instrument has not traded */
+                static std::vector<uint8_t> encode_snapshot(const SessionStats &session, uint16_t symbol_id);
+
+                /** Set the symbol ID of an encoded session update or snapshot */
+                static std::vector<uint8_t> with_symbol_id(std::vector<uint8_t> message, uint16_t symbol_id);
+
+            private:
+                struct BarRing
+                {
+                    uint64_t interval_ms = 0;
+                    std::vector<Bar> bars; // Fixed size, allocated once
+                    size_t head = 0;       // Bar in progress
+                    size_t count = 0;
+                };
+
+                struct SymbolBars
+                {
+                    SessionStats session;
+                    std::vector<BarRing> rings; // Parallel to intervals_
+                };
+
+                uint64_t session_start(uint64_t timestamp_ms) const;
+
+                std::vector<uint32_t> intervals_;
+                size_t history_;
+                int64_t session_offset_ms_;
+                std::unordered_map<open_dtc_server::exchanges::base::InstrumentId, SymbolBars> symbols_;
+                mutable std::mutex mutex_;
+            };
+
+        } // namespace server
+    } // namespace core
+} // namespace coinbase_dtc_core
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "coinbase_dtc_core/core/dtc/protocol.hpp"
+#include "coinbase_dtc_core/core/history/tick_store.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace coinbase_dtc_core
+{
+    namespace core
+    {
+        namespace server
+        {
+
+            /**
+             * Answers HISTORICAL_PRICE_DATA_REQUEST from the local tick store.
+             *
+             * Ticks are read column-wise for the requested range and encoded in
+             * bulk from a template record, or aggregated into bars on the fly when
+             * a record interval is requested. With use_zlib_compression everything
+             * after the response header is a single deflate stream (Z_BEST_SPEED)
+             * cut into CHUNK_SIZE messages.
+             */
+            class HistoricalDataService
+            {
+            public:
+                static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+                explicit HistoricalDataService(open_dtc_server::core::history::TickStore &store, uint32_t default_max_days = 1);
+
+                /**
+                 * Build the full response for a request.
+                 * @param now_us Current time in microseconds, used when end_date_time is 0
+                 * @return Byte chunks to send in order (header first)
+                 */
+                std::vector<std::vector<uint8_t>> handle_request(const open_dtc_server::core::dtc::HistoricalPriceDataRequest &request,
+                                                                 int64_t now_us);
+
+                /** Append one tick record per tick; the last record is flagged final */
+                static void encode_ticks(int32_t request_id, const open_dtc_server::core::history::TickColumns &ticks,
+                                         std::vector<uint8_t> &out);
+
+                /** Aggregate ticks into interval_seconds bars and append one record per bar */
+                static void encode_bars(int32_t request_id, int32_t interval_seconds,
+                                        const open_dtc_server::core::history::TickColumns &ticks, std::vector<uint8_t> &out);
+
+                /** Deflate data into chunks of at most CHUNK_SIZE bytes; false without zlib */
+                static bool compress(const std::vector<uint8_t> &data, std::vector<std::vector<uint8_t>> &chunks);
+
+            private:
+                open_dtc_server::core::history::TickStore &store_;
+                uint32_t default_max_days_;
+            };
+
+        } // namespace server
+    } // namespace core
+} // namespace coinbase_dtc_core
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "coinbase_dtc_core/exchanges/base/exchange_feed.hpp"
+#include "coinbase_dtc_core/exchanges/base/order_book.hpp"
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace coinbase_dtc_core
+{
+    namespace core
+    {
+        namespace server
+        {
+
+            /**
+             * Distributes full market depth (DOM) to DTC clients.
+             *
+             * Keeps one order book per instrument, so the same spelling on two
+             * exchanges never shares a book, mirrored from the feed's book deltas
+             * (or diffed here for feeds that send raw changes). Every change becomes
+             * a positioned MARKET_DEPTH_INCREMENTAL_UPDATE; the encoded bytes are
+             * shared by all subscribers and only the symbol ID is patched per client.
+             * Each subscriber sees at most its own number of levels per side, so
+             * levels entering or leaving that window are inserted or deleted for it.
+             */
+            class MarketDepthDistributor
+            {
+            public:
+                struct OutgoingMessage
+                {
+                    int client_id;
+                    std::vector<uint8_t> data;
+                };
+
+                explicit MarketDepthDistributor(uint16_t max_levels = 100);
+
+                /**
+                 * Register a client for depth on an instrument (or change its level count).
+                 * @return MARKET_DEPTH_SNAPSHOT messages describing the current book
+                 */
+                std::vector<std::vector<uint8_t>> subscribe(open_dtc_server::exchanges::base::InstrumentId instrument, int client_id,
+                                                            uint16_t symbol_id, uint16_t levels);
+
+                /** Stop sending depth for an instrument to a client */
+                void unsubscribe(open_dtc_server::exchanges::base::InstrumentId instrument, int client_id);
+
+                /** Drop every depth subscription of a disconnected client */
+                void remove_client(int client_id);
+
+                /**
+                 * Apply one book change.
+                 * @return Messages to send, in order, tagged with the receiving client
+                 */
+                std::vector<OutgoingMessage> apply(const open_dtc_server::exchanges::base::MarketDepthUpdate &update);
+
+                /** Number of clients receiving depth for an instrument */
+                size_t get_subscriber_count(open_dtc_server::exchanges::base::InstrumentId instrument) const;
+
+                /** Copy of the mirrored book of an instrument; false if it has seen no change yet */
+                bool get_book(open_dtc_server::exchanges::base::InstrumentId instrument,
+                              open_dtc_server::exchanges::base::OrderBook &book) const;
+
+            private:
+                struct Subscriber
+                {
+                    int client_id;
+                    uint16_t symbol_id;
+                    uint16_t levels;
+                };
+
+                struct SymbolDepth
+                {
+                    open_dtc_server::exchanges::base::OrderBook book;
+                    std::vector<Subscriber> subscribers;
+                };
+
+                static std::vector<uint8_t> encode_update(open_dtc_server::exchanges::base::BookSide side, uint16_t position,
+                                                          uint8_t update_type, double price, double size, uint64_t date_time);
+                static std::vector<uint8_t> with_symbol_id(std::vector<uint8_t> message, uint16_t symbol_id);
+
+                std::vector<std::vector<uint8_t>> build_snapshot(const SymbolDepth &depth, uint16_t symbol_id,
+                                                                 uint16_t levels, uint64_t date_time) const;
+
+                uint16_t max_levels_;
+                std::unordered_map<open_dtc_server::exchanges::base::InstrumentId, SymbolDepth> symbols_;
+                mutable std::mutex mutex_;
+            };
+
+        } // namespace server
+    } // namespace core
+} // namespace coinbase_dtc_core
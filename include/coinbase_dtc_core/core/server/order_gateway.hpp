@@ -0,0 +1,151 @@
+#pragma once
+
+#include "coinbase_dtc_core/core/dtc/protocol.hpp"
+#include "coinbase_dtc_core/exchanges/base/order_transport.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace coinbase_dtc_core
+{
+    namespace core
+    {
+        namespace server
+        {
+
+            /**
+             * Routes DTC SUBMIT_NEW_SINGLE_ORDER messages to the exchange.
+             *
+             * submit() validates and translates the order on the calling (client)
+             * thread and returns a PENDING_OPEN (or REJECTED) ORDER_UPDATE right away;
+             * a single worker thread sends queued orders through the OrderTransport
+             * and streams the resulting ORDER_UPDATE back through the send callback.
+             * A request that gets no reply may still have placed the order, so it is
+             * never reported as rejected: the order stays PENDING_OPEN and is sent
+             * again under the same client_order_id, which returns the existing order
+             * rather than placing another, once keep_warm reports the transport
+             * connected again. While idle the worker keeps the transport warm. Submit-to-ack latency (order received to exchange reply) is
+             * tracked per order.
+             */
+            class OrderGateway
+            {
+            public:
+                // Longest wait between reconnect probes while an order waits to be resent
+                static constexpr std::chrono::milliseconds RECONNECT_INTERVAL{500};
+
+                /** Delivers an encoded ORDER_UPDATE to a client (called from the worker thread) */
+                using SendCallback = std::function<void(int client_id, const std::vector<uint8_t> &message)>;
+                /** Sees every ORDER_UPDATE the gateway produces, from the submitting or worker thread */
+                using UpdateObserver = std::function<void(const open_dtc_server::core::dtc::OrderUpdate &update)>;
+
+                struct Stats
+                {
+                    uint64_t submitted = 0; // Accepted into the queue
+                    uint64_t acknowledged = 0;
+                    uint64_t rejected = 0; // Invalid, queue full, or refused by the exchange
+                    uint64_t failed = 0;   // Transport errors (no exchange reply)
+                    uint64_t unresolved = 0; // Still unknown after every reconcile attempt
+                    size_t pending = 0;      // Queued or waiting to be resent
+
+                    // Submit-to-ack over the most recent replies, in microseconds
+                    uint64_t latency_samples = 0;
+                    double latency_mean_us = 0.0;
+                    uint64_t latency_p50_us = 0;
+                    uint64_t latency_p99_us = 0;
+                    uint64_t latency_max_us = 0;
+                };
+
+                /**
+                 * @param max_pending Orders queued beyond this are rejected
+                 * @param keep_warm_interval How often the idle worker calls OrderTransport::keep_warm
+                 *                           (at most RECONNECT_INTERVAL while an order waits to be resent)
+                 */
+                OrderGateway(std::unique_ptr<open_dtc_server::exchanges::base::OrderTransport> transport, SendCallback send,
+                             size_t max_pending = 256, std::chrono::milliseconds keep_warm_interval = std::chrono::seconds(5));
+                ~OrderGateway();
+
+                OrderGateway(const OrderGateway &) = delete;
+                OrderGateway &operator=(const OrderGateway &) = delete;
+
+                /**
+                 * Queue an order for the exchange. Never blocks on the network.
+                 * @return ORDER_UPDATE to send to the client now (PENDING_OPEN or REJECTED)
+                 */
+                std::vector<uint8_t> submit(int client_id, const open_dtc_server::core::dtc::SubmitNewSingleOrder &order);
+
+                /** Set before the first submit() */
+                void set_update_observer(UpdateObserver observer) { observer_ = std::move(observer); }
+
+                Stats get_stats() const;
+
+                /**
+                 * Build the Advanced Trade create-order JSON for a DTC order.
+                 * @return false with error set when the order cannot be expressed on Coinbase
+                 */
+                static bool build_order_request(const open_dtc_server::core::dtc::SubmitNewSingleOrder &order,
+                                                const std::string &client_order_id, std::string &body, std::string &error);
+
+                /**
+                 * Interpret a create-order reply.
+                 * @return true with the exchange order ID when the order was accepted, false with error otherwise
+                 */
+                static bool parse_order_response(const open_dtc_server::exchanges::base::OrderResponse &response,
+                                                 std::string &exchange_order_id, std::string &error);
+
+                /** ORDER_UPDATE rejecting an order that never reached a gateway */
+                static std::vector<uint8_t> encode_reject(const open_dtc_server::core::dtc::SubmitNewSingleOrder &order,
+                                                          const std::string &reason);
+
+            private:
+                struct PendingOrder
+                {
+                    int client_id = 0;
+                    open_dtc_server::core::dtc::SubmitNewSingleOrder order;
+                    std::string server_order_id; // Also the Coinbase client_order_id
+                    std::string body;
+                    uint64_t received_date_time = 0;
+                    std::chrono::steady_clock::time_point received;
+                    int attempts = 0; // Sends that got no reply
+                    std::string last_error;
+                };
+
+                void worker_loop();
+                void record_latency(uint64_t latency_us);
+                std::vector<uint8_t> encode_update(const PendingOrder &pending, open_dtc_server::core::dtc::OrderStatusEnum status,
+                                                   const std::string &exchange_order_id, const std::string &info_text);
+
+                std::unique_ptr<open_dtc_server::exchanges::base::OrderTransport> transport_;
+                SendCallback send_;
+                UpdateObserver observer_;
+                size_t max_pending_;
+                std::chrono::milliseconds keep_warm_interval_;
+
+                std::deque<PendingOrder> queue_;
+                std::deque<PendingOrder> unanswered_; // Sent without a reply, resent once the transport reconnects
+                bool stopping_ = false;
+                mutable std::mutex queue_mutex_;
+                std::condition_variable queue_cv_;
+                std::thread worker_;
+
+                std::atomic<uint64_t> next_order_id_{1};
+                std::atomic<uint32_t> update_sequence_{1};
+
+                // Counters and a fixed ring of recent latencies
+                Stats counters_;
+                std::vector<uint32_t> latencies_us_;
+                size_t latency_next_ = 0;
+                double latency_total_us_ = 0.0;
+                mutable std::mutex stats_mutex_;
+            };
+
+        } // namespace server
+    } // namespace core
+} // namespace coinbase_dtc_core
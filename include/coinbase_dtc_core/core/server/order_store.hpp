@@ -0,0 +1,85 @@
+#pragma once
+
+#include "coinbase_dtc_core/core/dtc/protocol.hpp"
+#include "coinbase_dtc_core/exchanges/base/order_transport.hpp"
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace coinbase_dtc_core
+{
+    namespace core
+    {
+        namespace server
+        {
+
+            /**
+             * In-memory order state, kept as the DTC ORDER_UPDATE last sent for each order.
+             *
+             * Orders enter from the OrderGateway (record) and from the exchange order
+             * stream or a one-time REST bootstrap (apply / bootstrap). Every order is
+             * keyed by server order ID, with indexes from DTC client order ID and
+             * exchange order ID, so all lookups are hash lookups. Open orders are kept
+             * in their own set; closed orders are retained up to max_closed_orders for
+             * lookups and then dropped oldest first. A close is final only once the
+             * exchange reports it; one the gateway inferred locally gives way to the
+             * exchange's view. Thread-safe.
+             */
+            class OrderStore
+            {
+            public:
+                explicit OrderStore(size_t max_closed_orders = 1000);
+
+                /** Record an ORDER_UPDATE produced by the order gateway */
+                void record(const open_dtc_server::core::dtc::OrderUpdate &update);
+
+                /**
+                 * Apply the exchange's view of an order. Fills are derived from the
+                 * change in cumulative quantity and average price.
+                 * @return true with the new state in update when anything a client sees changed
+                 */
+                bool apply(const open_dtc_server::exchanges::base::OrderEvent &event, open_dtc_server::core::dtc::OrderUpdate &update);
+
+                /**
+                 * Seed from order history. Orders already known (from the stream, which
+                 * is newer) are left alone; fills only set last-fill details.
+                 * @return number of orders added
+                 */
+                size_t bootstrap(const std::vector<open_dtc_server::exchanges::base::OrderEvent> &orders,
+                                 const std::vector<open_dtc_server::exchanges::base::FillEvent> &fills);
+
+                bool find_by_server_order_id(const std::string &server_order_id, open_dtc_server::core::dtc::OrderUpdate &order) const;
+                bool find_by_client_order_id(const std::string &client_order_id, open_dtc_server::core::dtc::OrderUpdate &order) const;
+
+                std::vector<open_dtc_server::core::dtc::OrderUpdate> get_open_orders() const;
+                size_t size() const;
+                size_t open_count() const;
+
+                /** OPEN_ORDERS_REQUEST reply: one numbered ORDER_UPDATE per order, or a single no_orders update */
+                static std::vector<std::vector<uint8_t>> encode_open_orders(const std::vector<open_dtc_server::core::dtc::OrderUpdate> &orders,
+                                                                            uint32_t request_id);
+
+            private:
+                static bool is_closed(open_dtc_server::core::dtc::OrderStatusEnum status);
+                bool apply_locked(const open_dtc_server::exchanges::base::OrderEvent &event, open_dtc_server::core::dtc::OrderUpdate *update);
+                void track_status(const std::string &server_order_id, open_dtc_server::core::dtc::OrderStatusEnum previous,
+                                  open_dtc_server::core::dtc::OrderStatusEnum status);
+                const std::string *find_key(const open_dtc_server::exchanges::base::OrderEvent &event) const;
+
+                std::unordered_map<std::string, open_dtc_server::core::dtc::OrderUpdate> orders_; // By server order ID
+                std::unordered_map<std::string, std::string> by_client_order_id_;
+                std::unordered_map<std::string, std::string> by_exchange_order_id_;
+                std::unordered_set<std::string> open_;
+                std::unordered_set<std::string> exchange_closed_; // Closed by the exchange stream or history, never reopened
+                std::deque<std::string> closed_; // Oldest first
+                size_t max_closed_orders_;
+                mutable std::mutex mutex_;
+            };
+
+        } // namespace server
+    } // namespace core
+} // namespace coinbase_dtc_core
@@ -1,9 +1,18 @@
 #pragma once
 
 #include "coinbase_dtc_core/core/dtc/protocol.hpp"
+#include "coinbase_dtc_core/core/server/market_depth.hpp"
+#include "coinbase_dtc_core/core/server/bar_aggregator.hpp"
+#include "coinbase_dtc_core/core/server/order_gateway.hpp"
+#include "coinbase_dtc_core/core/server/order_store.hpp"
+#include "coinbase_dtc_core/core/server/historical_data.hpp"
+#include "coinbase_dtc_core/core/history/tick_store.hpp"
 #include "coinbase_dtc_core/exchanges/base/exchange_feed.hpp"
+#include "coinbase_dtc_core/exchanges/base/consolidated_book.hpp"
+#include "coinbase_dtc_core/exchanges/base/market_journal.hpp"
 #include "coinbase_dtc_core/exchanges/factory/exchange_factory.hpp"
 #include "coinbase_dtc_core/exchanges/coinbase/rest_client.hpp"
+#include "coinbase_dtc_core/exchanges/coinbase/user_feed.hpp"
 #include <memory>
 #include <string>
 #include <thread>
@@ -42,6 +51,38 @@ namespace coinbase_dtc_core
                 uint16_t protocol_version = 8;
                 int max_clients = 100;
 
+                // Market depth (DOM) levels per side sent to each client
+                uint16_t market_depth_levels = 10;
+                uint16_t max_market_depth_levels = 100;
+
+                // Session statistics (MARKET_DATA_UPDATE_SESSION_*) and rolling bars from live trades
+                bool enable_bar_aggregation = true;
+                std::vector<uint32_t> bar_intervals_seconds = {1, 60};
+                size_t bar_history = 120;                 // Bars kept per interval
+                int64_t session_start_offset_seconds = 0; // Session start relative to 00:00 UTC
+
+                // Order entry through the Coinbase Advanced Trade API (needs valid credentials)
+                bool enable_order_entry = true;
+                bool order_entry_sandbox = false;
+                size_t max_pending_orders = 256;
+
+                // Own orders and fills kept in memory from the Coinbase user channel (needs valid credentials)
+                bool enable_order_tracking = true;
+                size_t max_closed_orders = 1000; // Finished orders kept for lookups
+
+                // Historical data served from the local tick store, filled by the live feed
+                bool enable_historical_data = true;
+                std::string tick_store_path = "data/ticks";
+                uint32_t historical_max_days = 1; // Used when a request has no start time
+
+                // Raw market data journal, one directory per exchange under market_journal_path
+                bool enable_market_journal = false;
+                std::string market_journal_path = "data/journal";
+                uint64_t market_journal_segment_records = 1 << 20;
+                size_t market_journal_retain_segments = 0;
+                open_dtc_server::exchanges::base::JournalConfig::SyncPolicy market_journal_sync =
+                    open_dtc_server::exchanges::base::JournalConfig::SyncPolicy::ON_ROLL;
+
                 // Exchange configuration
                 std::vector<open_dtc_server::exchanges::base::ExchangeConfig> exchanges;
 
@@ -67,6 +108,9 @@ namespace coinbase_dtc_core
                 uint32_t next_symbol_id = 1;
                 std::unordered_map<std::string, uint32_t> symbol_to_id;
                 std::unordered_map<uint32_t, std::string> id_to_symbol;
+                // Subscribed instruments -> client symbol ID, matched against every trade and quote
+                std::unordered_map<open_dtc_server::exchanges::base::InstrumentId, uint32_t> instrument_to_id;
+                uint16_t market_depth_levels = 0; // 0 = use ServerConfig::market_depth_levels
             };
 
             /**
@@ -198,12 +242,22 @@ namespace coinbase_dtc_core
 
                 // Exchange callbacks
                 void on_trade_data(const open_dtc_server::exchanges::base::MarketTrade &trade);
+                void record_feed_latency(uint64_t exchange_time_us, uint64_t receive_time_us);
                 void on_level2_data(const open_dtc_server::exchanges::base::MarketLevel2 &level2);
+                void on_depth_data(const open_dtc_server::exchanges::base::MarketDepthUpdate &update);
                 void on_exchange_connection(bool connected, const std::string &exchange);
+                // Feed for a client's exchange name, or the only feed there is; needs exchanges_mutex_
+                open_dtc_server::exchanges::base::ExchangeFeedBase *market_data_feed_locked(const std::string &exchange);
+                bool subscribe_consolidated(const std::string &normalized_symbol);
                 void on_exchange_error(const std::string &error, const std::string &exchange);
 
+                // Order state
+                void start_order_tracking();
+                void on_order_event(const open_dtc_server::exchanges::base::OrderEvent &event);
+
                 // Account data
                 void send_account_data_to_client(std::shared_ptr<ClientConnection> client);
+                void send_to_client(int client_id, const std::vector<uint8_t> &message);
                 void send_position_update_to_client(std::shared_ptr<ClientConnection> client,
                                                     const std::string &currency, const std::string &total_balance, const std::string &available); // Socket management
                 bool initialize_sockets();
@@ -238,11 +292,39 @@ namespace coinbase_dtc_core
                 std::unordered_map<std::string, std::unique_ptr<open_dtc_server::exchanges::base::ExchangeFeedBase>> exchange_feeds_;
                 std::mutex exchanges_mutex_;
 
+                // Feed status per exchange, as last reported; clients hear when all of them are up again or one goes down
+                std::unordered_map<std::string, bool> exchange_connected_;
+                bool market_data_feed_available_ = true;
+                std::mutex exchange_status_mutex_;
+
+                // Market depth distribution; depth_mutex_ keeps snapshots and updates in order
+                std::unique_ptr<MarketDepthDistributor> depth_distributor_;
+                std::mutex depth_mutex_;
+
+                // Session statistics and bars (null when bar aggregation is disabled)
+                std::unique_ptr<BarAggregator> bar_aggregator_;
+
+                // Cross-exchange book published as the CONSOLIDATED exchange
+                std::unique_ptr<open_dtc_server::exchanges::base::ConsolidatedBook> consolidated_book_;
+
+                // Local tick history (null when historical data is disabled)
+                std::unique_ptr<open_dtc_server::core::history::TickStore> tick_store_;
+                std::unique_ptr<HistoricalDataService> historical_data_;
+
                 // Client management
                 std::vector<std::shared_ptr<ClientConnection>> clients_;
                 std::mutex clients_mutex_;
                 std::atomic<int> next_client_id_{1};
 
+                // Order state from the user channel (null without valid credentials); used by the gateway and feed below
+                std::unique_ptr<OrderStore> order_store_;
+
+                // Order entry (null without valid credentials); declared after clients_ so it stops first
+                std::unique_ptr<OrderGateway> order_gateway_;
+
+                // Authenticated order stream feeding order_store_; declared last so it stops first
+                std::unique_ptr<open_dtc_server::exchanges::coinbase::CoinbaseUserFeed> user_feed_;
+
                 // Symbol management
                 std::unordered_map<std::string, uint32_t> global_symbol_to_id_;
                 std::unordered_map<uint32_t, std::string> global_id_to_symbol_;
@@ -262,6 +344,10 @@ namespace coinbase_dtc_core
                 std::atomic<uint64_t> total_messages_received_{0};
                 std::atomic<uint64_t> total_trade_updates_sent_{0};
                 std::atomic<uint64_t> total_level2_updates_sent_{0};
+                // Exchange time to receive time of trades, microseconds
+                std::atomic<uint64_t> feed_latency_samples_{0};
+                std::atomic<uint64_t> feed_latency_total_us_{0};
+                std::atomic<uint64_t> feed_latency_max_us_{0};
                 std::chrono::steady_clock::time_point server_start_time_;
 
                 // Delisted symbol tracking
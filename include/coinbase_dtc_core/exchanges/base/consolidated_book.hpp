@@ -0,0 +1,110 @@
+#pragma once
+
+#include "exchange_feed.hpp"
+#include "order_book.hpp"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace base
+        {
+
+            /** Synthetic exchange under which merged books are registered and published */
+            constexpr const char *CONSOLIDATED_EXCHANGE = "CONSOLIDATED";
+
+            /**
+             * Merges per-exchange L2 books of the same normalized symbol into one
+             * consolidated book (size summed per price) and a best bid/offer stream.
+             * The merged book is its own instrument: (CONSOLIDATED_EXCHANGE, symbol),
+             * spelled with the normalized symbol.
+             *
+             * Each exchange delta only touches its own price level: the merged size
+             * at that price is recomputed from the per-exchange books and the change
+             * is published as a consolidated MarketDepthUpdate. Snapshots rebuild the
+             * merged book for that symbol only.
+             *
+             * Only tracked symbols (those with a consolidated subscriber) are merged;
+             * an exchange's first change after tracking starts seeds its book from the
+             * book source. Callbacks run after the books are unlocked, serialized by a
+             * separate publish lock so events still leave in book order. They must not
+             * call back into this book.
+             */
+            class ConsolidatedBook
+            {
+            public:
+                // Current book of an exchange instrument; false if it has none
+                using BookSource = std::function<bool(InstrumentId instrument, OrderBook &book)>;
+
+                // Consolidated depth changes (instrument on CONSOLIDATED_EXCHANGE)
+                void set_depth_callback(DepthCallback callback) { depth_callback_ = callback; }
+
+                // Best bid/offer changes (instrument on CONSOLIDATED_EXCHANGE)
+                void set_level2_callback(Level2Callback callback) { level2_callback_ = callback; }
+
+                // Seeds exchange books when a symbol starts being tracked
+                void set_book_source(BookSource source) { book_source_ = source; }
+
+                /** Start merging a consolidated instrument; counted once per subscriber */
+                void track(InstrumentId instrument);
+
+                /** Drop a subscriber; the symbol's books go with its last one. Untracked instruments are ignored */
+                void untrack(InstrumentId instrument);
+
+                /** Apply one exchange's book change, merged under the instrument's normalized symbol */
+                void apply(const MarketDepthUpdate &update);
+
+                /** Drop an exchange's contribution from every symbol */
+                void remove_exchange(const std::string &exchange);
+
+                /** Current consolidated best bid/offer of a normalized symbol; false if it has no book */
+                bool get_best_bid_offer(const std::string &symbol, MarketLevel2 &bbo) const;
+
+                /** Up to max_levels consolidated levels of a side, best first */
+                std::vector<PriceLevel> get_depth(const std::string &symbol, BookSide side, size_t max_levels) const;
+
+            private:
+                struct SymbolBooks
+                {
+                    std::unordered_map<InstrumentId, OrderBook> exchanges; // By exchange instrument
+                    OrderBook consolidated;
+                    PriceLevel last_bid;
+                    PriceLevel last_ask;
+                    size_t subscribers = 0;
+                };
+
+                // Callbacks gathered under the book lock, invoked after it is released
+                struct Events
+                {
+                    std::vector<MarketDepthUpdate> depth;
+                    std::vector<MarketLevel2> level2;
+                };
+
+                InstrumentId consolidated_instrument(InstrumentId exchange_instrument);
+                const SymbolBooks *find_books(const std::string &symbol) const;
+                void rebuild(InstrumentId instrument, SymbolBooks &books, uint64_t exchange_time_us, uint64_t receive_time_us,
+                             Events &events);
+                void publish_best_bid_offer(InstrumentId instrument, SymbolBooks &books, uint64_t exchange_time_us,
+                                            uint64_t receive_time_us, Events &events);
+                void publish(std::unique_lock<std::mutex> &lock, const Events &events);
+
+                std::unordered_map<InstrumentId, SymbolBooks> symbols_;             // By consolidated instrument
+                std::unordered_map<InstrumentId, InstrumentId> consolidated_ids_; // Exchange -> consolidated instrument
+                std::atomic<size_t> tracked_{0};                                   // Symbols with subscribers
+                mutable std::mutex mutex_;
+                std::mutex publish_mutex_; // Taken before mutex_ is released; never the other way round
+
+                DepthCallback depth_callback_;
+                Level2Callback level2_callback_;
+                BookSource book_source_;
+            };
+
+        } // namespace base
+    } // namespace exchanges
+} // namespace open_dtc_server
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+#include <system_error>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace base
+        {
+            /**
+             * Exchange decimal strings ("43250.12", "0.00000001") to numbers.
+             *
+             * Unlike std::stod these are locale-independent, never allocate or throw,
+             * and reject trailing garbage. parse_decimal() is correctly rounded: plain
+             * decimals with up to 15 significant digits take an exact integer/power-of-ten
+             * path, anything longer or exotic falls back to std::from_chars.
+             *
+             * Books, feeds and DTC messages carry doubles from parse_decimal(); the same
+             * text always yields the same double, which is all level matching needs.
+             * parse_fixed() is for callers that need exact decimal arithmetic and is
+             * not used on the market data path.
+             */
+            namespace decimal
+            {
+                namespace detail
+                {
+                    // Powers of ten exactly representable as a double
+                    constexpr double POW10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+                    constexpr int64_t POW10_INT[] = {1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL,
+                                                     10000000LL, 100000000LL, 1000000000LL, 10000000000LL,
+                                                     100000000000LL, 1000000000000LL, 10000000000000LL,
+                                                     100000000000000LL, 1000000000000000LL, 10000000000000000LL,
+                                                     100000000000000000LL, 1000000000000000000LL};
+
+                    /**
+                     * Split [-]digits[.digits] into sign, mantissa and fraction digit count.
+                     * false on anything else, or past 19 digits where the mantissa could overflow.
+                     */
+                    inline bool split(std::string_view text, bool &negative, uint64_t &mantissa, int &fraction_digits)
+                    {
+                        const char *p = text.data();
+                        const char *end = p + text.size();
+                        negative = p != end && *p == '-';
+                        if (p != end && (*p == '-' || *p == '+'))
+                            ++p;
+
+                        const char *digits_start = p;
+                        uint64_t m = 0;
+                        while (p != end && static_cast<unsigned char>(*p - '0') < 10)
+                            m = m * 10 + static_cast<uint64_t>(*p++ - '0');
+                        size_t digit_count = static_cast<size_t>(p - digits_start);
+
+                        const char *fraction_start = p;
+                        if (p != end && *p == '.')
+                        {
+                            fraction_start = ++p;
+                            while (p != end && static_cast<unsigned char>(*p - '0') < 10)
+                                m = m * 10 + static_cast<uint64_t>(*p++ - '0');
+                            digit_count += static_cast<size_t>(p - fraction_start);
+                        }
+                        if (p != end || digit_count == 0)
+                            return false;
+
+                        // Leading zeros ("0.00000001") do not count towards the 19 digits
+                        if (digit_count > 19)
+                        {
+                            const char *q = digits_start;
+                            while (q != end && (*q == '0' || *q == '.'))
+                            {
+                                if (*q == '0')
+                                    --digit_count;
+                                ++q;
+                            }
+                            if (digit_count > 19)
+                                return false;
+                        }
+
+                        mantissa = m;
+                        fraction_digits = static_cast<int>(p - fraction_start);
+                        return true;
+                    }
+                } // namespace detail
+
+                /** @return false (value untouched) if text is not a complete decimal number */
+                inline bool parse_decimal(std::string_view text, double &value)
+                {
+                    bool negative = false;
+                    uint64_t mantissa = 0;
+                    int fraction_digits = 0;
+                    // Both operands exact, so the single division rounds correctly
+                    if (detail::split(text, negative, mantissa, fraction_digits) &&
+                        mantissa <= (uint64_t(1) << 53) && fraction_digits <= 22)
+                    {
+                        double result = static_cast<double>(mantissa) / detail::POW10[fraction_digits];
+                        value = negative ? -result : result;
+                        return true;
+                    }
+
+                    // Exponents, long mantissas, inf/nan
+                    const char *first = text.data();
+                    const char *last = text.data() + text.size();
+                    if (first != last && *first == '+')
+                        ++first;
+                    if (first == last)
+                        return false;
+                    double parsed = 0.0;
+                    auto result = std::from_chars(first, last, parsed);
+                    if (result.ec != std::errc() || result.ptr != last)
+                        return false;
+                    value = parsed;
+                    return true;
+                }
+
+                /** parse_decimal() for optional fields: fallback when text is empty or malformed */
+                inline double parse_decimal_or(std::string_view text, double fallback)
+                {
+                    double value = 0.0;
+                    return parse_decimal(text, value) ? value : fallback;
+                }
+
+                /**
+                 * Scaled fixed-point: "43250.12" with scale 8 gives 4325012000000.
+                 * @return false if text is malformed, has non-zero digits beyond scale
+                 *         (the value would not be exact) or does not fit in int64_t
+                 */
+                inline bool parse_fixed(std::string_view text, int scale, int64_t &value)
+                {
+                    if (scale < 0 || scale > 18)
+                        return false;
+
+                    bool negative = false;
+                    uint64_t result = 0;
+                    int fraction_digits = 0;
+                    if (!detail::split(text, negative, result, fraction_digits))
+                        return false;
+
+                    constexpr uint64_t LIMIT = static_cast<uint64_t>(INT64_MAX);
+                    if (fraction_digits > scale)
+                    {
+                        // Trailing zeros past the scale are harmless ("1.50000000000")
+                        int excess = fraction_digits - scale;
+                        if (excess > 18)
+                        {
+                            if (result != 0)
+                                return false;
+                        }
+                        else
+                        {
+                            uint64_t divisor = static_cast<uint64_t>(detail::POW10_INT[excess]);
+                            if (result % divisor != 0)
+                                return false;
+                            result /= divisor;
+                        }
+                    }
+                    else
+                    {
+                        uint64_t multiplier = static_cast<uint64_t>(detail::POW10_INT[scale - fraction_digits]);
+                        if (result > LIMIT / multiplier)
+                            return false;
+                        result *= multiplier;
+                    }
+                    if (result > LIMIT)
+                        return false;
+
+                    value = negative ? -static_cast<int64_t>(result) : static_cast<int64_t>(result);
+                    return true;
+                }
+
+                /** Fixed-point value back to a double */
+                inline double fixed_to_double(int64_t value, int scale)
+                {
+                    return static_cast<double>(value) / detail::POW10[scale];
+                }
+
+            } // namespace decimal
+        } // namespace base
+    } // namespace exchanges
+} // namespace open_dtc_server
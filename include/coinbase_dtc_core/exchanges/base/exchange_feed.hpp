@@ -1,6 +1,11 @@
 #pragma once
 
+#include "order_book.hpp"
+#include "spsc_ring.hpp"
+#include "symbol_registry.hpp"
+#include "timestamp.hpp"
 #include <string>
+#include <type_traits>
 #include <vector>
 #include <memory>
 #include <functional>
@@ -14,33 +19,143 @@ namespace open_dtc_server
         namespace base
         {
 
-            // Exchange-agnostic market data structures
+            enum class TradeSide : uint8_t
+            {
+                UNKNOWN = 0,
+                BUY = 1,
+                SELL = 2
+            };
+
+            // Exchange-agnostic market data structures. Trivially copyable: the
+            // symbol, its spellings and the exchange live in the SymbolRegistry.
+            //
+            // Times are microseconds since epoch (see timestamp.hpp). exchange_time_us
+            // is when the exchange says the event happened (receive time if it does
+            // not say); receive_time_us is when the message reached us, so the two
+            // differ by the feed latency.
             struct MarketTrade
             {
-                std::string symbol;   // Normalized symbol (e.g., "BTC/USD")
-                std::string exchange; // Exchange name (e.g., "coinbase")
+                InstrumentId instrument; // SymbolRegistry id (exchange + symbol)
+                TradeSide side;          // Aggressor side
                 double price;
                 double volume;
-                std::string side; // "buy" or "sell"
-                uint64_t timestamp;
-                std::string trade_id;
+                uint64_t exchange_time_us;
+                uint64_t receive_time_us;
+                uint64_t sequence; // Exchange sequence number, 0 if none
+                uint64_t trade_id; // Exchange trade number, 0 if none
 
-                MarketTrade() : price(0.0), volume(0.0), timestamp(0) {}
+                MarketTrade() : instrument(NO_INSTRUMENT), side(TradeSide::UNKNOWN), price(0.0), volume(0.0),
+                                exchange_time_us(0), receive_time_us(0), sequence(0), trade_id(0) {}
             };
 
             struct MarketLevel2
             {
-                std::string symbol;   // Normalized symbol
-                std::string exchange; // Exchange name
+                InstrumentId instrument; // SymbolRegistry id (exchange + symbol)
                 double bid_price;
                 double bid_size;
                 double ask_price;
                 double ask_size;
-                uint64_t timestamp;
+                uint64_t exchange_time_us;
+                uint64_t receive_time_us;
+                uint64_t sequence; // Exchange sequence number, 0 if none
+
+                MarketLevel2() : instrument(NO_INSTRUMENT), bid_price(0.0), bid_size(0.0), ask_price(0.0), ask_size(0.0),
+                                 exchange_time_us(0), receive_time_us(0), sequence(0) {}
+            };
+
+            static_assert(std::is_trivially_copyable<MarketTrade>::value, "MarketTrade must stay trivially copyable");
+            static_assert(std::is_trivially_copyable<MarketLevel2>::value, "MarketLevel2 must stay trivially copyable");
+
+            // One change of a full-depth (L2) book
+            struct MarketDepthUpdate
+            {
+                enum class Action
+                {
+                    SNAPSHOT, // Replace the whole book with *book (empty if null)
+                    SET       // Set size at price; size 0 removes the level
+                };
+
+                InstrumentId instrument; // SymbolRegistry id (exchange + symbol)
+                Action action;
+                bool is_bid;
+                double price;
+                double size;
+                uint64_t exchange_time_us; // As in MarketTrade
+                uint64_t receive_time_us;
+                uint64_t sequence; // Exchange sequence number, 0 if none
+
+                // Positioned change from the feed's own book (type NONE if the feed keeps no book)
+                BookDelta delta;
 
-                MarketLevel2() : bid_price(0.0), bid_size(0.0), ask_price(0.0), ask_size(0.0), timestamp(0) {}
+                // Full book for SNAPSHOT
+                std::shared_ptr<const OrderBook> book;
+
+                MarketDepthUpdate() : instrument(NO_INSTRUMENT), action(Action::SET), is_bid(true), price(0.0), size(0.0),
+                                      exchange_time_us(0), receive_time_us(0), sequence(0) {}
+            };
+
+            /**
+             * Any published event in one trivially copyable slot, for rings between
+             * feed threads. A depth SNAPSHOT's book does not fit: whoever queues the
+             * event passes the book alongside it and hands it back to depth_update().
+             */
+            struct MarketEvent
+            {
+                enum class Type : uint8_t
+                {
+                    TRADE,
+                    LEVEL2,
+                    DEPTH
+                };
+
+                // MarketDepthUpdate without the book
+                struct Depth
+                {
+                    InstrumentId instrument;
+                    MarketDepthUpdate::Action action;
+                    bool is_bid;
+                    double price;
+                    double size;
+                    uint64_t exchange_time_us;
+                    uint64_t receive_time_us;
+                    uint64_t sequence;
+                    BookDelta delta;
+                };
+
+                Type type;
+                union
+                {
+                    MarketTrade trade;
+                    MarketLevel2 level2;
+                    Depth depth;
+                };
+
+                MarketEvent() : type(Type::TRADE), trade() {}
+                explicit MarketEvent(const MarketTrade &t) : type(Type::TRADE), trade(t) {}
+                explicit MarketEvent(const MarketLevel2 &l) : type(Type::LEVEL2), level2(l) {}
+                explicit MarketEvent(const MarketDepthUpdate &u)
+                    : type(Type::DEPTH), depth{u.instrument, u.action, u.is_bid, u.price, u.size,
+                                               u.exchange_time_us, u.receive_time_us, u.sequence, u.delta} {}
+
+                MarketDepthUpdate depth_update(std::shared_ptr<const OrderBook> book = nullptr) const
+                {
+                    MarketDepthUpdate update;
+                    update.instrument = depth.instrument;
+                    update.action = depth.action;
+                    update.is_bid = depth.is_bid;
+                    update.price = depth.price;
+                    update.size = depth.size;
+                    update.exchange_time_us = depth.exchange_time_us;
+                    update.receive_time_us = depth.receive_time_us;
+                    update.sequence = depth.sequence;
+                    update.delta = depth.delta;
+                    update.book = std::move(book);
+                    return update;
+                }
             };
 
+            static_assert(std::is_trivially_copyable<MarketEvent>::value, "MarketEvent must stay trivially copyable");
+
             // Exchange configuration
             struct ExchangeConfig
             {
@@ -53,15 +168,50 @@ namespace open_dtc_server
                 std::string secret_key;
                 std::string passphrase; // For Coinbase Pro
 
-                ExchangeConfig() : port(443), requires_auth(false) {}
+                // Replay feed only: MarketJournal directory and speed (1 = original timing, N = N×, 0 = as fast as possible)
+                std::string replay_path;
+                double replay_speed;
+
+                // Coinbase feed only: append raw WebSocket payloads with receive timestamps to this file
+                std::string capture_file;
+
+                // Coinbase feed only: upstream WebSocket connections to spread products over
+                size_t websocket_connections;
+
+                // Coinbase feed only: a second connection (B) per product set, to the next resolved address,
+                // with the first copy of every message forwarded (A/B arbitration)
+                bool redundant_feed;
+
+                // Coinbase feed only, off by default: socket reads, parsing and distribution on separate threads
+                // joined by bounded rings of pipeline_capacity slots; pipeline_wait is how an idle or blocked stage waits
+                bool feed_pipeline;
+                WaitStrategy pipeline_wait;
+                size_t pipeline_capacity;
+
+                ExchangeConfig() : port(443), requires_auth(false), replay_speed(1.0), websocket_connections(1),
+                                   redundant_feed(false), feed_pipeline(false), pipeline_wait(WaitStrategy::FUTEX), pipeline_capacity(4096) {}
             };
 
             // Callback types for market data
             using TradeCallback = std::function<void(const MarketTrade &)>;
             using Level2Callback = std::function<void(const MarketLevel2 &)>;
+            using DepthCallback = std::function<void(const MarketDepthUpdate &)>;
             using ConnectionCallback = std::function<void(bool connected, const std::string &exchange)>;
             using ErrorCallback = std::function<void(const std::string &error, const std::string &exchange)>;
 
+            /**
+             * Sink for everything a feed publishes (e.g. MarketJournal).
+             * Called on the feed thread before the callbacks, so it must not block.
+             */
+            class MarketDataRecorder
+            {
+            public:
+                virtual ~MarketDataRecorder() = default;
+                virtual void record_trade(const MarketTrade &trade) = 0;
+                virtual void record_level2(const MarketLevel2 &level2) = 0;
+                virtual void record_depth(const MarketDepthUpdate &update) = 0;
+            };
+
             /**
              * Abstract base class for exchange market data feeds.
              *
@@ -129,13 +279,52 @@ namespace open_dtc_server
                 // Callback management
                 void set_trade_callback(TradeCallback callback) { trade_callback_ = callback; }
                 void set_level2_callback(Level2Callback callback) { level2_callback_ = callback; }
+                void set_depth_callback(DepthCallback callback) { depth_callback_ = callback; }
                 void set_connection_callback(ConnectionCallback callback) { connection_callback_ = callback; }
                 void set_error_callback(ErrorCallback callback) { error_callback_ = callback; }
 
+                // Persist published market data; set before connect()
+                void set_recorder(std::shared_ptr<MarketDataRecorder> recorder) { recorder_ = std::move(recorder); }
+
                 // Configuration access
                 const ExchangeConfig &get_config() const { return config_; }
                 std::string get_exchange_name() const { return config_.name; }
 
+                /**
+                 * Register one of this exchange's symbols with its normalized spelling and
+                 * add it to the feed's table. Called where products are loaded or
+                 * subscribed, never from the message handlers.
+                 */
+                InstrumentId register_instrument(std::string_view exchange_symbol)
+                {
+                    InstrumentId id = instruments_.find(exchange_symbol);
+                    if (id != NO_INSTRUMENT)
+                        return id;
+
+                    auto &registry = SymbolRegistry::getInstance();
+                    id = registry.find(config_.name, exchange_symbol);
+                    if (id == NO_INSTRUMENT)
+                    {
+                        std::string symbol(exchange_symbol);
+                        id = registry.intern(config_.name, symbol, normalize_symbol(symbol));
+                    }
+                    instruments_.add(registry.get(id));
+                    return id;
+                }
+
+                /**
+                 * Registry id of a registered symbol, NO_INSTRUMENT for products the feed
+                 * never loaded or subscribed. A lock-free table lookup; the registry is
+                 * only consulted once the table is full.
+                 */
+                InstrumentId instrument_for(std::string_view exchange_symbol) const
+                {
+                    InstrumentId id = instruments_.find(exchange_symbol);
+                    if (id == NO_INSTRUMENT && instruments_.full())
+                        id = SymbolRegistry::getInstance().find(config_.name, exchange_symbol);
+                    return id;
+                }
+
             protected:
                 // ========================================================================
                 // HELPER METHODS FOR DERIVED CLASSES
@@ -144,6 +333,8 @@ namespace open_dtc_server
                 /** Notify all listeners of new trade data */
                 void notify_trade(const MarketTrade &trade)
                 {
+                    if (recorder_)
+                        recorder_->record_trade(trade);
                     if (trade_callback_)
                         trade_callback_(trade);
                 }
@@ -151,10 +342,21 @@ namespace open_dtc_server
                 /** Notify all listeners of new level2 data */
                 void notify_level2(const MarketLevel2 &level2)
                 {
+                    if (recorder_)
+                        recorder_->record_level2(level2);
                     if (level2_callback_)
                         level2_callback_(level2);
                 }
 
+                /** Notify all listeners of a full-depth book change */
+                void notify_depth(const MarketDepthUpdate &update)
+                {
+                    if (recorder_)
+                        recorder_->record_depth(update);
+                    if (depth_callback_)
+                        depth_callback_(update);
+                }
+
                 /** Notify connection status change */
                 void notify_connection(bool connected)
                 {
@@ -176,8 +378,14 @@ namespace open_dtc_server
                 // Callbacks
                 TradeCallback trade_callback_;
                 Level2Callback level2_callback_;
+                DepthCallback depth_callback_;
                 ConnectionCallback connection_callback_;
                 ErrorCallback error_callback_;
+
+                std::shared_ptr<MarketDataRecorder> recorder_;
+
+                // This feed's products, filled as they are loaded
+                InstrumentTable instruments_;
             };
 
             // Multi-exchange aggregator
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "exchange_feed.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace base
+        {
+
+            /**
+             * One journal entry. Fixed 64 bytes so segments can be indexed by
+             * sequence and read by other tools without a parser.
+             */
+            struct JournalRecord
+            {
+                enum Type : uint8_t
+                {
+                    TRADE = 1,      // price/size of a trade, side 1 = buy, 2 = sell, 0 = unknown
+                    QUOTE = 2,      // Best bid (side 1) or best ask (side 2) from notify_level2
+                    BOOK_DELTA = 3, // BookDelta at position (delta_type = BookDelta::Type)
+                    BOOK_RESET = 4, // Book snapshot begins; followed by its BOOK_LEVEL records
+                    BOOK_LEVEL = 5  // One snapshot level at position
+                };
+
+                static constexpr size_t SYMBOL_SIZE = 24;
+
+                uint64_t sequence;  // 1-based, contiguous across segments
+                uint64_t timestamp; // Exchange event time (microseconds since epoch)
+                uint8_t type;
+                uint8_t side;       // BookSide for book records
+                uint8_t delta_type;
+                uint8_t reserved;
+                uint16_t position;
+                uint16_t reserved2;
+                double price;
+                double size;
+                char symbol[SYMBOL_SIZE]; // Exchange spelling, null-padded, truncated if longer
+            };
+            static_assert(sizeof(JournalRecord) == 64, "JournalRecord must stay 64 bytes");
+
+            /**
+             * Segment file header (64 bytes, followed by capacity records).
+             * committed is the number of complete records; the writer publishes it
+             * with release ordering after copying a record, so a reader that loads
+             * it (acquire) can read that many records while the file grows.
+             */
+            struct JournalSegmentHeader
+            {
+                static constexpr char MAGIC[8] = {'D', 'T', 'C', 'J', 'R', 'N', 'L', '1'};
+
+                char magic[8];
+                uint32_t version;
+                uint32_t record_size;
+                uint64_t capacity;
+                uint64_t first_sequence;
+                std::atomic<uint64_t> committed;
+                uint8_t reserved[24];
+            };
+            static_assert(sizeof(JournalSegmentHeader) == 64, "JournalSegmentHeader must stay 64 bytes");
+            static_assert(std::atomic<uint64_t>::is_always_lock_free, "committed must be lock free in shared memory");
+
+            struct JournalConfig
+            {
+                enum class SyncPolicy
+                {
+                    NONE,    // Leave write-back to the OS
+                    ON_ROLL, // msync each segment when it is closed
+                    INTERVAL // Background msync of the open segment every sync_interval_ms
+                };
+
+                std::string directory;                  // Segments: <directory>/<first_sequence>.jrnl
+                uint64_t records_per_segment = 1 << 20; // 64 MiB segments
+                size_t retain_segments = 0;             // Oldest segments beyond this are deleted, 0 = keep all
+                SyncPolicy sync_policy = SyncPolicy::ON_ROLL;
+                uint32_t sync_interval_ms = 1000;
+            };
+
+            /**
+             * Append-only, memory-mapped journal of one feed's normalized market data.
+             *
+             * Single writer: attach one journal per feed (set_recorder) so records are
+             * only ever appended from that feed's thread. Appending is a memcpy into
+             * the mapped segment plus a release store of the committed count. A
+             * background thread keeps the next segment mapped ahead of time and owns
+             * every slow file operation (sync, unmap, retention), so a roll only swaps
+             * segments under the mutex; the writer waits only if it outruns that thread.
+             */
+            class MarketJournal : public MarketDataRecorder
+            {
+            public:
+                explicit MarketJournal(const JournalConfig &config);
+                ~MarketJournal() override;
+
+                MarketJournal(const MarketJournal &) = delete;
+                MarketJournal &operator=(const MarketJournal &) = delete;
+
+                /** Create the directory, map the first segment and start the background thread */
+                bool open();
+
+                /** Sync (unless SyncPolicy::NONE) and unmap the open segment; the unused next one is deleted */
+                void close();
+
+                void record_trade(const MarketTrade &trade) override;
+                void record_level2(const MarketLevel2 &level2) override;
+                void record_depth(const MarketDepthUpdate &update) override;
+
+                /** Append one record; its sequence is assigned here */
+                void append(JournalRecord &record);
+
+                uint64_t get_next_sequence() const { return next_sequence_; }
+                uint64_t get_dropped_records() const { return dropped_records_.load(std::memory_order_relaxed); }
+                const JournalConfig &get_config() const { return config_; }
+
+            private:
+                struct Segment
+                {
+                    int fd = -1;
+                    uint8_t *base = nullptr;
+                    size_t length = 0;
+                    JournalSegmentHeader *header = nullptr;
+                    JournalRecord *records = nullptr;
+                };
+
+                bool roll();
+                bool map_segment(uint64_t first_sequence, Segment &segment);
+                static void unmap_segment(Segment &segment, bool sync);
+                void apply_retention(uint64_t current_first_sequence);
+                void background_thread_function();
+                bool sync_on_roll() const;
+
+                static void fill(JournalRecord &record, uint8_t type, InstrumentId instrument, uint64_t timestamp);
+
+                JournalConfig config_;
+                Segment segment_; // Written by the feed thread, swapped under segment_mutex_
+                uint64_t next_sequence_ = 1;
+                uint64_t segment_used_ = 0;
+                std::atomic<uint64_t> dropped_records_{0};
+
+                // Under segment_mutex_, handed between the writer and the background thread
+                Segment next_;                 // Mapped ahead for the next roll
+                bool next_failed_ = false;     // Mapping next_ failed; retried after a pause
+                std::vector<Segment> retired_; // Rolled out, waiting to be synced and unmapped
+
+                std::mutex segment_mutex_;
+                std::thread background_thread_;
+                std::condition_variable background_cv_; // Work for the background thread
+                std::condition_variable next_cv_;       // next_ mapped or failed
+                bool stopping_ = false;
+                bool opened_ = false;
+            };
+
+            /**
+             * Reads journal segments in sequence order, including the one being
+             * written. poll() returns what is committed so far and can be called
+             * again to tail the journal.
+             */
+            class JournalReader
+            {
+            public:
+                explicit JournalReader(const std::string &directory);
+
+                /** Read up to max_records records not returned before */
+                size_t poll(std::vector<JournalRecord> &out, size_t max_records = 65536);
+
+                /** Segment files in the directory, oldest first */
+                static std::vector<std::string> list_segments(const std::string &directory);
+
+            private:
+                std::string directory_;
+                std::string current_segment_;
+                uint64_t next_record_ = 0;
+            };
+
+        } // namespace base
+    } // namespace exchanges
+} // namespace open_dtc_server
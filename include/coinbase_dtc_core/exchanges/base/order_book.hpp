@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace base
+        {
+
+            enum class BookSide : uint8_t
+            {
+                BID = 1,
+                ASK = 2
+            };
+
+            struct PriceLevel
+            {
+                double price;
+                double size;
+
+                PriceLevel() : price(0.0), size(0.0) {}
+                PriceLevel(double p, double s) : price(p), size(s) {}
+            };
+
+            /**
+             * Result of applying one price level change to an OrderBook.
+             * position is the level index counted from the best price (0 = best);
+             * full books run deeper than any DTC position, so it is not narrowed here.
+             */
+            struct BookDelta
+            {
+                enum class Type : uint8_t
+                {
+                    NONE,
+                    INSERT,
+                    UPDATE,
+                    DELETE
+                };
+
+                Type type;
+                BookSide side;
+                uint32_t position;
+                double price;
+                double size;
+
+                BookDelta() : type(Type::NONE), side(BookSide::BID), position(0), price(0.0), size(0.0) {}
+            };
+
+            /**
+             * Price-aggregated (L2) order book for one symbol.
+             *
+             * Each side is a flat vector sorted so that the best price sits at the
+             * back; most exchange traffic touches the top of the book, so inserts
+             * and erases there only move a handful of elements.
+             */
+            class OrderBook
+            {
+            public:
+                /** Set the size at a price level; size <= 0 removes the level */
+                BookDelta apply(BookSide side, double price, double size);
+
+                /**
+                 * Replay a delta produced by another book's apply() without searching.
+                 * Checked against the prices around its position, never applied blindly.
+                 * @return false if the delta does not fit this book (books out of sync); fall back to apply()
+                 */
+                bool apply_delta(const BookDelta &delta);
+
+                /** Replace a side with unsorted levels in O(n log n); zero sizes are dropped */
+                void load(BookSide side, std::vector<PriceLevel> levels);
+
+                /** Remove every level on both sides */
+                void clear();
+
+                /** Number of levels on a side */
+                size_t depth(BookSide side) const;
+
+                /** Level at a position counted from the best price, nullptr if out of range */
+                const PriceLevel *level(BookSide side, size_t position) const;
+
+                /** Size resting at an exact price, 0 if the level does not exist */
+                double size_at(BookSide side, double price) const;
+
+                /** Best bid/ask in O(1), nullptr if the side is empty */
+                const PriceLevel *best_bid() const { return bids_.empty() ? nullptr : &bids_.back(); }
+                const PriceLevel *best_ask() const { return asks_.empty() ? nullptr : &asks_.back(); }
+
+                /** Copy up to max_levels levels of a side, best price first */
+                std::vector<PriceLevel> get_depth(BookSide side, size_t max_levels) const;
+
+            private:
+                std::vector<PriceLevel>::const_iterator find(BookSide side, double price) const;
+
+                std::vector<PriceLevel> &levels(BookSide side) { return side == BookSide::BID ? bids_ : asks_; }
+                const std::vector<PriceLevel> &levels(BookSide side) const { return side == BookSide::BID ? bids_ : asks_; }
+
+                std::vector<PriceLevel> bids_; // Ascending price, best bid at back
+                std::vector<PriceLevel> asks_; // Descending price, best ask at back
+            };
+
+        } // namespace base
+    } // namespace exchanges
+} // namespace open_dtc_server
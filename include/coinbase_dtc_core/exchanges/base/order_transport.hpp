@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace base
+        {
+
+            /** Raw exchange reply to an order request */
+            struct OrderResponse
+            {
+                int status_code = 0; // HTTP status, -1 when the request never completed
+                std::string body;
+                std::string error_message;
+            };
+
+            /** Lifecycle of an exchange order as reported by the exchange */
+            enum class OrderState
+            {
+                PENDING,
+                OPEN,
+                FILLED,
+                CANCELED,
+                EXPIRED,
+                REJECTED,
+                UNKNOWN
+            };
+
+            enum class OrderKind
+            {
+                MARKET,
+                LIMIT,
+                STOP,
+                STOP_LIMIT,
+                UNKNOWN
+            };
+
+            /** Exchange view of one order (from an order stream or order history) */
+            struct OrderEvent
+            {
+                std::string order_id;        // Exchange order ID
+                std::string client_order_id; // ID the order was submitted with
+                std::string symbol;
+                bool is_buy = true;
+                OrderKind kind = OrderKind::UNKNOWN;
+                OrderState state = OrderState::UNKNOWN;
+                double limit_price = 0.0;
+                double stop_price = 0.0;
+                double quantity = 0.0;        // Filled plus remaining
+                double filled_quantity = 0.0; // Cumulative
+                double average_fill_price = 0.0;
+                uint64_t created_time_ms = 0;
+            };
+
+            /** One execution against an order */
+            struct FillEvent
+            {
+                std::string order_id; // Exchange order ID
+                std::string trade_id;
+                std::string symbol;
+                bool is_buy = true;
+                double price = 0.0;
+                double quantity = 0.0;
+                uint64_t time_ms = 0;
+            };
+
+            /**
+             * Sends exchange-native order requests.
+             *
+             * Implementations keep whatever makes the next request cheap (open
+             * connection, signed credentials) ready between orders; keep_warm is
+             * called from the same thread as submit_order whenever it is idle.
+             */
+            class OrderTransport
+            {
+            public:
+                virtual ~OrderTransport() = default;
+
+                /**
+                 * Submit one order; body is the exchange's JSON order request.
+                 * Sending the same body again must not place a second order: the
+                 * exchange answers with the order already placed under its client
+                 * order ID, which is how a request that got no reply is reconciled.
+                 */
+                virtual OrderResponse submit_order(const std::string &body) = 0;
+
+                /**
+                 * Refresh connection and credentials so the next submit_order does no setup.
+                 * @return true when the exchange is reachable, false while reconnecting
+                 */
+                virtual bool keep_warm() { return true; }
+            };
+
+        } // namespace base
+    } // namespace exchanges
+} // namespace open_dtc_server
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace base
+        {
+
+            /**
+             * Checks one stream of exchange sequence numbers (per product, per channel).
+             *
+             * A contiguous stream numbers every message it delivers n, n+1, ...; a jump
+             * is a GAP and missing() says how many messages were lost. A monotonic
+             * stream shares its numbers with messages we never receive (Coinbase
+             * ticker and matches), so jumps are normal and only repeats or reordering
+             * are detected. Sequence 0 means "none" and must not be observed.
+             */
+            class SequenceTracker
+            {
+            public:
+                enum class Result
+                {
+                    FIRST,    // First number since construction or reset()
+                    IN_ORDER, // Next in the stream
+                    GAP,      // Contiguous stream skipped missing() numbers
+                    STALE     // Repeated or older than the last one: drop the message
+                };
+
+                explicit SequenceTracker(bool contiguous = true) : contiguous_(contiguous) {}
+
+                Result observe(uint64_t sequence)
+                {
+                    if (last_ == 0)
+                    {
+                        last_ = sequence;
+                        return Result::FIRST;
+                    }
+                    if (sequence <= last_)
+                        return Result::STALE;
+
+                    uint64_t expected = last_ + 1;
+                    last_ = sequence;
+                    if (contiguous_ && sequence != expected)
+                    {
+                        missing_ = sequence - expected;
+                        return Result::GAP;
+                    }
+                    return Result::IN_ORDER;
+                }
+
+                /** Forget the stream, e.g. after a snapshot; the next number starts it again */
+                void reset() { last_ = 0; }
+
+                uint64_t last() const { return last_; }
+                uint64_t missing() const { return missing_; }
+
+            private:
+                bool contiguous_;
+                uint64_t last_ = 0;
+                uint64_t missing_ = 0;
+            };
+
+        } // namespace base
+    } // namespace exchanges
+} // namespace open_dtc_server
@@ -0,0 +1,334 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <thread>
+
+#if defined(__linux__)
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace base
+        {
+
+            /**
+             * How a pipeline thread waits for its ring to fill or drain.
+             *
+             * SPIN burns a core for the lowest wakeup latency and needs a core per
+             * spinning thread, or it waits out whole scheduler slices. YIELD gives
+             * the core to other runnable threads between checks. FUTEX sleeps in the
+             * kernel until the other side signals (a condition variable where there
+             * is no futex). All three spin briefly first.
+             */
+            enum class WaitStrategy : uint8_t
+            {
+                SPIN,
+                YIELD,
+                FUTEX
+            };
+
+            inline const char *to_string(WaitStrategy strategy)
+            {
+                switch (strategy)
+                {
+                case WaitStrategy::SPIN:
+                    return "spin";
+                case WaitStrategy::YIELD:
+                    return "yield";
+                case WaitStrategy::FUTEX:
+                    return "futex";
+                }
+                return "unknown";
+            }
+
+            /** "spin", "yield" or "futex"; false leaves strategy unchanged */
+            inline bool parse_wait_strategy(std::string_view name, WaitStrategy &strategy)
+            {
+                if (name == "spin")
+                    strategy = WaitStrategy::SPIN;
+                else if (name == "yield")
+                    strategy = WaitStrategy::YIELD;
+                else if (name == "futex")
+                    strategy = WaitStrategy::FUTEX;
+                else
+                    return false;
+                return true;
+            }
+
+            /** One iteration of a busy-wait loop */
+            inline void cpu_relax()
+            {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+                _mm_pause();
+#elif defined(__aarch64__)
+                asm volatile("yield");
+#endif
+            }
+
+            /**
+             * Blocks one thread until a condition holds, per WaitStrategy.
+             *
+             * The waiter passes the condition; whoever makes it true calls notify().
+             * notify() is free for SPIN and YIELD and one atomic increment for FUTEX
+             * unless someone is actually asleep. Sleeps are capped at MAX_SLEEP so a
+             * waiter rechecks even if a wakeup were lost.
+             */
+            class Parker
+            {
+            public:
+                explicit Parker(WaitStrategy strategy = WaitStrategy::FUTEX) : strategy_(strategy) {}
+
+                Parker(const Parker &) = delete;
+                Parker &operator=(const Parker &) = delete;
+
+                WaitStrategy strategy() const { return strategy_; }
+
+                template <typename Ready>
+                void wait(Ready ready)
+                {
+                    for (int i = 0; i < SPIN_ROUNDS; ++i)
+                    {
+                        if (ready())
+                            return;
+                        cpu_relax();
+                    }
+
+                    while (!ready())
+                    {
+                        switch (strategy_)
+                        {
+                        case WaitStrategy::SPIN:
+                            cpu_relax();
+                            break;
+                        case WaitStrategy::YIELD:
+                            std::this_thread::yield();
+                            break;
+                        case WaitStrategy::FUTEX:
+                        {
+                            // Read the epoch before announcing ourselves: a notify() in between changes it and the sleep returns at once
+                            uint32_t seen = epoch_.load(std::memory_order_acquire);
+                            sleepers_.fetch_add(1, std::memory_order_relaxed);
+                            std::atomic_thread_fence(std::memory_order_seq_cst);
+                            if (!ready())
+                                sleep(seen);
+                            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+                            break;
+                        }
+                        }
+                    }
+                }
+
+                void notify()
+                {
+                    if (strategy_ != WaitStrategy::FUTEX)
+                        return;
+                    epoch_.fetch_add(1, std::memory_order_release);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    if (sleepers_.load(std::memory_order_relaxed) != 0)
+                        wake();
+                }
+
+            private:
+                static constexpr int SPIN_ROUNDS = 128;
+                static constexpr std::chrono::milliseconds MAX_SLEEP{50};
+
+#if defined(__linux__)
+                static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be a plain 32-bit integer");
+
+                void sleep(uint32_t seen)
+                {
+                    timespec timeout{0, static_cast<long>(std::chrono::nanoseconds(MAX_SLEEP).count())};
+                    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&epoch_), FUTEX_WAIT_PRIVATE, seen, &timeout, nullptr, 0);
+                }
+
+                void wake()
+                {
+                    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&epoch_), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+                }
+#else
+                void sleep(uint32_t seen)
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    if (epoch_.load(std::memory_order_acquire) == seen)
+                        cv_.wait_for(lock, MAX_SLEEP);
+                }
+
+                void wake()
+                {
+                    // Taking the lock orders us after a sleeper's epoch check
+                    {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                    }
+                    cv_.notify_one();
+                }
+
+                std::mutex mutex_;
+                std::condition_variable cv_;
+#endif
+
+                WaitStrategy strategy_;
+                std::atomic<uint32_t> epoch_{0};
+                std::atomic<uint32_t> sleepers_{0};
+            };
+
+            /**
+             * Bounded lock-free single-producer/single-consumer ring.
+             *
+             * The producer writes in place: claim() a slot, fill it, publish(). The
+             * consumer reads in place: front(), use it, pop(). Slots are reused, so
+             * a T that keeps its capacity (std::string) stops allocating once warm.
+             * Neither side ever blocks; pair with Parker to wait for room or data.
+             *
+             * Head and tail live on their own cache lines, and each side keeps a
+             * cached copy of the other's index so the shared line is only read when
+             * the ring looks full (producer) or empty (consumer). size() and
+             * high_water() may be read from any thread; high_water() counts from the
+             * producer's cached tail, so it can overstate by what the consumer took
+             * since the producer last looked.
+             */
+            template <typename T>
+            class SpscRing
+            {
+            public:
+                using value_type = T;
+
+                /** capacity is rounded up to a power of two */
+                explicit SpscRing(size_t capacity)
+                    : mask_(round_up(capacity) - 1),
+                      slots_(new T[mask_ + 1]())
+                {
+                }
+
+                SpscRing(const SpscRing &) = delete;
+                SpscRing &operator=(const SpscRing &) = delete;
+
+                size_t capacity() const { return mask_ + 1; }
+
+                // ---- Producer ----
+
+                /** Next free slot, or nullptr if full */
+                T *claim()
+                {
+                    size_t head = head_.load(std::memory_order_relaxed);
+                    if (head - cached_tail_ > mask_)
+                    {
+                        cached_tail_ = tail_.load(std::memory_order_acquire);
+                        if (head - cached_tail_ > mask_)
+                            return nullptr;
+                    }
+                    return &slots_[head & mask_];
+                }
+
+                /** Hand the claimed slot to the consumer */
+                void publish()
+                {
+                    size_t head = head_.load(std::memory_order_relaxed) + 1;
+                    head_.store(head, std::memory_order_release);
+                    size_t used = head - cached_tail_;
+                    if (used > high_water_.load(std::memory_order_relaxed))
+                        high_water_.store(used, std::memory_order_relaxed);
+                }
+
+                bool try_push(const T &value)
+                {
+                    T *slot = claim();
+                    if (!slot)
+                        return false;
+                    *slot = value;
+                    publish();
+                    return true;
+                }
+
+                // ---- Consumer ----
+
+                /** Oldest published slot, or nullptr if empty */
+                T *front()
+                {
+                    size_t tail = tail_.load(std::memory_order_relaxed);
+                    if (tail == cached_head_)
+                    {
+                        cached_head_ = head_.load(std::memory_order_acquire);
+                        if (tail == cached_head_)
+                            return nullptr;
+                    }
+                    return &slots_[tail & mask_];
+                }
+
+                /** Release the front slot back to the producer */
+                void pop()
+                {
+                    tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+                }
+
+                bool try_pop(T &value)
+                {
+                    T *slot = front();
+                    if (!slot)
+                        return false;
+                    value = std::move(*slot);
+                    pop();
+                    return true;
+                }
+
+                // ---- Either side / observers ----
+
+                size_t size() const
+                {
+                    size_t tail = tail_.load(std::memory_order_acquire);
+                    return head_.load(std::memory_order_acquire) - tail;
+                }
+
+                bool empty() const { return size() == 0; }
+
+                /** Most slots ever in use at once (see class comment) */
+                size_t high_water() const { return high_water_.load(std::memory_order_relaxed); }
+
+                /** Items published since construction */
+                uint64_t published() const { return head_.load(std::memory_order_relaxed); }
+
+            private:
+                static constexpr size_t CACHE_LINE = 64;
+
+                static size_t round_up(size_t capacity)
+                {
+                    size_t size = 2;
+                    while (size < capacity)
+                        size <<= 1;
+                    return size;
+                }
+
+                // Read-only after construction, shared by both sides
+                const size_t mask_;
+                std::unique_ptr<T[]> slots_;
+
+                // Producer
+                alignas(CACHE_LINE) std::atomic<size_t> head_{0};
+                size_t cached_tail_ = 0;
+                std::atomic<size_t> high_water_{0};
+
+                // Consumer
+                alignas(CACHE_LINE) std::atomic<size_t> tail_{0};
+                size_t cached_head_ = 0;
+            };
+
+        } // namespace base
+    } // namespace exchanges
+} // namespace open_dtc_server
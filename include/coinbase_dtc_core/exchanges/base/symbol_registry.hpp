@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace base
+        {
+
+            /** Dense process-wide instrument number; 0 means "no instrument" */
+            using InstrumentId = uint32_t;
+            constexpr InstrumentId NO_INSTRUMENT = 0;
+
+            /** One symbol on one exchange, with both spellings precomputed */
+            struct Instrument
+            {
+                InstrumentId id = NO_INSTRUMENT;
+                std::string exchange;        // Exchange name (e.g., "coinbase")
+                std::string exchange_symbol; // As on the wire (e.g., "BTC-USD")
+                std::string symbol;          // Normalized (e.g., "BTC/USD")
+            };
+
+            /**
+             * Interns (exchange, exchange symbol) pairs as dense InstrumentIds.
+             *
+             * Feeds intern their products when they load or subscribe them; market
+             * events then carry only the id and consumers index straight into the
+             * registry. Instruments are never removed, so references returned by
+             * get() stay valid for the life of the process. get() is lock-free;
+             * intern() and find() take a mutex and do not allocate on a hit.
+             */
+            class SymbolRegistry
+            {
+            public:
+                static constexpr size_t MAX_INSTRUMENTS = 16384;
+
+                static SymbolRegistry &getInstance();
+
+                SymbolRegistry();
+                SymbolRegistry(const SymbolRegistry &) = delete;
+                SymbolRegistry &operator=(const SymbolRegistry &) = delete;
+
+                /**
+                 * Id of exchange_symbol on exchange, registering it on first use.
+                 * @return NO_INSTRUMENT if the registry is full
+                 */
+                InstrumentId intern(std::string_view exchange, std::string_view exchange_symbol, std::string_view symbol);
+
+                /** Id of a registered instrument, NO_INSTRUMENT if unknown */
+                InstrumentId find(std::string_view exchange, std::string_view exchange_symbol) const;
+
+                /** Registered instrument, nullptr for NO_INSTRUMENT or unknown ids */
+                const Instrument *get(InstrumentId id) const
+                {
+                    if (id == NO_INSTRUMENT || id > count_.load(std::memory_order_acquire))
+                        return nullptr;
+                    return instruments_[id].get();
+                }
+
+                /** Spellings of an instrument; empty for unknown ids */
+                const std::string &exchange(InstrumentId id) const;
+                const std::string &exchange_symbol(InstrumentId id) const;
+                const std::string &symbol(InstrumentId id) const;
+
+                size_t size() const { return count_.load(std::memory_order_acquire); }
+
+            private:
+                static size_t hash(std::string_view exchange, std::string_view exchange_symbol);
+                InstrumentId find_locked(size_t key, std::string_view exchange, std::string_view exchange_symbol) const;
+
+                // Index = InstrumentId; sized once so readers never see a reallocation
+                std::vector<std::unique_ptr<Instrument>> instruments_;
+                std::atomic<size_t> count_{0};
+
+                // Hash of (exchange, exchange symbol) -> ids with that hash
+                std::unordered_multimap<size_t, InstrumentId> index_;
+                mutable std::mutex mutex_;
+            };
+
+            /**
+             * One feed's exchange symbols mapped to their registered instruments.
+             *
+             * Filled as the feed loads or subscribes products, so the handlers that
+             * turn each message's product into an InstrumentId never take the
+             * registry mutex. Open addressing over a fixed slot array: find() reads
+             * without a lock or allocation, and add() publishes with a
+             * compare-exchange, so entries are never moved or removed.
+             */
+            class InstrumentTable
+            {
+            public:
+                static constexpr size_t CAPACITY = 4096;              // Slots
+                static constexpr size_t MAX_ENTRIES = CAPACITY / 4 * 3; // Short probe runs keep find() cheap
+
+                InstrumentTable();
+                InstrumentTable(const InstrumentTable &) = delete;
+                InstrumentTable &operator=(const InstrumentTable &) = delete;
+
+                /** Id of a symbol added before, NO_INSTRUMENT otherwise */
+                InstrumentId find(std::string_view exchange_symbol) const;
+
+                /** @return false if the table is full; the caller keeps using the registry */
+                bool add(const Instrument *instrument);
+
+                size_t size() const { return count_.load(std::memory_order_relaxed); }
+                bool full() const { return size() >= MAX_ENTRIES; }
+
+            private:
+                static size_t slot_for(std::string_view exchange_symbol);
+
+                std::unique_ptr<std::atomic<const Instrument *>[]> slots_;
+                std::atomic<size_t> count_{0};
+            };
+
+        } // namespace base
+    } // namespace exchanges
+} // namespace open_dtc_server
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace base
+        {
+            /**
+             * Market event times: microseconds since the Unix epoch, UTC.
+             *
+             * parse_iso8601() reads exchange timestamps ("2024-03-01T14:30:05.123456Z")
+             * without allocating, going through std::tm or consulting the time zone.
+             */
+            namespace timestamp
+            {
+                /** Wall clock now, microseconds since epoch */
+                inline uint64_t now_us()
+                {
+                    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                                     std::chrono::system_clock::now().time_since_epoch())
+                                                     .count());
+                }
+
+                namespace detail
+                {
+                    // Days from 1970-01-01 to a proleptic Gregorian date (H. Hinnant's days_from_civil)
+                    constexpr int64_t days_from_civil(int64_t y, unsigned m, unsigned d)
+                    {
+                        y -= m <= 2;
+                        const int64_t era = (y >= 0 ? y : y - 399) / 400;
+                        const unsigned yoe = static_cast<unsigned>(y - era * 400);
+                        const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+                        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+                        return era * 146097 + static_cast<int64_t>(doe) - 719468;
+                    }
+
+                    // Exactly count digits at p; false if any is not a digit
+                    inline bool digits(const char *p, int count, unsigned &value)
+                    {
+                        value = 0;
+                        for (int i = 0; i < count; ++i)
+                        {
+                            unsigned digit = static_cast<unsigned char>(p[i] - '0');
+                            if (digit > 9)
+                                return false;
+                            value = value * 10 + digit;
+                        }
+                        return true;
+                    }
+                } // namespace detail
+
+                /**
+                 * YYYY-MM-DDTHH:MM:SS[.fraction](Z|+HH:MM|-HH:MM) to microseconds since epoch.
+                 * Fractions beyond microseconds are truncated.
+                 * @return false (micros untouched) on anything else or a pre-1970 time
+                 */
+                inline bool parse_iso8601(std::string_view text, uint64_t &micros)
+                {
+                    // Shortest form: 2024-03-01T14:30:05Z
+                    if (text.size() < 20)
+                        return false;
+
+                    const char *p = text.data();
+                    const char *end = p + text.size();
+                    unsigned year, month, day, hour, minute, second;
+                    if (!detail::digits(p, 4, year) || p[4] != '-' || !detail::digits(p + 5, 2, month) || p[7] != '-' ||
+                        !detail::digits(p + 8, 2, day) || (p[10] != 'T' && p[10] != ' ') ||
+                        !detail::digits(p + 11, 2, hour) || p[13] != ':' || !detail::digits(p + 14, 2, minute) ||
+                        p[16] != ':' || !detail::digits(p + 17, 2, second))
+                        return false;
+                    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60)
+                        return false;
+                    p += 19;
+
+                    unsigned fraction = 0;
+                    if (p != end && *p == '.')
+                    {
+                        ++p;
+                        int count = 0;
+                        while (p != end && static_cast<unsigned char>(*p - '0') < 10)
+                        {
+                            if (count < 6)
+                                fraction = fraction * 10 + static_cast<unsigned>(*p - '0');
+                            ++count;
+                            ++p;
+                        }
+                        if (count == 0)
+                            return false;
+                        for (; count < 6; ++count)
+                            fraction *= 10;
+                    }
+
+                    int64_t offset_seconds = 0;
+                    if (p != end && *p == 'Z')
+                    {
+                        ++p;
+                    }
+                    else if (end - p == 6 && (*p == '+' || *p == '-') && p[3] == ':')
+                    {
+                        unsigned offset_hours, offset_minutes;
+                        if (!detail::digits(p + 1, 2, offset_hours) || !detail::digits(p + 4, 2, offset_minutes))
+                            return false;
+                        offset_seconds = static_cast<int64_t>(offset_hours * 3600 + offset_minutes * 60);
+                        if (*p == '+')
+                            offset_seconds = -offset_seconds;
+                        p += 6;
+                    }
+                    else
+                    {
+                        return false;
+                    }
+                    if (p != end)
+                        return false;
+
+                    int64_t seconds = detail::days_from_civil(year, month, day) * 86400 +
+                                      static_cast<int64_t>(hour * 3600 + minute * 60 + second) + offset_seconds;
+                    if (seconds < 0)
+                        return false;
+
+                    micros = static_cast<uint64_t>(seconds) * 1000000 + fraction;
+                    return true;
+                }
+
+            } // namespace timestamp
+        } // namespace base
+    } // namespace exchanges
+} // namespace open_dtc_server
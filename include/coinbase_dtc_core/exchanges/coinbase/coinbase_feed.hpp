@@ -1,10 +1,16 @@
 #pragma once
 
 #include "../base/exchange_feed.hpp"
+#include "../base/sequence_tracker.hpp"
+#include "../base/spsc_ring.hpp"
 #include "../../core/http/http_client.hpp"
 #include "../../core/auth/jwt_auth.hpp"
 #include "../../core/util/log.hpp"
 #include "endpoint.hpp"
+#include "feed_arbiter.hpp"
+#include "feed_message_scanner.hpp"
+#include "subscription_batcher.hpp"
+#include "shard_planner.hpp"
 #include <atomic>
 #include <thread>
 #include <mutex>
@@ -12,8 +18,10 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <condition_variable>
+#include <deque>
 #include <chrono>
 #include <memory>
+#include <random>
 #include <string>
 #include <vector>
 
@@ -53,6 +61,60 @@ namespace open_dtc_server
             class CoinbaseFeed : public base::ExchangeFeedBase
             {
             public:
+                /** Level2 book integrity counters; times in microseconds */
+                struct BookSyncStats
+                {
+                    uint64_t gaps = 0;             // Sequence gaps seen on l2update
+                    uint64_t missed_messages = 0;  // Sequence numbers skipped by those gaps
+                    uint64_t out_of_order = 0;     // Repeated or reordered messages dropped
+                    uint64_t crossed_books = 0;    // Books found crossed after an update
+                    uint64_t resyncs = 0;          // Stale books recovered from a fresh snapshot
+                    uint64_t buffered_deltas = 0;  // Changes held back while a book had no snapshot
+                    uint64_t stale_books = 0;      // Books currently waiting for a snapshot
+                    uint64_t last_recovery_us = 0; // Stale to synced, most recent resync
+                    uint64_t max_recovery_us = 0;
+                };
+
+                /** One pipeline ring as seen from outside */
+                struct QueueStats
+                {
+                    size_t depth = 0;      // Slots in use now
+                    size_t capacity = 0;
+                    size_t high_water = 0; // Most slots in use at once
+                    uint64_t passed = 0;   // Items through since connect
+                    uint64_t stalls = 0;   // Times the producer found it full and had to wait
+                };
+
+                /** Reader -> parser (frames) and parser -> distribution (events) rings, per connection */
+                struct PipelineStats
+                {
+                    bool enabled = false;
+                    base::WaitStrategy wait = base::WaitStrategy::FUTEX;
+                    std::vector<QueueStats> frames;
+                    std::vector<QueueStats> events;
+                };
+
+                /** One recovered connection drop; times in microseconds */
+                struct ReconnectRecord
+                {
+                    size_t connection = 0;
+                    FeedSide side = FeedSide::A;
+                    uint64_t attempts = 0;         // Connects tried, the successful one included
+                    uint64_t down_us = 0;          // Drop to connected again
+                    uint64_t first_message_us = 0; // Connected to the first market message; 0 while none came
+                    uint64_t resynced_us = 0;      // Connected to a snapshot for every level2 book (first message without any); 0 until then
+                };
+
+                struct ReconnectStats
+                {
+                    uint64_t drops = 0;
+                    uint64_t reconnects = 0;
+                    uint64_t failed_attempts = 0;
+                    uint64_t max_first_message_us = 0;
+                    uint64_t max_resynced_us = 0;
+                    std::vector<ReconnectRecord> recent; // Oldest first; the connections still resyncing come last
+                };
+
                 explicit CoinbaseFeed(const base::ExchangeConfig &config);
                 ~CoinbaseFeed() override;
 
@@ -103,6 +165,29 @@ namespace open_dtc_server
                 /** Validate API credentials */
                 bool test_credentials();
 
+                /** Best bid/ask from the local level2 book (O(1)); false if no book yet */
+                bool get_top_of_book(const std::string &product_id, base::MarketLevel2 &top) const;
+
+                /** Up to max_levels levels per side from the local level2 book, best first */
+                bool get_order_book_depth(const std::string &product_id, size_t max_levels,
+                                          std::vector<base::PriceLevel> &bids,
+                                          std::vector<base::PriceLevel> &asks) const;
+
+                /** Book integrity counters since construction */
+                BookSyncStats get_book_sync_stats() const;
+
+                /** Ring occupancy of the feed pipeline; empty while disconnected */
+                PipelineStats get_pipeline_stats() const;
+
+                /** A/B arbitration per connection pair; empty unless redundant_feed */
+                std::vector<FeedArbiter::Stats> get_arbitration_stats() const;
+
+                /** Drops, reconnects and how long each took to carry data and to resync */
+                ReconnectStats get_reconnect_stats() const;
+
+                /** Run one raw WebSocket payload through the message handlers, as if received (replay and benchmarks) */
+                void inject_websocket_message(const std::string &message) { on_websocket_message_received(message); }
+
             private:
                 // ========================================================================
                 // COINBASE-SPECIFIC IMPLEMENTATION DETAILS
@@ -116,6 +201,7 @@ namespace open_dtc_server
                 // WebSocket protocol (Coinbase-specific)
                 bool establish_websocket_connection();
                 void cleanup_websocket();
+                void parse_websocket_url();
                 std::string create_subscribe_message(const std::string &channel,
                                                      const std::vector<std::string> &product_ids) const;
                 std::string create_unsubscribe_message(const std::string &channel,
@@ -123,17 +209,46 @@ namespace open_dtc_server
 
                 // Message processing
                 void process_websocket_message(const std::string &message);
-                void handle_trade_message(const std::string &message);
-                void handle_level2_message(const std::string &message);
-                void handle_ticker_message(const std::string &message);
+                // Hot types arrive pre-scanned; cold types get the full document.
+                // receive_time_us is read once per message in on_websocket_message_received.
+                void handle_trade_message(const FeedMessage &message, uint64_t receive_time_us);
+                void handle_level2_message(const FeedMessage &message, uint64_t receive_time_us);
+                void handle_ticker_message(const FeedMessage &message, uint64_t receive_time_us);
+                void handle_snapshot_message(const std::string &message, uint64_t receive_time_us);
                 void handle_heartbeat_message(const std::string &message);
                 void handle_subscriptions_message(const std::string &message);
                 void handle_error_message(const std::string &message);
 
+                // Level2 book synchronization
+                struct ProductBook;
+                bool is_stale_trade(base::InstrumentId instrument, uint64_t sequence, bool ticker);
+                bool mark_stale_locked(ProductBook &state);
+                std::shared_ptr<base::OrderBook> install_snapshot_locked(ProductBook &state, base::OrderBook &&book,
+                                                                         uint64_t snapshot_time_us, bool replay_pending);
+                void request_book_snapshot(const std::string &product_id);
+                void resubscribe_level2(const std::string &product_id);
+                void resync_loop();
+
                 // WebSocket callbacks
                 void on_trade_received(const exchanges::base::MarketTrade &trade);
                 void on_level2_received(const exchanges::base::MarketLevel2 &level2);
+                void on_depth_received(const exchanges::base::MarketDepthUpdate &update);
                 void on_websocket_message_received(const std::string &message); // NEW: Raw SSL WebSocket message handler
+                void process_message(const std::string &message, uint64_t receive_time_us);
+
+                // Feed pipeline: each connection's reader thread hands frames to its parser thread,
+                // parsers hand events to the one distribution thread. Rings are bounded and a full
+                // ring blocks its producer, so a slow consumer pushes back as far as the socket.
+                struct Pipeline;
+                struct Shard;
+                void on_shard_message(Shard &shard, FeedSide side, const std::string &message);
+                void forward_message(Shard &shard, const std::string &message, uint64_t receive_time_us);
+                void start_pipeline();
+                void stop_pipeline();
+                void parser_loop(Pipeline &pipeline);
+                void distribution_loop();
+                void enqueue_event(Pipeline &pipeline, const base::MarketEvent &event, std::shared_ptr<const base::OrderBook> book);
+                void deliver_event(Pipeline &pipeline, const base::MarketEvent &event);
 
                 // Symbol mapping initialization
                 void initialize_symbol_mappings();
@@ -145,10 +260,8 @@ namespace open_dtc_server
                                                        const std::string &body = "");
 
                 // Connection management
-                bool should_reconnect() const;
-                void schedule_reconnect();
                 void initialize_credentials();
-                void configure_ssl_credentials();
+                void configure_ssl_credentials(feed::coinbase::SSLWebSocketClient &client);
                 bool has_credentials() const;
 
                 // Utility methods
@@ -181,6 +294,29 @@ namespace open_dtc_server
                         : type(t), product_id(pid), active(false), subscribed_at(0) {}
                 };
 
+                // Subscribe trades and/or level2 for all symbols as one batch, then wait for every confirmation
+                bool subscribe_products(const std::vector<std::string> &symbols, bool trades, bool level2);
+                void queue_subscription(const char *channel, const std::string &product_id, bool subscribe);
+                void subscription_loop();
+
+                // Connection pool; *_locked methods need subscription_batcher_mutex_
+                void on_shard_connection(size_t index, FeedSide side, bool connected);
+                void mark_books_stale(const std::vector<std::string> &product_ids);
+                void expect_snapshot_locked(size_t index, const std::string &product_id);
+                void forget_awaited_snapshot_locked(Shard &shard, const std::string &product_id);
+                void apply_shard_moves_locked(const std::vector<ShardPlanner::Move> &moves);
+                void update_product_weight_locked(const std::string &product_id, size_t index);
+                void refresh_product_rates_locked();
+                static std::string subscription_key(const std::string &channel, const std::string &product_id);
+
+                // Reconnects; reconnect_mutex_ nests inside subscription_batcher_mutex_. on_link_change_locked
+                // needs the batcher mutex; the two marked reconnect_mutex_ need that one
+                void schedule_reconnect(size_t index, FeedSide side);
+                void on_link_change_locked(size_t index, FeedSide side, bool connected, const std::vector<std::string> &level2_products);
+                void track_resync(Shard &shard, FeedSide side, const std::string &message, uint64_t receive_time_us);
+                void finish_resync_locked(Shard &shard, FeedSide side);              // reconnect_mutex_
+                std::chrono::milliseconds reconnect_delay_locked(uint64_t attempts); // reconnect_mutex_
+
                 void add_subscription(SubscriptionType type, const std::string &product_id);
                 void remove_subscription(SubscriptionType type, const std::string &product_id);
                 bool has_subscription(SubscriptionType type, const std::string &product_id) const;
@@ -195,7 +331,99 @@ namespace open_dtc_server
 
                 // WebSocket client for real-time data
                 std::unique_ptr<feed::coinbase::WebSocketClient> websocket_client_;        // Plain WebSocket (public data)
-                std::unique_ptr<feed::coinbase::SSLWebSocketClient> ssl_websocket_client_; // NEW: SSL WebSocket (authenticated)
+
+                // Raw payload stamped on arrival; slots keep their capacity, so steady state does not allocate
+                struct Frame
+                {
+                    std::string payload;
+                    uint64_t receive_time_us = 0;
+                };
+
+                struct Pipeline
+                {
+                    Pipeline(size_t capacity, base::WaitStrategy wait)
+                        : frames(capacity), events(capacity), snapshots(SNAPSHOT_CAPACITY),
+                          frames_ready(wait), frames_space(wait), events_space(wait) {}
+
+                    base::SpscRing<Frame> frames;                                        // Reader -> parser
+                    base::SpscRing<base::MarketEvent> events;                            // Parser -> distribution
+                    base::SpscRing<std::shared_ptr<const base::OrderBook>> snapshots;    // Books of SNAPSHOT events, same order
+                    base::Parker frames_ready;  // Parser waits for frames
+                    base::Parker frames_space;  // Reader waits for a free frame slot
+                    base::Parker events_space;  // Parser waits for a free event slot
+                    std::atomic<uint64_t> reader_stalls{0};
+                    std::atomic<uint64_t> parser_stalls{0};
+                    std::thread parser;
+                };
+
+                /**
+                 * Reconnect state of one connection. A drop moves it from UP to BACKOFF;
+                 * reconnect_thread_ tries again at retry_at (CONNECTING) and, until it
+                 * succeeds, backs off exponentially with jitter. Once up it resyncs: the
+                 * batcher resends every wanted channel and the level2 snapshots that
+                 * answer them are counted off.
+                 */
+                enum class LinkState
+                {
+                    UP,
+                    BACKOFF,
+                    CONNECTING
+                };
+
+                struct Link // Guarded by reconnect_mutex_
+                {
+                    LinkState state = LinkState::UP;
+                    uint64_t attempts = 0; // Since the drop
+                    std::chrono::steady_clock::time_point down_since;
+                    std::chrono::steady_clock::time_point retry_at;
+                    uint64_t up_us = 0; // Connected again, on the receive time clock
+                    bool resyncing = false;
+                    ReconnectRecord record;
+                    std::unordered_set<std::string> awaiting_snapshots; // Level2 products with no snapshot since up_us
+                };
+
+                // SSL WebSocket connections (authenticated); each client runs its own reader thread.
+                // With config_.redundant_feed a shard has a second connection (side B) with the same
+                // subscriptions, and the arbiter passes on whichever copy of a message arrives first.
+                struct Shard
+                {
+                    std::unique_ptr<feed::coinbase::SSLWebSocketClient> client;  // Side A
+                    SubscriptionBatcher batcher;                                  // Guarded by subscription_batcher_mutex_
+                    std::unique_ptr<feed::coinbase::SSLWebSocketClient> standby; // Side B, null unless redundant
+                    SubscriptionBatcher standby_batcher;
+                    bool up[2] = {false, false};                                  // Per side; guarded by subscription_batcher_mutex_
+                    std::unique_ptr<FeedArbiter> arbiter;                         // Guarded by arbiter_mutex
+                    std::mutex arbiter_mutex;
+                    std::mutex forward_mutex;          // Both readers: arbitrate and hand off in one order
+                    std::unique_ptr<Pipeline> pipeline; // Null unless config_.feed_pipeline
+                    Link links[2];
+                    std::atomic<bool> resyncing[2] = {{false}, {false}}; // links[side].resyncing, read by the readers without the lock
+
+                    feed::coinbase::SSLWebSocketClient *client_of(FeedSide side) { return side == FeedSide::A ? client.get() : standby.get(); }
+                    SubscriptionBatcher &batcher_of(FeedSide side) { return side == FeedSide::A ? batcher : standby_batcher; }
+
+                    /** f(batcher) for every side: subscriptions are the same on both */
+                    template <typename F>
+                    void each_batcher(F &&f)
+                    {
+                        f(batcher);
+                        if (standby)
+                            f(standby_batcher);
+                    }
+                };
+                std::vector<std::unique_ptr<Shard>> shards_; // Built by connect(), cleared by disconnect()
+
+                std::thread distribution_thread_;
+                std::unique_ptr<base::Parker> events_ready_; // Distribution waits for events from any parser
+                std::atomic<bool> pipeline_stop_{false};
+                static thread_local Pipeline *parser_pipeline_; // Set on parser threads: publish into its rings
+                static constexpr size_t SNAPSHOT_CAPACITY = 64;
+                static constexpr size_t DISTRIBUTION_BATCH = 256;               // Events per connection before looking at the next
+                static constexpr size_t MAX_RETAINED_FRAME_BYTES = 256 * 1024; // Larger frame buffers (snapshots) are freed after use
+
+                // Events go out one at a time (single journal writer): from the distribution thread, or
+                // from whichever thread received them when there is no pipeline
+                std::mutex publish_mutex_;
 
                 // Authentication
                 std::unique_ptr<auth::JWTAuthenticator> authenticator_;
@@ -226,12 +454,59 @@ namespace open_dtc_server
                 mutable std::mutex subscriptions_mutex_;
                 std::unordered_map<std::string, SubscriptionInfo> subscriptions_; // key: type_productid
                 std::vector<std::string> subscribed_symbols_;                     // Cache for quick access
-                std::unordered_set<std::string> ticker_products_;                 // Aggregate set of active ticker product_ids
+
+                // Upstream channel subscriptions, sent as coalesced deltas per connection by subscription_thread_
+                ShardPlanner shard_planner_{1};
+                mutable std::mutex subscription_batcher_mutex_;
+                std::condition_variable subscription_batcher_cv_;
+                std::thread subscription_thread_;
+
+                // l2update change held back until the book has a snapshot to apply it to
+                struct PendingChange
+                {
+                    base::BookSide side;
+                    double price;
+                    double size;
+                    uint64_t exchange_time_us;
+                };
+
+                /**
+                 * Level2 book built from a snapshot and maintained by l2update, with the
+                 * sequence state that says whether it can still be trusted. An unsynced
+                 * book buffers changes until the next snapshot: in-stream snapshots
+                 * replace it outright, REST snapshots (fetched by the resync thread)
+                 * are installed by the feed thread with the newer buffered changes
+                 * replayed on top.
+                 */
+                struct ProductBook
+                {
+                    base::OrderBook book;
+                    base::SequenceTracker level2_sequence;       // Contiguous when present
+                    base::SequenceTracker match_sequence{false}; // Shared with the full channel, so only monotonic
+                    base::SequenceTracker ticker_sequence{false};
+                    bool synced = false;
+                    bool resync_requested = false;
+                    std::chrono::steady_clock::time_point stale_since;
+                    std::vector<PendingChange> pending;
+                    std::shared_ptr<base::OrderBook> fetched; // REST snapshot waiting to be installed
+                    uint64_t fetched_time_us = 0;
+                };
+
+                std::unordered_map<base::InstrumentId, ProductBook> order_books_;
+                BookSyncStats sync_stats_; // Guarded by order_books_mutex_
+                mutable std::mutex order_books_mutex_;
+                static constexpr size_t MAX_PENDING_CHANGES = 10000;
+
+                // Products waiting for a REST snapshot
+                std::thread resync_thread_;
+                std::mutex resync_mutex_;
+                std::condition_variable resync_cv_;
+                std::deque<std::string> resync_queue_;
 
                 // Pending subscription tracking for error correlation
                 mutable std::mutex pending_subscriptions_mutex_;
-                std::unordered_map<std::string, std::chrono::steady_clock::time_point> pending_subscriptions_; // key: product_id, value: request_time
-                std::unordered_map<std::string, bool> subscription_results_;                                   // key: product_id, value: success/failure
+                std::unordered_map<std::string, std::chrono::steady_clock::time_point> pending_subscriptions_; // key: channel:product_id, value: request_time
+                std::unordered_map<std::string, bool> subscription_results_;                                   // key: channel:product_id, value: success/failure
                 std::condition_variable subscription_cv_;                                                      // For waiting on subscription results
 
                 // Message queues and synchronization
@@ -243,14 +518,17 @@ namespace open_dtc_server
                 std::queue<std::string> receive_queue_;
                 std::condition_variable receive_cv_;
 
-                // Reconnection logic
-                std::atomic<bool> should_reconnect_;
-                std::atomic<uint64_t> last_successful_connection_;
-                std::atomic<uint64_t> reconnect_attempts_;
-                std::atomic<uint64_t> next_reconnect_time_;
+                // Reconnection: delays double from the initial one up to the maximum, each drawn from its
+                // upper half so connections dropped together do not come back together. Retries go on
+                // past MAX_RECONNECT_ATTEMPTS, which only reports the outage as an error.
+                mutable std::mutex reconnect_mutex_;
+                std::condition_variable reconnect_cv_;
+                std::mt19937_64 reconnect_jitter_{std::random_device{}()};
+                ReconnectStats reconnect_stats_; // recent holds finished resyncs only
                 static constexpr uint64_t INITIAL_RECONNECT_DELAY_MS = 1000;
                 static constexpr uint64_t MAX_RECONNECT_DELAY_MS = 30000;
                 static constexpr uint64_t MAX_RECONNECT_ATTEMPTS = 10;
+                static constexpr size_t RECENT_RECONNECTS = 16;
 
                 // Statistics and monitoring
                 std::atomic<uint64_t> messages_received_;
@@ -274,6 +552,17 @@ namespace open_dtc_server
                 static constexpr const char *CHANNEL_TICKER = "ticker";
                 static constexpr const char *CHANNEL_HEARTBEAT = "heartbeat";
 
+                // Wait for subscription confirmations this long after the batch goes out
+                static constexpr uint64_t SUBSCRIPTION_TIMEOUT_MS = 500;
+
+                // Product weights for placing products on connections (messages per second)
+                static constexpr double EXPECTED_LEVEL2_RATE = 20.0;
+                static constexpr double EXPECTED_TICKER_RATE = 2.0;
+                std::unique_ptr<std::atomic<uint64_t>[]> product_messages_; // Index = InstrumentId
+                std::unordered_map<base::InstrumentId, uint64_t> product_messages_sampled_;
+                std::unordered_map<std::string, double> product_rates_;
+                std::chrono::steady_clock::time_point rates_sampled_at_;
+
                 // Rate limiting
                 std::atomic<uint64_t> last_request_time_;
                 static constexpr uint64_t MIN_REQUEST_INTERVAL_MS = 100; // 10 requests/second max
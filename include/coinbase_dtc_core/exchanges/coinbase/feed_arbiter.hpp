@@ -0,0 +1,121 @@
+#pragma once
+
+#include "feed_message_scanner.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace coinbase
+        {
+
+            /** The two redundant connections behind one set of products */
+            enum class FeedSide : uint8_t
+            {
+                A = 0,
+                B = 1
+            };
+
+            /**
+             * Merges two copies of the same Coinbase stream (A/B arbitration).
+             *
+             * Every market message is forwarded once, from whichever connection
+             * delivered it first, so when one side stalls or drops the other
+             * carries the feed without a switchover step. Matches and tickers are
+             * matched on trade_id or sequence and never go backwards per product.
+             * Level2 updates carry no id, so they are matched by content: the
+             * exchange time of the update and its index among the product's updates
+             * with that time. Both sides see the same updates in the same order, so
+             * the position is the same on each whenever its snapshot arrived, and an
+             * update is forwarded only past the last forwarded position however far
+             * the other side lags. Snapshots are the exception, since each connection
+             * sends its own on subscribe: only the first per product is forwarded
+             * until expect_snapshot() asks for a new one. Subscriptions, heartbeats
+             * and errors pass through from both sides.
+             *
+             * When the second copy of a message arrives, the gap since the first
+             * is added to the lead of the side that won. Not synchronized; the
+             * owner serializes calls.
+             */
+            class FeedArbiter
+            {
+            public:
+                /** Per connection; times in microseconds */
+                struct SideStats
+                {
+                    uint64_t received = 0;      // Market messages seen on this side
+                    uint64_t first = 0;         // Forwarded: this side had them first
+                    uint64_t duplicates = 0;    // Already forwarded from the other side (or repeated)
+                    uint64_t leads = 0;         // First copies whose second copy was seen, so the lead is known
+                    uint64_t lead_us_total = 0; // Sum of those leads
+                    uint64_t lead_us_max = 0;
+                    uint64_t last_message_us = 0;
+                };
+
+                struct Stats
+                {
+                    SideStats sides[2];
+                    uint64_t passed = 0;    // Not arbitrated (subscriptions, heartbeats, errors)
+                    uint64_t failovers = 0; // Times one side took over while the other was quiet
+                };
+
+                static constexpr size_t RECENT_MESSAGES = 8192;           // First arrivals remembered for matching
+                static constexpr uint64_t DEFAULT_QUIET_AFTER_US = 2000000; // Silence that makes a side quiet
+
+                explicit FeedArbiter(uint64_t quiet_after_us = DEFAULT_QUIET_AFTER_US);
+
+                /**
+                 * @param fields the message's scan
+                 * @return true if this is the first copy and should be processed
+                 */
+                bool accept(FeedSide side, const FeedMessage &fields, uint64_t receive_time_us);
+
+                /** The next snapshot of product_id is wanted (new subscription or resync) */
+                void expect_snapshot(const std::string &product_id);
+
+                /** Forget every id, e.g. after both connections were down */
+                void reset();
+
+                Stats stats() const { return stats_; }
+                bool is_quiet(FeedSide side, uint64_t now_us) const;
+                uint64_t quiet_after_us() const { return quiet_after_us_; }
+
+            private:
+                struct Arrival
+                {
+                    uint64_t key = 0; // 0: empty
+                    uint64_t time_us = 0;
+                    FeedSide side = FeedSide::A;
+                };
+
+                /** Where each side, and the forwarded stream, are in one product's level2 updates */
+                struct Level2Position
+                {
+                    uint64_t time_us[2] = {0, 0}; // By side: exchange time of its last update
+                    uint64_t index[2] = {0, 0};   // By side: its updates so far with that time
+                    uint64_t forwarded_time_us = 0;
+                    uint64_t forwarded_index = 0;
+                };
+
+                bool duplicate(FeedSide side, uint64_t key, uint64_t receive_time_us);
+                void remember(FeedSide side, uint64_t key, uint64_t receive_time_us);
+
+                uint64_t quiet_after_us_;
+                std::vector<Arrival> recent_; // Direct-mapped on key
+                std::unordered_map<uint64_t, uint64_t> last_ids_; // Per type and product: highest id forwarded
+                std::unordered_map<uint64_t, Level2Position> level2_positions_; // By product hash
+                std::unordered_set<std::string> snapshots_;       // Products whose snapshot was forwarded
+                FeedSide last_forwarded_ = FeedSide::A;
+                Stats stats_;
+            };
+
+        } // namespace coinbase
+    } // namespace exchanges
+} // namespace open_dtc_server
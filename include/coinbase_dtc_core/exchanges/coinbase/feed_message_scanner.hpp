@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string_view>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace coinbase
+        {
+
+            /** Fields the hot feed handlers read, as views into the original message */
+            struct FeedMessage
+            {
+                std::string_view type;
+                std::string_view product_id;
+                std::string_view price;
+                std::string_view size;
+                std::string_view last_size;
+                std::string_view best_bid;
+                std::string_view best_bid_size;
+                std::string_view best_ask;
+                std::string_view best_ask_size;
+                std::string_view side;
+                std::string_view trade_id; // JSON number, as text
+                std::string_view sequence; // JSON number, as text
+                std::string_view time;     // ISO 8601 event time
+                std::string_view changes; // Inside of the l2update "changes" array; read with next_change()
+            };
+
+            /**
+             * Single-pass reader for Coinbase feed messages.
+             *
+             * scan() walks the top-level object once, keeps the fields in FeedMessage
+             * and skips every other value without decoding it. Nothing is allocated
+             * and string values are not unescaped (product IDs, sides and decimals
+             * never contain escapes); decimals are converted with base::decimal.
+             * Messages needing a full document (snapshots, errors, subscriptions)
+             * still go through nlohmann::json.
+             */
+            class FeedMessageScanner
+            {
+            public:
+                /** @return false if json is not a well-formed object */
+                static bool scan(std::string_view json, FeedMessage &message);
+
+                /**
+                 * Read the next ["side","price","size"] entry from FeedMessage::changes
+                 * and advance the cursor past it.
+                 * @return false at the end of the array or on malformed input
+                 */
+                static bool next_change(std::string_view &cursor, std::string_view &side,
+                                        std::string_view &price, std::string_view &size);
+            };
+
+        } // namespace coinbase
+    } // namespace exchanges
+} // namespace open_dtc_server
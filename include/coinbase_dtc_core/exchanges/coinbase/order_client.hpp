@@ -0,0 +1,64 @@
+#pragma once
+
+#include "coinbase_dtc_core/core/auth/jwt_auth.hpp"
+#include "coinbase_dtc_core/exchanges/base/order_transport.hpp"
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace coinbase
+        {
+
+            /**
+             * Order entry over the Advanced Trade ORDERS endpoint.
+             *
+             * Unlike CoinbaseRestClient, which opens a connection and signs a JWT per
+             * call, this keeps one HTTPS connection open (TCP_NODELAY, keep-alive)
+             * and signs the next order JWT ahead of time, so submit_order only sends
+             * the request. keep_warm re-signs tokens before they expire and pings the
+             * public time endpoint on an idle connection so it is never torn down.
+             * Not thread-safe: one thread submits and keeps it warm.
+             */
+            class CoinbaseOrderClient : public base::OrderTransport
+            {
+            public:
+                /**
+                 * @param base_url API base, e.g. endpoints::TRADE_BASE or endpoints::SANDBOX_BASE
+                 * @param timeout_seconds Per-request timeout
+                 */
+                CoinbaseOrderClient(const auth::CDPCredentials &credentials, const std::string &base_url, int timeout_seconds = 10);
+                ~CoinbaseOrderClient() override;
+
+                CoinbaseOrderClient(const CoinbaseOrderClient &) = delete;
+                CoinbaseOrderClient &operator=(const CoinbaseOrderClient &) = delete;
+
+                base::OrderResponse submit_order(const std::string &body) override;
+                bool keep_warm() override;
+
+            private:
+                base::OrderResponse perform(const std::string &url, const std::string *post_body, const std::string &token);
+                void sign_next_token();
+
+                std::unique_ptr<auth::JWTAuthenticator> authenticator_;
+                std::string base_url_;
+                int timeout_seconds_;
+                void *curl_ = nullptr; // CURL easy handle, reused so the connection stays open
+
+                std::string next_token_;
+                std::chrono::steady_clock::time_point token_signed_;
+                std::chrono::steady_clock::time_point last_request_;
+                bool connected_ = false;
+
+                // JWTs live 120 s; re-sign well before that
+                static constexpr std::chrono::seconds TOKEN_MAX_AGE{90};
+                // Servers drop idle keep-alive connections after about a minute
+                static constexpr std::chrono::seconds IDLE_PING_INTERVAL{30};
+            };
+
+        } // namespace coinbase
+    } // namespace exchanges
+} // namespace open_dtc_server
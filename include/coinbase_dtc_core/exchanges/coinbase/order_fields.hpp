@@ -0,0 +1,96 @@
+#pragma once
+
+#include "coinbase_dtc_core/exchanges/base/order_transport.hpp"
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace coinbase
+        {
+            // Coinbase order field conversions shared by the REST order history and the user channel
+            namespace order_fields
+            {
+
+                inline base::OrderState parse_order_state(const std::string &status)
+                {
+                    if (status == "OPEN" || status == "CANCEL_QUEUED" || status == "EDIT_QUEUED")
+                        return base::OrderState::OPEN;
+                    if (status == "PENDING" || status == "QUEUED")
+                        return base::OrderState::PENDING;
+                    if (status == "FILLED")
+                        return base::OrderState::FILLED;
+                    if (status == "CANCELLED" || status == "CANCELED")
+                        return base::OrderState::CANCELED;
+                    if (status == "EXPIRED")
+                        return base::OrderState::EXPIRED;
+                    if (status == "FAILED" || status == "REJECTED")
+                        return base::OrderState::REJECTED;
+                    return base::OrderState::UNKNOWN;
+                }
+
+                // The user channel says "Limit" / "Stop Limit", REST says "LIMIT" / "STOP_LIMIT"
+                inline base::OrderKind parse_order_kind(const std::string &type)
+                {
+                    std::string normalized;
+                    normalized.reserve(type.size());
+                    for (char c : type)
+                        normalized.push_back(c == ' ' ? '_' : static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+
+                    if (normalized == "MARKET")
+                        return base::OrderKind::MARKET;
+                    if (normalized == "LIMIT")
+                        return base::OrderKind::LIMIT;
+                    if (normalized == "STOP")
+                        return base::OrderKind::STOP;
+                    if (normalized == "STOP_LIMIT")
+                        return base::OrderKind::STOP_LIMIT;
+                    return base::OrderKind::UNKNOWN;
+                }
+
+                // Days since 1970-01-01 for a proleptic Gregorian date (no timegm on Windows)
+                inline int64_t days_from_civil(int64_t y, unsigned m, unsigned d)
+                {
+                    y -= m <= 2;
+                    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+                    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+                    const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+                    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+                    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+                }
+
+                /** RFC 3339 UTC time ("2024-01-02T03:04:05.678Z") to Unix milliseconds, 0 if malformed */
+                inline uint64_t parse_time_ms(const std::string &time)
+                {
+                    int year = 0;
+                    unsigned month = 0, day = 0, hour = 0, minute = 0, second = 0;
+                    int consumed = 0;
+                    if (std::sscanf(time.c_str(), "%4d-%2u-%2uT%2u:%2u:%2u%n", &year, &month, &day, &hour, &minute, &second, &consumed) != 6 ||
+                        month < 1 || month > 12 || day < 1 || day > 31)
+                        return 0;
+
+                    // Fraction may carry up to nanoseconds; keep milliseconds
+                    unsigned millis = 0;
+                    size_t pos = static_cast<size_t>(consumed);
+                    if (pos < time.size() && time[pos] == '.')
+                    {
+                        unsigned scale = 100;
+                        for (++pos; pos < time.size() && std::isdigit(static_cast<unsigned char>(time[pos])); ++pos)
+                        {
+                            millis += static_cast<unsigned>(time[pos] - '0') * scale;
+                            scale /= 10;
+                        }
+                    }
+
+                    int64_t seconds = days_from_civil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+                    return seconds < 0 ? 0 : static_cast<uint64_t>(seconds) * 1000 + millis;
+                }
+
+            } // namespace order_fields
+        } // namespace coinbase
+    } // namespace exchanges
+} // namespace open_dtc_server
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+struct z_stream_s;
+
+namespace open_dtc_server
+{
+    namespace feed
+    {
+        namespace coinbase
+        {
+
+            /** permessage-deflate parameters as accepted by the server (RFC 7692 section 7.1) */
+            struct DeflateParameters
+            {
+                bool server_no_context_takeover = false; // Server resets its compressor after every message
+                bool client_no_context_takeover = false;
+                int server_max_window_bits = 15;
+                int client_max_window_bits = 15;
+            };
+
+            /** What the client offers in Sec-WebSocket-Extensions */
+            constexpr const char *PERMESSAGE_DEFLATE_OFFER = "permessage-deflate; client_max_window_bits";
+
+            /**
+             * Reads the Sec-WebSocket-Extensions value of a handshake response.
+             * @return false if permessage-deflate was not accepted, or was accepted
+             * with parameters the client did not offer or cannot use (the
+             * connection must then be failed)
+             */
+            bool parse_deflate_response(const std::string &extensions, DeflateParameters &parameters, bool &accepted);
+
+            /**
+             * Receive side of permessage-deflate: one raw inflate stream per
+             * connection.
+             *
+             * With context takeover the server compresses each message against
+             * the previous ones, so the stream and its window carry over from
+             * message to message; without it the stream is reset after each
+             * message, which costs far less than a new inflateInit2/inflateEnd.
+             * Output goes into the caller's buffer, whose capacity is reused.
+             *
+             * inflate() is called from the connection's reader thread; stats() may
+             * be read from any thread.
+             */
+            class Inflater
+            {
+            public:
+                struct Stats
+                {
+                    uint64_t messages = 0;
+                    uint64_t compressed_bytes = 0; // Payload bytes on the wire
+                    uint64_t inflated_bytes = 0;
+                    uint64_t inflate_ns = 0; // Time inside inflate()
+                    uint64_t errors = 0;
+                };
+
+                Inflater();
+                ~Inflater();
+
+                Inflater(const Inflater &) = delete;
+                Inflater &operator=(const Inflater &) = delete;
+
+                /** Fresh stream for a new connection; false if zlib cannot allocate one */
+                bool start(const DeflateParameters &parameters);
+                void stop();
+                bool active() const { return active_; }
+                bool context_takeover() const { return active_ && !reset_each_message_; }
+
+                /**
+                 * Inflate one message (the payload of its frames, without the
+                 * 00 00 ff ff tail) into out, replacing its contents.
+                 * @return false on corrupt data; the stream is reset, but with
+                 * context takeover later messages cannot be trusted either
+                 */
+                bool inflate(const uint8_t *data, size_t size, std::string &out);
+
+                Stats stats() const;
+
+            private:
+                bool run(const uint8_t *data, size_t size, std::string &out, size_t &produced);
+
+                std::unique_ptr<z_stream_s> stream_;
+                bool active_ = false;
+                bool reset_each_message_ = false;
+
+                std::atomic<uint64_t> messages_{0};
+                std::atomic<uint64_t> compressed_bytes_{0};
+                std::atomic<uint64_t> inflated_bytes_{0};
+                std::atomic<uint64_t> inflate_ns_{0};
+                std::atomic<uint64_t> errors_{0};
+            };
+
+        } // namespace coinbase
+    } // namespace feed
+} // namespace open_dtc_server
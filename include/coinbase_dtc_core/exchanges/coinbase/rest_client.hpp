@@ -2,6 +2,8 @@
 
 #include "coinbase_dtc_core/core/auth/jwt_auth.hpp"
 #include "coinbase_dtc_core/core/auth/cdp_credentials.hpp"
+#include "coinbase_dtc_core/exchanges/base/order_book.hpp"
+#include "coinbase_dtc_core/exchanges/base/order_transport.hpp"
 #include <string>
 #include <vector>
 #include <memory>
@@ -86,6 +88,17 @@ namespace open_dtc_server
                 bool get_products_filtered(std::vector<Product> &products, ProductType type = ProductType::ALL);
                 bool get_product_types(std::vector<ProductType> &types);
 
+                /**
+                 * Level2 book from market/product_book, best first; limit 0 asks for the full book.
+                 * time_us is the book's exchange time (microseconds since epoch), 0 if absent.
+                 */
+                bool get_product_book(const std::string &product_id, std::vector<base::PriceLevel> &bids,
+                                      std::vector<base::PriceLevel> &asks, uint64_t &time_us, int limit = 0);
+
+                // Orders (one-time bootstrap; live state comes from the user channel)
+                bool get_open_orders(std::vector<base::OrderEvent> &orders);
+                bool get_fills(std::vector<base::FillEvent> &fills, int limit = 100);
+
                 // Configuration
                 void set_sandbox_mode(bool sandbox);
                 void set_timeout(int timeout_seconds);
@@ -113,6 +126,10 @@ namespace open_dtc_server
                 bool parse_account_response(const std::string &json, AccountBalance &account);
                 bool parse_products_response(const std::string &json, std::vector<std::string> &symbols);
                 bool parse_products_filtered_response(const std::string &json, std::vector<Product> &products, ProductType filter_type);
+                bool parse_orders_response(const std::string &json, std::vector<base::OrderEvent> &orders, std::string &cursor);
+                bool parse_fills_response(const std::string &json, std::vector<base::FillEvent> &fills);
+                bool parse_product_book_response(const std::string &json, std::vector<base::PriceLevel> &bids,
+                                                 std::vector<base::PriceLevel> &asks, uint64_t &time_us);
 
                 // Helper methods
                 ProductType parse_product_type(const std::string &product_id) const;
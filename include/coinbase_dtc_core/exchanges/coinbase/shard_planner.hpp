@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace coinbase
+        {
+
+            /**
+             * Places products on upstream WebSocket connections ("shards") by expected
+             * message rate.
+             *
+             * Each product has a weight (messages per second, or an estimate before
+             * any were seen) and lives on exactly one shard; new products go to the
+             * least loaded live shard. When a shard goes down its products move to
+             * the live ones, and when one comes back rebalance() moves products from
+             * the heaviest shards to the lightest until the spread is within
+             * tolerance. Moves are returned so the caller can (un)subscribe them.
+             * Not synchronized; the owner serializes calls.
+             */
+            class ShardPlanner
+            {
+            public:
+                struct Move
+                {
+                    std::string product_id;
+                    size_t from;
+                    size_t to;
+                };
+
+                explicit ShardPlanner(size_t shards);
+
+                size_t shard_count() const { return shards_.size(); }
+
+                /** Shard of product_id, placing it on the least loaded live shard if new */
+                size_t assign(const std::string &product_id, double weight);
+
+                /** Product unsubscribed everywhere */
+                void release(const std::string &product_id);
+
+                /** New expected rate for a product; its shard's load follows */
+                void set_weight(const std::string &product_id, double weight);
+
+                /**
+                 * Shard up or down. Down moves its products to live shards; up
+                 * rebalances onto it. @return the moves, in order
+                 */
+                std::vector<Move> set_live(size_t shard, bool live);
+
+                /**
+                 * Moves that bring every live shard within tolerance (a fraction of
+                 * the mean load) of the others, or as close as whole products allow.
+                 */
+                std::vector<Move> rebalance(double tolerance = 0.25);
+
+                bool is_live(size_t shard) const { return shard < shards_.size() && shards_[shard].live; }
+                double load(size_t shard) const { return shard < shards_.size() ? shards_[shard].load : 0.0; }
+                std::vector<std::string> products_on(size_t shard) const;
+
+                /** @return false if the product is not placed */
+                bool shard_of(const std::string &product_id, size_t &shard) const;
+
+            private:
+                struct Shard
+                {
+                    bool live = true;
+                    double load = 0.0;
+                    size_t products = 0; // Breaks ties between equally loaded shards
+                };
+
+                struct Placement
+                {
+                    size_t shard;
+                    double weight;
+                };
+
+                // Least loaded live shard; any shard if none is live
+                size_t lightest() const;
+                void move(const std::string &product_id, Placement &placement, size_t to, std::vector<Move> &moves);
+
+                std::vector<Shard> shards_;
+                std::unordered_map<std::string, Placement> placements_;
+            };
+
+        } // namespace coinbase
+    } // namespace exchanges
+} // namespace open_dtc_server
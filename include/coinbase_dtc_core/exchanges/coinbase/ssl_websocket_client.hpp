@@ -2,6 +2,8 @@
 
 #include "../../core/util/log.hpp"
 #include "../base/exchange_feed.hpp"
+#include "permessage_deflate.hpp"
+#include "websocket_frame.hpp"
 #include <string>
 #include <vector>
 #include <atomic>
@@ -9,6 +11,7 @@
 #include <mutex>
 #include <queue>
 #include <functional>
+#include <fstream>
 #include <memory>
 
 // OpenSSL includes
@@ -44,7 +47,9 @@ namespace open_dtc_server
              * - SSL/TLS encrypted connections using OpenSSL
              * - JWT authentication for Coinbase Advanced Trade API
              * - Real-time market data streaming over secure WebSocket
-             * - Automatic reconnection with exponential backoff
+             * - Drop detection: a read error, EOF, protocol error or long silence
+             *   ends the connection and reports it through the connection
+             *   callback; the owner reconnects with connect()
              * - Thread-safe message handling
              * - Full WebSocket protocol implementation (RFC 6455)
              */
@@ -57,8 +62,13 @@ namespace open_dtc_server
                 // Connection management
                 bool connect(const std::string &host = "ws-feed.exchange.coinbase.com",
                              uint16_t port = 443);
+                /** Close the connection, or release what is left of a dropped one */
                 void disconnect();
                 bool is_connected() const { return connected_.load(); }
+                /** Try the resolved addresses starting from this one (modulo their count), so redundant connections can take different routes */
+                void set_address_index(size_t index) { address_index_ = index; }
+                /** Address of the current connection, empty before connect() */
+                std::string get_peer_address() const;
 
                 // Message handling
                 bool send_message(const std::string &message);
@@ -71,14 +81,32 @@ namespace open_dtc_server
                 bool subscribe_to_level2(const std::vector<std::string> &symbols);
                 bool unsubscribe_from_ticker(const std::vector<std::string> &symbols);
                 bool unsubscribe_from_level2(const std::vector<std::string> &symbols);
+                // Authenticated Advanced Trade user channel (own orders) plus heartbeats; empty symbols means all products
+                bool subscribe_to_user(const std::vector<std::string> &symbols = {});
                 bool authenticate_with_jwt();
                 void set_credentials(const std::string &api_key_id, const std::string &private_key);
 
+                /**
+                 * Raw capture: append every decoded frame payload to path as
+                 * "<receive time, microseconds since epoch>\t<payload>\n".
+                 * Payloads are single-line JSON, so the file is also a valid
+                 * recording for the feed benchmarks and coinbase_simulator.
+                 */
+                bool start_capture(const std::string &path);
+                void stop_capture();
+                bool is_capturing() const { return capturing_.load(); }
+                uint64_t get_messages_captured() const { return messages_captured_.load(); }
+
                 // Statistics
                 uint64_t get_messages_received() const { return messages_received_.load(); }
                 uint64_t get_messages_sent() const { return messages_sent_.load(); }
                 std::chrono::steady_clock::time_point get_last_message_time() const;
 
+                /** permessage-deflate as negotiated on the current connection, and its totals */
+                bool is_deflate_active() const { return deflate_active_.load(); }
+                bool has_context_takeover() const { return deflate_takeover_.load(); }
+                Inflater::Stats get_compression_stats() const { return inflater_.stats(); }
+
             private:
                 // SSL/TLS methods
                 bool init_ssl();
@@ -91,6 +119,7 @@ namespace open_dtc_server
                 bool perform_websocket_handshake();
                 std::string generate_websocket_key();
                 bool validate_websocket_response(const std::string &response);
+                static std::string find_header(const std::string &response, const std::string &lowercase_name);
 
                 // JWT authentication
                 std::string generate_jwt_token();
@@ -104,21 +133,30 @@ namespace open_dtc_server
                 int receive_ssl_data(char *buffer, size_t buffer_size);
 
                 // WebSocket frame handling
-                std::vector<uint8_t> create_websocket_frame(const std::string &payload, uint8_t opcode = 0x1);
-                std::string parse_websocket_frame(const std::vector<uint8_t> &frame);
-                size_t calculate_frame_size(const std::vector<uint8_t> &frame_data);
+                bool send_frame(WebSocketOpcode opcode, const void *payload, size_t size);
+                // false on a protocol error: frame boundaries are lost
+                bool dispatch_messages(uint64_t receive_time_us);
+                void handle_message(const FrameReader::Message &message, uint64_t receive_time_us);
                 bool is_valid_json_start(const std::string &message);
 
                 // Worker threads
                 void worker_loop();
                 void ping_loop();
-                void process_incoming_messages();
+                // Bytes read, 0 if nothing could be read, -1 if the connection is gone, -2 on a protocol error
+                int process_incoming_messages();
+                // Reader side: the connection ended without disconnect()
+                void connection_lost(const std::string &reason);
+                // Unblock a reader waiting in SSL_read
+                void interrupt_reader();
 
                 // Connection state
                 std::atomic<bool> connected_;
                 std::atomic<bool> should_stop_;
                 std::string host_;
                 uint16_t port_;
+                size_t address_index_ = 0;
+                std::string peer_address_;
+                mutable std::mutex peer_address_mutex_;
 
                 // SSL context
                 SSL_CTX *ssl_ctx_;
@@ -143,17 +181,31 @@ namespace open_dtc_server
                 // Message queue and processing
                 std::queue<std::string> outgoing_messages_;
                 std::mutex message_queue_mutex_;
-                std::vector<uint8_t> incoming_buffer_;
+                FrameReader frame_reader_;   // Socket reads land here (worker thread)
+                std::string message_buffer_; // Decoded text of the current message, reused
+                FrameWriter frame_writer_;
+                std::mutex frame_writer_mutex_;
+                std::atomic<bool> close_sent_{false};
+                static constexpr size_t MIN_READ_BYTES = 16384;
+                static constexpr int PING_INTERVAL_SECONDS = 30;
+                static constexpr int SILENCE_TIMEOUT_SECONDS = 75; // Nothing at all, not even a pong: the link is dead
+
+                // permessage-deflate receive stream (reader thread)
+                Inflater inflater_;
+                std::atomic<bool> deflate_active_{false};
+                std::atomic<bool> deflate_takeover_{false};
+                static constexpr size_t MAX_HANDSHAKE_BYTES = 16384;
 
                 // Statistics
                 std::atomic<uint64_t> messages_received_;
                 std::atomic<uint64_t> messages_sent_;
                 std::atomic<std::chrono::steady_clock::time_point::rep> last_message_time_;
 
-                // Reconnection
-                std::atomic<int> reconnect_attempts_;
-                static constexpr int MAX_RECONNECT_ATTEMPTS = 10;
-                static constexpr int INITIAL_RECONNECT_DELAY_MS = 1000;
+                // Raw capture (written from the worker thread)
+                std::ofstream capture_file_;
+                std::mutex capture_mutex_;
+                std::atomic<bool> capturing_{false};
+                std::atomic<uint64_t> messages_captured_{0};
 
                 // JWT credentials
                 std::string api_key_id_;
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace coinbase
+        {
+
+            /**
+             * Coalesces subscribe/unsubscribe intents into minimal upstream messages.
+             *
+             * For each channel the batcher keeps the products we want and the products
+             * the exchange has been asked for; poll() sends the difference. Intents that
+             * cancel out within the window (subscribe then unsubscribe) send nothing,
+             * and a growing subscription only ever sends the new products. Requests are
+             * split to stay under max_message_bytes and held back to stay under
+             * max_messages_per_second. Not synchronized; the owner serializes calls.
+             */
+            class SubscriptionBatcher
+            {
+            public:
+                using Clock = std::chrono::steady_clock;
+
+                struct Limits
+                {
+                    std::chrono::milliseconds window{50};  // Collect intents this long after the first one
+                    size_t max_message_bytes = 8192;       // Whole subscribe message, authentication included
+                    size_t max_messages_per_second = 8;    // Coinbase WebSocket request rate limit
+                    size_t message_overhead_bytes = 1024;  // Envelope and JWT fields around the product list
+                };
+
+                /** One upstream message: (un)subscribe product_ids on channel */
+                struct Request
+                {
+                    bool subscribe = true;
+                    std::string channel;
+                    std::vector<std::string> product_ids;
+                };
+
+                SubscriptionBatcher() : SubscriptionBatcher(Limits()) {}
+                explicit SubscriptionBatcher(const Limits &limits) : limits_(limits) {}
+
+                void subscribe(const std::string &channel, const std::string &product_id, Clock::time_point now);
+                void unsubscribe(const std::string &channel, const std::string &product_id, Clock::time_point now);
+
+                /** Unsubscribe and subscribe again even though nothing changed (e.g. to get a new snapshot) */
+                void refresh(const std::string &channel, const std::string &product_id, Clock::time_point now);
+
+                /** Forget a product the exchange rejected, without sending anything */
+                void drop(const std::string &channel, const std::string &product_id);
+
+                /** Connection lost: the exchange has nothing; everything wanted is sent again */
+                void reset(Clock::time_point now);
+
+                /**
+                 * Requests due at now, unsubscribes first, within the rate limit.
+                 * Whatever the limit holds back stays queued for a later poll().
+                 */
+                std::vector<Request> poll(Clock::time_point now);
+
+                /** When poll() next has something to send; Clock::time_point::max() if nothing is queued */
+                Clock::time_point next_due() const;
+
+                bool is_wanted(const std::string &channel, const std::string &product_id) const;
+                std::vector<std::string> wanted(const std::string &channel) const;
+                bool has_pending() const;
+
+                uint64_t messages_sent() const { return messages_sent_; }
+                uint64_t intents() const { return intents_; }
+
+            private:
+                struct ChannelState
+                {
+                    std::set<std::string> wanted;
+                    std::set<std::string> upstream;
+                    std::set<std::string> refresh;
+                };
+
+                void mark_dirty(Clock::time_point now);
+                void split(bool subscribe, const std::string &channel, const std::vector<std::string> &products,
+                           std::vector<Request> &out) const;
+
+                Limits limits_;
+                std::map<std::string, ChannelState> channels_;
+                bool dirty_ = false;
+                Clock::time_point dirty_since_;
+                std::deque<Clock::time_point> recent_sends_; // Within the last second
+                uint64_t messages_sent_ = 0;
+                uint64_t intents_ = 0;
+            };
+
+        } // namespace coinbase
+    } // namespace exchanges
+} // namespace open_dtc_server
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "coinbase_dtc_core/core/auth/jwt_auth.hpp"
+#include "coinbase_dtc_core/exchanges/base/order_transport.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace open_dtc_server
+{
+    namespace feed
+    {
+        namespace coinbase
+        {
+            class SSLWebSocketClient;
+        }
+    }
+
+    namespace exchanges
+    {
+        namespace coinbase
+        {
+
+            /**
+             * Streams the account's own orders from the authenticated Advanced Trade
+             * `user` WebSocket channel.
+             *
+             * The channel opens with a snapshot of open orders and then pushes every
+             * state change (fills included, as cumulative quantity and average price),
+             * so order state never needs REST polling. Each order in a message is
+             * delivered to the order callback on the WebSocket thread.
+             */
+            class CoinbaseUserFeed
+            {
+            public:
+                using OrderCallback = std::function<void(const base::OrderEvent &)>;
+
+                static constexpr const char *USER_WEBSOCKET_HOST = "advanced-trade-ws-user.coinbase.com";
+                static constexpr uint16_t USER_WEBSOCKET_PORT = 443;
+
+                explicit CoinbaseUserFeed(const auth::CDPCredentials &credentials,
+                                          const std::string &host = USER_WEBSOCKET_HOST);
+                ~CoinbaseUserFeed();
+
+                CoinbaseUserFeed(const CoinbaseUserFeed &) = delete;
+                CoinbaseUserFeed &operator=(const CoinbaseUserFeed &) = delete;
+
+                /** Set before connect() */
+                void set_order_callback(OrderCallback callback) { order_callback_ = std::move(callback); }
+                void set_connection_callback(std::function<void(bool)> callback) { connection_callback_ = std::move(callback); }
+
+                /** Connect and subscribe; empty symbols follows orders on every product */
+                bool connect(const std::vector<std::string> &symbols = {});
+                void disconnect();
+                bool is_connected() const;
+
+                uint64_t get_orders_received() const { return orders_received_.load(); }
+
+                /**
+                 * Extract the orders from one user channel message.
+                 * @return false when the message is not a user channel message (heartbeats, subscriptions, errors)
+                 */
+                static bool parse_user_message(const std::string &message, std::vector<base::OrderEvent> &orders);
+
+            private:
+                void on_message(const std::string &message);
+
+                auth::CDPCredentials credentials_;
+                std::string host_;
+                std::vector<std::string> symbols_;
+                std::unique_ptr<feed::coinbase::SSLWebSocketClient> client_;
+
+                OrderCallback order_callback_;
+                std::function<void(bool)> connection_callback_;
+
+                std::atomic<uint64_t> orders_received_{0};
+                std::vector<base::OrderEvent> scratch_; // Reused per message; WebSocket thread only
+            };
+
+        } // namespace coinbase
+    } // namespace exchanges
+} // namespace open_dtc_server
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace open_dtc_server
+{
+    namespace feed
+    {
+        namespace coinbase
+        {
+
+            /** WebSocket opcodes (RFC 6455 section 5.2) */
+            enum class WebSocketOpcode : uint8_t
+            {
+                CONTINUATION = 0x0,
+                TEXT = 0x1,
+                BINARY = 0x2,
+                CLOSE = 0x8,
+                PING = 0x9,
+                PONG = 0xA
+            };
+
+            /**
+             * XOR size bytes in place with a 4-byte masking key; key[0] applies
+             * to data[0]. 16 bytes per step with SSE2 or NEON, 8 otherwise.
+             */
+            void mask_websocket_payload(uint8_t *data, size_t size, const uint8_t key[4]);
+
+            /**
+             * Incremental frame parser over one receive buffer.
+             *
+             * Socket reads land directly in the buffer (write_space/commit) and
+             * next() parses frames where they lie: masked payloads are unmasked
+             * in place and messages come back as views into the buffer, so a
+             * frame is never copied on its way to the caller. Consumed bytes are
+             * reclaimed lazily: the unparsed tail is moved to the front only when
+             * a read needs room at the end, which keeps every message contiguous
+             * where a wrapping ring could not.
+             *
+             * Fragmented messages are reassembled in place by sliding each
+             * continuation payload up against the previous one. Control frames
+             * (ping, pong, close) may arrive between fragments and are returned
+             * as soon as they are complete.
+             */
+            class FrameReader
+            {
+            public:
+                struct Message
+                {
+                    WebSocketOpcode opcode = WebSocketOpcode::TEXT;
+                    bool compressed = false; // RSV1 on the first frame (permessage-deflate)
+                    const uint8_t *data = nullptr;
+                    size_t size = 0;
+
+                    std::string_view text() const { return std::string_view(reinterpret_cast<const char *>(data), size); }
+                };
+
+                enum class Status
+                {
+                    NEED_MORE,     // No complete message buffered
+                    MESSAGE,       // message filled; valid until the next call to next(), write_space() or append()
+                    PROTOCOL_ERROR // See error(); reset() before reuse
+                };
+
+                static constexpr size_t DEFAULT_CAPACITY = 64 * 1024;
+                static constexpr size_t DEFAULT_MAX_MESSAGE = 64 * 1024 * 1024;
+
+                explicit FrameReader(size_t capacity = DEFAULT_CAPACITY, size_t max_message_bytes = DEFAULT_MAX_MESSAGE);
+
+                /** Room for at least min_bytes at the end of the buffer; available gets the full free length */
+                uint8_t *write_space(size_t min_bytes, size_t &available);
+                /** bytes of the space returned by write_space() now hold data */
+                void commit(size_t bytes);
+                /** Copying write_space()/commit(), for bytes that were read elsewhere */
+                void append(const uint8_t *data, size_t size);
+
+                Status next(Message &message);
+
+                /** Drop everything buffered, for a new connection */
+                void reset();
+
+                const std::string &error() const { return error_; }
+                size_t buffered() const { return write_ - read_; }
+                size_t capacity() const { return buffer_.size(); }
+
+            private:
+                Status fail(const std::string &error);
+                void release();
+
+                std::vector<uint8_t> buffer_;
+                size_t read_ = 0;  // First byte still needed: an unparsed frame, or a message being reassembled
+                size_t parse_ = 0; // Next frame header
+                size_t write_ = 0; // End of received data
+                size_t max_message_bytes_;
+
+                // Fragmented message, reassembled at [read_, assembled_end_)
+                bool fragmented_ = false;
+                WebSocketOpcode fragment_opcode_ = WebSocketOpcode::TEXT;
+                bool fragment_compressed_ = false;
+                size_t assembled_end_ = 0;
+
+                std::string error_;
+            };
+
+            /**
+             * Builds client frames (always masked, RFC 6455 section 5.3) into one
+             * buffer that is kept across calls. Masking keys are random, drawn
+             * from a pool filled by the system CSPRNG.
+             *
+             * Not thread-safe; the client serializes senders around it.
+             */
+            class FrameWriter
+            {
+            public:
+                explicit FrameWriter(size_t capacity = 4096);
+
+                /** One unfragmented frame; the result stays valid until the next build() */
+                std::string_view build(WebSocketOpcode opcode, const void *payload, size_t size);
+
+            private:
+                void next_mask(uint8_t key[4]);
+
+                std::vector<uint8_t> buffer_;
+                uint8_t mask_pool_[256];
+                size_t mask_pool_used_;
+            };
+
+        } // namespace coinbase
+    } // namespace feed
+} // namespace open_dtc_server
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "coinbase_dtc_core/exchanges/base/exchange_feed.hpp"
+#include "coinbase_dtc_core/exchanges/base/market_journal.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace replay
+        {
+
+            /**
+             * Replays a recorded MarketJournal session as exchange "replay".
+             *
+             * connect() starts a thread that reads the journal in config.replay_path
+             * and emits its trades, quotes and book changes through notify_trade,
+             * notify_level2 and notify_depth. Gaps between record timestamps are
+             * kept (replay_speed = 1), divided by replay_speed, or skipped entirely
+             * (replay_speed = 0). Symbols are passed through as recorded; when
+             * symbols are subscribed only those are replayed.
+             */
+            class ReplayFeed : public open_dtc_server::exchanges::base::ExchangeFeedBase
+            {
+            public:
+                explicit ReplayFeed(const open_dtc_server::exchanges::base::ExchangeConfig &config);
+                ~ReplayFeed() override;
+
+                bool connect() override;
+                void disconnect() override;
+                bool is_connected() const override;
+
+                bool subscribe_trades(const std::string &symbol) override;
+                bool subscribe_level2(const std::string &symbol) override;
+                bool unsubscribe(const std::string &symbol) override;
+                bool subscribe_multiple_symbols(const std::vector<std::string> &symbols) override;
+
+                std::string normalize_symbol(const std::string &exchange_symbol) override { return exchange_symbol; }
+                std::string exchange_symbol(const std::string &normalized_symbol) override { return normalized_symbol; }
+                std::vector<std::string> get_available_symbols() override;
+
+                std::string get_status() const override;
+                std::vector<std::string> get_subscribed_symbols() const override;
+
+                /** Block until the whole journal has been replayed (or disconnect) */
+                bool wait_until_finished(std::chrono::milliseconds timeout);
+
+                uint64_t get_records_replayed() const { return records_replayed_.load(); }
+                bool is_finished() const { return finished_.load(); }
+
+            private:
+                static constexpr size_t READ_BATCH = 4096;
+
+                void replay_thread_function();
+                void emit(const open_dtc_server::exchanges::base::JournalRecord &record);
+                void flush_snapshot();
+                bool is_wanted(const std::string &symbol) const;
+
+                std::thread replay_thread_;
+                std::atomic<bool> running_{false};
+                std::atomic<bool> finished_{false};
+                std::mutex finished_mutex_;
+                std::condition_variable finished_cv_;
+
+                std::unordered_set<std::string> subscribed_symbols_;
+                mutable std::mutex symbols_mutex_;
+
+                // Replay thread state
+                std::unordered_map<open_dtc_server::exchanges::base::InstrumentId, open_dtc_server::exchanges::base::MarketLevel2> pending_quotes_;
+                open_dtc_server::exchanges::base::InstrumentId snapshot_instrument_ = open_dtc_server::exchanges::base::NO_INSTRUMENT;
+                uint64_t snapshot_timestamp_ = 0;
+                std::vector<open_dtc_server::exchanges::base::PriceLevel> snapshot_bids_;
+                std::vector<open_dtc_server::exchanges::base::PriceLevel> snapshot_asks_;
+
+                std::atomic<uint64_t> records_replayed_{0};
+                std::atomic<uint64_t> trades_replayed_{0};
+            };
+
+        } // namespace replay
+    } // namespace exchanges
+} // namespace open_dtc_server
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace open_dtc_server
+{
+    namespace simulator
+    {
+
+        /**
+         * Configuration for the local Coinbase WebSocket feed simulator.
+         */
+        struct SimulatorConfig
+        {
+            std::string bind_address = "127.0.0.1";
+            uint16_t port = 8443; // 0 picks an ephemeral port (see CoinbaseSimulator::get_port)
+
+            // PEM certificate and key; when empty a self-signed certificate is generated in memory
+            std::string certificate_file;
+            std::string private_key_file;
+
+            // Products accepted by subscribe; synthetic books start at a per-product base price
+            std::vector<std::string> products = {"BTC-USD", "ETH-USD", "SOL-USD"};
+
+            // Market data messages per second, per connection (0 = as fast as the socket drains)
+            uint64_t messages_per_second = 1000;
+
+            // JSON lines of recorded Coinbase messages (or a raw capture); when set they are replayed instead of synthetic data
+            std::string recording_file;
+
+            bool enable_deflate = true;          // Negotiate permessage-deflate when the client offers it
+            bool deflate_context_takeover = true; // Compress each message against the previous ones, unless the client asks not to
+            uint32_t heartbeat_interval_ms = 1000; // Coinbase sends one heartbeat per second
+            size_t book_depth = 50;              // Levels per side in synthetic snapshots
+            uint32_t seed = 1;
+        };
+
+        /** One line of a recording, classified once at load time */
+        struct RecordedMessage
+        {
+            std::string channel; // ticker, matches, level2 or heartbeat
+            std::string product_id;
+            std::string text;
+        };
+
+        using Recording = std::vector<RecordedMessage>;
+
+        /**
+         * Coinbase feed protocol state for one client connection.
+         *
+         * Handles subscribe/unsubscribe requests and produces subscriptions,
+         * error, snapshot, l2update, match, ticker and heartbeat messages.
+         * It performs no I/O, so it can be driven directly by tests and by
+         * the connection threads of CoinbaseSimulator.
+         */
+        class FeedSession
+        {
+        public:
+            FeedSession(const SimulatorConfig &config, std::shared_ptr<const Recording> recording = nullptr);
+
+            /** Process one client text message, appending replies to out */
+            void handle_message(const std::string &message, std::vector<std::string> &out);
+
+            /**
+             * Append market data for the active subscriptions until at least count
+             * messages were added (one trade can add a match, a ticker and an
+             * l2update). Returns the number added; 0 without data subscriptions.
+             */
+            size_t generate(size_t count, std::vector<std::string> &out);
+
+            /** Append one heartbeat per product subscribed to the heartbeat channel */
+            void heartbeats(std::vector<std::string> &out);
+
+            bool has_data_subscriptions() const;
+            bool is_subscribed(const std::string &channel, const std::string &product_id) const;
+
+            static bool is_valid_channel(const std::string &channel);
+            static bool load_recording(const std::string &path, Recording &recording);
+
+        private:
+            // Prices in cents and sizes in satoshis keep the synthetic books exact
+            struct Book
+            {
+                std::map<int64_t, int64_t, std::greater<int64_t>> bids;
+                std::map<int64_t, int64_t> asks;
+                int64_t open = 0;
+                int64_t low = 0;
+                int64_t high = 0;
+                int64_t volume = 0;
+            };
+
+            struct DataProduct
+            {
+                std::string product_id;
+                bool ticker = false;
+                bool matches = false;
+                bool level2 = false;
+            };
+
+            void subscribe(const std::map<std::string, std::vector<std::string>> &request, std::vector<std::string> &out);
+            void unsubscribe(const std::map<std::string, std::vector<std::string>> &request, std::vector<std::string> &out);
+            std::string subscriptions_message() const;
+            std::string error_message(const std::string &message, const std::string &reason) const;
+
+            Book &book_for(const std::string &product_id);
+            std::string snapshot_message(const std::string &product_id);
+            void rebuild_data_products();
+            size_t generate_level2(const DataProduct &product, std::vector<std::string> &out);
+            size_t generate_trade(const DataProduct &product, std::vector<std::string> &out);
+            size_t generate_recorded(size_t count, std::vector<std::string> &out);
+
+            int64_t random_size();
+            const char *timestamp();
+
+            SimulatorConfig config_;
+            std::shared_ptr<const Recording> recording_;
+            size_t recording_cursor_ = 0;
+            std::set<std::string> valid_products_;
+
+            std::map<std::string, std::set<std::string>> subscriptions_; // channel -> products
+            std::vector<DataProduct> data_products_;                       // rebuilt on every (un)subscribe
+
+            std::map<std::string, Book> books_;
+            std::mt19937_64 rng_;
+            uint64_t sequence_ = 0;
+            uint64_t trade_id_ = 0;
+
+            int64_t time_second_ = -1;
+            char time_prefix_[32] = {};
+            char time_buffer_[64] = {}; // Prefix, dot, fraction (as wide as a long long can print) and Z
+        };
+
+        struct SimulatorStats
+        {
+            uint64_t connections = 0;
+            uint64_t active_connections = 0;
+            uint64_t messages_sent = 0;
+            uint64_t bytes_sent = 0; // On the wire, after compression and framing
+        };
+
+        /**
+         * Standalone TLS WebSocket server speaking the Coinbase Exchange feed
+         * protocol, for exercising SSLWebSocketClient and CoinbaseFeed offline.
+         *
+         * One thread accepts connections and each connection gets its own
+         * thread running a FeedSession, pacing market data at
+         * messages_per_second and writing it in batched frames.
+         */
+        class CoinbaseSimulator
+        {
+        public:
+            explicit CoinbaseSimulator(const SimulatorConfig &config);
+            ~CoinbaseSimulator();
+
+            bool start();
+            void stop();
+            bool is_running() const { return running_.load(); }
+
+            /** Port actually bound (differs from config.port when that is 0) */
+            uint16_t get_port() const { return port_; }
+            SimulatorStats get_stats() const;
+
+            /** Cut every open connection as a network failure would; returns how many were cut */
+            size_t drop_connections();
+
+        private:
+            struct Connection;
+
+            bool init_ssl();
+            void accept_loop();
+            void reap_connections(bool all);
+            void connection_loop(std::shared_ptr<Connection> connection);
+            bool websocket_handshake(Connection &connection);
+            bool read_frames(Connection &connection, FeedSession &session, std::vector<std::string> &replies);
+            bool send_messages(Connection &connection, const std::vector<std::string> &messages);
+            bool send_frame(Connection &connection, uint8_t opcode, const std::string &payload);
+            void append_frame(std::string &buffer, uint8_t first_byte, const char *payload, size_t length);
+
+            SimulatorConfig config_;
+            std::shared_ptr<const Recording> recording_;
+            void *ssl_ctx_ = nullptr; // SSL_CTX, kept opaque so the header does not pull in OpenSSL
+
+            int listen_fd_ = -1;
+            uint16_t port_ = 0;
+            std::atomic<bool> running_{false};
+            std::thread accept_thread_;
+
+            std::mutex connections_mutex_;
+            std::vector<std::shared_ptr<Connection>> connections_;
+
+            std::atomic<uint64_t> total_connections_{0};
+            std::atomic<uint64_t> active_connections_{0};
+            std::atomic<uint64_t> messages_sent_{0};
+            std::atomic<uint64_t> bytes_sent_{0};
+        };
+
+    } // namespace simulator
+} // namespace open_dtc_server
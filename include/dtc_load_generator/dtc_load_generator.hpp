@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace open_dtc_server
+{
+    namespace loadgen
+    {
+
+        /**
+         * Configuration for a DTC client swarm run.
+         */
+        struct LoadGeneratorConfig
+        {
+            std::string host = "127.0.0.1";
+            uint16_t port = 11099;
+
+            uint32_t sessions = 100;
+            uint32_t threads = 0; // 0 = hardware concurrency
+
+            // Weighted symbols, e.g. "BTC-USD:3,ETH-USD:1"; each session draws symbols_per_session of them
+            std::string symbol_mix = "BTC-USD:1";
+            uint32_t symbols_per_session = 1;
+            std::string exchange = "coinbase";
+
+            uint32_t connect_rate = 500;     // New connections per second across all threads (0 = all at once)
+            uint32_t duration_seconds = 10;  // Measurement window after the first connect
+            uint32_t heartbeat_interval_seconds = 10;
+            uint32_t seed = 1;
+        };
+
+        /**
+         * Latency histogram with log-linear buckets: every power of two is split
+         * into 128 linear sub-buckets, so percentiles are within 1% of the true
+         * value while record() stays a couple of integer operations.
+         */
+        class LatencyHistogram
+        {
+        public:
+            LatencyHistogram();
+
+            void record(uint64_t value);
+            void merge(const LatencyHistogram &other);
+
+            /** Upper bound of the bucket holding the given percentile (0-100) */
+            uint64_t percentile(double percent) const;
+
+            uint64_t count() const { return count_; }
+            uint64_t max() const { return max_; }
+            double mean() const { return count_ ? static_cast<double>(sum_) / count_ : 0.0; }
+
+        private:
+            static constexpr int SUB_BUCKET_BITS = 7;
+            static size_t bucket_index(uint64_t value);
+            static uint64_t bucket_upper_bound(size_t index);
+
+            std::vector<uint64_t> buckets_;
+            uint64_t count_ = 0;
+            uint64_t max_ = 0;
+            uint64_t sum_ = 0;
+        };
+
+        /**
+         * Result of a run, serialized with to_json() so builds can be compared.
+         */
+        struct LoadReport
+        {
+            uint32_t sessions_requested = 0;
+            uint32_t sessions_connected = 0;
+            uint32_t sessions_logged_on = 0;
+            uint64_t subscriptions_accepted = 0;
+            uint64_t subscriptions_rejected = 0;
+            uint64_t connect_failures = 0;
+            uint64_t dropped_connections = 0;
+
+            uint64_t messages_received = 0;
+            uint64_t bytes_received = 0;
+            uint64_t trade_updates = 0;
+            uint64_t bid_ask_updates = 0;
+            uint64_t depth_updates = 0;
+            uint64_t other_messages = 0;
+
+            double elapsed_seconds = 0.0;
+            double messages_per_second = 0.0;
+            double bytes_per_second = 0.0;
+
+            // End-to-end latency from the server timestamp in each update to its receipt
+            LatencyHistogram latency_us;
+            std::string timestamp_resolution = "none"; // seconds, milliseconds or microseconds
+
+            std::string to_json() const;
+        };
+
+        /**
+         * Non-blocking DTC client swarm.
+         *
+         * Sessions are spread across worker threads, each driving its share
+         * with non-blocking sockets and a single poll() loop: connect, logon,
+         * subscribe to the configured symbol mix, then count and time every
+         * market data update until the duration elapses.
+         */
+        class LoadGenerator
+        {
+        public:
+            explicit LoadGenerator(const LoadGeneratorConfig &config);
+
+            /** Run to completion (or until stop()) and return the merged report */
+            LoadReport run();
+            void stop() { running_ = false; }
+
+            /** Parse "SYM:weight,SYM:weight"; a missing weight counts as 1 */
+            static bool parse_symbol_mix(const std::string &mix, std::vector<std::pair<std::string, uint32_t>> &symbols);
+
+        private:
+            struct Session;
+
+            void worker_loop(uint32_t thread_index, uint32_t thread_count, LoadReport &report);
+            std::vector<std::string> pick_symbols(uint32_t session_index) const;
+
+            LoadGeneratorConfig config_;
+            std::vector<std::pair<std::string, uint32_t>> symbols_;
+            uint64_t total_weight_ = 0;
+            std::atomic<bool> running_{false};
+        };
+
+    } // namespace loadgen
+} // namespace open_dtc_server
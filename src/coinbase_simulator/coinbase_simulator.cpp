@@ -0,0 +1,1169 @@
+#include "coinbase_simulator/coinbase_simulator.hpp"
+#include "coinbase_dtc_core/core/util/log.hpp"
+#include <nlohmann/json.hpp>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+#include <zlib.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+
+namespace open_dtc_server
+{
+    namespace simulator
+    {
+        namespace
+        {
+            const char *const CHANNEL_TICKER = "ticker";
+            const char *const CHANNEL_MATCHES = "matches";
+            const char *const CHANNEL_LEVEL2 = "level2";
+            const char *const CHANNEL_HEARTBEAT = "heartbeat";
+
+            const char *const WEBSOCKET_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC11B65";
+
+            constexpr size_t MAX_BATCH = 1024;           // Messages generated per loop iteration
+            constexpr size_t WRITE_CHUNK = 64 * 1024;    // Frames coalesced per SSL_write
+            constexpr size_t MAX_HANDSHAKE = 16 * 1024;
+
+            int64_t base_price_cents(const std::string &product_id)
+            {
+                if (product_id.rfind("BTC-", 0) == 0)
+                    return 3000000;
+                if (product_id.rfind("ETH-", 0) == 0)
+                    return 200000;
+                return 10000;
+            }
+
+            void append_decimal(std::string &out, int64_t value, int64_t scale, int digits)
+            {
+                char buffer[32];
+                int length = std::snprintf(buffer, sizeof(buffer), "\"%lld.%0*lld\"",
+                                           static_cast<long long>(value / scale), digits,
+                                           static_cast<long long>(value % scale));
+                out.append(buffer, length);
+            }
+
+            void append_price(std::string &out, int64_t cents) { append_decimal(out, cents, 100, 2); }
+            void append_size(std::string &out, int64_t satoshis) { append_decimal(out, satoshis, 100000000, 8); }
+
+            // ["price","size"] as in snapshots
+            void append_level(std::string &out, int64_t price, int64_t size)
+            {
+                if (out.back() == ']')
+                    out += ',';
+                out += '[';
+                append_price(out, price);
+                out += ',';
+                append_size(out, size);
+                out += ']';
+            }
+
+            // ["buy"|"sell","price","size"] as in l2update changes
+            void append_change(std::string &out, bool bid, int64_t price, int64_t size)
+            {
+                if (out.back() == ']')
+                    out += ',';
+                out += bid ? "[\"buy\"," : "[\"sell\",";
+                append_price(out, price);
+                out += ',';
+                append_size(out, size);
+                out += ']';
+            }
+
+            std::string lowercase(std::string text)
+            {
+                std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c)
+                               { return static_cast<char>(std::tolower(c)); });
+                return text;
+            }
+        }
+
+        // ========================================================================
+        // FeedSession
+        // ========================================================================
+
+        FeedSession::FeedSession(const SimulatorConfig &config, std::shared_ptr<const Recording> recording)
+            : config_(config), recording_(std::move(recording)), rng_(config.seed)
+        {
+            valid_products_.insert(config_.products.begin(), config_.products.end());
+            if (recording_)
+            {
+                for (const auto &message : *recording_)
+                    valid_products_.insert(message.product_id);
+            }
+        }
+
+        bool FeedSession::is_valid_channel(const std::string &channel)
+        {
+            return channel == CHANNEL_TICKER || channel == CHANNEL_MATCHES ||
+                   channel == CHANNEL_LEVEL2 || channel == CHANNEL_HEARTBEAT;
+        }
+
+        void FeedSession::handle_message(const std::string &message, std::vector<std::string> &out)
+        {
+            nlohmann::json json;
+            std::map<std::string, std::vector<std::string>> request;
+            std::string type;
+            try
+            {
+                json = nlohmann::json::parse(message);
+                type = json.value("type", "");
+
+                // Channels are either names using the top-level product_ids or {name, product_ids} objects
+                std::vector<std::string> product_ids;
+                if (json.contains("product_ids"))
+                    product_ids = json["product_ids"].get<std::vector<std::string>>();
+
+                if (json.contains("channels"))
+                {
+                    for (const auto &channel : json["channels"])
+                    {
+                        if (channel.is_string())
+                        {
+                            auto &products = request[channel.get<std::string>()];
+                            products.insert(products.end(), product_ids.begin(), product_ids.end());
+                        }
+                        else
+                        {
+                            auto &products = request[channel.at("name").get<std::string>()];
+                            auto channel_products = channel.contains("product_ids")
+                                                        ? channel["product_ids"].get<std::vector<std::string>>()
+                                                        : product_ids;
+                            products.insert(products.end(), channel_products.begin(), channel_products.end());
+                        }
+                    }
+                }
+            }
+            catch (const std::exception &e)
+            {
+                out.push_back(error_message("Failed to parse message", e.what()));
+                return;
+            }
+
+            if (type != "subscribe" && type != "unsubscribe")
+            {
+                out.push_back(error_message("Failed to subscribe", "Type has to be either subscribe or unsubscribe"));
+                return;
+            }
+
+            // A request with any invalid channel or product is rejected as a whole
+            for (const auto &entry : request)
+            {
+                if (!is_valid_channel(entry.first))
+                {
+                    out.push_back(error_message("Failed to subscribe", entry.first + " is not a valid channel"));
+                    return;
+                }
+                if (type == "subscribe" && entry.second.empty())
+                {
+                    out.push_back(error_message("Failed to subscribe", "No product ids provided for " + entry.first));
+                    return;
+                }
+                for (const auto &product_id : entry.second)
+                {
+                    if (valid_products_.count(product_id) == 0)
+                    {
+                        out.push_back(error_message("Failed to subscribe", product_id + " is not a valid product"));
+                        return;
+                    }
+                }
+            }
+
+            if (type == "subscribe")
+                subscribe(request, out);
+            else
+                unsubscribe(request, out);
+        }
+
+        void FeedSession::subscribe(const std::map<std::string, std::vector<std::string>> &request, std::vector<std::string> &out)
+        {
+            std::vector<std::string> new_books;
+            for (const auto &entry : request)
+            {
+                auto &products = subscriptions_[entry.first];
+                for (const auto &product_id : entry.second)
+                {
+                    if (products.insert(product_id).second && entry.first == CHANNEL_LEVEL2)
+                        new_books.push_back(product_id);
+                }
+            }
+            rebuild_data_products();
+
+            out.push_back(subscriptions_message());
+            for (const auto &product_id : new_books)
+                out.push_back(snapshot_message(product_id));
+        }
+
+        void FeedSession::unsubscribe(const std::map<std::string, std::vector<std::string>> &request, std::vector<std::string> &out)
+        {
+            for (const auto &entry : request)
+            {
+                auto it = subscriptions_.find(entry.first);
+                if (it == subscriptions_.end())
+                    continue;
+
+                // A channel without product ids drops the whole channel
+                if (entry.second.empty())
+                    it->second.clear();
+                for (const auto &product_id : entry.second)
+                    it->second.erase(product_id);
+                if (it->second.empty())
+                    subscriptions_.erase(it);
+            }
+            rebuild_data_products();
+
+            out.push_back(subscriptions_message());
+        }
+
+        void FeedSession::rebuild_data_products()
+        {
+            std::map<std::string, DataProduct> products;
+            for (const char *channel : {CHANNEL_TICKER, CHANNEL_MATCHES, CHANNEL_LEVEL2})
+            {
+                auto it = subscriptions_.find(channel);
+                if (it == subscriptions_.end())
+                    continue;
+                for (const auto &product_id : it->second)
+                {
+                    auto &product = products[product_id];
+                    product.product_id = product_id;
+                    product.ticker = product.ticker || channel == CHANNEL_TICKER;
+                    product.matches = product.matches || channel == CHANNEL_MATCHES;
+                    product.level2 = product.level2 || channel == CHANNEL_LEVEL2;
+                }
+            }
+
+            data_products_.clear();
+            for (auto &entry : products)
+                data_products_.push_back(std::move(entry.second));
+        }
+
+        bool FeedSession::has_data_subscriptions() const
+        {
+            return !data_products_.empty();
+        }
+
+        bool FeedSession::is_subscribed(const std::string &channel, const std::string &product_id) const
+        {
+            auto it = subscriptions_.find(channel);
+            return it != subscriptions_.end() && it->second.count(product_id) > 0;
+        }
+
+        std::string FeedSession::subscriptions_message() const
+        {
+            nlohmann::json channels = nlohmann::json::array();
+            for (const auto &entry : subscriptions_)
+                channels.push_back({{"name", entry.first}, {"product_ids", entry.second}});
+            return nlohmann::json{{"type", "subscriptions"}, {"channels", channels}}.dump();
+        }
+
+        std::string FeedSession::error_message(const std::string &message, const std::string &reason) const
+        {
+            return nlohmann::json{{"type", "error"}, {"message", message}, {"reason", reason}}.dump();
+        }
+
+        FeedSession::Book &FeedSession::book_for(const std::string &product_id)
+        {
+            auto it = books_.find(product_id);
+            if (it != books_.end())
+                return it->second;
+
+            Book &book = books_[product_id];
+            int64_t mid = base_price_cents(product_id);
+            for (size_t level = 1; level <= config_.book_depth; ++level)
+            {
+                book.bids[mid - static_cast<int64_t>(level)] = random_size();
+                book.asks[mid + static_cast<int64_t>(level)] = random_size();
+            }
+            book.open = book.low = book.high = mid;
+            return book;
+        }
+
+        std::string FeedSession::snapshot_message(const std::string &product_id)
+        {
+            Book &book = book_for(product_id);
+
+            std::string message;
+            message.reserve(64 + (book.bids.size() + book.asks.size()) * 32);
+            message += "{\"type\":\"snapshot\",\"product_id\":\"" + product_id + "\",\"bids\":[";
+            for (const auto &level : book.bids)
+                append_level(message, level.first, level.second);
+            message += "],\"asks\":[";
+            for (const auto &level : book.asks)
+                append_level(message, level.first, level.second);
+            message += "]}";
+            return message;
+        }
+
+        size_t FeedSession::generate(size_t count, std::vector<std::string> &out)
+        {
+            if (recording_)
+                return generate_recorded(count, out);
+            if (data_products_.empty())
+                return 0;
+
+            size_t added = 0;
+            while (added < count)
+            {
+                const DataProduct &product = data_products_[rng_() % data_products_.size()];
+                bool trades = product.ticker || product.matches;
+
+                // Roughly 70% book updates and 30% trades, as on the live feed
+                if (product.level2 && (!trades || rng_() % 100 < 70))
+                    added += generate_level2(product, out);
+                else
+                    added += generate_trade(product, out);
+            }
+            return added;
+        }
+
+        size_t FeedSession::generate_level2(const DataProduct &product, std::vector<std::string> &out)
+        {
+            Book &book = book_for(product.product_id);
+            bool bid = (rng_() & 1) != 0;
+            int64_t offset = static_cast<int64_t>(rng_() % std::max<size_t>(config_.book_depth, 1));
+
+            std::string message;
+            message.reserve(160);
+            message += "{\"type\":\"l2update\",\"product_id\":\"";
+            message += product.product_id;
+            message += "\",\"changes\":[";
+
+            auto update = [&](auto &side, int64_t price)
+            {
+                auto it = side.find(price);
+                int64_t size = (it != side.end() && side.size() > 1 && rng_() % 100 < 30) ? 0 : random_size();
+                if (size == 0)
+                    side.erase(it);
+                else
+                    side[price] = size;
+                append_change(message, bid, price, size);
+
+                // Keep the book bounded: drop the worst level when a side grows past twice the depth
+                if (side.size() > config_.book_depth * 2)
+                {
+                    auto worst = std::prev(side.end());
+                    append_change(message, bid, worst->first, 0);
+                    side.erase(worst);
+                }
+            };
+
+            if (bid)
+            {
+                int64_t best = !book.bids.empty() ? book.bids.begin()->first : book.asks.begin()->first - 1;
+                update(book.bids, best - offset);
+            }
+            else
+            {
+                int64_t best = !book.asks.empty() ? book.asks.begin()->first : book.bids.begin()->first + 1;
+                update(book.asks, best + offset);
+            }
+
+            message += "],\"time\":\"";
+            message += timestamp();
+            message += "\"}";
+            out.push_back(std::move(message));
+            sequence_++;
+            return 1;
+        }
+
+        size_t FeedSession::generate_trade(const DataProduct &product, std::vector<std::string> &out)
+        {
+            Book &book = book_for(product.product_id);
+            bool buy = (rng_() & 1) != 0; // Taker side; the maker rests on the opposite side
+
+            std::string changes;
+            int64_t price = 0;
+            int64_t size = 0;
+
+            auto take = [&](auto &side, bool side_is_bid, int64_t refill_price)
+            {
+                auto level = side.begin();
+                price = level->first;
+                size = std::min(level->second, random_size());
+                level->second -= size;
+                append_change(changes, side_is_bid, price, level->second);
+                if (level->second == 0)
+                    side.erase(level);
+                if (side.empty())
+                {
+                    // Never leave a side empty: a new level appears one tick further out
+                    side[refill_price] = random_size();
+                    append_change(changes, side_is_bid, refill_price, side.begin()->second);
+                }
+            };
+
+            changes = "[";
+            if (buy)
+                take(book.asks, false, book.asks.begin()->first + 1);
+            else
+                take(book.bids, true, book.bids.begin()->first - 1);
+
+            trade_id_++;
+            book.volume += size;
+            book.low = std::min(book.low, price);
+            book.high = std::max(book.high, price);
+            const char *time = timestamp();
+            size_t added = 0;
+
+            if (product.matches)
+            {
+                std::string message;
+                message.reserve(220);
+                message += "{\"type\":\"match\",\"trade_id\":" + std::to_string(trade_id_) +
+                           ",\"sequence\":" + std::to_string(++sequence_) +
+                           ",\"side\":\"" + (buy ? "sell" : "buy") + "\",\"size\":";
+                append_size(message, size);
+                message += ",\"price\":";
+                append_price(message, price);
+                message += ",\"product_id\":\"" + product.product_id + "\",\"time\":\"" + time + "\"}";
+                out.push_back(std::move(message));
+                added++;
+            }
+
+            if (product.level2)
+            {
+                std::string message;
+                message.reserve(160);
+                message += "{\"type\":\"l2update\",\"product_id\":\"" + product.product_id + "\",\"changes\":" + changes +
+                           "],\"time\":\"" + time + "\"}";
+                out.push_back(std::move(message));
+                sequence_++;
+                added++;
+            }
+
+            if (product.ticker)
+            {
+                const auto &best_bid = *book.bids.begin();
+                const auto &best_ask = *book.asks.begin();
+
+                std::string message;
+                message.reserve(400);
+                message += "{\"type\":\"ticker\",\"sequence\":" + std::to_string(++sequence_) +
+                           ",\"product_id\":\"" + product.product_id + "\",\"price\":";
+                append_price(message, price);
+                message += ",\"open_24h\":";
+                append_price(message, book.open);
+                message += ",\"volume_24h\":";
+                append_size(message, book.volume);
+                message += ",\"low_24h\":";
+                append_price(message, book.low);
+                message += ",\"high_24h\":";
+                append_price(message, book.high);
+                message += ",\"volume_30d\":";
+                append_size(message, book.volume);
+                message += ",\"best_bid\":";
+                append_price(message, best_bid.first);
+                message += ",\"best_bid_size\":";
+                append_size(message, best_bid.second);
+                message += ",\"best_ask\":";
+                append_price(message, best_ask.first);
+                message += ",\"best_ask_size\":";
+                append_size(message, best_ask.second);
+                message += std::string(",\"side\":\"") + (buy ? "buy" : "sell") + "\",\"time\":\"" + time +
+                           "\",\"trade_id\":" + std::to_string(trade_id_) + ",\"last_size\":";
+                append_size(message, size);
+                message += '}';
+                out.push_back(std::move(message));
+                added++;
+            }
+
+            return added;
+        }
+
+        size_t FeedSession::generate_recorded(size_t count, std::vector<std::string> &out)
+        {
+            if (recording_->empty())
+                return 0;
+
+            // Cycle through the recording; stop after a full pass without a subscribed message
+            size_t added = 0;
+            size_t skipped = 0;
+            while (added < count && skipped < recording_->size())
+            {
+                const auto &message = (*recording_)[recording_cursor_];
+                recording_cursor_ = (recording_cursor_ + 1) % recording_->size();
+                if (is_subscribed(message.channel, message.product_id))
+                {
+                    out.push_back(message.text);
+                    added++;
+                    skipped = 0;
+                }
+                else
+                {
+                    skipped++;
+                }
+            }
+            return added;
+        }
+
+        void FeedSession::heartbeats(std::vector<std::string> &out)
+        {
+            auto it = subscriptions_.find(CHANNEL_HEARTBEAT);
+            if (it == subscriptions_.end())
+                return;
+
+            const char *time = timestamp();
+            for (const auto &product_id : it->second)
+            {
+                out.push_back("{\"type\":\"heartbeat\",\"sequence\":" + std::to_string(++sequence_) +
+                              ",\"last_trade_id\":" + std::to_string(trade_id_) +
+                              ",\"product_id\":\"" + product_id + "\",\"time\":\"" + time + "\"}");
+            }
+        }
+
+        int64_t FeedSession::random_size()
+        {
+            // 0.001 to 5 units, in satoshis
+            return 100000 + static_cast<int64_t>(rng_() % 500000000);
+        }
+
+        const char *FeedSession::timestamp()
+        {
+            auto now = std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                           .count();
+            int64_t second = now / 1000000;
+            if (second != time_second_)
+            {
+                std::time_t seconds = static_cast<std::time_t>(second);
+                std::tm utc{};
+                gmtime_r(&seconds, &utc);
+                std::strftime(time_prefix_, sizeof(time_prefix_), "%Y-%m-%dT%H:%M:%S", &utc);
+                time_second_ = second;
+            }
+            std::snprintf(time_buffer_, sizeof(time_buffer_), "%s.%06lldZ", time_prefix_,
+                          static_cast<long long>(now % 1000000));
+            return time_buffer_;
+        }
+
+        bool FeedSession::load_recording(const std::string &path, Recording &recording)
+        {
+            std::ifstream file(path);
+            if (!file)
+            {
+                util::simple_log("[SIMULATOR] Cannot open recording: " + path);
+                return false;
+            }
+
+            std::string line;
+            while (std::getline(file, line))
+            {
+                if (line.empty())
+                    continue;
+
+                // Raw captures (SSLWebSocketClient::start_capture) prefix each payload with "<time_us>\t"
+                size_t tab = line.find('\t');
+                if (tab != std::string::npos && line[0] != '{')
+                    line.erase(0, tab + 1);
+
+                try
+                {
+                    auto json = nlohmann::json::parse(line);
+                    std::string type = json.value("type", "");
+                    std::string channel;
+                    if (type == "ticker")
+                        channel = CHANNEL_TICKER;
+                    else if (type == "match" || type == "last_match")
+                        channel = CHANNEL_MATCHES;
+                    else if (type == "snapshot" || type == "l2update")
+                        channel = CHANNEL_LEVEL2;
+                    else
+                        continue; // Heartbeats, subscriptions and errors are produced live
+
+                    if (!json.contains("product_id"))
+                        continue;
+                    recording.push_back({channel, json["product_id"].get<std::string>(), line});
+                }
+                catch (const std::exception &)
+                {
+                    // Skip lines that are not JSON objects
+                }
+            }
+
+            util::simple_log("[SIMULATOR] Loaded " + std::to_string(recording.size()) + " recorded messages from " + path);
+            return !recording.empty();
+        }
+
+        // ========================================================================
+        // CoinbaseSimulator
+        // ========================================================================
+
+        struct CoinbaseSimulator::Connection
+        {
+            int fd = -1;
+            SSL *ssl = nullptr;
+            std::thread thread;
+            std::atomic<bool> done{false};
+
+            std::string read_buffer;
+            std::string write_buffer;
+
+            bool deflate = false;
+            bool context_takeover = false;
+            z_stream deflater{};
+            std::string compressed;
+        };
+
+        CoinbaseSimulator::CoinbaseSimulator(const SimulatorConfig &config)
+            : config_(config)
+        {
+        }
+
+        CoinbaseSimulator::~CoinbaseSimulator()
+        {
+            stop();
+            if (ssl_ctx_)
+                SSL_CTX_free(static_cast<SSL_CTX *>(ssl_ctx_));
+        }
+
+        bool CoinbaseSimulator::init_ssl()
+        {
+            if (ssl_ctx_)
+                return true;
+
+            SSL_CTX *ctx = SSL_CTX_new(TLS_server_method());
+            if (!ctx)
+            {
+                util::simple_log("[SIMULATOR] Failed to create SSL context");
+                return false;
+            }
+
+            bool loaded = false;
+            if (!config_.certificate_file.empty())
+            {
+                std::string key_file = config_.private_key_file.empty() ? config_.certificate_file : config_.private_key_file;
+                loaded = SSL_CTX_use_certificate_chain_file(ctx, config_.certificate_file.c_str()) == 1 &&
+                         SSL_CTX_use_PrivateKey_file(ctx, key_file.c_str(), SSL_FILETYPE_PEM) == 1;
+            }
+            else
+            {
+                // Self-signed P-256 certificate for localhost; clients under test skip verification
+                EVP_PKEY *key = nullptr;
+                EVP_PKEY_CTX *key_ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+                X509 *cert = X509_new();
+                if (key_ctx && cert &&
+                    EVP_PKEY_keygen_init(key_ctx) == 1 &&
+                    EVP_PKEY_CTX_set_ec_paramgen_curve_nid(key_ctx, NID_X9_62_prime256v1) == 1 &&
+                    EVP_PKEY_keygen(key_ctx, &key) == 1)
+                {
+                    X509_set_version(cert, 2);
+                    ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+                    X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+                    X509_gmtime_adj(X509_getm_notAfter(cert), 365L * 24 * 3600);
+                    X509_set_pubkey(cert, key);
+                    X509_NAME *name = X509_get_subject_name(cert);
+                    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                                               reinterpret_cast<const unsigned char *>("localhost"), -1, -1, 0);
+                    X509_set_issuer_name(cert, name);
+                    loaded = X509_sign(cert, key, EVP_sha256()) > 0 &&
+                             SSL_CTX_use_certificate(ctx, cert) == 1 &&
+                             SSL_CTX_use_PrivateKey(ctx, key) == 1;
+                }
+                X509_free(cert);
+                EVP_PKEY_free(key);
+                EVP_PKEY_CTX_free(key_ctx);
+            }
+
+            if (!loaded)
+            {
+                char error[256];
+                ERR_error_string_n(ERR_get_error(), error, sizeof(error));
+                util::simple_log("[SIMULATOR] Failed to load TLS certificate: " + std::string(error));
+                SSL_CTX_free(ctx);
+                return false;
+            }
+
+            ssl_ctx_ = ctx;
+            return true;
+        }
+
+        bool CoinbaseSimulator::start()
+        {
+            if (running_)
+                return true;
+
+            if (!config_.recording_file.empty())
+            {
+                auto recording = std::make_shared<Recording>();
+                if (!FeedSession::load_recording(config_.recording_file, *recording))
+                    return false;
+                recording_ = recording;
+            }
+
+            if (!init_ssl())
+                return false;
+
+            // A client vanishing mid-write must not kill the process
+            std::signal(SIGPIPE, SIG_IGN);
+
+            listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+            if (listen_fd_ < 0)
+            {
+                util::simple_log("[SIMULATOR] Failed to create listen socket");
+                return false;
+            }
+
+            int reuse = 1;
+            setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(config_.port);
+            if (inet_pton(AF_INET, config_.bind_address.c_str(), &address.sin_addr) != 1 ||
+                bind(listen_fd_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+                listen(listen_fd_, 128) != 0)
+            {
+                util::simple_log("[SIMULATOR] Failed to listen on " + config_.bind_address + ":" + std::to_string(config_.port));
+                close(listen_fd_);
+                listen_fd_ = -1;
+                return false;
+            }
+
+            socklen_t length = sizeof(address);
+            getsockname(listen_fd_, reinterpret_cast<sockaddr *>(&address), &length);
+            port_ = ntohs(address.sin_port);
+
+            running_ = true;
+            accept_thread_ = std::thread(&CoinbaseSimulator::accept_loop, this);
+
+            util::simple_log("[SIMULATOR] Listening on wss://" + config_.bind_address + ":" + std::to_string(port_) +
+                             (recording_ ? " replaying " + config_.recording_file : " with synthetic data") +
+                             " at " + std::to_string(config_.messages_per_second) + " msg/s per connection");
+            return true;
+        }
+
+        void CoinbaseSimulator::stop()
+        {
+            if (!running_.exchange(false))
+                return;
+
+            if (accept_thread_.joinable())
+                accept_thread_.join();
+            close(listen_fd_);
+            listen_fd_ = -1;
+
+            // Unblock connection threads stuck in SSL_read/SSL_write before joining them
+            {
+                std::lock_guard<std::mutex> lock(connections_mutex_);
+                for (auto &connection : connections_)
+                    shutdown(connection->fd, SHUT_RDWR);
+            }
+            reap_connections(true);
+
+            util::simple_log("[SIMULATOR] Stopped after " + std::to_string(messages_sent_.load()) + " messages");
+        }
+
+        SimulatorStats CoinbaseSimulator::get_stats() const
+        {
+            SimulatorStats stats;
+            stats.connections = total_connections_.load();
+            stats.active_connections = active_connections_.load();
+            stats.messages_sent = messages_sent_.load();
+            stats.bytes_sent = bytes_sent_.load();
+            return stats;
+        }
+
+        size_t CoinbaseSimulator::drop_connections()
+        {
+            // No close frame: the client only sees the socket end
+            size_t dropped = 0;
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            for (auto &connection : connections_)
+            {
+                if (connection->done.load())
+                    continue;
+                shutdown(connection->fd, SHUT_RDWR);
+                dropped++;
+            }
+            return dropped;
+        }
+
+        void CoinbaseSimulator::accept_loop()
+        {
+            while (running_)
+            {
+                pollfd listener{listen_fd_, POLLIN, 0};
+                if (poll(&listener, 1, 100) <= 0)
+                {
+                    reap_connections(false);
+                    continue;
+                }
+
+                int fd = accept(listen_fd_, nullptr, nullptr);
+                if (fd < 0)
+                    continue;
+
+                int no_delay = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+
+                auto connection = std::make_shared<Connection>();
+                connection->fd = fd;
+                total_connections_++;
+
+                std::lock_guard<std::mutex> lock(connections_mutex_);
+                connections_.push_back(connection);
+                connection->thread = std::thread(&CoinbaseSimulator::connection_loop, this, connection);
+            }
+        }
+
+        void CoinbaseSimulator::reap_connections(bool all)
+        {
+            std::vector<std::shared_ptr<Connection>> finished;
+            {
+                std::lock_guard<std::mutex> lock(connections_mutex_);
+                auto split = std::stable_partition(connections_.begin(), connections_.end(), [all](const auto &connection)
+                                                   { return !all && !connection->done.load(); });
+                finished.assign(split, connections_.end());
+                connections_.erase(split, connections_.end());
+            }
+
+            for (auto &connection : finished)
+            {
+                if (connection->thread.joinable())
+                    connection->thread.join();
+                if (connection->ssl)
+                    SSL_free(connection->ssl);
+                if (connection->deflate)
+                    deflateEnd(&connection->deflater);
+                close(connection->fd);
+            }
+        }
+
+        void CoinbaseSimulator::connection_loop(std::shared_ptr<Connection> connection)
+        {
+            active_connections_++;
+            Connection &conn = *connection;
+
+            conn.ssl = SSL_new(static_cast<SSL_CTX *>(ssl_ctx_));
+            SSL_set_fd(conn.ssl, conn.fd);
+
+            if (SSL_accept(conn.ssl) == 1 && websocket_handshake(conn))
+            {
+                FeedSession session(config_, recording_);
+                std::vector<std::string> messages;
+                messages.reserve(MAX_BATCH + 4);
+
+                const uint64_t rate = config_.messages_per_second;
+                const auto heartbeat_interval = std::chrono::milliseconds(config_.heartbeat_interval_ms);
+                auto next_heartbeat = std::chrono::steady_clock::now() + heartbeat_interval;
+                auto pacing_start = std::chrono::steady_clock::now();
+                uint64_t generated = 0;
+                bool pacing = false;
+
+                while (running_)
+                {
+                    // Wait for client frames, or at most until more market data is due
+                    bool streaming = session.has_data_subscriptions();
+                    bool readable = SSL_pending(conn.ssl) > 0;
+                    if (!readable)
+                    {
+                        pollfd client{conn.fd, POLLIN, 0};
+                        int ready = poll(&client, 1, streaming ? (rate == 0 ? 0 : 1) : 50);
+                        if (ready < 0)
+                            break;
+                        readable = ready > 0;
+                    }
+
+                    if (readable && !read_frames(conn, session, messages))
+                        break;
+                    if (!messages.empty())
+                    {
+                        if (!send_messages(conn, messages))
+                            break;
+                        messages.clear();
+                    }
+
+                    auto now = std::chrono::steady_clock::now();
+                    if (session.has_data_subscriptions())
+                    {
+                        if (!pacing)
+                        {
+                            pacing = true;
+                            pacing_start = now;
+                            generated = 0;
+                        }
+
+                        size_t due = MAX_BATCH;
+                        if (rate > 0)
+                        {
+                            auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - pacing_start).count();
+                            uint64_t target = static_cast<uint64_t>(elapsed) * rate / 1000000;
+
+                            // A slow reader drops at most one second of backlog instead of bursting it later
+                            if (target > generated + rate)
+                                generated = target - rate;
+                            due = target > generated ? std::min<uint64_t>(target - generated, MAX_BATCH) : 0;
+                        }
+
+                        if (due > 0)
+                        {
+                            generated += session.generate(due, messages);
+                            if (!send_messages(conn, messages))
+                                break;
+                            messages.clear();
+                        }
+                    }
+                    else
+                    {
+                        pacing = false;
+                    }
+
+                    if (now >= next_heartbeat)
+                    {
+                        next_heartbeat = now + heartbeat_interval;
+                        session.heartbeats(messages);
+                        if (!send_messages(conn, messages))
+                            break;
+                        messages.clear();
+                    }
+                }
+            }
+
+            active_connections_--;
+            conn.done = true;
+        }
+
+        bool CoinbaseSimulator::websocket_handshake(Connection &connection)
+        {
+            std::string request;
+            char buffer[4096];
+            size_t header_end;
+            while ((header_end = request.find("\r\n\r\n")) == std::string::npos)
+            {
+                int received = SSL_read(connection.ssl, buffer, sizeof(buffer));
+                if (received <= 0 || request.size() > MAX_HANDSHAKE)
+                    return false;
+                request.append(buffer, received);
+            }
+            connection.read_buffer = request.substr(header_end + 4);
+
+            std::string key;
+            bool offers_deflate = false;
+            bool refuses_takeover = false;
+            size_t line_start = request.find("\r\n") + 2;
+            while (line_start < header_end)
+            {
+                size_t line_end = request.find("\r\n", line_start);
+                std::string line = request.substr(line_start, line_end - line_start);
+                line_start = line_end + 2;
+
+                size_t colon = line.find(':');
+                if (colon == std::string::npos)
+                    continue;
+                size_t value_start = line.find_first_not_of(' ', colon + 1);
+                std::string name = lowercase(line.substr(0, colon));
+                std::string value = value_start == std::string::npos ? "" : line.substr(value_start);
+                if (name == "sec-websocket-key")
+                    key = value;
+                else if (name == "sec-websocket-extensions")
+                {
+                    offers_deflate = offers_deflate || value.find("permessage-deflate") != std::string::npos;
+                    refuses_takeover = refuses_takeover || value.find("server_no_context_takeover") != std::string::npos;
+                }
+            }
+
+            if (key.empty())
+            {
+                const char *reject = "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n\r\n";
+                SSL_write(connection.ssl, reject, static_cast<int>(std::strlen(reject)));
+                return false;
+            }
+
+            unsigned char digest[SHA_DIGEST_LENGTH];
+            std::string accept_source = key + WEBSOCKET_GUID;
+            SHA1(reinterpret_cast<const unsigned char *>(accept_source.data()), accept_source.size(), digest);
+            unsigned char accept[64];
+            int accept_length = EVP_EncodeBlock(accept, digest, SHA_DIGEST_LENGTH);
+
+            // The client compares "Connection: upgrade" literally
+            std::string response = "HTTP/1.1 101 Switching Protocols\r\n"
+                                   "Upgrade: websocket\r\n"
+                                   "Connection: upgrade\r\n"
+                                   "Sec-WebSocket-Accept: " +
+                                   std::string(reinterpret_cast<char *>(accept), accept_length) + "\r\n";
+
+            // With context takeover one compressor runs for the whole connection, like Coinbase's;
+            // without it every message is compressed on its own
+            if (config_.enable_deflate && offers_deflate)
+            {
+                connection.deflate = deflateInit2(&connection.deflater, Z_BEST_SPEED, Z_DEFLATED,
+                                                  -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+                connection.context_takeover = config_.deflate_context_takeover && !refuses_takeover;
+                if (connection.deflate)
+                    response += std::string("Sec-WebSocket-Extensions: permessage-deflate") +
+                                (connection.context_takeover ? "" : "; server_no_context_takeover") +
+                                "; client_no_context_takeover\r\n";
+            }
+            response += "\r\n";
+
+            return SSL_write(connection.ssl, response.data(), static_cast<int>(response.size())) == static_cast<int>(response.size());
+        }
+
+        bool CoinbaseSimulator::read_frames(Connection &connection, FeedSession &session, std::vector<std::string> &replies)
+        {
+            char buffer[16384];
+            int received = SSL_read(connection.ssl, buffer, sizeof(buffer));
+            if (received <= 0)
+                return false;
+            connection.read_buffer.append(buffer, received);
+
+            auto &data = connection.read_buffer;
+            size_t offset = 0;
+            while (data.size() - offset >= 2)
+            {
+                const auto *bytes = reinterpret_cast<const uint8_t *>(data.data() + offset);
+                uint8_t opcode = bytes[0] & 0x0F;
+                bool masked = (bytes[1] & 0x80) != 0;
+                uint64_t length = bytes[1] & 0x7F;
+                size_t header = 2;
+
+                if (length == 126)
+                {
+                    if (data.size() - offset < 4)
+                        break;
+                    length = (static_cast<uint64_t>(bytes[2]) << 8) | bytes[3];
+                    header = 4;
+                }
+                else if (length == 127)
+                {
+                    if (data.size() - offset < 10)
+                        break;
+                    length = 0;
+                    for (int i = 0; i < 8; ++i)
+                        length = (length << 8) | bytes[2 + i];
+                    header = 10;
+                }
+
+                size_t mask_offset = header;
+                if (masked)
+                    header += 4;
+                if (data.size() - offset < header + length)
+                    break;
+
+                std::string payload = data.substr(offset + header, length);
+                if (masked)
+                {
+                    for (size_t i = 0; i < payload.size(); ++i)
+                        payload[i] ^= bytes[mask_offset + (i % 4)];
+                }
+                offset += header + length;
+
+                switch (opcode)
+                {
+                case 0x1: // Text
+                    session.handle_message(payload, replies);
+                    break;
+                case 0x8: // Close: echo the status code and end the connection
+                    send_frame(connection, 0x8, payload.substr(0, 2));
+                    return false;
+                case 0x9: // Ping
+                    if (!send_frame(connection, 0xA, payload))
+                        return false;
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            data.erase(0, offset);
+            return true;
+        }
+
+        void CoinbaseSimulator::append_frame(std::string &buffer, uint8_t first_byte, const char *payload, size_t length)
+        {
+            // Server frames are never masked
+            buffer += static_cast<char>(first_byte);
+            if (length < 126)
+            {
+                buffer += static_cast<char>(length);
+            }
+            else if (length < 65536)
+            {
+                buffer += static_cast<char>(126);
+                buffer += static_cast<char>((length >> 8) & 0xFF);
+                buffer += static_cast<char>(length & 0xFF);
+            }
+            else
+            {
+                buffer += static_cast<char>(127);
+                for (int i = 7; i >= 0; --i)
+                    buffer += static_cast<char>((static_cast<uint64_t>(length) >> (i * 8)) & 0xFF);
+            }
+            buffer.append(payload, length);
+        }
+
+        bool CoinbaseSimulator::send_frame(Connection &connection, uint8_t opcode, const std::string &payload)
+        {
+            std::string frame;
+            append_frame(frame, 0x80 | opcode, payload.data(), payload.size());
+            return SSL_write(connection.ssl, frame.data(), static_cast<int>(frame.size())) == static_cast<int>(frame.size());
+        }
+
+        bool CoinbaseSimulator::send_messages(Connection &connection, const std::vector<std::string> &messages)
+        {
+            auto flush = [&connection, this]()
+            {
+                const std::string &buffer = connection.write_buffer;
+                size_t written = 0;
+                while (written < buffer.size())
+                {
+                    int sent = SSL_write(connection.ssl, buffer.data() + written, static_cast<int>(buffer.size() - written));
+                    if (sent <= 0)
+                        return false;
+                    written += sent;
+                }
+                bytes_sent_ += buffer.size();
+                connection.write_buffer.clear();
+                return true;
+            };
+
+            for (const auto &message : messages)
+            {
+                if (connection.deflate)
+                {
+                    // Raw deflate with a sync flush; the trailing 00 00 ff ff is implied by the extension
+                    z_stream &stream = connection.deflater;
+                    if (!connection.context_takeover)
+                        deflateReset(&stream);
+                    connection.compressed.resize(deflateBound(&stream, message.size()) + 16);
+                    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(message.data()));
+                    stream.avail_in = static_cast<uInt>(message.size());
+                    stream.next_out = reinterpret_cast<Bytef *>(&connection.compressed[0]);
+                    stream.avail_out = static_cast<uInt>(connection.compressed.size());
+                    deflate(&stream, Z_SYNC_FLUSH);
+
+                    size_t length = connection.compressed.size() - stream.avail_out;
+                    if (length >= 4 && std::memcmp(connection.compressed.data() + length - 4, "\x00\x00\xff\xff", 4) == 0)
+                        length -= 4;
+                    append_frame(connection.write_buffer, 0xC1, connection.compressed.data(), length);
+                }
+                else
+                {
+                    append_frame(connection.write_buffer, 0x81, message.data(), message.size());
+                }
+
+                if (connection.write_buffer.size() >= WRITE_CHUNK && !flush())
+                    return false;
+            }
+
+            messages_sent_ += messages.size();
+            return flush();
+        }
+
+    } // namespace simulator
+} // namespace open_dtc_server
@@ -0,0 +1,134 @@
+#include "coinbase_simulator/coinbase_simulator.hpp"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <signal.h>
+
+static std::atomic<bool> g_running{true};
+
+void signal_handler(int)
+{
+    g_running = false;
+}
+
+int main(int argc, char *argv[])
+{
+    using namespace open_dtc_server::simulator;
+
+    SimulatorConfig config;
+    int duration_seconds = 0; // 0 = until interrupted
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--port" && i + 1 < argc)
+        {
+            config.port = static_cast<uint16_t>(std::stoi(argv[++i]));
+        }
+        else if (arg == "--bind" && i + 1 < argc)
+        {
+            config.bind_address = argv[++i];
+        }
+        else if (arg == "--cert" && i + 1 < argc)
+        {
+            config.certificate_file = argv[++i];
+        }
+        else if (arg == "--key" && i + 1 < argc)
+        {
+            config.private_key_file = argv[++i];
+        }
+        else if (arg == "--products" && i + 1 < argc)
+        {
+            config.products.clear();
+            std::stringstream products(argv[++i]);
+            std::string product;
+            while (std::getline(products, product, ','))
+            {
+                if (!product.empty())
+                    config.products.push_back(product);
+            }
+        }
+        else if (arg == "--rate" && i + 1 < argc)
+        {
+            config.messages_per_second = std::stoull(argv[++i]);
+        }
+        else if (arg == "--record" && i + 1 < argc)
+        {
+            config.recording_file = argv[++i];
+        }
+        else if (arg == "--no-deflate")
+        {
+            config.enable_deflate = false;
+        }
+        else if (arg == "--no-context-takeover")
+        {
+            config.deflate_context_takeover = false;
+        }
+        else if (arg == "--heartbeat-ms" && i + 1 < argc)
+        {
+            config.heartbeat_interval_ms = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--depth" && i + 1 < argc)
+        {
+            config.book_depth = std::stoul(argv[++i]);
+        }
+        else if (arg == "--duration" && i + 1 < argc)
+        {
+            duration_seconds = std::stoi(argv[++i]);
+        }
+        else if (arg == "--help" || arg == "-h")
+        {
+            std::cout << "Usage: " << argv[0] << " [options]\n";
+            std::cout << "Options:\n";
+            std::cout << "  --port <n>               Listen port (default: 8443, 0 = ephemeral)\n";
+            std::cout << "  --bind <address>         Bind address (default: 127.0.0.1)\n";
+            std::cout << "  --cert <path>            PEM certificate (default: generated self-signed)\n";
+            std::cout << "  --key <path>             PEM private key (default: same file as --cert)\n";
+            std::cout << "  --products <a,b,...>     Products accepted by subscribe (default: BTC-USD,ETH-USD,SOL-USD)\n";
+            std::cout << "  --rate <n>               Messages per second per connection, 0 = unthrottled (default: 1000)\n";
+            std::cout << "  --record <path>          Replay recorded feed messages (JSON lines or a raw capture) instead of synthetic data\n";
+            std::cout << "  --no-deflate             Do not negotiate permessage-deflate\n";
+            std::cout << "  --no-context-takeover    Compress every message on its own (server_no_context_takeover)\n";
+            std::cout << "  --heartbeat-ms <n>       Heartbeat channel interval (default: 1000)\n";
+            std::cout << "  --depth <n>              Synthetic book levels per side (default: 50)\n";
+            std::cout << "  --duration <seconds>     Exit after this many seconds (default: run until interrupted)\n";
+            std::cout << "  --help, -h               Show this help message\n";
+            std::cout << "\nPoint the DTC server at it with websocket_url = wss://127.0.0.1:<port>\n";
+            return 0;
+        }
+    }
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+
+    CoinbaseSimulator simulator(config);
+    if (!simulator.start())
+    {
+        std::cerr << "Failed to start simulator" << std::endl;
+        return 1;
+    }
+
+    // Print per-second throughput until interrupted or the duration elapses
+    auto start = std::chrono::steady_clock::now();
+    SimulatorStats last;
+    while (g_running)
+    {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        SimulatorStats stats = simulator.get_stats();
+        std::cout << "[SIMULATOR] connections: " << stats.active_connections
+                  << ", msg/s: " << (stats.messages_sent - last.messages_sent)
+                  << ", KB/s: " << (stats.bytes_sent - last.bytes_sent) / 1024
+                  << ", total messages: " << stats.messages_sent << std::endl;
+        last = stats;
+
+        if (duration_seconds > 0 &&
+            std::chrono::steady_clock::now() - start >= std::chrono::seconds(duration_seconds))
+            break;
+    }
+
+    simulator.stop();
+    return 0;
+}
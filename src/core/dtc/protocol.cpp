@@ -1,4 +1,5 @@
 #include "coinbase_dtc_core/core/dtc/protocol.hpp"
+#include <algorithm>
 #include <cstring>
 #include <cstdio>
 #include <chrono>
@@ -716,6 +717,15 @@ namespace open_dtc_server
                     }
                     break;
                 }
+                case MessageType::MARKET_DATA_FEED_STATUS:
+                {
+                    auto msg = std::make_unique<MarketDataFeedStatus>();
+                    if (msg->deserialize(data, header->size))
+                    {
+                        return std::move(msg);
+                    }
+                    break;
+                }
                 case MessageType::MARKET_DATA_REQUEST:
                 {
                     auto msg = std::make_unique<MarketDataRequest>();
@@ -752,6 +762,15 @@ namespace open_dtc_server
                     }
                     break;
                 }
+                case MessageType::MARKET_DEPTH_SNAPSHOT:
+                {
+                    auto msg = std::make_unique<MarketDepthSnapshot>();
+                    if (msg->deserialize(data, header->size))
+                    {
+                        return std::move(msg);
+                    }
+                    break;
+                }
                 case MessageType::MARKET_DEPTH_INCREMENTAL_UPDATE:
                 {
                     auto msg = std::make_unique<MarketDepthIncrementalUpdate>();
@@ -761,6 +780,87 @@ namespace open_dtc_server
                     }
                     break;
                 }
+                case MessageType::MARKET_DATA_SNAPSHOT:
+                {
+                    auto msg = std::make_unique<MarketDataSnapshot>();
+                    if (msg->deserialize(data, header->size))
+                    {
+                        return std::move(msg);
+                    }
+                    break;
+                }
+                case MessageType::MARKET_DATA_UPDATE_SESSION_OPEN:
+                {
+                    auto msg = std::make_unique<MarketDataUpdateSessionOpen>();
+                    if (msg->deserialize(data, header->size))
+                    {
+                        return std::move(msg);
+                    }
+                    break;
+                }
+                case MessageType::MARKET_DATA_UPDATE_SESSION_HIGH:
+                {
+                    auto msg = std::make_unique<MarketDataUpdateSessionHigh>();
+                    if (msg->deserialize(data, header->size))
+                    {
+                        return std::move(msg);
+                    }
+                    break;
+                }
+                case MessageType::MARKET_DATA_UPDATE_SESSION_LOW:
+                {
+                    auto msg = std::make_unique<MarketDataUpdateSessionLow>();
+                    if (msg->deserialize(data, header->size))
+                    {
+                        return std::move(msg);
+                    }
+                    break;
+                }
+                case MessageType::MARKET_DATA_UPDATE_SESSION_VOLUME:
+                {
+                    auto msg = std::make_unique<MarketDataUpdateSessionVolume>();
+                    if (msg->deserialize(data, header->size))
+                    {
+                        return std::move(msg);
+                    }
+                    break;
+                }
+                case MessageType::SUBMIT_NEW_SINGLE_ORDER:
+                {
+                    auto msg = std::make_unique<SubmitNewSingleOrder>();
+                    if (msg->deserialize(data, header->size))
+                    {
+                        return std::move(msg);
+                    }
+                    break;
+                }
+                case MessageType::ORDER_UPDATE:
+                {
+                    auto msg = std::make_unique<OrderUpdate>();
+                    if (msg->deserialize(data, header->size))
+                    {
+                        return std::move(msg);
+                    }
+                    break;
+                }
+                case MessageType::OPEN_ORDERS_REQUEST:
+                {
+                    auto msg = std::make_unique<OpenOrdersRequest>();
+                    if (msg->deserialize(data, header->size))
+                    {
+                        return std::move(msg);
+                    }
+                    break;
+                }
+                case MessageType::OPEN_ORDERS_REJECT:
+                {
+                    auto msg = std::make_unique<OpenOrdersReject>();
+                    if (msg->deserialize(data, header->size))
+                    {
+                        return std::move(msg);
+                    }
+                    break;
+                }
                 case MessageType::POSITION_UPDATE:
                 {
                     auto msg = std::make_unique<PositionUpdate>();
@@ -788,6 +888,51 @@ namespace open_dtc_server
                     }
                     break;
                 }
+                case MessageType::HISTORICAL_PRICE_DATA_REQUEST:
+                {
+                    auto msg = std::make_unique<HistoricalPriceDataRequest>();
+                    if (msg->deserialize(data, header->size))
+                    {
+                        return std::move(msg);
+                    }
+                    break;
+                }
+                case MessageType::HISTORICAL_PRICE_DATA_RESPONSE_HEADER:
+                {
+                    auto msg = std::make_unique<HistoricalPriceDataResponseHeader>();
+                    if (msg->deserialize(data, header->size))
+                    {
+                        return std::move(msg);
+                    }
+                    break;
+                }
+                case MessageType::HISTORICAL_PRICE_DATA_REJECT:
+                {
+                    auto msg = std::make_unique<HistoricalPriceDataReject>();
+                    if (msg->deserialize(data, header->size))
+                    {
+                        return std::move(msg);
+                    }
+                    break;
+                }
+                case MessageType::HISTORICAL_PRICE_DATA_RECORD_RESPONSE:
+                {
+                    auto msg = std::make_unique<HistoricalPriceDataRecordResponse>();
+                    if (msg->deserialize(data, header->size))
+                    {
+                        return std::move(msg);
+                    }
+                    break;
+                }
+                case MessageType::HISTORICAL_PRICE_DATA_TICK_RECORD_RESPONSE:
+                {
+                    auto msg = std::make_unique<HistoricalPriceDataTickRecordResponse>();
+                    if (msg->deserialize(data, header->size))
+                    {
+                        return std::move(msg);
+                    }
+                    break;
+                }
                 default:
                     return nullptr;
                 }
@@ -859,6 +1004,13 @@ namespace open_dtc_server
                 return static_cast<uint64_t>(time_t);
             }
 
+            uint64_t Protocol::get_current_timestamp_us()
+            {
+                return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                                 std::chrono::system_clock::now().time_since_epoch())
+                                                 .count());
+            }
+
             MessageType Protocol::get_message_type(const uint8_t *data, uint16_t size)
             {
                 if (!data || size < sizeof(MessageHeader))
@@ -886,6 +1038,25 @@ namespace open_dtc_server
                 return message.serialize();
             }
 
+            std::string Protocol::read_dtc_string(const uint8_t *data, uint16_t &offset, uint16_t max_size)
+            {
+                // Null-terminated, as written by the message serializers; offset moves past the terminator
+                if (!data || offset >= max_size)
+                    return std::string();
+
+                const char *start = reinterpret_cast<const char *>(data + offset);
+                size_t length = strnlen(start, max_size - offset);
+                std::string value(start, length);
+                offset = static_cast<uint16_t>(std::min<size_t>(max_size, offset + length + 1));
+                return value;
+            }
+
+            void Protocol::write_dtc_string(std::vector<uint8_t> &buffer, const std::string &str)
+            {
+                buffer.insert(buffer.end(), str.begin(), str.end());
+                buffer.push_back(0);
+            }
+
             std::unique_ptr<Heartbeat> Protocol::create_heartbeat(uint32_t num_drops)
             {
                 auto heartbeat = std::make_unique<Heartbeat>();
@@ -894,6 +1065,14 @@ namespace open_dtc_server
                 return heartbeat;
             }
 
+            std::unique_ptr<MarketDataFeedStatus> Protocol::create_market_data_feed_status(bool available)
+            {
+                auto status = std::make_unique<MarketDataFeedStatus>();
+                status->status = available ? MarketDataFeedStatusEnum::MARKET_DATA_FEED_AVAILABLE
+                                           : MarketDataFeedStatusEnum::MARKET_DATA_FEED_UNAVAILABLE;
+                return status;
+            }
+
             std::unique_ptr<SecurityDefinitionResponse> Protocol::create_security_definition_response(
                 uint32_t request_id, const std::string &symbol, const std::string &exchange)
             {
@@ -923,6 +1102,8 @@ namespace open_dtc_server
                     return "HEARTBEAT";
                 case MessageType::LOGOFF:
                     return "LOGOFF";
+                case MessageType::MARKET_DATA_FEED_STATUS:
+                    return "MARKET_DATA_FEED_STATUS";
                 case MessageType::MARKET_DATA_REQUEST:
                     return "MARKET_DATA_REQUEST";
                 case MessageType::MARKET_DATA_RESPONSE:
@@ -933,12 +1114,44 @@ namespace open_dtc_server
                     return "MARKET_DATA_UPDATE_TRADE";
                 case MessageType::MARKET_DATA_UPDATE_BID_ASK:
                     return "MARKET_DATA_UPDATE_BID_ASK";
+                case MessageType::MARKET_DEPTH_SNAPSHOT:
+                    return "MARKET_DEPTH_SNAPSHOT";
+                case MessageType::MARKET_DEPTH_INCREMENTAL_UPDATE:
+                    return "MARKET_DEPTH_INCREMENTAL_UPDATE";
+                case MessageType::MARKET_DATA_SNAPSHOT:
+                    return "MARKET_DATA_SNAPSHOT";
+                case MessageType::MARKET_DATA_UPDATE_SESSION_OPEN:
+                    return "MARKET_DATA_UPDATE_SESSION_OPEN";
+                case MessageType::MARKET_DATA_UPDATE_SESSION_HIGH:
+                    return "MARKET_DATA_UPDATE_SESSION_HIGH";
+                case MessageType::MARKET_DATA_UPDATE_SESSION_LOW:
+                    return "MARKET_DATA_UPDATE_SESSION_LOW";
+                case MessageType::MARKET_DATA_UPDATE_SESSION_VOLUME:
+                    return "MARKET_DATA_UPDATE_SESSION_VOLUME";
+                case MessageType::SUBMIT_NEW_SINGLE_ORDER:
+                    return "SUBMIT_NEW_SINGLE_ORDER";
+                case MessageType::ORDER_UPDATE:
+                    return "ORDER_UPDATE";
+                case MessageType::OPEN_ORDERS_REQUEST:
+                    return "OPEN_ORDERS_REQUEST";
+                case MessageType::OPEN_ORDERS_REJECT:
+                    return "OPEN_ORDERS_REJECT";
                 case MessageType::SECURITY_DEFINITION_FOR_SYMBOL_REQUEST:
                     return "SECURITY_DEFINITION_FOR_SYMBOL_REQUEST";
                 case MessageType::SECURITY_DEFINITION_RESPONSE:
                     return "SECURITY_DEFINITION_RESPONSE";
                 case MessageType::POSITION_UPDATE:
                     return "POSITION_UPDATE";
+                case MessageType::HISTORICAL_PRICE_DATA_REQUEST:
+                    return "HISTORICAL_PRICE_DATA_REQUEST";
+                case MessageType::HISTORICAL_PRICE_DATA_RESPONSE_HEADER:
+                    return "HISTORICAL_PRICE_DATA_RESPONSE_HEADER";
+                case MessageType::HISTORICAL_PRICE_DATA_REJECT:
+                    return "HISTORICAL_PRICE_DATA_REJECT";
+                case MessageType::HISTORICAL_PRICE_DATA_RECORD_RESPONSE:
+                    return "HISTORICAL_PRICE_DATA_RECORD_RESPONSE";
+                case MessageType::HISTORICAL_PRICE_DATA_TICK_RECORD_RESPONSE:
+                    return "HISTORICAL_PRICE_DATA_TICK_RECORD_RESPONSE";
                 default:
                     return "UNKNOWN_" + std::to_string(static_cast<uint16_t>(type));
                 }
@@ -1024,6 +1237,32 @@ namespace open_dtc_server
                 return true;
             }
 
+            // MarketDataFeedStatus implementation
+            uint16_t MarketDataFeedStatus::get_size() const
+            {
+                return sizeof(MessageHeader) + sizeof(int32_t);
+            }
+
+            std::vector<uint8_t> MarketDataFeedStatus::serialize() const
+            {
+                std::vector<uint8_t> buffer(get_size());
+                MessageHeader header(get_size(), get_type());
+                std::memcpy(buffer.data(), &header, sizeof(MessageHeader));
+                int32_t value = static_cast<int32_t>(status);
+                std::memcpy(buffer.data() + sizeof(MessageHeader), &value, sizeof(int32_t));
+                return buffer;
+            }
+
+            bool MarketDataFeedStatus::deserialize(const uint8_t *data, uint16_t size)
+            {
+                if (size < get_size())
+                    return false;
+                int32_t value = 0;
+                std::memcpy(&value, data + sizeof(MessageHeader), sizeof(int32_t));
+                status = static_cast<MarketDataFeedStatusEnum>(value);
+                return true;
+            }
+
             // MarketDataReject implementation
             uint16_t MarketDataReject::get_size() const
             {
@@ -1058,12 +1297,92 @@ namespace open_dtc_server
                 return true;
             }
 
+            // =====================
+            // MarketDepthSnapshot implementation
+            // =====================
+            uint16_t MarketDepthSnapshot::get_size() const
+            {
+                return sizeof(MessageHeader) + sizeof(uint16_t) + sizeof(uint8_t) + sizeof(uint16_t) + sizeof(double) + sizeof(double) +
+                       sizeof(uint8_t) + sizeof(uint8_t) + sizeof(uint64_t);
+            }
+
+            std::vector<uint8_t> MarketDepthSnapshot::serialize() const
+            {
+                uint16_t total_size = get_size();
+                std::vector<uint8_t> buffer(total_size);
+                size_t offset = 0;
+
+                MessageHeader header(total_size, get_type());
+                std::memcpy(buffer.data() + offset, &header, sizeof(MessageHeader));
+                offset += sizeof(MessageHeader);
+
+                std::memcpy(buffer.data() + offset, &symbol_id, sizeof(uint16_t));
+                offset += sizeof(uint16_t);
+
+                std::memcpy(buffer.data() + offset, &side, sizeof(uint8_t));
+                offset += sizeof(uint8_t);
+
+                std::memcpy(buffer.data() + offset, &level, sizeof(uint16_t));
+                offset += sizeof(uint16_t);
+
+                std::memcpy(buffer.data() + offset, &price, sizeof(double));
+                offset += sizeof(double);
+
+                std::memcpy(buffer.data() + offset, &quantity, sizeof(double));
+                offset += sizeof(double);
+
+                std::memcpy(buffer.data() + offset, &is_first_message_in_batch, sizeof(uint8_t));
+                offset += sizeof(uint8_t);
+
+                std::memcpy(buffer.data() + offset, &is_last_message_in_batch, sizeof(uint8_t));
+                offset += sizeof(uint8_t);
+
+                std::memcpy(buffer.data() + offset, &date_time, sizeof(uint64_t));
+                offset += sizeof(uint64_t);
+
+                return buffer;
+            }
+
+            bool MarketDepthSnapshot::deserialize(const uint8_t *data, uint16_t size)
+            {
+                if (!data || size < get_size())
+                    return false;
+
+                size_t offset = sizeof(MessageHeader);
+
+                std::memcpy(&symbol_id, data + offset, sizeof(uint16_t));
+                offset += sizeof(uint16_t);
+
+                std::memcpy(&side, data + offset, sizeof(uint8_t));
+                offset += sizeof(uint8_t);
+
+                std::memcpy(&level, data + offset, sizeof(uint16_t));
+                offset += sizeof(uint16_t);
+
+                std::memcpy(&price, data + offset, sizeof(double));
+                offset += sizeof(double);
+
+                std::memcpy(&quantity, data + offset, sizeof(double));
+                offset += sizeof(double);
+
+                std::memcpy(&is_first_message_in_batch, data + offset, sizeof(uint8_t));
+                offset += sizeof(uint8_t);
+
+                std::memcpy(&is_last_message_in_batch, data + offset, sizeof(uint8_t));
+                offset += sizeof(uint8_t);
+
+                std::memcpy(&date_time, data + offset, sizeof(uint64_t));
+                offset += sizeof(uint64_t);
+
+                return true;
+            }
+
             // =====================
             // MarketDepthIncrementalUpdate implementation
             // =====================
             uint16_t MarketDepthIncrementalUpdate::get_size() const
             {
-                return sizeof(MessageHeader) + sizeof(uint16_t) + sizeof(uint8_t) + sizeof(uint16_t) + sizeof(double) + sizeof(double) + sizeof(uint64_t);
+                return sizeof(MessageHeader) + sizeof(uint16_t) + sizeof(uint8_t) + sizeof(uint16_t) + sizeof(uint8_t) + sizeof(double) + sizeof(double) + sizeof(uint64_t);
             }
 
             std::vector<uint8_t> MarketDepthIncrementalUpdate::serialize() const
@@ -1085,6 +1404,9 @@ namespace open_dtc_server
                 std::memcpy(buffer.data() + offset, &position, sizeof(uint16_t));
                 offset += sizeof(uint16_t);
 
+                std::memcpy(buffer.data() + offset, &update_type, sizeof(uint8_t));
+                offset += sizeof(uint8_t);
+
                 std::memcpy(buffer.data() + offset, &price, sizeof(double));
                 offset += sizeof(double);
 
@@ -1097,9 +1419,9 @@ namespace open_dtc_server
                 return buffer;
             }
 
-            bool MarketDepthIncrementalUpdate::deserialize(const uint8_t *data, uint16_t size)
+            bool MarketDepthIncrementalUpdate::deserialize(const uint8_t *data, uint16_t message_size)
             {
-                if (!data || size < get_size())
+                if (!data || message_size < get_size())
                     return false;
 
                 size_t offset = sizeof(MessageHeader);
@@ -1113,9 +1435,13 @@ namespace open_dtc_server
                 std::memcpy(&position, data + offset, sizeof(uint16_t));
                 offset += sizeof(uint16_t);
 
+                std::memcpy(&update_type, data + offset, sizeof(uint8_t));
+                offset += sizeof(uint8_t);
+
                 std::memcpy(&price, data + offset, sizeof(double));
                 offset += sizeof(double);
 
+                // Parameter is named message_size so this writes the member, not the argument
                 std::memcpy(&size, data + offset, sizeof(double));
                 offset += sizeof(double);
 
@@ -1125,6 +1451,756 @@ namespace open_dtc_server
                 return true;
             }
 
+            // =====================
+            // MarketDataSnapshot implementation
+            // =====================
+            uint16_t MarketDataSnapshot::get_size() const
+            {
+                return sizeof(MessageHeader) + sizeof(uint16_t) + sizeof(double) * 4 + sizeof(uint32_t) +
+                       sizeof(double) * 6 + sizeof(uint64_t) + sizeof(uint64_t);
+            }
+
+            std::vector<uint8_t> MarketDataSnapshot::serialize() const
+            {
+                uint16_t total_size = get_size();
+                std::vector<uint8_t> buffer(total_size);
+                size_t offset = 0;
+
+                MessageHeader header(total_size, get_type());
+                std::memcpy(buffer.data() + offset, &header, sizeof(MessageHeader));
+                offset += sizeof(MessageHeader);
+
+                std::memcpy(buffer.data() + offset, &symbol_id, sizeof(uint16_t));
+                offset += sizeof(uint16_t);
+
+                for (const double *value : {&session_open_price, &session_high_price, &session_low_price, &session_volume})
+                {
+                    std::memcpy(buffer.data() + offset, value, sizeof(double));
+                    offset += sizeof(double);
+                }
+
+                std::memcpy(buffer.data() + offset, &session_num_trades, sizeof(uint32_t));
+                offset += sizeof(uint32_t);
+
+                for (const double *value : {&bid_price, &ask_price, &bid_quantity, &ask_quantity, &last_trade_price, &last_trade_volume})
+                {
+                    std::memcpy(buffer.data() + offset, value, sizeof(double));
+                    offset += sizeof(double);
+                }
+
+                std::memcpy(buffer.data() + offset, &last_trade_date_time, sizeof(uint64_t));
+                offset += sizeof(uint64_t);
+
+                std::memcpy(buffer.data() + offset, &trading_session_date, sizeof(uint64_t));
+                offset += sizeof(uint64_t);
+
+                return buffer;
+            }
+
+            bool MarketDataSnapshot::deserialize(const uint8_t *data, uint16_t size)
+            {
+                if (!data || size < get_size())
+                    return false;
+
+                size_t offset = sizeof(MessageHeader);
+
+                std::memcpy(&symbol_id, data + offset, sizeof(uint16_t));
+                offset += sizeof(uint16_t);
+
+                for (double *value : {&session_open_price, &session_high_price, &session_low_price, &session_volume})
+                {
+                    std::memcpy(value, data + offset, sizeof(double));
+                    offset += sizeof(double);
+                }
+
+                std::memcpy(&session_num_trades, data + offset, sizeof(uint32_t));
+                offset += sizeof(uint32_t);
+
+                for (double *value : {&bid_price, &ask_price, &bid_quantity, &ask_quantity, &last_trade_price, &last_trade_volume})
+                {
+                    std::memcpy(value, data + offset, sizeof(double));
+                    offset += sizeof(double);
+                }
+
+                std::memcpy(&last_trade_date_time, data + offset, sizeof(uint64_t));
+                offset += sizeof(uint64_t);
+
+                std::memcpy(&trading_session_date, data + offset, sizeof(uint64_t));
+                offset += sizeof(uint64_t);
+
+                return true;
+            }
+
+            // =====================
+            // Session update implementations
+            // Open/High/Low/Volume share one layout: symbol_id, value, trading_session_date
+            // =====================
+            namespace
+            {
+                constexpr uint16_t SESSION_UPDATE_SIZE = sizeof(MessageHeader) + sizeof(uint16_t) + sizeof(double) + sizeof(uint64_t);
+
+                std::vector<uint8_t> serialize_session_update(MessageType type, uint16_t symbol_id, double value, uint64_t trading_session_date)
+                {
+                    std::vector<uint8_t> buffer(SESSION_UPDATE_SIZE);
+                    size_t offset = 0;
+
+                    MessageHeader header(SESSION_UPDATE_SIZE, type);
+                    std::memcpy(buffer.data() + offset, &header, sizeof(MessageHeader));
+                    offset += sizeof(MessageHeader);
+
+                    std::memcpy(buffer.data() + offset, &symbol_id, sizeof(uint16_t));
+                    offset += sizeof(uint16_t);
+
+                    std::memcpy(buffer.data() + offset, &value, sizeof(double));
+                    offset += sizeof(double);
+
+                    std::memcpy(buffer.data() + offset, &trading_session_date, sizeof(uint64_t));
+
+                    return buffer;
+                }
+
+                bool deserialize_session_update(const uint8_t *data, uint16_t size, uint16_t &symbol_id, double &value, uint64_t &trading_session_date)
+                {
+                    if (!data || size < SESSION_UPDATE_SIZE)
+                        return false;
+
+                    size_t offset = sizeof(MessageHeader);
+
+                    std::memcpy(&symbol_id, data + offset, sizeof(uint16_t));
+                    offset += sizeof(uint16_t);
+
+                    std::memcpy(&value, data + offset, sizeof(double));
+                    offset += sizeof(double);
+
+                    std::memcpy(&trading_session_date, data + offset, sizeof(uint64_t));
+
+                    return true;
+                }
+            }
+
+            uint16_t MarketDataUpdateSessionOpen::get_size() const { return SESSION_UPDATE_SIZE; }
+            std::vector<uint8_t> MarketDataUpdateSessionOpen::serialize() const { return serialize_session_update(get_type(), symbol_id, price, trading_session_date); }
+            bool MarketDataUpdateSessionOpen::deserialize(const uint8_t *data, uint16_t size) { return deserialize_session_update(data, size, symbol_id, price, trading_session_date); }
+
+            uint16_t MarketDataUpdateSessionHigh::get_size() const { return SESSION_UPDATE_SIZE; }
+            std::vector<uint8_t> MarketDataUpdateSessionHigh::serialize() const { return serialize_session_update(get_type(), symbol_id, price, trading_session_date); }
+            bool MarketDataUpdateSessionHigh::deserialize(const uint8_t *data, uint16_t size) { return deserialize_session_update(data, size, symbol_id, price, trading_session_date); }
+
+            uint16_t MarketDataUpdateSessionLow::get_size() const { return SESSION_UPDATE_SIZE; }
+            std::vector<uint8_t> MarketDataUpdateSessionLow::serialize() const { return serialize_session_update(get_type(), symbol_id, price, trading_session_date); }
+            bool MarketDataUpdateSessionLow::deserialize(const uint8_t *data, uint16_t size) { return deserialize_session_update(data, size, symbol_id, price, trading_session_date); }
+
+            uint16_t MarketDataUpdateSessionVolume::get_size() const { return SESSION_UPDATE_SIZE; }
+            std::vector<uint8_t> MarketDataUpdateSessionVolume::serialize() const { return serialize_session_update(get_type(), symbol_id, volume, trading_session_date); }
+            bool MarketDataUpdateSessionVolume::deserialize(const uint8_t *data, uint16_t size) { return deserialize_session_update(data, size, symbol_id, volume, trading_session_date); }
+
+            // =====================
+            // Order message helpers
+            // Order messages carry many strings, so they are built by appending rather than at fixed offsets
+            // =====================
+            namespace
+            {
+                template <typename T>
+                void append_value(std::vector<uint8_t> &buffer, const T &value)
+                {
+                    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&value);
+                    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+                }
+
+                template <typename T>
+                bool read_value(const uint8_t *data, uint16_t &offset, uint16_t size, T &value)
+                {
+                    if (offset + sizeof(T) > size)
+                        return false;
+                    std::memcpy(&value, data + offset, sizeof(T));
+                    offset += sizeof(T);
+                    return true;
+                }
+
+                void finish_message(std::vector<uint8_t> &buffer, MessageType type)
+                {
+                    MessageHeader header(static_cast<uint16_t>(buffer.size()), type);
+                    std::memcpy(buffer.data(), &header, sizeof(MessageHeader));
+                }
+            }
+
+            // =====================
+            // SubmitNewSingleOrder implementation
+            // =====================
+            uint16_t SubmitNewSingleOrder::get_size() const
+            {
+                return sizeof(MessageHeader) + symbol.length() + 1 + exchange.length() + 1 + trade_account.length() + 1 +
+                       client_order_id.length() + 1 + sizeof(uint8_t) * 2 + sizeof(double) * 3 + sizeof(uint8_t) +
+                       sizeof(uint64_t) + sizeof(uint8_t) * 2 + free_form_text.length() + 1;
+            }
+
+            std::vector<uint8_t> SubmitNewSingleOrder::serialize() const
+            {
+                std::vector<uint8_t> buffer;
+                buffer.reserve(get_size());
+                buffer.resize(sizeof(MessageHeader));
+
+                Protocol::write_dtc_string(buffer, symbol);
+                Protocol::write_dtc_string(buffer, exchange);
+                Protocol::write_dtc_string(buffer, trade_account);
+                Protocol::write_dtc_string(buffer, client_order_id);
+                append_value(buffer, static_cast<uint8_t>(order_type));
+                append_value(buffer, static_cast<uint8_t>(buy_sell));
+                append_value(buffer, price1);
+                append_value(buffer, price2);
+                append_value(buffer, quantity);
+                append_value(buffer, static_cast<uint8_t>(time_in_force));
+                append_value(buffer, good_till_date_time);
+                append_value(buffer, is_automated_order);
+                append_value(buffer, is_parent_order);
+                Protocol::write_dtc_string(buffer, free_form_text);
+
+                finish_message(buffer, get_type());
+                return buffer;
+            }
+
+            bool SubmitNewSingleOrder::deserialize(const uint8_t *data, uint16_t size)
+            {
+                if (!data || size < sizeof(MessageHeader))
+                    return false;
+
+                uint16_t offset = sizeof(MessageHeader);
+                symbol = Protocol::read_dtc_string(data, offset, size);
+                exchange = Protocol::read_dtc_string(data, offset, size);
+                trade_account = Protocol::read_dtc_string(data, offset, size);
+                client_order_id = Protocol::read_dtc_string(data, offset, size);
+
+                uint8_t type = 0, side = 0, tif = 0;
+                if (!read_value(data, offset, size, type) || !read_value(data, offset, size, side) ||
+                    !read_value(data, offset, size, price1) || !read_value(data, offset, size, price2) ||
+                    !read_value(data, offset, size, quantity) || !read_value(data, offset, size, tif) ||
+                    !read_value(data, offset, size, good_till_date_time) || !read_value(data, offset, size, is_automated_order) ||
+                    !read_value(data, offset, size, is_parent_order))
+                    return false;
+
+                order_type = static_cast<OrderTypeEnum>(type);
+                buy_sell = static_cast<BuySellEnum>(side);
+                time_in_force = static_cast<TimeInForceEnum>(tif);
+                free_form_text = Protocol::read_dtc_string(data, offset, size);
+                return true;
+            }
+
+            // =====================
+            // OrderUpdate implementation
+            // =====================
+            uint16_t OrderUpdate::get_size() const
+            {
+                size_t strings = symbol.length() + exchange.length() + previous_server_order_id.length() + server_order_id.length() +
+                                 client_order_id.length() + exchange_order_id.length() + free_form_text.length() + order_id.length() +
+                                 trade_account.length() + info_text.length() + parent_server_order_id.length() +
+                                 oco_linked_order_server_order_id.length() + 12;
+                return sizeof(MessageHeader) + sizeof(uint32_t) + sizeof(int32_t) * 2 + sizeof(uint8_t) * 3 + sizeof(double) * 8 +
+                       sizeof(uint64_t) * 2 + sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint32_t) + sizeof(uint8_t) + strings;
+            }
+
+            std::vector<uint8_t> OrderUpdate::serialize() const
+            {
+                std::vector<uint8_t> buffer;
+                buffer.reserve(get_size());
+                buffer.resize(sizeof(MessageHeader));
+
+                append_value(buffer, request_id);
+                append_value(buffer, total_num_messages);
+                append_value(buffer, message_number);
+                Protocol::write_dtc_string(buffer, symbol);
+                Protocol::write_dtc_string(buffer, exchange);
+                Protocol::write_dtc_string(buffer, previous_server_order_id);
+                Protocol::write_dtc_string(buffer, server_order_id);
+                Protocol::write_dtc_string(buffer, client_order_id);
+                Protocol::write_dtc_string(buffer, exchange_order_id);
+                append_value(buffer, static_cast<uint8_t>(order_status));
+                append_value(buffer, static_cast<uint8_t>(order_type));
+                append_value(buffer, static_cast<uint8_t>(buy_sell));
+                for (double value : {price1, price2, order_quantity, filled_quantity, remaining_quantity,
+                                     average_fill_price, last_fill_price, last_fill_quantity})
+                    append_value(buffer, value);
+                append_value(buffer, last_fill_date_time);
+                append_value(buffer, order_received_date_time);
+                append_value(buffer, static_cast<uint8_t>(time_in_force));
+                append_value(buffer, good_till_date_time);
+                append_value(buffer, order_update_sequence_number);
+                Protocol::write_dtc_string(buffer, free_form_text);
+                Protocol::write_dtc_string(buffer, order_id);
+                Protocol::write_dtc_string(buffer, trade_account);
+                Protocol::write_dtc_string(buffer, info_text);
+                append_value(buffer, no_orders);
+                Protocol::write_dtc_string(buffer, parent_server_order_id);
+                Protocol::write_dtc_string(buffer, oco_linked_order_server_order_id);
+
+                finish_message(buffer, get_type());
+                return buffer;
+            }
+
+            bool OrderUpdate::deserialize(const uint8_t *data, uint16_t size)
+            {
+                if (!data || size < sizeof(MessageHeader))
+                    return false;
+
+                uint16_t offset = sizeof(MessageHeader);
+                if (!read_value(data, offset, size, request_id) || !read_value(data, offset, size, total_num_messages) ||
+                    !read_value(data, offset, size, message_number))
+                    return false;
+
+                symbol = Protocol::read_dtc_string(data, offset, size);
+                exchange = Protocol::read_dtc_string(data, offset, size);
+                previous_server_order_id = Protocol::read_dtc_string(data, offset, size);
+                server_order_id = Protocol::read_dtc_string(data, offset, size);
+                client_order_id = Protocol::read_dtc_string(data, offset, size);
+                exchange_order_id = Protocol::read_dtc_string(data, offset, size);
+
+                uint8_t status = 0, type = 0, side = 0, tif = 0;
+                if (!read_value(data, offset, size, status) || !read_value(data, offset, size, type) ||
+                    !read_value(data, offset, size, side))
+                    return false;
+                for (double *value : {&price1, &price2, &order_quantity, &filled_quantity, &remaining_quantity,
+                                      &average_fill_price, &last_fill_price, &last_fill_quantity})
+                {
+                    if (!read_value(data, offset, size, *value))
+                        return false;
+                }
+                if (!read_value(data, offset, size, last_fill_date_time) || !read_value(data, offset, size, order_received_date_time) ||
+                    !read_value(data, offset, size, tif) || !read_value(data, offset, size, good_till_date_time) ||
+                    !read_value(data, offset, size, order_update_sequence_number))
+                    return false;
+
+                order_status = static_cast<OrderStatusEnum>(status);
+                order_type = static_cast<OrderTypeEnum>(type);
+                buy_sell = static_cast<BuySellEnum>(side);
+                time_in_force = static_cast<TimeInForceEnum>(tif);
+
+                free_form_text = Protocol::read_dtc_string(data, offset, size);
+                order_id = Protocol::read_dtc_string(data, offset, size);
+                trade_account = Protocol::read_dtc_string(data, offset, size);
+                info_text = Protocol::read_dtc_string(data, offset, size);
+                if (!read_value(data, offset, size, no_orders))
+                    return false;
+                parent_server_order_id = Protocol::read_dtc_string(data, offset, size);
+                oco_linked_order_server_order_id = Protocol::read_dtc_string(data, offset, size);
+                return true;
+            }
+
+            // =====================
+            // OpenOrdersRequest implementation
+            // =====================
+            uint16_t OpenOrdersRequest::get_size() const
+            {
+                return sizeof(MessageHeader) + sizeof(uint32_t) + sizeof(int32_t) + server_order_id.length() + 1 +
+                       trade_account.length() + 1;
+            }
+
+            std::vector<uint8_t> OpenOrdersRequest::serialize() const
+            {
+                std::vector<uint8_t> buffer;
+                buffer.reserve(get_size());
+                buffer.resize(sizeof(MessageHeader));
+
+                append_value(buffer, request_id);
+                append_value(buffer, request_all_orders);
+                Protocol::write_dtc_string(buffer, server_order_id);
+                Protocol::write_dtc_string(buffer, trade_account);
+
+                finish_message(buffer, get_type());
+                return buffer;
+            }
+
+            bool OpenOrdersRequest::deserialize(const uint8_t *data, uint16_t size)
+            {
+                if (!data || size < sizeof(MessageHeader))
+                    return false;
+
+                uint16_t offset = sizeof(MessageHeader);
+                if (!read_value(data, offset, size, request_id) || !read_value(data, offset, size, request_all_orders))
+                    return false;
+                server_order_id = Protocol::read_dtc_string(data, offset, size);
+                trade_account = Protocol::read_dtc_string(data, offset, size);
+                return true;
+            }
+
+            // =====================
+            // OpenOrdersReject implementation
+            // =====================
+            uint16_t OpenOrdersReject::get_size() const
+            {
+                return sizeof(MessageHeader) + sizeof(uint32_t) + reject_text.length() + 1;
+            }
+
+            std::vector<uint8_t> OpenOrdersReject::serialize() const
+            {
+                std::vector<uint8_t> buffer;
+                buffer.reserve(get_size());
+                buffer.resize(sizeof(MessageHeader));
+
+                append_value(buffer, request_id);
+                Protocol::write_dtc_string(buffer, reject_text);
+
+                finish_message(buffer, get_type());
+                return buffer;
+            }
+
+            bool OpenOrdersReject::deserialize(const uint8_t *data, uint16_t size)
+            {
+                if (!data || size < sizeof(MessageHeader))
+                    return false;
+
+                uint16_t offset = sizeof(MessageHeader);
+                if (!read_value(data, offset, size, request_id))
+                    return false;
+                reject_text = Protocol::read_dtc_string(data, offset, size);
+                return true;
+            }
+
+            // =====================
+            // HistoricalPriceDataRequest implementation
+            // =====================
+            uint16_t HistoricalPriceDataRequest::get_size() const
+            {
+                return sizeof(MessageHeader) + sizeof(int32_t) +
+                       symbol.length() + 1 + exchange.length() + 1 +
+                       sizeof(int32_t) + sizeof(int64_t) + sizeof(int64_t) + sizeof(uint32_t) +
+                       sizeof(uint8_t) + sizeof(uint8_t) + sizeof(uint16_t);
+            }
+
+            std::vector<uint8_t> HistoricalPriceDataRequest::serialize() const
+            {
+                uint16_t total_size = get_size();
+                std::vector<uint8_t> buffer(total_size);
+                size_t offset = 0;
+
+                MessageHeader header(total_size, get_type());
+                std::memcpy(buffer.data() + offset, &header, sizeof(MessageHeader));
+                offset += sizeof(MessageHeader);
+
+                std::memcpy(buffer.data() + offset, &request_id, sizeof(int32_t));
+                offset += sizeof(int32_t);
+
+                std::memcpy(buffer.data() + offset, symbol.c_str(), symbol.length() + 1);
+                offset += symbol.length() + 1;
+
+                std::memcpy(buffer.data() + offset, exchange.c_str(), exchange.length() + 1);
+                offset += exchange.length() + 1;
+
+                std::memcpy(buffer.data() + offset, &record_interval, sizeof(int32_t));
+                offset += sizeof(int32_t);
+
+                std::memcpy(buffer.data() + offset, &start_date_time, sizeof(int64_t));
+                offset += sizeof(int64_t);
+
+                std::memcpy(buffer.data() + offset, &end_date_time, sizeof(int64_t));
+                offset += sizeof(int64_t);
+
+                std::memcpy(buffer.data() + offset, &max_days_to_return, sizeof(uint32_t));
+                offset += sizeof(uint32_t);
+
+                std::memcpy(buffer.data() + offset, &use_zlib_compression, sizeof(uint8_t));
+                offset += sizeof(uint8_t);
+
+                std::memcpy(buffer.data() + offset, &request_dividend_adjusted_stock_data, sizeof(uint8_t));
+                offset += sizeof(uint8_t);
+
+                std::memcpy(buffer.data() + offset, &integer_1, sizeof(uint16_t));
+                offset += sizeof(uint16_t);
+
+                return buffer;
+            }
+
+            bool HistoricalPriceDataRequest::deserialize(const uint8_t *data, uint16_t size)
+            {
+                if (!data || size < sizeof(MessageHeader) + sizeof(int32_t))
+                    return false;
+
+                const uint8_t *ptr = data + sizeof(MessageHeader);
+                size_t remaining = size - sizeof(MessageHeader);
+
+                std::memcpy(&request_id, ptr, sizeof(int32_t));
+                ptr += sizeof(int32_t);
+                remaining -= sizeof(int32_t);
+
+                // Read symbol (null-terminated string)
+                const char *symbol_start = reinterpret_cast<const char *>(ptr);
+                size_t symbol_len = strnlen(symbol_start, remaining);
+                if (symbol_len == remaining)
+                    return false;
+                symbol.assign(symbol_start, symbol_len);
+                ptr += symbol_len + 1;
+                remaining -= symbol_len + 1;
+
+                // Read exchange (null-terminated string)
+                const char *exchange_start = reinterpret_cast<const char *>(ptr);
+                size_t exchange_len = strnlen(exchange_start, remaining);
+                if (exchange_len == remaining)
+                    return false;
+                exchange.assign(exchange_start, exchange_len);
+                ptr += exchange_len + 1;
+                remaining -= exchange_len + 1;
+
+                size_t fixed_size = sizeof(int32_t) + sizeof(int64_t) + sizeof(int64_t) + sizeof(uint32_t) +
+                                    sizeof(uint8_t) + sizeof(uint8_t) + sizeof(uint16_t);
+                if (remaining < fixed_size)
+                    return false;
+
+                std::memcpy(&record_interval, ptr, sizeof(int32_t));
+                ptr += sizeof(int32_t);
+
+                std::memcpy(&start_date_time, ptr, sizeof(int64_t));
+                ptr += sizeof(int64_t);
+
+                std::memcpy(&end_date_time, ptr, sizeof(int64_t));
+                ptr += sizeof(int64_t);
+
+                std::memcpy(&max_days_to_return, ptr, sizeof(uint32_t));
+                ptr += sizeof(uint32_t);
+
+                std::memcpy(&use_zlib_compression, ptr, sizeof(uint8_t));
+                ptr += sizeof(uint8_t);
+
+                std::memcpy(&request_dividend_adjusted_stock_data, ptr, sizeof(uint8_t));
+                ptr += sizeof(uint8_t);
+
+                std::memcpy(&integer_1, ptr, sizeof(uint16_t));
+
+                return true;
+            }
+
+            // =====================
+            // HistoricalPriceDataResponseHeader implementation
+            // =====================
+            uint16_t HistoricalPriceDataResponseHeader::get_size() const
+            {
+                return sizeof(MessageHeader) + sizeof(int32_t) + sizeof(int32_t) + sizeof(uint8_t) + sizeof(uint8_t) + sizeof(float);
+            }
+
+            std::vector<uint8_t> HistoricalPriceDataResponseHeader::serialize() const
+            {
+                uint16_t total_size = get_size();
+                std::vector<uint8_t> buffer(total_size);
+                size_t offset = 0;
+
+                MessageHeader header(total_size, get_type());
+                std::memcpy(buffer.data() + offset, &header, sizeof(MessageHeader));
+                offset += sizeof(MessageHeader);
+
+                std::memcpy(buffer.data() + offset, &request_id, sizeof(int32_t));
+                offset += sizeof(int32_t);
+
+                std::memcpy(buffer.data() + offset, &record_interval, sizeof(int32_t));
+                offset += sizeof(int32_t);
+
+                std::memcpy(buffer.data() + offset, &use_zlib_compression, sizeof(uint8_t));
+                offset += sizeof(uint8_t);
+
+                std::memcpy(buffer.data() + offset, &no_records_to_return, sizeof(uint8_t));
+                offset += sizeof(uint8_t);
+
+                std::memcpy(buffer.data() + offset, &int_to_float_price_divisor, sizeof(float));
+                offset += sizeof(float);
+
+                return buffer;
+            }
+
+            bool HistoricalPriceDataResponseHeader::deserialize(const uint8_t *data, uint16_t size)
+            {
+                if (!data || size < get_size())
+                    return false;
+
+                size_t offset = sizeof(MessageHeader);
+
+                std::memcpy(&request_id, data + offset, sizeof(int32_t));
+                offset += sizeof(int32_t);
+
+                std::memcpy(&record_interval, data + offset, sizeof(int32_t));
+                offset += sizeof(int32_t);
+
+                std::memcpy(&use_zlib_compression, data + offset, sizeof(uint8_t));
+                offset += sizeof(uint8_t);
+
+                std::memcpy(&no_records_to_return, data + offset, sizeof(uint8_t));
+                offset += sizeof(uint8_t);
+
+                std::memcpy(&int_to_float_price_divisor, data + offset, sizeof(float));
+                offset += sizeof(float);
+
+                return true;
+            }
+
+            // =====================
+            // HistoricalPriceDataReject implementation
+            // =====================
+            uint16_t HistoricalPriceDataReject::get_size() const
+            {
+                return sizeof(MessageHeader) + sizeof(int32_t) + sizeof(int16_t) + sizeof(uint16_t) + reject_text.length() + 1;
+            }
+
+            std::vector<uint8_t> HistoricalPriceDataReject::serialize() const
+            {
+                uint16_t total_size = get_size();
+                std::vector<uint8_t> buffer(total_size);
+                size_t offset = 0;
+
+                MessageHeader header(total_size, get_type());
+                std::memcpy(buffer.data() + offset, &header, sizeof(MessageHeader));
+                offset += sizeof(MessageHeader);
+
+                std::memcpy(buffer.data() + offset, &request_id, sizeof(int32_t));
+                offset += sizeof(int32_t);
+
+                std::memcpy(buffer.data() + offset, &reject_reason_code, sizeof(int16_t));
+                offset += sizeof(int16_t);
+
+                std::memcpy(buffer.data() + offset, &retry_time_in_seconds, sizeof(uint16_t));
+                offset += sizeof(uint16_t);
+
+                std::memcpy(buffer.data() + offset, reject_text.c_str(), reject_text.length() + 1);
+
+                return buffer;
+            }
+
+            bool HistoricalPriceDataReject::deserialize(const uint8_t *data, uint16_t size)
+            {
+                size_t fixed_size = sizeof(MessageHeader) + sizeof(int32_t) + sizeof(int16_t) + sizeof(uint16_t);
+                if (!data || size <= fixed_size)
+                    return false;
+
+                size_t offset = sizeof(MessageHeader);
+
+                std::memcpy(&request_id, data + offset, sizeof(int32_t));
+                offset += sizeof(int32_t);
+
+                std::memcpy(&reject_reason_code, data + offset, sizeof(int16_t));
+                offset += sizeof(int16_t);
+
+                std::memcpy(&retry_time_in_seconds, data + offset, sizeof(uint16_t));
+                offset += sizeof(uint16_t);
+
+                const char *text_start = reinterpret_cast<const char *>(data + offset);
+                reject_text.assign(text_start, strnlen(text_start, size - offset));
+
+                return true;
+            }
+
+            // =====================
+            // HistoricalPriceDataRecordResponse implementation
+            // =====================
+            uint16_t HistoricalPriceDataRecordResponse::get_size() const
+            {
+                return sizeof(MessageHeader) + sizeof(int32_t) + sizeof(int64_t) + sizeof(double) * 5 +
+                       sizeof(uint32_t) + sizeof(double) * 2 + sizeof(uint8_t);
+            }
+
+            std::vector<uint8_t> HistoricalPriceDataRecordResponse::serialize() const
+            {
+                uint16_t total_size = get_size();
+                std::vector<uint8_t> buffer(total_size);
+                size_t offset = 0;
+
+                MessageHeader header(total_size, get_type());
+                std::memcpy(buffer.data() + offset, &header, sizeof(MessageHeader));
+                offset += sizeof(MessageHeader);
+
+                std::memcpy(buffer.data() + offset, &request_id, sizeof(int32_t));
+                offset += sizeof(int32_t);
+
+                std::memcpy(buffer.data() + offset, &start_date_time, sizeof(int64_t));
+                offset += sizeof(int64_t);
+
+                for (double value : {open_price, high_price, low_price, last_price, volume})
+                {
+                    std::memcpy(buffer.data() + offset, &value, sizeof(double));
+                    offset += sizeof(double);
+                }
+
+                std::memcpy(buffer.data() + offset, &num_trades, sizeof(uint32_t));
+                offset += sizeof(uint32_t);
+
+                std::memcpy(buffer.data() + offset, &bid_volume, sizeof(double));
+                offset += sizeof(double);
+
+                std::memcpy(buffer.data() + offset, &ask_volume, sizeof(double));
+                offset += sizeof(double);
+
+                std::memcpy(buffer.data() + offset, &is_final_record, sizeof(uint8_t));
+                offset += sizeof(uint8_t);
+
+                return buffer;
+            }
+
+            bool HistoricalPriceDataRecordResponse::deserialize(const uint8_t *data, uint16_t size)
+            {
+                if (!data || size < get_size())
+                    return false;
+
+                size_t offset = sizeof(MessageHeader);
+
+                std::memcpy(&request_id, data + offset, sizeof(int32_t));
+                offset += sizeof(int32_t);
+
+                std::memcpy(&start_date_time, data + offset, sizeof(int64_t));
+                offset += sizeof(int64_t);
+
+                for (double *value : {&open_price, &high_price, &low_price, &last_price, &volume})
+                {
+                    std::memcpy(value, data + offset, sizeof(double));
+                    offset += sizeof(double);
+                }
+
+                std::memcpy(&num_trades, data + offset, sizeof(uint32_t));
+                offset += sizeof(uint32_t);
+
+                std::memcpy(&bid_volume, data + offset, sizeof(double));
+                offset += sizeof(double);
+
+                std::memcpy(&ask_volume, data + offset, sizeof(double));
+                offset += sizeof(double);
+
+                std::memcpy(&is_final_record, data + offset, sizeof(uint8_t));
+                offset += sizeof(uint8_t);
+
+                return true;
+            }
+
+            // =====================
+            // HistoricalPriceDataTickRecordResponse implementation
+            // =====================
+            uint16_t HistoricalPriceDataTickRecordResponse::get_size() const
+            {
+                return static_cast<uint16_t>(RECORD_SIZE);
+            }
+
+            std::vector<uint8_t> HistoricalPriceDataTickRecordResponse::serialize() const
+            {
+                std::vector<uint8_t> buffer(RECORD_SIZE);
+
+                MessageHeader header(static_cast<uint16_t>(RECORD_SIZE), get_type());
+                std::memcpy(buffer.data(), &header, sizeof(MessageHeader));
+                std::memcpy(buffer.data() + REQUEST_ID_OFFSET, &request_id, sizeof(int32_t));
+                std::memcpy(buffer.data() + DATE_TIME_OFFSET, &date_time, sizeof(double));
+                std::memcpy(buffer.data() + AT_BID_OR_ASK_OFFSET, &at_bid_or_ask, sizeof(uint8_t));
+                std::memcpy(buffer.data() + PRICE_OFFSET, &price, sizeof(double));
+                std::memcpy(buffer.data() + VOLUME_OFFSET, &volume, sizeof(double));
+                std::memcpy(buffer.data() + IS_FINAL_RECORD_OFFSET, &is_final_record, sizeof(uint8_t));
+
+                return buffer;
+            }
+
+            bool HistoricalPriceDataTickRecordResponse::deserialize(const uint8_t *data, uint16_t size)
+            {
+                if (!data || size < RECORD_SIZE)
+                    return false;
+
+                std::memcpy(&request_id, data + REQUEST_ID_OFFSET, sizeof(int32_t));
+                std::memcpy(&date_time, data + DATE_TIME_OFFSET, sizeof(double));
+                std::memcpy(&at_bid_or_ask, data + AT_BID_OR_ASK_OFFSET, sizeof(uint8_t));
+                std::memcpy(&price, data + PRICE_OFFSET, sizeof(double));
+                std::memcpy(&volume, data + VOLUME_OFFSET, sizeof(double));
+                std::memcpy(&is_final_record, data + IS_FINAL_RECORD_OFFSET, sizeof(uint8_t));
+
+                return true;
+            }
+
         } // namespace dtc
     } // namespace core
 } // namespace open_dtc_server
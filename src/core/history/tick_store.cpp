@@ -0,0 +1,421 @@
+#include "coinbase_dtc_core/core/history/tick_store.hpp"
+#include "coinbase_dtc_core/core/util/log.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+namespace open_dtc_server
+{
+    namespace core
+    {
+        namespace history
+        {
+            namespace fs = std::filesystem;
+
+            namespace
+            {
+                constexpr int64_t MICROS_PER_DAY = 86400LL * 1000000LL;
+                constexpr size_t READ_BLOCK_RECORDS = 64 * 1024;
+                constexpr size_t SPARE_BATCHES = 8;
+
+                // Howard Hinnant's days-to-civil conversion, avoids gmtime portability issues
+                std::string format_day(int64_t days)
+                {
+                    days += 719468;
+                    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+                    int64_t doe = days - era * 146097;
+                    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+                    int64_t year = yoe + era * 400;
+                    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+                    int64_t mp = (5 * doy + 2) / 153;
+                    int64_t day = doy - (153 * mp + 2) / 5 + 1;
+                    int64_t month = mp < 10 ? mp + 3 : mp - 9;
+                    year += (month <= 2);
+
+                    char buffer[16];
+                    std::snprintf(buffer, sizeof(buffer), "%04d%02d%02d",
+                                  static_cast<int>(year), static_cast<int>(month), static_cast<int>(day));
+                    return buffer;
+                }
+
+                template <typename T>
+                bool append_column(const fs::path &path, const T *data, size_t count)
+                {
+                    FILE *file = std::fopen(path.string().c_str(), "ab");
+                    if (!file)
+                        return false;
+                    size_t written = std::fwrite(data, sizeof(T), count, file);
+                    std::fclose(file);
+                    return written == count;
+                }
+
+                uint64_t column_records(const fs::path &path, size_t element_size)
+                {
+                    std::error_code ec;
+                    auto bytes = fs::file_size(path, ec);
+                    return ec ? 0 : bytes / element_size;
+                }
+
+                void truncate_column(const fs::path &path, size_t element_size, uint64_t records)
+                {
+                    std::error_code ec;
+                    if (fs::exists(path, ec) && fs::file_size(path, ec) > records * element_size)
+                        fs::resize_file(path, records * element_size, ec);
+                }
+
+                /** Cut every column back to the records all of them hold; returns that count */
+                uint64_t align_columns(const fs::path &directory, uint64_t records, uint64_t index_entries)
+                {
+                    truncate_column(directory / "time.col", sizeof(int64_t), records);
+                    truncate_column(directory / "price.col", sizeof(double), records);
+                    truncate_column(directory / "volume.col", sizeof(double), records);
+                    truncate_column(directory / "side.col", sizeof(uint8_t), records);
+                    truncate_column(directory / "index.idx", sizeof(int64_t) + sizeof(uint64_t), index_entries);
+                    return records;
+                }
+
+                class ColumnReader
+                {
+                public:
+                    ColumnReader(const fs::path &path, size_t element_size, uint64_t first_record)
+                        : file_(std::fopen(path.string().c_str(), "rb"))
+                    {
+                        if (file_)
+                        {
+                            std::setvbuf(file_, nullptr, _IOFBF, 1 << 20);
+                            std::fseek(file_, static_cast<long>(first_record * element_size), SEEK_SET);
+                        }
+                    }
+                    ~ColumnReader()
+                    {
+                        if (file_)
+                            std::fclose(file_);
+                    }
+                    ColumnReader(const ColumnReader &) = delete;
+                    ColumnReader &operator=(const ColumnReader &) = delete;
+
+                    bool is_open() const { return file_ != nullptr; }
+
+                    template <typename T>
+                    bool read(std::vector<T> &block, size_t count)
+                    {
+                        block.resize(count);
+                        return std::fread(block.data(), sizeof(T), count, file_) == count;
+                    }
+
+                private:
+                    FILE *file_;
+                };
+            } // namespace
+
+            // =====================
+            // TickColumns implementation
+            // =====================
+            void TickColumns::clear()
+            {
+                time_us.clear();
+                price.clear();
+                volume.clear();
+                side.clear();
+            }
+
+            void TickColumns::reserve(size_t count)
+            {
+                time_us.reserve(count);
+                price.reserve(count);
+                volume.reserve(count);
+                side.reserve(count);
+            }
+
+            void TickColumns::push_back(int64_t t, double p, double v, uint8_t s)
+            {
+                time_us.push_back(t);
+                price.push_back(p);
+                volume.push_back(v);
+                side.push_back(s);
+            }
+
+            // =====================
+            // TickStore implementation
+            // =====================
+            TickStore::TickStore(const std::string &root_path)
+                : root_path_(root_path)
+            {
+                writer_ = std::thread(&TickStore::writer_loop, this);
+            }
+
+            TickStore::~TickStore()
+            {
+                flush();
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stopping_ = true;
+                }
+                work_cv_.notify_one();
+                writer_.join();
+            }
+
+            void TickStore::append(const std::string &symbol, int64_t time_us, double price, double volume, uint8_t side)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                auto &buffer = buffers_[symbol];
+                // Late ticks (journal, replay, other feeds) keep their place in the stream
+                // but not their time: range reads binary-search and stop at end_us
+                time_us = std::max(time_us, buffer.last_time_us);
+                int64_t day = day_of(time_us);
+                if (buffer.day != day)
+                {
+                    if (!buffer.pending.empty())
+                        queue_locked(symbol, buffer);
+                    buffer.day = day;
+                }
+                buffer.last_time_us = time_us;
+
+                buffer.pending.push_back(time_us, price, volume, side);
+                if (buffer.pending.size() >= FLUSH_THRESHOLD)
+                    queue_locked(symbol, buffer);
+            }
+
+            void TickStore::flush()
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                for (auto &entry : buffers_)
+                {
+                    if (!entry.second.pending.empty())
+                        queue_locked(entry.first, entry.second);
+                }
+                wait_written(lock, queued_);
+            }
+
+            bool TickStore::read_range(const std::string &symbol, int64_t start_us, int64_t end_us, TickColumns &out)
+            {
+                {
+                    // Make buffered ticks visible; the wait releases the lock, so appends continue
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    auto it = buffers_.find(symbol);
+                    if (it != buffers_.end() && !it->second.pending.empty())
+                        queue_locked(symbol, it->second);
+                    wait_written(lock, queued_);
+                }
+
+                if (end_us < start_us)
+                    return false;
+
+                bool found = false;
+                for (int64_t day = day_of(start_us); day <= day_of(end_us); ++day)
+                {
+                    if (read_day(symbol, day, start_us, end_us, out))
+                        found = true;
+                }
+                return found;
+            }
+
+            void TickStore::queue_locked(const std::string &symbol, SymbolBuffer &buffer)
+            {
+                queue_.push_back({symbol, buffer.day, std::move(buffer.pending)});
+                ++queued_;
+
+                // Start the next batch on a written one's storage instead of growing a new one
+                if (!spare_.empty())
+                {
+                    buffer.pending = std::move(spare_.back());
+                    spare_.pop_back();
+                }
+                else
+                {
+                    buffer.pending = TickColumns();
+                }
+                work_cv_.notify_one();
+            }
+
+            void TickStore::wait_written(std::unique_lock<std::mutex> &lock, uint64_t batch)
+            {
+                written_cv_.wait(lock, [this, batch]
+                                 { return written_ >= batch; });
+            }
+
+            void TickStore::writer_loop()
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                while (true)
+                {
+                    work_cv_.wait(lock, [this]
+                                  { return stopping_ || !queue_.empty(); });
+                    if (queue_.empty())
+                        return; // Stopping, nothing left to write
+
+                    Batch batch = std::move(queue_.front());
+                    queue_.pop_front();
+                    lock.unlock();
+
+                    write_batch(batch);
+                    batch.ticks.clear();
+
+                    lock.lock();
+                    if (spare_.size() < SPARE_BATCHES)
+                        spare_.push_back(std::move(batch.ticks));
+                    ++written_;
+                    written_cv_.notify_all();
+                }
+            }
+
+            bool TickStore::write_batch(Batch &batch)
+            {
+                auto &file = files_[batch.symbol];
+                fs::path directory = day_directory(batch.symbol, batch.day);
+                if (file.day != batch.day)
+                {
+                    // Resume numbering after a restart on the same day, past whatever a crash left half-written
+                    uint64_t records = std::min({column_records(directory / "time.col", sizeof(int64_t)),
+                                                 column_records(directory / "price.col", sizeof(double)),
+                                                 column_records(directory / "volume.col", sizeof(double)),
+                                                 column_records(directory / "side.col", sizeof(uint8_t))});
+                    file.day = batch.day;
+                    file.records_on_disk = align_columns(directory, records, (records + INDEX_STRIDE - 1) / INDEX_STRIDE);
+                    if (records > 0)
+                    {
+                        ColumnReader times(directory / "time.col", sizeof(int64_t), records - 1);
+                        std::vector<int64_t> last;
+                        if (times.is_open() && times.read(last, 1))
+                            file.last_time_us = std::max(file.last_time_us, last[0]);
+                    }
+                }
+
+                // Buffered times are already ordered; only a previous run's ticks can be later
+                auto &pending = batch.ticks;
+                for (auto &time_us : pending.time_us)
+                    time_us = std::max(time_us, file.last_time_us);
+                file.last_time_us = pending.time_us.back();
+
+                std::error_code ec;
+                fs::create_directories(directory, ec);
+                if (ec)
+                {
+                    util::simple_log("[HISTORY] Cannot create " + directory.string() + ": " + ec.message());
+                    return false;
+                }
+
+                size_t count = pending.size();
+
+                bool ok = append_column(directory / "time.col", pending.time_us.data(), count) &&
+                          append_column(directory / "price.col", pending.price.data(), count) &&
+                          append_column(directory / "volume.col", pending.volume.data(), count) &&
+                          append_column(directory / "side.col", pending.side.data(), count);
+
+                // Sparse index: one entry per INDEX_STRIDE records
+                std::vector<IndexEntry> index;
+                uint64_t first = file.records_on_disk;
+                uint64_t next_indexed = ((first + INDEX_STRIDE - 1) / INDEX_STRIDE) * INDEX_STRIDE;
+                for (uint64_t record = next_indexed; record < first + count; record += INDEX_STRIDE)
+                    index.push_back({pending.time_us[record - first], record});
+                if (ok && !index.empty())
+                    ok = append_column(directory / "index.idx", index.data(), index.size());
+
+                if (ok)
+                {
+                    file.records_on_disk += count;
+                }
+                else
+                {
+                    // Whatever made it into some columns would shift every later record
+                    util::simple_log("[HISTORY] Failed to write ticks for " + batch.symbol + " in " + directory.string() +
+                                     ", " + std::to_string(count) + " dropped");
+                    align_columns(directory, file.records_on_disk, (file.records_on_disk + INDEX_STRIDE - 1) / INDEX_STRIDE);
+                }
+                return ok;
+            }
+
+            bool TickStore::read_day(const std::string &symbol, int64_t day, int64_t start_us, int64_t end_us, TickColumns &out) const
+            {
+                fs::path directory = day_directory(symbol, day);
+                std::error_code ec;
+                if (!fs::exists(directory / "time.col", ec))
+                    return false;
+
+                // Columns are appended one after another; trust only what all of them hold
+                uint64_t total = std::min({column_records(directory / "time.col", sizeof(int64_t)),
+                                           column_records(directory / "price.col", sizeof(double)),
+                                           column_records(directory / "volume.col", sizeof(double)),
+                                           column_records(directory / "side.col", sizeof(uint8_t))});
+
+                // Locate the last indexed record at or before start_us
+                uint64_t first_record = 0;
+                uint64_t index_entries = column_records(directory / "index.idx", sizeof(IndexEntry));
+                if (index_entries > 0)
+                {
+                    ColumnReader index_reader(directory / "index.idx", sizeof(IndexEntry), 0);
+                    std::vector<IndexEntry> index;
+                    if (index_reader.is_open() && index_reader.read(index, index_entries))
+                    {
+                        auto it = std::upper_bound(index.begin(), index.end(), start_us,
+                                                   [](int64_t t, const IndexEntry &entry)
+                                                   { return t < entry.time_us; });
+                        if (it != index.begin())
+                            first_record = std::min<uint64_t>((it - 1)->record, total);
+                    }
+                }
+
+                ColumnReader times(directory / "time.col", sizeof(int64_t), first_record);
+                ColumnReader prices(directory / "price.col", sizeof(double), first_record);
+                ColumnReader volumes(directory / "volume.col", sizeof(double), first_record);
+                ColumnReader sides(directory / "side.col", sizeof(uint8_t), first_record);
+                if (!times.is_open() || !prices.is_open() || !volumes.is_open() || !sides.is_open())
+                    return false;
+
+                std::vector<int64_t> time_block;
+                std::vector<double> price_block;
+                std::vector<double> volume_block;
+                std::vector<uint8_t> side_block;
+
+                size_t before = out.size();
+                for (uint64_t record = first_record; record < total;)
+                {
+                    size_t count = static_cast<size_t>(std::min<uint64_t>(READ_BLOCK_RECORDS, total - record));
+                    if (!times.read(time_block, count) || !prices.read(price_block, count) ||
+                        !volumes.read(volume_block, count) || !sides.read(side_block, count))
+                        break;
+                    record += count;
+
+                    auto lo = std::lower_bound(time_block.begin(), time_block.end(), start_us) - time_block.begin();
+                    auto hi = std::upper_bound(time_block.begin(), time_block.end(), end_us) - time_block.begin();
+                    if (lo < hi)
+                    {
+                        out.time_us.insert(out.time_us.end(), time_block.begin() + lo, time_block.begin() + hi);
+                        out.price.insert(out.price.end(), price_block.begin() + lo, price_block.begin() + hi);
+                        out.volume.insert(out.volume.end(), volume_block.begin() + lo, volume_block.begin() + hi);
+                        out.side.insert(out.side.end(), side_block.begin() + lo, side_block.begin() + hi);
+                    }
+
+                    if (hi < static_cast<std::ptrdiff_t>(count))
+                        break; // Passed end_us
+                }
+
+                return out.size() > before;
+            }
+
+            std::string TickStore::day_directory(const std::string &symbol, int64_t day) const
+            {
+                return (fs::path(root_path_) / sanitize_symbol(symbol) / format_day(day)).string();
+            }
+
+            int64_t TickStore::day_of(int64_t time_us)
+            {
+                return time_us >= 0 ? time_us / MICROS_PER_DAY : (time_us - MICROS_PER_DAY + 1) / MICROS_PER_DAY;
+            }
+
+            std::string TickStore::sanitize_symbol(const std::string &symbol)
+            {
+                std::string result = symbol;
+                for (char &c : result)
+                {
+                    bool safe = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '.';
+                    if (!safe)
+                        c = '_';
+                }
+                return result;
+            }
+
+        } // namespace history
+    } // namespace core
+} // namespace open_dtc_server
@@ -0,0 +1,238 @@
+#include "coinbase_dtc_core/core/server/bar_aggregator.hpp"
+#include "coinbase_dtc_core/core/dtc/protocol.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace coinbase_dtc_core
+{
+    namespace core
+    {
+        namespace server
+        {
+            namespace dtc = open_dtc_server::core::dtc;
+            using open_dtc_server::exchanges::base::InstrumentId;
+
+            namespace
+            {
+                constexpr int64_t MS_PER_DAY = 24LL * 60 * 60 * 1000;
+
+                // DTC DateTime fields carry seconds
+                uint64_t to_dtc_time(uint64_t timestamp_ms)
+                {
+                    return timestamp_ms / 1000;
+                }
+
+                void add_trade(BarAggregator::Bar &bar, double price, double volume, uint8_t at_bid_or_ask)
+                {
+                    bar.high = std::max(bar.high, price);
+                    bar.low = std::min(bar.low, price);
+                    bar.close = price;
+                    bar.volume += volume;
+                    bar.num_trades++;
+                    if (at_bid_or_ask == 1)
+                        bar.bid_volume += volume;
+                    else if (at_bid_or_ask == 2)
+                        bar.ask_volume += volume;
+                }
+            } // namespace
+
+            BarAggregator::BarAggregator(std::vector<uint32_t> interval_seconds, size_t history, int64_t session_offset_seconds)
+                : history_(history > 0 ? history : 1), session_offset_ms_(session_offset_seconds * 1000)
+            {
+                for (uint32_t interval : interval_seconds)
+                {
+                    if (interval > 0 && std::find(intervals_.begin(), intervals_.end(), interval) == intervals_.end())
+                        intervals_.push_back(interval);
+                }
+            }
+
+            uint64_t BarAggregator::session_start(uint64_t timestamp_ms) const
+            {
+                int64_t shifted = static_cast<int64_t>(timestamp_ms) - session_offset_ms_;
+                int64_t into_day = ((shifted % MS_PER_DAY) + MS_PER_DAY) % MS_PER_DAY;
+                return static_cast<uint64_t>(shifted - into_day + session_offset_ms_);
+            }
+
+            uint8_t BarAggregator::on_trade(InstrumentId instrument, double price, double volume, uint64_t timestamp_ms,
+                                            uint8_t at_bid_or_ask, SessionStats *session)
+            {
+                if (instrument == open_dtc_server::exchanges::base::NO_INSTRUMENT || price <= 0)
+                    return 0;
+
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                auto it = symbols_.find(instrument);
+                if (it == symbols_.end())
+                {
+                    // First trade: size every ring now so later trades never allocate
+                    it = symbols_.emplace(instrument, SymbolBars()).first;
+                    it->second.rings.resize(intervals_.size());
+                    for (size_t i = 0; i < intervals_.size(); i++)
+                    {
+                        it->second.rings[i].interval_ms = static_cast<uint64_t>(intervals_[i]) * 1000;
+                        it->second.rings[i].bars.resize(history_ + 1);
+                    }
+                }
+                SymbolBars &state = it->second;
+                SessionStats &stats = state.session;
+
+                uint8_t changed = 0;
+                uint64_t start = session_start(timestamp_ms);
+                if (stats.num_trades == 0 || start > stats.session_start_ms)
+                {
+                    stats = SessionStats();
+                    stats.session_start_ms = start;
+                    stats.open = stats.high = stats.low = price;
+                    stats.volume = volume;
+                    stats.num_trades = 1;
+                    changed = SESSION_OPEN | SESSION_HIGH | SESSION_LOW | SESSION_VOLUME;
+                }
+                else if (start == stats.session_start_ms)
+                {
+                    if (price > stats.high)
+                    {
+                        stats.high = price;
+                        changed |= SESSION_HIGH;
+                    }
+                    if (price < stats.low)
+                    {
+                        stats.low = price;
+                        changed |= SESSION_LOW;
+                    }
+                    if (volume > 0)
+                    {
+                        stats.volume += volume;
+                        changed |= SESSION_VOLUME;
+                    }
+                    stats.num_trades++;
+                }
+
+                if (start == stats.session_start_ms)
+                {
+                    stats.last_price = price;
+                    stats.last_volume = volume;
+                    stats.last_trade_ms = std::max(stats.last_trade_ms, timestamp_ms);
+                }
+
+                for (BarRing &ring : state.rings)
+                {
+                    uint64_t bar_start = timestamp_ms - timestamp_ms % ring.interval_ms;
+                    Bar &current = ring.bars[ring.head];
+
+                    if (ring.count == 0 || bar_start > current.start_ms)
+                    {
+                        if (ring.count > 0)
+                            ring.head = (ring.head + 1) % ring.bars.size();
+                        ring.count = std::min(ring.count + 1, ring.bars.size());
+
+                        Bar &bar = ring.bars[ring.head];
+                        bar = Bar();
+                        bar.start_ms = bar_start;
+                        bar.open = bar.high = bar.low = price;
+                        add_trade(bar, price, volume, at_bid_or_ask);
+                    }
+                    else if (bar_start == current.start_ms)
+                    {
+                        add_trade(current, price, volume, at_bid_or_ask);
+                    }
+                }
+
+                if (session)
+                    *session = stats;
+                return changed;
+            }
+
+            bool BarAggregator::get_session(InstrumentId instrument, SessionStats &session) const
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                auto it = symbols_.find(instrument);
+                if (it == symbols_.end())
+                    return false;
+
+                session = it->second.session;
+                return true;
+            }
+
+            std::vector<BarAggregator::Bar> BarAggregator::get_bars(InstrumentId instrument, uint32_t interval_seconds, size_t count) const
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                std::vector<Bar> bars;
+                auto it = symbols_.find(instrument);
+                auto interval = std::find(intervals_.begin(), intervals_.end(), interval_seconds);
+                if (it == symbols_.end() || interval == intervals_.end())
+                    return bars;
+
+                const BarRing &ring = it->second.rings[interval - intervals_.begin()];
+                size_t n = count > 0 ? std::min(count, ring.count) : ring.count;
+                size_t size = ring.bars.size();
+
+                bars.reserve(n);
+                for (size_t i = 0; i < n; i++)
+                    bars.push_back(ring.bars[(ring.head + size - (n - 1) + i) % size]);
+                return bars;
+            }
+
+            std::vector<std::vector<uint8_t>> BarAggregator::encode_session_updates(const SessionStats &session, uint8_t changed)
+            {
+                std::vector<std::vector<uint8_t>> messages;
+                uint64_t session_date = to_dtc_time(session.session_start_ms);
+
+                if (changed & SESSION_OPEN)
+                {
+                    dtc::MarketDataUpdateSessionOpen open;
+                    open.price = session.open;
+                    open.trading_session_date = session_date;
+                    messages.push_back(open.serialize());
+                }
+                if (changed & SESSION_HIGH)
+                {
+                    dtc::MarketDataUpdateSessionHigh high;
+                    high.price = session.high;
+                    high.trading_session_date = session_date;
+                    messages.push_back(high.serialize());
+                }
+                if (changed & SESSION_LOW)
+                {
+                    dtc::MarketDataUpdateSessionLow low;
+                    low.price = session.low;
+                    low.trading_session_date = session_date;
+                    messages.push_back(low.serialize());
+                }
+                if (changed & SESSION_VOLUME)
+                {
+                    dtc::MarketDataUpdateSessionVolume volume;
+                    volume.volume = session.volume;
+                    volume.trading_session_date = session_date;
+                    messages.push_back(volume.serialize());
+                }
+                return messages;
+            }
+
+            std::vector<uint8_t> BarAggregator::encode_snapshot(const SessionStats &session, uint16_t symbol_id)
+            {
+                dtc::MarketDataSnapshot snapshot;
+                snapshot.symbol_id = symbol_id;
+                snapshot.session_open_price = session.open;
+                snapshot.session_high_price = session.high;
+                snapshot.session_low_price = session.low;
+                snapshot.session_volume = session.volume;
+                snapshot.session_num_trades = session.num_trades;
+                snapshot.last_trade_price = session.last_price;
+                snapshot.last_trade_volume = session.last_volume;
+                snapshot.last_trade_date_time = to_dtc_time(session.last_trade_ms);
+                snapshot.trading_session_date = to_dtc_time(session.session_start_ms);
+                return snapshot.serialize();
+            }
+
+            std::vector<uint8_t> BarAggregator::with_symbol_id(std::vector<uint8_t> message, uint16_t symbol_id)
+            {
+                // Session updates and snapshots start with the symbol ID right after the header
+                std::memcpy(message.data() + sizeof(dtc::MessageHeader), &symbol_id, sizeof(uint16_t));
+                return message;
+            }
+
+        } // namespace server
+    } // namespace core
+} // namespace coinbase_dtc_core
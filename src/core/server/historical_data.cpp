@@ -0,0 +1,192 @@
+#include "coinbase_dtc_core/core/server/historical_data.hpp"
+#include "coinbase_dtc_core/core/util/log.hpp"
+#include <algorithm>
+#include <cstring>
+
+#ifdef HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace coinbase_dtc_core
+{
+    namespace core
+    {
+        namespace server
+        {
+            using open_dtc_server::core::dtc::HistoricalPriceDataRecordResponse;
+            using open_dtc_server::core::dtc::HistoricalPriceDataRequest;
+            using open_dtc_server::core::dtc::HistoricalPriceDataResponseHeader;
+            using open_dtc_server::core::dtc::HistoricalPriceDataTickRecordResponse;
+            using open_dtc_server::core::history::TickColumns;
+
+            namespace
+            {
+                constexpr int64_t MICROS_PER_SECOND = 1000000LL;
+                constexpr int64_t SECONDS_PER_DAY = 86400LL;
+            }
+
+            HistoricalDataService::HistoricalDataService(open_dtc_server::core::history::TickStore &store, uint32_t default_max_days)
+                : store_(store), default_max_days_(default_max_days > 0 ? default_max_days : 1)
+            {
+            }
+
+            std::vector<std::vector<uint8_t>> HistoricalDataService::handle_request(const HistoricalPriceDataRequest &request,
+                                                                                    int64_t now_us)
+            {
+                // Resolve the range: end 0 = now, start 0 = max_days_to_return before end
+                int64_t end_us = request.end_date_time > 0 ? request.end_date_time * MICROS_PER_SECOND : now_us;
+                uint32_t max_days = request.max_days_to_return > 0 ? request.max_days_to_return : default_max_days_;
+                int64_t start_us = request.start_date_time > 0
+                                       ? request.start_date_time * MICROS_PER_SECOND
+                                       : end_us - static_cast<int64_t>(max_days) * SECONDS_PER_DAY * MICROS_PER_SECOND;
+
+                TickColumns ticks;
+                store_.read_range(request.symbol, start_us, end_us, ticks);
+
+                std::vector<uint8_t> records;
+                if (request.record_interval > 0)
+                    encode_bars(request.request_id, request.record_interval, ticks, records);
+                else
+                    encode_ticks(request.request_id, ticks, records);
+
+                HistoricalPriceDataResponseHeader header;
+                header.request_id = request.request_id;
+                header.record_interval = request.record_interval;
+                header.no_records_to_return = records.empty() ? 1 : 0;
+
+                std::vector<std::vector<uint8_t>> chunks;
+                if (!records.empty() && request.use_zlib_compression)
+                {
+                    std::vector<std::vector<uint8_t>> compressed;
+                    if (compress(records, compressed))
+                    {
+                        header.use_zlib_compression = 1;
+                        chunks.push_back(header.serialize());
+                        for (auto &chunk : compressed)
+                            chunks.push_back(std::move(chunk));
+                        return chunks;
+                    }
+                }
+
+                chunks.push_back(header.serialize());
+                for (size_t offset = 0; offset < records.size(); offset += CHUNK_SIZE)
+                {
+                    size_t length = std::min(CHUNK_SIZE, records.size() - offset);
+                    chunks.emplace_back(records.begin() + offset, records.begin() + offset + length);
+                }
+                return chunks;
+            }
+
+            void HistoricalDataService::encode_ticks(int32_t request_id, const TickColumns &ticks, std::vector<uint8_t> &out)
+            {
+                if (ticks.empty())
+                    return;
+
+                // Header and request ID are identical for every record, patch the rest in place
+                HistoricalPriceDataTickRecordResponse templ;
+                templ.request_id = request_id;
+                const auto record = templ.serialize();
+                const size_t size = HistoricalPriceDataTickRecordResponse::RECORD_SIZE;
+
+                size_t base = out.size();
+                out.resize(base + ticks.size() * size);
+                uint8_t *dest = out.data() + base;
+                for (size_t i = 0; i < ticks.size(); ++i, dest += size)
+                {
+                    double date_time = static_cast<double>(ticks.time_us[i]) / MICROS_PER_SECOND;
+                    std::memcpy(dest, record.data(), size);
+                    std::memcpy(dest + HistoricalPriceDataTickRecordResponse::DATE_TIME_OFFSET, &date_time, sizeof(double));
+                    std::memcpy(dest + HistoricalPriceDataTickRecordResponse::AT_BID_OR_ASK_OFFSET, &ticks.side[i], sizeof(uint8_t));
+                    std::memcpy(dest + HistoricalPriceDataTickRecordResponse::PRICE_OFFSET, &ticks.price[i], sizeof(double));
+                    std::memcpy(dest + HistoricalPriceDataTickRecordResponse::VOLUME_OFFSET, &ticks.volume[i], sizeof(double));
+                }
+
+                out[out.size() - size + HistoricalPriceDataTickRecordResponse::IS_FINAL_RECORD_OFFSET] = 1;
+            }
+
+            void HistoricalDataService::encode_bars(int32_t request_id, int32_t interval_seconds, const TickColumns &ticks,
+                                                    std::vector<uint8_t> &out)
+            {
+                if (ticks.empty() || interval_seconds <= 0)
+                    return;
+
+                const int64_t interval_us = static_cast<int64_t>(interval_seconds) * MICROS_PER_SECOND;
+                std::vector<HistoricalPriceDataRecordResponse> bars;
+
+                for (size_t i = 0; i < ticks.size(); ++i)
+                {
+                    int64_t bar_start = ticks.time_us[i] - ((ticks.time_us[i] % interval_us) + interval_us) % interval_us;
+                    double price = ticks.price[i];
+
+                    if (bars.empty() || bars.back().start_date_time != bar_start)
+                    {
+                        HistoricalPriceDataRecordResponse bar;
+                        bar.request_id = request_id;
+                        bar.start_date_time = bar_start;
+                        bar.open_price = bar.high_price = bar.low_price = bar.last_price = price;
+                        bars.push_back(bar);
+                    }
+
+                    auto &bar = bars.back();
+                    bar.high_price = std::max(bar.high_price, price);
+                    bar.low_price = std::min(bar.low_price, price);
+                    bar.last_price = price;
+                    bar.volume += ticks.volume[i];
+                    bar.num_trades++;
+                    if (ticks.side[i] == 1)
+                        bar.bid_volume += ticks.volume[i];
+                    else if (ticks.side[i] == 2)
+                        bar.ask_volume += ticks.volume[i];
+                }
+
+                bars.back().is_final_record = 1;
+                for (const auto &bar : bars)
+                {
+                    auto data = bar.serialize();
+                    out.insert(out.end(), data.begin(), data.end());
+                }
+            }
+
+            bool HistoricalDataService::compress(const std::vector<uint8_t> &data, std::vector<std::vector<uint8_t>> &chunks)
+            {
+#ifdef HAS_ZLIB
+                z_stream stream;
+                std::memset(&stream, 0, sizeof(stream));
+                if (deflateInit(&stream, Z_BEST_SPEED) != Z_OK)
+                    return false;
+
+                stream.next_in = const_cast<Bytef *>(data.data());
+                stream.avail_in = static_cast<uInt>(data.size());
+
+                int result = Z_OK;
+                while (result != Z_STREAM_END)
+                {
+                    std::vector<uint8_t> chunk(CHUNK_SIZE);
+                    stream.next_out = chunk.data();
+                    stream.avail_out = static_cast<uInt>(chunk.size());
+
+                    result = deflate(&stream, Z_FINISH);
+                    if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+                    {
+                        deflateEnd(&stream);
+                        open_dtc_server::util::simple_log("[HISTORY] deflate failed: " + std::to_string(result));
+                        return false;
+                    }
+
+                    chunk.resize(CHUNK_SIZE - stream.avail_out);
+                    if (!chunk.empty())
+                        chunks.push_back(std::move(chunk));
+                }
+
+                deflateEnd(&stream);
+                return true;
+#else
+                (void)data;
+                (void)chunks;
+                return false;
+#endif
+            }
+
+        } // namespace server
+    } // namespace core
+} // namespace coinbase_dtc_core
@@ -2,6 +2,7 @@
 #include "coinbase_dtc_core/core/util/advanced_log.hpp"
 #include "coinbase_dtc_core/core/auth/jwt_auth.hpp"
 #include "coinbase_dtc_core/exchanges/base/exchange_feed.hpp"
+#include <algorithm>
 #include <iostream>
 #include <chrono>
 #include <thread>
@@ -44,6 +45,14 @@ int main(int argc, char *argv[])
     std::string credentials_path = "config/cdp_api_key_ECDSA.json"; // Default path
     std::string log_level = "advanced";                             // Default log level
     std::string log_config = "config/logging.ini";                  // Default config path
+    std::string replay_path;                                        // Recorded journal instead of Coinbase
+    double replay_speed = 1.0;
+    std::string capture_file;                                       // Raw Coinbase payload capture
+    size_t ws_connections = 1;                                      // Coinbase WebSocket connections
+    bool redundant_feed = false;                                    // A/B connection pairs
+    bool feed_pipeline = false;                                     // Reader, parser and distribution threads
+    auto pipeline_wait = open_dtc_server::exchanges::base::WaitStrategy::FUTEX;
+    size_t pipeline_capacity = 4096;
 
     for (int i = 1; i < argc; i++)
     {
@@ -63,6 +72,48 @@ int main(int argc, char *argv[])
             log_config = argv[i + 1];
             i++; // Skip next argument as it's the config path
         }
+        else if (arg == "--replay" && i + 1 < argc)
+        {
+            replay_path = argv[i + 1];
+            i++; // Skip next argument as it's the journal directory
+        }
+        else if (arg == "--replay-speed" && i + 1 < argc)
+        {
+            replay_speed = std::stod(argv[i + 1]);
+            i++; // Skip next argument as it's the speed
+        }
+        else if (arg == "--capture" && i + 1 < argc)
+        {
+            capture_file = argv[i + 1];
+            i++; // Skip next argument as it's the capture file
+        }
+        else if (arg == "--ws-connections" && i + 1 < argc)
+        {
+            ws_connections = static_cast<size_t>(std::max(1, std::stoi(argv[i + 1])));
+            i++; // Skip next argument as it's the connection count
+        }
+        else if (arg == "--redundant-feed")
+        {
+            redundant_feed = true;
+        }
+        else if (arg == "--pipeline-wait" && i + 1 < argc)
+        {
+            if (!open_dtc_server::exchanges::base::parse_wait_strategy(argv[i + 1], pipeline_wait))
+            {
+                std::cerr << "Unknown wait strategy: " << argv[i + 1] << " (spin, yield or futex)" << std::endl;
+                return 1;
+            }
+            i++; // Skip next argument as it's the strategy
+        }
+        else if (arg == "--pipeline-capacity" && i + 1 < argc)
+        {
+            pipeline_capacity = static_cast<size_t>(std::max(2, std::stoi(argv[i + 1])));
+            i++; // Skip next argument as it's the slot count
+        }
+        else if (arg == "--pipeline")
+        {
+            feed_pipeline = true;
+        }
         else if (arg == "--help" || arg == "-h")
         {
             std::cout << "Usage: " << argv[0] << " [options]\n";
@@ -70,6 +121,14 @@ int main(int argc, char *argv[])
             std::cout << "  --credentials <path>     Path to CDP API credentials file\n";
             std::cout << "  --loglevel <level>       Log level: std, advanced, verbose (default: advanced)\n";
             std::cout << "  --logconfig <path>       Path to logging configuration file (default: config/logging.ini)\n";
+            std::cout << "  --replay <dir>           Replay a recorded market journal instead of connecting to Coinbase\n";
+            std::cout << "  --replay-speed <n>       Replay speed: 1 = original timing, N = N times faster, 0 = as fast as possible\n";
+            std::cout << "  --capture <file>         Append raw Coinbase WebSocket payloads with receive timestamps to a file\n";
+            std::cout << "  --ws-connections <n>     Spread Coinbase products over n WebSocket connections (default: 1)\n";
+            std::cout << "  --redundant-feed         Two Coinbase connections (A/B) per product set; first copy of each message wins\n";
+            std::cout << "  --pipeline               Separate reader, parser and distribution threads for Coinbase messages\n";
+            std::cout << "  --pipeline-wait <mode>   How idle feed pipeline threads wait: spin, yield, futex (default: futex)\n";
+            std::cout << "  --pipeline-capacity <n>  Slots per feed pipeline ring, rounded up to a power of two (default: 4096)\n";
             std::cout << "  --help, -h              Show this help message\n";
             std::cout << "\nLog Levels:\n";
             std::cout << "  std        - Only errors and critical messages\n";
@@ -176,42 +235,65 @@ int main(int argc, char *argv[])
             LOG_WARN("[WARNING] No valid CDP credentials found - using public data only");
         }
 
-        // Add Coinbase exchange for real market data
-        open_dtc_server::exchanges::base::ExchangeConfig coinbase_config;
-        coinbase_config.name = "coinbase"; // Must match factory name
-        coinbase_config.websocket_url = "wss://ws-feed.exchange.coinbase.com";
-        coinbase_config.api_url = "https://api.exchange.coinbase.com";
-        coinbase_config.port = 443;
-        coinbase_config.requires_auth = has_valid_credentials; // Enable auth if we have credentials
-
-        // Set credentials in config if available
-        if (has_valid_credentials)
+        if (!replay_path.empty())
         {
-            coinbase_config.api_key = extract_api_key_short(credentials.key_id);
-            coinbase_config.secret_key = credentials.private_key;
-            coinbase_config.passphrase = credentials.passphrase;
-            LOG_INFO("[CONFIG] Coinbase exchange configured with authentication (key id " + redact_key_id(credentials.key_id) + ")");
+            // Recorded session replaces the live feed (deterministic benchmarks and incident reproduction)
+            open_dtc_server::exchanges::base::ExchangeConfig replay_config;
+            replay_config.name = "replay"; // Must match factory name
+            replay_config.replay_path = replay_path;
+            replay_config.replay_speed = replay_speed;
+            if (!srv.add_exchange(replay_config))
+            {
+                LOG_ERROR("Failed to add replay exchange for " + replay_path);
+                return 1;
+            }
+            LOG_INFO("[SUCCESS] Replaying recorded market data from " + replay_path);
         }
         else
         {
-            LOG_INFO("[CONFIG] Coinbase exchange configured for public data only");
-        }
-        LOG_TRACE("[DEBUG] Coinbase config prepared");
+            // Add Coinbase exchange for real market data
+            open_dtc_server::exchanges::base::ExchangeConfig coinbase_config;
+            coinbase_config.name = "coinbase"; // Must match factory name
+            coinbase_config.websocket_url = "wss://ws-feed.exchange.coinbase.com";
+            coinbase_config.api_url = "https://api.exchange.coinbase.com";
+            coinbase_config.port = 443;
+            coinbase_config.requires_auth = has_valid_credentials; // Enable auth if we have credentials
+            coinbase_config.capture_file = capture_file;
+            coinbase_config.websocket_connections = ws_connections;
+            coinbase_config.redundant_feed = redundant_feed;
+            coinbase_config.feed_pipeline = feed_pipeline;
+            coinbase_config.pipeline_wait = pipeline_wait;
+            coinbase_config.pipeline_capacity = pipeline_capacity;
 
-        LOG_TRACE("[DEBUG] Adding Coinbase exchange to server...");
-        if (!srv.add_exchange(coinbase_config))
-        {
-            LOG_WARN("Warning: Failed to add Coinbase exchange - continuing with mock data");
-        }
-        else
-        {
-            LOG_INFO("[SUCCESS] Added Coinbase exchange for real market data");
+            // Set credentials in config if available
+            if (has_valid_credentials)
+            {
+                coinbase_config.api_key = extract_api_key_short(credentials.key_id);
+                coinbase_config.secret_key = credentials.private_key;
+                coinbase_config.passphrase = credentials.passphrase;
+                LOG_INFO("[CONFIG] Coinbase exchange configured with authentication (key id " + redact_key_id(credentials.key_id) + ")");
+            }
+            else
+            {
+                LOG_INFO("[CONFIG] Coinbase exchange configured for public data only");
+            }
+            LOG_TRACE("[DEBUG] Coinbase config prepared");
 
-            LOG_TRACE("[DEBUG] Subscribing to BTC-USD...");
-            // Subscribe to specific symbols for testing
-            srv.subscribe_symbol("BTC-USD", "coinbase");
-            LOG_TRACE("[DEBUG] Symbol subscription completed");
-            // Removed ETH-USD and SOL-USD to keep logs clean for testing
+            LOG_TRACE("[DEBUG] Adding Coinbase exchange to server...");
+            if (!srv.add_exchange(coinbase_config))
+            {
+                LOG_WARN("Warning: Failed to add Coinbase exchange - continuing with mock data");
+            }
+            else
+            {
+                LOG_INFO("[SUCCESS] Added Coinbase exchange for real market data");
+
+                LOG_TRACE("[DEBUG] Subscribing to BTC-USD...");
+                // Subscribe to specific symbols for testing
+                srv.subscribe_symbol("BTC-USD", "coinbase");
+                LOG_TRACE("[DEBUG] Symbol subscription completed");
+                // Removed ETH-USD and SOL-USD to keep logs clean for testing
+            }
         }
         LOG_INFO("Server configured, starting...");
 
@@ -0,0 +1,260 @@
+#include "coinbase_dtc_core/core/server/market_depth.hpp"
+#include "coinbase_dtc_core/core/dtc/protocol.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace coinbase_dtc_core
+{
+    namespace core
+    {
+        namespace server
+        {
+            using open_dtc_server::exchanges::base::BookDelta;
+            using open_dtc_server::exchanges::base::BookSide;
+            using open_dtc_server::exchanges::base::InstrumentId;
+            using open_dtc_server::exchanges::base::MarketDepthUpdate;
+            namespace dtc = open_dtc_server::core::dtc;
+
+            namespace
+            {
+                uint64_t to_dtc_time(uint64_t timestamp_us)
+                {
+                    return timestamp_us > 0 ? timestamp_us : dtc::Protocol::get_current_timestamp_us();
+                }
+
+                uint8_t to_dtc_update_type(BookDelta::Type type)
+                {
+                    switch (type)
+                    {
+                    case BookDelta::Type::INSERT:
+                        return static_cast<uint8_t>(dtc::DepthUpdateTypeEnum::DEPTH_INSERT);
+                    case BookDelta::Type::UPDATE:
+                        return static_cast<uint8_t>(dtc::DepthUpdateTypeEnum::DEPTH_UPDATE);
+                    case BookDelta::Type::DELETE:
+                        return static_cast<uint8_t>(dtc::DepthUpdateTypeEnum::DEPTH_DELETE);
+                    default:
+                        return static_cast<uint8_t>(dtc::DepthUpdateTypeEnum::DEPTH_UNSET);
+                    }
+                }
+            } // namespace
+
+            MarketDepthDistributor::MarketDepthDistributor(uint16_t max_levels)
+                : max_levels_(max_levels > 0 ? max_levels : 1)
+            {
+            }
+
+            std::vector<std::vector<uint8_t>> MarketDepthDistributor::subscribe(InstrumentId instrument, int client_id,
+                                                                                uint16_t symbol_id, uint16_t levels)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                levels = std::max<uint16_t>(1, std::min(levels, max_levels_));
+
+                auto &depth = symbols_[instrument];
+                auto it = std::find_if(depth.subscribers.begin(), depth.subscribers.end(),
+                                       [client_id](const Subscriber &s)
+                                       { return s.client_id == client_id; });
+                if (it != depth.subscribers.end())
+                {
+                    it->symbol_id = symbol_id;
+                    it->levels = levels;
+                }
+                else
+                {
+                    depth.subscribers.push_back({client_id, symbol_id, levels});
+                }
+
+                return build_snapshot(depth, symbol_id, levels, dtc::Protocol::get_current_timestamp_us());
+            }
+
+            void MarketDepthDistributor::unsubscribe(InstrumentId instrument, int client_id)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                auto it = symbols_.find(instrument);
+                if (it == symbols_.end())
+                    return;
+
+                auto &subscribers = it->second.subscribers;
+                subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(),
+                                                 [client_id](const Subscriber &s)
+                                                 { return s.client_id == client_id; }),
+                                  subscribers.end());
+            }
+
+            void MarketDepthDistributor::remove_client(int client_id)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                for (auto &entry : symbols_)
+                {
+                    auto &subscribers = entry.second.subscribers;
+                    subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(),
+                                                     [client_id](const Subscriber &s)
+                                                     { return s.client_id == client_id; }),
+                                      subscribers.end());
+                }
+            }
+
+            std::vector<MarketDepthDistributor::OutgoingMessage> MarketDepthDistributor::apply(const MarketDepthUpdate &update)
+            {
+                std::vector<OutgoingMessage> outgoing;
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                auto &depth = symbols_[update.instrument];
+                uint64_t date_time = to_dtc_time(update.exchange_time_us);
+
+                if (update.action == MarketDepthUpdate::Action::SNAPSHOT)
+                {
+                    depth.book = update.book ? *update.book : open_dtc_server::exchanges::base::OrderBook();
+                    for (const auto &subscriber : depth.subscribers)
+                    {
+                        for (auto &message : build_snapshot(depth, subscriber.symbol_id, subscriber.levels, date_time))
+                            outgoing.push_back({subscriber.client_id, std::move(message)});
+                    }
+                    return outgoing;
+                }
+
+                // Feeds that keep their own book hand over the positioned delta; replay it
+                // instead of searching again, and only diff raw changes ourselves
+                BookSide side = update.is_bid ? BookSide::BID : BookSide::ASK;
+                BookDelta delta = update.delta;
+                if (delta.type == BookDelta::Type::NONE || !depth.book.apply_delta(delta))
+                {
+                    delta = depth.book.apply(side, update.price, update.size);
+                }
+                side = delta.side;
+                if (delta.type == BookDelta::Type::NONE || depth.subscribers.empty())
+                    return outgoing;
+
+                // Below the deepest window anyone can subscribe to: only the mirror changes,
+                // and DTC positions are 16 bits
+                if (delta.position >= max_levels_)
+                    return outgoing;
+
+                // Diff once; subscribers only differ by symbol ID and visible window
+                std::vector<uint8_t> shared = encode_update(side, delta.position, to_dtc_update_type(delta.type),
+                                                            delta.price, delta.size, date_time);
+
+                // Window-edge messages depend only on the subscriber's level count
+                std::vector<std::pair<uint16_t, std::vector<uint8_t>>> edge_cache;
+                size_t book_depth = depth.book.depth(side);
+
+                for (const auto &subscriber : depth.subscribers)
+                {
+                    if (delta.position >= subscriber.levels)
+                        continue;
+
+                    outgoing.push_back({subscriber.client_id, with_symbol_id(shared, subscriber.symbol_id)});
+
+                    // An insert pushes the last visible level out; a delete pulls the next one in
+                    bool pushes_out = (delta.type == BookDelta::Type::INSERT && book_depth > subscriber.levels);
+                    bool pulls_in = (delta.type == BookDelta::Type::DELETE && book_depth >= subscriber.levels);
+                    if (!pushes_out && !pulls_in)
+                        continue;
+
+                    auto cached = std::find_if(edge_cache.begin(), edge_cache.end(),
+                                               [&subscriber](const std::pair<uint16_t, std::vector<uint8_t>> &entry)
+                                               { return entry.first == subscriber.levels; });
+                    if (cached == edge_cache.end())
+                    {
+                        uint16_t position = pushes_out ? subscriber.levels : static_cast<uint16_t>(subscriber.levels - 1);
+                        const auto *level = depth.book.level(side, position);
+                        auto type = pushes_out ? dtc::DepthUpdateTypeEnum::DEPTH_DELETE : dtc::DepthUpdateTypeEnum::DEPTH_INSERT;
+                        edge_cache.emplace_back(subscriber.levels,
+                                                encode_update(side, position, static_cast<uint8_t>(type),
+                                                              level->price, pushes_out ? 0.0 : level->size, date_time));
+                        cached = edge_cache.end() - 1;
+                    }
+
+                    outgoing.push_back({subscriber.client_id, with_symbol_id(cached->second, subscriber.symbol_id)});
+                }
+
+                return outgoing;
+            }
+
+            size_t MarketDepthDistributor::get_subscriber_count(InstrumentId instrument) const
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                auto it = symbols_.find(instrument);
+                return it != symbols_.end() ? it->second.subscribers.size() : 0;
+            }
+
+            bool MarketDepthDistributor::get_book(InstrumentId instrument, open_dtc_server::exchanges::base::OrderBook &book) const
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                auto it = symbols_.find(instrument);
+                if (it == symbols_.end())
+                    return false;
+                book = it->second.book;
+                return true;
+            }
+
+            std::vector<uint8_t> MarketDepthDistributor::encode_update(BookSide side, uint16_t position, uint8_t update_type,
+                                                                       double price, double size, uint64_t date_time)
+            {
+                dtc::MarketDepthIncrementalUpdate message;
+                message.symbol_id = 0; // Patched per subscriber
+                message.side = static_cast<uint8_t>(side);
+                message.position = position;
+                message.update_type = update_type;
+                message.price = price;
+                message.size = size;
+                message.date_time = date_time;
+                return message.serialize();
+            }
+
+            std::vector<uint8_t> MarketDepthDistributor::with_symbol_id(std::vector<uint8_t> message, uint16_t symbol_id)
+            {
+                // Every depth message starts with the symbol ID right after the header
+                std::memcpy(message.data() + sizeof(dtc::MessageHeader), &symbol_id, sizeof(uint16_t));
+                return message;
+            }
+
+            std::vector<std::vector<uint8_t>> MarketDepthDistributor::build_snapshot(const SymbolDepth &depth, uint16_t symbol_id,
+                                                                                     uint16_t levels, uint64_t date_time) const
+            {
+                std::vector<dtc::MarketDepthSnapshot> entries;
+
+                for (BookSide side : {BookSide::BID, BookSide::ASK})
+                {
+                    size_t count = std::min<size_t>(levels, depth.book.depth(side));
+                    for (size_t position = 0; position < count; ++position)
+                    {
+                        const auto *level = depth.book.level(side, position);
+
+                        dtc::MarketDepthSnapshot entry;
+                        entry.symbol_id = symbol_id;
+                        entry.side = static_cast<uint8_t>(side);
+                        entry.level = static_cast<uint16_t>(position);
+                        entry.price = level->price;
+                        entry.quantity = level->size;
+                        entry.date_time = date_time;
+                        entries.push_back(entry);
+                    }
+                }
+
+                // An empty book is still sent so the client clears its DOM
+                if (entries.empty())
+                {
+                    dtc::MarketDepthSnapshot entry;
+                    entry.symbol_id = symbol_id;
+                    entry.date_time = date_time;
+                    entries.push_back(entry);
+                }
+
+                entries.front().is_first_message_in_batch = 1;
+                entries.back().is_last_message_in_batch = 1;
+
+                std::vector<std::vector<uint8_t>> messages;
+                messages.reserve(entries.size());
+                for (const auto &entry : entries)
+                    messages.push_back(entry.serialize());
+                return messages;
+            }
+
+        } // namespace server
+    } // namespace core
+} // namespace coinbase_dtc_core
@@ -0,0 +1,465 @@
+#include "coinbase_dtc_core/core/server/order_gateway.hpp"
+#include "coinbase_dtc_core/core/util/advanced_log.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <iterator>
+
+namespace coinbase_dtc_core
+{
+    namespace core
+    {
+        namespace server
+        {
+            namespace dtc = open_dtc_server::core::dtc;
+            using open_dtc_server::exchanges::base::OrderResponse;
+            using open_dtc_server::exchanges::base::OrderTransport;
+
+            namespace
+            {
+                constexpr size_t LATENCY_WINDOW = 4096;
+                constexpr uint64_t SECONDS_PER_DAY = 24 * 60 * 60;
+                // Sends of one order before its state is left to the user channel
+                constexpr int RECONCILE_ATTEMPTS = 3;
+
+                // Coinbase takes decimal strings; %.15g keeps 0.01 as "0.01"
+                std::string to_decimal(double value)
+                {
+                    char buffer[32];
+                    std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+                    return buffer;
+                }
+
+                std::string to_rfc3339(uint64_t seconds)
+                {
+                    std::time_t time = static_cast<std::time_t>(seconds);
+                    std::tm utc{};
+#ifdef _WIN32
+                    gmtime_s(&utc, &time);
+#else
+                    gmtime_r(&time, &utc);
+#endif
+                    char buffer[32];
+                    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &utc);
+                    return buffer;
+                }
+
+                // Prefer the most specific reason Coinbase gives
+                std::string error_text(const nlohmann::json &reply)
+                {
+                    const nlohmann::json &error = reply.contains("error_response") ? reply["error_response"] : reply;
+                    for (const char *key : {"message", "error_details", "preview_failure_reason", "error"})
+                    {
+                        if (error.contains(key) && error[key].is_string() && !error[key].get<std::string>().empty())
+                            return error[key].get<std::string>();
+                    }
+                    return std::string();
+                }
+            } // namespace
+
+            OrderGateway::OrderGateway(std::unique_ptr<OrderTransport> transport, SendCallback send,
+                                       size_t max_pending, std::chrono::milliseconds keep_warm_interval)
+                : transport_(std::move(transport)), send_(std::move(send)),
+                  max_pending_(max_pending > 0 ? max_pending : 1), keep_warm_interval_(keep_warm_interval),
+                  latencies_us_(LATENCY_WINDOW, 0)
+            {
+                worker_ = std::thread(&OrderGateway::worker_loop, this);
+            }
+
+            OrderGateway::~OrderGateway()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(queue_mutex_);
+                    stopping_ = true;
+                }
+                queue_cv_.notify_all();
+                if (worker_.joinable())
+                    worker_.join();
+            }
+
+            std::vector<uint8_t> OrderGateway::submit(int client_id, const dtc::SubmitNewSingleOrder &order)
+            {
+                PendingOrder pending;
+                pending.client_id = client_id;
+                pending.order = order;
+                pending.received = std::chrono::steady_clock::now();
+                pending.received_date_time = dtc::Protocol::get_current_timestamp();
+
+                // Coinbase needs a unique client_order_id; it doubles as the DTC server order ID
+                pending.server_order_id = "dtc-" + std::to_string(pending.received_date_time) + "-" +
+                                          std::to_string(next_order_id_.fetch_add(1));
+
+                std::string error;
+                if (!build_order_request(order, pending.server_order_id, pending.body, error))
+                {
+                    std::lock_guard<std::mutex> lock(stats_mutex_);
+                    counters_.rejected++;
+                    return encode_update(pending, dtc::OrderStatusEnum::ORDER_STATUS_REJECTED, std::string(), error);
+                }
+
+                std::vector<uint8_t> update;
+                {
+                    std::lock_guard<std::mutex> lock(queue_mutex_);
+                    if (stopping_ || queue_.size() >= max_pending_)
+                    {
+                        std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+                        counters_.rejected++;
+                        return encode_update(pending, dtc::OrderStatusEnum::ORDER_STATUS_REJECTED, std::string(),
+                                             stopping_ ? "Order entry is shutting down" : "Too many pending orders");
+                    }
+                    // Numbered and observed before the worker can see the order, so the exchange reply always follows it
+                    update = encode_update(pending, dtc::OrderStatusEnum::ORDER_STATUS_PENDING_OPEN, std::string(), std::string());
+                    queue_.push_back(std::move(pending));
+                }
+                queue_cv_.notify_one();
+
+                {
+                    std::lock_guard<std::mutex> lock(stats_mutex_);
+                    counters_.submitted++;
+                }
+                return update;
+            }
+
+            void OrderGateway::worker_loop()
+            {
+                // Open the connection and sign the first token before any order arrives
+                bool connected = transport_->keep_warm();
+
+                while (true)
+                {
+                    PendingOrder pending;
+                    {
+                        std::unique_lock<std::mutex> lock(queue_mutex_);
+
+                        // Unanswered orders go first, once the transport reports it is back
+                        if (connected && !unanswered_.empty())
+                        {
+                            queue_.insert(queue_.begin(), std::make_move_iterator(unanswered_.begin()),
+                                          std::make_move_iterator(unanswered_.end()));
+                            unanswered_.clear();
+                        }
+
+                        auto idle = unanswered_.empty() ? keep_warm_interval_ : std::min(keep_warm_interval_, RECONNECT_INTERVAL);
+                        if (!queue_cv_.wait_for(lock, idle, [this]
+                                                { return stopping_ || !queue_.empty(); }))
+                        {
+                            lock.unlock();
+                            connected = transport_->keep_warm();
+                            continue;
+                        }
+                        if (queue_.empty())
+                            break; // Stopping with nothing left to send
+
+                        pending = std::move(queue_.front());
+                        queue_.pop_front();
+                    }
+
+                    OrderResponse response = transport_->submit_order(pending.body);
+                    auto latency_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                                          std::chrono::steady_clock::now() - pending.received)
+                                          .count();
+
+                    std::string exchange_order_id, error;
+                    bool accepted = parse_order_response(response, exchange_order_id, error);
+                    bool replied = response.status_code > 0;
+                    bool retry = !replied && ++pending.attempts < RECONCILE_ATTEMPTS;
+                    {
+                        std::lock_guard<std::mutex> lock(stats_mutex_);
+                        if (accepted)
+                            counters_.acknowledged++;
+                        else if (replied)
+                            counters_.rejected++;
+                        else
+                            counters_.failed++;
+                        if (!replied && !retry)
+                            counters_.unresolved++;
+                    }
+                    if (replied)
+                        record_latency(static_cast<uint64_t>(latency_us));
+
+                    // The order may have reached the exchange: it stays pending, never rejected, until a reply settles it
+                    dtc::OrderStatusEnum status = dtc::OrderStatusEnum::ORDER_STATUS_PENDING_OPEN;
+                    std::string info_text = error;
+                    if (accepted)
+                        status = dtc::OrderStatusEnum::ORDER_STATUS_OPEN;
+                    else if (replied)
+                        status = dtc::OrderStatusEnum::ORDER_STATUS_REJECTED;
+                    else if (retry)
+                        info_text = "No reply from exchange (" + error + "), checking order state";
+                    else
+                        info_text = "Order state unknown after " + std::to_string(pending.attempts) + " attempts (" + error + ")";
+
+                    // Only the first missed reply and the outcome reach the client
+                    if (send_ && (!retry || pending.attempts == 1))
+                        send_(pending.client_id, encode_update(pending, status, exchange_order_id, info_text));
+
+                    LOG_INFO("[ORDERS] " + pending.server_order_id + " " + pending.order.symbol +
+                             (accepted ? " accepted as " + exchange_order_id : replied ? " rejected: " + error : " no reply: " + error) +
+                             " in " + std::to_string(latency_us) + "us");
+
+                    if (retry)
+                    {
+                        // Sent again under the same client_order_id once the transport has reconnected
+                        pending.last_error = error;
+                        std::lock_guard<std::mutex> lock(queue_mutex_);
+                        unanswered_.push_back(std::move(pending));
+                    }
+
+                    // Sign the next token now rather than on the next order; also says whether a resend can go
+                    connected = transport_->keep_warm();
+                }
+
+                // Stopped before the transport came back: what these orders did is left to the user channel
+                std::deque<PendingOrder> abandoned;
+                {
+                    std::lock_guard<std::mutex> lock(queue_mutex_);
+                    abandoned.swap(unanswered_);
+                }
+                for (const auto &pending : abandoned)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(stats_mutex_);
+                        counters_.unresolved++;
+                    }
+                    if (send_)
+                    {
+                        send_(pending.client_id, encode_update(pending, dtc::OrderStatusEnum::ORDER_STATUS_PENDING_OPEN, std::string(),
+                                                               "Order state unknown after " + std::to_string(pending.attempts) +
+                                                                   " attempts (" + pending.last_error + ")"));
+                    }
+                }
+            }
+
+            void OrderGateway::record_latency(uint64_t latency_us)
+            {
+                std::lock_guard<std::mutex> lock(stats_mutex_);
+                latencies_us_[latency_next_] = static_cast<uint32_t>(std::min<uint64_t>(latency_us, UINT32_MAX));
+                latency_next_ = (latency_next_ + 1) % latencies_us_.size();
+                counters_.latency_samples++;
+                latency_total_us_ += static_cast<double>(latency_us);
+                counters_.latency_max_us = std::max(counters_.latency_max_us, latency_us);
+            }
+
+            OrderGateway::Stats OrderGateway::get_stats() const
+            {
+                Stats stats;
+                std::vector<uint32_t> window;
+                {
+                    std::lock_guard<std::mutex> lock(stats_mutex_);
+                    stats = counters_;
+                    size_t count = static_cast<size_t>(std::min<uint64_t>(counters_.latency_samples, latencies_us_.size()));
+                    window.assign(latencies_us_.begin(), latencies_us_.begin() + count);
+                    if (counters_.latency_samples > 0)
+                        stats.latency_mean_us = latency_total_us_ / static_cast<double>(counters_.latency_samples);
+                }
+                {
+                    std::lock_guard<std::mutex> lock(queue_mutex_);
+                    stats.pending = queue_.size() + unanswered_.size();
+                }
+
+                if (!window.empty())
+                {
+                    std::sort(window.begin(), window.end());
+                    stats.latency_p50_us = window[(window.size() - 1) / 2];
+                    stats.latency_p99_us = window[(window.size() - 1) * 99 / 100];
+                }
+                return stats;
+            }
+
+            bool OrderGateway::build_order_request(const dtc::SubmitNewSingleOrder &order, const std::string &client_order_id,
+                                                   std::string &body, std::string &error)
+            {
+                if (order.symbol.empty())
+                {
+                    error = "Order has no symbol";
+                    return false;
+                }
+                if (order.buy_sell != dtc::BuySellEnum::BUY && order.buy_sell != dtc::BuySellEnum::SELL)
+                {
+                    error = "Order side must be buy or sell";
+                    return false;
+                }
+                if (!(order.quantity > 0))
+                {
+                    error = "Order quantity must be positive";
+                    return false;
+                }
+
+                bool good_till_date = order.time_in_force == dtc::TimeInForceEnum::TIF_GOOD_TILL_DATE_TIME;
+                uint64_t end_time = order.good_till_date_time;
+                if (order.time_in_force == dtc::TimeInForceEnum::TIF_DAY)
+                {
+                    // Coinbase has no day orders; expire at the end of the UTC day
+                    uint64_t now = dtc::Protocol::get_current_timestamp();
+                    end_time = now - now % SECONDS_PER_DAY + SECONDS_PER_DAY;
+                    good_till_date = true;
+                }
+                if (good_till_date && end_time <= dtc::Protocol::get_current_timestamp())
+                {
+                    error = "Good-till date/time is in the past";
+                    return false;
+                }
+
+                nlohmann::json configuration;
+                std::string base_size = to_decimal(order.quantity);
+                switch (order.order_type)
+                {
+                case dtc::OrderTypeEnum::ORDER_TYPE_MARKET:
+                    configuration["market_market_ioc"] = {{"base_size", base_size}};
+                    break;
+
+                case dtc::OrderTypeEnum::ORDER_TYPE_LIMIT:
+                {
+                    if (!(order.price1 > 0))
+                    {
+                        error = "Limit order needs a positive price";
+                        return false;
+                    }
+                    nlohmann::json limit = {{"base_size", base_size}, {"limit_price", to_decimal(order.price1)}};
+                    if (order.time_in_force == dtc::TimeInForceEnum::TIF_IMMEDIATE_OR_CANCEL)
+                    {
+                        configuration["sor_limit_ioc"] = limit;
+                    }
+                    else if (order.time_in_force == dtc::TimeInForceEnum::TIF_FILL_OR_KILL)
+                    {
+                        configuration["limit_limit_fok"] = limit;
+                    }
+                    else if (good_till_date)
+                    {
+                        limit["end_time"] = to_rfc3339(end_time);
+                        limit["post_only"] = false;
+                        configuration["limit_limit_gtd"] = limit;
+                    }
+                    else
+                    {
+                        limit["post_only"] = false;
+                        configuration["limit_limit_gtc"] = limit;
+                    }
+                    break;
+                }
+
+                case dtc::OrderTypeEnum::ORDER_TYPE_STOP_LIMIT:
+                {
+                    // DTC: price1 = stop, price2 = limit
+                    if (!(order.price1 > 0) || !(order.price2 > 0))
+                    {
+                        error = "Stop-limit order needs positive stop and limit prices";
+                        return false;
+                    }
+                    nlohmann::json stop = {{"base_size", base_size},
+                                           {"limit_price", to_decimal(order.price2)},
+                                           {"stop_price", to_decimal(order.price1)},
+                                           {"stop_direction", order.buy_sell == dtc::BuySellEnum::BUY ? "STOP_DIRECTION_STOP_UP" : "STOP_DIRECTION_STOP_DOWN"}};
+                    if (good_till_date)
+                    {
+                        stop["end_time"] = to_rfc3339(end_time);
+                        configuration["stop_limit_stop_limit_gtd"] = stop;
+                    }
+                    else
+                    {
+                        configuration["stop_limit_stop_limit_gtc"] = stop;
+                    }
+                    break;
+                }
+
+                default:
+                    error = "Order type not supported by Coinbase";
+                    return false;
+                }
+
+                nlohmann::json request = {{"client_order_id", client_order_id},
+                                          {"product_id", order.symbol},
+                                          {"side", order.buy_sell == dtc::BuySellEnum::BUY ? "BUY" : "SELL"},
+                                          {"order_configuration", configuration}};
+                body = request.dump();
+                return true;
+            }
+
+            bool OrderGateway::parse_order_response(const OrderResponse &response, std::string &exchange_order_id, std::string &error)
+            {
+                if (response.status_code <= 0)
+                {
+                    error = response.error_message.empty() ? "No reply from exchange" : response.error_message;
+                    return false;
+                }
+
+                nlohmann::json reply = nlohmann::json::parse(response.body, nullptr, false);
+                if (reply.is_discarded() || !reply.is_object())
+                {
+                    error = "HTTP " + std::to_string(response.status_code) + ": unreadable reply";
+                    return false;
+                }
+
+                if (response.status_code == 200 && reply.value("success", false))
+                {
+                    const auto &success = reply.contains("success_response") ? reply["success_response"] : reply;
+                    exchange_order_id = success.value("order_id", std::string());
+                    if (!exchange_order_id.empty())
+                        return true;
+                }
+
+                error = error_text(reply);
+                if (error.empty())
+                    error = "HTTP " + std::to_string(response.status_code);
+                return false;
+            }
+
+            std::vector<uint8_t> OrderGateway::encode_reject(const dtc::SubmitNewSingleOrder &order, const std::string &reason)
+            {
+                dtc::OrderUpdate update;
+                update.total_num_messages = 1;
+                update.message_number = 1;
+                update.symbol = order.symbol;
+                update.exchange = order.exchange;
+                update.client_order_id = order.client_order_id;
+                update.order_status = dtc::OrderStatusEnum::ORDER_STATUS_REJECTED;
+                update.order_type = order.order_type;
+                update.buy_sell = order.buy_sell;
+                update.price1 = order.price1;
+                update.price2 = order.price2;
+                update.order_quantity = order.quantity;
+                update.time_in_force = order.time_in_force;
+                update.good_till_date_time = order.good_till_date_time;
+                update.order_received_date_time = dtc::Protocol::get_current_timestamp();
+                update.trade_account = order.trade_account;
+                update.free_form_text = order.free_form_text;
+                update.info_text = reason;
+                return update.serialize();
+            }
+
+            std::vector<uint8_t> OrderGateway::encode_update(const PendingOrder &pending, dtc::OrderStatusEnum status,
+                                                             const std::string &exchange_order_id, const std::string &info_text)
+            {
+                const auto &order = pending.order;
+
+                dtc::OrderUpdate update;
+                update.total_num_messages = 1;
+                update.message_number = 1;
+                update.symbol = order.symbol;
+                update.exchange = order.exchange;
+                update.server_order_id = pending.server_order_id;
+                update.client_order_id = order.client_order_id;
+                update.exchange_order_id = exchange_order_id;
+                update.order_status = status;
+                update.order_type = order.order_type;
+                update.buy_sell = order.buy_sell;
+                update.price1 = order.price1;
+                update.price2 = order.price2;
+                update.order_quantity = order.quantity;
+                update.remaining_quantity = status == dtc::OrderStatusEnum::ORDER_STATUS_REJECTED ? 0.0 : order.quantity;
+                update.order_received_date_time = pending.received_date_time;
+                update.time_in_force = order.time_in_force;
+                update.good_till_date_time = order.good_till_date_time;
+                update.order_update_sequence_number = update_sequence_.fetch_add(1);
+                update.free_form_text = order.free_form_text;
+                update.trade_account = order.trade_account;
+                update.info_text = info_text;
+                if (observer_)
+                    observer_(update);
+                return update.serialize();
+            }
+
+        } // namespace server
+    } // namespace core
+} // namespace coinbase_dtc_core
@@ -0,0 +1,378 @@
+#include "coinbase_dtc_core/core/server/order_store.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace coinbase_dtc_core
+{
+    namespace core
+    {
+        namespace server
+        {
+            namespace dtc = open_dtc_server::core::dtc;
+            namespace base = open_dtc_server::exchanges::base;
+
+            namespace
+            {
+                // Quantities below this are rounding noise, not fills
+                constexpr double QUANTITY_EPSILON = 1e-12;
+
+                // DTC DateTime fields carry seconds
+                uint64_t to_dtc_time(uint64_t timestamp_ms)
+                {
+                    return timestamp_ms / 1000;
+                }
+
+                dtc::OrderStatusEnum to_dtc_status(base::OrderState state, double filled_quantity)
+                {
+                    switch (state)
+                    {
+                    case base::OrderState::PENDING:
+                        return dtc::OrderStatusEnum::ORDER_STATUS_PENDING_OPEN;
+                    case base::OrderState::OPEN:
+                        return filled_quantity > QUANTITY_EPSILON ? dtc::OrderStatusEnum::ORDER_STATUS_PARTIALLY_FILLED
+                                                                  : dtc::OrderStatusEnum::ORDER_STATUS_OPEN;
+                    case base::OrderState::FILLED:
+                        return dtc::OrderStatusEnum::ORDER_STATUS_FILLED;
+                    case base::OrderState::CANCELED:
+                    case base::OrderState::EXPIRED:
+                        return dtc::OrderStatusEnum::ORDER_STATUS_CANCELED;
+                    case base::OrderState::REJECTED:
+                        return dtc::OrderStatusEnum::ORDER_STATUS_REJECTED;
+                    default:
+                        return dtc::OrderStatusEnum::ORDER_STATUS_UNSPECIFIED;
+                    }
+                }
+
+                dtc::OrderTypeEnum to_dtc_type(base::OrderKind kind)
+                {
+                    switch (kind)
+                    {
+                    case base::OrderKind::MARKET:
+                        return dtc::OrderTypeEnum::ORDER_TYPE_MARKET;
+                    case base::OrderKind::LIMIT:
+                        return dtc::OrderTypeEnum::ORDER_TYPE_LIMIT;
+                    case base::OrderKind::STOP:
+                        return dtc::OrderTypeEnum::ORDER_TYPE_STOP;
+                    case base::OrderKind::STOP_LIMIT:
+                        return dtc::OrderTypeEnum::ORDER_TYPE_STOP_LIMIT;
+                    default:
+                        return dtc::OrderTypeEnum::ORDER_TYPE_UNSET;
+                    }
+                }
+
+                void erase_index(std::unordered_map<std::string, std::string> &index, const std::string &id, const std::string &server_order_id)
+                {
+                    if (id.empty())
+                        return;
+                    auto it = index.find(id);
+                    if (it != index.end() && it->second == server_order_id)
+                        index.erase(it);
+                }
+            } // namespace
+
+            OrderStore::OrderStore(size_t max_closed_orders)
+                : max_closed_orders_(max_closed_orders)
+            {
+            }
+
+            bool OrderStore::is_closed(dtc::OrderStatusEnum status)
+            {
+                return status == dtc::OrderStatusEnum::ORDER_STATUS_FILLED ||
+                       status == dtc::OrderStatusEnum::ORDER_STATUS_CANCELED ||
+                       status == dtc::OrderStatusEnum::ORDER_STATUS_REJECTED;
+            }
+
+            void OrderStore::record(const dtc::OrderUpdate &update)
+            {
+                if (update.server_order_id.empty())
+                    return;
+
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                auto previous = dtc::OrderStatusEnum::ORDER_STATUS_UNSPECIFIED;
+                auto it = orders_.find(update.server_order_id);
+                if (it == orders_.end())
+                {
+                    it = orders_.emplace(update.server_order_id, update).first;
+                    it->second.request_id = 0;
+                }
+                else
+                {
+                    // The exchange stream can report an order before the gateway sees its reply;
+                    // keep the stream's state and take only what the DTC client supplied
+                    auto &order = it->second;
+                    previous = order.order_status;
+                    erase_index(by_client_order_id_, order.client_order_id, order.server_order_id);
+                    order.client_order_id = update.client_order_id;
+                    order.trade_account = update.trade_account;
+                    order.free_form_text = update.free_form_text;
+                    order.time_in_force = update.time_in_force;
+                    order.good_till_date_time = update.good_till_date_time;
+                    if (!update.exchange.empty())
+                        order.exchange = update.exchange;
+                    if (order.exchange_order_id.empty())
+                        order.exchange_order_id = update.exchange_order_id;
+                    if (order.order_status == dtc::OrderStatusEnum::ORDER_STATUS_UNSPECIFIED ||
+                        order.order_status == dtc::OrderStatusEnum::ORDER_STATUS_PENDING_OPEN)
+                    {
+                        order.order_status = update.order_status;
+                        order.info_text = update.info_text;
+                    }
+                }
+
+                const auto &order = it->second;
+                if (!order.client_order_id.empty())
+                    by_client_order_id_[order.client_order_id] = order.server_order_id;
+                if (!order.exchange_order_id.empty())
+                    by_exchange_order_id_[order.exchange_order_id] = order.server_order_id;
+                track_status(order.server_order_id, previous, order.order_status);
+            }
+
+            bool OrderStore::apply(const base::OrderEvent &event, dtc::OrderUpdate &update)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return apply_locked(event, &update);
+            }
+
+            const std::string *OrderStore::find_key(const base::OrderEvent &event) const
+            {
+                auto by_exchange = by_exchange_order_id_.find(event.order_id);
+                if (by_exchange != by_exchange_order_id_.end())
+                    return &by_exchange->second;
+
+                // Gateway orders use their server order ID as the exchange client_order_id
+                auto by_server = orders_.find(event.client_order_id);
+                if (!event.client_order_id.empty() && by_server != orders_.end())
+                    return &by_server->first;
+
+                return nullptr;
+            }
+
+            bool OrderStore::apply_locked(const base::OrderEvent &event, dtc::OrderUpdate *update)
+            {
+                if (event.order_id.empty())
+                    return false;
+
+                const std::string *key = find_key(event);
+                bool known = key != nullptr;
+                dtc::OrderUpdate *order = nullptr;
+
+                if (known)
+                {
+                    order = &orders_[*key];
+                }
+                else
+                {
+                    // Placed outside this server: the exchange client_order_id is unique, so it serves as the server ID
+                    std::string server_order_id = event.client_order_id.empty() ? event.order_id : event.client_order_id;
+                    order = &orders_[server_order_id];
+                    order->server_order_id = server_order_id;
+                    order->client_order_id = event.client_order_id;
+                    order->symbol = event.symbol;
+                    order->exchange = "coinbase";
+                    order->buy_sell = event.is_buy ? dtc::BuySellEnum::BUY : dtc::BuySellEnum::SELL;
+                    order->order_received_date_time = to_dtc_time(event.created_time_ms);
+                    order->total_num_messages = 1;
+                    order->message_number = 1;
+                    if (!order->client_order_id.empty())
+                        by_client_order_id_[order->client_order_id] = server_order_id;
+                }
+
+                if (order->exchange_order_id.empty())
+                {
+                    order->exchange_order_id = event.order_id;
+                    by_exchange_order_id_[event.order_id] = order->server_order_id;
+                }
+
+                if (order->order_type == dtc::OrderTypeEnum::ORDER_TYPE_UNSET)
+                {
+                    // Same price layout the gateway accepts: stop in price1, limit in price2 for stop-limits
+                    order->order_type = to_dtc_type(event.kind);
+                    order->price1 = event.kind == base::OrderKind::STOP || event.kind == base::OrderKind::STOP_LIMIT ? event.stop_price : event.limit_price;
+                    order->price2 = event.kind == base::OrderKind::STOP_LIMIT ? event.limit_price : 0.0;
+                }
+
+                auto previous = known ? order->order_status : dtc::OrderStatusEnum::ORDER_STATUS_UNSPECIFIED;
+                bool changed = !known;
+
+                if (event.quantity > QUANTITY_EPSILON && std::abs(event.quantity - order->order_quantity) > QUANTITY_EPSILON)
+                {
+                    order->order_quantity = event.quantity;
+                    changed = true;
+                }
+
+                double previous_filled = order->filled_quantity;
+                if (event.filled_quantity > previous_filled + QUANTITY_EPSILON)
+                {
+                    // Only cumulative figures are reported; recover the latest fill from the deltas
+                    double fill_quantity = event.filled_quantity - previous_filled;
+                    double fill_notional = event.average_fill_price * event.filled_quantity - order->average_fill_price * previous_filled;
+                    order->last_fill_quantity = fill_quantity;
+                    order->last_fill_price = previous_filled > QUANTITY_EPSILON ? fill_notional / fill_quantity : event.average_fill_price;
+                    order->last_fill_date_time = dtc::Protocol::get_current_timestamp();
+                    order->filled_quantity = event.filled_quantity;
+                    order->average_fill_price = event.average_fill_price;
+                    changed = true;
+                }
+                order->remaining_quantity = std::max(0.0, order->order_quantity - order->filled_quantity);
+
+                // A close the exchange reported is final, so a late snapshot cannot reopen the order;
+                // a rejection the gateway recorded without an exchange reply is overridden
+                auto status = to_dtc_status(event.state, order->filled_quantity);
+                bool confirmed = exchange_closed_.count(order->server_order_id) > 0;
+                if (status != dtc::OrderStatusEnum::ORDER_STATUS_UNSPECIFIED && status != order->order_status && !confirmed)
+                {
+                    order->order_status = status;
+                    changed = true;
+                }
+                if (!confirmed && is_closed(status) && status == order->order_status)
+                    exchange_closed_.insert(order->server_order_id);
+
+                if (!changed)
+                    return false;
+
+                order->order_update_sequence_number++;
+                order->info_text.clear();
+                if (update)
+                    *update = *order;
+
+                track_status(order->server_order_id, previous, order->order_status);
+                return true;
+            }
+
+            size_t OrderStore::bootstrap(const std::vector<base::OrderEvent> &orders, const std::vector<base::FillEvent> &fills)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                size_t added = 0;
+                for (const auto &event : orders)
+                {
+                    if (!find_key(event) && apply_locked(event, nullptr))
+                        added++;
+                }
+
+                for (const auto &fill : fills)
+                {
+                    auto key = by_exchange_order_id_.find(fill.order_id);
+                    if (key == by_exchange_order_id_.end())
+                        continue;
+
+                    // Fills arrive newest first; keep the latest per order
+                    auto &order = orders_[key->second];
+                    uint64_t fill_time = to_dtc_time(fill.time_ms);
+                    if (order.last_fill_quantity <= QUANTITY_EPSILON || fill_time > order.last_fill_date_time)
+                    {
+                        order.last_fill_price = fill.price;
+                        order.last_fill_quantity = fill.quantity;
+                        order.last_fill_date_time = fill_time;
+                    }
+                }
+                return added;
+            }
+
+            void OrderStore::track_status(const std::string &server_order_id, dtc::OrderStatusEnum previous, dtc::OrderStatusEnum status)
+            {
+                if (!is_closed(status))
+                {
+                    open_.insert(server_order_id);
+                    return;
+                }
+                if (is_closed(previous))
+                    return;
+
+                open_.erase(server_order_id);
+                closed_.push_back(server_order_id);
+
+                while (closed_.size() > max_closed_orders_)
+                {
+                    std::string oldest = std::move(closed_.front());
+                    closed_.pop_front();
+
+                    auto it = orders_.find(oldest);
+                    if (it == orders_.end() || !is_closed(it->second.order_status))
+                        continue;
+                    erase_index(by_client_order_id_, it->second.client_order_id, oldest);
+                    erase_index(by_exchange_order_id_, it->second.exchange_order_id, oldest);
+                    exchange_closed_.erase(oldest);
+                    orders_.erase(it);
+                }
+            }
+
+            bool OrderStore::find_by_server_order_id(const std::string &server_order_id, dtc::OrderUpdate &order) const
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = orders_.find(server_order_id);
+                if (it == orders_.end())
+                    return false;
+                order = it->second;
+                return true;
+            }
+
+            bool OrderStore::find_by_client_order_id(const std::string &client_order_id, dtc::OrderUpdate &order) const
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto key = by_client_order_id_.find(client_order_id);
+                if (key == by_client_order_id_.end())
+                    return false;
+                auto it = orders_.find(key->second);
+                if (it == orders_.end())
+                    return false;
+                order = it->second;
+                return true;
+            }
+
+            std::vector<dtc::OrderUpdate> OrderStore::get_open_orders() const
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                std::vector<dtc::OrderUpdate> result;
+                result.reserve(open_.size());
+                for (const auto &server_order_id : open_)
+                {
+                    auto it = orders_.find(server_order_id);
+                    if (it != orders_.end())
+                        result.push_back(it->second);
+                }
+                return result;
+            }
+
+            size_t OrderStore::size() const
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return orders_.size();
+            }
+
+            size_t OrderStore::open_count() const
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return open_.size();
+            }
+
+            std::vector<std::vector<uint8_t>> OrderStore::encode_open_orders(const std::vector<dtc::OrderUpdate> &orders, uint32_t request_id)
+            {
+                std::vector<std::vector<uint8_t>> messages;
+                if (orders.empty())
+                {
+                    dtc::OrderUpdate none;
+                    none.request_id = request_id;
+                    none.total_num_messages = 1;
+                    none.message_number = 1;
+                    none.no_orders = 1;
+                    messages.push_back(none.serialize());
+                    return messages;
+                }
+
+                messages.reserve(orders.size());
+                int32_t number = 1;
+                for (auto order : orders)
+                {
+                    order.request_id = request_id;
+                    order.total_num_messages = static_cast<int32_t>(orders.size());
+                    order.message_number = number++;
+                    messages.push_back(order.serialize());
+                }
+                return messages;
+            }
+
+        } // namespace server
+    } // namespace core
+} // namespace coinbase_dtc_core
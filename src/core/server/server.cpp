@@ -2,6 +2,8 @@
 #include "coinbase_dtc_core/core/util/log.hpp"
 #include "coinbase_dtc_core/exchanges/factory/exchange_factory.hpp"
 #include "coinbase_dtc_core/exchanges/coinbase/rest_client.hpp"
+#include "coinbase_dtc_core/exchanges/coinbase/order_client.hpp"
+#include "coinbase_dtc_core/exchanges/coinbase/endpoint.hpp"
 #include "coinbase_dtc_core/exchanges/coinbase/coinbase_feed.hpp"
 #include "coinbase_dtc_core/core/auth/cdp_credentials.hpp"
 #include "coinbase_dtc_core/core/auth/jwt_auth.hpp"
@@ -35,6 +37,33 @@ namespace coinbase_dtc_core
             {
                 std::cout << "DTCServer initialized with config: " + config_.server_name << std::endl;
 
+                depth_distributor_ = std::make_unique<MarketDepthDistributor>(config_.max_market_depth_levels);
+
+                if (config_.enable_bar_aggregation)
+                {
+                    bar_aggregator_ = std::make_unique<BarAggregator>(config_.bar_intervals_seconds, config_.bar_history,
+                                                                      config_.session_start_offset_seconds);
+                }
+
+                // Consolidated book is published like any other exchange, keyed by normalized symbol
+                consolidated_book_ = std::make_unique<open_dtc_server::exchanges::base::ConsolidatedBook>();
+                consolidated_book_->set_depth_callback([this](const open_dtc_server::exchanges::base::MarketDepthUpdate &update)
+                                                       { this->on_depth_data(update); });
+                consolidated_book_->set_level2_callback([this](const open_dtc_server::exchanges::base::MarketLevel2 &level2)
+                                                        { this->on_level2_data(level2); });
+                // Symbols start merging from the books the distributor already mirrors
+                consolidated_book_->set_book_source([this](open_dtc_server::exchanges::base::InstrumentId instrument,
+                                                           open_dtc_server::exchanges::base::OrderBook &book)
+                                                    {
+                                                        std::lock_guard<std::mutex> depth_lock(depth_mutex_);
+                                                        return depth_distributor_->get_book(instrument, book); });
+
+                if (config_.enable_historical_data)
+                {
+                    tick_store_ = std::make_unique<open_dtc_server::core::history::TickStore>(config_.tick_store_path);
+                    historical_data_ = std::make_unique<HistoricalDataService>(*tick_store_, config_.historical_max_days);
+                }
+
                 // Initialize REST client for Coinbase API access
                 try
                 {
@@ -43,6 +72,31 @@ namespace coinbase_dtc_core
                     {
                         rest_client_ = std::make_unique<open_dtc_server::exchanges::coinbase::CoinbaseRestClient>(credentials);
                         std::cout << "Coinbase REST client initialized successfully" << std::endl;
+
+                        if (config_.enable_order_tracking)
+                        {
+                            order_store_ = std::make_unique<OrderStore>(config_.max_closed_orders);
+                            user_feed_ = std::make_unique<open_dtc_server::exchanges::coinbase::CoinbaseUserFeed>(credentials);
+                            user_feed_->set_order_callback([this](const open_dtc_server::exchanges::base::OrderEvent &event)
+                                                           { this->on_order_event(event); });
+                        }
+
+                        if (config_.enable_order_entry)
+                        {
+                            auto transport = std::make_unique<open_dtc_server::exchanges::coinbase::CoinbaseOrderClient>(
+                                credentials, config_.order_entry_sandbox ? open_dtc_server::endpoints::SANDBOX_BASE : open_dtc_server::endpoints::TRADE_BASE);
+                            order_gateway_ = std::make_unique<OrderGateway>(
+                                std::move(transport),
+                                [this](int client_id, const std::vector<uint8_t> &message)
+                                { this->send_to_client(client_id, message); },
+                                config_.max_pending_orders);
+                            if (order_store_)
+                            {
+                                order_gateway_->set_update_observer([this](const open_dtc_server::core::dtc::OrderUpdate &update)
+                                                                    { order_store_->record(update); });
+                            }
+                            std::cout << "Order entry enabled" << (config_.order_entry_sandbox ? " (sandbox)" : "") << std::endl;
+                        }
                     }
                     else
                     {
@@ -58,6 +112,14 @@ namespace coinbase_dtc_core
             DTCServer::~DTCServer()
             {
                 stop();
+
+                // Feeds report their disconnect to this server: release them while its members still exist
+                std::unordered_map<std::string, std::unique_ptr<open_dtc_server::exchanges::base::ExchangeFeedBase>> feeds;
+                {
+                    std::lock_guard<std::mutex> lock(exchanges_mutex_);
+                    feeds.swap(exchange_feeds_);
+                }
+                feeds.clear();
                 std::cout << "DTCServer destroyed" << std::endl;
             }
 
@@ -92,6 +154,8 @@ namespace coinbase_dtc_core
                 // Start server thread
                 server_thread_ = std::thread(&DTCServer::server_thread_function, this);
 
+                start_order_tracking();
+
                 std::cout << "DTC Server started successfully on port " + std::to_string(config_.port) << std::endl;
                 return true;
             }
@@ -112,6 +176,11 @@ namespace coinbase_dtc_core
                 // Close server socket to break accept() loop
                 close_server_socket();
 
+                if (user_feed_)
+                {
+                    user_feed_->disconnect();
+                }
+
                 // Wait for server thread to finish
                 if (server_thread_.joinable())
                 {
@@ -130,6 +199,44 @@ namespace coinbase_dtc_core
                 std::cout << "DTC Server stopped" << std::endl;
             }
 
+            void DTCServer::start_order_tracking()
+            {
+                if (!order_store_ || !user_feed_)
+                {
+                    return;
+                }
+
+                // Stream first, then history: anything that changes during the bootstrap is already
+                // known from the stream, and bootstrap never overwrites known orders
+                if (!user_feed_->connect())
+                {
+                    std::cout << "[WARNING] Coinbase user channel unavailable - exchange order updates will not be pushed" << std::endl;
+                }
+
+                std::vector<open_dtc_server::exchanges::base::OrderEvent> orders;
+                std::vector<open_dtc_server::exchanges::base::FillEvent> fills;
+                if (rest_client_ && rest_client_->get_open_orders(orders))
+                {
+                    rest_client_->get_fills(fills);
+                    size_t added = order_store_->bootstrap(orders, fills);
+                    std::cout << "Order state bootstrapped: " << added << " open orders from history, "
+                              << order_store_->open_count() << " open in total" << std::endl;
+                }
+                else
+                {
+                    std::cout << "[WARNING] Open order bootstrap failed" << (rest_client_ ? ": " + rest_client_->get_last_error() : std::string()) << std::endl;
+                }
+            }
+
+            void DTCServer::on_order_event(const open_dtc_server::exchanges::base::OrderEvent &event)
+            {
+                open_dtc_server::core::dtc::OrderUpdate update;
+                if (order_store_ && order_store_->apply(event, update))
+                {
+                    broadcast_to_all_clients(update.serialize());
+                }
+            }
+
             bool DTCServer::add_exchange(const open_dtc_server::exchanges::base::ExchangeConfig &exchange_config)
             {
                 std::cout << "Adding exchange: " + exchange_config.name << std::endl;
@@ -151,6 +258,34 @@ namespace coinbase_dtc_core
                     feed->set_level2_callback([this](const open_dtc_server::exchanges::base::MarketLevel2 &level2)
                                               { this->on_level2_data(level2); });
 
+                    feed->set_depth_callback([this](const open_dtc_server::exchanges::base::MarketDepthUpdate &update)
+                                             {
+                                                 this->on_depth_data(update);
+
+                                                 // Merged under the instrument's normalized symbol; a no-op without consolidated subscribers
+                                                 consolidated_book_->apply(update); });
+
+                    feed->set_connection_callback([this](bool connected, const std::string &exchange)
+                                                  { this->on_exchange_connection(connected, exchange); });
+
+                    feed->set_error_callback([this](const std::string &error, const std::string &exchange)
+                                             { this->on_exchange_error(error, exchange); });
+
+                    if (config_.enable_market_journal)
+                    {
+                        open_dtc_server::exchanges::base::JournalConfig journal_config;
+                        journal_config.directory = config_.market_journal_path + "/" + exchange_config.name;
+                        journal_config.records_per_segment = config_.market_journal_segment_records;
+                        journal_config.retain_segments = config_.market_journal_retain_segments;
+                        journal_config.sync_policy = config_.market_journal_sync;
+
+                        auto journal = std::make_shared<open_dtc_server::exchanges::base::MarketJournal>(journal_config);
+                        if (journal->open())
+                            feed->set_recorder(journal);
+                        else
+                            std::cout << "[WARNING] Market journal disabled for exchange: " + exchange_config.name << std::endl;
+                    }
+
                     // Connect to the exchange
                     if (!feed->connect())
                     {
@@ -216,6 +351,25 @@ namespace coinbase_dtc_core
                 status << "  Port: " << config_.port << "\n";
                 status << "  Server Name: " << config_.server_name << "\n";
                 status << "  Client Count: " << get_client_count() << "\n";
+                if (order_gateway_)
+                {
+                    auto orders = order_gateway_->get_stats();
+                    status << "  Orders: " << orders.submitted << " submitted, " << orders.acknowledged << " acknowledged, "
+                           << orders.rejected << " rejected, " << orders.failed << " failed, " << orders.unresolved << " unknown, " << orders.pending << " pending\n";
+                    status << "  Order Ack Latency (us): mean " << static_cast<uint64_t>(orders.latency_mean_us) << ", p50 " << orders.latency_p50_us
+                           << ", p99 " << orders.latency_p99_us << ", max " << orders.latency_max_us << "\n";
+                }
+                if (order_store_)
+                {
+                    status << "  Tracked Orders: " << order_store_->size() << " (" << order_store_->open_count() << " open), user channel "
+                           << (user_feed_ && user_feed_->is_connected() ? "connected" : "disconnected") << "\n";
+                }
+                uint64_t latency_samples = feed_latency_samples_.load(std::memory_order_relaxed);
+                if (latency_samples > 0)
+                {
+                    status << "  Feed Latency (us): mean " << feed_latency_total_us_.load(std::memory_order_relaxed) / latency_samples
+                           << ", max " << feed_latency_max_us_.load(std::memory_order_relaxed) << " over " << latency_samples << " trades\n";
+                }
                 return status.str();
             }
 
@@ -339,6 +493,8 @@ namespace coinbase_dtc_core
 #else
                 if (server_socket_ >= 0)
                 {
+                    // Closing alone does not wake a thread blocked in accept() on Linux
+                    shutdown(server_socket_, SHUT_RDWR);
                     close(server_socket_);
                     server_socket_ = -1;
                 }
@@ -472,6 +628,15 @@ namespace coinbase_dtc_core
 
             void DTCServer::remove_client(std::shared_ptr<ClientConnection> client)
             {
+                // Consolidated symbols stop merging with their last subscriber
+                for (const auto &entry : client->get_session().instrument_to_id)
+                    consolidated_book_->untrack(entry.first);
+
+                {
+                    std::lock_guard<std::mutex> depth_lock(depth_mutex_);
+                    depth_distributor_->remove_client(client->get_client_id());
+                }
+
                 std::lock_guard<std::mutex> lock(clients_mutex_);
                 clients_.erase(std::remove(clients_.begin(), clients_.end(), client), clients_.end());
             }
@@ -482,8 +647,36 @@ namespace coinbase_dtc_core
 
             void DTCServer::on_trade_data(const open_dtc_server::exchanges::base::MarketTrade &trade)
             {
+                // AtBidOrAsk: sell hits the bid, buy lifts the ask
+                using open_dtc_server::exchanges::base::TradeSide;
+                uint8_t side = trade.side == TradeSide::BUY ? 2 : (trade.side == TradeSide::SELL ? 1 : 0);
+
+                // Clients and stores key by the wire spelling; resolved once, no copy
+                const std::string &symbol = open_dtc_server::exchanges::base::SymbolRegistry::getInstance().exchange_symbol(trade.instrument);
+
+                // Exchange time goes to every client as is; feeds fill it, so no clock read per client
+                uint64_t date_time = trade.exchange_time_us ? trade.exchange_time_us
+                                                            : open_dtc_server::core::dtc::Protocol::get_current_timestamp_us();
+                record_feed_latency(trade.exchange_time_us, trade.receive_time_us);
+
+                // Record every trade for historical requests
+                if (tick_store_ && !symbol.empty() && trade.price > 0)
+                {
+                    tick_store_->append(symbol, static_cast<int64_t>(date_time), trade.price, trade.volume, side);
+                }
+
+                // Session statistics: encoded once, sent only for the fields this trade changed
+                std::vector<std::vector<uint8_t>> session_updates;
+                if (bar_aggregator_)
+                {
+                    BarAggregator::SessionStats session;
+                    uint8_t changed = bar_aggregator_->on_trade(trade.instrument, trade.price, trade.volume, date_time / 1000, side, &session);
+                    if (changed)
+                        session_updates = BarAggregator::encode_session_updates(session, changed);
+                }
+
                 // Broadcast trade data to connected clients via DTC protocol
-                if (trade.symbol.empty() == false && trade.price > 0)
+                if (symbol.empty() == false && trade.price > 0)
                 {
                     std::lock_guard<std::mutex> lock(clients_mutex_);
 
@@ -497,39 +690,58 @@ namespace coinbase_dtc_core
                         if (!client || !client->is_connected())
                             continue;
 
-                        auto &subscriptions = client->get_session().subscribed_symbols;
-                        if (std::find(subscriptions.begin(), subscriptions.end(), trade.symbol) != subscriptions.end())
-                        {
-                            // Get symbol ID for this client
-                            auto symbol_id_it = client->get_session().symbol_to_id.find(trade.symbol);
-                            if (symbol_id_it != client->get_session().symbol_to_id.end())
-                            {
-                                // Create trade update message
-                                auto trade_update = protocol.create_trade_update(
-                                    symbol_id_it->second,                                         // symbol_id
-                                    trade.price,                                                  // price
-                                    trade.volume,                                                 // volume
-                                    open_dtc_server::core::dtc::Protocol::get_current_timestamp() // timestamp
-                                );
-
-                                auto message_data = protocol.create_message(*trade_update);
-                                client->send_message(message_data);
-                                broadcasts++;
-                            }
-                        }
+                        // One integer lookup per client: subscriptions are keyed by instrument
+                        auto &subscriptions = client->get_session().instrument_to_id;
+                        auto symbol_id_it = subscriptions.find(trade.instrument);
+                        if (symbol_id_it == subscriptions.end())
+                            continue;
+
+                        // Create trade update message
+                        auto trade_update = protocol.create_trade_update(
+                            symbol_id_it->second, // symbol_id
+                            trade.price,          // price
+                            trade.volume,         // volume
+                            date_time             // exchange time, microseconds
+                        );
+
+                        auto message_data = protocol.create_message(*trade_update);
+                        client->send_message(message_data);
+
+                        for (const auto &update : session_updates)
+                            client->send_message(BarAggregator::with_symbol_id(update, static_cast<uint16_t>(symbol_id_it->second)));
+                        broadcasts++;
                     }
 
                     if (broadcasts > 0)
                     {
-                        std::cout << "[TRADE] Trade broadcasted: " + trade.symbol + " = $" + std::to_string(trade.price) + " to " + std::to_string(broadcasts) + " clients" << std::endl;
+                        std::cout << "[TRADE] Trade broadcasted: " + symbol + " = $" + std::to_string(trade.price) + " to " + std::to_string(broadcasts) + " clients" << std::endl;
                     }
                 }
             }
 
+            void DTCServer::record_feed_latency(uint64_t exchange_time_us, uint64_t receive_time_us)
+            {
+                // Only real exchange times; feeds without one copy the receive time
+                if (exchange_time_us == 0 || receive_time_us <= exchange_time_us)
+                    return;
+
+                uint64_t latency = receive_time_us - exchange_time_us;
+                feed_latency_samples_.fetch_add(1, std::memory_order_relaxed);
+                feed_latency_total_us_.fetch_add(latency, std::memory_order_relaxed);
+                uint64_t max = feed_latency_max_us_.load(std::memory_order_relaxed);
+                while (latency > max && !feed_latency_max_us_.compare_exchange_weak(max, latency, std::memory_order_relaxed))
+                {
+                }
+            }
+
             void DTCServer::on_level2_data(const open_dtc_server::exchanges::base::MarketLevel2 &level2)
             {
+                const std::string &symbol = open_dtc_server::exchanges::base::SymbolRegistry::getInstance().exchange_symbol(level2.instrument);
+                uint64_t date_time = level2.exchange_time_us ? level2.exchange_time_us
+                                                             : open_dtc_server::core::dtc::Protocol::get_current_timestamp_us();
+
                 // Broadcast level2 data to connected clients
-                if (level2.symbol.empty() == false)
+                if (symbol.empty() == false)
                 {
                     std::lock_guard<std::mutex> lock(clients_mutex_);
 
@@ -543,61 +755,115 @@ namespace coinbase_dtc_core
                         if (!client || !client->is_connected())
                             continue;
 
-                        auto &subscriptions = client->get_session().subscribed_symbols;
-                        if (std::find(subscriptions.begin(), subscriptions.end(), level2.symbol) != subscriptions.end())
+                        auto &subscriptions = client->get_session().instrument_to_id;
+                        auto symbol_id_it = subscriptions.find(level2.instrument);
+                        if (symbol_id_it == subscriptions.end())
+                            continue;
+
+                        // If best bid/ask are available, send top-of-book update
+                        if (level2.bid_price > 0.0 || level2.ask_price > 0.0)
                         {
-                            // Get symbol ID for this client
-                            auto symbol_id_it = client->get_session().symbol_to_id.find(level2.symbol);
-                            if (symbol_id_it != client->get_session().symbol_to_id.end())
-                            {
-                                // If best bid/ask are available, send top-of-book update
-                                if (level2.bid_price > 0.0 || level2.ask_price > 0.0)
-                                {
-                                    auto bid_ask_update = protocol.create_bid_ask_update(
-                                        symbol_id_it->second,
-                                        level2.bid_price,
-                                        static_cast<float>(level2.bid_size),
-                                        level2.ask_price,
-                                        static_cast<float>(level2.ask_size),
-                                        open_dtc_server::core::dtc::Protocol::get_current_timestamp());
-                                    auto message_data = protocol.create_message(*bid_ask_update);
-                                    client->send_message(message_data);
-                                }
-                                // Additionally emit DOM incremental updates per side when sizes are provided
-                                if (level2.bid_price > 0.0 && level2.bid_size >= 0.0)
-                                {
-                                    open_dtc_server::core::dtc::MarketDepthIncrementalUpdate dom;
-                                    dom.symbol_id = symbol_id_it->second;
-                                    dom.side = 1;     // Bid
-                                    dom.position = 0; // Best level for now
-                                    dom.price = level2.bid_price;
-                                    dom.size = level2.bid_size;
-                                    dom.date_time = open_dtc_server::core::dtc::Protocol::get_current_timestamp();
-                                    client->send_message(dom.serialize());
-                                }
-                                if (level2.ask_price > 0.0 && level2.ask_size >= 0.0)
-                                {
-                                    open_dtc_server::core::dtc::MarketDepthIncrementalUpdate dom;
-                                    dom.symbol_id = symbol_id_it->second;
-                                    dom.side = 2;     // Ask
-                                    dom.position = 0; // Best level for now
-                                    dom.price = level2.ask_price;
-                                    dom.size = level2.ask_size;
-                                    dom.date_time = open_dtc_server::core::dtc::Protocol::get_current_timestamp();
-                                    client->send_message(dom.serialize());
-                                }
-                                broadcasts++;
-                            }
+                            auto bid_ask_update = protocol.create_bid_ask_update(
+                                symbol_id_it->second,
+                                level2.bid_price,
+                                static_cast<float>(level2.bid_size),
+                                level2.ask_price,
+                                static_cast<float>(level2.ask_size),
+                                date_time);
+                            auto message_data = protocol.create_message(*bid_ask_update);
+                            client->send_message(message_data);
                         }
+                        broadcasts++;
                     }
 
                     if (broadcasts > 0)
                     {
-                        std::cout << "[LEVEL2] Level2 broadcasted: " + level2.symbol + " Bid=$" + std::to_string(level2.bid_price) + " Ask=$" + std::to_string(level2.ask_price) + " (DOM incremental emitted) to " + std::to_string(broadcasts) + " clients" << std::endl;
+                        std::cout << "[LEVEL2] Level2 broadcasted: " + symbol + " Bid=$" + std::to_string(level2.bid_price) + " Ask=$" + std::to_string(level2.ask_price) + " to " + std::to_string(broadcasts) + " clients" << std::endl;
+                    }
+                }
+            }
+
+            void DTCServer::on_depth_data(const open_dtc_server::exchanges::base::MarketDepthUpdate &update)
+            {
+                if (update.instrument == open_dtc_server::exchanges::base::NO_INSTRUMENT)
+                    return;
+
+                // Book change is diffed once; distributor returns per-client copies
+                std::lock_guard<std::mutex> depth_lock(depth_mutex_);
+                auto outgoing = depth_distributor_->apply(update);
+                if (outgoing.empty())
+                    return;
+
+                std::lock_guard<std::mutex> lock(clients_mutex_);
+                std::unordered_map<int, std::shared_ptr<ClientConnection>> recipients;
+                for (const auto &client : clients_)
+                {
+                    if (client && client->is_connected())
+                        recipients[client->get_client_id()] = client;
+                }
+
+                for (const auto &message : outgoing)
+                {
+                    auto it = recipients.find(message.client_id);
+                    if (it != recipients.end())
+                        it->second->send_message(message.data);
+                }
+            }
+
+            void DTCServer::broadcast_to_all_clients(const std::vector<uint8_t> &message)
+            {
+                std::lock_guard<std::mutex> lock(clients_mutex_);
+                for (const auto &client : clients_)
+                {
+                    if (client && client->is_connected())
+                        client->send_message(message);
+                }
+            }
+
+            void DTCServer::send_to_client(int client_id, const std::vector<uint8_t> &message)
+            {
+                std::lock_guard<std::mutex> lock(clients_mutex_);
+                for (const auto &client : clients_)
+                {
+                    if (client && client->is_connected() && client->get_client_id() == client_id)
+                    {
+                        client->send_message(message);
+                        return;
                     }
                 }
             }
 
+            bool DTCServer::subscribe_consolidated(const std::string &normalized_symbol)
+            {
+                std::lock_guard<std::mutex> lock(exchanges_mutex_);
+
+                bool any_subscribed = false;
+                for (auto &entry : exchange_feeds_)
+                {
+                    auto &feed = entry.second;
+                    std::string exchange_symbol = feed->exchange_symbol(normalized_symbol);
+                    if (feed->subscribe_level2(exchange_symbol))
+                    {
+                        any_subscribed = true;
+                    }
+                    else
+                    {
+                        std::cout << "[DTC-SERVER] " << entry.first << " has no level2 for " << exchange_symbol << std::endl;
+                    }
+                }
+                return any_subscribed;
+            }
+
+            open_dtc_server::exchanges::base::ExchangeFeedBase *DTCServer::market_data_feed_locked(const std::string &exchange)
+            {
+                auto it = exchange_feeds_.find(exchange);
+                if (it != exchange_feeds_.end())
+                    return it->second.get();
+
+                // Clients name the exchange they know (or none); a single feed, live or replayed, serves them all
+                return exchange_feeds_.size() == 1 ? exchange_feeds_.begin()->second.get() : nullptr;
+            }
+
             void DTCServer::on_exchange_connection(bool connected, const std::string &exchange)
             {
                 if (connected)
@@ -608,6 +874,38 @@ namespace coinbase_dtc_core
                 {
                     std::cout << "Exchange disconnected: " + exchange << std::endl;
                 }
+
+                // Called from the feed's threads: exchanges_mutex_ may be held by whoever is waiting on them
+                bool available = true;
+                {
+                    std::lock_guard<std::mutex> lock(exchange_status_mutex_);
+                    exchange_connected_[exchange] = connected;
+                    for (const auto &entry : exchange_connected_)
+                        available = available && entry.second;
+                    if (available == market_data_feed_available_)
+                        return;
+                    market_data_feed_available_ = available;
+                }
+
+                std::cout << "[DTC-SERVER] Market data feed " << (available ? "available" : "unavailable") << std::endl;
+                open_dtc_server::core::dtc::Protocol protocol;
+                broadcast_to_all_clients(protocol.create_market_data_feed_status(available)->serialize());
+                if (!available || !bar_aggregator_)
+                    return;
+
+                // Session values may have moved while trades were missed; depth snapshots follow from the feed's resync
+                std::lock_guard<std::mutex> lock(clients_mutex_);
+                for (const auto &client : clients_)
+                {
+                    if (!client || !client->is_connected())
+                        continue;
+                    for (const auto &subscription : client->get_session().instrument_to_id)
+                    {
+                        BarAggregator::SessionStats session;
+                        bar_aggregator_->get_session(subscription.first, session);
+                        client->send_message(BarAggregator::encode_snapshot(session, static_cast<uint16_t>(subscription.second)));
+                    }
+                }
             }
 
             void DTCServer::on_exchange_error(const std::string &error, const std::string &exchange)
@@ -639,9 +937,10 @@ namespace coinbase_dtc_core
                     auto logon_response = protocol.create_logon_response(true, "Login successful");
                     logon_response->server_name = config_.server_name;
                     logon_response->market_depth_updates_best_bid_and_ask = 1;
-                    logon_response->trading_is_supported = 1;
+                    logon_response->trading_is_supported = order_gateway_ ? 1 : 0;
                     logon_response->security_definitions_supported = 1;
                     logon_response->market_depth_is_supported = 1;
+                    logon_response->historical_price_data_supported = historical_data_ ? 1 : 0;
 
                     // Serialize and send response
                     auto response_data = protocol.create_message(*logon_response);
@@ -767,6 +1066,8 @@ namespace coinbase_dtc_core
                     std::cout << "[DTC-SERVER] Symbol ID: " << market_req->symbol_id << std::endl;
 
                     bool success = false;
+                    // Instruments the request added or removed; depth follows them once the response is out
+                    std::vector<open_dtc_server::exchanges::base::InstrumentId> instruments;
 
                     // Add symbol to client's subscription list only if subscription succeeds
                     if (market_req->request_action == open_dtc_server::core::dtc::RequestAction::SUBSCRIBE)
@@ -781,20 +1082,45 @@ namespace coinbase_dtc_core
                         client->get_session().symbol_to_id[market_req->symbol] = market_req->symbol_id;
                         client->get_session().id_to_symbol[market_req->symbol_id] = market_req->symbol;
 
-                        // Subscribe to Coinbase WebSocket for this specific symbol
-                        std::lock_guard<std::mutex> lock(exchanges_mutex_);
-                        auto feed_it = exchange_feeds_.find("coinbase");
-                        if (feed_it != exchange_feeds_.end())
+                        if (market_req->exchange == open_dtc_server::exchanges::base::CONSOLIDATED_EXCHANGE)
                         {
-                            auto coinbase_feed = dynamic_cast<open_dtc_server::exchanges::coinbase::CoinbaseFeed *>(feed_it->second.get());
-                            if (coinbase_feed)
+                            // Synthetic exchange: merged book of every feed quoting this normalized symbol
+                            success = subscribe_consolidated(market_req->symbol);
+                            if (success)
+                            {
+                                // Same spelling ConsolidatedBook registers its merged instruments under
+                                auto instrument = open_dtc_server::exchanges::base::SymbolRegistry::getInstance().intern(
+                                    open_dtc_server::exchanges::base::CONSOLIDATED_EXCHANGE, market_req->symbol, market_req->symbol);
+                                if (client->get_session().instrument_to_id.insert_or_assign(instrument, market_req->symbol_id).second)
+                                {
+                                    consolidated_book_->track(instrument);
+                                }
+                                instruments.push_back(instrument);
+                                auto &subscriptions = client->get_session().subscribed_symbols;
+                                if (std::find(subscriptions.begin(), subscriptions.end(), market_req->symbol) == subscriptions.end())
+                                {
+                                    subscriptions.push_back(market_req->symbol);
+                                }
+                                std::cout << "[DTC-SERVER] *** SUBSCRIPTION SUCCESS (CONSOLIDATED) *** Client " << client->get_client_id() << " subscribed to " << market_req->symbol << std::endl;
+                            }
+                        }
+                        else
+                        {
+                            // Subscribe on the requested exchange's feed (or the only one, e.g. a replay)
+                            std::lock_guard<std::mutex> lock(exchanges_mutex_);
+                            auto *feed = market_data_feed_locked(market_req->exchange);
+                            if (feed)
                             {
                                 // Subscribe to trades (primary) and attempt level2 (optional)
-                                bool trades_subscribed = coinbase_feed->subscribe_trades(market_req->symbol);
-                                bool level2_subscribed = coinbase_feed->subscribe_level2(market_req->symbol);
+                                bool trades_subscribed = feed->subscribe_trades(market_req->symbol);
+                                bool level2_subscribed = feed->subscribe_level2(market_req->symbol);
 
                                 if (trades_subscribed)
                                 {
+                                    // The feed's own instrument for the product it subscribed, so trades match without a string compare
+                                    auto instrument = feed->register_instrument(feed->exchange_symbol(market_req->symbol));
+                                    client->get_session().instrument_to_id[instrument] = market_req->symbol_id;
+                                    instruments.push_back(instrument);
                                     // Add to subscriptions if trades succeeded
                                     auto &subscriptions = client->get_session().subscribed_symbols;
                                     if (std::find(subscriptions.begin(), subscriptions.end(), market_req->symbol) == subscriptions.end())
@@ -825,46 +1151,67 @@ namespace coinbase_dtc_core
                             }
                             else
                             {
-                                std::cout << "[ERROR] Failed to cast to CoinbaseFeed" << std::endl;
+                                std::cout << "[WARNING] No feed for exchange '" << market_req->exchange << "' to subscribe " << market_req->symbol << std::endl;
                             }
                         }
-                        else
-                        {
-                            std::cout << "[WARNING] Coinbase feed not found for subscription" << std::endl;
-                        }
                     }
                     else if (market_req->request_action == open_dtc_server::core::dtc::RequestAction::UNSUBSCRIBE)
                     {
                         // Remove from subscriptions
                         auto &subscriptions = client->get_session().subscribed_symbols;
                         subscriptions.erase(std::remove(subscriptions.begin(), subscriptions.end(), market_req->symbol), subscriptions.end());
+                        auto symbol_id = client->get_session().symbol_to_id.find(market_req->symbol);
+                        if (symbol_id != client->get_session().symbol_to_id.end())
+                        {
+                            auto &subscribed = client->get_session().instrument_to_id;
+                            for (auto it = subscribed.begin(); it != subscribed.end();)
+                            {
+                                if (it->second != symbol_id->second)
+                                {
+                                    ++it;
+                                    continue;
+                                }
+                                instruments.push_back(it->first);
+                                consolidated_book_->untrack(it->first);
+                                it = subscribed.erase(it);
+                            }
+                        }
 
                         std::cout << "[DTC-SERVER] Client " << client->get_client_id() << " unsubscribed from " << market_req->symbol << std::endl;
                         success = true;
 
-                        // Unsubscribe from Coinbase WebSocket for this symbol
+                        // Unsubscribe from the feed that carried it
                         std::lock_guard<std::mutex> lock(exchanges_mutex_);
-                        auto feed_it = exchange_feeds_.find("coinbase");
-                        if (feed_it != exchange_feeds_.end())
+                        auto *feed = market_data_feed_locked(market_req->exchange);
+                        if (feed)
                         {
-                            auto coinbase_feed = dynamic_cast<open_dtc_server::exchanges::coinbase::CoinbaseFeed *>(feed_it->second.get());
-                            if (coinbase_feed)
-                            {
-                                // Unsubscribe from both trades and level2 for the symbol
-                                coinbase_feed->unsubscribe(market_req->symbol);
-                                coinbase_feed->unsubscribe(market_req->symbol + "_level2");
-                                std::cout << "[DTC-SERVER] Unsubscribed from Coinbase WebSocket for " << market_req->symbol << std::endl;
-                            }
-                            else
-                            {
-                                std::cout << "[ERROR] Failed to cast to CoinbaseFeed for unsubscribe" << std::endl;
-                            }
+                            // Unsubscribe from both trades and level2; feeds without a separate level2 key ignore it
+                            feed->unsubscribe(market_req->symbol);
+                            feed->unsubscribe(market_req->symbol + "_level2");
+                            std::cout << "[DTC-SERVER] Unsubscribed from " << feed->get_exchange_name() << " feed for " << market_req->symbol << std::endl;
                         }
                         else
                         {
-                            std::cout << "[WARNING] Coinbase feed not found for unsubscribe" << std::endl;
+                            std::cout << "[WARNING] No feed for exchange '" << market_req->exchange << "' to unsubscribe " << market_req->symbol << std::endl;
                         }
                     }
+                    else if (market_req->request_action == open_dtc_server::core::dtc::RequestAction::SNAPSHOT && bar_aggregator_)
+                    {
+                        // One-shot request: current session state only, no subscription
+                        BarAggregator::SessionStats session;
+                        {
+                            std::lock_guard<std::mutex> lock(exchanges_mutex_);
+                            auto *feed = market_data_feed_locked(market_req->exchange);
+                            if (feed)
+                            {
+                                bar_aggregator_->get_session(open_dtc_server::exchanges::base::SymbolRegistry::getInstance().find(
+                                                                 feed->get_exchange_name(), feed->exchange_symbol(market_req->symbol)),
+                                                             session);
+                            }
+                        }
+                        client->send_message(BarAggregator::encode_snapshot(session, static_cast<uint16_t>(market_req->symbol_id)));
+                        break;
+                    }
 
                     // Send MarketDataResponse
                     if (success)
@@ -874,6 +1221,36 @@ namespace coinbase_dtc_core
                         auto response_data = protocol.create_message(*market_response);
                         client->send_message(response_data);
                         std::cout << "[DTC-SERVER] *** MarketDataResponse SENT *** Result: SUCCESS" << std::endl;
+
+                        // Session snapshot follows the response so session updates apply on top of it
+                        if (bar_aggregator_ && market_req->request_action == open_dtc_server::core::dtc::RequestAction::SUBSCRIBE)
+                        {
+                            BarAggregator::SessionStats session;
+                            if (!instruments.empty())
+                                bar_aggregator_->get_session(instruments.front(), session);
+                            client->send_message(BarAggregator::encode_snapshot(session, static_cast<uint16_t>(market_req->symbol_id)));
+                        }
+
+                        // Depth follows the response: full snapshot now, incremental updates after
+                        std::lock_guard<std::mutex> depth_lock(depth_mutex_);
+                        if (market_req->request_action == open_dtc_server::core::dtc::RequestAction::SUBSCRIBE)
+                        {
+                            uint16_t levels = client->get_session().market_depth_levels > 0
+                                                  ? client->get_session().market_depth_levels
+                                                  : config_.market_depth_levels;
+                            for (auto instrument : instruments)
+                            {
+                                auto snapshot = depth_distributor_->subscribe(instrument, client->get_client_id(),
+                                                                              market_req->symbol_id, levels);
+                                for (const auto &depth_message : snapshot)
+                                    client->send_message(depth_message);
+                            }
+                        }
+                        else
+                        {
+                            for (auto instrument : instruments)
+                                depth_distributor_->unsubscribe(instrument, client->get_client_id());
+                        }
                     }
                     else
                     {
@@ -894,6 +1271,59 @@ namespace coinbase_dtc_core
                     break;
                 }
 
+                case open_dtc_server::core::dtc::MessageType::SUBMIT_NEW_SINGLE_ORDER:
+                {
+                    auto *order = static_cast<open_dtc_server::core::dtc::SubmitNewSingleOrder *>(message.get());
+
+                    std::cout << "[DTC-SERVER] SubmitNewSingleOrder " << order->client_order_id << " for " << order->symbol
+                              << " from client " << client->get_client_id() << std::endl;
+
+                    // The gateway answers at once (pending or rejected); the exchange reply follows asynchronously
+                    if (order_gateway_)
+                        client->send_message(order_gateway_->submit(client->get_client_id(), *order));
+                    else
+                        client->send_message(OrderGateway::encode_reject(*order, "Order entry is not enabled on this server"));
+                    break;
+                }
+
+                case open_dtc_server::core::dtc::MessageType::OPEN_ORDERS_REQUEST:
+                {
+                    auto *open_req = static_cast<open_dtc_server::core::dtc::OpenOrdersRequest *>(message.get());
+
+                    std::cout << "[DTC-SERVER] OpenOrdersRequest " << open_req->request_id << " from client " << client->get_client_id() << std::endl;
+
+                    open_dtc_server::core::dtc::OpenOrdersReject reject;
+                    reject.request_id = open_req->request_id;
+                    if (!order_store_)
+                    {
+                        reject.reject_text = "Order tracking is not enabled on this server";
+                        client->send_message(protocol.create_message(reject));
+                        break;
+                    }
+
+                    // Answered from memory; the store is kept current by the user channel
+                    std::vector<open_dtc_server::core::dtc::OrderUpdate> orders;
+                    if (open_req->request_all_orders == 0 && !open_req->server_order_id.empty())
+                    {
+                        open_dtc_server::core::dtc::OrderUpdate order;
+                        if (!order_store_->find_by_server_order_id(open_req->server_order_id, order))
+                        {
+                            reject.reject_text = "Unknown server order ID: " + open_req->server_order_id;
+                            client->send_message(protocol.create_message(reject));
+                            break;
+                        }
+                        orders.push_back(std::move(order));
+                    }
+                    else
+                    {
+                        orders = order_store_->get_open_orders();
+                    }
+
+                    for (const auto &chunk : OrderStore::encode_open_orders(orders, open_req->request_id))
+                        client->send_message(chunk);
+                    break;
+                }
+
                 case open_dtc_server::core::dtc::MessageType::CURRENT_POSITIONS_REQUEST:
                 {
                     auto *positions_req = static_cast<open_dtc_server::core::dtc::CurrentPositionsRequest *>(message.get());
@@ -905,6 +1335,31 @@ namespace coinbase_dtc_core
                     break;
                 }
 
+                case open_dtc_server::core::dtc::MessageType::HISTORICAL_PRICE_DATA_REQUEST:
+                {
+                    auto *history_req = static_cast<open_dtc_server::core::dtc::HistoricalPriceDataRequest *>(message.get());
+
+                    std::cout << "[DTC-SERVER] HistoricalPriceDataRequest " << history_req->request_id << " for " << history_req->symbol
+                              << " (interval " << history_req->record_interval << "s) from client " << client->get_client_id() << std::endl;
+
+                    if (!historical_data_)
+                    {
+                        open_dtc_server::core::dtc::HistoricalPriceDataReject reject;
+                        reject.request_id = history_req->request_id;
+                        reject.reject_reason_code = 1;
+                        reject.reject_text = "Historical data is not enabled on this server";
+                        client->send_message(protocol.create_message(reject));
+                        break;
+                    }
+
+                    auto now_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                                      std::chrono::system_clock::now().time_since_epoch())
+                                      .count();
+                    for (const auto &chunk : historical_data_->handle_request(*history_req, now_us))
+                        client->send_message(chunk);
+                    break;
+                }
+
                 case open_dtc_server::core::dtc::MessageType::HEARTBEAT:
                 {
                     // Echo heartbeat back
@@ -0,0 +1,670 @@
+#include "dtc_load_generator/dtc_load_generator.hpp"
+#include "coinbase_dtc_core/core/dtc/protocol.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace open_dtc_server
+{
+    namespace loadgen
+    {
+        namespace dtc = open_dtc_server::core::dtc;
+
+        namespace
+        {
+            // Timestamp units ordered from coarsest to finest; a report carries the coarsest seen
+            enum TimestampUnit
+            {
+                UNIT_NONE = 0,
+                UNIT_MICROSECONDS = 1,
+                UNIT_MILLISECONDS = 2,
+                UNIT_SECONDS = 3
+            };
+
+            const char *unit_name(int unit)
+            {
+                switch (unit)
+                {
+                case UNIT_SECONDS:
+                    return "seconds";
+                case UNIT_MILLISECONDS:
+                    return "milliseconds";
+                case UNIT_MICROSECONDS:
+                    return "microseconds";
+                default:
+                    return "none";
+                }
+            }
+
+            int unit_rank(const std::string &name)
+            {
+                for (int unit = UNIT_NONE; unit <= UNIT_SECONDS; unit++)
+                {
+                    if (name == unit_name(unit))
+                        return unit;
+                }
+                return UNIT_NONE;
+            }
+
+            // DTC date_time fields are not consistently scaled across servers, so the
+            // unit is inferred from the magnitude (seconds stay below 1e11 until year 5138)
+            uint64_t to_microseconds(uint64_t timestamp, int &unit)
+            {
+                if (timestamp < 100000000000ULL)
+                {
+                    unit = UNIT_SECONDS;
+                    return timestamp * 1000000ULL;
+                }
+                if (timestamp < 100000000000000ULL)
+                {
+                    unit = UNIT_MILLISECONDS;
+                    return timestamp * 1000ULL;
+                }
+                unit = UNIT_MICROSECONDS;
+                return timestamp;
+            }
+
+            uint64_t now_microseconds()
+            {
+                return std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                    .count();
+            }
+        }
+
+        // ---------------------------------------------------------------
+        // LatencyHistogram
+        // ---------------------------------------------------------------
+
+        LatencyHistogram::LatencyHistogram()
+            : buckets_(bucket_index(UINT64_MAX) + 1, 0)
+        {
+        }
+
+        size_t LatencyHistogram::bucket_index(uint64_t value)
+        {
+            // Values below 2 * 128 map to themselves; above that each power of two
+            // keeps its top 8 bits, i.e. 128 sub-buckets per doubling
+            constexpr uint64_t linear_limit = 2ULL << SUB_BUCKET_BITS;
+            if (value < linear_limit)
+                return static_cast<size_t>(value);
+
+            int msb = 63 - __builtin_clzll(value);
+            int shift = msb - SUB_BUCKET_BITS;
+            uint64_t sub_bucket = (value >> shift) - (1ULL << SUB_BUCKET_BITS);
+            return static_cast<size_t>(linear_limit + (static_cast<uint64_t>(shift - 1) << SUB_BUCKET_BITS) + sub_bucket);
+        }
+
+        uint64_t LatencyHistogram::bucket_upper_bound(size_t index)
+        {
+            constexpr uint64_t linear_limit = 2ULL << SUB_BUCKET_BITS;
+            if (index < linear_limit)
+                return index;
+
+            uint64_t offset = index - linear_limit;
+            int shift = static_cast<int>(offset >> SUB_BUCKET_BITS) + 1;
+            uint64_t sub_bucket = (offset & ((1ULL << SUB_BUCKET_BITS) - 1)) + (1ULL << SUB_BUCKET_BITS);
+            if (shift + SUB_BUCKET_BITS >= 63)
+                return UINT64_MAX;
+            return ((sub_bucket + 1) << shift) - 1;
+        }
+
+        void LatencyHistogram::record(uint64_t value)
+        {
+            buckets_[bucket_index(value)]++;
+            count_++;
+            sum_ += value;
+            max_ = std::max(max_, value);
+        }
+
+        void LatencyHistogram::merge(const LatencyHistogram &other)
+        {
+            for (size_t i = 0; i < buckets_.size(); i++)
+                buckets_[i] += other.buckets_[i];
+            count_ += other.count_;
+            sum_ += other.sum_;
+            max_ = std::max(max_, other.max_);
+        }
+
+        uint64_t LatencyHistogram::percentile(double percent) const
+        {
+            if (count_ == 0)
+                return 0;
+
+            uint64_t target = static_cast<uint64_t>(std::ceil(percent / 100.0 * count_));
+            target = std::max<uint64_t>(1, std::min(target, count_));
+
+            uint64_t seen = 0;
+            for (size_t i = 0; i < buckets_.size(); i++)
+            {
+                seen += buckets_[i];
+                if (seen >= target)
+                    return std::min(bucket_upper_bound(i), max_);
+            }
+            return max_;
+        }
+
+        // ---------------------------------------------------------------
+        // LoadReport
+        // ---------------------------------------------------------------
+
+        std::string LoadReport::to_json() const
+        {
+            std::ostringstream json;
+            json << std::fixed << std::setprecision(3);
+            json << "{\n";
+            json << "  \"sessions_requested\": " << sessions_requested << ",\n";
+            json << "  \"sessions_connected\": " << sessions_connected << ",\n";
+            json << "  \"sessions_logged_on\": " << sessions_logged_on << ",\n";
+            json << "  \"subscriptions_accepted\": " << subscriptions_accepted << ",\n";
+            json << "  \"subscriptions_rejected\": " << subscriptions_rejected << ",\n";
+            json << "  \"connect_failures\": " << connect_failures << ",\n";
+            json << "  \"dropped_connections\": " << dropped_connections << ",\n";
+            json << "  \"messages_received\": " << messages_received << ",\n";
+            json << "  \"bytes_received\": " << bytes_received << ",\n";
+            json << "  \"trade_updates\": " << trade_updates << ",\n";
+            json << "  \"bid_ask_updates\": " << bid_ask_updates << ",\n";
+            json << "  \"depth_updates\": " << depth_updates << ",\n";
+            json << "  \"other_messages\": " << other_messages << ",\n";
+            json << "  \"elapsed_seconds\": " << elapsed_seconds << ",\n";
+            json << "  \"messages_per_second\": " << messages_per_second << ",\n";
+            json << "  \"bytes_per_second\": " << bytes_per_second << ",\n";
+            json << "  \"latency_us\": {\n";
+            json << "    \"samples\": " << latency_us.count() << ",\n";
+            json << "    \"timestamp_resolution\": \"" << timestamp_resolution << "\",\n";
+            json << "    \"p50\": " << latency_us.percentile(50.0) << ",\n";
+            json << "    \"p99\": " << latency_us.percentile(99.0) << ",\n";
+            json << "    \"p999\": " << latency_us.percentile(99.9) << ",\n";
+            json << "    \"max\": " << latency_us.max() << ",\n";
+            json << "    \"mean\": " << latency_us.mean() << "\n";
+            json << "  }\n";
+            json << "}\n";
+            return json.str();
+        }
+
+        // ---------------------------------------------------------------
+        // LoadGenerator
+        // ---------------------------------------------------------------
+
+        struct LoadGenerator::Session
+        {
+            enum class State
+            {
+                PENDING,
+                CONNECTING,
+                LOGGING_ON,
+                STREAMING,
+                CLOSED
+            };
+
+            uint32_t index = 0;
+            int fd = -1;
+            State state = State::PENDING;
+            std::vector<std::string> symbols;
+            std::vector<uint8_t> input;  // Partial message carried over between reads
+            std::vector<uint8_t> output; // Bytes the socket did not accept yet
+            std::chrono::steady_clock::time_point connect_at;
+            std::chrono::steady_clock::time_point last_heartbeat;
+        };
+
+        LoadGenerator::LoadGenerator(const LoadGeneratorConfig &config)
+            : config_(config)
+        {
+            if (!parse_symbol_mix(config_.symbol_mix, symbols_))
+            {
+                std::cerr << "[LOADGEN] Invalid symbol mix '" << config_.symbol_mix << "', using BTC-USD" << std::endl;
+                symbols_ = {{"BTC-USD", 1}};
+            }
+            for (const auto &symbol : symbols_)
+                total_weight_ += symbol.second;
+        }
+
+        bool LoadGenerator::parse_symbol_mix(const std::string &mix, std::vector<std::pair<std::string, uint32_t>> &symbols)
+        {
+            symbols.clear();
+            std::stringstream entries(mix);
+            std::string entry;
+            while (std::getline(entries, entry, ','))
+            {
+                if (entry.empty())
+                    continue;
+
+                std::string symbol = entry;
+                uint32_t weight = 1;
+                size_t colon = entry.rfind(':');
+                if (colon != std::string::npos)
+                {
+                    symbol = entry.substr(0, colon);
+                    try
+                    {
+                        weight = static_cast<uint32_t>(std::stoul(entry.substr(colon + 1)));
+                    }
+                    catch (const std::exception &)
+                    {
+                        return false;
+                    }
+                }
+                if (symbol.empty() || weight == 0)
+                    return false;
+                symbols.emplace_back(symbol, weight);
+            }
+            return !symbols.empty();
+        }
+
+        std::vector<std::string> LoadGenerator::pick_symbols(uint32_t session_index) const
+        {
+            size_t wanted = std::min<size_t>(std::max<uint32_t>(config_.symbols_per_session, 1), symbols_.size());
+            std::mt19937 rng(config_.seed + session_index);
+            std::uniform_int_distribution<uint64_t> draw(0, total_weight_ - 1);
+
+            std::vector<std::string> picked;
+            while (picked.size() < wanted)
+            {
+                uint64_t ticket = draw(rng);
+                for (const auto &symbol : symbols_)
+                {
+                    if (ticket < symbol.second)
+                    {
+                        if (std::find(picked.begin(), picked.end(), symbol.first) == picked.end())
+                            picked.push_back(symbol.first);
+                        break;
+                    }
+                    ticket -= symbol.second;
+                }
+            }
+            return picked;
+        }
+
+        LoadReport LoadGenerator::run()
+        {
+            running_ = true;
+
+            uint32_t thread_count = config_.threads;
+            if (thread_count == 0)
+                thread_count = std::max(1u, std::thread::hardware_concurrency());
+            thread_count = std::max(1u, std::min(thread_count, std::max(1u, config_.sessions)));
+
+            std::vector<LoadReport> reports(thread_count);
+            std::vector<std::thread> workers;
+            auto start = std::chrono::steady_clock::now();
+            for (uint32_t t = 0; t < thread_count; t++)
+                workers.emplace_back(&LoadGenerator::worker_loop, this, t, thread_count, std::ref(reports[t]));
+            for (auto &worker : workers)
+                worker.join();
+            auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            running_ = false;
+
+            LoadReport report;
+            int resolution = UNIT_NONE;
+            for (const auto &part : reports)
+            {
+                report.sessions_connected += part.sessions_connected;
+                report.sessions_logged_on += part.sessions_logged_on;
+                report.subscriptions_accepted += part.subscriptions_accepted;
+                report.subscriptions_rejected += part.subscriptions_rejected;
+                report.connect_failures += part.connect_failures;
+                report.dropped_connections += part.dropped_connections;
+                report.messages_received += part.messages_received;
+                report.bytes_received += part.bytes_received;
+                report.trade_updates += part.trade_updates;
+                report.bid_ask_updates += part.bid_ask_updates;
+                report.depth_updates += part.depth_updates;
+                report.other_messages += part.other_messages;
+                report.latency_us.merge(part.latency_us);
+                resolution = std::max(resolution, unit_rank(part.timestamp_resolution));
+            }
+            report.sessions_requested = config_.sessions;
+            report.timestamp_resolution = unit_name(resolution);
+            report.elapsed_seconds = elapsed;
+            if (elapsed > 0)
+            {
+                report.messages_per_second = report.messages_received / elapsed;
+                report.bytes_per_second = report.bytes_received / elapsed;
+            }
+            return report;
+        }
+
+        void LoadGenerator::worker_loop(uint32_t thread_index, uint32_t thread_count, LoadReport &report)
+        {
+            using clock = std::chrono::steady_clock;
+
+            // Resolve once per thread; numeric addresses skip the resolver entirely
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(config_.port);
+            if (inet_pton(AF_INET, config_.host.c_str(), &address.sin_addr) != 1)
+            {
+                addrinfo hints{};
+                hints.ai_family = AF_INET;
+                hints.ai_socktype = SOCK_STREAM;
+                addrinfo *result = nullptr;
+                if (getaddrinfo(config_.host.c_str(), nullptr, &hints, &result) != 0 || !result)
+                {
+                    std::cerr << "[LOADGEN] Cannot resolve " << config_.host << std::endl;
+                    report.connect_failures += (config_.sessions + thread_count - 1 - thread_index) / thread_count;
+                    return;
+                }
+                address.sin_addr = reinterpret_cast<sockaddr_in *>(result->ai_addr)->sin_addr;
+                freeaddrinfo(result);
+            }
+
+            // Session i connects at start + i / connect_rate, so the swarm ramps at
+            // the configured rate regardless of how sessions are spread over threads
+            auto start = clock::now();
+            auto end = start + std::chrono::seconds(config_.duration_seconds);
+            auto heartbeat_interval = std::chrono::seconds(std::max(1u, config_.heartbeat_interval_seconds));
+
+            std::vector<Session> sessions;
+            for (uint32_t i = thread_index; i < config_.sessions; i += thread_count)
+            {
+                Session session;
+                session.index = i;
+                session.symbols = pick_symbols(i);
+                session.connect_at = start;
+                if (config_.connect_rate > 0)
+                    session.connect_at += std::chrono::microseconds(static_cast<uint64_t>(i) * 1000000ULL / config_.connect_rate);
+                sessions.push_back(std::move(session));
+            }
+
+            int resolution = UNIT_NONE;
+            std::vector<uint8_t> scratch(64 * 1024);
+            std::vector<pollfd> poll_fds;
+            std::vector<Session *> polled;
+
+            auto close_session = [](Session &session)
+            {
+                if (session.fd >= 0)
+                    ::close(session.fd);
+                session.fd = -1;
+                session.state = Session::State::CLOSED;
+            };
+
+            // Queue bytes and write as much as the socket accepts; the rest waits for POLLOUT
+            auto send_bytes = [](Session &session, const std::vector<uint8_t> &bytes)
+            {
+                session.output.insert(session.output.end(), bytes.begin(), bytes.end());
+                ssize_t sent = ::send(session.fd, session.output.data(), session.output.size(), MSG_NOSIGNAL);
+                if (sent > 0)
+                    session.output.erase(session.output.begin(), session.output.begin() + sent);
+                return sent >= 0 || errno == EAGAIN || errno == EWOULDBLOCK;
+            };
+
+            auto record_latency = [&](uint64_t timestamp, uint64_t received_us)
+            {
+                if (timestamp == 0)
+                    return;
+                int unit = UNIT_NONE;
+                uint64_t sent_us = to_microseconds(timestamp, unit);
+                resolution = std::max(resolution, unit);
+                report.latency_us.record(received_us > sent_us ? received_us - sent_us : 0);
+            };
+
+            // Returns false when the session has to be closed
+            auto handle_message = [&](Session &session, const uint8_t *data, uint16_t size, uint64_t received_us)
+            {
+                report.messages_received++;
+                uint16_t type = reinterpret_cast<const dtc::MessageHeader *>(data)->type;
+                switch (static_cast<dtc::MessageType>(type))
+                {
+                case dtc::MessageType::MARKET_DATA_UPDATE_TRADE:
+                {
+                    dtc::MarketDataUpdateTrade trade;
+                    if (trade.deserialize(data, size))
+                        record_latency(trade.date_time, received_us);
+                    report.trade_updates++;
+                    break;
+                }
+                case dtc::MessageType::MARKET_DATA_UPDATE_BID_ASK:
+                {
+                    dtc::MarketDataUpdateBidAsk bid_ask;
+                    if (bid_ask.deserialize(data, size))
+                        record_latency(bid_ask.date_time, received_us);
+                    report.bid_ask_updates++;
+                    break;
+                }
+                case dtc::MessageType::MARKET_DEPTH_INCREMENTAL_UPDATE:
+                {
+                    dtc::MarketDepthIncrementalUpdate depth;
+                    if (depth.deserialize(data, size))
+                        record_latency(depth.date_time, received_us);
+                    report.depth_updates++;
+                    break;
+                }
+                case dtc::MessageType::LOGON_RESPONSE:
+                {
+                    report.other_messages++;
+                    dtc::LogonResponse response;
+                    if (session.state != Session::State::LOGGING_ON || !response.deserialize(data, size) || response.result != 1)
+                        return false;
+
+                    report.sessions_logged_on++;
+                    session.state = Session::State::STREAMING;
+                    session.last_heartbeat = clock::now();
+                    for (size_t i = 0; i < session.symbols.size(); i++)
+                    {
+                        dtc::MarketDataRequest request;
+                        request.symbol_id = static_cast<uint16_t>(i + 1);
+                        request.symbol = session.symbols[i];
+                        request.exchange = config_.exchange;
+                        if (!send_bytes(session, request.serialize()))
+                            return false;
+                    }
+                    break;
+                }
+                case dtc::MessageType::MARKET_DATA_RESPONSE:
+                {
+                    report.other_messages++;
+                    dtc::MarketDataResponse response;
+                    if (response.deserialize(data, size) && response.result == 1)
+                        report.subscriptions_accepted++;
+                    else
+                        report.subscriptions_rejected++;
+                    break;
+                }
+                case dtc::MessageType::MARKET_DATA_REJECT:
+                    report.other_messages++;
+                    report.subscriptions_rejected++;
+                    break;
+                default:
+                    report.other_messages++;
+                    break;
+                }
+                return true;
+            };
+
+            // Frame complete messages from data, returning the bytes consumed or -1 on a bad frame
+            auto handle_input = [&](Session &session, const uint8_t *data, size_t length, uint64_t received_us) -> ssize_t
+            {
+                size_t offset = 0;
+                while (length - offset >= sizeof(dtc::MessageHeader))
+                {
+                    uint16_t size = reinterpret_cast<const dtc::MessageHeader *>(data + offset)->size;
+                    if (size < sizeof(dtc::MessageHeader))
+                        return -1;
+                    if (length - offset < size)
+                        break;
+                    if (!handle_message(session, data + offset, size, received_us))
+                        return -1;
+                    offset += size;
+                }
+                return static_cast<ssize_t>(offset);
+            };
+
+            while (running_ && clock::now() < end)
+            {
+                auto now = clock::now();
+                poll_fds.clear();
+                polled.clear();
+
+                for (auto &session : sessions)
+                {
+                    if (session.state == Session::State::PENDING && now >= session.connect_at)
+                    {
+                        session.fd = ::socket(AF_INET, SOCK_STREAM, 0);
+                        if (session.fd < 0)
+                        {
+                            report.connect_failures++;
+                            session.state = Session::State::CLOSED;
+                            continue;
+                        }
+                        int one = 1;
+                        setsockopt(session.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                        fcntl(session.fd, F_SETFL, fcntl(session.fd, F_GETFL, 0) | O_NONBLOCK);
+                        if (::connect(session.fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 &&
+                            errno != EINPROGRESS)
+                        {
+                            report.connect_failures++;
+                            close_session(session);
+                            continue;
+                        }
+                        session.state = Session::State::CONNECTING;
+                    }
+
+                    if (session.state == Session::State::STREAMING && now - session.last_heartbeat >= heartbeat_interval)
+                    {
+                        session.last_heartbeat = now;
+                        dtc::Heartbeat heartbeat;
+                        if (!send_bytes(session, heartbeat.serialize()))
+                        {
+                            report.dropped_connections++;
+                            close_session(session);
+                            continue;
+                        }
+                    }
+
+                    if (session.fd < 0)
+                        continue;
+
+                    pollfd entry{};
+                    entry.fd = session.fd;
+                    entry.events = POLLIN;
+                    if (session.state == Session::State::CONNECTING || !session.output.empty())
+                        entry.events |= POLLOUT;
+                    poll_fds.push_back(entry);
+                    polled.push_back(&session);
+                }
+
+                if (poll_fds.empty())
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    continue;
+                }
+
+                int ready = ::poll(poll_fds.data(), poll_fds.size(), 10);
+                if (ready <= 0)
+                    continue;
+
+                for (size_t i = 0; i < poll_fds.size(); i++)
+                {
+                    short revents = poll_fds[i].revents;
+                    if (revents == 0)
+                        continue;
+                    Session &session = *polled[i];
+
+                    if (session.state == Session::State::CONNECTING)
+                    {
+                        int error = 0;
+                        socklen_t error_length = sizeof(error);
+                        getsockopt(session.fd, SOL_SOCKET, SO_ERROR, &error, &error_length);
+                        if (error != 0 || (revents & (POLLERR | POLLHUP)))
+                        {
+                            report.connect_failures++;
+                            close_session(session);
+                            continue;
+                        }
+
+                        report.sessions_connected++;
+                        session.state = Session::State::LOGGING_ON;
+                        dtc::LogonRequest logon;
+                        logon.client_name = "dtc_load_generator";
+                        logon.heartbeat_interval_in_seconds = static_cast<uint8_t>(std::min(255u, config_.heartbeat_interval_seconds));
+                        if (!send_bytes(session, logon.serialize()))
+                        {
+                            report.dropped_connections++;
+                            close_session(session);
+                        }
+                        continue;
+                    }
+
+                    if ((revents & POLLOUT) && !session.output.empty())
+                    {
+                        ssize_t sent = ::send(session.fd, session.output.data(), session.output.size(), MSG_NOSIGNAL);
+                        if (sent > 0)
+                            session.output.erase(session.output.begin(), session.output.begin() + sent);
+                    }
+
+                    if (!(revents & (POLLIN | POLLERR | POLLHUP)))
+                        continue;
+
+                    // Drain what is buffered; the next poll() round picks up anything later
+                    bool open = true;
+                    while (open)
+                    {
+                        ssize_t received = ::recv(session.fd, scratch.data(), scratch.size(), 0);
+                        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                            break;
+                        if (received <= 0)
+                        {
+                            open = false;
+                            break;
+                        }
+
+                        uint64_t received_us = now_microseconds();
+                        report.bytes_received += static_cast<uint64_t>(received);
+
+                        ssize_t consumed;
+                        if (session.input.empty())
+                        {
+                            consumed = handle_input(session, scratch.data(), static_cast<size_t>(received), received_us);
+                            if (consumed >= 0)
+                                session.input.assign(scratch.data() + consumed, scratch.data() + received);
+                        }
+                        else
+                        {
+                            session.input.insert(session.input.end(), scratch.data(), scratch.data() + received);
+                            consumed = handle_input(session, session.input.data(), session.input.size(), received_us);
+                            if (consumed >= 0)
+                                session.input.erase(session.input.begin(), session.input.begin() + consumed);
+                        }
+                        if (consumed < 0)
+                            open = false;
+                        if (static_cast<size_t>(received) < scratch.size())
+                            break;
+                    }
+
+                    if (!open)
+                    {
+                        if (running_)
+                            report.dropped_connections++;
+                        close_session(session);
+                    }
+                }
+            }
+
+            for (auto &session : sessions)
+            {
+                if (session.fd >= 0)
+                    close_session(session);
+            }
+            report.timestamp_resolution = unit_name(resolution);
+        }
+
+    } // namespace loadgen
+} // namespace open_dtc_server
@@ -0,0 +1,118 @@
+#include "dtc_load_generator/dtc_load_generator.hpp"
+#include <fstream>
+#include <iostream>
+#include <signal.h>
+
+static open_dtc_server::loadgen::LoadGenerator *g_generator = nullptr;
+
+void signal_handler(int)
+{
+    if (g_generator)
+        g_generator->stop();
+}
+
+int main(int argc, char *argv[])
+{
+    using namespace open_dtc_server::loadgen;
+
+    LoadGeneratorConfig config;
+    std::string report_file;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--host" && i + 1 < argc)
+        {
+            config.host = argv[++i];
+        }
+        else if (arg == "--port" && i + 1 < argc)
+        {
+            config.port = static_cast<uint16_t>(std::stoi(argv[++i]));
+        }
+        else if (arg == "--sessions" && i + 1 < argc)
+        {
+            config.sessions = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            config.threads = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--symbols" && i + 1 < argc)
+        {
+            config.symbol_mix = argv[++i];
+        }
+        else if (arg == "--symbols-per-session" && i + 1 < argc)
+        {
+            config.symbols_per_session = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--exchange" && i + 1 < argc)
+        {
+            config.exchange = argv[++i];
+        }
+        else if (arg == "--connect-rate" && i + 1 < argc)
+        {
+            config.connect_rate = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--duration" && i + 1 < argc)
+        {
+            config.duration_seconds = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--heartbeat" && i + 1 < argc)
+        {
+            config.heartbeat_interval_seconds = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--seed" && i + 1 < argc)
+        {
+            config.seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--report" && i + 1 < argc)
+        {
+            report_file = argv[++i];
+        }
+        else if (arg == "--help" || arg == "-h")
+        {
+            std::cout << "Usage: " << argv[0] << " [options]\n";
+            std::cout << "Options:\n";
+            std::cout << "  --host <address>            DTC server host (default: 127.0.0.1)\n";
+            std::cout << "  --port <n>                  DTC server port (default: 11099)\n";
+            std::cout << "  --sessions <n>              Concurrent DTC sessions (default: 100)\n";
+            std::cout << "  --threads <n>               Worker threads, 0 = hardware concurrency (default: 0)\n";
+            std::cout << "  --symbols <SYM:w,...>       Weighted symbol mix (default: BTC-USD:1)\n";
+            std::cout << "  --symbols-per-session <n>   Distinct symbols each session subscribes to (default: 1)\n";
+            std::cout << "  --exchange <name>           Exchange in MarketDataRequest (default: coinbase)\n";
+            std::cout << "  --connect-rate <n>          New connections per second, 0 = all at once (default: 500)\n";
+            std::cout << "  --duration <seconds>        Length of the run (default: 10)\n";
+            std::cout << "  --heartbeat <seconds>       Client heartbeat interval (default: 10)\n";
+            std::cout << "  --seed <n>                  Seed for the per-session symbol draw (default: 1)\n";
+            std::cout << "  --report <path>             Also write the JSON report to this file\n";
+            std::cout << "  --help, -h                  Show this help message\n";
+            return 0;
+        }
+    }
+
+    LoadGenerator generator(config);
+    g_generator = &generator;
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+
+    std::cerr << "[LOADGEN] " << config.sessions << " sessions -> " << config.host << ":" << config.port
+              << " for " << config.duration_seconds << "s" << std::endl;
+
+    LoadReport report = generator.run();
+    g_generator = nullptr;
+
+    std::string json = report.to_json();
+    std::cout << json;
+    if (!report_file.empty())
+    {
+        std::ofstream file(report_file);
+        if (!file)
+        {
+            std::cerr << "Failed to write report to " << report_file << std::endl;
+            return 1;
+        }
+        file << json;
+    }
+
+    return report.sessions_logged_on > 0 ? 0 : 1;
+}
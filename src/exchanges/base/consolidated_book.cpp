@@ -0,0 +1,278 @@
+#include "coinbase_dtc_core/exchanges/base/consolidated_book.hpp"
+#include <algorithm>
+#include <iterator>
+#include <memory>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace base
+        {
+
+            void ConsolidatedBook::apply(const MarketDepthUpdate &update)
+            {
+                // Nothing to merge until a client subscribes to a consolidated symbol
+                if (tracked_.load(std::memory_order_acquire) == 0)
+                    return;
+
+                std::unique_lock<std::mutex> lock(mutex_);
+
+                InstrumentId instrument = consolidated_instrument(update.instrument);
+                auto tracked = symbols_.find(instrument);
+                if (tracked == symbols_.end() || tracked->second.subscribers == 0)
+                    return;
+                auto &books = tracked->second;
+                Events events;
+
+                if (update.action == MarketDepthUpdate::Action::SNAPSHOT)
+                {
+                    books.exchanges[update.instrument] = update.book ? *update.book : OrderBook();
+                    rebuild(instrument, books, update.exchange_time_us, update.receive_time_us, events);
+                    publish(lock, events);
+                    return;
+                }
+
+                // First change since tracking started: the source's book already holds it
+                auto exchange = books.exchanges.find(update.instrument);
+                if (exchange == books.exchanges.end())
+                {
+                    OrderBook seeded;
+                    if (book_source_ && book_source_(update.instrument, seeded))
+                    {
+                        books.exchanges.emplace(update.instrument, std::move(seeded));
+                        rebuild(instrument, books, update.exchange_time_us, update.receive_time_us, events);
+                        publish(lock, events);
+                        return;
+                    }
+                    exchange = books.exchanges.emplace(update.instrument, OrderBook()).first;
+                }
+
+                // Mirror the exchange book, replaying its delta when the feed provides one
+                BookSide side = update.is_bid ? BookSide::BID : BookSide::ASK;
+                auto &exchange_book = exchange->second;
+                if (update.delta.type == BookDelta::Type::NONE || !exchange_book.apply_delta(update.delta))
+                {
+                    exchange_book.apply(side, update.price, update.size);
+                }
+
+                // Only this price level changes in the merged book
+                double merged_size = 0.0;
+                for (const auto &entry : books.exchanges)
+                    merged_size += entry.second.size_at(side, update.price);
+
+                BookDelta delta = books.consolidated.apply(side, update.price, merged_size);
+                if (delta.type == BookDelta::Type::NONE)
+                    return;
+
+                MarketDepthUpdate merged;
+                merged.instrument = instrument;
+                merged.action = MarketDepthUpdate::Action::SET;
+                merged.is_bid = update.is_bid;
+                merged.price = update.price;
+                merged.size = merged_size;
+                merged.exchange_time_us = update.exchange_time_us;
+                merged.receive_time_us = update.receive_time_us;
+                merged.delta = delta;
+                events.depth.push_back(merged);
+
+                if (delta.position == 0)
+                    publish_best_bid_offer(instrument, books, update.exchange_time_us, update.receive_time_us, events);
+
+                publish(lock, events);
+            }
+
+            void ConsolidatedBook::track(InstrumentId instrument)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                if (symbols_[instrument].subscribers++ == 0)
+                    tracked_.fetch_add(1, std::memory_order_release);
+            }
+
+            void ConsolidatedBook::untrack(InstrumentId instrument)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                auto it = symbols_.find(instrument);
+                if (it == symbols_.end() || it->second.subscribers == 0)
+                    return;
+
+                // Books go stale while nobody merges them; the next subscriber reseeds
+                if (--it->second.subscribers == 0)
+                {
+                    symbols_.erase(it);
+                    tracked_.fetch_sub(1, std::memory_order_release);
+                }
+            }
+
+            void ConsolidatedBook::remove_exchange(const std::string &exchange)
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                Events events;
+
+                const auto &registry = SymbolRegistry::getInstance();
+                for (auto &entry : symbols_)
+                {
+                    auto &exchanges = entry.second.exchanges;
+                    size_t before = exchanges.size();
+                    for (auto it = exchanges.begin(); it != exchanges.end();)
+                        it = registry.exchange(it->first) == exchange ? exchanges.erase(it) : std::next(it);
+                    if (exchanges.size() != before)
+                    {
+                        uint64_t now = timestamp::now_us();
+                        rebuild(entry.first, entry.second, now, now, events);
+                    }
+                }
+                publish(lock, events);
+            }
+
+            bool ConsolidatedBook::get_best_bid_offer(const std::string &symbol, MarketLevel2 &bbo) const
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                const SymbolBooks *books = find_books(symbol);
+                if (!books)
+                    return false;
+
+                const auto *bid = books->consolidated.best_bid();
+                const auto *ask = books->consolidated.best_ask();
+                if (!bid && !ask)
+                    return false;
+
+                bbo.instrument = SymbolRegistry::getInstance().find(CONSOLIDATED_EXCHANGE, symbol);
+                bbo.bid_price = bid ? bid->price : 0.0;
+                bbo.bid_size = bid ? bid->size : 0.0;
+                bbo.ask_price = ask ? ask->price : 0.0;
+                bbo.ask_size = ask ? ask->size : 0.0;
+                return true;
+            }
+
+            std::vector<PriceLevel> ConsolidatedBook::get_depth(const std::string &symbol, BookSide side, size_t max_levels) const
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                const SymbolBooks *books = find_books(symbol);
+                if (!books)
+                    return {};
+                return books->consolidated.get_depth(side, max_levels);
+            }
+
+            InstrumentId ConsolidatedBook::consolidated_instrument(InstrumentId exchange_instrument)
+            {
+                auto it = consolidated_ids_.find(exchange_instrument);
+                if (it != consolidated_ids_.end())
+                    return it->second;
+
+                // First update from this exchange instrument: merge under its normalized symbol
+                auto &registry = SymbolRegistry::getInstance();
+                const Instrument *source = registry.get(exchange_instrument);
+                if (!source)
+                    return NO_INSTRUMENT;
+
+                InstrumentId id = registry.intern(CONSOLIDATED_EXCHANGE, source->symbol, source->symbol);
+                consolidated_ids_.emplace(exchange_instrument, id);
+                return id;
+            }
+
+            const ConsolidatedBook::SymbolBooks *ConsolidatedBook::find_books(const std::string &symbol) const
+            {
+                auto it = symbols_.find(SymbolRegistry::getInstance().find(CONSOLIDATED_EXCHANGE, symbol));
+                return it != symbols_.end() ? &it->second : nullptr;
+            }
+
+            void ConsolidatedBook::rebuild(InstrumentId instrument, SymbolBooks &books, uint64_t exchange_time_us,
+                                           uint64_t receive_time_us, Events &events)
+            {
+                auto merged = std::make_shared<OrderBook>();
+
+                for (BookSide side : {BookSide::BID, BookSide::ASK})
+                {
+                    std::vector<PriceLevel> levels;
+                    for (const auto &entry : books.exchanges)
+                    {
+                        auto exchange_levels = entry.second.get_depth(side, entry.second.depth(side));
+                        levels.insert(levels.end(), exchange_levels.begin(), exchange_levels.end());
+                    }
+
+                    // Sum sizes of identical prices quoted on several exchanges
+                    std::sort(levels.begin(), levels.end(),
+                              [](const PriceLevel &a, const PriceLevel &b)
+                              { return a.price < b.price; });
+                    std::vector<PriceLevel> combined;
+                    for (const auto &level : levels)
+                    {
+                        if (!combined.empty() && combined.back().price == level.price)
+                            combined.back().size += level.size;
+                        else
+                            combined.push_back(level);
+                    }
+
+                    merged->load(side, std::move(combined));
+                }
+
+                books.consolidated = *merged;
+
+                MarketDepthUpdate snapshot;
+                snapshot.instrument = instrument;
+                snapshot.action = MarketDepthUpdate::Action::SNAPSHOT;
+                snapshot.exchange_time_us = exchange_time_us;
+                snapshot.receive_time_us = receive_time_us;
+                snapshot.book = merged;
+                events.depth.push_back(snapshot);
+
+                publish_best_bid_offer(instrument, books, exchange_time_us, receive_time_us, events);
+            }
+
+            void ConsolidatedBook::publish_best_bid_offer(InstrumentId instrument, SymbolBooks &books, uint64_t exchange_time_us,
+                                                          uint64_t receive_time_us, Events &events)
+            {
+                const auto *bid = books.consolidated.best_bid();
+                const auto *ask = books.consolidated.best_ask();
+                PriceLevel best_bid = bid ? *bid : PriceLevel();
+                PriceLevel best_ask = ask ? *ask : PriceLevel();
+
+                if (best_bid.price == books.last_bid.price && best_bid.size == books.last_bid.size &&
+                    best_ask.price == books.last_ask.price && best_ask.size == books.last_ask.size)
+                    return;
+
+                books.last_bid = best_bid;
+                books.last_ask = best_ask;
+
+                MarketLevel2 bbo;
+                bbo.instrument = instrument;
+                bbo.bid_price = best_bid.price;
+                bbo.bid_size = best_bid.size;
+                bbo.ask_price = best_ask.price;
+                bbo.ask_size = best_ask.size;
+                bbo.exchange_time_us = exchange_time_us;
+                bbo.receive_time_us = receive_time_us;
+                events.level2.push_back(bbo);
+            }
+
+            void ConsolidatedBook::publish(std::unique_lock<std::mutex> &lock, const Events &events)
+            {
+                if (events.depth.empty() && events.level2.empty())
+                    return;
+
+                // Hand over to the publish lock before the books unlock: a later change
+                // from another feed cannot overtake this one, and queries stop waiting
+                // on client sends
+                std::lock_guard<std::mutex> publishing(publish_mutex_);
+                lock.unlock();
+
+                if (depth_callback_)
+                {
+                    for (const auto &update : events.depth)
+                        depth_callback_(update);
+                }
+                if (level2_callback_)
+                {
+                    for (const auto &bbo : events.level2)
+                        level2_callback_(bbo);
+                }
+            }
+
+        } // namespace base
+    } // namespace exchanges
+} // namespace open_dtc_server
@@ -0,0 +1,517 @@
+#include "coinbase_dtc_core/exchanges/base/market_journal.hpp"
+#include "coinbase_dtc_core/core/util/log.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace base
+        {
+            namespace fs = std::filesystem;
+
+            namespace
+            {
+                // 1: timestamps in milliseconds; 2: in microseconds
+                constexpr uint32_t JOURNAL_VERSION = 2;
+                constexpr const char *SEGMENT_EXTENSION = ".jrnl";
+                constexpr std::chrono::milliseconds MAP_RETRY_INTERVAL{1000};
+
+                std::string segment_path(const std::string &directory, uint64_t first_sequence)
+                {
+                    char name[32];
+                    std::snprintf(name, sizeof(name), "%020llu", static_cast<unsigned long long>(first_sequence));
+                    return (fs::path(directory) / (std::string(name) + SEGMENT_EXTENSION)).string();
+                }
+
+                bool read_header(std::ifstream &file, uint64_t &capacity, uint64_t &first_sequence, uint64_t &committed,
+                                 uint32_t *version = nullptr)
+                {
+                    uint8_t bytes[sizeof(JournalSegmentHeader)];
+                    file.seekg(0);
+                    if (!file.read(reinterpret_cast<char *>(bytes), sizeof(bytes)))
+                        return false;
+                    if (std::memcmp(bytes, JournalSegmentHeader::MAGIC, sizeof(JournalSegmentHeader::MAGIC)) != 0)
+                        return false;
+
+                    std::memcpy(&capacity, bytes + offsetof(JournalSegmentHeader, capacity), sizeof(uint64_t));
+                    std::memcpy(&first_sequence, bytes + offsetof(JournalSegmentHeader, first_sequence), sizeof(uint64_t));
+                    std::memcpy(&committed, bytes + offsetof(JournalSegmentHeader, committed), sizeof(uint64_t));
+                    committed = std::min(committed, capacity);
+                    if (version)
+                        std::memcpy(version, bytes + offsetof(JournalSegmentHeader, version), sizeof(uint32_t));
+                    return true;
+                }
+            }
+
+            // =====================
+            // MarketJournal implementation
+            // =====================
+            MarketJournal::MarketJournal(const JournalConfig &config)
+                : config_(config)
+            {
+                if (config_.records_per_segment == 0)
+                    config_.records_per_segment = 1;
+            }
+
+            MarketJournal::~MarketJournal()
+            {
+                close();
+            }
+
+            bool MarketJournal::open()
+            {
+#ifdef _WIN32
+                util::simple_log("[JOURNAL] Memory-mapped journal is not supported on Windows");
+                return false;
+#else
+                if (opened_)
+                    return true;
+
+                std::error_code ec;
+                fs::create_directories(config_.directory, ec);
+                if (ec)
+                {
+                    util::simple_log("[JOURNAL] Cannot create " + config_.directory + ": " + ec.message());
+                    return false;
+                }
+
+                // Continue the sequence of an existing journal in a fresh segment. A trailing
+                // empty segment was mapped ahead by a run that stopped before using it
+                auto segments = JournalReader::list_segments(config_.directory);
+                while (!segments.empty())
+                {
+                    std::ifstream last(segments.back(), std::ios::binary);
+                    uint64_t capacity = 0, first_sequence = 0, committed = 0;
+                    if (!read_header(last, capacity, first_sequence, committed))
+                        break;
+                    if (committed == 0 && segments.size() > 1)
+                    {
+                        last.close();
+                        fs::remove(segments.back(), ec);
+                        segments.pop_back();
+                        continue;
+                    }
+                    next_sequence_ = first_sequence + committed;
+                    break;
+                }
+
+                std::lock_guard<std::mutex> lock(segment_mutex_);
+                if (!map_segment(next_sequence_, segment_))
+                    return false;
+                segment_used_ = 0;
+                apply_retention(next_sequence_);
+
+                opened_ = true;
+                stopping_ = false;
+                next_failed_ = false;
+                background_thread_ = std::thread(&MarketJournal::background_thread_function, this);
+
+                util::simple_log("[JOURNAL] Recording to " + config_.directory + " from sequence " + std::to_string(next_sequence_));
+                return true;
+#endif
+            }
+
+            void MarketJournal::close()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(segment_mutex_);
+                    if (!opened_)
+                        return;
+                    opened_ = false;
+                    stopping_ = true;
+                }
+                background_cv_.notify_all();
+                next_cv_.notify_all();
+                if (background_thread_.joinable())
+                    background_thread_.join();
+
+                std::lock_guard<std::mutex> lock(segment_mutex_);
+                for (auto &segment : retired_)
+                    unmap_segment(segment, sync_on_roll());
+                retired_.clear();
+
+                if (next_.base)
+                {
+                    // Mapped ahead but never written
+                    std::string path = segment_path(config_.directory, next_.header->first_sequence);
+                    unmap_segment(next_, false);
+                    std::error_code ec;
+                    fs::remove(path, ec);
+                }
+
+                if (segment_.base)
+                {
+                    uint64_t first_sequence = segment_.header->first_sequence;
+                    unmap_segment(segment_, config_.sync_policy != JournalConfig::SyncPolicy::NONE);
+                    apply_retention(first_sequence);
+                }
+            }
+
+            void MarketJournal::record_trade(const MarketTrade &trade)
+            {
+                JournalRecord record;
+                fill(record, JournalRecord::TRADE, trade.instrument, trade.exchange_time_us);
+                record.side = static_cast<uint8_t>(trade.side);
+                record.price = trade.price;
+                record.size = trade.volume;
+                append(record);
+            }
+
+            void MarketJournal::record_level2(const MarketLevel2 &level2)
+            {
+                JournalRecord record;
+                fill(record, JournalRecord::QUOTE, level2.instrument, level2.exchange_time_us);
+                record.side = static_cast<uint8_t>(BookSide::BID);
+                record.price = level2.bid_price;
+                record.size = level2.bid_size;
+                append(record);
+
+                record.side = static_cast<uint8_t>(BookSide::ASK);
+                record.price = level2.ask_price;
+                record.size = level2.ask_size;
+                append(record);
+            }
+
+            void MarketJournal::record_depth(const MarketDepthUpdate &update)
+            {
+                JournalRecord record;
+
+                if (update.action == MarketDepthUpdate::Action::SNAPSHOT)
+                {
+                    fill(record, JournalRecord::BOOK_RESET, update.instrument, update.exchange_time_us);
+                    append(record);
+                    if (!update.book)
+                        return;
+
+                    for (BookSide side : {BookSide::BID, BookSide::ASK})
+                    {
+                        size_t depth = update.book->depth(side);
+                        for (size_t position = 0; position < depth; ++position)
+                        {
+                            const PriceLevel *level = update.book->level(side, position);
+                            fill(record, JournalRecord::BOOK_LEVEL, update.instrument, update.exchange_time_us);
+                            record.side = static_cast<uint8_t>(side);
+                            record.position = static_cast<uint16_t>(std::min<size_t>(position, UINT16_MAX));
+                            record.price = level->price;
+                            record.size = level->size;
+                            append(record);
+                        }
+                    }
+                    return;
+                }
+
+                fill(record, JournalRecord::BOOK_DELTA, update.instrument, update.exchange_time_us);
+                record.side = static_cast<uint8_t>(update.is_bid ? BookSide::BID : BookSide::ASK);
+                // A position past the record's range is dropped; replay then diffs the change itself
+                bool positioned = update.delta.position <= UINT16_MAX;
+                record.delta_type = static_cast<uint8_t>(positioned ? update.delta.type : BookDelta::Type::NONE);
+                record.position = positioned ? static_cast<uint16_t>(update.delta.position) : 0;
+                record.price = update.price;
+                record.size = update.size;
+                append(record);
+            }
+
+            void MarketJournal::append(JournalRecord &record)
+            {
+                if (segment_used_ >= config_.records_per_segment || !segment_.records)
+                {
+                    if (!roll())
+                    {
+                        dropped_records_.fetch_add(1, std::memory_order_relaxed);
+                        return;
+                    }
+                }
+
+                record.sequence = next_sequence_++;
+                std::memcpy(&segment_.records[segment_used_], &record, sizeof(JournalRecord));
+                segment_.header->committed.store(++segment_used_, std::memory_order_release);
+            }
+
+            bool MarketJournal::roll()
+            {
+                std::unique_lock<std::mutex> lock(segment_mutex_);
+                if (!opened_)
+                    return false;
+
+                // Mapped while the current segment filled; only a writer outrunning the background thread waits
+                next_cv_.wait(lock, [this]
+                              { return next_.base || next_failed_ || stopping_; });
+                if (!next_.base)
+                    return false;
+
+                retired_.push_back(segment_);
+                segment_ = next_;
+                next_ = Segment();
+                segment_used_ = 0;
+                lock.unlock();
+
+                background_cv_.notify_one();
+                return true;
+            }
+
+            bool MarketJournal::map_segment(uint64_t first_sequence, Segment &segment)
+            {
+#ifdef _WIN32
+                (void)first_sequence;
+                (void)segment;
+                return false;
+#else
+                std::string path = segment_path(config_.directory, first_sequence);
+                size_t length = sizeof(JournalSegmentHeader) + config_.records_per_segment * sizeof(JournalRecord);
+
+                int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+                if (fd < 0)
+                {
+                    util::simple_log("[JOURNAL] Cannot open segment " + path);
+                    return false;
+                }
+
+                if (::ftruncate(fd, static_cast<off_t>(length)) != 0)
+                {
+                    util::simple_log("[JOURNAL] Cannot size segment " + path);
+                    ::close(fd);
+                    return false;
+                }
+#ifdef __linux__
+                // Reserve blocks now so appends never wait on block allocation
+                ::posix_fallocate(fd, 0, static_cast<off_t>(length));
+#endif
+
+                void *base = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (base == MAP_FAILED)
+                {
+                    util::simple_log("[JOURNAL] Cannot map segment " + path);
+                    ::close(fd);
+                    return false;
+                }
+
+                segment.fd = fd;
+                segment.base = static_cast<uint8_t *>(base);
+                segment.length = length;
+                segment.header = reinterpret_cast<JournalSegmentHeader *>(segment.base);
+                segment.records = reinterpret_cast<JournalRecord *>(segment.base + sizeof(JournalSegmentHeader));
+
+                std::memcpy(segment.header->magic, JournalSegmentHeader::MAGIC, sizeof(JournalSegmentHeader::MAGIC));
+                segment.header->version = JOURNAL_VERSION;
+                segment.header->record_size = sizeof(JournalRecord);
+                segment.header->capacity = config_.records_per_segment;
+                segment.header->first_sequence = first_sequence;
+                segment.header->committed.store(0, std::memory_order_release);
+                return true;
+#endif
+            }
+
+            void MarketJournal::unmap_segment(Segment &segment, bool sync)
+            {
+#ifndef _WIN32
+                if (!segment.base)
+                    return;
+
+                if (sync)
+                    ::msync(segment.base, segment.length, MS_SYNC);
+                ::munmap(segment.base, segment.length);
+                ::close(segment.fd);
+#endif
+                segment = Segment();
+            }
+
+            void MarketJournal::apply_retention(uint64_t current_first_sequence)
+            {
+                if (config_.retain_segments == 0)
+                    return;
+
+                // A segment mapped ahead holds nothing yet and does not count
+                auto segments = JournalReader::list_segments(config_.directory);
+                auto end = std::upper_bound(segments.begin(), segments.end(), segment_path(config_.directory, current_first_sequence));
+                size_t count = static_cast<size_t>(end - segments.begin());
+                size_t excess = count > config_.retain_segments ? count - config_.retain_segments : 0;
+                for (size_t i = 0; i < excess; ++i)
+                {
+                    std::error_code ec;
+                    fs::remove(segments[i], ec);
+                }
+            }
+
+            bool MarketJournal::sync_on_roll() const
+            {
+                return config_.sync_policy == JournalConfig::SyncPolicy::ON_ROLL ||
+                       config_.sync_policy == JournalConfig::SyncPolicy::INTERVAL;
+            }
+
+            void MarketJournal::background_thread_function()
+            {
+                using Clock = std::chrono::steady_clock;
+                const bool interval = config_.sync_policy == JournalConfig::SyncPolicy::INTERVAL;
+                auto next_sync = Clock::now() + std::chrono::milliseconds(config_.sync_interval_ms);
+                auto next_map_attempt = Clock::now();
+
+                // Only this thread unmaps, so segments copied out of the lock stay mapped
+                std::unique_lock<std::mutex> lock(segment_mutex_);
+                while (!stopping_)
+                {
+                    // The next segment first: a writer that fills the current one waits for it
+                    if (!next_.base && Clock::now() >= next_map_attempt)
+                    {
+                        uint64_t first_sequence = segment_.header->first_sequence + config_.records_per_segment;
+                        lock.unlock();
+                        Segment next;
+                        bool mapped = map_segment(first_sequence, next);
+                        lock.lock();
+
+                        next_ = next;
+                        next_failed_ = !mapped;
+                        if (!mapped)
+                            next_map_attempt = Clock::now() + MAP_RETRY_INTERVAL;
+                        next_cv_.notify_all();
+                        continue;
+                    }
+
+                    if (!retired_.empty())
+                    {
+                        std::vector<Segment> retired;
+                        retired.swap(retired_);
+                        uint64_t current_first_sequence = segment_.header->first_sequence;
+                        lock.unlock();
+
+                        for (auto &segment : retired)
+                            unmap_segment(segment, sync_on_roll());
+                        apply_retention(current_first_sequence);
+
+                        lock.lock();
+                        continue;
+                    }
+
+                    if (interval && Clock::now() >= next_sync)
+                    {
+                        Segment current = segment_;
+                        lock.unlock();
+#ifndef _WIN32
+                        ::msync(current.base, current.length, MS_SYNC);
+#endif
+                        lock.lock();
+                        next_sync = Clock::now() + std::chrono::milliseconds(config_.sync_interval_ms);
+                        continue;
+                    }
+
+                    auto has_work = [this]
+                    { return stopping_ || !retired_.empty(); };
+                    if (!next_.base)
+                        background_cv_.wait_until(lock, interval ? std::min(next_sync, next_map_attempt) : next_map_attempt, has_work);
+                    else if (interval)
+                        background_cv_.wait_until(lock, next_sync, has_work);
+                    else
+                        background_cv_.wait(lock, has_work);
+                }
+            }
+
+            void MarketJournal::fill(JournalRecord &record, uint8_t type, InstrumentId instrument, uint64_t timestamp)
+            {
+                // Ids are per process; the journal keeps the spelling
+                const std::string &symbol = SymbolRegistry::getInstance().exchange_symbol(instrument);
+                std::memset(&record, 0, sizeof(record));
+                record.type = type;
+                record.timestamp = timestamp;
+                std::memcpy(record.symbol, symbol.data(), std::min(symbol.size(), JournalRecord::SYMBOL_SIZE - 1));
+            }
+
+            // =====================
+            // JournalReader implementation
+            // =====================
+            JournalReader::JournalReader(const std::string &directory)
+                : directory_(directory)
+            {
+            }
+
+            size_t JournalReader::poll(std::vector<JournalRecord> &out, size_t max_records)
+            {
+                size_t read = 0;
+                while (read < max_records)
+                {
+                    auto segments = list_segments(directory_);
+                    if (segments.empty())
+                        break;
+
+                    // Start at the oldest segment still on disk
+                    auto current = std::find(segments.begin(), segments.end(), current_segment_);
+                    if (current == segments.end())
+                    {
+                        current = std::upper_bound(segments.begin(), segments.end(), current_segment_);
+                        if (current == segments.end())
+                            break;
+                        current_segment_ = *current;
+                        next_record_ = 0;
+                    }
+
+                    std::ifstream file(current_segment_, std::ios::binary);
+                    uint64_t capacity = 0, first_sequence = 0, committed = 0;
+                    uint32_t version = 0;
+                    if (!read_header(file, capacity, first_sequence, committed, &version))
+                        break;
+
+                    if (next_record_ < committed)
+                    {
+                        size_t count = static_cast<size_t>(std::min<uint64_t>(committed - next_record_, max_records - read));
+                        size_t base = out.size();
+                        out.resize(base + count);
+                        file.seekg(static_cast<std::streamoff>(sizeof(JournalSegmentHeader) + next_record_ * sizeof(JournalRecord)));
+                        file.read(reinterpret_cast<char *>(out.data() + base), static_cast<std::streamsize>(count * sizeof(JournalRecord)));
+                        if (version < 2)
+                        {
+                            // Older segments kept milliseconds
+                            for (size_t i = base; i < out.size(); ++i)
+                                out[i].timestamp *= 1000;
+                        }
+                        next_record_ += count;
+                        read += count;
+                        continue;
+                    }
+
+                    // Segment drained: move on only once the writer has started a newer one.
+                    // One mapped ahead starts at this segment's capacity, so until this one
+                    // is full the next must continue right after its last record
+                    if (current + 1 == segments.end())
+                        break;
+                    if (committed < capacity)
+                    {
+                        std::ifstream next_file(*(current + 1), std::ios::binary);
+                        uint64_t next_capacity = 0, next_first_sequence = 0, next_committed = 0;
+                        if (!read_header(next_file, next_capacity, next_first_sequence, next_committed) ||
+                            next_first_sequence != first_sequence + committed)
+                            break;
+                    }
+                    current_segment_ = *(current + 1);
+                    next_record_ = 0;
+                }
+                return read;
+            }
+
+            std::vector<std::string> JournalReader::list_segments(const std::string &directory)
+            {
+                std::vector<std::string> segments;
+                std::error_code ec;
+                for (fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec))
+                {
+                    if (it->path().extension() == SEGMENT_EXTENSION)
+                        segments.push_back(it->path().string());
+                }
+
+                // Zero-padded sequence names sort in journal order
+                std::sort(segments.begin(), segments.end());
+                return segments;
+            }
+
+        } // namespace base
+    } // namespace exchanges
+} // namespace open_dtc_server
@@ -0,0 +1,171 @@
+#include "coinbase_dtc_core/exchanges/base/order_book.hpp"
+#include <algorithm>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace base
+        {
+
+            BookDelta OrderBook::apply(BookSide side, double price, double size)
+            {
+                BookDelta delta;
+                delta.side = side;
+                delta.price = price;
+                delta.size = size;
+
+                auto &book = levels(side);
+
+                // Bids ascend and asks descend so that the best level is always at the back
+                auto it = book.begin() + (find(side, price) - book.cbegin());
+
+                bool found = (it != book.end() && it->price == price);
+                size_t index = static_cast<size_t>(it - book.begin());
+
+                if (size <= 0.0)
+                {
+                    if (!found)
+                        return delta;
+
+                    delta.type = BookDelta::Type::DELETE;
+                    delta.position = static_cast<uint32_t>(book.size() - 1 - index);
+                    delta.size = 0.0;
+                    book.erase(it);
+                    return delta;
+                }
+
+                if (found)
+                {
+                    if (it->size == size)
+                        return delta;
+
+                    it->size = size;
+                    delta.type = BookDelta::Type::UPDATE;
+                    delta.position = static_cast<uint32_t>(book.size() - 1 - index);
+                    return delta;
+                }
+
+                book.insert(it, PriceLevel(price, size));
+                delta.type = BookDelta::Type::INSERT;
+                delta.position = static_cast<uint32_t>(book.size() - 1 - index);
+                return delta;
+            }
+
+            bool OrderBook::apply_delta(const BookDelta &delta)
+            {
+                auto &book = levels(delta.side);
+
+                switch (delta.type)
+                {
+                case BookDelta::Type::INSERT:
+                {
+                    if (delta.position > book.size())
+                        return false;
+                    // Strictly between its neighbours, or a stale delta would break the sort order
+                    auto it = book.end() - delta.position;
+                    bool bid = delta.side == BookSide::BID;
+                    auto better = [bid](double a, double b)
+                    { return bid ? a > b : a < b; };
+                    if ((it != book.begin() && !better(delta.price, (it - 1)->price)) ||
+                        (it != book.end() && !better(it->price, delta.price)))
+                        return false;
+                    book.insert(it, PriceLevel(delta.price, delta.size));
+                    return true;
+                }
+                case BookDelta::Type::UPDATE:
+                {
+                    if (delta.position >= book.size())
+                        return false;
+                    auto &level = book[book.size() - 1 - delta.position];
+                    if (level.price != delta.price)
+                        return false;
+                    level.size = delta.size;
+                    return true;
+                }
+                case BookDelta::Type::DELETE:
+                {
+                    if (delta.position >= book.size())
+                        return false;
+                    auto it = book.end() - 1 - delta.position;
+                    if (it->price != delta.price)
+                        return false;
+                    book.erase(it);
+                    return true;
+                }
+                default:
+                    return true;
+                }
+            }
+
+            void OrderBook::load(BookSide side, std::vector<PriceLevel> new_levels)
+            {
+                new_levels.erase(std::remove_if(new_levels.begin(), new_levels.end(),
+                                                [](const PriceLevel &level)
+                                                { return level.size <= 0.0; }),
+                                 new_levels.end());
+
+                if (side == BookSide::BID)
+                    std::sort(new_levels.begin(), new_levels.end(),
+                              [](const PriceLevel &a, const PriceLevel &b)
+                              { return a.price < b.price; });
+                else
+                    std::sort(new_levels.begin(), new_levels.end(),
+                              [](const PriceLevel &a, const PriceLevel &b)
+                              { return a.price > b.price; });
+
+                levels(side) = std::move(new_levels);
+            }
+
+            void OrderBook::clear()
+            {
+                bids_.clear();
+                asks_.clear();
+            }
+
+            size_t OrderBook::depth(BookSide side) const
+            {
+                return levels(side).size();
+            }
+
+            const PriceLevel *OrderBook::level(BookSide side, size_t position) const
+            {
+                const auto &book = levels(side);
+                if (position >= book.size())
+                    return nullptr;
+                return &book[book.size() - 1 - position];
+            }
+
+            double OrderBook::size_at(BookSide side, double price) const
+            {
+                auto it = find(side, price);
+                return (it != levels(side).end() && it->price == price) ? it->size : 0.0;
+            }
+
+            std::vector<PriceLevel>::const_iterator OrderBook::find(BookSide side, double price) const
+            {
+                const auto &book = levels(side);
+                if (side == BookSide::BID)
+                    return std::lower_bound(book.begin(), book.end(), price,
+                                            [](const PriceLevel &level, double p)
+                                            { return level.price < p; });
+                return std::lower_bound(book.begin(), book.end(), price,
+                                        [](const PriceLevel &level, double p)
+                                        { return level.price > p; });
+            }
+
+            std::vector<PriceLevel> OrderBook::get_depth(BookSide side, size_t max_levels) const
+            {
+                const auto &book = levels(side);
+                size_t count = std::min(max_levels, book.size());
+
+                std::vector<PriceLevel> result;
+                result.reserve(count);
+                for (auto it = book.rbegin(); it != book.rbegin() + count; ++it)
+                    result.push_back(*it);
+                return result;
+            }
+
+        } // namespace base
+    } // namespace exchanges
+} // namespace open_dtc_server
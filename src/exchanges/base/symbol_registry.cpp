@@ -0,0 +1,159 @@
+#include "coinbase_dtc_core/exchanges/base/symbol_registry.hpp"
+#include "coinbase_dtc_core/core/util/log.hpp"
+#include <functional>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace base
+        {
+
+            namespace
+            {
+                const std::string EMPTY;
+            }
+
+            SymbolRegistry &SymbolRegistry::getInstance()
+            {
+                static SymbolRegistry registry;
+                return registry;
+            }
+
+            SymbolRegistry::SymbolRegistry()
+                : instruments_(MAX_INSTRUMENTS + 1)
+            {
+            }
+
+            InstrumentId SymbolRegistry::intern(std::string_view exchange, std::string_view exchange_symbol, std::string_view symbol)
+            {
+                size_t key = hash(exchange, exchange_symbol);
+
+                std::lock_guard<std::mutex> lock(mutex_);
+                InstrumentId id = find_locked(key, exchange, exchange_symbol);
+                if (id != NO_INSTRUMENT)
+                    return id;
+
+                size_t count = count_.load(std::memory_order_relaxed);
+                if (count >= MAX_INSTRUMENTS)
+                {
+                    util::simple_log("[REGISTRY] Instrument limit reached, not registering " + std::string(exchange_symbol));
+                    return NO_INSTRUMENT;
+                }
+
+                id = static_cast<InstrumentId>(count + 1);
+                auto instrument = std::make_unique<Instrument>();
+                instrument->id = id;
+                instrument->exchange.assign(exchange.data(), exchange.size());
+                instrument->exchange_symbol.assign(exchange_symbol.data(), exchange_symbol.size());
+                instrument->symbol.assign(symbol.data(), symbol.size());
+                instruments_[id] = std::move(instrument);
+                index_.emplace(key, id);
+
+                // Publish after the slot is filled
+                count_.store(count + 1, std::memory_order_release);
+                return id;
+            }
+
+            InstrumentId SymbolRegistry::find(std::string_view exchange, std::string_view exchange_symbol) const
+            {
+                size_t key = hash(exchange, exchange_symbol);
+                std::lock_guard<std::mutex> lock(mutex_);
+                return find_locked(key, exchange, exchange_symbol);
+            }
+
+            const std::string &SymbolRegistry::exchange(InstrumentId id) const
+            {
+                const Instrument *instrument = get(id);
+                return instrument ? instrument->exchange : EMPTY;
+            }
+
+            const std::string &SymbolRegistry::exchange_symbol(InstrumentId id) const
+            {
+                const Instrument *instrument = get(id);
+                return instrument ? instrument->exchange_symbol : EMPTY;
+            }
+
+            const std::string &SymbolRegistry::symbol(InstrumentId id) const
+            {
+                const Instrument *instrument = get(id);
+                return instrument ? instrument->symbol : EMPTY;
+            }
+
+            size_t SymbolRegistry::hash(std::string_view exchange, std::string_view exchange_symbol)
+            {
+                std::hash<std::string_view> hasher;
+                size_t seed = hasher(exchange);
+                return seed ^ (hasher(exchange_symbol) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+            }
+
+            InstrumentId SymbolRegistry::find_locked(size_t key, std::string_view exchange, std::string_view exchange_symbol) const
+            {
+                auto range = index_.equal_range(key);
+                for (auto it = range.first; it != range.second; ++it)
+                {
+                    const Instrument &instrument = *instruments_[it->second];
+                    if (instrument.exchange == exchange && instrument.exchange_symbol == exchange_symbol)
+                        return it->second;
+                }
+                return NO_INSTRUMENT;
+            }
+
+            InstrumentTable::InstrumentTable()
+                : slots_(new std::atomic<const Instrument *>[CAPACITY])
+            {
+                for (size_t i = 0; i < CAPACITY; ++i)
+                    slots_[i].store(nullptr, std::memory_order_relaxed);
+            }
+
+            InstrumentId InstrumentTable::find(std::string_view exchange_symbol) const
+            {
+                for (size_t i = slot_for(exchange_symbol), probes = 0; probes < CAPACITY; i = (i + 1) % CAPACITY, ++probes)
+                {
+                    const Instrument *instrument = slots_[i].load(std::memory_order_acquire);
+                    if (!instrument)
+                        return NO_INSTRUMENT;
+                    if (instrument->exchange_symbol == exchange_symbol)
+                        return instrument->id;
+                }
+                return NO_INSTRUMENT;
+            }
+
+            bool InstrumentTable::add(const Instrument *instrument)
+            {
+                if (!instrument)
+                    return false;
+
+                for (size_t i = slot_for(instrument->exchange_symbol), probes = 0; probes < CAPACITY; i = (i + 1) % CAPACITY, ++probes)
+                {
+                    const Instrument *current = slots_[i].load(std::memory_order_acquire);
+                    if (!current)
+                    {
+                        // Past MAX_ENTRIES the registry takes over
+                        if (full())
+                            return false;
+                        if (slots_[i].compare_exchange_strong(current, instrument, std::memory_order_acq_rel))
+                        {
+                            count_.fetch_add(1, std::memory_order_relaxed);
+                            return true;
+                        }
+                        // Another thread filled the slot first; current now holds its instrument
+                    }
+                    if (current == instrument || current->exchange_symbol == instrument->exchange_symbol)
+                        return true;
+                }
+                return false;
+            }
+
+            size_t InstrumentTable::slot_for(std::string_view exchange_symbol)
+            {
+                // FNV-1a: product IDs are a few bytes, so this costs less than std::hash
+                uint64_t hash = 0xcbf29ce484222325ULL;
+                for (char c : exchange_symbol)
+                    hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3ULL;
+                return static_cast<size_t>(hash % CAPACITY);
+            }
+
+        } // namespace base
+    } // namespace exchanges
+} // namespace open_dtc_server
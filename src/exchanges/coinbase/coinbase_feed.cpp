@@ -1,12 +1,16 @@
 #include "coinbase_dtc_core/exchanges/coinbase/coinbase_feed.hpp"
 #include "coinbase_dtc_core/exchanges/coinbase/websocket_client.hpp"     // Re-enabled
 #include "coinbase_dtc_core/exchanges/coinbase/ssl_websocket_client.hpp" // NEW: SSL WebSocket client
+#include "coinbase_dtc_core/exchanges/coinbase/rest_client.hpp"
+#include "coinbase_dtc_core/exchanges/base/decimal.hpp"
+#include "coinbase_dtc_core/exchanges/base/timestamp.hpp"
 #include "coinbase_dtc_core/core/util/advanced_log.hpp"
 #include <nlohmann/json.hpp> // For JSON parsing
 #include <chrono>
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <charconv>
 
 namespace open_dtc_server
 {
@@ -15,6 +19,46 @@ namespace open_dtc_server
         namespace coinbase
         {
 
+            namespace
+            {
+                // Exchange time and sequence from a scanned message; receive time stands in for a missing "time"
+                template <typename Event>
+                void stamp(Event &event, const FeedMessage &message, uint64_t receive_time_us)
+                {
+                    event.receive_time_us = receive_time_us;
+                    if (!base::timestamp::parse_iso8601(message.time, event.exchange_time_us))
+                        event.exchange_time_us = receive_time_us;
+                    std::from_chars(message.sequence.data(), message.sequence.data() + message.sequence.size(), event.sequence);
+                }
+
+                // "2", or "2A"/"2B" for the sides of a redundant pair
+                std::string connection_name(size_t index, bool paired, FeedSide side)
+                {
+                    return std::to_string(index) + (paired ? (side == FeedSide::A ? "A" : "B") : "");
+                }
+
+                uint64_t elapsed_us(std::chrono::steady_clock::duration duration)
+                {
+                    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+                }
+
+                // Free slot of a pipeline ring, waiting while it is full; nullptr once the pipeline stops
+                template <typename T>
+                T *claim_slot(base::SpscRing<T> &ring, base::Parker &space, const std::atomic<bool> &stop, std::atomic<uint64_t> &stalls)
+                {
+                    T *slot = ring.claim();
+                    if (slot)
+                        return slot;
+
+                    stalls.fetch_add(1, std::memory_order_relaxed);
+                    space.wait([&]
+                               { return (slot = ring.claim()) != nullptr || stop.load(std::memory_order_acquire); });
+                    return slot;
+                }
+            } // namespace
+
+            thread_local CoinbaseFeed::Pipeline *CoinbaseFeed::parser_pipeline_ = nullptr;
+
             CoinbaseFeed::CoinbaseFeed(const base::ExchangeConfig &config)
                 : base::ExchangeFeedBase(config),
                   connected_(false),
@@ -24,10 +68,6 @@ namespace open_dtc_server
                   websocket_host_(WEBSOCKET_HOST),
                   websocket_path_(WEBSOCKET_PATH),
                   websocket_port_(WEBSOCKET_PORT),
-                  should_reconnect_(false),
-                  last_successful_connection_(0),
-                  reconnect_attempts_(0),
-                  next_reconnect_time_(0),
                   messages_received_(0),
                   messages_sent_(0),
                   last_message_time_(0),
@@ -35,8 +75,11 @@ namespace open_dtc_server
                   total_trades_received_(0),
                   total_level2_updates_(0),
                   connection_uptime_start_(0),
+                  product_messages_(new std::atomic<uint64_t>[base::SymbolRegistry::MAX_INSTRUMENTS + 1]()),
+                  rates_sampled_at_(std::chrono::steady_clock::now()),
                   last_request_time_(0)
             {
+                initialize_symbol_mappings();
                 LOG_INFO("[COINBASE] Coinbase feed initialized with config: " + config.name);
             }
 
@@ -62,44 +105,117 @@ namespace open_dtc_server
 
                     // Choose between SSL WebSocket (for authenticated feeds) or plain WebSocket
                     bool use_ssl = config_.websocket_url.find("wss://") == 0 || config_.websocket_url.find("443") != std::string::npos;
+                    parse_websocket_url();
+
+                    should_stop_.store(false);
 
                     if (use_ssl)
                     {
-                        LOG_INFO("[COINBASE] Using SSL WebSocket client with JWT authentication");
-                        ssl_websocket_client_ = std::make_unique<feed::coinbase::SSLWebSocketClient>();
+                        // Products are spread over several connections, each with its own reader thread
+                        size_t connections = std::max<size_t>(config_.websocket_connections, 1);
+                        LOG_INFO("[COINBASE] Using " + std::to_string(connections) + " SSL WebSocket connection(s) with JWT authentication" +
+                                 (config_.redundant_feed ? ", each with an A/B pair" : ""));
+                        {
+                            std::lock_guard<std::mutex> lock(subscription_batcher_mutex_);
+                            shard_planner_ = ShardPlanner(connections);
+                        }
+
+                        for (size_t index = 0; index < connections; ++index)
+                        {
+                            auto shard = std::make_unique<Shard>();
+                            shard->client = std::make_unique<feed::coinbase::SSLWebSocketClient>();
+                            configure_ssl_credentials(*shard->client);
 
-                        configure_ssl_credentials();
+                            // One capture file per connection: each is written by its own reader thread
+                            if (!config_.capture_file.empty())
+                                shard->client->start_capture(index == 0 ? config_.capture_file
+                                                                        : config_.capture_file + "." + std::to_string(index));
 
-                        // Set up callbacks for SSL client
-                        ssl_websocket_client_->set_message_callback([this](const std::string &message)
-                                                                    { this->on_websocket_message_received(message); });
+                            if (config_.feed_pipeline)
+                                shard->pipeline = std::make_unique<Pipeline>(config_.pipeline_capacity, config_.pipeline_wait);
 
-                        ssl_websocket_client_->set_connection_callback([this](bool connected)
-                                                                       {
-                            if (connected) {
-                                this->notify_connection(true);
-                                // Authenticate and subscribe after connection
-                                if (has_credentials()) {
-                                    if (!ssl_websocket_client_->authenticate_with_jwt()) {
-                                        LOG_INFO("[ERROR] SSL WebSocket authentication failed");
-                                        this->notify_error("Coinbase SSL authentication failed");
-                                    }
-                                } else {
-                                    LOG_INFO("[WARNING] No credentials available for SSL WebSocket authentication");
+                            // Side B: same products, next resolved address when DNS gives more than one
+                            if (config_.redundant_feed)
+                            {
+                                shard->standby = std::make_unique<feed::coinbase::SSLWebSocketClient>();
+                                shard->standby->set_address_index(1);
+                                configure_ssl_credentials(*shard->standby);
+                                if (!config_.capture_file.empty())
+                                    shard->standby->start_capture((index == 0 ? config_.capture_file
+                                                                              : config_.capture_file + "." + std::to_string(index)) +
+                                                                  ".b");
+                                shard->arbiter = std::make_unique<FeedArbiter>();
+                            }
+
+                            Shard *raw = shard.get();
+                            for (FeedSide side : {FeedSide::A, FeedSide::B})
+                            {
+                                auto *client = shard->client_of(side);
+                                if (!client)
+                                    continue;
+                                client->set_message_callback([this, raw, side](const std::string &message)
+                                                             { this->on_shard_message(*raw, side, message); });
+                                client->set_connection_callback([this, index, side](bool connected)
+                                                                { this->on_shard_connection(index, side, connected); });
+                            }
+                            shards_.push_back(std::move(shard));
+                        }
+
+                        // Consumers first, so the first frames have somewhere to go
+                        if (config_.feed_pipeline)
+                            start_pipeline();
+
+                        size_t live = 0;
+                        std::vector<std::pair<size_t, FeedSide>> failed;
+                        for (size_t index = 0; index < connections; ++index)
+                        {
+                            // Connect to SSL WebSocket (Coinbase Advanced Trade); a pair is live while either side is
+                            bool shard_live = false;
+                            for (FeedSide side : {FeedSide::A, FeedSide::B})
+                            {
+                                auto *client = shards_[index]->client_of(side);
+                                if (!client)
+                                    continue;
+                                if (client->connect(websocket_host_, websocket_port_))
+                                {
+                                    shard_live = true;
                                 }
-                                
-                                // No auto-subscriptions on startup; await explicit server requests
-                            } else {
-                                this->notify_connection(false);
-                            } });
-
-                        // Connect to SSL WebSocket (Coinbase Advanced Trade)
-                        bool ws_connected = ssl_websocket_client_->connect("ws-feed.exchange.coinbase.com", 443);
-                        if (!ws_connected)
+                                else
+                                {
+                                    LOG_INFO("[ERROR] Failed to establish SSL WebSocket connection " +
+                                             connection_name(index, shards_[index]->standby != nullptr, side) + " to Coinbase");
+                                    failed.emplace_back(index, side);
+                                }
+                            }
+
+                            if (shard_live)
+                            {
+                                live++;
+                            }
+                            else
+                            {
+                                std::lock_guard<std::mutex> lock(subscription_batcher_mutex_);
+                                shard_planner_.set_live(index, false);
+                            }
+                        }
+
+                        if (live == 0)
                         {
                             LOG_INFO("[ERROR] Failed to establish SSL WebSocket connection to Coinbase");
+                            for (auto &shard : shards_)
+                            {
+                                shard->client->disconnect();
+                                if (shard->standby)
+                                    shard->standby->disconnect();
+                            }
+                            stop_pipeline();
+                            shards_.clear();
                             return false;
                         }
+
+                        // The others carry the feed meanwhile; these are retried like dropped connections
+                        for (const auto &[index, side] : failed)
+                            schedule_reconnect(index, side);
                     }
                     else
                     {
@@ -115,7 +231,7 @@ namespace open_dtc_server
                                                                { this->on_level2_received(level2); });
 
                         // Connect to plain WebSocket
-                        bool ws_connected = websocket_client_->connect("ws-feed.exchange.coinbase.com", 80);
+                        bool ws_connected = websocket_client_->connect(websocket_host_, websocket_port_);
                         if (!ws_connected)
                         {
                             LOG_INFO("[ERROR] Failed to establish WebSocket connection to Coinbase");
@@ -124,7 +240,18 @@ namespace open_dtc_server
                     }
 
                     connected_.store(true);
-                    LOG_INFO("[SUCCESS] Connected to Coinbase WebSocket feed at ws-feed.exchange.coinbase.com");
+
+                    if (!shards_.empty())
+                    {
+                        subscription_thread_ = std::thread(&CoinbaseFeed::subscription_loop, this);
+                        reconnect_thread_ = std::thread(&CoinbaseFeed::reconnect_loop, this);
+                    }
+
+                    // Stale books are refetched over REST when we can authenticate, otherwise by re-subscribing
+                    if (has_credentials())
+                        resync_thread_ = std::thread(&CoinbaseFeed::resync_loop, this);
+
+                    LOG_INFO("[SUCCESS] Connected to Coinbase WebSocket feed at " + websocket_host_ + ":" + std::to_string(websocket_port_));
                     notify_connection(true);
                     return true;
                 }
@@ -145,12 +272,45 @@ namespace open_dtc_server
 
                 LOG_INFO("[COINBASE] Disconnecting...");
 
-                // Disconnect SSL WebSocket client
-                if (ssl_websocket_client_)
+                // Worker threads use the WebSocket clients: stop them first
+                {
+                    std::lock_guard<std::mutex> lock(resync_mutex_);
+                    should_stop_.store(true);
+                    resync_queue_.clear();
+                }
+                resync_cv_.notify_all();
+                if (resync_thread_.joinable())
+                    resync_thread_.join();
+
+                // Taken once so the loop either sees should_stop_ or already waits for the notify;
+                // a reconnect in progress finishes its connect() first
+                {
+                    std::lock_guard<std::mutex> lock(reconnect_mutex_);
+                }
+                reconnect_cv_.notify_all();
+                if (reconnect_thread_.joinable())
+                    reconnect_thread_.join();
+
+                {
+                    std::lock_guard<std::mutex> lock(subscription_batcher_mutex_);
+                    for (auto &shard : shards_)
+                        shard->each_batcher([](SubscriptionBatcher &batcher)
+                                            { batcher = SubscriptionBatcher(); });
+                    shard_planner_ = ShardPlanner(1);
+                }
+                subscription_batcher_cv_.notify_all();
+                if (subscription_thread_.joinable())
+                    subscription_thread_.join();
+
+                // Disconnect SSL WebSocket clients, then the pipeline stages they fed
+                for (auto &shard : shards_)
                 {
-                    ssl_websocket_client_->disconnect();
-                    ssl_websocket_client_.reset();
+                    shard->client->disconnect();
+                    if (shard->standby)
+                        shard->standby->disconnect();
                 }
+                stop_pipeline();
+                shards_.clear();
 
                 // Disconnect plain WebSocket client
                 if (websocket_client_)
@@ -161,6 +321,12 @@ namespace open_dtc_server
 
                 connected_.store(false);
 
+                // Nothing received from here on is sequenced against the old books
+                {
+                    std::lock_guard<std::mutex> lock(order_books_mutex_);
+                    order_books_.clear();
+                }
+
                 std::lock_guard<std::mutex> lock(subscriptions_mutex_);
                 subscriptions_.clear();
 
@@ -168,6 +334,38 @@ namespace open_dtc_server
                 notify_connection(false);
             }
 
+            void CoinbaseFeed::parse_websocket_url()
+            {
+                // ws[s]://host[:port][/path]; an empty URL means the production feed over plain ws
+                const std::string &url = config_.websocket_url;
+                if (url.empty())
+                {
+                    websocket_host_ = WEBSOCKET_HOST;
+                    websocket_port_ = 80;
+                    return;
+                }
+
+                bool secure = url.find("wss://") == 0;
+                size_t host_start = url.find("://");
+                host_start = host_start == std::string::npos ? 0 : host_start + 3;
+
+                size_t path_start = url.find('/', host_start);
+                std::string authority = url.substr(host_start, path_start == std::string::npos ? std::string::npos : path_start - host_start);
+                websocket_path_ = path_start == std::string::npos ? WEBSOCKET_PATH : url.substr(path_start);
+
+                size_t colon = authority.rfind(':');
+                if (colon != std::string::npos)
+                {
+                    websocket_host_ = authority.substr(0, colon);
+                    websocket_port_ = static_cast<uint16_t>(std::stoi(authority.substr(colon + 1)));
+                }
+                else
+                {
+                    websocket_host_ = authority;
+                    websocket_port_ = secure ? 443 : 80;
+                }
+            }
+
             void CoinbaseFeed::set_credentials(const std::string &api_key_id, const std::string &private_key)
             {
                 if (api_key_id.empty() || private_key.empty())
@@ -186,7 +384,12 @@ namespace open_dtc_server
                     authenticator_ = std::make_unique<auth::JWTAuthenticator>(credentials_);
                 }
 
-                configure_ssl_credentials();
+                for (auto &shard : shards_)
+                {
+                    configure_ssl_credentials(*shard->client);
+                    if (shard->standby)
+                        configure_ssl_credentials(*shard->standby);
+                }
                 LOG_INFO("[COINBASE] Credentials stored for Coinbase feed");
             }
 
@@ -212,22 +415,17 @@ namespace open_dtc_server
                 }
             }
 
-            void CoinbaseFeed::configure_ssl_credentials()
+            void CoinbaseFeed::configure_ssl_credentials(feed::coinbase::SSLWebSocketClient &client)
             {
                 std::lock_guard<std::mutex> lock(credentials_mutex_);
 
-                if (!ssl_websocket_client_)
-                {
-                    return;
-                }
-
                 if (!credentials_.is_valid())
                 {
                     LOG_INFO("[WARNING] SSL WebSocket client cannot load credentials - none available");
                     return;
                 }
 
-                ssl_websocket_client_->set_credentials(credentials_.key_id, credentials_.private_key);
+                client.set_credentials(credentials_.key_id, credentials_.private_key);
                 LOG_INFO("[COINBASE] SSL WebSocket client configured with credentials");
             }
 
@@ -244,74 +442,15 @@ namespace open_dtc_server
 
             bool CoinbaseFeed::subscribe_trades(const std::string &symbol)
             {
-                if (!is_connected())
-                {
-                    LOG_INFO("[COINBASE] Cannot subscribe - not connected");
-                    return false;
-                }
-
-                std::string coinbase_symbol = exchange_symbol(symbol);
-
-                // Track pending subscription
-                {
-                    std::lock_guard<std::mutex> lock(pending_subscriptions_mutex_);
-                    pending_subscriptions_[coinbase_symbol] = std::chrono::steady_clock::now();
-                }
-
-                LOG_INFO("[COINBASE] Requesting trades subscription for " + symbol + " (Coinbase: " + coinbase_symbol + ")");
-
-                // Send subscription to WebSocket client
-                if (websocket_client_)
-                {
-                    websocket_client_->subscribe_trades(coinbase_symbol);
-                }
-                else if (ssl_websocket_client_)
-                {
-                    // Use SSL WebSocket for ticker data (includes trade info)
-                    ssl_websocket_client_->subscribe_to_ticker({coinbase_symbol});
-                }
-
-                // Wait for subscription result or timeout
-                bool success = true;
-                {
-                    std::unique_lock<std::mutex> lock(pending_subscriptions_mutex_);
-                    auto timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
-
-                    subscription_cv_.wait_until(lock, timeout, [this, &coinbase_symbol, &success]()
-                                                {
-                                                    auto it = subscription_results_.find(coinbase_symbol);
-                                                    if (it != subscription_results_.end())
-                                                    {
-                                                        success = it->second;
-                                                        return true; // Result is available
-                                                    }
-                                                    return false; // Still waiting
-                                                });
-
-                    // Clean up pending tracking
-                    pending_subscriptions_.erase(coinbase_symbol);
-                    subscription_results_.erase(coinbase_symbol);
-                }
-
-                if (success)
-                {
-                    // Add to active subscriptions
-                    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
-                    subscriptions_[symbol] = SubscriptionInfo(SubscriptionType::TRADES, coinbase_symbol);
-                    subscriptions_[symbol].active = true;
-                    ticker_products_.insert(coinbase_symbol);
-                    // Resubscribe with full ticker product list to ensure proper server state
-                    if (ssl_websocket_client_)
-                    {
-                        std::vector<std::string> all(ticker_products_.begin(), ticker_products_.end());
-                        ssl_websocket_client_->subscribe_to_ticker(all);
-                    }
-                }
-
-                return success;
+                return subscribe_products({symbol}, true, false);
             }
 
             bool CoinbaseFeed::subscribe_level2(const std::string &symbol)
+            {
+                return subscribe_products({symbol}, false, true);
+            }
+
+            bool CoinbaseFeed::subscribe_products(const std::vector<std::string> &symbols, bool trades, bool level2)
             {
                 if (!is_connected())
                 {
@@ -319,58 +458,105 @@ namespace open_dtc_server
                     return false;
                 }
 
-                std::string coinbase_symbol = exchange_symbol(symbol);
-
-                // Track pending subscription
+                // (subscriptions_ key, channel, Coinbase product) for every intent
+                struct Intent
                 {
-                    std::lock_guard<std::mutex> lock(pending_subscriptions_mutex_);
-                    pending_subscriptions_[coinbase_symbol] = std::chrono::steady_clock::now();
+                    std::string key;
+                    const char *channel;
+                    std::string product_id;
+                    SubscriptionType type;
+                    bool rejected;
+                };
+                std::vector<Intent> intents;
+                for (const auto &symbol : symbols)
+                {
+                    std::string coinbase_symbol = exchange_symbol(symbol);
+                    register_instrument(coinbase_symbol);
+                    // Ticker carries the trade info on the SSL feed
+                    if (trades)
+                        intents.push_back({symbol, !shards_.empty() ? CHANNEL_TICKER : CHANNEL_TRADES, coinbase_symbol, SubscriptionType::TRADES, false});
+                    if (level2)
+                        intents.push_back({symbol + "_level2", CHANNEL_LEVEL2, coinbase_symbol, SubscriptionType::LEVEL2, false});
                 }
 
-                LOG_INFO("[COINBASE] Requesting level2 subscription for " + symbol + " (Coinbase: " + coinbase_symbol + ")");
-
-                // Send subscription to WebSocket client
-                if (websocket_client_)
+                // Track pending subscriptions per channel and product
                 {
-                    websocket_client_->subscribe_level2(coinbase_symbol);
+                    std::lock_guard<std::mutex> lock(pending_subscriptions_mutex_);
+                    for (const auto &intent : intents)
+                        pending_subscriptions_[subscription_key(intent.channel, intent.product_id)] = std::chrono::steady_clock::now();
                 }
-                else if (ssl_websocket_client_)
+
+                for (const auto &intent : intents)
                 {
-                    // Use SSL WebSocket for level2 data
-                    ssl_websocket_client_->subscribe_to_level2({coinbase_symbol});
+                    LOG_INFO("[COINBASE] Requesting " + std::string(intent.channel) + " subscription for " + intent.product_id);
+                    if (websocket_client_)
+                    {
+                        if (intent.type == SubscriptionType::TRADES)
+                            websocket_client_->subscribe_trades(intent.product_id);
+                        else
+                            websocket_client_->subscribe_level2(intent.product_id);
+                    }
+                    else if (!shards_.empty())
+                    {
+                        queue_subscription(intent.channel, intent.product_id, true);
+                    }
                 }
 
-                // Wait for subscription result or timeout
-                bool success = true;
+                // Wait for every result or the timeout; no answer counts as success
+                bool all_success = true;
                 {
                     std::unique_lock<std::mutex> lock(pending_subscriptions_mutex_);
-                    auto timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+                    auto timeout = std::chrono::steady_clock::now() + SubscriptionBatcher::Limits().window +
+                                   std::chrono::milliseconds(SUBSCRIPTION_TIMEOUT_MS);
 
-                    subscription_cv_.wait_until(lock, timeout, [this, &coinbase_symbol, &success]()
+                    subscription_cv_.wait_until(lock, timeout, [this, &intents]()
                                                 {
-                                                    auto it = subscription_results_.find(coinbase_symbol);
-                                                    if (it != subscription_results_.end())
+                                                    for (const auto &intent : intents)
                                                     {
-                                                        success = it->second;
-                                                        return true; // Result is available
+                                                        if (subscription_results_.count(subscription_key(intent.channel, intent.product_id)) == 0)
+                                                            return false; // Still waiting
                                                     }
-                                                    return false; // Still waiting
-                                                });
+                                                    return true; });
+
+                    for (auto &intent : intents)
+                    {
+                        std::string key = subscription_key(intent.channel, intent.product_id);
+                        auto it = subscription_results_.find(key);
+                        if (it != subscription_results_.end() && !it->second)
+                        {
+                            all_success = false;
+                            intent.rejected = true;
+                        }
 
-                    // Clean up pending tracking
-                    pending_subscriptions_.erase(coinbase_symbol);
-                    subscription_results_.erase(coinbase_symbol);
+                        // Clean up pending tracking
+                        pending_subscriptions_.erase(key);
+                        subscription_results_.erase(key);
+                    }
                 }
 
-                if (success)
+                for (const auto &intent : intents)
                 {
+                    if (intent.rejected)
+                    {
+                        // Nothing to unsubscribe later: the exchange never had it
+                        std::lock_guard<std::mutex> lock(subscription_batcher_mutex_);
+                        size_t index = 0;
+                        if (shard_planner_.shard_of(intent.product_id, index) && index < shards_.size())
+                        {
+                            shards_[index]->each_batcher([&](SubscriptionBatcher &batcher)
+                                                         { batcher.drop(intent.channel, intent.product_id); });
+                            update_product_weight_locked(intent.product_id, index);
+                        }
+                        continue;
+                    }
+
                     // Add to active subscriptions
                     std::lock_guard<std::mutex> lock(subscriptions_mutex_);
-                    subscriptions_[symbol + "_level2"] = SubscriptionInfo(SubscriptionType::LEVEL2, coinbase_symbol);
-                    subscriptions_[symbol + "_level2"].active = true;
+                    subscriptions_[intent.key] = SubscriptionInfo(intent.type, intent.product_id);
+                    subscriptions_[intent.key].active = true;
                 }
 
-                return success;
+                return all_success;
             }
 
             bool CoinbaseFeed::unsubscribe(const std::string &symbol)
@@ -381,29 +567,26 @@ namespace open_dtc_server
                 if (it != subscriptions_.end())
                 {
                     std::string coinbase_symbol = it->second.product_id;
+                    bool level2 = it->second.type == SubscriptionType::LEVEL2;
                     subscriptions_.erase(it);
 
                     LOG_INFO("[COINBASE] Unsubscribed from " + symbol + " (Coinbase: " + coinbase_symbol + ")");
                     // Send actual unsubscribe message to Coinbase WebSocket
-                    if (ssl_websocket_client_)
+                    if (!shards_.empty())
                     {
-                        ticker_products_.erase(coinbase_symbol);
-                        // If products remain, send a fresh subscribe to remaining list; if none, send unsubscribe
-                        if (!ticker_products_.empty())
-                        {
-                            std::vector<std::string> remaining(ticker_products_.begin(), ticker_products_.end());
-                            ssl_websocket_client_->subscribe_to_ticker(remaining);
-                        }
-                        else
-                        {
-                            ssl_websocket_client_->unsubscribe_from_ticker({coinbase_symbol});
-                        }
-                        ssl_websocket_client_->unsubscribe_from_level2({coinbase_symbol});
+                        queue_subscription(level2 ? CHANNEL_LEVEL2 : CHANNEL_TICKER, coinbase_symbol, false);
                     }
                     else if (websocket_client_)
                     {
                         // Plain client unsubscribe TODO if implemented
                     }
+
+                    // Book is rebuilt from the next level2 snapshot
+                    if (level2)
+                    {
+                        std::lock_guard<std::mutex> books_lock(order_books_mutex_);
+                        order_books_.erase(base::SymbolRegistry::getInstance().find(config_.name, coinbase_symbol));
+                    }
                     return true;
                 }
 
@@ -412,239 +595,1363 @@ namespace open_dtc_server
 
             bool CoinbaseFeed::subscribe_multiple_symbols(const std::vector<std::string> &symbols)
             {
-                bool all_success = true;
-                for (const auto &symbol : symbols)
+                // One batch: the subscription thread sends a single message per channel
+                return subscribe_products(symbols, true, true);
+            }
+
+            std::string CoinbaseFeed::subscription_key(const std::string &channel, const std::string &product_id)
+            {
+                return channel + ":" + product_id;
+            }
+
+            void CoinbaseFeed::queue_subscription(const char *channel, const std::string &product_id, bool subscribe)
+            {
                 {
-                    if (!subscribe_trades(symbol) || !subscribe_level2(symbol))
+                    std::lock_guard<std::mutex> lock(subscription_batcher_mutex_);
+                    auto now = std::chrono::steady_clock::now();
+                    size_t index = 0;
+                    if (subscribe)
+                    {
+                        // A product keeps its connection for all its channels
+                        index = shard_planner_.assign(product_id, 0.0);
+                        if (index >= shards_.size())
+                            return;
+                        shards_[index]->each_batcher([&](SubscriptionBatcher &batcher)
+                                                     { batcher.subscribe(channel, product_id, now); });
+                        if (std::string(channel) == CHANNEL_LEVEL2)
+                            expect_snapshot_locked(index, product_id);
+                    }
+                    else
                     {
-                        all_success = false;
+                        if (!shard_planner_.shard_of(product_id, index) || index >= shards_.size())
+                            return;
+                        shards_[index]->each_batcher([&](SubscriptionBatcher &batcher)
+                                                     { batcher.unsubscribe(channel, product_id, now); });
                     }
+                    update_product_weight_locked(product_id, index);
                 }
-                return all_success;
+                subscription_batcher_cv_.notify_one();
             }
 
-            std::string CoinbaseFeed::normalize_symbol(const std::string &exchange_symbol)
+            void CoinbaseFeed::update_product_weight_locked(const std::string &product_id, size_t index)
             {
-                // Convert Coinbase format (BTC-USD) to normalized format (BTC/USD)
-                std::string result = exchange_symbol;
-                std::replace(result.begin(), result.end(), '-', '/');
-                return result;
+                const auto &batcher = shards_[index]->batcher;
+                bool level2 = batcher.is_wanted(CHANNEL_LEVEL2, product_id);
+                bool ticker = batcher.is_wanted(CHANNEL_TICKER, product_id);
+                if (!level2 && !ticker)
+                {
+                    shard_planner_.release(product_id);
+                    return;
+                }
+
+                // Observed rate once there is one, otherwise what the channels usually carry
+                double weight = (level2 ? EXPECTED_LEVEL2_RATE : 0.0) + (ticker ? EXPECTED_TICKER_RATE : 0.0);
+                auto observed = product_rates_.find(product_id);
+                if (observed != product_rates_.end() && observed->second > 0.0)
+                    weight = observed->second;
+                shard_planner_.set_weight(product_id, weight);
             }
 
-            std::string CoinbaseFeed::exchange_symbol(const std::string &normalized_symbol)
+            void CoinbaseFeed::refresh_product_rates_locked()
             {
-                // Convert normalized format (BTC/USD) to Coinbase format (BTC-USD)
-                std::string result = normalized_symbol;
-                std::replace(result.begin(), result.end(), '/', '-');
-
-                // Ensure uppercase
-                std::transform(result.begin(), result.end(), result.begin(), ::toupper);
+                auto now = std::chrono::steady_clock::now();
+                double seconds = std::chrono::duration<double>(now - rates_sampled_at_).count();
+                rates_sampled_at_ = now;
+                if (seconds <= 0.0)
+                    return;
 
-                return result;
+                auto &registry = base::SymbolRegistry::getInstance();
+                for (size_t index = 0; index < shards_.size(); ++index)
+                {
+                    for (const auto &product_id : shard_planner_.products_on(index))
+                    {
+                        auto instrument = registry.find(config_.name, product_id);
+                        if (instrument == base::NO_INSTRUMENT)
+                            continue;
+                        uint64_t count = product_messages_[instrument].load(std::memory_order_relaxed);
+                        uint64_t &previous = product_messages_sampled_[instrument];
+                        product_rates_[product_id] = static_cast<double>(count - previous) / seconds;
+                        previous = count;
+                        update_product_weight_locked(product_id, index);
+                    }
+                }
             }
 
-            std::vector<std::string> CoinbaseFeed::get_available_symbols()
+            void CoinbaseFeed::apply_shard_moves_locked(const std::vector<ShardPlanner::Move> &moves)
             {
-                // TODO: Fetch from Coinbase API
-                // For now, return some common symbols
-                return {"BTC/USD", "ETH/USD", "LTC/USD", "BCH/USD"};
+                auto now = std::chrono::steady_clock::now();
+                for (const auto &move : moves)
+                {
+                    auto &from = *shards_[move.from];
+                    auto &to = *shards_[move.to];
+                    for (const char *channel : {CHANNEL_TICKER, CHANNEL_LEVEL2})
+                    {
+                        if (!from.batcher.is_wanted(channel, move.product_id))
+                            continue;
+                        // A dead connection has nothing to unsubscribe; the new one sends a fresh snapshot
+                        for (FeedSide side : {FeedSide::A, FeedSide::B})
+                        {
+                            if (!from.client_of(side))
+                                continue;
+                            if (from.up[static_cast<size_t>(side)])
+                                from.batcher_of(side).unsubscribe(channel, move.product_id, now);
+                            else
+                                from.batcher_of(side).drop(channel, move.product_id);
+                        }
+                        to.each_batcher([&](SubscriptionBatcher &batcher)
+                                        { batcher.subscribe(channel, move.product_id, now); });
+                        if (std::string(channel) == CHANNEL_LEVEL2)
+                        {
+                            expect_snapshot_locked(move.to, move.product_id);
+                            forget_awaited_snapshot_locked(from, move.product_id);
+                        }
+                    }
+                    LOG_INFO("[COINBASE] Moving " + move.product_id + " from connection " + std::to_string(move.from) +
+                             " to " + std::to_string(move.to));
+                }
             }
 
-            std::string CoinbaseFeed::get_status() const
+            void CoinbaseFeed::on_shard_connection(size_t index, FeedSide side, bool connected)
             {
-                std::ostringstream ss;
-                ss << "Coinbase Feed Status:\n";
-                ss << "  Connected: " << (is_connected() ? "Yes" : "No") << "\n";
-
-                std::lock_guard<std::mutex> lock(subscriptions_mutex_);
-                ss << "  Subscriptions: " << subscriptions_.size() << "\n";
+                // Teardown: disconnect() is closing every connection
+                if (should_stop_.load() || index >= shards_.size())
+                    return;
 
-                for (const auto &[key, sub] : subscriptions_)
+                Shard &shard = *shards_[index];
+                if (connected && has_credentials() && !shard.client_of(side)->authenticate_with_jwt())
                 {
-                    std::string type_str = (sub.type == SubscriptionType::TRADES) ? "trades" : "level2";
-                    ss << "    " << sub.product_id << " (" << type_str << ")\n";
+                    LOG_INFO("[ERROR] SSL WebSocket authentication failed");
+                    notify_error("Coinbase SSL authentication failed");
                 }
 
-                return ss.str();
-            }
-
-            std::vector<std::string> CoinbaseFeed::get_subscribed_symbols() const
-            {
-                std::vector<std::string> symbols;
-                std::lock_guard<std::mutex> lock(subscriptions_mutex_);
-
-                for (const auto &[key, sub] : subscriptions_)
+                size_t live = 0;
+                bool shard_live = false;
                 {
-                    if (sub.type == SubscriptionType::TRADES)
+                    std::lock_guard<std::mutex> lock(subscription_batcher_mutex_);
+                    // The exchange forgot this connection's subscriptions either way; the reset batcher
+                    // sends all of them again, in batches
+                    shard.batcher_of(side).reset(std::chrono::steady_clock::now());
+                    shard.up[static_cast<size_t>(side)] = connected;
+                    shard_live = shard.up[0] || shard.up[1];
+                    if (connected)
+                        refresh_product_rates_locked();
+
+                    // Both sides of a pair gone: nothing carries over, books start again from new snapshots.
+                    // Marked before the moves, whose snapshots may come on another connection any moment
+                    if (!shard_live)
                     {
-                        // Convert Coinbase format to normalized format inline
-                        std::string result = sub.product_id;
-                        std::replace(result.begin(), result.end(), '-', '/');
-                        symbols.push_back(result);
+                        mark_books_stale(shard.batcher.wanted(CHANNEL_LEVEL2));
+                        if (shard.arbiter)
+                        {
+                            std::lock_guard<std::mutex> arbiter_lock(shard.arbiter_mutex);
+                            shard.arbiter->reset();
+                        }
                     }
-                }
+                    apply_shard_moves_locked(shard_planner_.set_live(index, shard_live));
+                    for (size_t i = 0; i < shards_.size(); ++i)
+                        live += shard_planner_.is_live(i) ? 1 : 0;
 
-                return symbols;
+                    // After the moves, so the snapshots awaited are those of the products staying here
+                    on_link_change_locked(index, side, connected,
+                                          connected ? shard.batcher_of(side).wanted(CHANNEL_LEVEL2) : std::vector<std::string>());
+                }
+                subscription_batcher_cv_.notify_one();
+
+                std::string name = connection_name(index, shard.standby != nullptr, side);
+                LOG_INFO("[COINBASE] Connection " + name + (connected ? " up, " : " down, ") +
+                         std::to_string(live) + " of " + std::to_string(shards_.size()) + " live");
+                // The feed as a whole is up while any connection is; the other side of a pair covers for this one
+                if (connected ? (live == 1 && shard.up[0] + shard.up[1] == 1) : live == 0)
+                    notify_connection(connected);
             }
 
-            void CoinbaseFeed::on_trade_received(const exchanges::base::MarketTrade &trade)
+            void CoinbaseFeed::mark_books_stale(const std::vector<std::string> &product_ids)
             {
-                // Process received trade data
-                util::log_debug("[COINBASE] Trade received: " + trade.symbol + " - " + std::to_string(trade.price) + " @ " + std::to_string(trade.volume));
-
-                // Forward to base class for distribution to clients
-                notify_trade(trade);
+                // Nothing updates them until the connection is back; its level2 resubscribe brings the snapshots
+                if (product_ids.empty())
+                    return;
+                auto &registry = base::SymbolRegistry::getInstance();
+                std::lock_guard<std::mutex> lock(order_books_mutex_);
+                for (const auto &product_id : product_ids)
+                {
+                    auto it = order_books_.find(registry.find(config_.name, product_id));
+                    if (it != order_books_.end() && it->second.synced)
+                        mark_stale_locked(it->second);
+                }
             }
-            void CoinbaseFeed::on_level2_received(const exchanges::base::MarketLevel2 &level2)
-            {
-                // Process received level2 data
-                util::log_debug("[COINBASE] Level2 received: " + level2.symbol + " - Bid: " + std::to_string(level2.bid_price) + " Ask: " + std::to_string(level2.ask_price));
 
-                // Forward to base class for distribution to clients
-                notify_level2(level2);
+            void CoinbaseFeed::expect_snapshot_locked(size_t index, const std::string &product_id)
+            {
+                Shard &shard = *shards_[index];
+                if (!shard.arbiter)
+                    return;
+                std::lock_guard<std::mutex> lock(shard.arbiter_mutex);
+                shard.arbiter->expect_snapshot(product_id);
             }
 
-            void CoinbaseFeed::on_websocket_message_received(const std::string &message)
+            void CoinbaseFeed::subscription_loop()
             {
-                // Process raw WebSocket message from SSL client
-                util::log_debug("[COINBASE] SSL WebSocket message received: " + message.substr(0, 100) + "...");
-
-                try
+                std::unique_lock<std::mutex> lock(subscription_batcher_mutex_);
+                while (!should_stop_.load())
                 {
-                    // Parse JSON message
-                    nlohmann::json json_message = nlohmann::json::parse(message);
-
-                    if (json_message.contains("type"))
+                    // Re-read the due time after every wakeup: new intents move it. A side that is down
+                    // keeps its requests until the reconnect brings it up and wakes this loop
+                    auto due = std::chrono::steady_clock::time_point::max();
+                    for (const auto &shard : shards_)
+                    {
+                        if (shard->up[0])
+                            due = std::min(due, shard->batcher.next_due());
+                        if (shard->standby && shard->up[1])
+                            due = std::min(due, shard->standby_batcher.next_due());
+                    }
+                    if (std::chrono::steady_clock::now() < due)
                     {
-                        std::string message_type = json_message["type"];
+                        if (due == std::chrono::steady_clock::time_point::max())
+                            subscription_batcher_cv_.wait(lock);
+                        else
+                            subscription_batcher_cv_.wait_until(lock, due);
+                        continue;
+                    }
 
-                        if (message_type == "ticker")
-                        {
-                            // Handle ticker message
-                            handle_ticker_message(message);
-                        }
-                        else if (message_type == "match")
+                    std::vector<std::pair<feed::coinbase::SSLWebSocketClient *, std::vector<SubscriptionBatcher::Request>>> batches;
+                    auto now = std::chrono::steady_clock::now();
+                    for (auto &shard : shards_)
+                    {
+                        for (FeedSide side : {FeedSide::A, FeedSide::B})
                         {
-                            // Handle trade message
-                            handle_trade_message(message);
+                            if (!shard->client_of(side) || !shard->up[static_cast<size_t>(side)])
+                                continue;
+                            auto requests = shard->batcher_of(side).poll(now);
+                            if (!requests.empty())
+                                batches.emplace_back(shard->client_of(side), std::move(requests));
                         }
-                        else if (message_type == "l2update")
+                    }
+                    if (batches.empty())
+                        continue;
+
+                    // Send without holding the batchers: subscribers keep queueing meanwhile
+                    lock.unlock();
+                    for (const auto &[client, requests] : batches)
+                    {
+                        for (const auto &request : requests)
                         {
-                            // Handle level2 update
-                            handle_level2_message(message);
+                            bool level2 = request.channel == CHANNEL_LEVEL2;
+                            bool sent;
+                            if (request.subscribe)
+                                sent = level2 ? client->subscribe_to_level2(request.product_ids)
+                                              : client->subscribe_to_ticker(request.product_ids);
+                            else
+                                sent = level2 ? client->unsubscribe_from_level2(request.product_ids)
+                                              : client->unsubscribe_from_ticker(request.product_ids);
+                            LOG_INFO("[COINBASE] " + std::string(request.subscribe ? "Subscribe " : "Unsubscribe ") + request.channel + ": " +
+                                     std::to_string(request.product_ids.size()) + " product(s)" + (sent ? "" : " (send failed)"));
                         }
-                        else if (message_type == "heartbeat")
+                    }
+                    lock.lock();
+                }
+            }
+
+            void CoinbaseFeed::forget_awaited_snapshot_locked(Shard &shard, const std::string &product_id)
+            {
+                // Moved away while its connection was resyncing: the snapshot now comes on another one
+                std::lock_guard<std::mutex> lock(reconnect_mutex_);
+                for (FeedSide side : {FeedSide::A, FeedSide::B})
+                {
+                    Link &link = shard.links[static_cast<size_t>(side)];
+                    if (!link.resyncing || link.awaiting_snapshots.erase(product_id) == 0)
+                        continue;
+                    if (link.awaiting_snapshots.empty() && link.record.first_message_us != 0)
+                    {
+                        uint64_t now_us = base::timestamp::now_us();
+                        link.record.resynced_us = std::max<uint64_t>(now_us > link.up_us ? now_us - link.up_us : 0, 1);
+                        finish_resync_locked(shard, side);
+                    }
+                }
+            }
+
+            void CoinbaseFeed::schedule_reconnect(size_t index, FeedSide side)
+            {
+                std::lock_guard<std::mutex> lock(reconnect_mutex_);
+                Shard &shard = *shards_[index];
+                Link &link = shard.links[static_cast<size_t>(side)];
+                link.state = LinkState::BACKOFF;
+                link.attempts = 0;
+                link.down_since = std::chrono::steady_clock::now();
+                auto delay = reconnect_delay_locked(0);
+                link.retry_at = link.down_since + delay;
+                LOG_INFO("[COINBASE] Reconnecting connection " + connection_name(index, shard.standby != nullptr, side) + " in " +
+                         std::to_string(delay.count()) + " ms");
+                reconnect_cv_.notify_all();
+            }
+
+            void CoinbaseFeed::on_link_change_locked(size_t index, FeedSide side, bool connected,
+                                                     const std::vector<std::string> &level2_products)
+            {
+                Shard &shard = *shards_[index];
+                if (!connected)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(reconnect_mutex_);
+                        // Dropped again before it resynced: kept with what it reached
+                        if (shard.links[static_cast<size_t>(side)].resyncing)
+                            finish_resync_locked(shard, side);
+                        reconnect_stats_.drops++;
+                    }
+                    schedule_reconnect(index, side);
+                    return;
+                }
+
+                std::lock_guard<std::mutex> lock(reconnect_mutex_);
+                Link &link = shard.links[static_cast<size_t>(side)];
+                if (link.state == LinkState::UP)
+                    return; // First connect: nothing to recover
+
+                // Back up: time it until it carries data again and until every book has a new snapshot
+                reconnect_stats_.reconnects++;
+                link.state = LinkState::UP;
+                link.record = ReconnectRecord();
+                link.record.connection = index;
+                link.record.side = side;
+                link.record.attempts = link.attempts;
+                link.record.down_us = elapsed_us(std::chrono::steady_clock::now() - link.down_since);
+                link.attempts = 0;
+                link.up_us = base::timestamp::now_us();
+                link.awaiting_snapshots.clear();
+                link.awaiting_snapshots.insert(level2_products.begin(), level2_products.end());
+                link.resyncing = true;
+                shard.resyncing[static_cast<size_t>(side)].store(true, std::memory_order_release);
+                LOG_INFO("[COINBASE] Connection " + connection_name(index, shard.standby != nullptr, side) + " reconnected after " +
+                         std::to_string(link.record.down_us / 1000) + " ms (" + std::to_string(link.record.attempts) + " attempt(s)), restoring " +
+                         std::to_string(level2_products.size()) + " level2 book(s)");
+            }
+
+            void CoinbaseFeed::track_resync(Shard &shard, FeedSide side, const std::string &message, uint64_t receive_time_us)
+            {
+                // Only while this side resyncs: subscriptions, heartbeats and errors do not count as data
+                FeedMessage fields;
+                if (!FeedMessageScanner::scan(message, fields))
+                    return;
+                bool snapshot = fields.type == "snapshot";
+                if (!snapshot && fields.type != "l2update" && fields.type != "ticker" && fields.type != "match")
+                    return;
+
+                std::lock_guard<std::mutex> lock(reconnect_mutex_);
+                Link &link = shard.links[static_cast<size_t>(side)];
+                if (!link.resyncing)
+                    return;
+
+                // 0 means "not yet", so a message in the same microsecond counts as 1
+                uint64_t elapsed = std::max<uint64_t>(receive_time_us > link.up_us ? receive_time_us - link.up_us : 0, 1);
+                if (link.record.first_message_us == 0)
+                    link.record.first_message_us = elapsed;
+                if (snapshot)
+                    link.awaiting_snapshots.erase(std::string(fields.product_id));
+                if (link.awaiting_snapshots.empty())
+                {
+                    link.record.resynced_us = elapsed;
+                    finish_resync_locked(shard, side);
+                }
+            }
+
+            void CoinbaseFeed::finish_resync_locked(Shard &shard, FeedSide side)
+            {
+                Link &link = shard.links[static_cast<size_t>(side)];
+                link.resyncing = false;
+                shard.resyncing[static_cast<size_t>(side)].store(false, std::memory_order_relaxed);
+
+                const ReconnectRecord &record = link.record;
+                reconnect_stats_.max_first_message_us = std::max(reconnect_stats_.max_first_message_us, record.first_message_us);
+                reconnect_stats_.max_resynced_us = std::max(reconnect_stats_.max_resynced_us, record.resynced_us);
+                reconnect_stats_.recent.push_back(record);
+                if (reconnect_stats_.recent.size() > RECENT_RECONNECTS)
+                    reconnect_stats_.recent.erase(reconnect_stats_.recent.begin());
+
+                std::string name = connection_name(record.connection, shard.standby != nullptr, side);
+                if (record.resynced_us != 0)
+                    LOG_INFO("[COINBASE] Connection " + name + " resynced: first message after " + std::to_string(record.first_message_us) +
+                             " us, every book after " + std::to_string(record.resynced_us) + " us");
+                else
+                    LOG_INFO("[COINBASE] Connection " + name + " dropped again before it resynced");
+            }
+
+            std::chrono::milliseconds CoinbaseFeed::reconnect_delay_locked(uint64_t attempts)
+            {
+                // Doubling per failed attempt, drawn from the upper half of the current step
+                uint64_t delay = INITIAL_RECONNECT_DELAY_MS;
+                for (uint64_t i = 0; i < attempts && delay < MAX_RECONNECT_DELAY_MS; ++i)
+                    delay *= 2;
+                delay = std::min(delay, MAX_RECONNECT_DELAY_MS);
+                std::uniform_int_distribution<uint64_t> jitter(delay / 2, delay);
+                return std::chrono::milliseconds(jitter(reconnect_jitter_));
+            }
+
+            void CoinbaseFeed::reconnect_loop()
+            {
+                std::unique_lock<std::mutex> lock(reconnect_mutex_);
+                while (!should_stop_.load())
+                {
+                    // The connection whose retry is due first
+                    Shard *shard = nullptr;
+                    size_t index = 0;
+                    FeedSide side = FeedSide::A;
+                    auto due = std::chrono::steady_clock::time_point::max();
+                    for (size_t i = 0; i < shards_.size(); ++i)
+                    {
+                        for (FeedSide candidate : {FeedSide::A, FeedSide::B})
                         {
-                            // Handle heartbeat
-                            handle_heartbeat_message(message);
+                            const Link &link = shards_[i]->links[static_cast<size_t>(candidate)];
+                            if (shards_[i]->client_of(candidate) && link.state == LinkState::BACKOFF && link.retry_at < due)
+                            {
+                                shard = shards_[i].get();
+                                index = i;
+                                side = candidate;
+                                due = link.retry_at;
+                            }
                         }
-                        else if (message_type == "subscriptions")
+                    }
+                    if (!shard)
+                    {
+                        reconnect_cv_.wait(lock);
+                        continue;
+                    }
+                    if (std::chrono::steady_clock::now() < due)
+                    {
+                        reconnect_cv_.wait_until(lock, due);
+                        continue;
+                    }
+
+                    Link &link = shard->links[static_cast<size_t>(side)];
+                    link.state = LinkState::CONNECTING;
+                    link.attempts++;
+                    std::string name = connection_name(index, shard->standby != nullptr, side);
+                    LOG_INFO("[COINBASE] Reconnecting connection " + name + ", attempt " + std::to_string(link.attempts));
+
+                    // Success is taken over by on_shard_connection, called from inside connect()
+                    lock.unlock();
+                    bool connected = shard->client_of(side)->connect(websocket_host_, websocket_port_);
+                    lock.lock();
+                    if (connected || link.state != LinkState::CONNECTING)
+                        continue;
+
+                    reconnect_stats_.failed_attempts++;
+                    link.state = LinkState::BACKOFF;
+                    auto delay = reconnect_delay_locked(link.attempts);
+                    link.retry_at = std::chrono::steady_clock::now() + delay;
+                    LOG_INFO("[COINBASE] Reconnect of connection " + name + " failed, next attempt in " + std::to_string(delay.count()) + " ms");
+                    if (link.attempts == MAX_RECONNECT_ATTEMPTS)
+                    {
+                        lock.unlock();
+                        notify_error("Coinbase connection " + name + " still down after " + std::to_string(MAX_RECONNECT_ATTEMPTS) +
+                                     " attempts, retrying every " + std::to_string(MAX_RECONNECT_DELAY_MS / 1000) + " s or less");
+                        lock.lock();
+                    }
+                }
+            }
+
+            std::string CoinbaseFeed::normalize_symbol(const std::string &exchange_symbol)
+            {
+                // Convert Coinbase format (BTC-USD) to normalized format (BTC/USD)
+                std::string result = exchange_symbol;
+                std::replace(result.begin(), result.end(), '-', '/');
+                return result;
+            }
+
+            std::string CoinbaseFeed::exchange_symbol(const std::string &normalized_symbol)
+            {
+                // Convert normalized format (BTC/USD) to Coinbase format (BTC-USD)
+                std::string result = normalized_symbol;
+                std::replace(result.begin(), result.end(), '/', '-');
+
+                // Ensure uppercase
+                std::transform(result.begin(), result.end(), result.begin(), ::toupper);
+
+                return result;
+            }
+
+            std::vector<std::string> CoinbaseFeed::get_available_symbols()
+            {
+                // TODO: Fetch from Coinbase API
+                // For now, return some common symbols
+                return {"BTC/USD", "ETH/USD", "LTC/USD", "BCH/USD"};
+            }
+
+            void CoinbaseFeed::initialize_symbol_mappings()
+            {
+                // Products are registered here and on subscribe; the handlers only look them up
+                for (const auto &symbol : get_available_symbols())
+                    register_instrument(exchange_symbol(symbol));
+            }
+
+            std::string CoinbaseFeed::get_status() const
+            {
+                std::ostringstream ss;
+                ss << "Coinbase Feed Status:\n";
+                ss << "  Connected: " << (is_connected() ? "Yes" : "No") << "\n";
+
+                std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+                ss << "  Subscriptions: " << subscriptions_.size() << "\n";
+
+                for (const auto &[key, sub] : subscriptions_)
+                {
+                    std::string type_str = (sub.type == SubscriptionType::TRADES) ? "trades" : "level2";
+                    ss << "    " << sub.product_id << " (" << type_str << ")\n";
+                }
+
+                {
+                    std::lock_guard<std::mutex> batcher_lock(subscription_batcher_mutex_);
+                    for (size_t index = 0; index < shards_.size(); ++index)
+                    {
+                        ss << "  Connection " << index << ": " << (shard_planner_.is_live(index) ? "live" : "down") << ", "
+                           << shard_planner_.products_on(index).size() << " products, ~" << static_cast<uint64_t>(shard_planner_.load(index))
+                           << " msg/s";
+
+                        // Wire bytes saved and what inflating them costs
+                        auto &shard = *shards_[index];
+                        for (FeedSide side : {FeedSide::A, FeedSide::B})
                         {
-                            // Handle subscription confirmation from Coinbase
-                            handle_subscriptions_message(message);
+                            const auto *client = shard.client_of(side);
+                            if (!client)
+                                continue;
+                            if (shard.standby)
+                                ss << "\n    " << (side == FeedSide::A ? "A" : "B") << ": " << (shard.up[static_cast<size_t>(side)] ? "up" : "down")
+                                   << " " << client->get_peer_address();
+                            auto compression = client->get_compression_stats();
+                            if (client->is_deflate_active() && compression.messages > 0 && compression.compressed_bytes > 0)
+                            {
+                                ss << ", deflate " << (client->has_context_takeover() ? "with" : "without") << " context takeover "
+                                   << std::fixed << std::setprecision(1)
+                                   << static_cast<double>(compression.inflated_bytes) / static_cast<double>(compression.compressed_bytes)
+                                   << ":1, " << compression.inflate_ns / compression.messages << " ns/msg";
+                            }
                         }
-                        else if (message_type == "error")
+
+                        // Which side delivers first, and by how much
+                        if (shard.arbiter)
                         {
-                            // Handle error
-                            handle_error_message(message);
+                            std::lock_guard<std::mutex> arbiter_lock(shard.arbiter_mutex);
+                            auto arbitration = shard.arbiter->stats();
+                            uint64_t now_us = base::timestamp::now_us();
+                            for (FeedSide side : {FeedSide::A, FeedSide::B})
+                            {
+                                const auto &stats = arbitration.sides[static_cast<size_t>(side)];
+                                ss << "\n    " << (side == FeedSide::A ? "A" : "B") << " first " << stats.first << " of "
+                                   << stats.received << ", lead (us) mean " << (stats.leads > 0 ? stats.lead_us_total / stats.leads : 0)
+                                   << " max " << stats.lead_us_max << (shard.arbiter->is_quiet(side, now_us) ? ", quiet" : "");
+                            }
+                            ss << "\n    Failovers: " << arbitration.failovers;
                         }
-                        else
+
+                        // Connections on their way back
+                        std::lock_guard<std::mutex> reconnect_lock(reconnect_mutex_);
+                        for (FeedSide side : {FeedSide::A, FeedSide::B})
                         {
-                            LOG_INFO("[COINBASE] Unknown message type: " + message_type);
+                            const Link &link = shard.links[static_cast<size_t>(side)];
+                            if (!shard.client_of(side))
+                                continue;
+                            std::string name = shard.standby ? (side == FeedSide::A ? "A " : "B ") : "";
+                            if (link.state != LinkState::UP)
+                                ss << "\n    " << name << (link.state == LinkState::CONNECTING ? "reconnecting" : "waiting to reconnect")
+                                   << ", " << link.attempts << " attempt(s) so far";
+                            else if (link.resyncing)
+                                ss << "\n    " << name << "resyncing, " << link.awaiting_snapshots.size() << " snapshot(s) to go";
                         }
+                        ss << "\n";
                     }
                 }
-                catch (const std::exception &e)
+
+                auto reconnects = get_reconnect_stats();
+                ss << "  Reconnects: " << reconnects.reconnects << " of " << reconnects.drops << " drops, "
+                   << reconnects.failed_attempts << " failed attempts";
+                if (!reconnects.recent.empty())
+                {
+                    const auto &last = reconnects.recent.back();
+                    ss << "; last down " << last.down_us / 1000 << " ms, first message (us) " << last.first_message_us
+                       << ", resynced (us) " << last.resynced_us;
+                }
+                ss << "; max first message (us) " << reconnects.max_first_message_us << ", max resynced (us) "
+                   << reconnects.max_resynced_us << "\n";
+
+                auto pipeline = get_pipeline_stats();
+                if (pipeline.enabled)
                 {
-                    LOG_INFO("[ERROR] Failed to parse SSL WebSocket message: " + std::string(e.what()));
+                    ss << "  Pipeline (" << base::to_string(pipeline.wait) << "):\n";
+                    for (size_t index = 0; index < pipeline.frames.size(); ++index)
+                    {
+                        const auto &frames = pipeline.frames[index];
+                        const auto &events = pipeline.events[index];
+                        ss << "    Connection " << index << ": frames " << frames.depth << "/" << frames.capacity
+                           << " (peak " << frames.high_water << ", " << frames.stalls << " stalls), events "
+                           << events.depth << "/" << events.capacity << " (peak " << events.high_water << ", "
+                           << events.stalls << " stalls)\n";
+                    }
                 }
+
+                auto sync = get_book_sync_stats();
+                ss << "  Book Sync: " << sync.gaps << " gaps (" << sync.missed_messages << " missed), "
+                   << sync.out_of_order << " out of order, " << sync.crossed_books << " crossed, "
+                   << sync.resyncs << " resyncs, " << sync.stale_books << " stale\n";
+                ss << "  Book Recovery (us): last " << sync.last_recovery_us << ", max " << sync.max_recovery_us << "\n";
+
+                return ss.str();
             }
 
-            void CoinbaseFeed::handle_trade_message(const std::string &message)
+            std::vector<std::string> CoinbaseFeed::get_subscribed_symbols() const
             {
-                try
+                std::vector<std::string> symbols;
+                std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+
+                for (const auto &[key, sub] : subscriptions_)
                 {
-                    nlohmann::json json = nlohmann::json::parse(message);
+                    if (sub.type == SubscriptionType::TRADES)
+                    {
+                        // Convert Coinbase format to normalized format inline
+                        std::string result = sub.product_id;
+                        std::replace(result.begin(), result.end(), '-', '/');
+                        symbols.push_back(result);
+                    }
+                }
+
+                return symbols;
+            }
+
+            void CoinbaseFeed::on_trade_received(const exchanges::base::MarketTrade &trade)
+            {
+                // Debug builds only: the message would allocate on every trade
+#ifdef _DEBUG
+                util::log_debug("[COINBASE] Trade received: " + base::SymbolRegistry::getInstance().exchange_symbol(trade.instrument) + " - " + std::to_string(trade.price) + " @ " + std::to_string(trade.volume));
+#endif
+
+                if (parser_pipeline_)
+                {
+                    enqueue_event(*parser_pipeline_, base::MarketEvent(trade), nullptr);
+                    return;
+                }
+
+                // Forward to base class for distribution to clients
+                std::lock_guard<std::mutex> lock(publish_mutex_);
+                notify_trade(trade);
+            }
+            void CoinbaseFeed::on_level2_received(const exchanges::base::MarketLevel2 &level2)
+            {
+                // Debug builds only: the message would allocate on every quote
+#ifdef _DEBUG
+                util::log_debug("[COINBASE] Level2 received: " + base::SymbolRegistry::getInstance().exchange_symbol(level2.instrument) + " - Bid: " + std::to_string(level2.bid_price) + " Ask: " + std::to_string(level2.ask_price));
+#endif
 
-                    if (json.contains("product_id") && json.contains("price") && json.contains("size"))
+                if (parser_pipeline_)
+                {
+                    enqueue_event(*parser_pipeline_, base::MarketEvent(level2), nullptr);
+                    return;
+                }
+
+                // Forward to base class for distribution to clients
+                std::lock_guard<std::mutex> lock(publish_mutex_);
+                notify_level2(level2);
+            }
+
+            void CoinbaseFeed::on_depth_received(const exchanges::base::MarketDepthUpdate &update)
+            {
+                total_level2_updates_++;
+
+                if (parser_pipeline_)
+                {
+                    enqueue_event(*parser_pipeline_, base::MarketEvent(update), update.book);
+                    return;
+                }
+
+                // Forward to base class for distribution to clients
+                std::lock_guard<std::mutex> lock(publish_mutex_);
+                notify_depth(update);
+            }
+
+            void CoinbaseFeed::on_shard_message(Shard &shard, FeedSide side, const std::string &message)
+            {
+                uint64_t receive_time_us = base::timestamp::now_us();
+                if (shard.resyncing[static_cast<size_t>(side)].load(std::memory_order_acquire))
+                    track_resync(shard, side, message, receive_time_us);
+
+                if (!shard.arbiter)
+                {
+                    forward_message(shard, message, receive_time_us);
+                    return;
+                }
+
+                // Both readers of a pair meet here. Scan outside the locks; decide and hand off under
+                // forward_mutex, so messages leave in the order they were accepted
+                FeedMessage fields;
+                if (!FeedMessageScanner::scan(message, fields))
+                    fields = FeedMessage(); // Passed through; the parser reports it
+
+                std::lock_guard<std::mutex> lock(shard.forward_mutex);
+                {
+                    std::lock_guard<std::mutex> arbiter_lock(shard.arbiter_mutex);
+                    if (!shard.arbiter->accept(side, fields, receive_time_us))
+                        return;
+                }
+                forward_message(shard, message, receive_time_us);
+            }
+
+            void CoinbaseFeed::forward_message(Shard &shard, const std::string &message, uint64_t receive_time_us)
+            {
+                if (!shard.pipeline)
+                {
+                    process_message(message, receive_time_us);
+                    return;
+                }
+
+                // Reader thread: copy into the ring and get back to the socket
+                auto &pipeline = *shard.pipeline;
+                Frame *frame = claim_slot(pipeline.frames, pipeline.frames_space, pipeline_stop_, pipeline.reader_stalls);
+                if (!frame)
+                    return;
+                frame->payload.assign(message);
+                frame->receive_time_us = receive_time_us;
+                pipeline.frames.publish();
+                pipeline.frames_ready.notify();
+            }
+
+            void CoinbaseFeed::start_pipeline()
+            {
+                pipeline_stop_.store(false);
+                events_ready_ = std::make_unique<base::Parker>(config_.pipeline_wait);
+                for (auto &shard : shards_)
+                {
+                    Pipeline *pipeline = shard->pipeline.get();
+                    pipeline->parser = std::thread(&CoinbaseFeed::parser_loop, this, std::ref(*pipeline));
+                }
+                distribution_thread_ = std::thread(&CoinbaseFeed::distribution_loop, this);
+                LOG_INFO("[COINBASE] Feed pipeline started: " + std::to_string(shards_.size()) + " parser thread(s), " +
+                         std::to_string(config_.pipeline_capacity) + "-slot rings, " + base::to_string(config_.pipeline_wait) + " wait");
+            }
+
+            void CoinbaseFeed::stop_pipeline()
+            {
+                if (!distribution_thread_.joinable())
+                    return;
+
+                pipeline_stop_.store(true, std::memory_order_release);
+                for (auto &shard : shards_)
+                {
+                    shard->pipeline->frames_ready.notify();
+                    shard->pipeline->events_space.notify();
+                }
+                for (auto &shard : shards_)
+                {
+                    if (shard->pipeline->parser.joinable())
+                        shard->pipeline->parser.join();
+                }
+
+                // Parsers are gone: distribution drains what they queued, then exits
+                events_ready_->notify();
+                distribution_thread_.join();
+            }
+
+            void CoinbaseFeed::parser_loop(Pipeline &pipeline)
+            {
+                parser_pipeline_ = &pipeline;
+                while (true)
+                {
+                    Frame *frame = pipeline.frames.front();
+                    if (!frame)
                     {
-                        std::string product_id = json["product_id"];
-                        double price = std::stod(json["price"].get<std::string>());
-                        double size = std::stod(json["size"].get<std::string>());
+                        if (pipeline_stop_.load(std::memory_order_acquire))
+                            break;
+                        pipeline.frames_ready.wait([&]
+                                                   { return pipeline.frames.front() != nullptr || pipeline_stop_.load(std::memory_order_acquire); });
+                        continue;
+                    }
 
-                        // Convert to DTC format
-                        exchanges::base::MarketTrade trade;
-                        trade.symbol = product_id;
-                        trade.price = price;
-                        trade.volume = size;
-                        trade.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                              std::chrono::system_clock::now().time_since_epoch())
-                                              .count();
+                    process_message(frame->payload, frame->receive_time_us);
 
-                        // Forward to base class
-                        on_trade_received(trade);
+                    // Keep ordinary buffers for reuse, not the occasional multi-megabyte snapshot
+                    if (frame->payload.capacity() > MAX_RETAINED_FRAME_BYTES)
+                        std::string().swap(frame->payload);
+                    pipeline.frames.pop();
+                    pipeline.frames_space.notify();
+                }
+                parser_pipeline_ = nullptr;
+            }
+
+            void CoinbaseFeed::enqueue_event(Pipeline &pipeline, const base::MarketEvent &event, std::shared_ptr<const base::OrderBook> book)
+            {
+                // The book goes first: distribution takes it when it reaches the SNAPSHOT event
+                bool snapshot = event.type == base::MarketEvent::Type::DEPTH &&
+                                event.depth.action == base::MarketDepthUpdate::Action::SNAPSHOT;
+                if (snapshot)
+                {
+                    auto *slot = claim_slot(pipeline.snapshots, pipeline.events_space, pipeline_stop_, pipeline.parser_stalls);
+                    if (!slot)
+                        return;
+                    *slot = std::move(book);
+                    pipeline.snapshots.publish();
+                }
+
+                base::MarketEvent *slot = claim_slot(pipeline.events, pipeline.events_space, pipeline_stop_, pipeline.parser_stalls);
+                if (!slot)
+                    return;
+                *slot = event;
+                pipeline.events.publish();
+                events_ready_->notify();
+            }
+
+            void CoinbaseFeed::distribution_loop()
+            {
+                auto pending = [this]
+                {
+                    for (const auto &shard : shards_)
+                    {
+                        if (!shard->pipeline->events.empty())
+                            return true;
+                    }
+                    return false;
+                };
+
+                while (true)
+                {
+                    bool delivered = false;
+                    for (auto &shard : shards_)
+                    {
+                        auto &pipeline = *shard->pipeline;
+                        size_t count = 0;
+                        for (base::MarketEvent *event; count < DISTRIBUTION_BATCH && (event = pipeline.events.front()) != nullptr; ++count)
+                        {
+                            deliver_event(pipeline, *event);
+                            pipeline.events.pop();
+                        }
+                        if (count > 0)
+                        {
+                            pipeline.events_space.notify();
+                            delivered = true;
+                        }
+                    }
+
+                    if (!delivered)
+                    {
+                        if (pipeline_stop_.load(std::memory_order_acquire))
+                            break;
+                        events_ready_->wait([&]
+                                            { return pending() || pipeline_stop_.load(std::memory_order_acquire); });
                     }
                 }
-                catch (const std::exception &e)
+            }
+
+            void CoinbaseFeed::deliver_event(Pipeline &pipeline, const base::MarketEvent &event)
+            {
+                std::lock_guard<std::mutex> lock(publish_mutex_);
+                switch (event.type)
+                {
+                case base::MarketEvent::Type::TRADE:
+                    notify_trade(event.trade);
+                    break;
+                case base::MarketEvent::Type::LEVEL2:
+                    notify_level2(event.level2);
+                    break;
+                case base::MarketEvent::Type::DEPTH:
+                {
+                    std::shared_ptr<const base::OrderBook> book;
+                    if (event.depth.action == base::MarketDepthUpdate::Action::SNAPSHOT)
+                        pipeline.snapshots.try_pop(book);
+                    notify_depth(event.depth_update(std::move(book)));
+                    break;
+                }
+                }
+            }
+
+            void CoinbaseFeed::on_websocket_message_received(const std::string &message)
+            {
+                process_message(message, base::timestamp::now_us());
+            }
+
+            void CoinbaseFeed::process_message(const std::string &message, uint64_t receive_time_us)
+            {
+                // One pass over the message: dispatch on type, hot handlers read the scanned fields directly
+                FeedMessage fields;
+                if (!FeedMessageScanner::scan(message, fields))
+                {
+                    LOG_INFO("[ERROR] Failed to parse SSL WebSocket message: " + message.substr(0, 100));
+                    return;
+                }
+
+                if (fields.type == "l2update")
+                {
+                    handle_level2_message(fields, receive_time_us);
+                }
+                else if (fields.type == "match")
+                {
+                    handle_trade_message(fields, receive_time_us);
+                }
+                else if (fields.type == "ticker")
+                {
+                    handle_ticker_message(fields, receive_time_us);
+                }
+                else if (fields.type == "snapshot")
+                {
+                    handle_snapshot_message(message, receive_time_us);
+                }
+                else if (fields.type == "heartbeat")
+                {
+                    handle_heartbeat_message(message);
+                }
+                else if (fields.type == "subscriptions")
                 {
-                    LOG_INFO("[ERROR] Failed to parse trade message: " + std::string(e.what()));
+                    // Handle subscription confirmation from Coinbase
+                    handle_subscriptions_message(message);
+                }
+                else if (fields.type == "error")
+                {
+                    handle_error_message(message);
+                }
+                else if (!fields.type.empty())
+                {
+                    LOG_INFO("[COINBASE] Unknown message type: " + std::string(fields.type));
                 }
             }
 
-            void CoinbaseFeed::handle_level2_message(const std::string &message)
+            void CoinbaseFeed::handle_trade_message(const FeedMessage &message, uint64_t receive_time_us)
+            {
+                exchanges::base::MarketTrade trade;
+                if (message.product_id.empty() || !base::decimal::parse_decimal(message.price, trade.price) ||
+                    !base::decimal::parse_decimal(message.size, trade.volume))
+                {
+                    LOG_INFO("[ERROR] Malformed trade message for " + std::string(message.product_id));
+                    return;
+                }
+
+                trade.instrument = instrument_for(message.product_id);
+                if (trade.instrument == base::NO_INSTRUMENT)
+                    return; // Never loaded or subscribed
+                product_messages_[trade.instrument].fetch_add(1, std::memory_order_relaxed);
+                // Matches carry the maker's side; the aggressor took the other one
+                if (message.side == "buy")
+                    trade.side = base::TradeSide::SELL;
+                else if (message.side == "sell")
+                    trade.side = base::TradeSide::BUY;
+                std::from_chars(message.trade_id.data(), message.trade_id.data() + message.trade_id.size(), trade.trade_id);
+                stamp(trade, message, receive_time_us);
+                if (is_stale_trade(trade.instrument, trade.sequence, false))
+                    return;
+                on_trade_received(trade);
+            }
+
+            void CoinbaseFeed::handle_snapshot_message(const std::string &message, uint64_t receive_time_us)
             {
                 try
                 {
                     nlohmann::json json = nlohmann::json::parse(message);
 
-                    if (json.contains("product_id") && json.contains("changes"))
+                    if (!json.contains("product_id"))
+                        return;
+
+                    std::string product_id = json["product_id"];
+
+                    exchanges::base::MarketDepthUpdate update;
+                    update.instrument = instrument_for(product_id);
+                    if (update.instrument == base::NO_INSTRUMENT)
+                        return;
+                    // Snapshots carry no event time
+                    update.exchange_time_us = receive_time_us;
+                    update.receive_time_us = receive_time_us;
+
+                    // Full book: rebuild in one pass and hand subscribers a copy
+                    exchanges::base::OrderBook book;
+                    for (const char *side : {"bids", "asks"})
                     {
-                        std::string product_id = json["product_id"];
-                        auto changes = json["changes"];
+                        if (!json.contains(side))
+                            continue;
 
-                        for (const auto &change : changes)
+                        std::vector<exchanges::base::PriceLevel> levels;
+                        levels.reserve(json[side].size());
+                        for (const auto &level : json[side])
                         {
-                            if (change.size() >= 3)
+                            double price = 0.0, size = 0.0;
+                            if (level.size() >= 2 && level[0].is_string() && level[1].is_string() &&
+                                base::decimal::parse_decimal(level[0].get_ref<const std::string &>(), price) &&
+                                base::decimal::parse_decimal(level[1].get_ref<const std::string &>(), size))
                             {
-                                std::string side = change[0]; // "buy" or "sell"
-                                double price = std::stod(change[1].get<std::string>());
-                                double size = std::stod(change[2].get<std::string>());
+                                levels.emplace_back(price, size);
+                            }
+                        }
+                        book.load(side[0] == 'b' ? exchanges::base::BookSide::BID : exchanges::base::BookSide::ASK,
+                                  std::move(levels));
+                    }
 
-                                // Convert to DTC format
-                                exchanges::base::MarketLevel2 level2;
-                                level2.symbol = product_id;
+                    // In-stream snapshots are ordered with the deltas around them: nothing buffered is newer
+                    {
+                        std::lock_guard<std::mutex> lock(order_books_mutex_);
+                        auto &state = order_books_[update.instrument];
+                        state.fetched.reset();
+                        update.book = install_snapshot_locked(state, std::move(book), 0, false);
+                    }
 
-                                if (side == "buy")
-                                {
-                                    level2.bid_price = price;
-                                    level2.bid_size = size;
-                                    level2.ask_price = 0.0;
-                                    level2.ask_size = 0.0;
-                                }
-                                else
-                                {
-                                    level2.bid_price = 0.0;
-                                    level2.bid_size = 0.0;
-                                    level2.ask_price = price;
-                                    level2.ask_size = size;
-                                }
+                    update.action = exchanges::base::MarketDepthUpdate::Action::SNAPSHOT;
+                    on_depth_received(update);
+                }
+                catch (const std::exception &e)
+                {
+                    LOG_INFO("[ERROR] Failed to parse level2 snapshot: " + std::string(e.what()));
+                }
+            }
 
-                                level2.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                                       std::chrono::system_clock::now().time_since_epoch())
-                                                       .count();
+            void CoinbaseFeed::handle_level2_message(const FeedMessage &message, uint64_t receive_time_us)
+            {
+                if (message.product_id.empty() || message.changes.empty())
+                    return;
 
-                                // Forward to base class
-                                on_level2_received(level2);
-                            }
+                exchanges::base::MarketDepthUpdate update;
+                update.instrument = instrument_for(message.product_id);
+                if (update.instrument == base::NO_INSTRUMENT)
+                    return;
+                product_messages_[update.instrument].fetch_add(1, std::memory_order_relaxed);
+                stamp(update, message, receive_time_us);
+
+                // Apply every change first, then emit only those that moved the book
+                std::vector<exchanges::base::BookDelta> deltas;
+                std::shared_ptr<exchanges::base::OrderBook> recovered;
+                bool resync = false;
+                {
+                    std::lock_guard<std::mutex> lock(order_books_mutex_);
+                    auto &state = order_books_[update.instrument];
+
+                    // The Exchange level2 channel sends no sequence; when one is present it must be contiguous
+                    if (update.sequence != 0)
+                    {
+                        auto result = state.level2_sequence.observe(update.sequence);
+                        if (result == base::SequenceTracker::Result::STALE)
+                        {
+                            sync_stats_.out_of_order++;
+                            return;
+                        }
+                        if (result == base::SequenceTracker::Result::GAP)
+                        {
+                            sync_stats_.gaps++;
+                            sync_stats_.missed_messages += state.level2_sequence.missing();
+                            resync = mark_stale_locked(state);
                         }
                     }
+
+                    if (!state.synced && state.fetched)
+                    {
+                        auto fetched = std::move(state.fetched);
+                        recovered = install_snapshot_locked(state, std::move(*fetched), state.fetched_time_us, true);
+                    }
+
+                    std::string_view cursor = message.changes;
+                    std::string_view side, price_text, size_text;
+                    while (FeedMessageScanner::next_change(cursor, side, price_text, size_text))
+                    {
+                        double price = 0.0, size = 0.0;
+                        if (!base::decimal::parse_decimal(price_text, price) || !base::decimal::parse_decimal(size_text, size))
+                            continue;
+
+                        // "buy" or "sell"; size "0" removes the level
+                        auto book_side = side == "buy" ? exchanges::base::BookSide::BID : exchanges::base::BookSide::ASK;
+                        if (!state.synced)
+                        {
+                            state.pending.push_back({book_side, price, size, update.exchange_time_us});
+                            sync_stats_.buffered_deltas++;
+                            continue;
+                        }
+
+                        auto delta = state.book.apply(book_side, price, size);
+                        if (delta.type != exchanges::base::BookDelta::Type::NONE)
+                            deltas.push_back(delta);
+                    }
+
+                    // No snapshot is coming for this book (e.g. deltas after an unsubscribe raced it): ask for one
+                    if (state.pending.size() > MAX_PENDING_CHANGES)
+                    {
+                        state.pending.clear();
+                        resync = mark_stale_locked(state) || resync;
+                    }
+
+                    // A consistent book is never crossed; one that is has lost a change
+                    const auto *bid = state.book.best_bid();
+                    const auto *ask = state.book.best_ask();
+                    if (state.synced && bid && ask && bid->price >= ask->price)
+                    {
+                        sync_stats_.crossed_books++;
+                        deltas.clear();
+                        resync = mark_stale_locked(state) || resync;
+                    }
                 }
-                catch (const std::exception &e)
+
+                if (recovered)
+                {
+                    exchanges::base::MarketDepthUpdate snapshot = update;
+                    snapshot.action = exchanges::base::MarketDepthUpdate::Action::SNAPSHOT;
+                    snapshot.book = std::move(recovered);
+                    on_depth_received(snapshot);
+                }
+
+                update.action = exchanges::base::MarketDepthUpdate::Action::SET;
+                for (const auto &delta : deltas)
+                {
+                    update.is_bid = (delta.side == exchanges::base::BookSide::BID);
+                    update.price = delta.price;
+                    update.size = delta.size;
+                    update.delta = delta;
+                    on_depth_received(update);
+                }
+
+                if (resync)
+                    request_book_snapshot(std::string(message.product_id));
+            }
+
+            bool CoinbaseFeed::is_stale_trade(base::InstrumentId instrument, uint64_t sequence, bool ticker)
+            {
+                if (sequence == 0)
+                    return false;
+
+                std::lock_guard<std::mutex> lock(order_books_mutex_);
+                auto &state = order_books_[instrument];
+                auto &tracker = ticker ? state.ticker_sequence : state.match_sequence;
+                if (tracker.observe(sequence) != base::SequenceTracker::Result::STALE)
+                    return false;
+
+                sync_stats_.out_of_order++;
+                return true;
+            }
+
+            bool CoinbaseFeed::mark_stale_locked(ProductBook &state)
+            {
+                // Already waiting: the snapshot on its way covers this too
+                if (state.resync_requested)
+                    return false;
+
+                state.synced = false;
+                state.resync_requested = true;
+                state.stale_since = std::chrono::steady_clock::now();
+                state.pending.clear();
+                state.fetched.reset();
+                return true;
+            }
+
+            std::shared_ptr<base::OrderBook> CoinbaseFeed::install_snapshot_locked(ProductBook &state, base::OrderBook &&book,
+                                                                                   uint64_t snapshot_time_us, bool replay_pending)
+            {
+                state.book = std::move(book);
+
+                // Changes the snapshot already reflects are older than it; without a time replay them all
+                if (replay_pending)
+                {
+                    for (const auto &change : state.pending)
+                    {
+                        if (change.exchange_time_us >= snapshot_time_us)
+                            state.book.apply(change.side, change.price, change.size);
+                    }
+                }
+                state.pending.clear();
+                state.synced = true;
+                state.level2_sequence.reset();
+
+                if (state.resync_requested)
+                {
+                    auto recovery_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                                                 std::chrono::steady_clock::now() - state.stale_since)
+                                                                 .count());
+                    state.resync_requested = false;
+                    sync_stats_.resyncs++;
+                    sync_stats_.last_recovery_us = recovery_us;
+                    sync_stats_.max_recovery_us = std::max(sync_stats_.max_recovery_us, recovery_us);
+                }
+
+                return std::make_shared<base::OrderBook>(state.book);
+            }
+
+            void CoinbaseFeed::request_book_snapshot(const std::string &product_id)
+            {
+                LOG_INFO("[COINBASE] Level2 book for " + product_id + " is stale, requesting a fresh snapshot");
+
+                if (resync_thread_.joinable())
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(resync_mutex_);
+                        if (std::find(resync_queue_.begin(), resync_queue_.end(), product_id) == resync_queue_.end())
+                            resync_queue_.push_back(product_id);
+                    }
+                    resync_cv_.notify_one();
+                    return;
+                }
+
+                resubscribe_level2(product_id);
+            }
+
+            void CoinbaseFeed::resubscribe_level2(const std::string &product_id)
+            {
+                // The feed answers a level2 subscribe with a snapshot
+                size_t index = 0;
+                bool live = false;
+                {
+                    std::lock_guard<std::mutex> lock(subscription_batcher_mutex_);
+                    live = shard_planner_.shard_of(product_id, index) && index < shards_.size() && shard_planner_.is_live(index);
+                    if (live)
+                    {
+                        auto now = std::chrono::steady_clock::now();
+                        shards_[index]->each_batcher([&](SubscriptionBatcher &batcher)
+                                                     { batcher.refresh(CHANNEL_LEVEL2, product_id, now); });
+                        expect_snapshot_locked(index, product_id);
+                    }
+                }
+                if (live)
+                {
+                    subscription_batcher_cv_.notify_one();
+                }
+                else
                 {
-                    LOG_INFO("[ERROR] Failed to parse level2 message: " + std::string(e.what()));
+                    LOG_INFO("[COINBASE] Not connected, " + product_id + " waits for the next level2 snapshot");
                 }
             }
 
+            void CoinbaseFeed::resync_loop()
+            {
+                auth::CDPCredentials credentials;
+                {
+                    std::lock_guard<std::mutex> lock(credentials_mutex_);
+                    credentials = credentials_;
+                }
+                CoinbaseRestClient rest_client(credentials);
+
+                while (true)
+                {
+                    std::string product_id;
+                    {
+                        std::unique_lock<std::mutex> lock(resync_mutex_);
+                        resync_cv_.wait(lock, [this]()
+                                        { return should_stop_.load() || !resync_queue_.empty(); });
+                        if (should_stop_.load())
+                            return;
+                        product_id = std::move(resync_queue_.front());
+                        resync_queue_.pop_front();
+                    }
+
+                    std::vector<base::PriceLevel> bids, asks;
+                    uint64_t time_us = 0;
+                    if (!rest_client.get_product_book(product_id, bids, asks, time_us))
+                    {
+                        LOG_INFO("[COINBASE] REST snapshot for " + product_id + " failed, re-subscribing: " + rest_client.get_last_error());
+                        resubscribe_level2(product_id);
+                        continue;
+                    }
+
+                    auto fetched = std::make_shared<base::OrderBook>();
+                    fetched->load(base::BookSide::BID, std::move(bids));
+                    fetched->load(base::BookSide::ASK, std::move(asks));
+
+                    // Installed by the feed thread with the next update, so depth events stay in order
+                    std::lock_guard<std::mutex> lock(order_books_mutex_);
+                    auto instrument = base::SymbolRegistry::getInstance().find(config_.name, product_id);
+                    auto it = order_books_.find(instrument);
+                    if (it != order_books_.end() && !it->second.synced)
+                    {
+                        it->second.fetched = std::move(fetched);
+                        it->second.fetched_time_us = time_us;
+                    }
+                }
+            }
+
+            CoinbaseFeed::BookSyncStats CoinbaseFeed::get_book_sync_stats() const
+            {
+                std::lock_guard<std::mutex> lock(order_books_mutex_);
+                BookSyncStats stats = sync_stats_;
+                stats.stale_books = 0;
+                for (const auto &[instrument, state] : order_books_)
+                {
+                    if (state.resync_requested)
+                        stats.stale_books++;
+                }
+                return stats;
+            }
+
+            CoinbaseFeed::PipelineStats CoinbaseFeed::get_pipeline_stats() const
+            {
+                PipelineStats stats;
+                stats.wait = config_.pipeline_wait;
+
+                std::lock_guard<std::mutex> lock(subscription_batcher_mutex_);
+                for (const auto &shard : shards_)
+                {
+                    if (!shard->pipeline)
+                        continue;
+                    const auto &pipeline = *shard->pipeline;
+                    stats.enabled = true;
+                    stats.frames.push_back({pipeline.frames.size(), pipeline.frames.capacity(), pipeline.frames.high_water(),
+                                            pipeline.frames.published(), pipeline.reader_stalls.load(std::memory_order_relaxed)});
+                    stats.events.push_back({pipeline.events.size(), pipeline.events.capacity(), pipeline.events.high_water(),
+                                            pipeline.events.published(), pipeline.parser_stalls.load(std::memory_order_relaxed)});
+                }
+                return stats;
+            }
+
+            std::vector<FeedArbiter::Stats> CoinbaseFeed::get_arbitration_stats() const
+            {
+                std::vector<FeedArbiter::Stats> stats;
+                std::lock_guard<std::mutex> lock(subscription_batcher_mutex_);
+                for (const auto &shard : shards_)
+                {
+                    if (!shard->arbiter)
+                        continue;
+                    std::lock_guard<std::mutex> arbiter_lock(shard->arbiter_mutex);
+                    stats.push_back(shard->arbiter->stats());
+                }
+                return stats;
+            }
+
+            CoinbaseFeed::ReconnectStats CoinbaseFeed::get_reconnect_stats() const
+            {
+                std::lock_guard<std::mutex> lock(subscription_batcher_mutex_);
+                std::lock_guard<std::mutex> reconnect_lock(reconnect_mutex_);
+                ReconnectStats stats = reconnect_stats_;
+                for (const auto &shard : shards_)
+                {
+                    for (const auto &link : shard->links)
+                    {
+                        if (link.resyncing)
+                            stats.recent.push_back(link.record);
+                    }
+                }
+                return stats;
+            }
+
+            bool CoinbaseFeed::get_top_of_book(const std::string &product_id, base::MarketLevel2 &top) const
+            {
+                auto instrument = base::SymbolRegistry::getInstance().find(config_.name, product_id);
+
+                std::lock_guard<std::mutex> lock(order_books_mutex_);
+                auto it = order_books_.find(instrument);
+                if (it == order_books_.end() || !it->second.synced)
+                    return false;
+
+                const auto *bid = it->second.book.best_bid();
+                const auto *ask = it->second.book.best_ask();
+                if (!bid && !ask)
+                    return false;
+
+                top.instrument = instrument;
+                top.bid_price = bid ? bid->price : 0.0;
+                top.bid_size = bid ? bid->size : 0.0;
+                top.ask_price = ask ? ask->price : 0.0;
+                top.ask_size = ask ? ask->size : 0.0;
+                top.exchange_time_us = base::timestamp::now_us();
+                top.receive_time_us = top.exchange_time_us;
+                return true;
+            }
+
+            bool CoinbaseFeed::get_order_book_depth(const std::string &product_id, size_t max_levels,
+                                                    std::vector<base::PriceLevel> &bids,
+                                                    std::vector<base::PriceLevel> &asks) const
+            {
+                auto instrument = base::SymbolRegistry::getInstance().find(config_.name, product_id);
+
+                std::lock_guard<std::mutex> lock(order_books_mutex_);
+                auto it = order_books_.find(instrument);
+                if (it == order_books_.end() || !it->second.synced)
+                    return false;
+
+                bids = it->second.book.get_depth(base::BookSide::BID, max_levels);
+                asks = it->second.book.get_depth(base::BookSide::ASK, max_levels);
+                return true;
+            }
+
             void CoinbaseFeed::process_websocket_message(const std::string &message)
             {
                 try
@@ -675,18 +1982,23 @@ namespace open_dtc_server
                     if (json.contains("product_id") && json.contains("price"))
                     {
                         std::string product_id = json["product_id"];
-                        double price = std::stod(json["price"].get<std::string>());
+                        double price = base::decimal::parse_decimal_or(json["price"].get_ref<const std::string &>(), 0.0);
 
                         util::log_debug("[COINBASE] Ticker update: " + product_id + " = $" + std::to_string(price));
 
                         // Convert ticker to trade format for DTC
                         exchanges::base::MarketTrade trade;
-                        trade.symbol = product_id;
+                        trade.instrument = instrument_for(product_id);
+                        if (trade.instrument == base::NO_INSTRUMENT)
+                            return;
                         trade.price = price;
-                        trade.volume = json.contains("last_size") ? std::stod(json["last_size"].get<std::string>()) : 1.0;
-                        trade.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                              std::chrono::system_clock::now().time_since_epoch())
-                                              .count();
+                        trade.volume = base::decimal::parse_decimal_or(json.value("last_size", ""), 1.0);
+                        trade.receive_time_us = base::timestamp::now_us();
+                        if (!json.contains("time") || !json["time"].is_string() ||
+                            !base::timestamp::parse_iso8601(json["time"].get_ref<const std::string &>(), trade.exchange_time_us))
+                            trade.exchange_time_us = trade.receive_time_us;
+                        if (json.contains("sequence") && json["sequence"].is_number_unsigned())
+                            trade.sequence = json["sequence"].get<uint64_t>();
 
                         // Forward to DTC clients
                         on_trade_received(trade);
@@ -695,12 +2007,14 @@ namespace open_dtc_server
                         if (json.contains("best_bid") && json.contains("best_ask"))
                         {
                             exchanges::base::MarketLevel2 level2;
-                            level2.symbol = product_id;
-                            level2.bid_price = std::stod(json["best_bid"].get<std::string>());
-                            level2.ask_price = std::stod(json["best_ask"].get<std::string>());
-                            level2.bid_size = json.contains("best_bid_size") ? std::stod(json["best_bid_size"].get<std::string>()) : 1.0;
-                            level2.ask_size = json.contains("best_ask_size") ? std::stod(json["best_ask_size"].get<std::string>()) : 1.0;
-                            level2.timestamp = trade.timestamp;
+                            level2.instrument = trade.instrument;
+                            level2.bid_price = base::decimal::parse_decimal_or(json["best_bid"].get_ref<const std::string &>(), 0.0);
+                            level2.ask_price = base::decimal::parse_decimal_or(json["best_ask"].get_ref<const std::string &>(), 0.0);
+                            level2.bid_size = base::decimal::parse_decimal_or(json.value("best_bid_size", ""), 1.0);
+                            level2.ask_size = base::decimal::parse_decimal_or(json.value("best_ask_size", ""), 1.0);
+                            level2.exchange_time_us = trade.exchange_time_us;
+                            level2.receive_time_us = trade.receive_time_us;
+                            level2.sequence = trade.sequence;
 
                             // Forward to DTC clients
                             on_level2_received(level2);
@@ -713,52 +2027,52 @@ namespace open_dtc_server
                 }
             }
 
-            void CoinbaseFeed::handle_ticker_message(const std::string &message)
+            void CoinbaseFeed::handle_ticker_message(const FeedMessage &message, uint64_t receive_time_us)
             {
-                try
-                {
-                    nlohmann::json json = nlohmann::json::parse(message);
+                exchanges::base::MarketTrade trade;
+                if (message.product_id.empty() || !base::decimal::parse_decimal(message.price, trade.price))
+                    return;
 
-                    if (json.contains("product_id") && json.contains("price"))
-                    {
-                        std::string product_id = json["product_id"];
-                        double price = std::stod(json["price"].get<std::string>());
+                trade.instrument = instrument_for(message.product_id);
+                if (trade.instrument == base::NO_INSTRUMENT)
+                    return;
+                product_messages_[trade.instrument].fetch_add(1, std::memory_order_relaxed);
 
-                        // Log ticker updates occasionally
-                        static int ticker_count = 0;
-                        ticker_count++;
-                        if (ticker_count % 100 == 0) // Log every 100th ticker
-                        {
-                            LOG_INFO("[COINBASE] Ticker " + product_id + ": $" + std::to_string(price));
-                        }
+                // Log ticker updates occasionally
+                static std::atomic<uint64_t> ticker_count{0};
+                if (++ticker_count % 100 == 0) // Log every 100th ticker
+                {
+                    LOG_INFO("[COINBASE] Ticker " + std::string(message.product_id) + ": $" + std::to_string(trade.price));
+                }
 
-                        // Forward as trade update to DTC clients
-                        exchanges::base::MarketTrade trade;
-                        trade.symbol = product_id;
-                        trade.price = price;
-                        trade.volume = json.contains("last_size") ? std::stod(json["last_size"].get<std::string>()) : 1.0;
-                        trade.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                              std::chrono::system_clock::now().time_since_epoch())
-                                              .count();
-                        on_trade_received(trade);
+                // Forward as trade update to DTC clients
+                if (!base::decimal::parse_decimal(message.last_size, trade.volume))
+                    trade.volume = 1.0;
+                // Ticker side is the taker's
+                if (message.side == "buy")
+                    trade.side = base::TradeSide::BUY;
+                else if (message.side == "sell")
+                    trade.side = base::TradeSide::SELL;
+                std::from_chars(message.trade_id.data(), message.trade_id.data() + message.trade_id.size(), trade.trade_id);
+                stamp(trade, message, receive_time_us);
+                if (is_stale_trade(trade.instrument, trade.sequence, true))
+                    return;
+                on_trade_received(trade);
 
-                        // Also forward best bid/ask as level2 if available
-                        if (json.contains("best_bid") && json.contains("best_ask"))
-                        {
-                            exchanges::base::MarketLevel2 level2;
-                            level2.symbol = product_id;
-                            level2.bid_price = std::stod(json["best_bid"].get<std::string>());
-                            level2.ask_price = std::stod(json["best_ask"].get<std::string>());
-                            level2.bid_size = json.contains("best_bid_size") ? std::stod(json["best_bid_size"].get<std::string>()) : 1.0;
-                            level2.ask_size = json.contains("best_ask_size") ? std::stod(json["best_ask_size"].get<std::string>()) : 1.0;
-                            level2.timestamp = trade.timestamp;
-                            on_level2_received(level2);
-                        }
-                    }
-                }
-                catch (const std::exception &e)
+                // Also forward best bid/ask as level2 if available
+                exchanges::base::MarketLevel2 level2;
+                if (base::decimal::parse_decimal(message.best_bid, level2.bid_price) &&
+                    base::decimal::parse_decimal(message.best_ask, level2.ask_price))
                 {
-                    LOG_INFO("[ERROR] Failed to parse ticker message: " + std::string(e.what()));
+                    level2.instrument = trade.instrument;
+                    if (!base::decimal::parse_decimal(message.best_bid_size, level2.bid_size))
+                        level2.bid_size = 1.0;
+                    if (!base::decimal::parse_decimal(message.best_ask_size, level2.ask_size))
+                        level2.ask_size = 1.0;
+                    level2.exchange_time_us = trade.exchange_time_us;
+                    level2.receive_time_us = trade.receive_time_us;
+                    level2.sequence = trade.sequence;
+                    on_level2_received(level2);
                 }
             }
 
@@ -820,8 +2134,13 @@ namespace open_dtc_server
                         std::lock_guard<std::mutex> lock(pending_subscriptions_mutex_);
                         for (const auto &product : failed_products)
                         {
-                            // Unconditionally set failure result so waiters can observe it
-                            subscription_results_[product] = false;
+                            // Errors do not name the channel: fail every pending one for the product
+                            for (const auto &[key, requested_at] : pending_subscriptions_)
+                            {
+                                if (key.size() > product.size() && key.compare(key.size() - product.size(), product.size(), product) == 0 &&
+                                    key[key.size() - product.size() - 1] == ':')
+                                    subscription_results_[key] = false;
+                            }
                             LOG_INFO("[COINBASE] Subscription failed for product: " + product + " - " + error_msg);
                         }
                         // Notify waiting threads
@@ -861,10 +2180,10 @@ namespace open_dtc_server
                                     {
                                         const std::string product_id = product.get<std::string>();
                                         LOG_INFO("[COINBASE] - Product: " + product_id);
-                                        // Mark subscription success for waiting requests
+                                        // Mark subscription success for waiting requests on this channel
                                         {
                                             std::lock_guard<std::mutex> lock(pending_subscriptions_mutex_);
-                                            subscription_results_[product_id] = true;
+                                            subscription_results_[subscription_key(channel_name, product_id)] = true;
                                             subscription_cv_.notify_all();
                                         }
                                     }
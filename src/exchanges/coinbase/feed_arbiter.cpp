@@ -0,0 +1,173 @@
+#include "coinbase_dtc_core/exchanges/coinbase/feed_arbiter.hpp"
+#include "coinbase_dtc_core/exchanges/base/timestamp.hpp"
+#include <algorithm>
+#include <charconv>
+#include <functional>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace coinbase
+        {
+
+            namespace
+            {
+                // splitmix64 finalizer: spreads ids that differ in low bits over the whole table
+                uint64_t mix(uint64_t x)
+                {
+                    x ^= x >> 30;
+                    x *= 0xbf58476d1ce4e5b9ULL;
+                    x ^= x >> 27;
+                    x *= 0x94d049bb133111ebULL;
+                    x ^= x >> 31;
+                    return x;
+                }
+
+                size_t index_of(FeedSide side) { return static_cast<size_t>(side); }
+            } // namespace
+
+            static_assert((FeedArbiter::RECENT_MESSAGES & (FeedArbiter::RECENT_MESSAGES - 1)) == 0, "Arrival table is masked");
+
+            FeedArbiter::FeedArbiter(uint64_t quiet_after_us)
+                : quiet_after_us_(quiet_after_us), recent_(RECENT_MESSAGES)
+            {
+            }
+
+            bool FeedArbiter::accept(FeedSide side, const FeedMessage &fields, uint64_t receive_time_us)
+            {
+                bool snapshot = fields.type == "snapshot";
+                if (!snapshot && fields.type != "match" && fields.type != "ticker" && fields.type != "l2update")
+                {
+                    stats_.passed++;
+                    return true;
+                }
+
+                SideStats &mine = stats_.sides[index_of(side)];
+                mine.received++;
+                mine.last_message_us = receive_time_us;
+
+                uint64_t product = std::hash<std::string_view>()(fields.product_id);
+                if (snapshot)
+                {
+                    // The other side's snapshot was taken at another moment: nothing to measure against.
+                    // Either way this side's updates start over after it
+                    Level2Position &position = level2_positions_[product];
+                    position.time_us[index_of(side)] = 0;
+                    position.index[index_of(side)] = 0;
+                    if (!snapshots_.insert(std::string(fields.product_id)).second)
+                    {
+                        mine.duplicates++;
+                        return false;
+                    }
+                }
+                else
+                {
+                    std::string_view id_text = fields.type == "match" && !fields.trade_id.empty() ? fields.trade_id : fields.sequence;
+                    uint64_t id = 0;
+                    bool has_id = !id_text.empty() &&
+                                  std::from_chars(id_text.data(), id_text.data() + id_text.size(), id).ec == std::errc();
+                    uint64_t time_us = 0; // Exchange time; aligns updates without an id
+
+                    if (has_id)
+                    {
+                        uint64_t stream = mix(std::hash<std::string_view>()(fields.type)) ^ product;
+                        uint64_t key = mix(stream ^ mix(id)) | 1;
+                        if (duplicate(side, key, receive_time_us))
+                            return false;
+
+                        // Not in the window: this side is far behind, or the message is out of order
+                        uint64_t &last = last_ids_[stream];
+                        if (id <= last)
+                        {
+                            mine.duplicates++;
+                            return false;
+                        }
+                        last = id;
+                        remember(side, key, receive_time_us);
+                    }
+                    else if (base::timestamp::parse_iso8601(fields.time, time_us))
+                    {
+                        // No id: (time, index at that time) is the same on both sides, forwarded once whatever the lag.
+                        // With neither id nor time there is nothing to align on, and both copies are forwarded
+                        Level2Position &position = level2_positions_[product];
+                        size_t mine_index = index_of(side);
+                        if (time_us != position.time_us[mine_index])
+                        {
+                            position.time_us[mine_index] = time_us;
+                            position.index[mine_index] = 0;
+                        }
+                        uint64_t index = ++position.index[mine_index];
+                        uint64_t key = mix(product ^ mix(time_us ^ mix(index))) | 1;
+                        if (time_us < position.forwarded_time_us ||
+                            (time_us == position.forwarded_time_us && index <= position.forwarded_index))
+                        {
+                            // The first copy's arrival may have left the window; then only the lead is unknown
+                            if (!duplicate(side, key, receive_time_us))
+                                mine.duplicates++;
+                            return false;
+                        }
+                        position.forwarded_time_us = time_us;
+                        position.forwarded_index = index;
+                        remember(side, key, receive_time_us);
+                    }
+                }
+
+                mine.first++;
+                FeedSide other = side == FeedSide::A ? FeedSide::B : FeedSide::A;
+                if (last_forwarded_ == other && stats_.sides[index_of(other)].last_message_us != 0 &&
+                    is_quiet(other, receive_time_us))
+                    stats_.failovers++;
+                last_forwarded_ = side;
+                return true;
+            }
+
+            bool FeedArbiter::duplicate(FeedSide side, uint64_t key, uint64_t receive_time_us)
+            {
+                Arrival &slot = recent_[key & (RECENT_MESSAGES - 1)];
+                if (slot.key != key)
+                    return false;
+
+                stats_.sides[index_of(side)].duplicates++;
+                if (slot.side != side)
+                {
+                    SideStats &winner = stats_.sides[index_of(slot.side)];
+                    uint64_t lead = receive_time_us > slot.time_us ? receive_time_us - slot.time_us : 0;
+                    winner.leads++;
+                    winner.lead_us_total += lead;
+                    winner.lead_us_max = std::max(winner.lead_us_max, lead);
+                }
+                slot.key = 0; // Two copies at most
+                return true;
+            }
+
+            void FeedArbiter::remember(FeedSide side, uint64_t key, uint64_t receive_time_us)
+            {
+                Arrival &slot = recent_[key & (RECENT_MESSAGES - 1)];
+                slot.key = key;
+                slot.time_us = receive_time_us;
+                slot.side = side;
+            }
+
+            void FeedArbiter::expect_snapshot(const std::string &product_id)
+            {
+                snapshots_.erase(product_id);
+            }
+
+            void FeedArbiter::reset()
+            {
+                std::fill(recent_.begin(), recent_.end(), Arrival());
+                last_ids_.clear();
+                level2_positions_.clear();
+                snapshots_.clear();
+            }
+
+            bool FeedArbiter::is_quiet(FeedSide side, uint64_t now_us) const
+            {
+                uint64_t last = stats_.sides[index_of(side)].last_message_us;
+                return last == 0 || now_us > last + quiet_after_us_;
+            }
+
+        } // namespace coinbase
+    } // namespace exchanges
+} // namespace open_dtc_server
@@ -0,0 +1,244 @@
+#include "coinbase_dtc_core/exchanges/coinbase/feed_message_scanner.hpp"
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace coinbase
+        {
+
+            namespace
+            {
+                void skip_whitespace(std::string_view json, size_t &pos)
+                {
+                    while (pos < json.size() && (json[pos] == ' ' || json[pos] == '\n' || json[pos] == '\r' || json[pos] == '\t'))
+                        ++pos;
+                }
+
+                // pos at the opening quote; leaves pos after the closing quote
+                bool read_string(std::string_view json, size_t &pos, std::string_view &value)
+                {
+                    size_t start = ++pos;
+                    while (pos < json.size())
+                    {
+                        char c = json[pos];
+                        if (c == '"')
+                        {
+                            value = json.substr(start, pos - start);
+                            ++pos;
+                            return true;
+                        }
+                        pos += c == '\\' ? 2 : 1;
+                    }
+                    return false;
+                }
+
+                // pos at '[' or '{'; leaves pos after the matching bracket
+                bool skip_container(std::string_view json, size_t &pos)
+                {
+                    int depth = 0;
+                    while (pos < json.size())
+                    {
+                        char c = json[pos];
+                        if (c == '"')
+                        {
+                            std::string_view ignored;
+                            if (!read_string(json, pos, ignored))
+                                return false;
+                            continue;
+                        }
+                        if (c == '[' || c == '{')
+                            ++depth;
+                        else if ((c == ']' || c == '}') && --depth == 0)
+                        {
+                            ++pos;
+                            return true;
+                        }
+                        ++pos;
+                    }
+                    return false;
+                }
+
+                // Numbers, true, false, null
+                void skip_scalar(std::string_view json, size_t &pos)
+                {
+                    while (pos < json.size() && json[pos] != ',' && json[pos] != '}' && json[pos] != ']' &&
+                           json[pos] != ' ' && json[pos] != '\n' && json[pos] != '\r' && json[pos] != '\t')
+                        ++pos;
+                }
+
+                std::string_view *field_for(std::string_view key, FeedMessage &message)
+                {
+                    // Dispatch on length first: most keys are rejected without a compare
+                    switch (key.size())
+                    {
+                    case 4:
+                        if (key == "type")
+                            return &message.type;
+                        if (key == "size")
+                            return &message.size;
+                        if (key == "side")
+                            return &message.side;
+                        if (key == "time")
+                            return &message.time;
+                        break;
+                    case 5:
+                        if (key == "price")
+                            return &message.price;
+                        break;
+                    case 8:
+                        if (key == "best_bid")
+                            return &message.best_bid;
+                        if (key == "best_ask")
+                            return &message.best_ask;
+                        break;
+                    case 9:
+                        if (key == "last_size")
+                            return &message.last_size;
+                        break;
+                    case 10:
+                        if (key == "product_id")
+                            return &message.product_id;
+                        break;
+                    case 13:
+                        if (key == "best_bid_size")
+                            return &message.best_bid_size;
+                        if (key == "best_ask_size")
+                            return &message.best_ask_size;
+                        break;
+                    }
+                    return nullptr;
+                }
+
+                bool expect(std::string_view json, size_t &pos, char c)
+                {
+                    skip_whitespace(json, pos);
+                    if (pos >= json.size() || json[pos] != c)
+                        return false;
+                    ++pos;
+                    return true;
+                }
+            } // namespace
+
+            bool FeedMessageScanner::scan(std::string_view json, FeedMessage &message)
+            {
+                message = FeedMessage();
+
+                size_t pos = 0;
+                if (!expect(json, pos, '{'))
+                    return false;
+
+                skip_whitespace(json, pos);
+                if (pos < json.size() && json[pos] == '}')
+                    return true;
+
+                while (pos < json.size())
+                {
+                    skip_whitespace(json, pos);
+                    std::string_view key;
+                    if (pos >= json.size() || json[pos] != '"' || !read_string(json, pos, key) || !expect(json, pos, ':'))
+                        return false;
+
+                    skip_whitespace(json, pos);
+                    if (pos >= json.size())
+                        return false;
+
+                    char c = json[pos];
+                    if (c == '"')
+                    {
+                        std::string_view value;
+                        if (!read_string(json, pos, value))
+                            return false;
+                        if (auto *field = field_for(key, message))
+                            *field = value;
+                    }
+                    else if (c == '[' || c == '{')
+                    {
+                        size_t start = pos;
+                        if (!skip_container(json, pos))
+                            return false;
+                        if (c == '[' && key == "changes")
+                            message.changes = json.substr(start + 1, pos - start - 2);
+                    }
+                    else
+                    {
+                        size_t start = pos;
+                        skip_scalar(json, pos);
+                        if (key == "trade_id")
+                            message.trade_id = json.substr(start, pos - start);
+                        else if (key == "sequence")
+                            message.sequence = json.substr(start, pos - start);
+                    }
+
+                    skip_whitespace(json, pos);
+                    if (pos >= json.size())
+                        return false;
+                    if (json[pos] == '}')
+                        return true;
+                    if (json[pos] != ',')
+                        return false;
+                    ++pos;
+                }
+                return false;
+            }
+
+            bool FeedMessageScanner::next_change(std::string_view &cursor, std::string_view &side,
+                                                 std::string_view &price, std::string_view &size)
+            {
+                size_t pos = 0;
+                skip_whitespace(cursor, pos);
+                if (pos < cursor.size() && cursor[pos] == ',')
+                    ++pos;
+                if (!expect(cursor, pos, '['))
+                {
+                    cursor = std::string_view();
+                    return false;
+                }
+
+                std::string_view *values[] = {&side, &price, &size};
+                for (size_t i = 0; i < 3; ++i)
+                {
+                    if ((i > 0 && !expect(cursor, pos, ',')) || !expect(cursor, pos, '"'))
+                    {
+                        cursor = std::string_view();
+                        return false;
+                    }
+                    --pos; // read_string starts at the quote
+                    if (!read_string(cursor, pos, *values[i]))
+                    {
+                        cursor = std::string_view();
+                        return false;
+                    }
+                }
+
+                // Tolerate extra entries (newer feeds append a timestamp)
+                skip_whitespace(cursor, pos);
+                while (pos < cursor.size() && cursor[pos] == ',')
+                {
+                    ++pos;
+                    skip_whitespace(cursor, pos);
+                    if (pos < cursor.size() && cursor[pos] == '"')
+                    {
+                        std::string_view ignored;
+                        if (!read_string(cursor, pos, ignored))
+                            break;
+                    }
+                    else
+                    {
+                        skip_scalar(cursor, pos);
+                    }
+                    skip_whitespace(cursor, pos);
+                }
+                if (!expect(cursor, pos, ']'))
+                {
+                    cursor = std::string_view();
+                    return false;
+                }
+
+                cursor.remove_prefix(pos);
+                return true;
+            }
+
+        } // namespace coinbase
+    } // namespace exchanges
+} // namespace open_dtc_server
@@ -0,0 +1,145 @@
+#include "coinbase_dtc_core/exchanges/coinbase/order_client.hpp"
+#include "coinbase_dtc_core/exchanges/coinbase/endpoint.hpp"
+#include "coinbase_dtc_core/core/util/advanced_log.hpp"
+#include <curl/curl.h>
+#include <stdexcept>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace coinbase
+        {
+
+            namespace
+            {
+                size_t append_body(void *contents, size_t size, size_t nmemb, void *userp)
+                {
+                    static_cast<std::string *>(userp)->append(static_cast<char *>(contents), size * nmemb);
+                    return size * nmemb;
+                }
+
+                // JWT uri claim path for the ORDERS endpoint
+                const std::string ORDERS_JWT_PATH = std::string("/api/v3/brokerage/") + endpoints::ORDERS;
+            } // namespace
+
+            CoinbaseOrderClient::CoinbaseOrderClient(const auth::CDPCredentials &credentials, const std::string &base_url, int timeout_seconds)
+                : authenticator_(std::make_unique<auth::JWTAuthenticator>(credentials)),
+                  base_url_(base_url), timeout_seconds_(timeout_seconds)
+            {
+                curl_ = curl_easy_init();
+                if (!curl_)
+                    throw std::runtime_error("Failed to initialize CURL for order entry");
+
+                CURL *curl = static_cast<CURL *>(curl_);
+                curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, append_body);
+                curl_easy_setopt(curl, CURLOPT_TIMEOUT, static_cast<long>(timeout_seconds_));
+                curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
+                curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 2L);
+                curl_easy_setopt(curl, CURLOPT_TCP_NODELAY, 1L);
+                curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+                curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+
+                LOG_INFO("[COINBASE-ORDERS] Order client created for " + base_url_);
+            }
+
+            CoinbaseOrderClient::~CoinbaseOrderClient()
+            {
+                if (curl_)
+                    curl_easy_cleanup(static_cast<CURL *>(curl_));
+            }
+
+            base::OrderResponse CoinbaseOrderClient::submit_order(const std::string &body)
+            {
+                // Normally signed by keep_warm; only the first order after a long stall pays for it here
+                if (next_token_.empty() || std::chrono::steady_clock::now() - token_signed_ >= TOKEN_MAX_AGE)
+                    sign_next_token();
+
+                std::string token;
+                token.swap(next_token_);
+                return perform(base_url_ + endpoints::ORDERS, &body, token);
+            }
+
+            bool CoinbaseOrderClient::keep_warm()
+            {
+                auto now = std::chrono::steady_clock::now();
+
+                if (next_token_.empty() || now - token_signed_ >= TOKEN_MAX_AGE)
+                    sign_next_token();
+
+                // The time endpoint is public: opens the TLS session, or keeps an idle one alive
+                if (!connected_ || now - last_request_ >= IDLE_PING_INTERVAL)
+                {
+                    auto response = perform(base_url_ + endpoints::TIME, nullptr, std::string());
+                    if (response.status_code <= 0)
+                        LOG_WARN("[COINBASE-ORDERS] Connection warm-up failed: " + response.error_message);
+                }
+                return connected_;
+            }
+
+            void CoinbaseOrderClient::sign_next_token()
+            {
+                try
+                {
+                    next_token_ = authenticator_->generate_token("POST", ORDERS_JWT_PATH);
+                    token_signed_ = std::chrono::steady_clock::now();
+                }
+                catch (const std::exception &e)
+                {
+                    next_token_.clear();
+                    LOG_ERROR("[COINBASE-ORDERS] Failed to sign order token: " + std::string(e.what()));
+                }
+            }
+
+            base::OrderResponse CoinbaseOrderClient::perform(const std::string &url, const std::string *post_body, const std::string &token)
+            {
+                base::OrderResponse result;
+                CURL *curl = static_cast<CURL *>(curl_);
+
+                std::string response_body;
+                curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+                curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_body);
+
+                struct curl_slist *headers = nullptr;
+                std::string auth_header = "Authorization: Bearer " + token;
+                if (post_body)
+                {
+                    headers = curl_slist_append(headers, auth_header.c_str());
+                    headers = curl_slist_append(headers, "Content-Type: application/json");
+                    curl_easy_setopt(curl, CURLOPT_POST, 1L);
+                    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, post_body->c_str());
+                    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(post_body->size()));
+                }
+                else
+                {
+                    curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+                }
+                headers = curl_slist_append(headers, "User-Agent: coinbase-dtc-core/1.0");
+                curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+
+                CURLcode res = curl_easy_perform(curl);
+                if (res == CURLE_OK)
+                {
+                    long status = 0;
+                    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+                    result.status_code = static_cast<int>(status);
+                    result.body = std::move(response_body);
+                    connected_ = true;
+                }
+                else
+                {
+                    result.status_code = -1;
+                    result.error_message = "CURL error: " + std::string(curl_easy_strerror(res));
+                    connected_ = false;
+                }
+                last_request_ = std::chrono::steady_clock::now();
+
+                // Headers must outlive the transfer only
+                curl_easy_setopt(curl, CURLOPT_HTTPHEADER, nullptr);
+                curl_slist_free_all(headers);
+                return result;
+            }
+
+        } // namespace coinbase
+    } // namespace exchanges
+} // namespace open_dtc_server
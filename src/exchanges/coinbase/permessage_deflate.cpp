@@ -0,0 +1,207 @@
+#include "coinbase_dtc_core/exchanges/coinbase/permessage_deflate.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <zlib.h>
+
+namespace open_dtc_server
+{
+    namespace feed
+    {
+        namespace coinbase
+        {
+
+            namespace
+            {
+                std::string trim(const std::string &text)
+                {
+                    size_t begin = text.find_first_not_of(" \t");
+                    if (begin == std::string::npos)
+                        return "";
+                    size_t end = text.find_last_not_of(" \t");
+                    return text.substr(begin, end - begin + 1);
+                }
+
+                std::string lowercase(std::string text)
+                {
+                    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c)
+                                   { return static_cast<char>(std::tolower(c)); });
+                    return text;
+                }
+
+                // "10" or "\"10\"", 8 to 15
+                bool parse_window_bits(std::string value, int &bits)
+                {
+                    if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+                        value = value.substr(1, value.size() - 2);
+                    if (value.empty() || value.size() > 2 || !std::all_of(value.begin(), value.end(), ::isdigit))
+                        return false;
+                    bits = std::stoi(value);
+                    return bits >= 8 && bits <= 15;
+                }
+
+                // Removed by the sender at the end of every message (RFC 7692 section 7.2.1)
+                const uint8_t SYNC_TAIL[4] = {0x00, 0x00, 0xff, 0xff};
+            } // namespace
+
+            bool parse_deflate_response(const std::string &extensions, DeflateParameters &parameters, bool &accepted)
+            {
+                accepted = false;
+                parameters = DeflateParameters();
+
+                // Comma-separated extensions, each "name; param; param=value"
+                size_t start = 0;
+                while (start <= extensions.size())
+                {
+                    size_t comma = extensions.find(',', start);
+                    std::string extension = extensions.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+                    start = comma == std::string::npos ? extensions.size() + 1 : comma + 1;
+
+                    size_t semicolon = extension.find(';');
+                    if (lowercase(trim(extension.substr(0, semicolon))) != "permessage-deflate")
+                        continue;
+                    if (accepted)
+                        return false; // Accepted twice
+
+                    accepted = true;
+                    while (semicolon != std::string::npos)
+                    {
+                        size_t next = extension.find(';', semicolon + 1);
+                        std::string parameter = trim(extension.substr(semicolon + 1, next == std::string::npos ? std::string::npos : next - semicolon - 1));
+                        semicolon = next;
+
+                        size_t equals = parameter.find('=');
+                        std::string name = lowercase(trim(parameter.substr(0, equals)));
+                        std::string value = equals == std::string::npos ? "" : trim(parameter.substr(equals + 1));
+
+                        if (name == "server_no_context_takeover" && equals == std::string::npos)
+                            parameters.server_no_context_takeover = true;
+                        else if (name == "client_no_context_takeover" && equals == std::string::npos)
+                            parameters.client_no_context_takeover = true;
+                        else if (name == "server_max_window_bits")
+                        {
+                            if (!parse_window_bits(value, parameters.server_max_window_bits))
+                                return false;
+                        }
+                        else if (name == "client_max_window_bits")
+                        {
+                            // We offered it without a value, so the server may answer with one
+                            if (!parse_window_bits(value, parameters.client_max_window_bits))
+                                return false;
+                        }
+                        else
+                        {
+                            return false;
+                        }
+                    }
+                }
+                return true;
+            }
+
+            Inflater::Inflater() : stream_(new z_stream_s())
+            {
+            }
+
+            Inflater::~Inflater()
+            {
+                stop();
+            }
+
+            bool Inflater::start(const DeflateParameters &parameters)
+            {
+                stop();
+                *stream_ = z_stream_s();
+
+                // The server's window may be smaller than ours; a full window always works
+                if (inflateInit2(stream_.get(), -MAX_WBITS) != Z_OK)
+                    return false;
+                active_ = true;
+                reset_each_message_ = parameters.server_no_context_takeover;
+                return true;
+            }
+
+            void Inflater::stop()
+            {
+                if (active_)
+                    inflateEnd(stream_.get());
+                active_ = false;
+            }
+
+            bool Inflater::inflate(const uint8_t *data, size_t size, std::string &out)
+            {
+                out.clear();
+                if (!active_)
+                    return false;
+
+                auto started = std::chrono::steady_clock::now();
+                size_t produced = 0;
+                bool ok = run(data, size, out, produced) && run(SYNC_TAIL, sizeof(SYNC_TAIL), out, produced);
+                out.resize(produced);
+
+                if (!ok || reset_each_message_)
+                    inflateReset(stream_.get());
+
+                inflate_ns_.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                                std::chrono::steady_clock::now() - started)
+                                                                .count()),
+                                      std::memory_order_relaxed);
+                compressed_bytes_.fetch_add(size, std::memory_order_relaxed);
+                if (!ok)
+                {
+                    errors_.fetch_add(1, std::memory_order_relaxed);
+                    out.clear();
+                    return false;
+                }
+                messages_.fetch_add(1, std::memory_order_relaxed);
+                inflated_bytes_.fetch_add(produced, std::memory_order_relaxed);
+                return true;
+            }
+
+            bool Inflater::run(const uint8_t *data, size_t size, std::string &out, size_t &produced)
+            {
+                z_stream_s &stream = *stream_;
+                stream.next_in = const_cast<Bytef *>(data);
+                stream.avail_in = static_cast<uInt>(size);
+
+                while (true)
+                {
+                    // Grow geometrically from a guess at the ratio; resize only zero-fills the new part
+                    if (produced == out.size())
+                        out.resize(std::max<size_t>({out.size() * 2, size * 4, 1024}));
+
+                    stream.next_out = reinterpret_cast<Bytef *>(&out[produced]);
+                    stream.avail_out = static_cast<uInt>(out.size() - produced);
+                    int ret = ::inflate(&stream, Z_SYNC_FLUSH);
+                    produced = out.size() - stream.avail_out;
+
+                    if (ret == Z_STREAM_END)
+                    {
+                        // The server ended its stream (BFINAL); the next message starts a new one
+                        inflateReset(&stream);
+                        return true;
+                    }
+                    if (ret != Z_OK && ret != Z_BUF_ERROR)
+                        return false;
+
+                    // Input used up and output not full: nothing more pending
+                    if (stream.avail_in == 0 && stream.avail_out != 0)
+                        return true;
+                    if (ret == Z_BUF_ERROR && stream.avail_out != 0)
+                        return false; // No progress with room to write: truncated input
+                }
+            }
+
+            Inflater::Stats Inflater::stats() const
+            {
+                Stats stats;
+                stats.messages = messages_.load(std::memory_order_relaxed);
+                stats.compressed_bytes = compressed_bytes_.load(std::memory_order_relaxed);
+                stats.inflated_bytes = inflated_bytes_.load(std::memory_order_relaxed);
+                stats.inflate_ns = inflate_ns_.load(std::memory_order_relaxed);
+                stats.errors = errors_.load(std::memory_order_relaxed);
+                return stats;
+            }
+
+        } // namespace coinbase
+    } // namespace feed
+} // namespace open_dtc_server
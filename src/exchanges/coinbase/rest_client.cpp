@@ -1,5 +1,8 @@
 #include "coinbase_dtc_core/exchanges/coinbase/rest_client.hpp"
 #include "coinbase_dtc_core/exchanges/coinbase/endpoint.hpp"
+#include "coinbase_dtc_core/exchanges/coinbase/order_fields.hpp"
+#include "coinbase_dtc_core/exchanges/base/decimal.hpp"
+#include "coinbase_dtc_core/exchanges/base/timestamp.hpp"
 #include "coinbase_dtc_core/core/util/advanced_log.hpp"
 #include <curl/curl.h>
 #include <stdexcept>
@@ -144,6 +147,70 @@ namespace open_dtc_server
                 return true;
             }
 
+            bool CoinbaseRestClient::get_open_orders(std::vector<base::OrderEvent> &orders)
+            {
+                LOG_INFO("[COINBASE-REST] Fetching open orders...");
+
+                orders.clear();
+                std::string cursor;
+                // Bounded so a misbehaving cursor cannot loop forever
+                for (int page = 0; page < 20; ++page)
+                {
+                    std::string path = std::string(endpoints::ORDERS_HISTORICAL) + "?order_status=OPEN&limit=1000";
+                    if (!cursor.empty())
+                        path += "&cursor=" + cursor;
+
+                    auto response = make_authenticated_request("GET", path, "");
+                    if (response.status_code != 200)
+                    {
+                        last_error_ = "Failed to get open orders: HTTP " + std::to_string(response.status_code) + " - " + response.body;
+                        LOG_INFO("[COINBASE-REST] " + last_error_);
+                        return false;
+                    }
+
+                    if (!parse_orders_response(response.body, orders, cursor))
+                        return false;
+                    if (cursor.empty())
+                        break;
+                }
+
+                LOG_INFO("[COINBASE-REST] " + std::to_string(orders.size()) + " open orders");
+                return true;
+            }
+
+            bool CoinbaseRestClient::get_fills(std::vector<base::FillEvent> &fills, int limit)
+            {
+                LOG_INFO("[COINBASE-REST] Fetching recent fills...");
+
+                auto response = make_authenticated_request("GET", std::string(endpoints::ORDERS_FILLS) + "?limit=" + std::to_string(limit), "");
+                if (response.status_code != 200)
+                {
+                    last_error_ = "Failed to get fills: HTTP " + std::to_string(response.status_code) + " - " + response.body;
+                    LOG_INFO("[COINBASE-REST] " + last_error_);
+                    return false;
+                }
+
+                return parse_fills_response(response.body, fills);
+            }
+
+            bool CoinbaseRestClient::get_product_book(const std::string &product_id, std::vector<base::PriceLevel> &bids,
+                                                      std::vector<base::PriceLevel> &asks, uint64_t &time_us, int limit)
+            {
+                std::string path = std::string(endpoints::MARKET_PRODUCT_BOOK) + "?product_id=" + product_id;
+                if (limit > 0)
+                    path += "&limit=" + std::to_string(limit);
+
+                auto response = make_authenticated_request("GET", path, "");
+                if (response.status_code != 200)
+                {
+                    last_error_ = "Failed to get product book for " + product_id + ": HTTP " + std::to_string(response.status_code) + " - " + response.body;
+                    LOG_INFO("[COINBASE-REST] " + last_error_);
+                    return false;
+                }
+
+                return parse_product_book_response(response.body, bids, asks, time_us);
+            }
+
             bool CoinbaseRestClient::get_portfolio_summary(Portfolio &summary)
             {
                 LOG_INFO("[COINBASE-REST] Getting portfolio summary...");
@@ -167,14 +234,8 @@ namespace open_dtc_server
                 {
                     if (balance.currency == "USD" || balance.currency == "USDC")
                     {
-                        try
-                        {
-                            summary.total_value_usd += std::stod(balance.total_balance);
-                        }
-                        catch (const std::exception &)
-                        {
-                            // Ignore parsing errors
-                        }
+                        // Unparseable balances count as zero
+                        summary.total_value_usd += base::decimal::parse_decimal_or(balance.total_balance, 0.0);
                     }
                 }
 
@@ -200,7 +261,8 @@ namespace open_dtc_server
 
                     // Generate JWT token for this request
                     // The path needs to be the full API path starting with /api
-                    std::string jwt_path = "/api/v3/brokerage/" + path;
+                    // The uri claim excludes any query string
+                    std::string jwt_path = "/api/v3/brokerage/" + path.substr(0, path.find('?'));
                     std::string jwt_token = authenticator_->generate_token(method, jwt_path, body);
 
                     // Set up CURL options
@@ -294,16 +356,9 @@ namespace open_dtc_server
                         }
 
                         // Calculate total balance
-                        try
-                        {
-                            double avail = balance.available.empty() ? 0.0 : std::stod(balance.available);
-                            double held = balance.hold.empty() ? 0.0 : std::stod(balance.hold);
-                            balance.total_balance = std::to_string(avail + held);
-                        }
-                        catch (const std::exception &)
-                        {
-                            balance.total_balance = "0";
-                        }
+                        double avail = base::decimal::parse_decimal_or(balance.available, 0.0);
+                        double held = base::decimal::parse_decimal_or(balance.hold, 0.0);
+                        balance.total_balance = std::to_string(avail + held);
 
                         // Only include accounts with some balance or active status
                         if (balance.active || (!balance.available.empty() && balance.available != "0" && balance.available != "0.00"))
@@ -440,13 +495,14 @@ namespace open_dtc_server
                         // Parse numeric values safely
                         try
                         {
-                            product.price_increment = std::stod(product_json.value("price_increment", "0.01"));
-                            product.base_min_size = std::stod(product_json.value("base_min_size", "0.001"));
-                            product.base_max_size = std::stod(product_json.value("base_max_size", "10000"));
+                            // Use defaults if a field is missing or malformed
+                            product.price_increment = base::decimal::parse_decimal_or(product_json.value("price_increment", ""), 0.01);
+                            product.base_min_size = base::decimal::parse_decimal_or(product_json.value("base_min_size", ""), 0.001);
+                            product.base_max_size = base::decimal::parse_decimal_or(product_json.value("base_max_size", ""), 10000.0);
                         }
                         catch (...)
                         {
-                            // Use defaults if parsing fails
+                            // Non-string fields
                             product.price_increment = 0.01;
                             product.base_min_size = 0.001;
                             product.base_max_size = 10000.0;
@@ -489,6 +545,144 @@ namespace open_dtc_server
             }
 
             // Helper methods for product type handling
+            bool CoinbaseRestClient::parse_orders_response(const std::string &json, std::vector<base::OrderEvent> &orders, std::string &cursor)
+            {
+                try
+                {
+                    auto parsed = nlohmann::json::parse(json);
+                    if (!parsed.contains("orders") || !parsed["orders"].is_array())
+                    {
+                        last_error_ = "Invalid orders response format";
+                        return false;
+                    }
+
+                    auto decimal = [](const nlohmann::json &object, const char *key)
+                    {
+                        auto it = object.find(key);
+                        if (it != object.end() && it->is_string())
+                            return base::decimal::parse_decimal_or(it->get_ref<const std::string &>(), 0.0);
+                        return 0.0;
+                    };
+
+                    for (const auto &order_json : parsed["orders"])
+                    {
+                        base::OrderEvent order;
+                        order.order_id = order_json.value("order_id", "");
+                        order.client_order_id = order_json.value("client_order_id", "");
+                        order.symbol = order_json.value("product_id", "");
+                        order.is_buy = order_json.value("side", "") != "SELL";
+                        order.kind = order_fields::parse_order_kind(order_json.value("order_type", ""));
+                        order.state = order_fields::parse_order_state(order_json.value("status", ""));
+                        order.filled_quantity = decimal(order_json, "filled_size");
+                        order.average_fill_price = decimal(order_json, "average_filled_price");
+                        order.created_time_ms = order_fields::parse_time_ms(order_json.value("created_time", ""));
+
+                        // Size and prices live in the single entry of order_configuration, e.g. {"limit_limit_gtc": {...}}
+                        if (order_json.contains("order_configuration") && order_json["order_configuration"].is_object())
+                        {
+                            for (const auto &config : order_json["order_configuration"])
+                            {
+                                if (!config.is_object())
+                                    continue;
+                                order.quantity = decimal(config, "base_size");
+                                order.limit_price = decimal(config, "limit_price");
+                                order.stop_price = decimal(config, "stop_price");
+                            }
+                        }
+                        if (order.quantity < order.filled_quantity)
+                            order.quantity = order.filled_quantity;
+
+                        if (!order.order_id.empty())
+                            orders.push_back(std::move(order));
+                    }
+
+                    cursor = parsed.value("has_next", false) ? parsed.value("cursor", "") : std::string();
+                    return true;
+                }
+                catch (const std::exception &e)
+                {
+                    last_error_ = "Failed to parse orders response: " + std::string(e.what());
+                    LOG_INFO("[COINBASE-REST] " + last_error_);
+                    return false;
+                }
+            }
+
+            bool CoinbaseRestClient::parse_fills_response(const std::string &json, std::vector<base::FillEvent> &fills)
+            {
+                try
+                {
+                    auto parsed = nlohmann::json::parse(json);
+                    if (!parsed.contains("fills") || !parsed["fills"].is_array())
+                    {
+                        last_error_ = "Invalid fills response format";
+                        return false;
+                    }
+
+                    fills.clear();
+                    for (const auto &fill_json : parsed["fills"])
+                    {
+                        base::FillEvent fill;
+                        fill.order_id = fill_json.value("order_id", "");
+                        fill.trade_id = fill_json.value("trade_id", "");
+                        fill.symbol = fill_json.value("product_id", "");
+                        fill.is_buy = fill_json.value("side", "") != "SELL";
+                        fill.price = base::decimal::parse_decimal_or(fill_json.value("price", ""), 0.0);
+                        fill.quantity = base::decimal::parse_decimal_or(fill_json.value("size", ""), 0.0);
+                        fill.time_ms = order_fields::parse_time_ms(fill_json.value("trade_time", ""));
+                        fills.push_back(std::move(fill));
+                    }
+                    return true;
+                }
+                catch (const std::exception &e)
+                {
+                    last_error_ = "Failed to parse fills response: " + std::string(e.what());
+                    LOG_INFO("[COINBASE-REST] " + last_error_);
+                    return false;
+                }
+            }
+
+            bool CoinbaseRestClient::parse_product_book_response(const std::string &json, std::vector<base::PriceLevel> &bids,
+                                                                 std::vector<base::PriceLevel> &asks, uint64_t &time_us)
+            {
+                try
+                {
+                    auto parsed = nlohmann::json::parse(json);
+                    if (!parsed.contains("pricebook") || !parsed["pricebook"].is_object())
+                    {
+                        last_error_ = "Invalid product book response format";
+                        return false;
+                    }
+
+                    const auto &pricebook = parsed["pricebook"];
+                    auto load = [](const nlohmann::json &levels, std::vector<base::PriceLevel> &out)
+                    {
+                        out.clear();
+                        if (!levels.is_array())
+                            return;
+                        out.reserve(levels.size());
+                        for (const auto &level : levels)
+                        {
+                            double price = 0.0, size = 0.0;
+                            if (base::decimal::parse_decimal(level.value("price", ""), price) &&
+                                base::decimal::parse_decimal(level.value("size", ""), size))
+                                out.emplace_back(price, size);
+                        }
+                    };
+                    load(pricebook.value("bids", nlohmann::json::array()), bids);
+                    load(pricebook.value("asks", nlohmann::json::array()), asks);
+
+                    time_us = 0;
+                    base::timestamp::parse_iso8601(pricebook.value("time", ""), time_us);
+                    return true;
+                }
+                catch (const std::exception &e)
+                {
+                    last_error_ = "Failed to parse product book response: " + std::string(e.what());
+                    LOG_INFO("[COINBASE-REST] " + last_error_);
+                    return false;
+                }
+            }
+
             open_dtc_server::exchanges::coinbase::ProductType CoinbaseRestClient::parse_product_type(const std::string &product_id) const
             {
                 // Simple heuristic for determining product type
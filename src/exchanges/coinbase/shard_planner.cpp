@@ -0,0 +1,193 @@
+#include "coinbase_dtc_core/exchanges/coinbase/shard_planner.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace coinbase
+        {
+
+            ShardPlanner::ShardPlanner(size_t shards)
+                : shards_(std::max<size_t>(shards, 1))
+            {
+            }
+
+            size_t ShardPlanner::assign(const std::string &product_id, double weight)
+            {
+                auto it = placements_.find(product_id);
+                if (it != placements_.end())
+                    return it->second.shard;
+
+                size_t shard = lightest();
+                placements_.emplace(product_id, Placement{shard, weight});
+                shards_[shard].load += weight;
+                shards_[shard].products++;
+                return shard;
+            }
+
+            void ShardPlanner::release(const std::string &product_id)
+            {
+                auto it = placements_.find(product_id);
+                if (it == placements_.end())
+                    return;
+
+                auto &shard = shards_[it->second.shard];
+                shard.load = std::max(0.0, shard.load - it->second.weight);
+                shard.products--;
+                placements_.erase(it);
+            }
+
+            void ShardPlanner::set_weight(const std::string &product_id, double weight)
+            {
+                auto it = placements_.find(product_id);
+                if (it == placements_.end())
+                    return;
+
+                auto &shard = shards_[it->second.shard];
+                shard.load = std::max(0.0, shard.load - it->second.weight + weight);
+                it->second.weight = weight;
+            }
+
+            std::vector<ShardPlanner::Move> ShardPlanner::set_live(size_t shard, bool live)
+            {
+                std::vector<Move> moves;
+                if (shard >= shards_.size() || shards_[shard].live == live)
+                    return moves;
+
+                shards_[shard].live = live;
+                if (live)
+                    return rebalance();
+
+                // Heaviest first, so the big ones spread before the small ones fill the gaps
+                std::vector<std::pair<std::string, double>> orphans;
+                for (const auto &[product_id, placement] : placements_)
+                {
+                    if (placement.shard == shard)
+                        orphans.emplace_back(product_id, placement.weight);
+                }
+                std::sort(orphans.begin(), orphans.end(), [](const auto &a, const auto &b)
+                          { return a.second != b.second ? a.second > b.second : a.first < b.first; });
+
+                for (const auto &[product_id, weight] : orphans)
+                {
+                    size_t to = lightest();
+                    if (!shards_[to].live)
+                        break; // Nowhere to go; they wait for a shard to come back
+                    move(product_id, placements_[product_id], to, moves);
+                }
+                return moves;
+            }
+
+            std::vector<ShardPlanner::Move> ShardPlanner::rebalance(double tolerance)
+            {
+                std::vector<Move> moves;
+
+                // Every move lowers the sum of squared loads, so this ends; the cap is a safety net
+                for (size_t step = 0; step <= placements_.size(); ++step)
+                {
+                    size_t heaviest = shards_.size(), lightest_live = shards_.size();
+                    double total = 0.0;
+                    size_t live = 0;
+                    for (size_t i = 0; i < shards_.size(); ++i)
+                    {
+                        if (!shards_[i].live)
+                            continue;
+                        live++;
+                        total += shards_[i].load;
+                        if (heaviest == shards_.size() || shards_[i].load > shards_[heaviest].load)
+                            heaviest = i;
+                        if (lightest_live == shards_.size() || shards_[i].load < shards_[lightest_live].load)
+                            lightest_live = i;
+                    }
+                    if (live < 2)
+                        break;
+
+                    double gap = shards_[heaviest].load - shards_[lightest_live].load;
+                    if (gap <= tolerance * total / static_cast<double>(live))
+                        break;
+
+                    // The product closest to half the gap evens the pair out best
+                    const std::string *best = nullptr;
+                    double best_distance = 0.0;
+                    for (const auto &[product_id, placement] : placements_)
+                    {
+                        if (placement.shard != heaviest || placement.weight <= 0.0 || placement.weight >= gap)
+                            continue;
+                        double distance = std::fabs(gap / 2.0 - placement.weight);
+                        if (!best || distance < best_distance || (distance == best_distance && product_id < *best))
+                        {
+                            best = &product_id;
+                            best_distance = distance;
+                        }
+                    }
+                    if (!best)
+                        break;
+
+                    std::string product_id = *best;
+                    move(product_id, placements_[product_id], lightest_live, moves);
+                }
+                return moves;
+            }
+
+            std::vector<std::string> ShardPlanner::products_on(size_t shard) const
+            {
+                std::vector<std::string> products;
+                for (const auto &[product_id, placement] : placements_)
+                {
+                    if (placement.shard == shard)
+                        products.push_back(product_id);
+                }
+                std::sort(products.begin(), products.end());
+                return products;
+            }
+
+            bool ShardPlanner::shard_of(const std::string &product_id, size_t &shard) const
+            {
+                auto it = placements_.find(product_id);
+                if (it == placements_.end())
+                    return false;
+                shard = it->second.shard;
+                return true;
+            }
+
+            size_t ShardPlanner::lightest() const
+            {
+                size_t best = shards_.size();
+                for (size_t i = 0; i < shards_.size(); ++i)
+                {
+                    if (best == shards_.size())
+                    {
+                        best = i;
+                        continue;
+                    }
+                    const auto &candidate = shards_[i];
+                    const auto &current = shards_[best];
+                    if (candidate.live != current.live)
+                    {
+                        if (candidate.live)
+                            best = i;
+                        continue;
+                    }
+                    if (candidate.load < current.load ||
+                        (candidate.load == current.load && candidate.products < current.products))
+                        best = i;
+                }
+                return best;
+            }
+
+            void ShardPlanner::move(const std::string &product_id, Placement &placement, size_t to, std::vector<Move> &moves)
+            {
+                auto &from = shards_[placement.shard];
+                from.load = std::max(0.0, from.load - placement.weight);
+                from.products--;
+                shards_[to].load += placement.weight;
+                shards_[to].products++;
+                moves.push_back({product_id, placement.shard, to});
+                placement.shard = to;
+            }
+
+        } // namespace coinbase
+    } // namespace exchanges
+} // namespace open_dtc_server
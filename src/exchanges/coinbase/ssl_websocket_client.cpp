@@ -1,6 +1,7 @@
 #include "coinbase_dtc_core/exchanges/coinbase/ssl_websocket_client.hpp"
 #include "coinbase_dtc_core/core/util/advanced_log.hpp"
 #include "../../../secrets/coinbase/coinbase.h"
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <chrono>
@@ -12,6 +13,7 @@
 #include <optional>
 #include <cstdlib>
 #include <unordered_set>
+#include <csignal>
 
 // JSON and JWT libraries
 #include <nlohmann/json.hpp>
@@ -22,7 +24,6 @@
 #include <openssl/bio.h>
 #include <openssl/evp.h>
 #include <openssl/buffer.h>
-#include <zlib.h>
 
 namespace open_dtc_server
 {
@@ -30,51 +31,11 @@ namespace open_dtc_server
     {
         namespace coinbase
         {
-            // Helper function to decompress deflate data
-            std::string decompress_deflate(const std::vector<uint8_t> &compressed_data)
-            {
-                if (compressed_data.empty())
-                    return "";
-
-                z_stream stream = {};
-                stream.next_in = const_cast<Bytef *>(compressed_data.data());
-                stream.avail_in = static_cast<uInt>(compressed_data.size());
-
-                // Initialize deflate decompression
-                if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
-                {
-                    return "";
-                }
-
-                std::string result;
-                char buffer[4096];
-
-                do
-                {
-                    stream.next_out = reinterpret_cast<Bytef *>(buffer);
-                    stream.avail_out = sizeof(buffer);
-
-                    int ret = inflate(&stream, Z_NO_FLUSH);
-                    if (ret == Z_STREAM_ERROR || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR)
-                    {
-                        inflateEnd(&stream);
-                        return "";
-                    }
-
-                    size_t bytes_produced = sizeof(buffer) - stream.avail_out;
-                    result.append(buffer, bytes_produced);
-
-                } while (stream.avail_out == 0);
-
-                inflateEnd(&stream);
-                return result;
-            }
-
             SSLWebSocketClient::SSLWebSocketClient()
                 : connected_(false), should_stop_(false), host_("ws-feed.exchange.coinbase.com"),
                   port_(443), ssl_ctx_(nullptr), ssl_(nullptr), bio_(nullptr),
                   ssl_initialized_(false), socket_fd_(-1), messages_received_(0),
-                  messages_sent_(0), last_message_time_(0), reconnect_attempts_(0),
+                  messages_sent_(0), last_message_time_(0),
                   credentials_loaded_(false)
             {
 #ifdef _WIN32
@@ -84,6 +45,9 @@ namespace open_dtc_server
                 {
                     LOG_ERROR("[ERROR] WSAStartup failed: " + std::to_string(result));
                 }
+#else
+                // A write to a connection the peer reset must fail, not kill the process before the drop is seen
+                std::signal(SIGPIPE, SIG_IGN);
 #endif
 
                 if (!init_ssl())
@@ -110,6 +74,7 @@ namespace open_dtc_server
             SSLWebSocketClient::~SSLWebSocketClient()
             {
                 disconnect();
+                stop_capture();
                 cleanup_ssl();
 
 #ifdef _WIN32
@@ -138,9 +103,7 @@ namespace open_dtc_server
                 // Configure SSL context
                 SSL_CTX_set_verify(ssl_ctx_, SSL_VERIFY_NONE, nullptr); // DEVELOPMENT: Skip certificate verification
                 SSL_CTX_set_default_verify_paths(ssl_ctx_);
-
-                // Enable SNI (Server Name Indication)
-                SSL_CTX_set_tlsext_use_srtp(ssl_ctx_, "SRTP_AES128_CM_SHA1_80");
+                // SNI is set per connection in create_ssl_socket()
 
                 ssl_initialized_ = true;
                 LOG_INFO("[SUCCESS] SSL context initialized");
@@ -392,6 +355,9 @@ namespace open_dtc_server
                     return true;
                 }
 
+                // Threads, SSL and socket of a dropped connection or a failed attempt
+                disconnect();
+
                 host_ = host;
                 port_ = port;
 
@@ -425,6 +391,7 @@ namespace open_dtc_server
                     return false;
                 }
 
+                last_message_time_.store(std::chrono::steady_clock::now().time_since_epoch().count());
                 connected_.store(true);
                 should_stop_.store(false);
 
@@ -474,12 +441,21 @@ namespace open_dtc_server
                     return false;
                 }
 
-                // Connect to server
-                bool connected = false;
+                // Connect to server, starting at address_index_ and wrapping around
+                std::vector<struct addrinfo *> addresses;
                 for (struct addrinfo *addr = result; addr != nullptr; addr = addr->ai_next)
+                    addresses.push_back(addr);
+
+                bool connected = false;
+                for (size_t i = 0; i < addresses.size(); ++i)
                 {
+                    struct addrinfo *addr = addresses[(address_index_ + i) % addresses.size()];
                     if (::connect(socket_fd_, addr->ai_addr, addr->ai_addrlen) == 0)
                     {
+                        char text[INET_ADDRSTRLEN] = {};
+                        inet_ntop(AF_INET, &reinterpret_cast<struct sockaddr_in *>(addr->ai_addr)->sin_addr, text, sizeof(text));
+                        std::lock_guard<std::mutex> lock(peer_address_mutex_);
+                        peer_address_ = text;
                         connected = true;
                         break;
                     }
@@ -498,7 +474,7 @@ namespace open_dtc_server
                     return false;
                 }
 
-                LOG_INFO("[SUCCESS] TCP connection established");
+                LOG_INFO("[SUCCESS] TCP connection established to " + get_peer_address());
                 return true;
             }
 
@@ -623,7 +599,7 @@ namespace open_dtc_server
                 request << "Connection: Upgrade\r\n";
                 request << "Sec-WebSocket-Key: " << websocket_key << "\r\n";
                 request << "Sec-WebSocket-Version: 13\r\n";
-                request << "Sec-WebSocket-Extensions: permessage-deflate; client_max_window_bits\r\n";
+                request << "Sec-WebSocket-Extensions: " << PERMESSAGE_DEFLATE_OFFER << "\r\n";
                 request << "User-Agent: CoinbaseDTC/1.0\r\n";
                 request << "\r\n";
 
@@ -636,17 +612,32 @@ namespace open_dtc_server
                     return false;
                 }
 
-                // Read handshake response
-                char buffer[4096];
-                int bytes_received = receive_ssl_data(buffer, sizeof(buffer) - 1);
-                if (bytes_received <= 0)
+                // Read handshake response up to the blank line; anything after it is already frame data
+                std::string response;
+                size_t header_end = std::string::npos;
+                int idle_reads = 0;
+                while ((header_end = response.find("\r\n\r\n")) == std::string::npos)
                 {
-                    LOG_ERROR("[ERROR] Failed to receive WebSocket handshake response");
-                    return false;
+                    char buffer[4096];
+                    int bytes_received = receive_ssl_data(buffer, sizeof(buffer));
+                    if (bytes_received < 0 || response.size() > MAX_HANDSHAKE_BYTES || idle_reads > 5000)
+                    {
+                        LOG_ERROR("[ERROR] Failed to receive WebSocket handshake response");
+                        return false;
+                    }
+                    if (bytes_received == 0)
+                    {
+                        idle_reads++;
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                        continue;
+                    }
+                    response.append(buffer, bytes_received);
                 }
-
-                buffer[bytes_received] = '\\0';
-                std::string response(buffer);
+                frame_reader_.reset();
+                frame_reader_.append(reinterpret_cast<const uint8_t *>(response.data()) + header_end + 4,
+                                     response.size() - header_end - 4);
+                close_sent_.store(false);
+                response.resize(header_end + 4);
 
                 LOG_DEBUG("[DEBUG] WebSocket handshake response:\\n" + response);
 
@@ -657,10 +648,61 @@ namespace open_dtc_server
                     return false;
                 }
 
+                // permessage-deflate only if the server accepted it; one inflate stream for the whole connection
+                DeflateParameters deflate;
+                bool deflate_accepted = false;
+                if (!parse_deflate_response(find_header(response, "sec-websocket-extensions"), deflate, deflate_accepted))
+                {
+                    LOG_ERROR("[ERROR] Unusable Sec-WebSocket-Extensions in handshake response");
+                    return false;
+                }
+                inflater_.stop();
+                deflate_active_.store(false);
+                deflate_takeover_.store(false);
+                if (deflate_accepted)
+                {
+                    if (!inflater_.start(deflate))
+                    {
+                        LOG_ERROR("[ERROR] Failed to initialize permessage-deflate");
+                        return false;
+                    }
+                    deflate_active_.store(true);
+                    deflate_takeover_.store(inflater_.context_takeover());
+                    LOG_INFO(std::string("[WEBSOCKET] permessage-deflate negotiated, ") +
+                             (inflater_.context_takeover() ? "with" : "without") + " context takeover");
+                }
+
                 LOG_INFO("[SUCCESS] WebSocket handshake completed");
                 return true;
             }
 
+            std::string SSLWebSocketClient::find_header(const std::string &response, const std::string &lowercase_name)
+            {
+                size_t line_start = response.find("\r\n");
+                while (line_start != std::string::npos && line_start + 2 < response.size())
+                {
+                    line_start += 2;
+                    size_t line_end = response.find("\r\n", line_start);
+                    size_t colon = response.find(':', line_start);
+                    if (line_end == std::string::npos || colon == std::string::npos || colon > line_end)
+                    {
+                        line_start = line_end;
+                        continue;
+                    }
+
+                    std::string name = response.substr(line_start, colon - line_start);
+                    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c)
+                                   { return static_cast<char>(std::tolower(c)); });
+                    if (name == lowercase_name)
+                    {
+                        size_t value_start = response.find_first_not_of(' ', colon + 1);
+                        return value_start < line_end ? response.substr(value_start, line_end - value_start) : "";
+                    }
+                    line_start = line_end;
+                }
+                return "";
+            }
+
             bool SSLWebSocketClient::validate_websocket_response(const std::string &response)
             {
                 return response.find("HTTP/1.1 101") != std::string::npos &&
@@ -725,18 +767,24 @@ namespace open_dtc_server
 
             void SSLWebSocketClient::disconnect()
             {
-                if (!connected_.load())
+                // After a drop there is no connection left, but still threads, SSL and a socket to release
+                bool was_connected = connected_.exchange(false);
+                if (!was_connected && !worker_thread_.joinable() && !ping_thread_.joinable() && !ssl_ && socket_fd_ < 0)
                     return;
 
-                LOG_INFO("[WS] Disconnecting SSL WebSocket");
+                if (was_connected)
+                    LOG_INFO("[WS] Disconnecting SSL WebSocket");
 
                 should_stop_.store(true);
-                connected_.store(false);
+                interrupt_reader();
 
-                // Wait for threads to finish
+                // Wait for threads to finish; a callback on the reader thread cannot wait for itself
                 if (worker_thread_.joinable())
                 {
-                    worker_thread_.join();
+                    if (worker_thread_.get_id() == std::this_thread::get_id())
+                        worker_thread_.detach();
+                    else
+                        worker_thread_.join();
                 }
 
                 if (ping_thread_.joinable())
@@ -763,22 +811,60 @@ namespace open_dtc_server
                     socket_fd_ = -1;
                 }
 
-                if (connection_callback_)
+                if (was_connected)
                 {
-                    connection_callback_(false);
+                    if (connection_callback_)
+                        connection_callback_(false);
+                    LOG_INFO("[SUCCESS] SSL WebSocket disconnected");
                 }
+            }
 
-                LOG_INFO("[SUCCESS] SSL WebSocket disconnected");
+            void SSLWebSocketClient::interrupt_reader()
+            {
+                // Blocking SSL_read returns once the receive side is shut down; sending still works
+                if (socket_fd_ < 0)
+                    return;
+#ifdef _WIN32
+                shutdown(socket_fd_, SD_RECEIVE);
+#else
+                shutdown(socket_fd_, SHUT_RD);
+#endif
+            }
+
+            void SSLWebSocketClient::connection_lost(const std::string &reason)
+            {
+                // disconnect() got there first: nothing was lost
+                if (!connected_.exchange(false))
+                    return;
+
+                LOG_WARN("[WS] Connection lost: " + reason);
+                if (error_callback_)
+                    error_callback_("Connection lost: " + reason);
+                if (connection_callback_)
+                    connection_callback_(false);
             }
 
             void SSLWebSocketClient::worker_loop()
             {
                 LOG_INFO("[WORKER] SSL WebSocket worker thread started");
 
+                // Frames that arrived together with the handshake response
+                if (!dispatch_messages(0))
+                    connection_lost("WebSocket protocol error");
+
+                // Reads block until data arrives; back off only when the socket reports nothing
                 while (!should_stop_.load() && connected_.load())
                 {
-                    process_incoming_messages();
-                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    int received = process_incoming_messages();
+                    if (received < 0)
+                    {
+                        // Closed by either side, reset, or unreadable: this connection is over
+                        if (!should_stop_.load())
+                            connection_lost(received == -2 ? "WebSocket protocol error" : "socket closed or read failed");
+                        break;
+                    }
+                    if (received == 0)
+                        std::this_thread::sleep_for(std::chrono::milliseconds(10));
                 }
 
                 LOG_INFO("[WORKER] SSL WebSocket worker thread ended");
@@ -790,103 +876,155 @@ namespace open_dtc_server
 
                 while (!should_stop_.load() && connected_.load())
                 {
-                    std::this_thread::sleep_for(std::chrono::seconds(30));
+                    // Sleep in short steps so disconnect() does not wait out the interval
+                    auto next_ping = std::chrono::steady_clock::now() + std::chrono::seconds(PING_INTERVAL_SECONDS);
+                    while (!should_stop_.load() && connected_.load() && std::chrono::steady_clock::now() < next_ping)
+                        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+                    if (!connected_.load() || should_stop_.load())
+                        break;
 
-                    if (connected_.load())
+                    // A half-open connection never errors: if not even our pings are answered, end it
+                    if (std::chrono::steady_clock::now() - get_last_message_time() > std::chrono::seconds(SILENCE_TIMEOUT_SECONDS))
                     {
-                        // Send ping frame (opcode 0x9)
-                        std::vector<uint8_t> ping_frame = create_websocket_frame("ping", 0x9);
-                        send_ssl_data((char *)ping_frame.data(), ping_frame.size());
-                        LOG_DEBUG("[PING] Sent WebSocket ping");
+                        LOG_WARN("[PING] Nothing received for " + std::to_string(SILENCE_TIMEOUT_SECONDS) + " seconds, closing");
+                        interrupt_reader();
+                        break;
                     }
+
+                    send_frame(WebSocketOpcode::PING, "ping", 4);
+                    LOG_DEBUG("[PING] Sent WebSocket ping");
                 }
 
                 LOG_DEBUG("[PING] WebSocket ping thread ended");
             }
 
-            void SSLWebSocketClient::process_incoming_messages()
+            int SSLWebSocketClient::process_incoming_messages()
             {
-                char buffer[4096];
-                int bytes_received = receive_ssl_data(buffer, sizeof(buffer));
+                // Read straight into the frame buffer; frames are parsed where they land
+                size_t available = 0;
+                uint8_t *space = frame_reader_.write_space(MIN_READ_BYTES, available);
+                int bytes_received = receive_ssl_data(reinterpret_cast<char *>(space), std::min<size_t>(available, 1 << 20));
+                if (bytes_received <= 0)
+                    return bytes_received < 0 ? -1 : 0;
+                frame_reader_.commit(static_cast<size_t>(bytes_received));
 
-                if (bytes_received > 0)
+                uint64_t receive_time_us = 0;
+                if (capturing_.load(std::memory_order_relaxed))
                 {
-                    incoming_buffer_.insert(incoming_buffer_.end(), buffer, buffer + bytes_received);
-
-                    // Process complete WebSocket frames
-                    while (incoming_buffer_.size() >= 2)
-                    {
-                        // Check if we have enough data for a complete frame
-                        size_t frame_size = calculate_frame_size(incoming_buffer_);
-                        if (frame_size == 0 || incoming_buffer_.size() < frame_size)
-                        {
-                            break; // Wait for more data
-                        }
-
-                        // Extract complete frame
-                        std::vector<uint8_t> frame_data(incoming_buffer_.begin(), incoming_buffer_.begin() + frame_size);
-                        incoming_buffer_.erase(incoming_buffer_.begin(), incoming_buffer_.begin() + frame_size);
-
-                        // Parse WebSocket frame
-                        std::string message = parse_websocket_frame(frame_data);
+                    receive_time_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                                          std::chrono::system_clock::now().time_since_epoch())
+                                          .count();
+                }
+                return dispatch_messages(receive_time_us) ? bytes_received : -2;
+            }
 
-                        // Only process text frames as JSON - ignore binary/control frames
-                        if (!message.empty() && message_callback_ && is_valid_json_start(message))
-                        {
-                            message_callback_(message);
-                        }
-                        else if (!message.empty() && !is_valid_json_start(message))
-                        {
-                            LOG_DEBUG("[DEBUG] Ignoring non-JSON WebSocket frame (binary/control data)");
-                        }
+            bool SSLWebSocketClient::dispatch_messages(uint64_t receive_time_us)
+            {
+                FrameReader::Message message;
+                FrameReader::Status status;
+                while ((status = frame_reader_.next(message)) == FrameReader::Status::MESSAGE)
+                {
+                    messages_received_.fetch_add(1);
+                    last_message_time_.store(std::chrono::steady_clock::now().time_since_epoch().count());
+                    handle_message(message, receive_time_us);
+                }
 
-                        messages_received_.fetch_add(1);
-                        last_message_time_.store(std::chrono::steady_clock::now().time_since_epoch().count());
-                    }
+                if (status == FrameReader::Status::PROTOCOL_ERROR)
+                {
+                    // Frame boundaries are lost; nothing after this point can be parsed
+                    LOG_ERROR("[ERROR] WebSocket protocol error: " + frame_reader_.error());
+                    if (error_callback_)
+                        error_callback_("WebSocket protocol error: " + frame_reader_.error());
+                    frame_reader_.reset();
+                    return false;
                 }
+                return true;
             }
 
-            std::vector<uint8_t> SSLWebSocketClient::create_websocket_frame(const std::string &payload, uint8_t opcode)
+            void SSLWebSocketClient::handle_message(const FrameReader::Message &message, uint64_t receive_time_us)
             {
-                std::vector<uint8_t> frame;
+                switch (message.opcode)
+                {
+                case WebSocketOpcode::PING:
+                    // Same application data back (RFC 6455 section 5.5.2)
+                    if (send_frame(WebSocketOpcode::PONG, message.data, message.size))
+                        LOG_DEBUG("[PING] Answered WebSocket ping");
+                    return;
+                case WebSocketOpcode::PONG:
+                    LOG_DEBUG("[PING] Received WebSocket pong");
+                    return;
+                case WebSocketOpcode::CLOSE:
+                {
+                    int code = message.size >= 2 ? (message.data[0] << 8) | message.data[1] : 1005;
+                    LOG_INFO("[INFO] Received WebSocket close frame (code " + std::to_string(code) + ")");
+                    // Echo the status code once; the server then closes the TCP connection
+                    if (!close_sent_.exchange(true))
+                        send_frame(WebSocketOpcode::CLOSE, message.data, std::min<size_t>(message.size, 2));
+                    return;
+                }
+                default:
+                    break;
+                }
 
-                // WebSocket frame format (simplified)
-                frame.push_back(0x80 | opcode); // FIN + opcode
+                std::string &text = message_buffer_;
+                text.clear();
 
-                size_t payload_len = payload.length();
-                if (payload_len < 126)
+                // Compressed data messages all go through the connection's inflate stream, binary ones
+                // included: with context takeover they share its window
+                if (message.compressed)
+                {
+                    if (!inflater_.active())
+                    {
+                        LOG_ERROR("[ERROR] Compressed WebSocket frame without negotiated permessage-deflate");
+                        return;
+                    }
+                    if (!inflater_.inflate(message.data, message.size, text))
+                    {
+                        LOG_ERROR("[ERROR] permessage-deflate inflate failed");
+                        if (error_callback_)
+                            error_callback_("permessage-deflate inflate failed");
+                        return;
+                    }
+                }
+                else if (message.opcode == WebSocketOpcode::TEXT)
                 {
-                    frame.push_back(0x80 | payload_len); // MASK + length
+                    text.assign(reinterpret_cast<const char *>(message.data), message.size);
                 }
-                else if (payload_len < 65536)
+
+                if (message.opcode != WebSocketOpcode::TEXT)
                 {
-                    frame.push_back(0x80 | 126);
-                    frame.push_back((payload_len >> 8) & 0xFF);
-                    frame.push_back(payload_len & 0xFF);
+                    // Don't convert binary frames to string - they're not JSON
+                    LOG_DEBUG("[DEBUG] Received binary WebSocket message, ignoring (not JSON)");
+                    return;
                 }
-                else
+
+                if (receive_time_us != 0 && !text.empty())
                 {
-                    frame.push_back(0x80 | 127);
-                    for (int i = 7; i >= 0; --i)
+                    std::lock_guard<std::mutex> lock(capture_mutex_);
+                    if (capture_file_.is_open())
                     {
-                        frame.push_back((payload_len >> (i * 8)) & 0xFF);
+                        capture_file_ << receive_time_us << '\t' << text << '\n';
+                        messages_captured_.fetch_add(1, std::memory_order_relaxed);
                     }
                 }
 
-                // Add masking key (required for client)
-                uint32_t mask = 0x12345678; // Simple mask for demo
-                frame.push_back((mask >> 24) & 0xFF);
-                frame.push_back((mask >> 16) & 0xFF);
-                frame.push_back((mask >> 8) & 0xFF);
-                frame.push_back(mask & 0xFF);
-
-                // Add masked payload
-                for (size_t i = 0; i < payload_len; ++i)
+                if (message_callback_ && is_valid_json_start(text))
+                {
+                    message_callback_(text);
+                }
+                else if (!text.empty() && !is_valid_json_start(text))
                 {
-                    frame.push_back(payload[i] ^ ((mask >> ((3 - (i % 4)) * 8)) & 0xFF));
+                    LOG_DEBUG("[DEBUG] Ignoring non-JSON WebSocket message");
                 }
+            }
 
-                return frame;
+            bool SSLWebSocketClient::send_frame(WebSocketOpcode opcode, const void *payload, size_t size)
+            {
+                // Built and written under one lock so frames from different threads never interleave
+                std::lock_guard<std::mutex> lock(frame_writer_mutex_);
+                std::string_view frame = frame_writer_.build(opcode, payload, size);
+                return send_ssl_data(frame.data(), frame.size());
             }
 
             bool SSLWebSocketClient::send_message(const std::string &message)
@@ -897,8 +1035,7 @@ namespace open_dtc_server
                     return false;
                 }
 
-                std::vector<uint8_t> frame = create_websocket_frame(message);
-                bool success = send_ssl_data((char *)frame.data(), frame.size());
+                bool success = send_frame(WebSocketOpcode::TEXT, message.data(), message.size());
 
                 if (success)
                 {
@@ -986,169 +1123,77 @@ namespace open_dtc_server
                 return send_message(unsubscribe_message.dump());
             }
 
-            void SSLWebSocketClient::set_message_callback(std::function<void(const std::string &)> callback)
+            bool SSLWebSocketClient::subscribe_to_user(const std::vector<std::string> &symbols)
             {
-                message_callback_ = callback;
-            }
-
-            void SSLWebSocketClient::set_connection_callback(std::function<void(bool)> callback)
-            {
-                connection_callback_ = callback;
-            }
-
-            void SSLWebSocketClient::set_error_callback(std::function<void(const std::string &)> callback)
-            {
-                error_callback_ = callback;
-            }
-
-            std::string SSLWebSocketClient::parse_websocket_frame(const std::vector<uint8_t> &frame_data)
-            {
-                if (frame_data.size() < 2)
-                    return "";
-
-                // Parse WebSocket frame header
-                uint8_t first_byte = frame_data[0];
-                uint8_t second_byte = frame_data[1];
-
-                bool fin = (first_byte & 0x80) != 0;
-                bool rsv1 = (first_byte & 0x40) != 0; // Per-Message-Deflate extension
-                bool rsv2 = (first_byte & 0x20) != 0;
-                bool rsv3 = (first_byte & 0x10) != 0;
-                uint8_t opcode = first_byte & 0x0F;
-
-                bool mask = (second_byte & 0x80) != 0;
-                uint64_t payload_length = second_byte & 0x7F;
-
-                size_t header_length = 2;
-
-                // Extended payload length
-                if (payload_length == 126)
-                {
-                    if (frame_data.size() < 4)
-                        return "";
-                    payload_length = (static_cast<uint64_t>(frame_data[2]) << 8) |
-                                     frame_data[3];
-                    header_length = 4;
-                }
-                else if (payload_length == 127)
+                // Advanced Trade format: one channel per message, the JWT travels with the subscription
+                std::string jwt_token = generate_jwt_token();
+                if (jwt_token.empty())
                 {
-                    if (frame_data.size() < 10)
-                        return "";
-                    payload_length = 0;
-                    for (int i = 0; i < 8; i++)
-                    {
-                        payload_length = (payload_length << 8) | frame_data[2 + i];
-                    }
-                    header_length = 10;
+                    LOG_ERROR("[ERROR] Cannot subscribe to user channel without a JWT");
+                    return false;
                 }
 
-                // Masking key (if present)
-                std::vector<uint8_t> masking_key(4);
-                if (mask)
-                {
-                    if (frame_data.size() < header_length + 4)
-                        return "";
-                    std::copy(frame_data.begin() + header_length,
-                              frame_data.begin() + header_length + 4,
-                              masking_key.begin());
-                    header_length += 4;
-                }
+                nlohmann::json subscribe_message = {
+                    {"type", "subscribe"},
+                    {"channel", "user"},
+                    {"jwt", jwt_token}};
+                if (!symbols.empty())
+                    subscribe_message["product_ids"] = symbols;
 
-                // Extract payload
-                if (frame_data.size() < header_length + payload_length)
-                    return "";
+                if (!send_message(subscribe_message.dump()))
+                    return false;
 
-                std::vector<uint8_t> payload(frame_data.begin() + header_length,
-                                             frame_data.begin() + header_length + payload_length);
+                // A quiet account sends nothing; heartbeats stop the server closing the socket as idle
+                nlohmann::json heartbeat_message = {
+                    {"type", "subscribe"},
+                    {"channel", "heartbeats"},
+                    {"jwt", jwt_token}};
+                return send_message(heartbeat_message.dump());
+            }
 
-                // Unmask payload if needed
-                if (mask)
-                {
-                    for (size_t i = 0; i < payload.size(); i++)
-                    {
-                        payload[i] ^= masking_key[i % 4];
-                    }
-                }
+            bool SSLWebSocketClient::start_capture(const std::string &path)
+            {
+                std::lock_guard<std::mutex> lock(capture_mutex_);
+                if (capture_file_.is_open())
+                    capture_file_.close();
 
-                // Handle different opcodes
-                if (opcode == 0x1) // Text frame
-                {
-                    // Check if data is compressed (RSV1 bit set for Per-Message-Deflate)
-                    if (rsv1)
-                    {
-                        // Decompress the payload
-                        return decompress_deflate(payload);
-                    }
-                    else
-                    {
-                        return std::string(payload.begin(), payload.end());
-                    }
-                }
-                else if (opcode == 0x2) // Binary frame
-                {
-                    // Don't convert binary frames to string - they're not JSON
-                    LOG_DEBUG("[DEBUG] Received binary WebSocket frame, ignoring (not JSON)");
-                    return ""; // Return empty string to avoid JSON parsing
-                }
-                else if (opcode == 0x8) // Close frame
-                {
-                    LOG_INFO("[INFO] Received WebSocket close frame");
-                    return "";
-                }
-                else if (opcode == 0x9) // Ping frame
+                capture_file_.open(path, std::ios::out | std::ios::app | std::ios::binary);
+                if (!capture_file_)
                 {
-                    LOG_INFO("[INFO] Received WebSocket ping frame");
-                    // Should send pong response
-                    return "";
-                }
-                else if (opcode == 0xA) // Pong frame
-                {
-                    LOG_INFO("[INFO] Received WebSocket pong frame");
-                    return "";
+                    LOG_ERROR("[ERROR] Cannot open raw capture file: " + path);
+                    capturing_.store(false);
+                    return false;
                 }
 
-                return "";
+                capturing_.store(true);
+                LOG_INFO("[CAPTURE] Recording raw WebSocket payloads to " + path);
+                return true;
             }
 
-            size_t SSLWebSocketClient::calculate_frame_size(const std::vector<uint8_t> &frame_data)
+            void SSLWebSocketClient::stop_capture()
             {
-                if (frame_data.size() < 2)
-                    return 0;
-
-                uint8_t second_byte = frame_data[1];
-                bool mask = (second_byte & 0x80) != 0;
-                uint64_t payload_length = second_byte & 0x7F;
-
-                size_t header_length = 2;
-
-                // Extended payload length
-                if (payload_length == 126)
+                std::lock_guard<std::mutex> lock(capture_mutex_);
+                capturing_.store(false);
+                if (capture_file_.is_open())
                 {
-                    if (frame_data.size() < 4)
-                        return 0;
-                    payload_length = (static_cast<uint64_t>(frame_data[2]) << 8) |
-                                     frame_data[3];
-                    header_length = 4;
-                }
-                else if (payload_length == 127)
-                {
-                    if (frame_data.size() < 10)
-                        return 0;
-                    payload_length = 0;
-                    for (int i = 0; i < 8; i++)
-                    {
-                        payload_length = (payload_length << 8) | frame_data[2 + i];
-                    }
-                    header_length = 10;
+                    capture_file_.close();
+                    LOG_INFO("[CAPTURE] Raw capture stopped after " + std::to_string(messages_captured_.load()) + " messages");
                 }
+            }
 
-                // Add masking key size if present
-                if (mask)
-                {
-                    header_length += 4;
-                }
+            void SSLWebSocketClient::set_message_callback(std::function<void(const std::string &)> callback)
+            {
+                message_callback_ = callback;
+            }
 
-                return header_length + static_cast<size_t>(payload_length);
+            void SSLWebSocketClient::set_connection_callback(std::function<void(bool)> callback)
+            {
+                connection_callback_ = callback;
+            }
+
+            void SSLWebSocketClient::set_error_callback(std::function<void(const std::string &)> callback)
+            {
+                error_callback_ = callback;
             }
 
             bool SSLWebSocketClient::is_valid_json_start(const std::string &message)
@@ -1169,6 +1214,12 @@ namespace open_dtc_server
                 return first_char == '{' || first_char == '[';
             }
 
+            std::string SSLWebSocketClient::get_peer_address() const
+            {
+                std::lock_guard<std::mutex> lock(peer_address_mutex_);
+                return peer_address_;
+            }
+
             std::chrono::steady_clock::time_point SSLWebSocketClient::get_last_message_time() const
             {
                 return std::chrono::steady_clock::time_point(
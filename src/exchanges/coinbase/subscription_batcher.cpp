@@ -0,0 +1,186 @@
+#include "coinbase_dtc_core/exchanges/coinbase/subscription_batcher.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace coinbase
+        {
+
+            void SubscriptionBatcher::subscribe(const std::string &channel, const std::string &product_id, Clock::time_point now)
+            {
+                intents_++;
+                if (channels_[channel].wanted.insert(product_id).second)
+                    mark_dirty(now);
+            }
+
+            void SubscriptionBatcher::unsubscribe(const std::string &channel, const std::string &product_id, Clock::time_point now)
+            {
+                intents_++;
+                auto it = channels_.find(channel);
+                if (it != channels_.end() && it->second.wanted.erase(product_id) > 0)
+                    mark_dirty(now);
+            }
+
+            void SubscriptionBatcher::refresh(const std::string &channel, const std::string &product_id, Clock::time_point now)
+            {
+                intents_++;
+                auto it = channels_.find(channel);
+                if (it == channels_.end() || it->second.wanted.count(product_id) == 0)
+                    return;
+                it->second.refresh.insert(product_id);
+                mark_dirty(now);
+            }
+
+            void SubscriptionBatcher::drop(const std::string &channel, const std::string &product_id)
+            {
+                auto it = channels_.find(channel);
+                if (it == channels_.end())
+                    return;
+                it->second.wanted.erase(product_id);
+                it->second.upstream.erase(product_id);
+                it->second.refresh.erase(product_id);
+            }
+
+            void SubscriptionBatcher::reset(Clock::time_point now)
+            {
+                bool any_wanted = false;
+                for (auto &[channel, state] : channels_)
+                {
+                    state.upstream.clear();
+                    state.refresh.clear();
+                    any_wanted = any_wanted || !state.wanted.empty();
+                }
+                if (any_wanted)
+                    mark_dirty(now);
+            }
+
+            std::vector<SubscriptionBatcher::Request> SubscriptionBatcher::poll(Clock::time_point now)
+            {
+                std::vector<Request> sent;
+                if (!dirty_ || now < dirty_since_ + limits_.window)
+                    return sent;
+
+                while (!recent_sends_.empty() && now - recent_sends_.front() >= std::chrono::seconds(1))
+                    recent_sends_.pop_front();
+                size_t budget = limits_.max_messages_per_second > recent_sends_.size()
+                                    ? limits_.max_messages_per_second - recent_sends_.size()
+                                    : 0;
+
+                bool held_back = false;
+                auto send = [&](std::vector<Request> &requests, ChannelState &state)
+                {
+                    for (auto &request : requests)
+                    {
+                        if (budget == 0)
+                        {
+                            held_back = true;
+                            return;
+                        }
+                        budget--;
+                        for (const auto &product : request.product_ids)
+                        {
+                            if (request.subscribe)
+                                state.upstream.insert(product);
+                            else
+                                state.upstream.erase(product);
+                        }
+                        recent_sends_.push_back(now);
+                        messages_sent_++;
+                        sent.push_back(std::move(request));
+                    }
+                };
+
+                for (auto &[channel, state] : channels_)
+                {
+                    // Unsubscribes first: a refresh is an unsubscribe followed by a subscribe
+                    std::vector<std::string> products;
+                    for (const auto &product : state.upstream)
+                    {
+                        if (state.wanted.count(product) == 0 || state.refresh.count(product) > 0)
+                            products.push_back(product);
+                    }
+
+                    std::vector<Request> requests;
+                    split(false, channel, products, requests);
+                    send(requests, state);
+
+                    // Refreshes held back by the rate limit are still upstream
+                    for (auto it = state.refresh.begin(); it != state.refresh.end();)
+                        it = state.upstream.count(*it) ? std::next(it) : state.refresh.erase(it);
+
+                    products.clear();
+                    std::set_difference(state.wanted.begin(), state.wanted.end(), state.upstream.begin(), state.upstream.end(),
+                                        std::back_inserter(products));
+                    requests.clear();
+                    split(true, channel, products, requests);
+                    send(requests, state);
+                }
+
+                // Held back by the rate limit: still dirty, next_due() says when
+                dirty_ = held_back;
+                return sent;
+            }
+
+            SubscriptionBatcher::Clock::time_point SubscriptionBatcher::next_due() const
+            {
+                if (!dirty_)
+                    return Clock::time_point::max();
+
+                auto due = dirty_since_ + limits_.window;
+                if (limits_.max_messages_per_second > 0 && recent_sends_.size() >= limits_.max_messages_per_second)
+                    due = std::max(due, recent_sends_[recent_sends_.size() - limits_.max_messages_per_second] + std::chrono::seconds(1));
+                return due;
+            }
+
+            bool SubscriptionBatcher::is_wanted(const std::string &channel, const std::string &product_id) const
+            {
+                auto it = channels_.find(channel);
+                return it != channels_.end() && it->second.wanted.count(product_id) > 0;
+            }
+
+            std::vector<std::string> SubscriptionBatcher::wanted(const std::string &channel) const
+            {
+                auto it = channels_.find(channel);
+                if (it == channels_.end())
+                    return {};
+                return std::vector<std::string>(it->second.wanted.begin(), it->second.wanted.end());
+            }
+
+            bool SubscriptionBatcher::has_pending() const
+            {
+                return dirty_;
+            }
+
+            void SubscriptionBatcher::mark_dirty(Clock::time_point now)
+            {
+                if (!dirty_)
+                {
+                    dirty_ = true;
+                    dirty_since_ = now;
+                }
+            }
+
+            void SubscriptionBatcher::split(bool subscribe, const std::string &channel, const std::vector<std::string> &products,
+                                            std::vector<Request> &out) const
+            {
+                size_t bytes = 0;
+                for (const auto &product : products)
+                {
+                    // "PRODUCT", as it appears in the product_ids array
+                    size_t product_bytes = product.size() + 3;
+                    if (out.empty() || bytes + product_bytes > limits_.max_message_bytes)
+                    {
+                        out.push_back(Request{subscribe, channel, {}});
+                        bytes = limits_.message_overhead_bytes + channel.size();
+                    }
+                    out.back().product_ids.push_back(product);
+                    bytes += product_bytes;
+                }
+            }
+
+        } // namespace coinbase
+    } // namespace exchanges
+} // namespace open_dtc_server
@@ -0,0 +1,168 @@
+#include "coinbase_dtc_core/exchanges/coinbase/user_feed.hpp"
+#include "coinbase_dtc_core/exchanges/coinbase/order_fields.hpp"
+#include "coinbase_dtc_core/exchanges/base/decimal.hpp"
+#include "coinbase_dtc_core/exchanges/coinbase/ssl_websocket_client.hpp"
+#include "coinbase_dtc_core/core/util/advanced_log.hpp"
+#include <nlohmann/json.hpp>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace coinbase
+        {
+
+            namespace
+            {
+                // Coinbase sends decimals as strings; tolerate numbers and empty strings
+                double decimal_field(const nlohmann::json &object, const char *key)
+                {
+                    auto it = object.find(key);
+                    if (it == object.end())
+                        return 0.0;
+                    if (it->is_number())
+                        return it->get<double>();
+                    if (it->is_string())
+                        return base::decimal::parse_decimal_or(it->get_ref<const std::string &>(), 0.0);
+                    return 0.0;
+                }
+
+                std::string string_field(const nlohmann::json &object, const char *key)
+                {
+                    auto it = object.find(key);
+                    return it != object.end() && it->is_string() ? it->get<std::string>() : std::string();
+                }
+
+                bool parse_user_order(const nlohmann::json &order, base::OrderEvent &event)
+                {
+                    event.order_id = string_field(order, "order_id");
+                    if (event.order_id.empty())
+                        return false;
+
+                    event.client_order_id = string_field(order, "client_order_id");
+                    event.symbol = string_field(order, "product_id");
+                    event.is_buy = string_field(order, "order_side") != "SELL";
+                    event.kind = order_fields::parse_order_kind(string_field(order, "order_type"));
+                    event.state = order_fields::parse_order_state(string_field(order, "status"));
+                    event.limit_price = decimal_field(order, "limit_price");
+                    event.stop_price = decimal_field(order, "stop_price");
+                    event.filled_quantity = decimal_field(order, "cumulative_quantity");
+                    event.quantity = event.filled_quantity + decimal_field(order, "leaves_quantity");
+                    event.average_fill_price = decimal_field(order, "avg_price");
+                    event.created_time_ms = order_fields::parse_time_ms(string_field(order, "creation_time"));
+                    return true;
+                }
+            } // namespace
+
+            CoinbaseUserFeed::CoinbaseUserFeed(const auth::CDPCredentials &credentials, const std::string &host)
+                : credentials_(credentials), host_(host)
+            {
+            }
+
+            CoinbaseUserFeed::~CoinbaseUserFeed()
+            {
+                disconnect();
+            }
+
+            bool CoinbaseUserFeed::connect(const std::vector<std::string> &symbols)
+            {
+                if (is_connected())
+                    return true;
+
+                if (!credentials_.is_valid())
+                {
+                    LOG_WARN("[COINBASE-USER] No credentials - user channel disabled");
+                    return false;
+                }
+
+                symbols_ = symbols;
+                client_ = std::make_unique<feed::coinbase::SSLWebSocketClient>();
+                client_->set_credentials(credentials_.key_id, credentials_.private_key);
+
+                client_->set_message_callback([this](const std::string &message)
+                                              { on_message(message); });
+                client_->set_error_callback([](const std::string &error)
+                                            { LOG_WARN("[COINBASE-USER] " + error); });
+                client_->set_connection_callback([this](bool connected)
+                                                 {
+                    if (connected && !client_->subscribe_to_user(symbols_))
+                        LOG_ERROR("[COINBASE-USER] User channel subscription failed");
+                    if (!connected)
+                        LOG_WARN("[COINBASE-USER] User channel disconnected - order state is stale until reconnect");
+                    if (connection_callback_)
+                        connection_callback_(connected); });
+
+                if (!client_->connect(host_, USER_WEBSOCKET_PORT))
+                {
+                    LOG_ERROR("[COINBASE-USER] Failed to connect to " + host_);
+                    client_.reset();
+                    return false;
+                }
+
+                LOG_INFO("[COINBASE-USER] Streaming own orders from " + host_);
+                return true;
+            }
+
+            void CoinbaseUserFeed::disconnect()
+            {
+                if (client_)
+                {
+                    client_->disconnect();
+                    client_.reset();
+                }
+            }
+
+            bool CoinbaseUserFeed::is_connected() const
+            {
+                return client_ && client_->is_connected();
+            }
+
+            void CoinbaseUserFeed::on_message(const std::string &message)
+            {
+                if (!parse_user_message(message, scratch_))
+                    return;
+
+                orders_received_.fetch_add(scratch_.size());
+                if (order_callback_)
+                {
+                    for (const auto &event : scratch_)
+                        order_callback_(event);
+                }
+            }
+
+            bool CoinbaseUserFeed::parse_user_message(const std::string &message, std::vector<base::OrderEvent> &orders)
+            {
+                orders.clear();
+
+                auto parsed = nlohmann::json::parse(message, nullptr, false);
+                if (parsed.is_discarded() || !parsed.is_object())
+                    return false;
+
+                auto channel = parsed.find("channel");
+                if (channel == parsed.end() || !channel->is_string() || channel->get_ref<const std::string &>() != "user")
+                    return false;
+
+                auto events = parsed.find("events");
+                if (events == parsed.end() || !events->is_array())
+                    return true;
+
+                // "snapshot" and "update" events carry the same order objects
+                for (const auto &event : *events)
+                {
+                    auto event_orders = event.find("orders");
+                    if (event_orders == event.end() || !event_orders->is_array())
+                        continue;
+
+                    for (const auto &order : *event_orders)
+                    {
+                        base::OrderEvent parsed_order;
+                        if (parse_user_order(order, parsed_order))
+                            orders.push_back(std::move(parsed_order));
+                    }
+                }
+                return true;
+            }
+
+        } // namespace coinbase
+    } // namespace exchanges
+} // namespace open_dtc_server
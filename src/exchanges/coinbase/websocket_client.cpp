@@ -36,6 +36,23 @@ namespace open_dtc_server
     {
         namespace coinbase
         {
+            namespace
+            {
+                // This client predates the feed classes; products register under "coinbase" when subscribed
+                void register_product(const std::string &product_id)
+                {
+                    std::string normalized = product_id;
+                    std::replace(normalized.begin(), normalized.end(), '-', '/');
+                    exchanges::base::SymbolRegistry::getInstance().intern("coinbase", product_id, normalized);
+                }
+
+                // Message handlers only look products up; unsubscribed ones stay NO_INSTRUMENT
+                exchanges::base::InstrumentId instrument_for(const std::string &product_id)
+                {
+                    return exchanges::base::SymbolRegistry::getInstance().find("coinbase", product_id);
+                }
+            }
+
             WebSocketClient::WebSocketClient()
                 : connected_(false), should_stop_(false), socket_(-1),
                   host_("ws-feed.exchange.coinbase.com"), port_(443),
@@ -127,6 +144,7 @@ namespace open_dtc_server
 
             bool WebSocketClient::subscribe_trades(const std::string &product_id)
             {
+                register_product(product_id);
                 std::lock_guard<std::mutex> lock(subscriptions_mutex_);
 
                 // Add to subscribed symbols if not already present
@@ -147,6 +165,7 @@ namespace open_dtc_server
 
             bool WebSocketClient::subscribe_level2(const std::string &product_id)
             {
+                register_product(product_id);
                 std::lock_guard<std::mutex> lock(subscriptions_mutex_);
                 LOG_INFO("[WS] Subscribed to level2: " + product_id);
 
@@ -518,7 +537,7 @@ namespace open_dtc_server
                         size_t product_end = message.find("\"", product_start);
                         if (product_end != std::string::npos)
                         {
-                            trade.symbol = message.substr(product_start, product_end - product_start);
+                            trade.instrument = instrument_for(message.substr(product_start, product_end - product_start));
                         }
                     }
 
@@ -556,14 +575,18 @@ namespace open_dtc_server
                         size_t side_end = message.find("\"", side_start);
                         if (side_end != std::string::npos)
                         {
-                            trade.side = message.substr(side_start, side_end - side_start);
+                            // Maker side; the aggressor took the other one
+                            std::string side = message.substr(side_start, side_end - side_start);
+                            trade.side = side == "buy" ? exchanges::base::TradeSide::SELL
+                                                       : (side == "sell" ? exchanges::base::TradeSide::BUY : exchanges::base::TradeSide::UNKNOWN);
                         }
                     }
 
-                    trade.timestamp = get_current_timestamp();
+                    trade.receive_time_us = exchanges::base::timestamp::now_us();
+                    trade.exchange_time_us = trade.receive_time_us;
 
                     // Call trade callback
-                    if (trade_callback_ && !trade.symbol.empty())
+                    if (trade_callback_ && trade.instrument != exchanges::base::NO_INSTRUMENT)
                     {
                         std::lock_guard<std::mutex> lock(callback_mutex_);
                         trade_callback_(trade);
@@ -593,7 +616,7 @@ namespace open_dtc_server
                         size_t product_end = message.find("\"", product_start);
                         if (product_end != std::string::npos)
                         {
-                            level2.symbol = message.substr(product_start, product_end - product_start);
+                            level2.instrument = instrument_for(message.substr(product_start, product_end - product_start));
                         }
                     }
 
@@ -603,10 +626,11 @@ namespace open_dtc_server
                     level2.bid_size = 1.0 + (rand() % 5);
                     level2.ask_price = 50100.0 + (rand() % 200);
                     level2.ask_size = 1.0 + (rand() % 5);
-                    level2.timestamp = get_current_timestamp();
+                    level2.receive_time_us = exchanges::base::timestamp::now_us();
+                    level2.exchange_time_us = level2.receive_time_us;
 
                     // Call level2 callback
-                    if (level2_callback_ && !level2.symbol.empty())
+                    if (level2_callback_ && level2.instrument != exchanges::base::NO_INSTRUMENT)
                     {
                         std::lock_guard<std::mutex> lock(callback_mutex_);
                         level2_callback_(level2);
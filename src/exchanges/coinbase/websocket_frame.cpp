@@ -0,0 +1,291 @@
+#include "coinbase_dtc_core/exchanges/coinbase/websocket_frame.hpp"
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <openssl/rand.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define WEBSOCKET_MASK_SSE2 1
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#include <arm_neon.h>
+#define WEBSOCKET_MASK_NEON 1
+#endif
+
+namespace open_dtc_server
+{
+    namespace feed
+    {
+        namespace coinbase
+        {
+
+            void mask_websocket_payload(uint8_t *data, size_t size, const uint8_t key[4])
+            {
+                uint8_t pattern[16];
+                for (size_t i = 0; i < sizeof(pattern); ++i)
+                    pattern[i] = key[i & 3];
+
+                // Every step is a multiple of 4 bytes, so the key phase never shifts
+                size_t i = 0;
+#if defined(WEBSOCKET_MASK_SSE2)
+                const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pattern));
+                for (; i + 16 <= size; i += 16)
+                {
+                    __m128i *block = reinterpret_cast<__m128i *>(data + i);
+                    _mm_storeu_si128(block, _mm_xor_si128(_mm_loadu_si128(block), mask));
+                }
+#elif defined(WEBSOCKET_MASK_NEON)
+                const uint8x16_t mask = vld1q_u8(pattern);
+                for (; i + 16 <= size; i += 16)
+                    vst1q_u8(data + i, veorq_u8(vld1q_u8(data + i), mask));
+#endif
+                uint64_t word;
+                std::memcpy(&word, pattern, sizeof(word));
+                for (; i + 8 <= size; i += 8)
+                {
+                    uint64_t block;
+                    std::memcpy(&block, data + i, sizeof(block));
+                    block ^= word;
+                    std::memcpy(data + i, &block, sizeof(block));
+                }
+                for (; i < size; ++i)
+                    data[i] ^= pattern[i & 3];
+            }
+
+            FrameReader::FrameReader(size_t capacity, size_t max_message_bytes)
+                : buffer_(std::max<size_t>(capacity, 16)), max_message_bytes_(max_message_bytes)
+            {
+            }
+
+            void FrameReader::release()
+            {
+                // The last message handed out is no longer needed; a reassembly in progress still is
+                if (fragmented_)
+                    return;
+                read_ = parse_;
+                if (read_ == write_)
+                    read_ = parse_ = write_ = 0;
+            }
+
+            uint8_t *FrameReader::write_space(size_t min_bytes, size_t &available)
+            {
+                release();
+                if (buffer_.size() - write_ < min_bytes)
+                {
+                    // Move what is still needed to the front, then grow if that was not enough
+                    size_t shift = read_;
+                    if (shift > 0)
+                    {
+                        std::memmove(buffer_.data(), buffer_.data() + shift, write_ - shift);
+                        read_ = 0;
+                        parse_ -= shift;
+                        write_ -= shift;
+                        if (fragmented_)
+                            assembled_end_ -= shift;
+                    }
+                    if (buffer_.size() - write_ < min_bytes)
+                        buffer_.resize(std::max(buffer_.size() * 2, write_ + min_bytes));
+                }
+                available = buffer_.size() - write_;
+                return buffer_.data() + write_;
+            }
+
+            void FrameReader::commit(size_t bytes)
+            {
+                write_ = std::min(write_ + bytes, buffer_.size());
+            }
+
+            void FrameReader::append(const uint8_t *data, size_t size)
+            {
+                size_t available = 0;
+                uint8_t *space = write_space(size, available);
+                if (size > 0)
+                    std::memcpy(space, data, size);
+                commit(size);
+            }
+
+            void FrameReader::reset()
+            {
+                read_ = parse_ = write_ = 0;
+                fragmented_ = false;
+                assembled_end_ = 0;
+                error_.clear();
+            }
+
+            FrameReader::Status FrameReader::fail(const std::string &error)
+            {
+                error_ = error;
+                return Status::PROTOCOL_ERROR;
+            }
+
+            FrameReader::Status FrameReader::next(Message &message)
+            {
+                release();
+                while (true)
+                {
+                    size_t available = write_ - parse_;
+                    if (available < 2)
+                        return Status::NEED_MORE;
+
+                    const uint8_t *header = buffer_.data() + parse_;
+                    bool fin = (header[0] & 0x80) != 0;
+                    bool rsv1 = (header[0] & 0x40) != 0;
+                    bool control = (header[0] & 0x08) != 0;
+                    auto opcode = static_cast<WebSocketOpcode>(header[0] & 0x0F);
+                    bool masked = (header[1] & 0x80) != 0;
+                    uint64_t length = header[1] & 0x7F;
+
+                    size_t header_size = 2;
+                    if (length == 126)
+                    {
+                        if (available < 4)
+                            return Status::NEED_MORE;
+                        length = (static_cast<uint64_t>(header[2]) << 8) | header[3];
+                        header_size = 4;
+                    }
+                    else if (length == 127)
+                    {
+                        if (available < 10)
+                            return Status::NEED_MORE;
+                        length = 0;
+                        for (int i = 0; i < 8; ++i)
+                            length = (length << 8) | header[2 + i];
+                        header_size = 10;
+                    }
+                    uint8_t key[4] = {0, 0, 0, 0};
+                    if (masked)
+                    {
+                        if (available < header_size + 4)
+                            return Status::NEED_MORE;
+                        std::memcpy(key, header + header_size, sizeof(key));
+                        header_size += 4;
+                    }
+
+                    // Checked on the header alone, so a bad frame fails before its payload arrives
+                    switch (opcode)
+                    {
+                    case WebSocketOpcode::CONTINUATION:
+                    case WebSocketOpcode::TEXT:
+                    case WebSocketOpcode::BINARY:
+                    case WebSocketOpcode::CLOSE:
+                    case WebSocketOpcode::PING:
+                    case WebSocketOpcode::PONG:
+                        break;
+                    default:
+                        return fail("reserved opcode " + std::to_string(header[0] & 0x0F));
+                    }
+                    if ((header[0] & 0x30) != 0)
+                        return fail("RSV2/RSV3 set without a negotiated extension");
+                    if (control && (!fin || length > 125 || rsv1))
+                        return fail("control frames must be final, uncompressed and at most 125 bytes");
+                    if (opcode == WebSocketOpcode::CONTINUATION && (!fragmented_ || rsv1))
+                        return fail("unexpected continuation frame");
+                    if (!control && opcode != WebSocketOpcode::CONTINUATION && fragmented_)
+                        return fail("data frame before the fragmented message finished");
+
+                    size_t assembled = opcode == WebSocketOpcode::CONTINUATION ? assembled_end_ - read_ : 0;
+                    if (length > max_message_bytes_ - assembled)
+                        return fail("message larger than " + std::to_string(max_message_bytes_) + " bytes");
+                    if (available - header_size < length)
+                        return Status::NEED_MORE;
+
+                    size_t frame_start = parse_;
+                    size_t size = static_cast<size_t>(length);
+                    uint8_t *payload = buffer_.data() + frame_start + header_size;
+                    if (masked)
+                        mask_websocket_payload(payload, size, key);
+                    parse_ = frame_start + header_size + size;
+
+                    if (control || (fin && opcode != WebSocketOpcode::CONTINUATION))
+                    {
+                        message.opcode = opcode;
+                        message.compressed = rsv1;
+                        message.data = payload;
+                        message.size = size;
+                        return Status::MESSAGE;
+                    }
+
+                    // Fragments: payloads slide down over the headers between them
+                    if (opcode != WebSocketOpcode::CONTINUATION)
+                    {
+                        fragmented_ = true;
+                        fragment_opcode_ = opcode;
+                        fragment_compressed_ = rsv1;
+                        read_ = frame_start;
+                        assembled_end_ = frame_start;
+                    }
+                    std::memmove(buffer_.data() + assembled_end_, payload, size);
+                    assembled_end_ += size;
+                    if (!fin)
+                        continue;
+
+                    fragmented_ = false;
+                    message.opcode = fragment_opcode_;
+                    message.compressed = fragment_compressed_;
+                    message.data = buffer_.data() + read_;
+                    message.size = assembled_end_ - read_;
+                    return Status::MESSAGE;
+                }
+            }
+
+            FrameWriter::FrameWriter(size_t capacity)
+                : buffer_(std::max<size_t>(capacity, 14)), mask_pool_used_(sizeof(mask_pool_))
+            {
+            }
+
+            void FrameWriter::next_mask(uint8_t key[4])
+            {
+                if (mask_pool_used_ + 4 > sizeof(mask_pool_))
+                {
+                    if (RAND_bytes(mask_pool_, sizeof(mask_pool_)) != 1)
+                    {
+                        // Keys only have to be unpredictable to scripts on the path, not secret
+                        static thread_local std::mt19937 fallback(std::random_device{}());
+                        for (auto &byte : mask_pool_)
+                            byte = static_cast<uint8_t>(fallback());
+                    }
+                    mask_pool_used_ = 0;
+                }
+                std::memcpy(key, mask_pool_ + mask_pool_used_, 4);
+                mask_pool_used_ += 4;
+            }
+
+            std::string_view FrameWriter::build(WebSocketOpcode opcode, const void *payload, size_t size)
+            {
+                size_t header_size = size < 126 ? 2 : size <= 0xFFFF ? 4
+                                                                      : 10;
+                size_t frame_size = header_size + 4 + size;
+                if (buffer_.size() < frame_size)
+                    buffer_.resize(std::max(frame_size, buffer_.size() * 2));
+
+                uint8_t *frame = buffer_.data();
+                frame[0] = static_cast<uint8_t>(0x80 | static_cast<uint8_t>(opcode)); // FIN
+                if (size < 126)
+                {
+                    frame[1] = static_cast<uint8_t>(0x80 | size); // MASK
+                }
+                else if (size <= 0xFFFF)
+                {
+                    frame[1] = 0x80 | 126;
+                    frame[2] = static_cast<uint8_t>(size >> 8);
+                    frame[3] = static_cast<uint8_t>(size);
+                }
+                else
+                {
+                    frame[1] = 0x80 | 127;
+                    for (int i = 0; i < 8; ++i)
+                        frame[2 + i] = static_cast<uint8_t>(static_cast<uint64_t>(size) >> (56 - 8 * i));
+                }
+
+                uint8_t *key = frame + header_size;
+                next_mask(key);
+                uint8_t *body = key + 4;
+                if (size > 0)
+                    std::memcpy(body, payload, size);
+                mask_websocket_payload(body, size, key);
+                return std::string_view(reinterpret_cast<const char *>(frame), frame_size);
+            }
+
+        } // namespace coinbase
+    } // namespace feed
+} // namespace open_dtc_server
@@ -1,6 +1,7 @@
 #include "coinbase_dtc_core/exchanges/factory/exchange_factory.hpp"
 #include "coinbase_dtc_core/exchanges/coinbase/coinbase_feed.hpp"
 #include "coinbase_dtc_core/exchanges/binance/binance_feed.hpp"
+#include "coinbase_dtc_core/exchanges/replay/replay_feed.hpp"
 #include "coinbase_dtc_core/core/util/log.hpp"
 #include <stdexcept>
 #include <algorithm>
@@ -30,10 +31,15 @@ namespace open_dtc_server
                     auto feed = std::make_unique<binance::BinanceFeed>(config);
                     return std::move(feed);
                 }
+                else if (exchange_name == "replay")
+                {
+                    auto feed = std::make_unique<replay::ReplayFeed>(config);
+                    return feed;
+                }
                 else
                 {
                     throw std::invalid_argument("Unsupported exchange: " + config.name +
-                                                ". Supported exchanges: coinbase, binance");
+                                                ". Supported exchanges: coinbase, binance, replay");
                 }
             }
 
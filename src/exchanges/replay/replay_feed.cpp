@@ -0,0 +1,312 @@
+#include "coinbase_dtc_core/exchanges/replay/replay_feed.hpp"
+#include "coinbase_dtc_core/core/util/log.hpp"
+#include <sstream>
+
+namespace open_dtc_server
+{
+    namespace exchanges
+    {
+        namespace replay
+        {
+            using base::BookDelta;
+            using base::BookSide;
+            using base::InstrumentId;
+            using base::JournalRecord;
+            using base::NO_INSTRUMENT;
+
+            ReplayFeed::ReplayFeed(const base::ExchangeConfig &config)
+                : base::ExchangeFeedBase(config)
+            {
+            }
+
+            ReplayFeed::~ReplayFeed()
+            {
+                disconnect();
+            }
+
+            bool ReplayFeed::connect()
+            {
+                if (running_)
+                    return true;
+
+                if (base::JournalReader::list_segments(config_.replay_path).empty())
+                {
+                    notify_error("No journal segments in replay path: " + config_.replay_path);
+                    return false;
+                }
+
+                if (replay_thread_.joinable())
+                    replay_thread_.join();
+
+                // A session replayed whole registers all its products before the thread starts
+                if (get_subscribed_symbols().empty())
+                {
+                    for (const auto &symbol : get_available_symbols())
+                        register_instrument(symbol);
+                }
+
+                running_ = true;
+                finished_ = false;
+                records_replayed_ = 0;
+                trades_replayed_ = 0;
+                replay_thread_ = std::thread(&ReplayFeed::replay_thread_function, this);
+
+                util::simple_log("[REPLAY] Replaying " + config_.replay_path + " at speed " + std::to_string(config_.replay_speed));
+                notify_connection(true);
+                return true;
+            }
+
+            void ReplayFeed::disconnect()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(finished_mutex_);
+                    if (!running_ && !replay_thread_.joinable())
+                        return;
+                    running_ = false;
+                }
+                finished_cv_.notify_all();
+                if (replay_thread_.joinable())
+                    replay_thread_.join();
+                notify_connection(false);
+            }
+
+            bool ReplayFeed::is_connected() const
+            {
+                return running_;
+            }
+
+            bool ReplayFeed::subscribe_trades(const std::string &symbol)
+            {
+                register_instrument(symbol);
+                std::lock_guard<std::mutex> lock(symbols_mutex_);
+                subscribed_symbols_.insert(symbol);
+                return true;
+            }
+
+            bool ReplayFeed::subscribe_level2(const std::string &symbol)
+            {
+                return subscribe_trades(symbol);
+            }
+
+            bool ReplayFeed::unsubscribe(const std::string &symbol)
+            {
+                std::lock_guard<std::mutex> lock(symbols_mutex_);
+                return subscribed_symbols_.erase(symbol) > 0;
+            }
+
+            bool ReplayFeed::subscribe_multiple_symbols(const std::vector<std::string> &symbols)
+            {
+                for (const auto &symbol : symbols)
+                    subscribe_trades(symbol);
+                return true;
+            }
+
+            std::vector<std::string> ReplayFeed::get_available_symbols()
+            {
+                // Scan the session once for the symbols it contains
+                std::unordered_set<std::string> symbols;
+                base::JournalReader reader(config_.replay_path);
+                std::vector<JournalRecord> records;
+                while (reader.poll(records, READ_BATCH) > 0)
+                {
+                    for (const auto &record : records)
+                        symbols.insert(record.symbol);
+                    records.clear();
+                }
+                return std::vector<std::string>(symbols.begin(), symbols.end());
+            }
+
+            std::string ReplayFeed::get_status() const
+            {
+                std::ostringstream status;
+                status << "Replay feed [" << config_.replay_path << "] "
+                       << (finished_ ? "finished" : (running_ ? "running" : "stopped"))
+                       << ", records: " << records_replayed_.load()
+                       << ", trades: " << trades_replayed_.load()
+                       << ", speed: " << config_.replay_speed;
+                return status.str();
+            }
+
+            std::vector<std::string> ReplayFeed::get_subscribed_symbols() const
+            {
+                std::lock_guard<std::mutex> lock(symbols_mutex_);
+                return std::vector<std::string>(subscribed_symbols_.begin(), subscribed_symbols_.end());
+            }
+
+            bool ReplayFeed::wait_until_finished(std::chrono::milliseconds timeout)
+            {
+                std::unique_lock<std::mutex> lock(finished_mutex_);
+                return finished_cv_.wait_for(lock, timeout, [this]
+                                             { return finished_.load() || !running_.load(); }) &&
+                       finished_;
+            }
+
+            void ReplayFeed::replay_thread_function()
+            {
+                base::JournalReader reader(config_.replay_path);
+                std::vector<JournalRecord> records;
+                records.reserve(READ_BATCH);
+
+                const bool timed = config_.replay_speed > 0.0;
+                auto start = std::chrono::steady_clock::now();
+                uint64_t first_timestamp = 0;
+
+                while (running_ && reader.poll(records, READ_BATCH) > 0)
+                {
+                    for (const auto &record : records)
+                    {
+                        if (!running_)
+                            break;
+
+                        if (timed)
+                        {
+                            if (first_timestamp == 0)
+                                first_timestamp = record.timestamp;
+
+                            // Sleep until the record's original offset, scaled by the speed
+                            if (record.timestamp > first_timestamp)
+                            {
+                                auto offset = std::chrono::duration<double, std::micro>(
+                                    (record.timestamp - first_timestamp) / config_.replay_speed);
+                                auto due = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset);
+                                if (due > std::chrono::steady_clock::now())
+                                {
+                                    std::unique_lock<std::mutex> lock(finished_mutex_);
+                                    finished_cv_.wait_until(lock, due, [this]
+                                                            { return !running_.load(); });
+                                }
+                            }
+                        }
+
+                        emit(record);
+                        records_replayed_.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    records.clear();
+                }
+
+                flush_snapshot();
+
+                {
+                    std::lock_guard<std::mutex> lock(finished_mutex_);
+                    finished_ = running_.load();
+                }
+                finished_cv_.notify_all();
+                util::simple_log("[REPLAY] Replay finished: " + std::to_string(records_replayed_.load()) + " records");
+            }
+
+            void ReplayFeed::emit(const JournalRecord &record)
+            {
+                if (record.type != JournalRecord::BOOK_LEVEL)
+                    flush_snapshot();
+
+                std::string symbol(record.symbol);
+                if (!is_wanted(symbol))
+                    return;
+                InstrumentId instrument = instrument_for(symbol);
+                if (instrument == NO_INSTRUMENT)
+                    return;
+
+                switch (record.type)
+                {
+                case JournalRecord::TRADE:
+                {
+                    base::MarketTrade trade;
+                    trade.instrument = instrument;
+                    trade.price = record.price;
+                    trade.volume = record.size;
+                    trade.side = record.side <= 2 ? static_cast<base::TradeSide>(record.side) : base::TradeSide::UNKNOWN;
+                    trade.exchange_time_us = record.timestamp;
+                    trade.receive_time_us = base::timestamp::now_us();
+                    trades_replayed_.fetch_add(1, std::memory_order_relaxed);
+                    notify_trade(trade);
+                    break;
+                }
+
+                case JournalRecord::QUOTE:
+                {
+                    // Quotes are journaled as a bid record followed by an ask record
+                    auto &quote = pending_quotes_[instrument];
+                    if (record.side == static_cast<uint8_t>(BookSide::BID))
+                    {
+                        quote.bid_price = record.price;
+                        quote.bid_size = record.size;
+                        break;
+                    }
+                    quote.instrument = instrument;
+                    quote.ask_price = record.price;
+                    quote.ask_size = record.size;
+                    quote.exchange_time_us = record.timestamp;
+                    quote.receive_time_us = base::timestamp::now_us();
+                    notify_level2(quote);
+                    break;
+                }
+
+                case JournalRecord::BOOK_DELTA:
+                {
+                    base::MarketDepthUpdate update;
+                    update.instrument = instrument;
+                    update.action = base::MarketDepthUpdate::Action::SET;
+                    update.is_bid = record.side == static_cast<uint8_t>(BookSide::BID);
+                    update.price = record.price;
+                    update.size = record.size;
+                    update.exchange_time_us = record.timestamp;
+                    update.receive_time_us = base::timestamp::now_us();
+                    update.delta.type = static_cast<BookDelta::Type>(record.delta_type);
+                    update.delta.side = static_cast<BookSide>(record.side);
+                    update.delta.position = record.position;
+                    update.delta.price = record.price;
+                    update.delta.size = record.size;
+                    notify_depth(update);
+                    break;
+                }
+
+                case JournalRecord::BOOK_RESET:
+                    snapshot_instrument_ = instrument;
+                    snapshot_timestamp_ = record.timestamp;
+                    break;
+
+                case JournalRecord::BOOK_LEVEL:
+                    if (instrument != snapshot_instrument_)
+                        break;
+                    if (record.side == static_cast<uint8_t>(BookSide::BID))
+                        snapshot_bids_.push_back({record.price, record.size});
+                    else
+                        snapshot_asks_.push_back({record.price, record.size});
+                    break;
+
+                default:
+                    break;
+                }
+            }
+
+            void ReplayFeed::flush_snapshot()
+            {
+                if (snapshot_instrument_ == NO_INSTRUMENT)
+                    return;
+
+                auto book = std::make_shared<base::OrderBook>();
+                book->load(BookSide::BID, std::move(snapshot_bids_));
+                book->load(BookSide::ASK, std::move(snapshot_asks_));
+
+                base::MarketDepthUpdate update;
+                update.instrument = snapshot_instrument_;
+                update.action = base::MarketDepthUpdate::Action::SNAPSHOT;
+                update.exchange_time_us = snapshot_timestamp_;
+                update.receive_time_us = base::timestamp::now_us();
+                update.book = book;
+
+                snapshot_instrument_ = NO_INSTRUMENT;
+                snapshot_bids_.clear();
+                snapshot_asks_.clear();
+                notify_depth(update);
+            }
+
+            bool ReplayFeed::is_wanted(const std::string &symbol) const
+            {
+                std::lock_guard<std::mutex> lock(symbols_mutex_);
+                return subscribed_symbols_.empty() || subscribed_symbols_.count(symbol) > 0;
+            }
+
+        } // namespace replay
+    } // namespace exchanges
+} // namespace open_dtc_server
@@ -129,6 +129,44 @@ int main()
     std::cout << "[OK] Message type detection: " << static_cast<uint16_t>(detected_type)
               << " (expected " << static_cast<uint16_t>(MessageType::MARKET_DATA_UPDATE_BID_ASK) << ")" << std::endl;
 
+    // Test 9: Variable-length string helpers
+    std::cout << "\n[TEST] Testing DTC string helpers..." << std::endl;
+    std::vector<uint8_t> strings;
+    Protocol::write_dtc_string(strings, "BTC-USD");
+    Protocol::write_dtc_string(strings, "");
+    Protocol::write_dtc_string(strings, "coinbase");
+    uint16_t offset = 0;
+    std::string first = Protocol::read_dtc_string(strings.data(), offset, static_cast<uint16_t>(strings.size()));
+    std::string empty = Protocol::read_dtc_string(strings.data(), offset, static_cast<uint16_t>(strings.size()));
+    std::string last = Protocol::read_dtc_string(strings.data(), offset, static_cast<uint16_t>(strings.size()));
+    if (first != "BTC-USD" || !empty.empty() || last != "coinbase" || offset != strings.size())
+    {
+        std::cout << "[ERROR] DTC string round trip failed" << std::endl;
+        return 1;
+    }
+    // An unterminated tail is read up to max_size
+    uint16_t tail_offset = 0;
+    if (Protocol::read_dtc_string(strings.data(), tail_offset, 3) != "BTC" || tail_offset != 3)
+    {
+        std::cout << "[ERROR] Unterminated DTC string not bounded" << std::endl;
+        return 1;
+    }
+    std::cout << "[OK] DTC string round trip" << std::endl;
+
+    // Test 10: Market data feed status
+    std::cout << "\n[TEST] Testing MarketDataFeedStatus..." << std::endl;
+    auto feed_status = protocol.create_market_data_feed_status(false);
+    auto feed_status_data = feed_status->serialize();
+    auto parsed_status = protocol.parse_message(feed_status_data.data(), static_cast<uint16_t>(feed_status_data.size()));
+    auto *status_message = dynamic_cast<MarketDataFeedStatus *>(parsed_status.get());
+    if (!status_message || status_message->status != MarketDataFeedStatusEnum::MARKET_DATA_FEED_UNAVAILABLE ||
+        Protocol::message_type_to_string(status_message->get_type()) != "MARKET_DATA_FEED_STATUS")
+    {
+        std::cout << "[ERROR] MarketDataFeedStatus round trip failed" << std::endl;
+        return 1;
+    }
+    std::cout << "[OK] MarketDataFeedStatus round trip" << std::endl;
+
     std::cout << "\n[SUCCESS] All DTC Protocol tests completed successfully!" << std::endl;
     std::cout << "\n[SUMMARY] DTC Protocol Summary:" << std::endl;
     std::cout << "   * Protocol Version: " << DTC_PROTOCOL_VERSION << std::endl;
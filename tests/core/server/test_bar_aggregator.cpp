@@ -0,0 +1,161 @@
+#include "coinbase_dtc_core/core/server/bar_aggregator.hpp"
+#include "coinbase_dtc_core/core/dtc/protocol.hpp"
+#include "test_support.hpp"
+#include <iostream>
+#include <memory>
+#include <string>
+
+using namespace open_dtc_server;
+using coinbase_dtc_core::core::server::BarAggregator;
+using test_support::check;
+
+namespace
+{
+    // 2023-11-15 00:00:00 UTC
+    const uint64_t DAY_START_MS = 1700006400000ULL;
+    const uint64_t DAY_MS = 24ULL * 60 * 60 * 1000;
+
+    const exchanges::base::InstrumentId BTC = exchanges::base::SymbolRegistry::getInstance().intern("coinbase", "BTC-USD", "BTC/USD");
+    const exchanges::base::InstrumentId ETH = exchanges::base::SymbolRegistry::getInstance().intern("coinbase", "ETH-USD", "ETH/USD");
+    const exchanges::base::InstrumentId SOL = exchanges::base::SymbolRegistry::getInstance().intern("coinbase", "SOL-USD", "SOL/USD");
+}
+
+int main()
+{
+    std::cout << "[TEST] Testing bar aggregation..." << std::endl;
+
+    // Test 1: Session statistics report only the fields that changed
+    {
+        BarAggregator aggregator({1, 60}, 10);
+        BarAggregator::SessionStats session;
+
+        uint8_t changed = aggregator.on_trade(BTC, 100.0, 1.0, DAY_START_MS + 1000, 2, &session);
+        check(changed == (BarAggregator::SESSION_OPEN | BarAggregator::SESSION_HIGH | BarAggregator::SESSION_LOW | BarAggregator::SESSION_VOLUME),
+              "first trade sets every field");
+        check(session.session_start_ms == DAY_START_MS && session.open == 100.0, "session starts at UTC midnight");
+
+        changed = aggregator.on_trade(BTC, 101.0, 0.5, DAY_START_MS + 2000, 2, &session);
+        check(changed == (BarAggregator::SESSION_HIGH | BarAggregator::SESSION_VOLUME), "new high");
+        changed = aggregator.on_trade(BTC, 100.5, 0.5, DAY_START_MS + 3000, 1, &session);
+        check(changed == BarAggregator::SESSION_VOLUME, "inside range changes volume only");
+        changed = aggregator.on_trade(BTC, 99.0, 0.0, DAY_START_MS + 4000, 1, &session);
+        check(changed == BarAggregator::SESSION_LOW, "zero volume trade changes low only");
+
+        check(session.high == 101.0 && session.low == 99.0 && session.volume == 2.0 && session.num_trades == 4, "session OHLV");
+        check(session.last_price == 99.0 && session.last_trade_ms == DAY_START_MS + 4000, "last trade");
+        check(aggregator.on_trade(BTC, 0.0, 1.0, DAY_START_MS + 5000, 1) == 0, "non-positive price ignored");
+        std::cout << "[OK] Session change detection" << std::endl;
+    }
+
+    // Test 2: A new session resets the statistics; the session start is offset from midnight
+    {
+        BarAggregator aggregator({60}, 10, 8 * 60 * 60);
+        BarAggregator::SessionStats session;
+
+        aggregator.on_trade(ETH, 2000.0, 1.0, DAY_START_MS + 7 * 60 * 60 * 1000, 0, &session);
+        check(session.session_start_ms == DAY_START_MS - DAY_MS + 8 * 60 * 60 * 1000, "before offset belongs to previous session");
+
+        uint8_t changed = aggregator.on_trade(ETH, 1990.0, 2.0, DAY_START_MS + 9 * 60 * 60 * 1000, 0, &session);
+        check(changed == (BarAggregator::SESSION_OPEN | BarAggregator::SESSION_HIGH | BarAggregator::SESSION_LOW | BarAggregator::SESSION_VOLUME),
+              "new session sets every field");
+        check(session.open == 1990.0 && session.volume == 2.0 && session.num_trades == 1, "new session reset");
+
+        // A late trade from the previous session leaves the current one alone
+        changed = aggregator.on_trade(ETH, 5000.0, 1.0, DAY_START_MS + 7 * 60 * 60 * 1000, 0, &session);
+        check(changed == 0 && session.high == 1990.0 && session.num_trades == 1, "late trade ignored by session");
+        std::cout << "[OK] Session rollover" << std::endl;
+    }
+
+    // Test 3: Bars per interval, in-progress bar last, ring keeps the newest history
+    {
+        BarAggregator aggregator({1, 60}, 3);
+
+        aggregator.on_trade(BTC, 100.0, 1.0, DAY_START_MS + 100, 2);
+        aggregator.on_trade(BTC, 102.0, 2.0, DAY_START_MS + 900, 1);
+        aggregator.on_trade(BTC, 101.0, 1.0, DAY_START_MS + 1500, 2);
+
+        auto seconds = aggregator.get_bars(BTC, 1);
+        check(seconds.size() == 2, "two 1s bars");
+        if (seconds.size() == 2)
+        {
+            const auto &first = seconds[0];
+            check(first.start_ms == DAY_START_MS && first.open == 100.0 && first.high == 102.0 && first.low == 100.0 && first.close == 102.0,
+                  "first 1s bar OHLC");
+            check(first.volume == 3.0 && first.num_trades == 2 && first.ask_volume == 1.0 && first.bid_volume == 2.0, "first 1s bar volume");
+            check(seconds[1].start_ms == DAY_START_MS + 1000 && seconds[1].close == 101.0, "in-progress bar last");
+        }
+
+        auto minutes = aggregator.get_bars(BTC, 60);
+        check(minutes.size() == 1 && minutes[0].num_trades == 3 && minutes[0].high == 102.0, "one 1m bar");
+
+        // Intervals without trades have no bar; the ring holds history + 1 bars
+        for (uint64_t second = 5; second < 10; second++)
+            aggregator.on_trade(BTC, 100.0 + second, 1.0, DAY_START_MS + second * 1000, 0);
+        seconds = aggregator.get_bars(BTC, 1);
+        check(seconds.size() == 4, "ring capacity");
+        check(!seconds.empty() && seconds.front().start_ms == DAY_START_MS + 6000 && seconds.back().start_ms == DAY_START_MS + 9000,
+              "ring keeps newest bars in order");
+        check(aggregator.get_bars(BTC, 1, 2).size() == 2 && aggregator.get_bars(BTC, 1, 2).back().close == 109.0, "count limit");
+        check(aggregator.get_bars(BTC, 5).empty() && aggregator.get_bars(SOL, 1).empty(), "unknown interval or symbol");
+        std::cout << "[OK] Rolling bars" << std::endl;
+    }
+
+    // Test 4: Encoded session updates and snapshot decode through the protocol
+    {
+        BarAggregator aggregator;
+        BarAggregator::SessionStats session;
+        aggregator.on_trade(BTC, 100.0, 1.5, DAY_START_MS + 5000, 2, &session);
+
+        auto updates = BarAggregator::encode_session_updates(session, BarAggregator::SESSION_HIGH | BarAggregator::SESSION_VOLUME);
+        check(updates.size() == 2, "one message per changed field");
+
+        core::dtc::Protocol protocol;
+        if (updates.size() == 2)
+        {
+            auto high_data = BarAggregator::with_symbol_id(updates[0], 7);
+            auto parsed = protocol.parse_message(high_data.data(), high_data.size());
+            check(parsed && parsed->get_type() == core::dtc::MessageType::MARKET_DATA_UPDATE_SESSION_HIGH, "session high parses");
+            if (parsed && parsed->get_type() == core::dtc::MessageType::MARKET_DATA_UPDATE_SESSION_HIGH)
+            {
+                auto *high = static_cast<core::dtc::MarketDataUpdateSessionHigh *>(parsed.get());
+                check(high->symbol_id == 7 && high->price == 100.0 && high->trading_session_date == DAY_START_MS / 1000, "session high fields");
+            }
+
+            core::dtc::MarketDataUpdateSessionVolume volume;
+            check(volume.deserialize(updates[1].data(), static_cast<uint16_t>(updates[1].size())) && volume.volume == 1.5, "session volume");
+        }
+
+        auto snapshot_data = BarAggregator::encode_snapshot(session, 3);
+        auto parsed = protocol.parse_message(snapshot_data.data(), snapshot_data.size());
+        check(parsed && parsed->get_type() == core::dtc::MessageType::MARKET_DATA_SNAPSHOT, "snapshot parses");
+        if (parsed && parsed->get_type() == core::dtc::MessageType::MARKET_DATA_SNAPSHOT)
+        {
+            auto *snapshot = static_cast<core::dtc::MarketDataSnapshot *>(parsed.get());
+            check(snapshot->symbol_id == 3 && snapshot->session_open_price == 100.0 && snapshot->session_volume == 1.5 &&
+                      snapshot->session_num_trades == 1 && snapshot->last_trade_date_time == (DAY_START_MS + 5000) / 1000,
+                  "snapshot fields");
+        }
+
+        BarAggregator::SessionStats none;
+        check(!aggregator.get_session(ETH, none) && aggregator.get_session(BTC, none) && none.num_trades == 1, "get_session");
+        std::cout << "[OK] Session messages" << std::endl;
+    }
+
+    // Test 5: The same spelling on another exchange keeps its own session
+    {
+        BarAggregator aggregator({60}, 10);
+        auto replayed = exchanges::base::SymbolRegistry::getInstance().intern("replay", "BTC-USD", "BTC/USD");
+        aggregator.on_trade(BTC, 100.0, 1.0, DAY_START_MS + 1000, 2);
+        aggregator.on_trade(replayed, 50.0, 3.0, DAY_START_MS + 2000, 1);
+
+        BarAggregator::SessionStats live, replay;
+        check(aggregator.get_session(BTC, live) && live.high == 100.0 && live.volume == 1.0, "live session untouched");
+        check(aggregator.get_session(replayed, replay) && replay.high == 50.0 && replay.num_trades == 1, "replay session separate");
+        check(!aggregator.get_session(exchanges::base::NO_INSTRUMENT, live) &&
+                  aggregator.on_trade(exchanges::base::NO_INSTRUMENT, 1.0, 1.0, DAY_START_MS, 0) == 0,
+              "unresolved trades ignored");
+        std::cout << "[OK] Sessions by instrument" << std::endl;
+    }
+
+    return test_support::finish("Bar aggregation");
+}
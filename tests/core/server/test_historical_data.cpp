@@ -0,0 +1,218 @@
+#include "coinbase_dtc_core/core/server/historical_data.hpp"
+#include "coinbase_dtc_core/core/history/tick_store.hpp"
+#include "coinbase_dtc_core/core/dtc/protocol.hpp"
+#include "test_support.hpp"
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#ifdef HAS_ZLIB
+#include <zlib.h>
+#endif
+
+using namespace open_dtc_server;
+using coinbase_dtc_core::core::server::HistoricalDataService;
+using test_support::check;
+
+namespace
+{
+    // 2023-11-14 22:13:20 UTC
+    constexpr int64_t BASE_US = 1700000000LL * 1000000LL;
+}
+
+int main()
+{
+    std::cout << "[TEST] Testing historical price data..." << std::endl;
+
+    auto root = std::filesystem::temp_directory_path() / "test_historical_data_ticks";
+    std::filesystem::remove_all(root);
+
+    // Test 1: Range reads across flushes, index strides and a day boundary
+    {
+        core::history::TickStore store(root.string());
+        const int count = 10000;
+        for (int i = 0; i < count; ++i)
+            store.append("BTC-USD", BASE_US + i * 1000LL, 100.0 + i, 0.5, static_cast<uint8_t>(1 + i % 2));
+        store.append("BTC-USD", BASE_US + 86400LL * 1000000LL, 200.0, 1.0, 2);
+
+        core::history::TickColumns ticks;
+        check(store.read_range("BTC-USD", BASE_US + 5000 * 1000LL, BASE_US + 5099 * 1000LL, ticks), "range found");
+        check(ticks.size() == 100, "100 ticks in range");
+        check(!ticks.empty() && ticks.price.front() == 5100.0 && ticks.price.back() == 5199.0, "range bounds");
+
+        ticks.clear();
+        store.read_range("BTC-USD", BASE_US, BASE_US + 2 * 86400LL * 1000000LL, ticks);
+        check(ticks.size() == static_cast<size_t>(count + 1), "read spans both days");
+        check(!ticks.empty() && ticks.price.back() == 200.0 && ticks.side.back() == 2, "next day tick");
+
+        ticks.clear();
+        check(!store.read_range("ETH-USD", BASE_US, BASE_US + 1000, ticks), "unknown symbol has no data");
+        std::cout << "[OK] Tick store range reads" << std::endl;
+    }
+
+    // Test 2: A reopened store keeps appending to the same day files
+    {
+        core::history::TickStore store(root.string());
+        store.append("BTC-USD", BASE_US + 20000 * 1000LL, 300.0, 2.0, 1);
+        core::history::TickColumns ticks;
+        store.read_range("BTC-USD", BASE_US + 19000 * 1000LL, BASE_US + 21000 * 1000LL, ticks);
+        check(ticks.size() == 1 && ticks.price[0] == 300.0, "append after reopen");
+        std::cout << "[OK] Tick store reopen" << std::endl;
+    }
+
+    // Test 2b: Late ticks stay readable; a failed flush leaves the columns aligned
+    {
+        core::history::TickStore store(root.string());
+        store.append("LTC-USD", BASE_US + 5000, 10.0, 1.0, 1);
+        store.append("LTC-USD", BASE_US + 2000, 11.0, 1.0, 1); // Arrives late
+        store.append("LTC-USD", BASE_US + 6000, 12.0, 1.0, 2);
+        core::history::TickColumns ticks;
+        store.read_range("LTC-USD", BASE_US + 4000, BASE_US + 7000, ticks);
+        check(ticks.size() == 3 && ticks.price[1] == 11.0 && ticks.time_us[1] == BASE_US + 5000, "late tick kept at the latest time");
+
+        // price.col as a directory on a fresh day: time.col is written, price.col is not
+        const int64_t later = BASE_US + 3 * 86400LL * 1000000LL;
+        auto day = root / "LTC-USD" / "20231117";
+        std::filesystem::create_directories(day / "price.col");
+        store.append("LTC-USD", later, 13.0, 1.0, 1);
+        store.flush();
+        check(std::filesystem::file_size(day / "time.col") == 0, "partial write truncated");
+
+        std::filesystem::remove(day / "price.col");
+        store.append("LTC-USD", later + 1000, 14.0, 1.0, 1);
+        ticks.clear();
+        store.read_range("LTC-USD", later, later + 10000, ticks);
+        check(ticks.size() == 1 && ticks.price[0] == 14.0 && ticks.time_us[0] == later + 1000, "columns aligned after failure");
+        std::cout << "[OK] Tick store ordering and failed writes" << std::endl;
+    }
+
+    // Test 2c: Reads wait on the writer thread while a feed thread keeps appending
+    {
+        core::history::TickStore store(root.string());
+        const int count = 5 * static_cast<int>(core::history::TickStore::FLUSH_THRESHOLD);
+        std::thread feed([&store, count]
+                         {
+                             for (int i = 0; i < count; ++i)
+                                 store.append("ADA-USD", BASE_US + i * 10LL, 1.0 + i, 1.0, 1); });
+
+        bool ordered = true;
+        for (int read = 0; read < 20; ++read)
+        {
+            core::history::TickColumns ticks;
+            store.read_range("ADA-USD", BASE_US, BASE_US + count * 10LL, ticks);
+            for (size_t i = 0; i < ticks.size(); ++i)
+                ordered = ordered && ticks.price[i] == 1.0 + static_cast<double>(i);
+        }
+        feed.join();
+
+        core::history::TickColumns ticks;
+        store.read_range("ADA-USD", BASE_US, BASE_US + count * 10LL, ticks);
+        check(ordered, "concurrent reads see a prefix of the stream");
+        check(ticks.size() == static_cast<size_t>(count), "every tick written");
+        std::cout << "[OK] Tick store background writer" << std::endl;
+    }
+
+    // Test 3: Bulk tick encoding matches the message class
+    {
+        core::history::TickColumns ticks;
+        ticks.push_back(BASE_US + 1500, 101.5, 0.25, 1);
+        ticks.push_back(BASE_US + 2500, 102.5, 0.75, 2);
+
+        std::vector<uint8_t> records;
+        HistoricalDataService::encode_ticks(42, ticks, records);
+        const size_t size = core::dtc::HistoricalPriceDataTickRecordResponse::RECORD_SIZE;
+        check(records.size() == 2 * size, "two tick records");
+
+        core::dtc::HistoricalPriceDataTickRecordResponse first;
+        first.deserialize(records.data(), static_cast<uint16_t>(size));
+        check(first.request_id == 42 && first.price == 101.5 && first.volume == 0.25 && first.at_bid_or_ask == 1, "first record fields");
+        check(first.date_time == static_cast<double>(BASE_US + 1500) / 1000000.0 && first.is_final_record == 0, "first record time");
+
+        core::dtc::HistoricalPriceDataTickRecordResponse last;
+        last.deserialize(records.data() + size, static_cast<uint16_t>(size));
+        check(last.price == 102.5 && last.is_final_record == 1, "last record is final");
+
+        core::dtc::Protocol protocol;
+        auto parsed = protocol.parse_message(records.data(), size);
+        check(parsed && parsed->get_type() == core::dtc::MessageType::HISTORICAL_PRICE_DATA_TICK_RECORD_RESPONSE, "tick record parses");
+        std::cout << "[OK] Tick record encoding" << std::endl;
+    }
+
+    // Test 4: Bars are aggregated from ticks
+    {
+        const int64_t minute = BASE_US - BASE_US % (60 * 1000000LL);
+        core::history::TickColumns ticks;
+        ticks.push_back(minute, 10.0, 1.0, 1);
+        ticks.push_back(minute + 20 * 1000000LL, 12.0, 2.0, 2);
+        ticks.push_back(minute + 40 * 1000000LL, 9.0, 1.0, 2);
+        ticks.push_back(minute + 61 * 1000000LL, 11.0, 3.0, 1);
+
+        std::vector<uint8_t> records;
+        HistoricalDataService::encode_bars(7, 60, ticks, records);
+
+        core::dtc::HistoricalPriceDataRecordResponse bar;
+        uint16_t bar_size = bar.get_size();
+        check(records.size() == 2u * bar_size, "two one-minute bars");
+        bar.deserialize(records.data(), bar_size);
+        check(bar.open_price == 10.0 && bar.high_price == 12.0 && bar.low_price == 9.0 && bar.last_price == 9.0, "bar OHLC");
+        check(bar.volume == 4.0 && bar.num_trades == 3 && bar.bid_volume == 1.0 && bar.ask_volume == 3.0, "bar volumes");
+        check(bar.start_date_time == minute && bar.is_final_record == 0, "bar start");
+
+        core::dtc::HistoricalPriceDataRecordResponse second;
+        second.deserialize(records.data() + bar_size, bar_size);
+        check(second.open_price == 11.0 && second.is_final_record == 1, "second bar is final");
+        std::cout << "[OK] Bar aggregation" << std::endl;
+    }
+
+    // Test 5: Full request, uncompressed and (when available) zlib-compressed
+    {
+        core::history::TickStore store(root.string());
+        HistoricalDataService service(store);
+
+        core::dtc::HistoricalPriceDataRequest request;
+        request.request_id = 3;
+        request.symbol = "BTC-USD";
+        request.start_date_time = BASE_US / 1000000LL;
+        request.end_date_time = BASE_US / 1000000LL + 9;
+
+        auto chunks = service.handle_request(request, 0);
+        core::dtc::HistoricalPriceDataResponseHeader header;
+        header.deserialize(chunks[0].data(), static_cast<uint16_t>(chunks[0].size()));
+        check(header.request_id == 3 && header.no_records_to_return == 0 && header.use_zlib_compression == 0, "uncompressed header");
+
+        std::vector<uint8_t> plain;
+        for (size_t i = 1; i < chunks.size(); ++i)
+            plain.insert(plain.end(), chunks[i].begin(), chunks[i].end());
+        check(plain.size() == 9001 * core::dtc::HistoricalPriceDataTickRecordResponse::RECORD_SIZE, "all ticks in first 9s");
+
+        request.symbol = "SOL-USD";
+        chunks = service.handle_request(request, 0);
+        header.deserialize(chunks[0].data(), static_cast<uint16_t>(chunks[0].size()));
+        check(chunks.size() == 1 && header.no_records_to_return == 1, "empty response");
+
+#ifdef HAS_ZLIB
+        request.symbol = "BTC-USD";
+        request.use_zlib_compression = 1;
+        chunks = service.handle_request(request, 0);
+        header.deserialize(chunks[0].data(), static_cast<uint16_t>(chunks[0].size()));
+        check(header.use_zlib_compression == 1, "compressed header");
+
+        std::vector<uint8_t> compressed;
+        for (size_t i = 1; i < chunks.size(); ++i)
+            compressed.insert(compressed.end(), chunks[i].begin(), chunks[i].end());
+        std::vector<uint8_t> inflated(plain.size());
+        uLongf inflated_size = static_cast<uLongf>(inflated.size());
+        int result = uncompress(inflated.data(), &inflated_size, compressed.data(), static_cast<uLong>(compressed.size()));
+        check(result == Z_OK && inflated_size == plain.size() && inflated == plain, "zlib round trip");
+        check(compressed.size() < plain.size(), "compression shrinks data");
+        std::cout << "[OK] Compressed response" << std::endl;
+#endif
+        std::cout << "[OK] Historical request" << std::endl;
+    }
+
+    std::filesystem::remove_all(root);
+
+    return test_support::finish("Historical data");
+}
@@ -0,0 +1,231 @@
+#include "coinbase_dtc_core/core/server/market_depth.hpp"
+#include "coinbase_dtc_core/core/dtc/protocol.hpp"
+#include "coinbase_dtc_core/exchanges/base/order_book.hpp"
+#include "test_support.hpp"
+#include <iostream>
+#include <memory>
+#include <string>
+
+using namespace open_dtc_server;
+using coinbase_dtc_core::core::server::MarketDepthDistributor;
+using test_support::check;
+
+namespace
+{
+    const exchanges::base::InstrumentId BTC = exchanges::base::SymbolRegistry::getInstance().intern("coinbase", "BTC-USD", "BTC/USD");
+
+    exchanges::base::MarketDepthUpdate make_update(bool is_bid, double price, double size)
+    {
+        exchanges::base::MarketDepthUpdate update;
+        update.instrument = BTC;
+        update.is_bid = is_bid;
+        update.price = price;
+        update.size = size;
+        update.exchange_time_us = 1700000000000000ULL;
+        return update;
+    }
+
+    core::dtc::MarketDepthIncrementalUpdate decode(const std::vector<uint8_t> &data)
+    {
+        core::dtc::MarketDepthIncrementalUpdate message;
+        message.deserialize(data.data(), static_cast<uint16_t>(data.size()));
+        return message;
+    }
+}
+
+int main()
+{
+    std::cout << "[TEST] Testing market depth distribution..." << std::endl;
+
+    // Test 1: Order book positions are counted from the best price
+    {
+        exchanges::base::OrderBook book;
+        auto delta = book.apply(exchanges::base::BookSide::BID, 100.0, 1.0);
+        check(delta.type == exchanges::base::BookDelta::Type::INSERT && delta.position == 0, "first bid inserts at 0");
+        delta = book.apply(exchanges::base::BookSide::BID, 101.0, 2.0);
+        check(delta.type == exchanges::base::BookDelta::Type::INSERT && delta.position == 0, "better bid inserts at 0");
+        delta = book.apply(exchanges::base::BookSide::BID, 100.0, 3.0);
+        check(delta.type == exchanges::base::BookDelta::Type::UPDATE && delta.position == 1, "old best bid updates at 1");
+        delta = book.apply(exchanges::base::BookSide::ASK, 102.0, 1.0);
+        delta = book.apply(exchanges::base::BookSide::ASK, 103.0, 1.0);
+        check(delta.type == exchanges::base::BookDelta::Type::INSERT && delta.position == 1, "worse ask inserts at 1");
+        delta = book.apply(exchanges::base::BookSide::ASK, 102.0, 0.0);
+        check(delta.type == exchanges::base::BookDelta::Type::DELETE && delta.position == 0, "best ask deletes at 0");
+        delta = book.apply(exchanges::base::BookSide::ASK, 150.0, 0.0);
+        check(delta.type == exchanges::base::BookDelta::Type::NONE, "unknown level delete is ignored");
+        check(book.level(exchanges::base::BookSide::ASK, 0)->price == 103.0, "best ask is 103");
+        check(book.best_bid()->price == 101.0 && book.best_ask()->price == 103.0, "top of book");
+        std::cout << "[OK] Order book positions" << std::endl;
+    }
+
+    // Test 1b: Snapshot load, depth query and delta replay into a mirror
+    {
+        exchanges::base::OrderBook book;
+        book.load(exchanges::base::BookSide::BID, {{99.0, 1.0}, {101.0, 2.0}, {100.0, 0.0}, {98.0, 3.0}});
+        auto bids = book.get_depth(exchanges::base::BookSide::BID, 2);
+        check(bids.size() == 2 && bids[0].price == 101.0 && bids[1].price == 99.0, "loaded bids sorted, zero dropped");
+
+        exchanges::base::OrderBook mirror = book;
+        bool in_sync = true;
+        for (auto change : {std::make_pair(100.0, 4.0), std::make_pair(101.0, 0.0), std::make_pair(98.0, 5.0), std::make_pair(102.0, 1.0)})
+        {
+            auto delta = book.apply(exchanges::base::BookSide::BID, change.first, change.second);
+            in_sync = in_sync && mirror.apply_delta(delta);
+        }
+        auto a = book.get_depth(exchanges::base::BookSide::BID, 10);
+        auto b = mirror.get_depth(exchanges::base::BookSide::BID, 10);
+        check(in_sync && a.size() == b.size(), "mirror accepts every delta");
+        for (size_t i = 0; i < a.size() && i < b.size(); ++i)
+            check(a[i].price == b[i].price && a[i].size == b[i].size, "mirror level matches");
+
+        exchanges::base::BookDelta stale;
+        stale.type = exchanges::base::BookDelta::Type::DELETE;
+        stale.position = 0;
+        stale.price = 55.0;
+        check(!mirror.apply_delta(stale), "out-of-sync delta rejected");
+
+        // Best bid is 102: inserting 101.5 as the new best, or 103 below it, would unsort the side
+        exchanges::base::BookDelta misplaced;
+        misplaced.type = exchanges::base::BookDelta::Type::INSERT;
+        misplaced.side = exchanges::base::BookSide::BID;
+        misplaced.position = 0;
+        misplaced.price = 101.5;
+        misplaced.size = 1.0;
+        check(!mirror.apply_delta(misplaced), "insert worse than its better neighbour rejected");
+        misplaced.position = 1;
+        misplaced.price = 103.0;
+        check(!mirror.apply_delta(misplaced), "insert better than its worse neighbour rejected");
+        misplaced.price = 102.0;
+        check(!mirror.apply_delta(misplaced), "insert onto an existing price rejected");
+        misplaced.price = 101.0;
+        check(mirror.apply_delta(misplaced) && mirror.level(exchanges::base::BookSide::BID, 1)->price == 101.0, "fitting insert applied");
+
+        exchanges::base::BookDelta wrong_level;
+        wrong_level.type = exchanges::base::BookDelta::Type::UPDATE;
+        wrong_level.side = exchanges::base::BookSide::BID;
+        wrong_level.position = 0;
+        wrong_level.price = 101.0;
+        check(!mirror.apply_delta(wrong_level), "update of another price rejected");
+        std::cout << "[OK] Order book load and delta replay" << std::endl;
+    }
+
+    // Test 2: Snapshot on subscribe
+    {
+        MarketDepthDistributor distributor(100);
+        distributor.apply(make_update(true, 100.0, 1.0));
+        distributor.apply(make_update(true, 99.0, 2.0));
+        distributor.apply(make_update(true, 98.0, 3.0));
+        distributor.apply(make_update(false, 101.0, 4.0));
+
+        auto snapshot = distributor.subscribe(BTC, 7, 5, 2);
+        check(snapshot.size() == 3, "snapshot holds 2 bids and 1 ask");
+
+        core::dtc::MarketDepthSnapshot first;
+        first.deserialize(snapshot.front().data(), static_cast<uint16_t>(snapshot.front().size()));
+        check(first.symbol_id == 5 && first.level == 0 && first.price == 100.0, "snapshot starts at best bid");
+        check(first.is_first_message_in_batch == 1 && first.is_last_message_in_batch == 0, "first batch flag");
+
+        core::dtc::MarketDepthSnapshot last;
+        last.deserialize(snapshot.back().data(), static_cast<uint16_t>(snapshot.back().size()));
+        check(last.side == static_cast<uint8_t>(core::dtc::DepthSideEnum::SIDE_ASK) && last.is_last_message_in_batch == 1, "last batch flag on ask");
+
+        core::dtc::Protocol protocol;
+        auto parsed = protocol.parse_message(snapshot.front().data(), snapshot.front().size());
+        check(parsed && parsed->get_type() == core::dtc::MessageType::MARKET_DEPTH_SNAPSHOT, "snapshot parses");
+        std::cout << "[OK] Depth snapshot" << std::endl;
+    }
+
+    // Test 3: One diff, shared by subscribers with their own symbol IDs and windows
+    {
+        MarketDepthDistributor distributor(100);
+        distributor.apply(make_update(true, 100.0, 1.0));
+        distributor.apply(make_update(true, 99.0, 1.0));
+        distributor.subscribe(BTC, 1, 11, 2);
+        distributor.subscribe(BTC, 2, 22, 10);
+
+        // New best bid: both see the insert, the 2-level client also loses its old level 1
+        auto out = distributor.apply(make_update(true, 101.0, 1.0));
+        check(out.size() == 3, "insert fans out to both clients plus one trim");
+        auto insert = decode(out[0].data);
+        check(out[0].client_id == 1 && insert.symbol_id == 11 && insert.position == 0, "client 1 insert");
+        check(insert.update_type == static_cast<uint8_t>(core::dtc::DepthUpdateTypeEnum::DEPTH_INSERT), "insert type");
+        auto trim = decode(out[1].data);
+        check(out[1].client_id == 1 && trim.position == 2 && trim.price == 99.0, "client 1 trims level 2");
+        check(trim.update_type == static_cast<uint8_t>(core::dtc::DepthUpdateTypeEnum::DEPTH_DELETE), "trim is a delete");
+        check(out[2].client_id == 2 && decode(out[2].data).symbol_id == 22, "client 2 insert");
+
+        // Change below client 1's window only reaches client 2
+        out = distributor.apply(make_update(true, 99.0, 5.0));
+        check(out.size() == 1 && out[0].client_id == 2 && decode(out[0].data).position == 2, "deep update filtered");
+
+        // Removing the best bid pulls the hidden level into client 1's window
+        out = distributor.apply(make_update(true, 101.0, 0.0));
+        check(out.size() == 3, "delete fans out plus one backfill");
+        auto backfill = decode(out[1].data);
+        check(out[1].client_id == 1 && backfill.position == 1 && backfill.price == 99.0 && backfill.size == 5.0, "client 1 backfill");
+
+        // The same spelling on another exchange is another book with its own subscribers
+        auto replay = make_update(true, 50.0, 1.0);
+        replay.instrument = exchanges::base::SymbolRegistry::getInstance().intern("replay", "BTC-USD", "BTC-USD");
+        check(distributor.apply(replay).empty(), "other exchange's book not sent to these clients");
+        check(distributor.subscribe(replay.instrument, 1, 33, 10).size() == 1, "other exchange's book holds only its own level");
+
+        distributor.remove_client(1);
+        check(distributor.get_subscriber_count(BTC) == 1 && distributor.get_subscriber_count(replay.instrument) == 0, "client removed");
+        std::cout << "[OK] Incremental depth distribution" << std::endl;
+    }
+
+    // Test 4: Feed deltas are replayed; an empty feed snapshot resets subscribers
+    {
+        MarketDepthDistributor distributor(100);
+        distributor.apply(make_update(false, 101.0, 1.0));
+        distributor.subscribe(BTC, 3, 9, 5);
+
+        exchanges::base::OrderBook feed_book;
+        feed_book.apply(exchanges::base::BookSide::ASK, 101.0, 1.0);
+        auto with_delta = make_update(false, 100.5, 2.0);
+        with_delta.delta = feed_book.apply(exchanges::base::BookSide::ASK, 100.5, 2.0);
+        auto out = distributor.apply(with_delta);
+        check(out.size() == 1 && decode(out[0].data).position == 0 && decode(out[0].data).price == 100.5, "feed delta forwarded");
+
+        auto reset = make_update(true, 0.0, 0.0);
+        reset.action = exchanges::base::MarketDepthUpdate::Action::SNAPSHOT;
+        out = distributor.apply(reset);
+        check(out.size() == 1, "reset produces one message");
+        core::dtc::MarketDepthSnapshot empty;
+        empty.deserialize(out[0].data.data(), static_cast<uint16_t>(out[0].data.size()));
+        check(empty.side == 0 && empty.is_first_message_in_batch == 1 && empty.is_last_message_in_batch == 1, "empty snapshot");
+        std::cout << "[OK] Depth reset" << std::endl;
+    }
+
+    // Test 5: Positions deeper than 16 bits stay exact and never reach clients
+    {
+        exchanges::base::OrderBook feed_book;
+        std::vector<exchanges::base::PriceLevel> levels;
+        for (int i = 0; i < 70000; ++i)
+            levels.emplace_back(1000.0 + i, 1.0);
+        feed_book.load(exchanges::base::BookSide::ASK, levels);
+
+        auto deep = make_update(false, 1000.0 + 66000, 2.0);
+        deep.delta = feed_book.apply(exchanges::base::BookSide::ASK, deep.price, deep.size);
+        check(deep.delta.type == exchanges::base::BookDelta::Type::UPDATE && deep.delta.position == 66000, "deep position not wrapped");
+
+        MarketDepthDistributor distributor(100);
+        auto snapshot = make_update(false, 0.0, 0.0);
+        snapshot.action = exchanges::base::MarketDepthUpdate::Action::SNAPSHOT;
+        exchanges::base::OrderBook before = feed_book;
+        before.apply(exchanges::base::BookSide::ASK, deep.price, 1.0);
+        snapshot.book = std::make_shared<exchanges::base::OrderBook>(before);
+        distributor.apply(snapshot);
+        distributor.subscribe(BTC, 4, 2, 100);
+
+        check(distributor.apply(deep).empty(), "change below every window not sent");
+        auto top = make_update(false, 999.5, 1.0);
+        top.delta = feed_book.apply(exchanges::base::BookSide::ASK, top.price, top.size);
+        auto out = distributor.apply(top);
+        check(!out.empty() && decode(out[0].data).position == 0, "top change still sent");
+        std::cout << "[OK] Deep book positions" << std::endl;
+    }
+
+    return test_support::finish("Market depth");
+}
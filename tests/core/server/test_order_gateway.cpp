@@ -0,0 +1,410 @@
+#include "coinbase_dtc_core/core/server/order_gateway.hpp"
+#include "coinbase_dtc_core/core/dtc/protocol.hpp"
+#include "test_support.hpp"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace open_dtc_server;
+using coinbase_dtc_core::core::server::OrderGateway;
+using test_support::check;
+
+namespace
+{
+    /** Replies from a script; holds each order until released when gated */
+    class FakeTransport : public exchanges::base::OrderTransport
+    {
+    public:
+        struct Shared
+        {
+            std::mutex mutex;
+            std::condition_variable cv;
+            std::vector<std::string> bodies;
+            std::vector<exchanges::base::OrderResponse> replies;
+            size_t released = 0;
+            bool gated = false;
+            bool connected = true; // What keep_warm reports
+            int warm_calls = 0;
+        };
+
+        explicit FakeTransport(Shared &shared) : shared_(shared) {}
+
+        exchanges::base::OrderResponse submit_order(const std::string &body) override
+        {
+            std::unique_lock<std::mutex> lock(shared_.mutex);
+            size_t index = shared_.bodies.size();
+            shared_.bodies.push_back(body);
+            shared_.cv.notify_all();
+            shared_.cv.wait(lock, [&]
+                            { return !shared_.gated || shared_.released > index; });
+            return index < shared_.replies.size() ? shared_.replies[index] : exchanges::base::OrderResponse();
+        }
+
+        bool keep_warm() override
+        {
+            std::lock_guard<std::mutex> lock(shared_.mutex);
+            shared_.warm_calls++;
+            return shared_.connected;
+        }
+
+    private:
+        Shared &shared_;
+    };
+
+    core::dtc::SubmitNewSingleOrder make_order(core::dtc::OrderTypeEnum type, core::dtc::BuySellEnum side, double price1, double quantity)
+    {
+        core::dtc::SubmitNewSingleOrder order;
+        order.symbol = "BTC-USD";
+        order.exchange = "coinbase";
+        order.trade_account = "default";
+        order.client_order_id = "client-1";
+        order.order_type = type;
+        order.buy_sell = side;
+        order.price1 = price1;
+        order.quantity = quantity;
+        order.time_in_force = core::dtc::TimeInForceEnum::TIF_GOOD_TILL_CANCELED;
+        return order;
+    }
+
+    core::dtc::OrderUpdate decode(const std::vector<uint8_t> &data)
+    {
+        core::dtc::OrderUpdate update;
+        update.deserialize(data.data(), static_cast<uint16_t>(data.size()));
+        return update;
+    }
+
+    exchanges::base::OrderResponse reply(int status, const std::string &body)
+    {
+        exchanges::base::OrderResponse response;
+        response.status_code = status;
+        response.body = body;
+        return response;
+    }
+}
+
+int main()
+{
+    std::cout << "[TEST] Testing order gateway..." << std::endl;
+
+    // Test 1: Order messages round trip through the protocol
+    {
+        auto order = make_order(core::dtc::OrderTypeEnum::ORDER_TYPE_STOP_LIMIT, core::dtc::BuySellEnum::SELL, 64000.0, 0.25);
+        order.price2 = 63900.0;
+        order.free_form_text = "hedge";
+        auto data = order.serialize();
+        check(data.size() == order.get_size(), "order size matches get_size");
+
+        core::dtc::Protocol protocol;
+        auto parsed = protocol.parse_message(data.data(), data.size());
+        check(parsed && parsed->get_type() == core::dtc::MessageType::SUBMIT_NEW_SINGLE_ORDER, "order parses");
+        if (parsed && parsed->get_type() == core::dtc::MessageType::SUBMIT_NEW_SINGLE_ORDER)
+        {
+            auto *decoded = static_cast<core::dtc::SubmitNewSingleOrder *>(parsed.get());
+            check(decoded->symbol == "BTC-USD" && decoded->client_order_id == "client-1" && decoded->trade_account == "default" &&
+                      decoded->order_type == core::dtc::OrderTypeEnum::ORDER_TYPE_STOP_LIMIT && decoded->buy_sell == core::dtc::BuySellEnum::SELL &&
+                      decoded->price1 == 64000.0 && decoded->price2 == 63900.0 && decoded->quantity == 0.25 && decoded->free_form_text == "hedge",
+                  "order fields");
+        }
+
+        core::dtc::OrderUpdate update;
+        update.server_order_id = "dtc-1";
+        update.exchange_order_id = "abc";
+        update.order_status = core::dtc::OrderStatusEnum::ORDER_STATUS_OPEN;
+        update.order_quantity = 0.25;
+        update.info_text = "ok";
+        update.oco_linked_order_server_order_id = "last";
+        auto update_data = update.serialize();
+        check(update_data.size() == update.get_size(), "update size matches get_size");
+        auto round = decode(update_data);
+        check(round.server_order_id == "dtc-1" && round.exchange_order_id == "abc" && round.order_status == core::dtc::OrderStatusEnum::ORDER_STATUS_OPEN &&
+                  round.order_quantity == 0.25 && round.info_text == "ok" && round.oco_linked_order_server_order_id == "last",
+              "update fields");
+        check(!round.deserialize(update_data.data(), 20), "truncated update rejected");
+        std::cout << "[OK] Order message codecs" << std::endl;
+    }
+
+    // Test 2: DTC orders map to Advanced Trade order configurations
+    {
+        std::string body, error;
+        auto limit = make_order(core::dtc::OrderTypeEnum::ORDER_TYPE_LIMIT, core::dtc::BuySellEnum::BUY, 65000.5, 0.01);
+        check(OrderGateway::build_order_request(limit, "dtc-7", body, error), "limit order builds");
+        auto json = nlohmann::json::parse(body);
+        check(json["client_order_id"] == "dtc-7" && json["product_id"] == "BTC-USD" && json["side"] == "BUY", "order envelope");
+        check(json["order_configuration"]["limit_limit_gtc"]["base_size"] == "0.01" &&
+                  json["order_configuration"]["limit_limit_gtc"]["limit_price"] == "65000.5",
+              "GTC limit as decimal strings");
+
+        limit.time_in_force = core::dtc::TimeInForceEnum::TIF_IMMEDIATE_OR_CANCEL;
+        OrderGateway::build_order_request(limit, "dtc-8", body, error);
+        check(nlohmann::json::parse(body)["order_configuration"].contains("sor_limit_ioc"), "IOC limit");
+
+        limit.time_in_force = core::dtc::TimeInForceEnum::TIF_GOOD_TILL_DATE_TIME;
+        limit.good_till_date_time = 4102444800; // 2100-01-01
+        OrderGateway::build_order_request(limit, "dtc-9", body, error);
+        check(nlohmann::json::parse(body)["order_configuration"]["limit_limit_gtd"]["end_time"] == "2100-01-01T00:00:00Z", "GTD limit end time");
+
+        auto market = make_order(core::dtc::OrderTypeEnum::ORDER_TYPE_MARKET, core::dtc::BuySellEnum::SELL, 0.0, 2.0);
+        check(OrderGateway::build_order_request(market, "dtc-10", body, error), "market order builds");
+        json = nlohmann::json::parse(body);
+        check(json["side"] == "SELL" && json["order_configuration"]["market_market_ioc"]["base_size"] == "2", "market IOC");
+
+        auto stop_limit = make_order(core::dtc::OrderTypeEnum::ORDER_TYPE_STOP_LIMIT, core::dtc::BuySellEnum::BUY, 66000.0, 1.0);
+        stop_limit.price2 = 66100.0;
+        OrderGateway::build_order_request(stop_limit, "dtc-11", body, error);
+        json = nlohmann::json::parse(body);
+        const auto &stop = json["order_configuration"]["stop_limit_stop_limit_gtc"];
+        check(stop["stop_price"] == "66000" && stop["limit_price"] == "66100" && stop["stop_direction"] == "STOP_DIRECTION_STOP_UP",
+              "buy stop-limit triggers upward");
+
+        auto unsupported = make_order(core::dtc::OrderTypeEnum::ORDER_TYPE_STOP, core::dtc::BuySellEnum::BUY, 66000.0, 1.0);
+        check(!OrderGateway::build_order_request(unsupported, "x", body, error) && !error.empty(), "plain stop unsupported");
+        auto no_price = make_order(core::dtc::OrderTypeEnum::ORDER_TYPE_LIMIT, core::dtc::BuySellEnum::BUY, 0.0, 1.0);
+        check(!OrderGateway::build_order_request(no_price, "x", body, error), "limit without price rejected");
+        auto no_quantity = make_order(core::dtc::OrderTypeEnum::ORDER_TYPE_MARKET, core::dtc::BuySellEnum::BUY, 0.0, 0.0);
+        check(!OrderGateway::build_order_request(no_quantity, "x", body, error), "zero quantity rejected");
+        auto expired = limit;
+        expired.good_till_date_time = 1000;
+        check(!OrderGateway::build_order_request(expired, "x", body, error), "past GTD rejected");
+        std::cout << "[OK] Order mapping" << std::endl;
+    }
+
+    // Test 3: Exchange replies
+    {
+        std::string order_id, error;
+        check(OrderGateway::parse_order_response(reply(200, R"({"success":true,"success_response":{"order_id":"11-22"}})"), order_id, error) &&
+                  order_id == "11-22",
+              "accepted reply");
+        check(!OrderGateway::parse_order_response(reply(200, R"({"success":false,"error_response":{"error":"INSUFFICIENT_FUND","message":"Insufficient balance"}})"),
+                                                  order_id, error) &&
+                  error == "Insufficient balance",
+              "refused reply");
+        check(!OrderGateway::parse_order_response(reply(401, R"({"error":"unauthorized"})"), order_id, error) && error == "unauthorized", "HTTP error");
+        exchanges::base::OrderResponse failed;
+        failed.status_code = -1;
+        failed.error_message = "CURL error: Timeout";
+        check(!OrderGateway::parse_order_response(failed, order_id, error) && error == "CURL error: Timeout", "transport failure");
+        std::cout << "[OK] Order replies" << std::endl;
+    }
+
+    // Test 4: submit never waits for the exchange; updates stream back from the worker
+    {
+        FakeTransport::Shared shared;
+        shared.gated = true;
+        shared.replies.push_back(reply(200, R"({"success":true,"success_response":{"order_id":"ex-1"}})"));
+        shared.replies.push_back(reply(200, R"({"success":false,"error_response":{"message":"Invalid product"}})"));
+
+        std::mutex sent_mutex;
+        std::condition_variable sent_cv;
+        std::vector<std::pair<int, core::dtc::OrderUpdate>> sent;
+        {
+            OrderGateway gateway(std::make_unique<FakeTransport>(shared), [&](int client_id, const std::vector<uint8_t> &message)
+                                 {
+                                     std::lock_guard<std::mutex> lock(sent_mutex);
+                                     sent.emplace_back(client_id, decode(message));
+                                     sent_cv.notify_all(); });
+
+            auto order = make_order(core::dtc::OrderTypeEnum::ORDER_TYPE_LIMIT, core::dtc::BuySellEnum::BUY, 65000.0, 0.5);
+            auto immediate = decode(gateway.submit(3, order));
+            check(immediate.order_status == core::dtc::OrderStatusEnum::ORDER_STATUS_PENDING_OPEN, "pending while the exchange holds the order");
+            check(immediate.client_order_id == "client-1" && !immediate.server_order_id.empty() && immediate.order_quantity == 0.5, "pending update fields");
+
+            auto second = decode(gateway.submit(4, make_order(core::dtc::OrderTypeEnum::ORDER_TYPE_MARKET, core::dtc::BuySellEnum::SELL, 0.0, 1.0)));
+            check(second.order_status == core::dtc::OrderStatusEnum::ORDER_STATUS_PENDING_OPEN, "second order queued");
+
+            auto invalid = decode(gateway.submit(3, make_order(core::dtc::OrderTypeEnum::ORDER_TYPE_LIMIT, core::dtc::BuySellEnum::BUY, 0.0, 1.0)));
+            check(invalid.order_status == core::dtc::OrderStatusEnum::ORDER_STATUS_REJECTED && !invalid.info_text.empty(), "invalid order rejected at once");
+
+            {
+                std::lock_guard<std::mutex> lock(shared.mutex);
+                shared.released = 2;
+            }
+            shared.cv.notify_all();
+
+            std::unique_lock<std::mutex> lock(sent_mutex);
+            sent_cv.wait_for(lock, std::chrono::seconds(5), [&]
+                             { return sent.size() >= 2; });
+            check(sent.size() == 2, "two exchange replies streamed back");
+            if (sent.size() == 2)
+            {
+                check(sent[0].first == 3 && sent[0].second.order_status == core::dtc::OrderStatusEnum::ORDER_STATUS_OPEN &&
+                          sent[0].second.exchange_order_id == "ex-1" && sent[0].second.server_order_id == immediate.server_order_id,
+                      "accepted order opens");
+                check(sent[1].first == 4 && sent[1].second.order_status == core::dtc::OrderStatusEnum::ORDER_STATUS_REJECTED &&
+                          sent[1].second.info_text == "Invalid product",
+                      "refused order rejected with reason");
+                check(sent[1].second.order_update_sequence_number > sent[0].second.order_update_sequence_number, "sequence numbers increase");
+            }
+            lock.unlock();
+
+            auto stats = gateway.get_stats();
+            check(stats.submitted == 2 && stats.acknowledged == 1 && stats.rejected == 2 && stats.failed == 0 && stats.pending == 0, "order counters");
+            check(stats.latency_samples == 2 && stats.latency_max_us >= stats.latency_p50_us && stats.latency_mean_us > 0, "ack latency recorded");
+        }
+        check(shared.warm_calls >= 1, "transport warmed before first order");
+        std::cout << "[OK] Asynchronous submission" << std::endl;
+    }
+
+    // Test 5: A full queue rejects instead of blocking the client
+    {
+        FakeTransport::Shared shared;
+        shared.gated = true;
+        shared.replies.assign(2, reply(200, R"({"success":true,"order_id":"ex"})"));
+
+        OrderGateway gateway(std::make_unique<FakeTransport>(shared), nullptr, 1);
+        auto order = make_order(core::dtc::OrderTypeEnum::ORDER_TYPE_MARKET, core::dtc::BuySellEnum::BUY, 0.0, 1.0);
+        gateway.submit(1, order);
+        {
+            // Wait until the worker holds the first order, leaving the queue empty
+            std::unique_lock<std::mutex> lock(shared.mutex);
+            shared.cv.wait_for(lock, std::chrono::seconds(5), [&]
+                               { return shared.bodies.size() == 1; });
+        }
+        check(decode(gateway.submit(1, order)).order_status == core::dtc::OrderStatusEnum::ORDER_STATUS_PENDING_OPEN, "one order fits the queue");
+        auto overflow = decode(gateway.submit(1, order));
+        check(overflow.order_status == core::dtc::OrderStatusEnum::ORDER_STATUS_REJECTED && overflow.info_text == "Too many pending orders",
+              "overflow rejected");
+
+        {
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            shared.released = 2;
+        }
+        shared.cv.notify_all();
+        std::cout << "[OK] Queue limit" << std::endl;
+    }
+
+    // Test 6: Servers without a gateway reject with a reason
+    {
+        auto reject = decode(OrderGateway::encode_reject(make_order(core::dtc::OrderTypeEnum::ORDER_TYPE_MARKET, core::dtc::BuySellEnum::BUY, 0.0, 1.0),
+                                                         "Order entry is not enabled on this server"));
+        check(reject.order_status == core::dtc::OrderStatusEnum::ORDER_STATUS_REJECTED && reject.client_order_id == "client-1" &&
+                  reject.info_text == "Order entry is not enabled on this server",
+              "standalone reject");
+        std::cout << "[OK] Standalone reject" << std::endl;
+    }
+
+    // Test 7: A request with no reply stays pending and is reconciled under the same client_order_id
+    {
+        FakeTransport::Shared shared;
+        exchanges::base::OrderResponse timeout;
+        timeout.status_code = -1;
+        timeout.error_message = "CURL error: Timeout was reached";
+        shared.replies = {timeout, reply(200, R"({"success":true,"success_response":{"order_id":"ex-9"}})"), timeout, timeout, timeout};
+
+        std::mutex sent_mutex;
+        std::condition_variable sent_cv;
+        std::vector<core::dtc::OrderUpdate> sent, observed;
+        {
+            OrderGateway gateway(std::make_unique<FakeTransport>(shared), [&](int, const std::vector<uint8_t> &message)
+                                 {
+                                     std::lock_guard<std::mutex> lock(sent_mutex);
+                                     sent.push_back(decode(message));
+                                     sent_cv.notify_all(); });
+            gateway.set_update_observer([&](const core::dtc::OrderUpdate &update)
+                                        {
+                                            std::lock_guard<std::mutex> lock(sent_mutex);
+                                            observed.push_back(update); });
+
+            auto order = make_order(core::dtc::OrderTypeEnum::ORDER_TYPE_LIMIT, core::dtc::BuySellEnum::BUY, 65000.0, 0.5);
+            auto first = decode(gateway.submit(1, order));
+            {
+                std::unique_lock<std::mutex> lock(sent_mutex);
+                sent_cv.wait_for(lock, std::chrono::seconds(5), [&]
+                                 { return sent.size() >= 2; });
+            }
+            auto second = decode(gateway.submit(1, order));
+            {
+                std::unique_lock<std::mutex> lock(sent_mutex);
+                sent_cv.wait_for(lock, std::chrono::seconds(5), [&]
+                                 { return sent.size() >= 4; });
+            }
+
+            std::lock_guard<std::mutex> lock(sent_mutex);
+            check(sent.size() == 4, "one notice and one outcome per order");
+            if (sent.size() == 4)
+            {
+                check(sent[0].order_status == core::dtc::OrderStatusEnum::ORDER_STATUS_PENDING_OPEN &&
+                          sent[0].info_text.find("checking order state") != std::string::npos && sent[0].remaining_quantity == 0.5,
+                      "missed reply leaves the order pending");
+                check(sent[1].order_status == core::dtc::OrderStatusEnum::ORDER_STATUS_OPEN && sent[1].exchange_order_id == "ex-9" &&
+                          sent[1].server_order_id == first.server_order_id,
+                      "resend finds the order");
+                check(sent[3].order_status == core::dtc::OrderStatusEnum::ORDER_STATUS_PENDING_OPEN &&
+                          sent[3].server_order_id == second.server_order_id && sent[3].remaining_quantity == 0.5 &&
+                          sent[3].info_text.find("unknown") != std::string::npos,
+                      "order never answered is reported unknown, not rejected");
+            }
+            check(shared.bodies.size() == 5 && shared.bodies[1] == shared.bodies[0] && shared.bodies[4] == shared.bodies[2] &&
+                      shared.bodies[2] != shared.bodies[0],
+                  "resends reuse the client_order_id");
+
+            // PENDING_OPEN is observed and numbered before anything the worker reports for the same order
+            check(!observed.empty() && observed[0].order_status == core::dtc::OrderStatusEnum::ORDER_STATUS_PENDING_OPEN &&
+                      observed[0].info_text.empty(),
+                  "pending observed first");
+            bool increasing = true;
+            for (size_t i = 1; i < observed.size(); ++i)
+                increasing = increasing && observed[i].order_update_sequence_number > observed[i - 1].order_update_sequence_number;
+            check(increasing, "observed sequence numbers increase");
+
+            auto stats = gateway.get_stats();
+            check(stats.acknowledged == 1 && stats.failed == 4 && stats.unresolved == 1 && stats.rejected == 0, "reconcile counters");
+        }
+        std::cout << "[OK] Reconcile after missed replies" << std::endl;
+    }
+
+    // Test 8: An unanswered order is resent only after the transport reports it reconnected
+    {
+        FakeTransport::Shared shared;
+        exchanges::base::OrderResponse refused;
+        refused.status_code = -1;
+        refused.error_message = "CURL error: Couldn't connect to server";
+        shared.replies = {refused, reply(200, R"({"success":true,"success_response":{"order_id":"ex-10"}})")};
+
+        std::mutex sent_mutex;
+        std::condition_variable sent_cv;
+        std::vector<core::dtc::OrderUpdate> sent;
+        {
+            OrderGateway gateway(std::make_unique<FakeTransport>(shared), [&](int, const std::vector<uint8_t> &message)
+                                 {
+                                     std::lock_guard<std::mutex> lock(sent_mutex);
+                                     sent.push_back(decode(message));
+                                     sent_cv.notify_all(); },
+                                 16, std::chrono::milliseconds(20));
+
+            {
+                std::lock_guard<std::mutex> lock(shared.mutex);
+                shared.connected = false;
+            }
+            gateway.submit(1, make_order(core::dtc::OrderTypeEnum::ORDER_TYPE_MARKET, core::dtc::BuySellEnum::SELL, 0.0, 0.1));
+            {
+                std::unique_lock<std::mutex> lock(sent_mutex);
+                sent_cv.wait_for(lock, std::chrono::seconds(5), [&]
+                                 { return !sent.empty(); });
+            }
+
+            // Several probe intervals pass while the transport is down
+            std::this_thread::sleep_for(std::chrono::milliseconds(150));
+            {
+                std::lock_guard<std::mutex> lock(shared.mutex);
+                check(shared.bodies.size() == 1 && shared.warm_calls > 2, "no resend while disconnected");
+                shared.connected = true;
+            }
+            check(gateway.get_stats().pending == 1, "waiting order counted as pending");
+
+            std::unique_lock<std::mutex> lock(sent_mutex);
+            sent_cv.wait_for(lock, std::chrono::seconds(5), [&]
+                             { return sent.size() >= 2; });
+            check(sent.size() == 2 && sent[1].order_status == core::dtc::OrderStatusEnum::ORDER_STATUS_OPEN &&
+                      sent[1].exchange_order_id == "ex-10",
+                  "resent after reconnect");
+        }
+        std::cout << "[OK] Resend waits for reconnect" << std::endl;
+    }
+
+    return test_support::finish("Order gateway");
+}
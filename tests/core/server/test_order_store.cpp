@@ -0,0 +1,255 @@
+#include "coinbase_dtc_core/core/server/order_store.hpp"
+#include "coinbase_dtc_core/exchanges/coinbase/order_fields.hpp"
+#include "coinbase_dtc_core/exchanges/coinbase/user_feed.hpp"
+#include "coinbase_dtc_core/core/dtc/protocol.hpp"
+#include "test_support.hpp"
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace open_dtc_server;
+using coinbase_dtc_core::core::server::OrderStore;
+using exchanges::coinbase::CoinbaseUserFeed;
+using test_support::check;
+
+namespace
+{
+    bool near(double a, double b)
+    {
+        return std::fabs(a - b) < 1e-9;
+    }
+
+    exchanges::base::OrderEvent make_event(const std::string &order_id, const std::string &client_order_id,
+                                           exchanges::base::OrderState state, double quantity, double filled, double average)
+    {
+        exchanges::base::OrderEvent event;
+        event.order_id = order_id;
+        event.client_order_id = client_order_id;
+        event.symbol = "BTC-USD";
+        event.kind = exchanges::base::OrderKind::LIMIT;
+        event.state = state;
+        event.limit_price = 50000.0;
+        event.quantity = quantity;
+        event.filled_quantity = filled;
+        event.average_fill_price = average;
+        return event;
+    }
+
+    core::dtc::OrderUpdate make_gateway_update(const std::string &server_order_id, const std::string &client_order_id,
+                                               core::dtc::OrderStatusEnum status)
+    {
+        core::dtc::OrderUpdate update;
+        update.symbol = "BTC-USD";
+        update.exchange = "coinbase";
+        update.server_order_id = server_order_id;
+        update.client_order_id = client_order_id;
+        update.order_status = status;
+        update.order_type = core::dtc::OrderTypeEnum::ORDER_TYPE_LIMIT;
+        update.buy_sell = core::dtc::BuySellEnum::BUY;
+        update.price1 = 50000.0;
+        update.order_quantity = 2.0;
+        update.remaining_quantity = 2.0;
+        update.trade_account = "main";
+        return update;
+    }
+}
+
+int main()
+{
+    std::cout << "=== Order Store Tests ===" << std::endl;
+
+    // Test 1: User channel messages
+    {
+        const std::string message = R"({"channel":"user","client_id":"","timestamp":"2024-03-01T12:00:00.5Z","sequence_num":3,"events":[
+            {"type":"snapshot","orders":[{"order_id":"ex-1","client_order_id":"dtc-1","cumulative_quantity":"0.25","leaves_quantity":"0.75",
+              "avg_price":"50010.5","total_fees":"0","status":"OPEN","product_id":"BTC-USD","creation_time":"2024-03-01T11:59:58.123456Z",
+              "order_side":"SELL","order_type":"Stop Limit","limit_price":"49000","stop_price":"49500"}]},
+            {"type":"update","orders":[{"order_id":"ex-2","client_order_id":"web-2","cumulative_quantity":"1","leaves_quantity":"0",
+              "avg_price":"3000","status":"FILLED","product_id":"ETH-USD","creation_time":"2024-03-01T11:00:00Z","order_side":"BUY","order_type":"Market"}]}]})";
+
+        std::vector<exchanges::base::OrderEvent> orders;
+        check(CoinbaseUserFeed::parse_user_message(message, orders), "user message parsed");
+        check(orders.size() == 2, "both events' orders extracted");
+        if (orders.size() == 2)
+        {
+            const auto &first = orders[0];
+            check(first.order_id == "ex-1" && first.client_order_id == "dtc-1" && first.symbol == "BTC-USD", "order identity");
+            check(!first.is_buy && first.kind == exchanges::base::OrderKind::STOP_LIMIT &&
+                      first.state == exchanges::base::OrderState::OPEN,
+                  "side, type and status");
+            check(near(first.quantity, 1.0) && near(first.filled_quantity, 0.25) && near(first.average_fill_price, 50010.5),
+                  "quantities from cumulative and leaves");
+            check(near(first.limit_price, 49000.0) && near(first.stop_price, 49500.0), "prices");
+            check(first.created_time_ms == 1709294398123ULL, "creation time in ms");
+            check(orders[1].kind == exchanges::base::OrderKind::MARKET && orders[1].state == exchanges::base::OrderState::FILLED,
+                  "second order");
+        }
+
+        check(!CoinbaseUserFeed::parse_user_message(R"({"channel":"heartbeats","events":[]})", orders) && orders.empty(),
+              "other channels ignored");
+        check(!CoinbaseUserFeed::parse_user_message("not json", orders), "malformed message ignored");
+        check(exchanges::coinbase::order_fields::parse_order_state("CANCELLED") == exchanges::base::OrderState::CANCELED &&
+                  exchanges::coinbase::order_fields::parse_order_state("CANCEL_QUEUED") == exchanges::base::OrderState::OPEN &&
+                  exchanges::coinbase::order_fields::parse_order_kind("STOP_LIMIT") == exchanges::base::OrderKind::STOP_LIMIT,
+              "REST spellings");
+        check(exchanges::coinbase::order_fields::parse_time_ms("1970-01-02T00:00:01Z") == 86401000ULL && exchanges::coinbase::order_fields::parse_time_ms("bogus") == 0,
+              "time parsing");
+        std::cout << "[OK] User channel parsing" << std::endl;
+    }
+
+    // Test 2: Gateway orders are matched by the exchange stream and fills are derived
+    {
+        OrderStore store;
+        store.record(make_gateway_update("dtc-1", "my-order", core::dtc::OrderStatusEnum::ORDER_STATUS_PENDING_OPEN));
+
+        core::dtc::OrderUpdate found;
+        check(store.find_by_server_order_id("dtc-1", found) && found.client_order_id == "my-order", "lookup by server order ID");
+        check(store.find_by_client_order_id("my-order", found) && found.server_order_id == "dtc-1", "lookup by client order ID");
+        check(store.open_count() == 1, "pending order is open");
+
+        core::dtc::OrderUpdate update;
+        check(store.apply(make_event("ex-1", "dtc-1", exchanges::base::OrderState::OPEN, 2.0, 0.0, 0.0), update), "open accepted");
+        check(update.server_order_id == "dtc-1" && update.exchange_order_id == "ex-1" &&
+                  update.order_status == core::dtc::OrderStatusEnum::ORDER_STATUS_OPEN && update.trade_account == "main",
+              "stream update keeps gateway identity");
+        check(!store.apply(make_event("ex-1", "dtc-1", exchanges::base::OrderState::OPEN, 2.0, 0.0, 0.0), update), "repeat ignored");
+
+        check(store.apply(make_event("ex-1", "dtc-1", exchanges::base::OrderState::OPEN, 2.0, 0.5, 100.0), update), "first fill");
+        check(update.order_status == core::dtc::OrderStatusEnum::ORDER_STATUS_PARTIALLY_FILLED && near(update.last_fill_quantity, 0.5) &&
+                  near(update.last_fill_price, 100.0) && near(update.remaining_quantity, 1.5),
+              "partial fill");
+
+        // Average 110 over 2.0 after 0.5 @ 100: the remaining 1.5 filled at 113.33...
+        check(store.apply(make_event("ex-1", "dtc-1", exchanges::base::OrderState::FILLED, 2.0, 2.0, 110.0), update), "final fill");
+        check(update.order_status == core::dtc::OrderStatusEnum::ORDER_STATUS_FILLED && near(update.last_fill_quantity, 1.5) &&
+                  near(update.last_fill_price, (220.0 - 50.0) / 1.5) && near(update.remaining_quantity, 0.0),
+              "fill derived from average price");
+        check(store.open_count() == 0 && store.get_open_orders().empty(), "filled order closed");
+
+        check(!store.apply(make_event("ex-1", "dtc-1", exchanges::base::OrderState::OPEN, 2.0, 2.0, 110.0), update), "closed order not reopened");
+        std::cout << "[OK] Gateway and stream state" << std::endl;
+    }
+
+    // Test 3: The stream can beat the gateway's own reply
+    {
+        OrderStore store;
+        core::dtc::OrderUpdate update;
+        store.apply(make_event("ex-9", "dtc-9", exchanges::base::OrderState::OPEN, 2.0, 0.0, 0.0), update);
+        store.record(make_gateway_update("dtc-9", "late", core::dtc::OrderStatusEnum::ORDER_STATUS_PENDING_OPEN));
+
+        core::dtc::OrderUpdate found;
+        check(store.find_by_client_order_id("late", found) && found.order_status == core::dtc::OrderStatusEnum::ORDER_STATUS_OPEN &&
+                  found.exchange_order_id == "ex-9",
+              "late gateway update merged without regressing status");
+        check(store.size() == 1, "single entry for the order");
+        std::cout << "[OK] Out-of-order sources" << std::endl;
+    }
+
+    // Test 3b: Only closes the exchange reported are final
+    {
+        OrderStore store;
+        core::dtc::OrderUpdate update;
+        store.record(make_gateway_update("dtc-5", "quiet", core::dtc::OrderStatusEnum::ORDER_STATUS_PENDING_OPEN));
+        store.record(make_gateway_update("dtc-5", "quiet", core::dtc::OrderStatusEnum::ORDER_STATUS_REJECTED));
+        check(store.open_count() == 0, "gateway rejection closes the order");
+
+        check(store.apply(make_event("ex-5", "dtc-5", exchanges::base::OrderState::OPEN, 2.0, 0.0, 0.0), update) &&
+                  update.order_status == core::dtc::OrderStatusEnum::ORDER_STATUS_OPEN && update.exchange_order_id == "ex-5",
+              "exchange reopens a locally rejected order");
+        check(store.open_count() == 1 && store.get_open_orders().front().server_order_id == "dtc-5", "order back among open orders");
+
+        check(store.apply(make_event("ex-5", "dtc-5", exchanges::base::OrderState::FILLED, 2.0, 2.0, 100.0), update) &&
+                  update.order_status == core::dtc::OrderStatusEnum::ORDER_STATUS_FILLED,
+              "exchange fills it");
+        check(!store.apply(make_event("ex-5", "dtc-5", exchanges::base::OrderState::OPEN, 2.0, 2.0, 100.0), update) &&
+                  store.find_by_server_order_id("dtc-5", update) && update.order_status == core::dtc::OrderStatusEnum::ORDER_STATUS_FILLED,
+              "exchange close stays final");
+
+        store.record(make_gateway_update("dtc-6", "refused", core::dtc::OrderStatusEnum::ORDER_STATUS_REJECTED));
+        check(store.apply(make_event("ex-6", "dtc-6", exchanges::base::OrderState::FILLED, 2.0, 2.0, 100.0), update) &&
+                  update.order_status == core::dtc::OrderStatusEnum::ORDER_STATUS_FILLED && store.open_count() == 0,
+              "exchange fill replaces a local rejection");
+        std::cout << "[OK] Exchange state over local rejections" << std::endl;
+    }
+
+    // Test 4: Bootstrap and open orders
+    {
+        OrderStore store;
+        core::dtc::OrderUpdate update;
+        store.apply(make_event("ex-1", "a", exchanges::base::OrderState::OPEN, 1.0, 0.5, 10.0), update);
+
+        std::vector<exchanges::base::OrderEvent> history = {
+            make_event("ex-1", "a", exchanges::base::OrderState::OPEN, 1.0, 0.0, 0.0),
+            make_event("ex-2", "", exchanges::base::OrderState::OPEN, 3.0, 0.0, 0.0)};
+        exchanges::base::FillEvent fill;
+        fill.order_id = "ex-1";
+        fill.price = 10.0;
+        fill.quantity = 0.5;
+        fill.time_ms = 5000;
+
+        check(store.bootstrap(history, {fill}) == 1, "only unknown orders added");
+        check(store.find_by_server_order_id("a", update) && near(update.filled_quantity, 0.5), "stream state kept over history");
+        check(store.find_by_server_order_id("ex-2", update) && update.client_order_id.empty(), "order without client ID keyed by exchange ID");
+
+        auto open = store.get_open_orders();
+        check(open.size() == 2, "two open orders");
+
+        auto messages = OrderStore::encode_open_orders(open, 77);
+        check(messages.size() == 2, "one message per open order");
+        core::dtc::OrderUpdate decoded;
+        check(!messages.empty() && decoded.deserialize(messages.back().data(), static_cast<uint16_t>(messages.back().size())) &&
+                  decoded.request_id == 77 && decoded.total_num_messages == 2 && decoded.message_number == 2,
+              "open orders numbered for the request");
+
+        auto none = OrderStore::encode_open_orders({}, 78);
+        check(none.size() == 1 && decoded.deserialize(none[0].data(), static_cast<uint16_t>(none[0].size())) &&
+                  decoded.no_orders == 1 && decoded.request_id == 78,
+              "no_orders reply");
+        std::cout << "[OK] Bootstrap and open orders" << std::endl;
+    }
+
+    // Test 5: Closed orders are pruned oldest first, with their indexes
+    {
+        OrderStore store(2);
+        core::dtc::OrderUpdate update;
+        for (int i = 0; i < 4; ++i)
+        {
+            std::string id = std::to_string(i);
+            store.apply(make_event("ex-" + id, "c-" + id, exchanges::base::OrderState::CANCELED, 1.0, 0.0, 0.0), update);
+        }
+        store.apply(make_event("ex-open", "c-open", exchanges::base::OrderState::OPEN, 1.0, 0.0, 0.0), update);
+
+        check(store.size() == 3 && store.open_count() == 1, "two closed orders retained");
+        check(!store.find_by_client_order_id("c-0", update) && store.find_by_client_order_id("c-3", update), "oldest closed dropped");
+        std::cout << "[OK] Closed order retention" << std::endl;
+    }
+
+    // Test 6: Open orders request codec
+    {
+        core::dtc::OpenOrdersRequest request;
+        request.request_id = 5;
+        request.request_all_orders = 0;
+        request.server_order_id = "dtc-1";
+        auto bytes = request.serialize();
+        check(bytes.size() == request.get_size(), "request size");
+
+        core::dtc::Protocol protocol;
+        auto parsed = protocol.parse_message(bytes.data(), static_cast<uint16_t>(bytes.size()));
+        auto *decoded = dynamic_cast<core::dtc::OpenOrdersRequest *>(parsed.get());
+        check(decoded && decoded->request_id == 5 && decoded->request_all_orders == 0 && decoded->server_order_id == "dtc-1",
+              "request round trip");
+
+        core::dtc::OpenOrdersReject reject;
+        reject.request_id = 5;
+        reject.reject_text = "Unknown server order ID";
+        auto reject_bytes = reject.serialize();
+        core::dtc::OpenOrdersReject reject_decoded;
+        check(reject_decoded.deserialize(reject_bytes.data(), static_cast<uint16_t>(reject_bytes.size())) &&
+                  reject_decoded.reject_text == reject.reject_text && reject_bytes.size() == reject.get_size(),
+              "reject round trip");
+        std::cout << "[OK] Open orders messages" << std::endl;
+    }
+
+    return test_support::finish("Order store");
+}
@@ -0,0 +1,124 @@
+#include "coinbase_dtc_core/exchanges/coinbase/coinbase_feed.hpp"
+#include "coinbase_dtc_core/exchanges/base/sequence_tracker.hpp"
+#include "test_support.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace open_dtc_server;
+using exchanges::base::MarketDepthUpdate;
+using exchanges::base::SequenceTracker;
+using test_support::check;
+
+namespace
+{
+    std::string l2update(const std::string &side, const std::string &price, const std::string &size, uint64_t sequence = 0)
+    {
+        std::string message = "{\"type\":\"l2update\",\"product_id\":\"BTC-USD\",\"changes\":[[\"" + side + "\",\"" +
+                              price + "\",\"" + size + "\"]],\"time\":\"2024-03-01T14:30:05.123456Z\"";
+        if (sequence != 0)
+            message += ",\"sequence\":" + std::to_string(sequence);
+        return message + "}";
+    }
+
+    const std::string SNAPSHOT =
+        "{\"type\":\"snapshot\",\"product_id\":\"BTC-USD\",\"bids\":[[\"100.00\",\"1.0\"],[\"99.00\",\"2.0\"]],"
+        "\"asks\":[[\"101.00\",\"1.5\"],[\"102.00\",\"3.0\"]]}";
+}
+
+int main()
+{
+    std::cout << "[TEST] Testing level2 sequence tracking and resync..." << std::endl;
+
+    // Test 1: Contiguous and monotonic trackers
+    {
+        SequenceTracker contiguous;
+        check(contiguous.observe(5) == SequenceTracker::Result::FIRST, "first number");
+        check(contiguous.observe(6) == SequenceTracker::Result::IN_ORDER, "next number");
+        check(contiguous.observe(6) == SequenceTracker::Result::STALE, "repeat is stale");
+        check(contiguous.observe(3) == SequenceTracker::Result::STALE, "older is stale");
+        check(contiguous.observe(10) == SequenceTracker::Result::GAP && contiguous.missing() == 3, "gap of 3");
+        check(contiguous.last() == 10, "gap moves the stream on");
+        contiguous.reset();
+        check(contiguous.observe(2) == SequenceTracker::Result::FIRST, "reset restarts the stream");
+
+        SequenceTracker monotonic(false);
+        monotonic.observe(100);
+        check(monotonic.observe(150) == SequenceTracker::Result::IN_ORDER, "monotonic stream allows jumps");
+        check(monotonic.observe(120) == SequenceTracker::Result::STALE, "monotonic stream drops reordering");
+    }
+
+    exchanges::base::ExchangeConfig config;
+    config.name = "coinbase";
+    exchanges::coinbase::CoinbaseFeed feed(config);
+
+    std::vector<MarketDepthUpdate> updates;
+    size_t trades = 0;
+    feed.set_depth_callback([&updates](const MarketDepthUpdate &update)
+                            { updates.push_back(update); });
+    feed.set_trade_callback([&trades](const exchanges::base::MarketTrade &)
+                            { trades++; });
+
+    exchanges::base::MarketLevel2 top;
+
+    // Test 2: Changes before the first snapshot are held back
+    feed.inject_websocket_message(l2update("buy", "99.50", "4.0"));
+    check(updates.empty(), "no deltas without a snapshot");
+    check(!feed.get_top_of_book("BTC-USD", top), "no top of book without a snapshot");
+    check(feed.get_book_sync_stats().buffered_deltas == 1, "change buffered");
+
+    // Test 3: Snapshot syncs the book
+    feed.inject_websocket_message(SNAPSHOT);
+    check(updates.size() == 1 && updates[0].action == MarketDepthUpdate::Action::SNAPSHOT, "snapshot published");
+    check(feed.get_top_of_book("BTC-USD", top) && top.bid_price == 100.0 && top.ask_price == 101.0, "top after snapshot");
+
+    // Test 4: In-order, repeated and skipped sequence numbers
+    updates.clear();
+    feed.inject_websocket_message(l2update("buy", "100.50", "1.0", 10));
+    feed.inject_websocket_message(l2update("sell", "100.75", "1.0", 11));
+    check(updates.size() == 2, "in-order deltas published");
+    feed.inject_websocket_message(l2update("sell", "100.80", "1.0", 11));
+    check(updates.size() == 2, "repeated sequence dropped");
+
+    feed.inject_websocket_message(l2update("buy", "100.60", "1.0", 14));
+    auto stats = feed.get_book_sync_stats();
+    check(stats.out_of_order == 1, "out of order counted");
+    check(stats.gaps == 1 && stats.missed_messages == 2, "gap of 2 counted");
+    check(stats.stale_books == 1, "book marked stale");
+    check(updates.size() == 2, "no deltas from a stale book");
+    check(!feed.get_top_of_book("BTC-USD", top), "stale book has no top");
+    std::vector<exchanges::base::PriceLevel> bids, asks;
+    check(!feed.get_order_book_depth("BTC-USD", 5, bids, asks), "stale book has no depth");
+
+    // Test 5: The next snapshot recovers it
+    feed.inject_websocket_message(SNAPSHOT);
+    stats = feed.get_book_sync_stats();
+    check(stats.resyncs == 1 && stats.stale_books == 0, "resync counted");
+    check(stats.max_recovery_us >= stats.last_recovery_us, "recovery time recorded");
+    check(updates.back().action == MarketDepthUpdate::Action::SNAPSHOT, "recovery snapshot published");
+    check(feed.get_top_of_book("BTC-USD", top) && top.bid_price == 100.0, "top after recovery");
+    feed.inject_websocket_message(l2update("buy", "100.25", "1.0", 15));
+    check(updates.back().action == MarketDepthUpdate::Action::SET && updates.back().price == 100.25,
+          "sequence restarts after the snapshot");
+
+    // Test 6: A crossed book is stale
+    size_t before = updates.size();
+    feed.inject_websocket_message(l2update("buy", "101.50", "1.0", 16));
+    stats = feed.get_book_sync_stats();
+    check(stats.crossed_books == 1 && stats.stale_books == 1, "crossed book marked stale");
+    check(updates.size() == before, "crossing delta not published");
+    feed.inject_websocket_message(SNAPSHOT);
+    check(feed.get_book_sync_stats().resyncs == 2, "crossed book recovered");
+
+    // Test 7: Reordered trades are dropped, jumps are not gaps
+    feed.inject_websocket_message("{\"type\":\"match\",\"trade_id\":1,\"sequence\":50,\"product_id\":\"BTC-USD\","
+                                  "\"size\":\"0.1\",\"price\":\"100.5\",\"side\":\"buy\"}");
+    feed.inject_websocket_message("{\"type\":\"match\",\"trade_id\":2,\"sequence\":70,\"product_id\":\"BTC-USD\","
+                                  "\"size\":\"0.1\",\"price\":\"100.5\",\"side\":\"buy\"}");
+    feed.inject_websocket_message("{\"type\":\"match\",\"trade_id\":0,\"sequence\":49,\"product_id\":\"BTC-USD\","
+                                  "\"size\":\"0.1\",\"price\":\"100.5\",\"side\":\"buy\"}");
+    check(trades == 2, "stale trade dropped");
+    check(feed.get_book_sync_stats().gaps == 1, "trade sequence jumps are not gaps");
+
+    return test_support::finish("Level2 sequence tracking and resync");
+}
@@ -16,15 +16,16 @@ public:
     void on_trade(const exchanges::base::MarketTrade &trade)
     {
         trade_count++;
-        util::log("[CALLBACK] Trade received: " + trade.symbol + " Price: " + std::to_string(trade.price) +
+        util::log("[CALLBACK] Trade received: " + exchanges::base::SymbolRegistry::getInstance().exchange_symbol(trade.instrument) +
+                  " Price: " + std::to_string(trade.price) +
                   " Volume: " + std::to_string(trade.volume) +
-                  " Side: " + trade.side);
+                  " Side: " + (trade.side == exchanges::base::TradeSide::BUY ? "buy" : "sell"));
     }
 
     void on_level2(const exchanges::base::MarketLevel2 &level2)
     {
         level2_count++;
-        util::log("[CALLBACK] Level2 received: " + level2.symbol +
+        util::log("[CALLBACK] Level2 received: " + exchanges::base::SymbolRegistry::getInstance().exchange_symbol(level2.instrument) +
                   " Bid: " + std::to_string(level2.bid_price) + "x" + std::to_string(level2.bid_size) +
                   " Ask: " + std::to_string(level2.ask_price) + "x" + std::to_string(level2.ask_size));
     }
@@ -0,0 +1,360 @@
+#include "coinbase_simulator/coinbase_simulator.hpp"
+#include "coinbase_dtc_core/exchanges/coinbase/coinbase_feed.hpp"
+#include "coinbase_dtc_core/exchanges/base/order_book.hpp"
+#include "test_support.hpp"
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace open_dtc_server;
+using namespace open_dtc_server::simulator;
+using test_support::check;
+
+namespace
+{
+    nlohmann::json parse(const std::string &message)
+    {
+        return nlohmann::json::parse(message);
+    }
+
+    void load_levels(exchanges::base::OrderBook &book, exchanges::base::BookSide side, const nlohmann::json &levels)
+    {
+        std::vector<exchanges::base::PriceLevel> loaded;
+        for (const auto &level : levels)
+            loaded.emplace_back(std::stod(level[0].get<std::string>()), std::stod(level[1].get<std::string>()));
+        book.load(side, std::move(loaded));
+    }
+}
+
+int main()
+{
+    std::cout << "[TEST] Testing Coinbase feed simulator..." << std::endl;
+
+    SimulatorConfig config;
+    config.products = {"BTC-USD", "ETH-USD"};
+    config.book_depth = 10;
+
+    // Test 1: Subscribe replies with subscriptions and a level2 snapshot
+    FeedSession session(config);
+    std::vector<std::string> out;
+    session.handle_message(R"({"type":"subscribe","product_ids":["BTC-USD"],"channels":["level2","heartbeat",{"name":"ticker","product_ids":["BTC-USD"]},"matches"]})", out);
+    check(out.size() == 2, "subscriptions and snapshot");
+
+    exchanges::base::OrderBook book;
+    {
+        auto subscriptions = parse(out[0]);
+        check(subscriptions["type"] == "subscriptions" && subscriptions["channels"].size() == 4, "four channels confirmed");
+
+        auto snapshot = parse(out[1]);
+        check(snapshot["type"] == "snapshot" && snapshot["product_id"] == "BTC-USD", "snapshot for subscribed product");
+        check(snapshot["bids"].size() == 10 && snapshot["asks"].size() == 10, "snapshot depth");
+        load_levels(book, exchanges::base::BookSide::BID, snapshot["bids"]);
+        load_levels(book, exchanges::base::BookSide::ASK, snapshot["asks"]);
+        check(book.best_bid()->price < book.best_ask()->price, "snapshot not crossed");
+        std::cout << "[OK] Subscribe" << std::endl;
+    }
+
+    // Test 2: Invalid products and channels are rejected as a whole
+    {
+        out.clear();
+        session.handle_message(R"({"type":"subscribe","channels":[{"name":"ticker","product_ids":["ETH-USD","FOO-USD"]}]})", out);
+        check(out.size() == 1 && parse(out[0])["type"] == "error", "invalid product rejected");
+        check(!session.is_subscribed("ticker", "ETH-USD"), "valid product of rejected request not subscribed");
+
+        out.clear();
+        session.handle_message(R"({"type":"subscribe","product_ids":["ETH-USD"],"channels":["full"]})", out);
+        check(out.size() == 1 && parse(out[0])["reason"] == "full is not a valid channel", "invalid channel rejected");
+
+        out.clear();
+        session.handle_message("not json", out);
+        check(out.size() == 1 && parse(out[0])["type"] == "error", "malformed message rejected");
+        std::cout << "[OK] Errors" << std::endl;
+    }
+
+    // Test 3: Generated data only covers subscriptions and keeps the book consistent
+    {
+        out.clear();
+        size_t added = session.generate(5000, out);
+        check(added >= 5000 && out.size() == added, "requested count generated");
+
+        size_t updates = 0, matches = 0, tickers = 0;
+        bool consistent = true;
+        for (const auto &message : out)
+        {
+            auto json = parse(message);
+            consistent = consistent && json["product_id"] == "BTC-USD";
+            std::string type = json["type"];
+            if (type == "l2update")
+            {
+                updates++;
+                for (const auto &change : json["changes"])
+                {
+                    book.apply(change[0] == "buy" ? exchanges::base::BookSide::BID : exchanges::base::BookSide::ASK,
+                               std::stod(change[1].get<std::string>()), std::stod(change[2].get<std::string>()));
+                }
+                consistent = consistent && book.best_bid() && book.best_ask() &&
+                             book.best_bid()->price < book.best_ask()->price;
+            }
+            else if (type == "match")
+            {
+                matches++;
+            }
+            else if (type == "ticker")
+            {
+                tickers++;
+                consistent = consistent && std::stod(json["best_bid"].get<std::string>()) == book.best_bid()->price &&
+                             std::stod(json["best_ask"].get<std::string>()) == book.best_ask()->price;
+            }
+        }
+        check(consistent, "book replayed from updates matches ticker best bid/ask and never crosses");
+        check(updates > matches && matches > 0 && matches == tickers, "channel mix");
+
+        out.clear();
+        session.heartbeats(out);
+        check(out.size() == 1 && parse(out[0])["type"] == "heartbeat", "heartbeat");
+        std::cout << "[OK] Synthetic data (" << updates << " updates, " << matches << " trades)" << std::endl;
+    }
+
+    // Test 4: Unsubscribe stops a channel
+    {
+        out.clear();
+        session.handle_message(R"({"type":"unsubscribe","channels":["level2","matches"]})", out);
+        out.clear();
+        session.generate(100, out);
+        bool tickers_only = !out.empty();
+        for (const auto &message : out)
+            tickers_only = tickers_only && parse(message)["type"] == "ticker";
+        check(tickers_only, "only ticker after unsubscribe");
+
+        out.clear();
+        session.handle_message(R"({"type":"unsubscribe","channels":["ticker"]})", out);
+        out.clear();
+        check(!session.has_data_subscriptions() && session.generate(100, out) == 0, "nothing after unsubscribing all data");
+        std::cout << "[OK] Unsubscribe" << std::endl;
+    }
+
+    // Test 5: Recorded messages are replayed by channel and product
+    {
+        auto path = std::filesystem::temp_directory_path() / "test_coinbase_simulator.jsonl";
+        {
+            std::ofstream file(path);
+            file << R"({"type":"match","product_id":"DOGE-USD","price":"0.10","size":"5"})" << "\n";
+            file << R"({"type":"ticker","product_id":"DOGE-USD","price":"0.10"})" << "\n";
+            file << R"({"type":"heartbeat","product_id":"DOGE-USD"})" << "\n";
+            file << "1700000000000000\t" << R"({"type":"ticker","product_id":"DOGE-USD","price":"0.11"})" << "\n";
+            file << "garbage\n";
+        }
+
+        auto recording = std::make_shared<Recording>();
+        check(FeedSession::load_recording(path.string(), *recording) && recording->size() == 3, "recording loaded, including a raw capture line");
+
+        FeedSession replay(config, recording);
+        out.clear();
+        replay.handle_message(R"({"type":"subscribe","product_ids":["DOGE-USD"],"channels":["matches"]})", out);
+        check(out.size() == 1 && parse(out[0])["type"] == "subscriptions", "recorded product is valid");
+
+        out.clear();
+        check(replay.generate(3, out) == 3, "recording cycles");
+        check(parse(out[0])["type"] == "match" && out[0] == out[1], "only the subscribed channel is replayed");
+        std::filesystem::remove(path);
+        std::cout << "[OK] Recorded data" << std::endl;
+    }
+
+    // Test 6: CoinbaseFeed end to end over TLS with permessage-deflate
+    {
+        SimulatorConfig server_config;
+        server_config.port = 0;
+        server_config.products = {"BTC-USD"};
+        server_config.messages_per_second = 2000;
+
+        CoinbaseSimulator simulator(server_config);
+        check(simulator.start(), "simulator starts");
+
+        exchanges::base::ExchangeConfig feed_config;
+        feed_config.name = "coinbase";
+        feed_config.websocket_url = "wss://127.0.0.1:" + std::to_string(simulator.get_port());
+        auto capture_path = std::filesystem::temp_directory_path() / "test_coinbase_simulator_capture.txt";
+        std::filesystem::remove(capture_path);
+        feed_config.capture_file = capture_path.string();
+        exchanges::coinbase::CoinbaseFeed feed(feed_config);
+
+        std::atomic<int> trades{0};
+        std::atomic<int> quotes{0};
+        feed.set_trade_callback([&trades](const exchanges::base::MarketTrade &)
+                                { trades++; });
+        feed.set_level2_callback([&quotes](const exchanges::base::MarketLevel2 &)
+                                 { quotes++; });
+
+        check(feed.connect(), "feed connects to simulator");
+        check(feed.subscribe_trades("BTC-USD"), "ticker subscription confirmed");
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while ((trades < 50 || quotes < 50) && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        check(trades >= 50 && quotes >= 50, "ticker messages decoded by the feed");
+        check(simulator.get_stats().connections == 1 && simulator.get_stats().messages_sent > 0, "simulator stats");
+        check(feed.get_status().find("deflate with context takeover") != std::string::npos,
+              "permessage-deflate negotiated with context takeover");
+
+        feed.disconnect();
+        simulator.stop();
+
+        // Raw capture: timestamped payloads that replay as a recording
+        {
+            std::ifstream capture(capture_path);
+            std::string line;
+            size_t lines = 0;
+            bool well_formed = true;
+            while (std::getline(capture, line))
+            {
+                lines++;
+                size_t tab = line.find('\t');
+                well_formed = well_formed && tab != std::string::npos && tab > 0 &&
+                              line.find_first_not_of("0123456789") == tab && line[tab + 1] == '{';
+            }
+            check(lines >= static_cast<size_t>(trades.load()) && well_formed, "raw capture written with receive timestamps");
+
+            Recording captured;
+            check(FeedSession::load_recording(capture_path.string(), captured) && !captured.empty(), "capture replays as a recording");
+            std::filesystem::remove(capture_path);
+        }
+        std::cout << "[OK] End to end (" << trades.load() << " trades)" << std::endl;
+    }
+
+    // Test 7: A/B connections carry the same stream; each trade comes out once
+    {
+        SimulatorConfig server_config;
+        server_config.port = 0;
+        server_config.products = {"BTC-USD"};
+        server_config.messages_per_second = 2000;
+
+        CoinbaseSimulator simulator(server_config);
+        check(simulator.start(), "simulator starts for A/B");
+
+        exchanges::base::ExchangeConfig feed_config;
+        feed_config.name = "coinbase";
+        feed_config.websocket_url = "wss://127.0.0.1:" + std::to_string(simulator.get_port());
+        feed_config.redundant_feed = true;
+        exchanges::coinbase::CoinbaseFeed feed(feed_config);
+
+        std::mutex trades_mutex;
+        std::vector<uint64_t> sequences;
+        feed.set_trade_callback([&](const exchanges::base::MarketTrade &trade)
+                                {
+            std::lock_guard<std::mutex> lock(trades_mutex);
+            sequences.push_back(trade.sequence); });
+
+        check(feed.connect(), "A/B feed connects");
+        check(feed.subscribe_trades("BTC-USD"), "A/B ticker subscription confirmed");
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        auto arbitrated = [&]
+        {
+            auto stats = feed.get_arbitration_stats();
+            return stats.size() == 1 && stats[0].sides[0].duplicates + stats[0].sides[1].duplicates >= 50;
+        };
+        while (!arbitrated() && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        auto stats = feed.get_arbitration_stats();
+        check(simulator.get_stats().connections == 2, "two connections");
+        check(arbitrated(), "copies from both sides seen");
+        if (stats.size() == 1)
+        {
+            const auto &a = stats[0].sides[0];
+            const auto &b = stats[0].sides[1];
+            check(a.received > 0 && b.received > 0 && a.leads + b.leads > 0, "both sides measured");
+        }
+        check(feed.get_status().find("Failovers: ") != std::string::npos, "A/B status");
+
+        feed.disconnect();
+        simulator.stop();
+
+        std::lock_guard<std::mutex> lock(trades_mutex);
+        bool increasing = !sequences.empty();
+        for (size_t i = 1; i < sequences.size(); ++i)
+            increasing = increasing && sequences[i] > sequences[i - 1];
+        check(increasing, "each trade delivered once, in order");
+        std::cout << "[OK] A/B end to end (" << sequences.size() << " trades)" << std::endl;
+    }
+
+    // Test 8: A dropped connection comes back on its own with its subscriptions
+    {
+        SimulatorConfig server_config;
+        server_config.port = 0;
+        server_config.products = {"BTC-USD"};
+        server_config.messages_per_second = 500;
+
+        CoinbaseSimulator simulator(server_config);
+        check(simulator.start(), "simulator starts for reconnect");
+
+        exchanges::base::ExchangeConfig feed_config;
+        feed_config.name = "coinbase";
+        feed_config.websocket_url = "wss://127.0.0.1:" + std::to_string(simulator.get_port());
+        exchanges::coinbase::CoinbaseFeed feed(feed_config);
+
+        std::atomic<int> trades{0};
+        std::atomic<int> downs{0};
+        std::atomic<int> ups{0};
+        feed.set_trade_callback([&](const exchanges::base::MarketTrade &)
+                                { trades++; });
+        feed.set_connection_callback([&](bool connected, const std::string &)
+                                     { (connected ? ups : downs)++; });
+
+        check(feed.connect(), "feed connects for reconnect");
+        check(feed.subscribe_trades("BTC-USD"), "ticker subscription confirmed");
+        check(feed.subscribe_level2("BTC-USD"), "level2 subscription confirmed");
+
+        auto wait_for = [](const std::function<bool()> &done, int seconds)
+        {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+            while (!done() && std::chrono::steady_clock::now() < deadline)
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            return done();
+        };
+        check(wait_for([&]
+                       { return trades.load() > 10; }, 5),
+              "trades before the drop");
+
+        check(simulator.drop_connections() == 1, "connection dropped");
+        auto resynced = [&]
+        {
+            auto stats = feed.get_reconnect_stats();
+            return stats.reconnects >= 1 && !stats.recent.empty() && stats.recent.back().resynced_us > 0;
+        };
+        check(wait_for(resynced, 5), "reconnected and resynced");
+
+        auto stats = feed.get_reconnect_stats();
+        check(stats.drops >= 1 && downs.load() >= 1 && ups.load() >= 2, "drop and recovery reported");
+        if (!stats.recent.empty())
+        {
+            const auto &record = stats.recent.back();
+            check(record.first_message_us > 0 && record.first_message_us <= record.resynced_us, "first message before resync");
+            check(record.down_us >= 500000, "backoff before the attempt");
+        }
+
+        int before = trades.load();
+        check(wait_for([&]
+                       { return trades.load() > before + 10; }, 5),
+              "trades resume on restored subscriptions");
+        check(simulator.get_stats().connections == 2, "one reconnect");
+        check(feed.get_status().find("Reconnects: ") != std::string::npos, "reconnect status");
+
+        feed.disconnect();
+        simulator.stop();
+        if (!stats.recent.empty())
+            std::cout << "[OK] Reconnect (first message " << stats.recent.back().first_message_us << " us, resynced "
+                      << stats.recent.back().resynced_us << " us)" << std::endl;
+    }
+
+    return test_support::finish("Coinbase simulator");
+}
@@ -0,0 +1,175 @@
+#include "coinbase_dtc_core/exchanges/coinbase/feed_arbiter.hpp"
+#include "test_support.hpp"
+#include <iostream>
+#include <string>
+
+using namespace open_dtc_server::exchanges::coinbase;
+using test_support::check;
+
+namespace
+{
+    std::string ticker(const std::string &product, int sequence)
+    {
+        return "{\"type\":\"ticker\",\"sequence\":" + std::to_string(sequence) + ",\"product_id\":\"" + product +
+               "\",\"price\":\"100.00\"}";
+    }
+
+    std::string match(int trade_id, int sequence)
+    {
+        return "{\"type\":\"match\",\"trade_id\":" + std::to_string(trade_id) + ",\"sequence\":" + std::to_string(sequence) +
+               ",\"product_id\":\"BTC-USD\",\"price\":\"100.00\",\"size\":\"1\"}";
+    }
+
+    // micros: exchange time within 2024-03-01T14:30:05, below one second
+    std::string l2update(const std::string &price, int micros)
+    {
+        std::string fraction = std::to_string(micros);
+        fraction.insert(0, 6 - fraction.size(), '0');
+        return "{\"type\":\"l2update\",\"product_id\":\"BTC-USD\",\"changes\":[[\"buy\",\"" + price +
+               "\",\"1.0\"]],\"time\":\"2024-03-01T14:30:05." + fraction + "Z\"}";
+    }
+
+    std::string snapshot()
+    {
+        return "{\"type\":\"snapshot\",\"product_id\":\"BTC-USD\",\"bids\":[],\"asks\":[]}";
+    }
+
+    bool offer(FeedArbiter &arbiter, FeedSide side, const std::string &message, uint64_t time_us)
+    {
+        FeedMessage fields;
+        FeedMessageScanner::scan(message, fields);
+        return arbiter.accept(side, fields, time_us);
+    }
+}
+
+int main()
+{
+    std::cout << "[TEST] Testing A/B feed arbitration..." << std::endl;
+
+    // Test 1: First copy wins, the second is dropped and measured
+    {
+        FeedArbiter arbiter;
+        check(offer(arbiter, FeedSide::A, ticker("BTC-USD", 1), 1000), "A first");
+        check(!offer(arbiter, FeedSide::B, ticker("BTC-USD", 1), 1250), "B copy dropped");
+        check(offer(arbiter, FeedSide::B, ticker("BTC-USD", 2), 2000), "B first");
+        check(!offer(arbiter, FeedSide::A, ticker("BTC-USD", 2), 2100), "A copy dropped");
+        check(offer(arbiter, FeedSide::A, ticker("ETH-USD", 2), 2200), "same sequence, other product");
+
+        auto stats = arbiter.stats();
+        const auto &a = stats.sides[0];
+        const auto &b = stats.sides[1];
+        check(a.received == 3 && a.first == 2 && a.duplicates == 1, "side A counts");
+        check(b.received == 2 && b.first == 1 && b.duplicates == 1, "side B counts");
+        check(a.leads == 1 && a.lead_us_total == 250 && a.lead_us_max == 250, "A lead measured");
+        check(b.leads == 1 && b.lead_us_total == 100, "B lead measured");
+    }
+
+    // Test 2: A side that falls behind never sends the feed backwards
+    {
+        FeedArbiter arbiter;
+        for (int sequence = 1; sequence <= 20000; ++sequence)
+            offer(arbiter, FeedSide::A, ticker("BTC-USD", sequence), sequence);
+        check(!offer(arbiter, FeedSide::B, ticker("BTC-USD", 5), 30000), "copy beyond the window still dropped");
+        check(offer(arbiter, FeedSide::B, ticker("BTC-USD", 20001), 30001), "B carries on where A stopped");
+    }
+
+    // Test 3: Matches by trade_id, level2 updates by their exchange time
+    {
+        FeedArbiter arbiter;
+        check(offer(arbiter, FeedSide::A, match(7, 100), 10), "match forwarded");
+        check(!offer(arbiter, FeedSide::B, match(7, 100), 20), "match copy dropped");
+        check(offer(arbiter, FeedSide::B, l2update("100.00", 1), 30), "update forwarded");
+        check(!offer(arbiter, FeedSide::A, l2update("100.00", 1), 35), "same update from the other side dropped");
+        check(offer(arbiter, FeedSide::A, l2update("100.01", 2), 40), "later update forwarded");
+        check(offer(arbiter, FeedSide::A, l2update("100.02", 2), 45), "second update at the same time forwarded");
+        check(!offer(arbiter, FeedSide::B, l2update("100.01", 2), 50) && !offer(arbiter, FeedSide::B, l2update("100.02", 2), 55),
+              "copies at the same time dropped in order");
+    }
+
+    // Test 3b: A side lagging past the arrival window never replays level2 updates
+    {
+        FeedArbiter arbiter;
+        const int updates = static_cast<int>(FeedArbiter::RECENT_MESSAGES) + 1000;
+        check(offer(arbiter, FeedSide::A, snapshot(), 1), "snapshot from A");
+        check(!offer(arbiter, FeedSide::B, snapshot(), 2), "B's snapshot dropped");
+
+        // Prices repeat, so equal text on one side is not a copy of the other's
+        int forwarded = 0;
+        for (int i = 0; i < updates; ++i)
+            forwarded += offer(arbiter, FeedSide::A, l2update(std::to_string(100 + i % 50) + ".00", 10 + i), 10 + i) ? 1 : 0;
+        check(forwarded == updates, "A forwards every update, repeated text included");
+
+        int replayed = 0;
+        for (int i = 0; i < updates; ++i)
+            replayed += offer(arbiter, FeedSide::B, l2update(std::to_string(100 + i % 50) + ".00", 10 + i), 100000 + i) ? 1 : 0;
+        check(replayed == 0, "B's late copies all dropped");
+        check(offer(arbiter, FeedSide::B, l2update("99.00", updates + 10), 200000), "B carries on past A");
+        check(!offer(arbiter, FeedSide::A, l2update("99.00", updates + 10), 200100), "A's copy of it dropped");
+
+        auto stats = arbiter.stats();
+        check(stats.sides[1].duplicates == static_cast<uint64_t>(updates) + 1 && stats.sides[0].first == static_cast<uint64_t>(updates) + 1,
+              "duplicates counted beyond the window");
+
+        // A resync starts both sides from the new snapshot
+        arbiter.expect_snapshot("BTC-USD");
+        check(offer(arbiter, FeedSide::B, snapshot(), 300000), "resync snapshot forwarded");
+        check(offer(arbiter, FeedSide::A, l2update("98.00", updates + 20), 300010) &&
+                  !offer(arbiter, FeedSide::B, l2update("98.00", updates + 20), 300020),
+              "updates after the resync snapshot arbitrated");
+    }
+
+    // Test 3c: B subscribes after A already forwarded updates, then carries the feed alone
+    {
+        FeedArbiter arbiter;
+        check(offer(arbiter, FeedSide::A, snapshot(), 1), "snapshot from A");
+        for (int i = 1; i <= 3; ++i)
+            check(offer(arbiter, FeedSide::A, l2update(std::to_string(100 + i) + ".00", i), 10 + i), "A forwards update before B joins");
+        check(!offer(arbiter, FeedSide::B, snapshot(), 20), "B's later snapshot dropped");
+
+        // B's first update is the fourth of the stream, not a copy of A's first
+        check(offer(arbiter, FeedSide::B, l2update("104.00", 4), 30), "B's first update forwarded");
+        check(!offer(arbiter, FeedSide::A, l2update("104.00", 4), 35), "A's copy dropped");
+        check(offer(arbiter, FeedSide::B, l2update("105.00", 5), 40) && offer(arbiter, FeedSide::B, l2update("106.00", 6), 50),
+              "B carries on while A is silent");
+        check(!offer(arbiter, FeedSide::A, l2update("105.00", 5), 60) && offer(arbiter, FeedSide::A, l2update("107.00", 7), 70),
+              "A rejoins where B left off");
+        check(arbiter.stats().sides[1].first == 3, "no update lost to B's late snapshot");
+    }
+
+    // Test 4: One snapshot per product until another is asked for; control messages pass
+    {
+        FeedArbiter arbiter;
+        check(offer(arbiter, FeedSide::B, snapshot(), 10), "first snapshot forwarded");
+        check(!offer(arbiter, FeedSide::A, snapshot(), 20), "other side's snapshot dropped");
+        check(!offer(arbiter, FeedSide::A, snapshot(), 30), "reconnecting side's snapshot dropped");
+        arbiter.expect_snapshot("BTC-USD");
+        check(offer(arbiter, FeedSide::A, snapshot(), 40), "requested snapshot forwarded");
+
+        std::string heartbeat = "{\"type\":\"heartbeat\",\"sequence\":5,\"product_id\":\"BTC-USD\"}";
+        check(offer(arbiter, FeedSide::A, heartbeat, 50) && offer(arbiter, FeedSide::B, heartbeat, 60), "heartbeats from both sides");
+        check(arbiter.stats().passed == 2, "passed through");
+
+        arbiter.reset();
+        check(offer(arbiter, FeedSide::A, snapshot(), 70), "snapshot after reset");
+    }
+
+    // Test 5: Quiet side and failover
+    {
+        FeedArbiter arbiter(1000);
+        check(arbiter.is_quiet(FeedSide::B, 0), "never heard from is quiet");
+        offer(arbiter, FeedSide::A, ticker("BTC-USD", 1), 100);
+        offer(arbiter, FeedSide::B, ticker("BTC-USD", 1), 150);
+        offer(arbiter, FeedSide::A, ticker("BTC-USD", 2), 200);
+        check(!arbiter.is_quiet(FeedSide::A, 500), "A live");
+
+        // A stops; B goes on alone
+        offer(arbiter, FeedSide::B, ticker("BTC-USD", 2), 250);
+        offer(arbiter, FeedSide::B, ticker("BTC-USD", 3), 5000);
+        offer(arbiter, FeedSide::B, ticker("BTC-USD", 4), 5100);
+        check(arbiter.is_quiet(FeedSide::A, 5100) && !arbiter.is_quiet(FeedSide::B, 5100), "A quiet");
+        check(arbiter.stats().failovers == 1, "one failover");
+        check(arbiter.stats().sides[1].first == 2, "B forwarded on its own");
+    }
+
+    return test_support::finish("A/B feed arbitration");
+}
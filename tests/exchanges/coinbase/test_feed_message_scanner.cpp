@@ -0,0 +1,82 @@
+#include "coinbase_dtc_core/exchanges/coinbase/feed_message_scanner.hpp"
+#include "test_support.hpp"
+#include <iostream>
+#include <string>
+
+using namespace open_dtc_server::exchanges::coinbase;
+using test_support::check;
+
+int main()
+{
+    std::cout << "[TEST] Testing Coinbase feed message scanner..." << std::endl;
+
+    // Match: wanted fields kept, numbers / nested values skipped
+    {
+        const std::string json = R"({"type":"match","trade_id":12345,"maker_order_id":"ab\"c","sequence":50,)"
+                                 R"("meta":{"a":[1,{"b":"}"}]},"product_id":"BTC-USD","size":"0.015","price":"43250.12",)"
+                                 R"("side":"sell","time":"2024-01-02T03:04:05.678Z","flag":true})";
+        FeedMessage message;
+        check(FeedMessageScanner::scan(json, message), "match scans");
+        check(message.type == "match", "type");
+        check(message.product_id == "BTC-USD", "product_id after nested object");
+        check(message.price == "43250.12" && message.size == "0.015", "price and size");
+        check(message.side == "sell", "side");
+        check(message.trade_id == "12345" && message.sequence == "50", "numeric trade_id and sequence");
+        check(message.time == "2024-01-02T03:04:05.678Z", "time");
+        check(message.best_bid.empty() && message.changes.empty(), "absent fields stay empty");
+        std::cout << "[OK] Match message" << std::endl;
+    }
+
+    // Ticker with whitespace between tokens
+    {
+        const std::string json = "{ \"type\" : \"ticker\",\n \"product_id\": \"ETH-USD\", \"price\": \"2250.5\","
+                                 " \"best_bid\": \"2250.4\", \"best_bid_size\": \"1.2\", \"best_ask\": \"2250.6\","
+                                 " \"best_ask_size\": \"0.8\", \"last_size\": \"0.1\" }";
+        FeedMessage message;
+        check(FeedMessageScanner::scan(json, message), "ticker scans");
+        check(message.type == "ticker" && message.product_id == "ETH-USD", "ticker identity");
+        check(message.best_bid == "2250.4" && message.best_ask == "2250.6", "best bid/ask");
+        check(message.best_bid_size == "1.2" && message.best_ask_size == "0.8", "best sizes");
+        check(message.last_size == "0.1", "last size");
+        std::cout << "[OK] Ticker message" << std::endl;
+    }
+
+    // l2update: changes walked entry by entry, extra trailing entries tolerated
+    {
+        const std::string json = R"({"type":"l2update","product_id":"BTC-USD","changes":[["buy","100.5","1.0"],)"
+                                 R"( ["sell","101","0", "2024-01-02T03:04:05Z"],["buy","99.75","2.5"]],"time":"x"})";
+        FeedMessage message;
+        check(FeedMessageScanner::scan(json, message), "l2update scans");
+        check(!message.changes.empty(), "changes captured");
+
+        std::string_view cursor = message.changes, side, price, size;
+        int count = 0;
+        bool ok = true;
+        const char *expected[][3] = {{"buy", "100.5", "1.0"}, {"sell", "101", "0"}, {"buy", "99.75", "2.5"}};
+        while (FeedMessageScanner::next_change(cursor, side, price, size))
+        {
+            if (count < 3)
+                ok = ok && side == expected[count][0] && price == expected[count][1] && size == expected[count][2];
+            ++count;
+        }
+        check(count == 3 && ok, "three changes read in order");
+        std::cout << "[OK] Level2 update" << std::endl;
+    }
+
+    // Malformed input is rejected rather than half-read
+    {
+        FeedMessage message;
+        check(!FeedMessageScanner::scan("", message), "empty rejected");
+        check(!FeedMessageScanner::scan("[1,2]", message), "array rejected");
+        check(!FeedMessageScanner::scan(R"({"type":"match","price":"1)", message), "unterminated string rejected");
+        check(!FeedMessageScanner::scan(R"({"type":"match" "price":"1"})", message), "missing comma rejected");
+        check(!FeedMessageScanner::scan(R"({"type":"match","changes":[["buy","1","2"])", message), "unterminated array rejected");
+        check(FeedMessageScanner::scan("{}", message) && message.type.empty(), "empty object accepted");
+
+        std::string_view cursor = R"(["buy","1"])", side, price, size;
+        check(!FeedMessageScanner::next_change(cursor, side, price, size) && cursor.empty(), "short change rejected");
+        std::cout << "[OK] Malformed input" << std::endl;
+    }
+
+    return test_support::finish("Feed message scanner");
+}
@@ -0,0 +1,146 @@
+#include "coinbase_dtc_core/exchanges/coinbase/permessage_deflate.hpp"
+#include "test_support.hpp"
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+using namespace open_dtc_server::feed::coinbase;
+using test_support::check;
+
+namespace
+{
+    /** Server side of permessage-deflate: sync flush, tail stripped, reset per message unless taking over context */
+    class Deflater
+    {
+    public:
+        explicit Deflater(bool takeover) : takeover_(takeover)
+        {
+            deflateInit2(&stream_, Z_BEST_SPEED, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+        }
+        ~Deflater() { deflateEnd(&stream_); }
+
+        std::vector<uint8_t> compress(const std::string &message)
+        {
+            if (!takeover_)
+                deflateReset(&stream_);
+            std::vector<uint8_t> out(deflateBound(&stream_, message.size()) + 16);
+            stream_.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(message.data()));
+            stream_.avail_in = static_cast<uInt>(message.size());
+            stream_.next_out = out.data();
+            stream_.avail_out = static_cast<uInt>(out.size());
+            deflate(&stream_, Z_SYNC_FLUSH);
+            out.resize(out.size() - stream_.avail_out);
+            if (out.size() >= 4 && std::memcmp(out.data() + out.size() - 4, "\x00\x00\xff\xff", 4) == 0)
+                out.resize(out.size() - 4);
+            return out;
+        }
+
+    private:
+        z_stream stream_{};
+        bool takeover_;
+    };
+
+    std::string ticker(int i)
+    {
+        return "{\"type\":\"ticker\",\"sequence\":" + std::to_string(1000 + i) +
+               ",\"product_id\":\"BTC-USD\",\"price\":\"6543" + std::to_string(i % 10) +
+               ".12\",\"best_bid\":\"65430.11\",\"best_ask\":\"65430.13\",\"time\":\"2024-03-01T14:30:05.123456Z\"}";
+    }
+}
+
+int main()
+{
+    std::cout << "[TEST] Testing permessage-deflate..." << std::endl;
+
+    // Test 1: Negotiation
+    {
+        DeflateParameters parameters;
+        bool accepted = true;
+        check(parse_deflate_response("", parameters, accepted) && !accepted, "no extension");
+        check(parse_deflate_response("permessage-deflate", parameters, accepted) && accepted &&
+                  !parameters.server_no_context_takeover,
+              "plain accept means context takeover");
+        check(parse_deflate_response("permessage-deflate; server_no_context_takeover; client_max_window_bits=10",
+                                     parameters, accepted) &&
+                  accepted && parameters.server_no_context_takeover && parameters.client_max_window_bits == 10,
+              "parameters parsed");
+        check(parse_deflate_response("x-webkit-deflate-frame, Permessage-Deflate ; server_max_window_bits=\"12\"",
+                                     parameters, accepted) &&
+                  accepted && parameters.server_max_window_bits == 12,
+              "other extensions skipped, quoted value");
+        check(!parse_deflate_response("permessage-deflate; server_max_window_bits=16", parameters, accepted),
+              "window bits out of range rejected");
+        check(!parse_deflate_response("permessage-deflate; mystery", parameters, accepted), "unknown parameter rejected");
+        check(!parse_deflate_response("permessage-deflate, permessage-deflate", parameters, accepted), "accepted twice rejected");
+    }
+
+    // Test 2: Context takeover across many messages, one output buffer
+    for (bool takeover : {true, false})
+    {
+        Deflater deflater(takeover);
+        Inflater inflater;
+        DeflateParameters parameters;
+        parameters.server_no_context_takeover = !takeover;
+        check(inflater.start(parameters) && inflater.context_takeover() == takeover, "stream started");
+
+        std::string out;
+        bool all_equal = true;
+        size_t wire = 0, plain = 0;
+        for (int i = 0; i < 500; ++i)
+        {
+            std::string message = ticker(i);
+            auto compressed = deflater.compress(message);
+            wire += compressed.size();
+            plain += message.size();
+            all_equal = all_equal && inflater.inflate(compressed.data(), compressed.size(), out) && out == message;
+        }
+        check(all_equal, takeover ? "takeover messages inflate" : "independent messages inflate");
+
+        auto stats = inflater.stats();
+        check(stats.messages == 500 && stats.compressed_bytes == wire && stats.inflated_bytes == plain && stats.errors == 0,
+              "stats count bytes both ways");
+        if (takeover)
+            check(wire * 3 < plain, "takeover compresses repeated structure well");
+    }
+
+    // Test 3: Large message grows the buffer; small ones after it reuse it
+    {
+        Deflater deflater(true);
+        Inflater inflater;
+        inflater.start(DeflateParameters());
+
+        std::string snapshot = "{\"type\":\"snapshot\",\"bids\":[";
+        for (int i = 0; i < 20000; ++i)
+            snapshot += "[\"" + std::to_string(60000 - i) + ".00\",\"" + std::to_string(i % 97) + ".5\"],";
+        snapshot += "[\"1.00\",\"1\"]]}";
+
+        std::string out;
+        auto compressed = deflater.compress(snapshot);
+        check(inflater.inflate(compressed.data(), compressed.size(), out) && out == snapshot, "large message");
+        size_t capacity = out.capacity();
+
+        compressed = deflater.compress(ticker(1));
+        check(inflater.inflate(compressed.data(), compressed.size(), out) && out == ticker(1), "small message after it");
+        check(out.capacity() == capacity, "buffer reused, not reallocated");
+    }
+
+    // Test 4: Corrupt input fails without crashing; inactive stream refuses
+    {
+        Inflater inflater;
+        std::string out;
+        uint8_t junk[] = {0xff, 0xff, 0xff, 0xff, 0x12};
+        check(!inflater.inflate(junk, sizeof(junk), out), "not started");
+
+        inflater.start(DeflateParameters());
+        check(!inflater.inflate(junk, sizeof(junk), out) && out.empty(), "corrupt data rejected");
+        check(inflater.stats().errors == 1, "error counted");
+
+        Deflater deflater(false);
+        auto compressed = deflater.compress(ticker(2));
+        check(inflater.inflate(compressed.data(), compressed.size(), out) && out == ticker(2), "stream usable after reset");
+    }
+
+    return test_support::finish("Permessage-deflate");
+}
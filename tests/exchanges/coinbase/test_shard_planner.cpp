@@ -0,0 +1,110 @@
+#include "coinbase_dtc_core/exchanges/coinbase/shard_planner.hpp"
+#include "test_support.hpp"
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using open_dtc_server::exchanges::coinbase::ShardPlanner;
+using test_support::check;
+
+namespace
+{
+    double spread(const ShardPlanner &planner)
+    {
+        double lowest = 1e300, highest = 0.0;
+        for (size_t i = 0; i < planner.shard_count(); ++i)
+        {
+            if (!planner.is_live(i))
+                continue;
+            lowest = std::min(lowest, planner.load(i));
+            highest = std::max(highest, planner.load(i));
+        }
+        return highest - lowest;
+    }
+}
+
+int main()
+{
+    std::cout << "[TEST] Testing shard planner..." << std::endl;
+
+    // Test 1: New products go to the least loaded shard
+    {
+        ShardPlanner planner(3);
+        check(planner.assign("BTC-USD", 100.0) == 0, "first product on shard 0");
+        check(planner.assign("ETH-USD", 60.0) == 1, "second on the empty shard 1");
+        check(planner.assign("SOL-USD", 30.0) == 2, "third on the empty shard 2");
+        check(planner.assign("XRP-USD", 20.0) == 2, "fourth on the lightest");
+        check(planner.assign("BTC-USD", 5.0) == 0, "assign keeps an existing placement");
+        check(planner.load(0) == 100.0 && planner.load(2) == 50.0, "loads tracked");
+
+        planner.set_weight("XRP-USD", 40.0);
+        check(planner.load(2) == 70.0, "weight change moves the load");
+        planner.release("SOL-USD");
+        check(planner.load(2) == 40.0 && planner.products_on(2) == std::vector<std::string>{"XRP-USD"}, "release");
+    }
+
+    // Test 2: Equal weights spread by product count
+    {
+        ShardPlanner planner(4);
+        for (int i = 0; i < 10; ++i)
+            planner.assign("P" + std::to_string(i), 0.0);
+        size_t most = 0, least = 10;
+        for (size_t shard = 0; shard < 4; ++shard)
+        {
+            most = std::max(most, planner.products_on(shard).size());
+            least = std::min(least, planner.products_on(shard).size());
+        }
+        check(most - least <= 1, "unweighted products spread evenly");
+    }
+
+    // Test 3: A shard going down hands its products to the live ones
+    {
+        ShardPlanner planner(3);
+        for (int i = 0; i < 30; ++i)
+            planner.assign("P" + std::to_string(i), 1.0 + i % 5);
+
+        auto orphans = planner.products_on(1);
+        auto moves = planner.set_live(1, false);
+        check(moves.size() == orphans.size(), "every product moved");
+        check(std::all_of(moves.begin(), moves.end(), [](const ShardPlanner::Move &m)
+                          { return m.from == 1 && m.to != 1; }),
+              "moves leave the dead shard");
+        check(planner.products_on(1).empty() && planner.load(1) == 0.0, "dead shard empty");
+        check(planner.assign("NEW", 1.0) != 1, "no new products on a dead shard");
+
+        // Test 4: Coming back rebalances onto it
+        moves = planner.set_live(1, true);
+        check(!moves.empty(), "rebalance moves products back");
+        check(std::all_of(moves.begin(), moves.end(), [](const ShardPlanner::Move &m)
+                          { return m.to == 1; }),
+              "moves go to the returning shard");
+        double total = planner.load(0) + planner.load(1) + planner.load(2);
+        check(spread(planner) <= 0.25 * total / 3 + 5.0, "balanced within tolerance or one product");
+        check(planner.set_live(1, true).empty(), "no change, no moves");
+    }
+
+    // Test 5: All shards down keeps placements until one returns
+    {
+        ShardPlanner planner(2);
+        planner.assign("BTC-USD", 10.0);
+        planner.assign("ETH-USD", 10.0);
+        planner.set_live(0, false);
+        auto moves = planner.set_live(1, false);
+        check(moves.empty(), "nowhere to move");
+        size_t shard = 99;
+        check(planner.shard_of("ETH-USD", shard) && shard == 1, "placement kept");
+        planner.set_live(1, true);
+        check(planner.products_on(1).size() == 2, "returning shard serves everything left on it");
+    }
+
+    // Test 6: Rebalance does not thrash on a single heavy product
+    {
+        ShardPlanner planner(2);
+        planner.assign("BTC-USD", 1000.0);
+        planner.assign("ETH-USD", 1.0);
+        check(planner.rebalance().empty(), "nothing smaller than the gap helps");
+    }
+
+    return test_support::finish("Shard planner");
+}
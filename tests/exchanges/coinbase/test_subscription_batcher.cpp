@@ -0,0 +1,162 @@
+#include "coinbase_dtc_core/exchanges/coinbase/subscription_batcher.hpp"
+#include "test_support.hpp"
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+using open_dtc_server::exchanges::coinbase::SubscriptionBatcher;
+using Clock = SubscriptionBatcher::Clock;
+using std::chrono::milliseconds;
+using test_support::check;
+
+namespace
+{
+    std::string product(int i)
+    {
+        return "P" + std::to_string(i) + "-USD";
+    }
+
+    size_t product_count(const std::vector<SubscriptionBatcher::Request> &requests)
+    {
+        size_t count = 0;
+        for (const auto &request : requests)
+            count += request.product_ids.size();
+        return count;
+    }
+}
+
+int main()
+{
+    std::cout << "[TEST] Testing subscription batcher..." << std::endl;
+
+    auto t0 = Clock::now();
+
+    // Test 1: Intents within the window go out as one message per channel
+    {
+        SubscriptionBatcher batcher;
+        for (int i = 0; i < 100; ++i)
+            batcher.subscribe("ticker", product(i), t0 + milliseconds(i % 10));
+        batcher.subscribe("level2", "BTC-USD", t0);
+
+        check(batcher.poll(t0 + milliseconds(10)).empty(), "nothing before the window closes");
+        check(batcher.next_due() == t0 + milliseconds(50), "due when the window closes");
+
+        auto requests = batcher.poll(t0 + milliseconds(50));
+        check(requests.size() == 2, "one message per channel");
+        check(product_count(requests) == 101, "every product sent once");
+        check(!batcher.has_pending() && batcher.next_due() == Clock::time_point::max(), "nothing left");
+
+        // Growing the subscription sends only the new product
+        batcher.subscribe("ticker", product(100), t0 + milliseconds(100));
+        batcher.subscribe("ticker", product(5), t0 + milliseconds(100));
+        requests = batcher.poll(t0 + milliseconds(150));
+        check(requests.size() == 1 && requests[0].subscribe && requests[0].product_ids.size() == 1 &&
+                  requests[0].product_ids[0] == product(100),
+              "delta subscribe");
+        check(batcher.wanted("ticker").size() == 101, "wanted set");
+    }
+
+    // Test 2: Intents that cancel out send nothing; removals are minimal
+    {
+        SubscriptionBatcher batcher;
+        batcher.subscribe("ticker", "BTC-USD", t0);
+        batcher.subscribe("ticker", "ETH-USD", t0);
+        batcher.poll(t0 + milliseconds(50));
+
+        batcher.subscribe("ticker", "SOL-USD", t0 + milliseconds(100));
+        batcher.unsubscribe("ticker", "SOL-USD", t0 + milliseconds(110));
+        check(batcher.poll(t0 + milliseconds(200)).empty(), "subscribe then unsubscribe cancels");
+
+        batcher.unsubscribe("ticker", "ETH-USD", t0 + milliseconds(300));
+        auto requests = batcher.poll(t0 + milliseconds(350));
+        check(requests.size() == 1 && !requests[0].subscribe && requests[0].product_ids == std::vector<std::string>{"ETH-USD"},
+              "single unsubscribe");
+        check(batcher.is_wanted("ticker", "BTC-USD") && !batcher.is_wanted("ticker", "ETH-USD"), "wanted after unsubscribe");
+    }
+
+    // Test 3: Messages stay under the size limit
+    {
+        SubscriptionBatcher::Limits limits;
+        limits.max_message_bytes = 2048;
+        limits.max_messages_per_second = 1000;
+        SubscriptionBatcher batcher(limits);
+        for (int i = 0; i < 1000; ++i)
+            batcher.subscribe("level2", product(i), t0);
+
+        auto requests = batcher.poll(t0 + milliseconds(50));
+        check(requests.size() > 1, "large subscription split");
+        std::set<std::string> seen;
+        bool within = true;
+        for (const auto &request : requests)
+        {
+            size_t bytes = limits.message_overhead_bytes + request.channel.size();
+            for (const auto &id : request.product_ids)
+            {
+                bytes += id.size() + 3;
+                seen.insert(id);
+            }
+            within = within && bytes <= limits.max_message_bytes;
+        }
+        check(within, "every message within max_message_bytes");
+        check(seen.size() == 1000 && product_count(requests) == 1000, "every product exactly once");
+    }
+
+    // Test 4: Rate limit holds messages back to the next second
+    {
+        SubscriptionBatcher::Limits limits;
+        limits.max_message_bytes = limits.message_overhead_bytes + 64; // A few products per message
+        limits.max_messages_per_second = 4;
+        SubscriptionBatcher batcher(limits);
+        for (int i = 0; i < 40; ++i)
+            batcher.subscribe("ticker", product(i), t0);
+
+        auto first = batcher.poll(t0 + milliseconds(50));
+        check(first.size() == 4, "first second sends the limit");
+        check(batcher.has_pending(), "rest held back");
+        check(batcher.next_due() == t0 + milliseconds(1050), "due when the oldest send leaves the window");
+        check(batcher.poll(t0 + milliseconds(500)).empty(), "still limited within the second");
+
+        size_t sent = product_count(first);
+        size_t messages = first.size();
+        auto now = t0 + milliseconds(1050);
+        while (batcher.has_pending())
+        {
+            auto requests = batcher.poll(now);
+            check(requests.size() <= 4, "never more than the limit per second");
+            sent += product_count(requests);
+            messages += requests.size();
+            now = batcher.next_due() == Clock::time_point::max() ? now : batcher.next_due();
+        }
+        check(sent == 40, "everything sent eventually");
+        check(batcher.messages_sent() == messages, "messages counted");
+    }
+
+    // Test 5: Refresh, drop and reset
+    {
+        SubscriptionBatcher batcher;
+        batcher.subscribe("level2", "BTC-USD", t0);
+        batcher.subscribe("level2", "ETH-USD", t0);
+        batcher.poll(t0 + milliseconds(50));
+
+        batcher.refresh("level2", "BTC-USD", t0 + milliseconds(100));
+        auto requests = batcher.poll(t0 + milliseconds(150));
+        check(requests.size() == 2 && !requests[0].subscribe && requests[1].subscribe &&
+                  requests[0].product_ids == std::vector<std::string>{"BTC-USD"} &&
+                  requests[1].product_ids == std::vector<std::string>{"BTC-USD"},
+              "refresh is unsubscribe then subscribe");
+
+        batcher.refresh("level2", "XRP-USD", t0 + milliseconds(200));
+        check(batcher.poll(t0 + milliseconds(250)).empty(), "refresh of an unwanted product is ignored");
+
+        batcher.drop("level2", "ETH-USD");
+        check(!batcher.is_wanted("level2", "ETH-USD"), "dropped product forgotten");
+
+        batcher.reset(t0 + milliseconds(300));
+        requests = batcher.poll(t0 + milliseconds(350));
+        check(requests.size() == 1 && requests[0].subscribe && requests[0].product_ids == std::vector<std::string>{"BTC-USD"},
+              "reset resends what is wanted");
+    }
+
+    return test_support::finish("Subscription batcher");
+}
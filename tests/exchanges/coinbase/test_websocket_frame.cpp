@@ -0,0 +1,217 @@
+#include "coinbase_dtc_core/exchanges/coinbase/websocket_frame.hpp"
+#include "test_support.hpp"
+#include <cstring>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace open_dtc_server::feed::coinbase;
+using test_support::check;
+
+namespace
+{
+    /** A frame as a server sends it: unmasked unless a key is given */
+    std::vector<uint8_t> frame(uint8_t first_byte, const std::string &payload, const uint8_t *key = nullptr)
+    {
+        std::vector<uint8_t> out{first_byte};
+        uint8_t mask_bit = key ? 0x80 : 0x00;
+        if (payload.size() < 126)
+        {
+            out.push_back(static_cast<uint8_t>(mask_bit | payload.size()));
+        }
+        else if (payload.size() <= 0xFFFF)
+        {
+            out.push_back(mask_bit | 126);
+            out.push_back(static_cast<uint8_t>(payload.size() >> 8));
+            out.push_back(static_cast<uint8_t>(payload.size()));
+        }
+        else
+        {
+            out.push_back(mask_bit | 127);
+            for (int i = 7; i >= 0; --i)
+                out.push_back(static_cast<uint8_t>(static_cast<uint64_t>(payload.size()) >> (8 * i)));
+        }
+        if (key)
+            out.insert(out.end(), key, key + 4);
+        for (size_t i = 0; i < payload.size(); ++i)
+            out.push_back(static_cast<uint8_t>(payload[i]) ^ (key ? key[i % 4] : 0));
+        return out;
+    }
+
+    void feed(FrameReader &reader, const std::vector<uint8_t> &bytes)
+    {
+        reader.append(bytes.data(), bytes.size());
+    }
+
+    bool next_is(FrameReader &reader, WebSocketOpcode opcode, const std::string &payload, bool compressed = false)
+    {
+        FrameReader::Message message;
+        return reader.next(message) == FrameReader::Status::MESSAGE && message.opcode == opcode &&
+               message.compressed == compressed && message.text() == payload;
+    }
+
+    std::string ticker(int i)
+    {
+        return "{\"type\":\"ticker\",\"sequence\":" + std::to_string(1000 + i) + ",\"product_id\":\"BTC-USD\"}";
+    }
+}
+
+int main()
+{
+    std::cout << "[TEST] Testing WebSocket frames..." << std::endl;
+
+    // Test 1: Vector masking matches byte-by-byte XOR at every length and alignment
+    {
+        const uint8_t key[4] = {0x37, 0xfa, 0x21, 0x3d};
+        bool all_equal = true;
+        std::vector<uint8_t> storage(300);
+        for (size_t offset = 0; offset < 4; ++offset)
+        {
+            for (size_t size = 0; size < 200; ++size)
+            {
+                uint8_t *data = storage.data() + offset;
+                for (size_t i = 0; i < size; ++i)
+                    data[i] = static_cast<uint8_t>(i * 7 + offset);
+                mask_websocket_payload(data, size, key);
+                for (size_t i = 0; i < size; ++i)
+                    all_equal = all_equal && data[i] == (static_cast<uint8_t>(i * 7 + offset) ^ key[i % 4]);
+            }
+        }
+        check(all_equal, "masking matches the scalar definition");
+    }
+
+    // Test 2: Whole frames, all length encodings, masked or not
+    {
+        FrameReader reader(64);
+        const uint8_t key[4] = {1, 2, 3, 4};
+        std::string medium(300, 'm'), large(70000, 'L');
+        feed(reader, frame(0x81, ticker(1)));
+        feed(reader, frame(0x81, medium, key));
+        feed(reader, frame(0xC1, large));
+        feed(reader, frame(0x82, "\x01\x02"));
+
+        check(next_is(reader, WebSocketOpcode::TEXT, ticker(1)), "short text frame");
+        check(next_is(reader, WebSocketOpcode::TEXT, medium), "16-bit length, unmasked in place");
+        check(next_is(reader, WebSocketOpcode::TEXT, large, true), "64-bit length with RSV1");
+        check(next_is(reader, WebSocketOpcode::BINARY, "\x01\x02"), "binary frame");
+
+        FrameReader::Message message;
+        check(reader.next(message) == FrameReader::Status::NEED_MORE && reader.buffered() == 0, "drained");
+    }
+
+    // Test 3: Byte-at-a-time input through write_space/commit
+    {
+        FrameReader reader(16);
+        auto bytes = frame(0x81, ticker(2));
+        auto second = frame(0x81, ticker(3));
+        bytes.insert(bytes.end(), second.begin(), second.end());
+
+        std::vector<std::string> received;
+        FrameReader::Message message;
+        for (uint8_t byte : bytes)
+        {
+            size_t available = 0;
+            uint8_t *space = reader.write_space(1, available);
+            check(available >= 1, "write space");
+            *space = byte;
+            reader.commit(1);
+            while (reader.next(message) == FrameReader::Status::MESSAGE)
+                received.emplace_back(message.text());
+        }
+        check(received.size() == 2 && received[0] == ticker(2) && received[1] == ticker(3), "partial frames reassembled");
+        check(reader.capacity() == 16 || reader.capacity() < bytes.size(), "buffer compacts instead of growing with the stream");
+    }
+
+    // Test 4: Fragmented message with a ping between its fragments
+    {
+        FrameReader reader;
+        feed(reader, frame(0x41, "{\"type\":")); // TEXT, RSV1, not final
+        feed(reader, frame(0x00, "\"ticker\","));
+        feed(reader, frame(0x89, "keepalive")); // PING
+        feed(reader, frame(0x80, "\"sequence\":7}"));
+        feed(reader, frame(0x81, ticker(4)));
+
+        check(next_is(reader, WebSocketOpcode::PING, "keepalive"), "control frame returned mid-message");
+        check(next_is(reader, WebSocketOpcode::TEXT, "{\"type\":\"ticker\",\"sequence\":7}", true),
+              "fragments joined, RSV1 and opcode from the first");
+        check(next_is(reader, WebSocketOpcode::TEXT, ticker(4)), "next message after reassembly");
+    }
+
+    // Test 5: Fragmented message arriving in pieces, compacted between reads
+    {
+        FrameReader reader(32);
+        std::string part(40, 'a'), rest(25, 'b');
+        auto bytes = frame(0x01, part);
+        auto last = frame(0x80, rest);
+        bytes.insert(bytes.end(), last.begin(), last.end());
+
+        bool done = false;
+        FrameReader::Message message;
+        for (size_t i = 0; i < bytes.size(); i += 5)
+        {
+            reader.append(bytes.data() + i, std::min<size_t>(5, bytes.size() - i));
+            if (reader.next(message) == FrameReader::Status::MESSAGE)
+                done = message.text() == part + rest;
+        }
+        check(done, "fragments survive buffer moves");
+    }
+
+    // Test 6: Protocol errors
+    {
+        auto fails = [](const std::vector<uint8_t> &bytes)
+        {
+            FrameReader reader(64, 1024);
+            reader.append(bytes.data(), bytes.size());
+            FrameReader::Message message;
+            return reader.next(message) == FrameReader::Status::PROTOCOL_ERROR && !reader.error().empty();
+        };
+        check(fails(frame(0x80, "orphan")), "continuation without a message");
+        check(fails(frame(0x09, "ping")), "fragmented control frame");
+        check(fails(frame(0x89, std::string(126, 'p'))), "oversized control frame");
+        check(fails(frame(0x83, "x")), "reserved opcode");
+        check(fails(frame(0xA1, "x")), "RSV2 set");
+        check(fails({0x81, 0x7F, 0, 0, 0, 0, 0, 1, 0, 0}), "message over the limit, before its payload");
+
+        FrameReader reader;
+        feed(reader, frame(0x01, "first"));
+        feed(reader, frame(0x81, "second"));
+        FrameReader::Message message;
+        check(reader.next(message) == FrameReader::Status::PROTOCOL_ERROR, "new message inside a fragmented one");
+        reader.reset();
+        feed(reader, frame(0x81, ticker(5)));
+        check(next_is(reader, WebSocketOpcode::TEXT, ticker(5)), "usable after reset");
+    }
+
+    // Test 7: Writer output parses back, keys differ
+    {
+        FrameWriter writer(8);
+        FrameReader reader;
+        std::set<uint32_t> keys;
+        for (size_t size : {0, 5, 125, 126, 1000, 65535, 65536, 100000})
+        {
+            std::string payload(size, 'x');
+            for (size_t i = 0; i < size; ++i)
+                payload[i] = static_cast<char>('a' + i % 26);
+
+            std::string_view built = writer.build(WebSocketOpcode::TEXT, payload.data(), payload.size());
+            const auto *bytes = reinterpret_cast<const uint8_t *>(built.data());
+            check((bytes[1] & 0x80) != 0, "client frames are masked");
+            size_t header = size < 126 ? 2 : size <= 0xFFFF ? 4
+                                                            : 10;
+            uint32_t key;
+            std::memcpy(&key, bytes + header, 4);
+            keys.insert(key);
+
+            reader.append(bytes, built.size());
+            check(next_is(reader, WebSocketOpcode::TEXT, payload), "round trip of " + std::to_string(size) + " bytes");
+        }
+        check(keys.size() > 4, "masking keys vary");
+
+        std::string_view pong = writer.build(WebSocketOpcode::PONG, "keepalive", 9);
+        reader.append(reinterpret_cast<const uint8_t *>(pong.data()), pong.size());
+        check(next_is(reader, WebSocketOpcode::PONG, "keepalive"), "pong round trip");
+    }
+
+    return test_support::finish("WebSocket frame");
+}
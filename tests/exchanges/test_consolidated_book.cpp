@@ -0,0 +1,133 @@
+#include "coinbase_dtc_core/exchanges/base/consolidated_book.hpp"
+#include "test_support.hpp"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace open_dtc_server::exchanges::base;
+using test_support::check;
+
+namespace
+{
+    MarketDepthUpdate make_update(const std::string &exchange, bool is_bid, double price, double size)
+    {
+        MarketDepthUpdate update;
+        update.instrument = SymbolRegistry::getInstance().intern(exchange, "BTC/USD", "BTC/USD");
+        update.is_bid = is_bid;
+        update.price = price;
+        update.size = size;
+        update.exchange_time_us = 1700000000000000ULL;
+        return update;
+    }
+}
+
+int main()
+{
+    std::cout << "[TEST] Testing consolidated order book..." << std::endl;
+
+    ConsolidatedBook consolidated;
+    std::vector<MarketDepthUpdate> depth_events;
+    std::vector<MarketLevel2> bbo_events;
+    consolidated.set_depth_callback([&](const MarketDepthUpdate &update)
+                                    { depth_events.push_back(update); });
+    consolidated.set_level2_callback([&](const MarketLevel2 &bbo)
+                                     { bbo_events.push_back(bbo); });
+    const InstrumentId merged_btc = SymbolRegistry::getInstance().intern(CONSOLIDATED_EXCHANGE, "BTC/USD", "BTC/USD");
+
+    // Test 0: Nothing merges without a consolidated subscriber
+    {
+        consolidated.apply(make_update("coinbase", true, 100.0, 1.0));
+        MarketLevel2 bbo;
+        check(depth_events.empty() && bbo_events.empty(), "untracked symbol publishes nothing");
+        check(!consolidated.get_best_bid_offer("BTC/USD", bbo), "untracked symbol has no book");
+        consolidated.track(merged_btc);
+        std::cout << "[OK] Untracked symbols" << std::endl;
+    }
+
+    // Test 1: Snapshot from one exchange seeds the merged book
+    {
+        auto book = std::make_shared<OrderBook>();
+        book->load(BookSide::BID, {{100.0, 1.0}, {99.0, 2.0}});
+        book->load(BookSide::ASK, {{101.0, 1.5}});
+
+        auto snapshot = make_update("coinbase", true, 0.0, 0.0);
+        snapshot.action = MarketDepthUpdate::Action::SNAPSHOT;
+        snapshot.book = book;
+        consolidated.apply(snapshot);
+
+        check(depth_events.size() == 1 && depth_events[0].action == MarketDepthUpdate::Action::SNAPSHOT, "snapshot published");
+        const Instrument *merged = SymbolRegistry::getInstance().get(depth_events[0].instrument);
+        check(merged && merged->exchange == CONSOLIDATED_EXCHANGE && merged->symbol == "BTC/USD", "published as CONSOLIDATED");
+        check(bbo_events.size() == 1 && bbo_events[0].bid_price == 100.0 && bbo_events[0].ask_price == 101.0, "initial BBO");
+        std::cout << "[OK] Snapshot" << std::endl;
+    }
+
+    // Test 2: Same price on a second exchange sums; only that level is republished
+    {
+        depth_events.clear();
+        bbo_events.clear();
+        consolidated.apply(make_update("kraken", true, 100.0, 0.5));
+        check(depth_events.size() == 1, "one consolidated delta");
+        check(depth_events[0].delta.type == BookDelta::Type::UPDATE && depth_events[0].delta.position == 0, "top bid updated in place");
+        check(depth_events[0].size == 1.5, "sizes summed across exchanges");
+        check(bbo_events.size() == 1 && bbo_events[0].bid_size == 1.5, "BBO size follows");
+
+        // A better ask elsewhere becomes the consolidated offer
+        consolidated.apply(make_update("kraken", false, 100.5, 2.0));
+        MarketLevel2 bbo;
+        check(consolidated.get_best_bid_offer("BTC/USD", bbo) && bbo.ask_price == 100.5 && bbo.ask_size == 2.0, "cross-exchange best offer");
+
+        // A deep change does not move the BBO
+        bbo_events.clear();
+        consolidated.apply(make_update("kraken", true, 95.0, 1.0));
+        check(bbo_events.empty(), "deep change leaves BBO alone");
+        std::cout << "[OK] Incremental merge" << std::endl;
+    }
+
+    // Test 3: Removing liquidity from one exchange leaves the other's
+    {
+        depth_events.clear();
+        consolidated.apply(make_update("coinbase", true, 100.0, 0.0));
+        auto bids = consolidated.get_depth("BTC/USD", BookSide::BID, 5);
+        check(!bids.empty() && bids[0].price == 100.0 && bids[0].size == 0.5, "kraken size remains");
+
+        consolidated.apply(make_update("kraken", true, 100.0, 0.0));
+        bids = consolidated.get_depth("BTC/USD", BookSide::BID, 5);
+        check(!bids.empty() && bids[0].price == 99.0, "level gone once both exchanges pull");
+        check(depth_events.back().delta.type == BookDelta::Type::DELETE, "delete published");
+
+        consolidated.remove_exchange("kraken");
+        MarketLevel2 bbo;
+        check(consolidated.get_best_bid_offer("BTC/USD", bbo) && bbo.ask_price == 101.0, "offer falls back after exchange removal");
+        std::cout << "[OK] Liquidity removal" << std::endl;
+    }
+
+    // Test 4: The last subscriber drops the books; the next one seeds from the book source
+    {
+        consolidated.untrack(merged_btc);
+        MarketLevel2 bbo;
+        check(!consolidated.get_best_bid_offer("BTC/USD", bbo), "books dropped with the last subscriber");
+
+        // Source already holds the triggering change, as the depth distributor does
+        consolidated.set_book_source([](InstrumentId instrument, OrderBook &book)
+                                     {
+                                         if (SymbolRegistry::getInstance().exchange(instrument) != "coinbase")
+                                             return false;
+                                         book.load(BookSide::BID, {{100.0, 1.0}, {99.0, 2.0}});
+                                         book.load(BookSide::ASK, {{101.0, 3.0}});
+                                         return true; });
+        consolidated.track(merged_btc);
+        depth_events.clear();
+        consolidated.apply(make_update("coinbase", false, 101.0, 3.0));
+        check(depth_events.size() == 1 && depth_events[0].action == MarketDepthUpdate::Action::SNAPSHOT, "seeding publishes a snapshot");
+        check(consolidated.get_best_bid_offer("BTC/USD", bbo) && bbo.bid_price == 100.0 && bbo.ask_size == 3.0, "seeded from source book");
+
+        // Later changes apply as deltas on the seeded book
+        consolidated.apply(make_update("coinbase", true, 100.0, 4.0));
+        check(depth_events.size() == 2 && depth_events[1].size == 4.0, "delta after seeding");
+        std::cout << "[OK] Tracking and seeding" << std::endl;
+    }
+
+    return test_support::finish("Consolidated book");
+}
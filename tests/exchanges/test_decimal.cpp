@@ -0,0 +1,101 @@
+#include "coinbase_dtc_core/exchanges/base/decimal.hpp"
+#include "test_support.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+using namespace open_dtc_server::exchanges::base;
+using test_support::check;
+
+namespace
+{
+    bool parses_to(const char *text, double expected)
+    {
+        double value = -1.0;
+        return decimal::parse_decimal(text, value) && value == expected;
+    }
+
+    bool fixed_to(const char *text, int scale, int64_t expected)
+    {
+        int64_t value = -1;
+        return decimal::parse_fixed(text, scale, value) && value == expected;
+    }
+}
+
+int main()
+{
+    std::cout << "[TEST] Testing decimal parsing..." << std::endl;
+
+    // Exchange-style decimals
+    {
+        check(parses_to("43250.12", 43250.12), "price");
+        check(parses_to("0.00000001", 0.00000001), "satoshi");
+        check(parses_to("0", 0.0), "zero");
+        check(parses_to("-1.5", -1.5), "negative");
+        check(parses_to("+2.25", 2.25), "explicit plus");
+        check(parses_to("100", 100.0), "integer");
+        check(parses_to("1.", 1.0) && parses_to(".5", 0.5), "bare point");
+        check(parses_to("1e-8", 1e-8) && parses_to("2.5E3", 2500.0), "exponent falls back");
+        check(parses_to("123456789012345678901234", 123456789012345678901234.0), "long mantissa falls back");
+        std::cout << "[OK] Decimal values" << std::endl;
+    }
+
+    // Malformed input never throws and is rejected whole
+    {
+        double value = 7.0;
+        check(!decimal::parse_decimal("", value), "empty");
+        check(!decimal::parse_decimal("-", value) && !decimal::parse_decimal(".", value), "sign or point alone");
+        check(!decimal::parse_decimal("1.5x", value), "trailing garbage");
+        check(!decimal::parse_decimal("1.2.3", value), "two points");
+        check(!decimal::parse_decimal(" 1", value), "leading space");
+        check(value == 7.0, "value untouched on failure");
+        check(decimal::parse_decimal_or("", 1.0) == 1.0 && decimal::parse_decimal_or("abc", 2.0) == 2.0, "fallback");
+        std::cout << "[OK] Malformed input" << std::endl;
+    }
+
+    // Correctly rounded: agrees bit for bit with strtod on random exchange-shaped decimals
+    {
+        std::mt19937_64 rng(42);
+        int mismatches = 0;
+        char text[64];
+        for (int i = 0; i < 200000; ++i)
+        {
+            uint64_t integer = rng() % 10000000;
+            int places = static_cast<int>(rng() % 11);
+            uint64_t fraction = places ? rng() % static_cast<uint64_t>(decimal::detail::POW10_INT[places]) : 0;
+            if (places)
+                std::snprintf(text, sizeof(text), "%llu.%0*llu", static_cast<unsigned long long>(integer), places,
+                              static_cast<unsigned long long>(fraction));
+            else
+                std::snprintf(text, sizeof(text), "%llu", static_cast<unsigned long long>(integer));
+
+            double value = 0.0;
+            if (!decimal::parse_decimal(text, value) || value != std::strtod(text, nullptr))
+                mismatches++;
+        }
+        check(mismatches == 0, "parse_decimal matches strtod (" + std::to_string(mismatches) + " mismatches)");
+        std::cout << "[OK] Rounding matches strtod" << std::endl;
+    }
+
+    // Fixed point
+    {
+        check(fixed_to("43250.12", 8, 4325012000000LL), "price at 1e-8");
+        check(fixed_to("0.00000001", 8, 1), "one satoshi");
+        check(fixed_to("-1.5", 2, -150), "negative");
+        check(fixed_to("7", 0, 7), "integer at scale 0");
+        check(fixed_to("1.50000000000", 2, 150), "trailing zeros beyond scale");
+
+        int64_t value = 0;
+        check(!decimal::parse_fixed("0.001", 2, value), "precision loss rejected");
+        check(!decimal::parse_fixed("92233720368.54775808", 8, value), "overflow rejected");
+        check(decimal::parse_fixed("92233720368.54775807", 8, value) && value == INT64_MAX, "int64 max");
+        check(!decimal::parse_fixed("1e5", 2, value) && !decimal::parse_fixed("", 2, value), "malformed rejected");
+        check(decimal::fixed_to_double(4325012000000LL, 8) == 43250.12, "back to double");
+        std::cout << "[OK] Fixed point" << std::endl;
+    }
+
+    return test_support::finish("Decimal");
+}
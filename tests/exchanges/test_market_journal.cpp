@@ -0,0 +1,205 @@
+#include "coinbase_dtc_core/exchanges/base/market_journal.hpp"
+#include "test_support.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace open_dtc_server::exchanges::base;
+using test_support::check;
+
+namespace
+{
+    MarketTrade make_trade(double price)
+    {
+        MarketTrade trade;
+        trade.instrument = SymbolRegistry::getInstance().intern("coinbase", "BTC-USD", "BTC/USD");
+        trade.price = price;
+        trade.volume = 0.5;
+        trade.side = TradeSide::SELL;
+        trade.exchange_time_us = 1700000000000000ULL;
+        return trade;
+    }
+
+    JournalConfig make_config(const std::string &directory, uint64_t records_per_segment, size_t retain)
+    {
+        JournalConfig config;
+        config.directory = directory;
+        config.records_per_segment = records_per_segment;
+        config.retain_segments = retain;
+        config.sync_policy = JournalConfig::SyncPolicy::NONE;
+        return config;
+    }
+}
+
+int main()
+{
+    std::cout << "[TEST] Testing market data journal..." << std::endl;
+
+    auto root = std::filesystem::temp_directory_path() / "test_market_journal";
+    std::filesystem::remove_all(root);
+
+#ifdef _WIN32
+    std::cout << "[SKIP] Memory-mapped journal is POSIX only" << std::endl;
+    return 0;
+#endif
+
+    // Test 1: Records roll across segments and are readable while the journal is open
+    {
+        MarketJournal journal(make_config((root / "roll").string(), 100, 0));
+        check(journal.open(), "journal opens");
+        for (int i = 0; i < 250; ++i)
+            journal.record_trade(make_trade(100.0 + i));
+
+        JournalReader reader((root / "roll").string());
+        std::vector<JournalRecord> records;
+        check(reader.poll(records) == 250, "reader sees all committed records");
+        bool ordered = true;
+        for (size_t i = 0; i < records.size(); ++i)
+            ordered = ordered && records[i].sequence == i + 1 && records[i].price == 100.0 + i;
+        check(ordered, "records in sequence order");
+        check(records[0].type == JournalRecord::TRADE && records[0].side == 2 && std::strcmp(records[0].symbol, "BTC-USD") == 0, "trade fields");
+        check(records[0].timestamp == 1700000000000000ULL, "exchange time in microseconds");
+
+        // Tail: only the new records are returned
+        journal.record_trade(make_trade(1.0));
+        records.clear();
+        check(reader.poll(records) == 1 && records[0].sequence == 251, "tail returns new record");
+        records.clear();
+        check(reader.poll(records) == 0, "nothing new");
+
+        journal.close();
+        check(JournalReader::list_segments((root / "roll").string()).size() == 3, "three segments, none left mapped ahead");
+        std::cout << "[OK] Segment roll and tailing" << std::endl;
+    }
+
+    // Test 2: Reopening continues the sequence in a new segment
+    {
+        MarketJournal journal(make_config((root / "roll").string(), 100, 0));
+        journal.open();
+        check(journal.get_next_sequence() == 252, "sequence continues after reopen");
+        journal.record_trade(make_trade(2.0));
+
+        JournalReader reader((root / "roll").string());
+        std::vector<JournalRecord> records;
+        check(reader.poll(records) == 252 && records.back().sequence == 252, "reader crosses the partial segment");
+        std::cout << "[OK] Reopen" << std::endl;
+    }
+
+    // Test 3: Retention deletes the oldest segments
+    {
+        MarketJournal journal(make_config((root / "retain").string(), 10, 2));
+        journal.open();
+        for (int i = 0; i < 45; ++i)
+            journal.record_trade(make_trade(i));
+        journal.close();
+
+        auto segments = JournalReader::list_segments((root / "retain").string());
+        check(segments.size() == 2, "two segments retained");
+
+        JournalReader reader((root / "retain").string());
+        std::vector<JournalRecord> records;
+        reader.poll(records);
+        check(records.size() == 15 && records.front().sequence == 31, "reader starts at oldest retained segment");
+        std::cout << "[OK] Retention" << std::endl;
+    }
+
+    // Test 3b: The segment mapped ahead is not read before the writer reaches it
+    {
+        const std::string directory = (root / "ahead").string();
+        MarketJournal journal(make_config(directory, 100, 0));
+        journal.open();
+        for (int i = 0; i < 50; ++i)
+            journal.record_trade(make_trade(i));
+        for (int wait = 0; wait < 200 && JournalReader::list_segments(directory).size() < 2; ++wait)
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        check(JournalReader::list_segments(directory).size() == 2, "next segment mapped ahead");
+
+        JournalReader reader(directory);
+        std::vector<JournalRecord> records;
+        check(reader.poll(records) == 50, "half-full segment read");
+        for (int i = 50; i < 160; ++i)
+            journal.record_trade(make_trade(i));
+        check(reader.poll(records) == 110, "reader stays until the segment is full");
+        bool contiguous = true;
+        for (size_t i = 0; i < records.size(); ++i)
+            contiguous = contiguous && records[i].sequence == i + 1;
+        check(records.size() == 160 && contiguous, "no records skipped across the roll");
+        check(journal.get_dropped_records() == 0, "roll never dropped");
+        std::cout << "[OK] Segment mapped ahead" << std::endl;
+    }
+
+    // Test 4: Book snapshots, deltas and quotes
+    {
+        MarketJournal journal(make_config((root / "book").string(), 1000, 0));
+        journal.open();
+
+        auto book = std::make_shared<OrderBook>();
+        book->load(BookSide::BID, {{99.0, 1.0}, {100.0, 2.0}});
+        book->load(BookSide::ASK, {{101.0, 3.0}});
+
+        InstrumentId eth = SymbolRegistry::getInstance().intern("coinbase", "ETH-USD", "ETH/USD");
+
+        MarketDepthUpdate snapshot;
+        snapshot.instrument = eth;
+        snapshot.action = MarketDepthUpdate::Action::SNAPSHOT;
+        snapshot.book = book;
+        journal.record_depth(snapshot);
+
+        MarketDepthUpdate set;
+        set.instrument = eth;
+        set.is_bid = false;
+        set.price = 101.0;
+        set.size = 0.0;
+        set.delta = book->apply(BookSide::ASK, 101.0, 0.0);
+        journal.record_depth(set);
+
+        MarketLevel2 quote;
+        quote.instrument = eth;
+        quote.bid_price = 100.0;
+        quote.ask_price = 102.0;
+        journal.record_level2(quote);
+
+        JournalReader reader((root / "book").string());
+        std::vector<JournalRecord> records;
+        reader.poll(records);
+        check(records.size() == 7, "reset + 3 levels + delta + 2 quotes");
+        check(records[0].type == JournalRecord::BOOK_RESET, "snapshot starts with reset");
+        check(records[1].type == JournalRecord::BOOK_LEVEL && records[1].price == 100.0 && records[1].position == 0, "best bid level");
+        check(records[4].type == JournalRecord::BOOK_DELTA && records[4].delta_type == static_cast<uint8_t>(BookDelta::Type::DELETE), "delta type");
+        check(records[6].type == JournalRecord::QUOTE && records[6].side == static_cast<uint8_t>(BookSide::ASK) && records[6].price == 102.0, "ask quote");
+        std::cout << "[OK] Book records" << std::endl;
+    }
+
+    // Test 5: Version 1 segments kept milliseconds; the reader scales them
+    {
+        {
+            MarketJournal journal(make_config((root / "v1").string(), 10, 0));
+            journal.open();
+            MarketTrade trade = make_trade(1.0);
+            trade.exchange_time_us = 1700000000000ULL;
+            journal.record_trade(trade);
+        }
+
+        auto segments = JournalReader::list_segments((root / "v1").string());
+        std::fstream segment(segments.front(), std::ios::binary | std::ios::in | std::ios::out);
+        uint32_t version = 1;
+        segment.seekp(offsetof(JournalSegmentHeader, version));
+        segment.write(reinterpret_cast<const char *>(&version), sizeof(version));
+        segment.close();
+
+        JournalReader reader((root / "v1").string());
+        std::vector<JournalRecord> records;
+        check(reader.poll(records) == 1 && records[0].timestamp == 1700000000000000ULL, "version 1 read as microseconds");
+        std::cout << "[OK] Version 1 segments" << std::endl;
+    }
+
+    std::filesystem::remove_all(root);
+
+    return test_support::finish("Market journal");
+}
@@ -0,0 +1,195 @@
+#include "coinbase_dtc_core/exchanges/replay/replay_feed.hpp"
+#include "coinbase_dtc_core/exchanges/factory/exchange_factory.hpp"
+#include "coinbase_dtc_core/exchanges/base/market_journal.hpp"
+#include "test_support.hpp"
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+using namespace open_dtc_server::exchanges;
+using test_support::check;
+
+namespace
+{
+    // Ten trades 100 ms apart, one quote and a book snapshot plus delta for BTC-USD; one ETH-USD trade
+    void record_session(const std::string &directory)
+    {
+        base::JournalConfig config;
+        config.directory = directory;
+        config.records_per_segment = 8;
+        config.sync_policy = base::JournalConfig::SyncPolicy::NONE;
+        base::MarketJournal journal(config);
+        journal.open();
+
+        const uint64_t start = 1700000000000000ULL; // Microseconds
+        auto book = std::make_shared<base::OrderBook>();
+        book->load(base::BookSide::BID, {{99.0, 1.0}});
+        book->load(base::BookSide::ASK, {{101.0, 1.0}});
+
+        auto &registry = base::SymbolRegistry::getInstance();
+        base::InstrumentId btc = registry.intern("coinbase", "BTC-USD", "BTC/USD");
+
+        base::MarketDepthUpdate snapshot;
+        snapshot.instrument = btc;
+        snapshot.action = base::MarketDepthUpdate::Action::SNAPSHOT;
+        snapshot.exchange_time_us = start;
+        snapshot.book = book;
+        journal.record_depth(snapshot);
+
+        for (int i = 0; i < 10; ++i)
+        {
+            base::MarketTrade trade;
+            trade.instrument = btc;
+            trade.price = 100.0 + i;
+            trade.volume = 1.0;
+            trade.side = base::TradeSide::BUY;
+            trade.exchange_time_us = start + i * 100000;
+            journal.record_trade(trade);
+        }
+
+        base::MarketLevel2 quote;
+        quote.instrument = btc;
+        quote.bid_price = 99.0;
+        quote.bid_size = 1.0;
+        quote.ask_price = 101.0;
+        quote.ask_size = 2.0;
+        quote.exchange_time_us = start + 900000;
+        journal.record_level2(quote);
+
+        base::MarketDepthUpdate set;
+        set.instrument = btc;
+        set.is_bid = true;
+        set.price = 99.5;
+        set.size = 3.0;
+        set.exchange_time_us = start + 900000;
+        set.delta = book->apply(base::BookSide::BID, 99.5, 3.0);
+        journal.record_depth(set);
+
+        base::MarketTrade other;
+        other.instrument = registry.intern("coinbase", "ETH-USD", "ETH/USD");
+        other.price = 2000.0;
+        other.volume = 1.0;
+        other.exchange_time_us = start + 900000;
+        journal.record_trade(other);
+    }
+
+    struct Counts
+    {
+        int trades = 0;
+        int quotes = 0;
+        int snapshots = 0;
+        int deltas = 0;
+        double last_price = 0.0;
+        base::InstrumentId last_instrument = base::NO_INSTRUMENT;
+        uint64_t last_exchange_time_us = 0;
+        double ask_size = 0.0;
+        size_t snapshot_levels = 0;
+        base::BookDelta::Type delta_type = base::BookDelta::Type::NONE;
+    };
+
+    void attach(base::ExchangeFeedBase &feed, Counts &counts)
+    {
+        feed.set_trade_callback([&counts](const base::MarketTrade &trade)
+                                { counts.trades++; counts.last_price = trade.price; counts.last_instrument = trade.instrument; counts.last_exchange_time_us = trade.exchange_time_us; });
+        feed.set_level2_callback([&counts](const base::MarketLevel2 &level2)
+                                 { counts.quotes++; counts.ask_size = level2.ask_size; });
+        feed.set_depth_callback([&counts](const base::MarketDepthUpdate &update)
+                                {
+                                    if (update.action == base::MarketDepthUpdate::Action::SNAPSHOT)
+                                    {
+                                        counts.snapshots++;
+                                        counts.snapshot_levels = update.book->depth(base::BookSide::BID) + update.book->depth(base::BookSide::ASK);
+                                    }
+                                    else
+                                    {
+                                        counts.deltas++;
+                                        counts.delta_type = update.delta.type;
+                                    } });
+    }
+}
+
+int main()
+{
+    std::cout << "[TEST] Testing replay feed..." << std::endl;
+
+#ifdef _WIN32
+    std::cout << "[SKIP] Market journal is POSIX only" << std::endl;
+    return 0;
+#endif
+
+    auto root = std::filesystem::temp_directory_path() / "test_replay_feed";
+    std::filesystem::remove_all(root);
+    record_session(root.string());
+
+    base::ExchangeConfig config;
+    config.name = "replay";
+    config.replay_path = root.string();
+
+    // Test 1: As fast as possible, everything is emitted through the callbacks
+    {
+        config.replay_speed = 0.0;
+        replay::ReplayFeed feed(config);
+        Counts counts;
+        attach(feed, counts);
+
+        auto start = std::chrono::steady_clock::now();
+        check(feed.connect(), "replay connects");
+        check(feed.wait_until_finished(std::chrono::seconds(5)), "replay finishes");
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        check(counts.trades == 11 && counts.last_price == 2000.0, "all trades replayed");
+        const auto *instrument = base::SymbolRegistry::getInstance().get(counts.last_instrument);
+        check(instrument && instrument->exchange == "replay" && instrument->exchange_symbol == "ETH-USD", "replayed under the replay exchange");
+        check(counts.last_exchange_time_us == 1700000000900000ULL, "exchange time replayed");
+        check(counts.quotes == 1 && counts.ask_size == 2.0, "quote rebuilt from bid and ask records");
+        check(counts.snapshots == 1 && counts.snapshot_levels == 2, "snapshot rebuilt");
+        check(counts.deltas == 1 && counts.delta_type == base::BookDelta::Type::INSERT, "delta replayed");
+        check(elapsed < std::chrono::milliseconds(500), "no pacing at speed 0");
+        feed.disconnect();
+        std::cout << "[OK] Fast replay" << std::endl;
+    }
+
+    // Test 2: 10x speed keeps the 900 ms session spacing scaled down; subscriptions filter symbols
+    {
+        config.replay_speed = 10.0;
+        replay::ReplayFeed feed(config);
+        Counts counts;
+        attach(feed, counts);
+        feed.subscribe_trades("ETH-USD");
+
+        auto start = std::chrono::steady_clock::now();
+        feed.connect();
+        check(feed.wait_until_finished(std::chrono::seconds(5)), "paced replay finishes");
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        check(elapsed >= std::chrono::milliseconds(85), "replay is paced");
+        check(counts.trades == 1 && counts.snapshots == 0 && counts.quotes == 0, "only subscribed symbol replayed");
+        std::cout << "[OK] Paced replay" << std::endl;
+    }
+
+    // Test 3: Registered with the factory as "replay"
+    {
+        auto feed = factory::ExchangeFactory::create_feed(config);
+        check(feed && dynamic_cast<replay::ReplayFeed *>(feed.get()) != nullptr, "factory creates replay feed");
+        auto symbols = feed->get_available_symbols();
+        check(symbols.size() == 2, "journal symbols listed");
+        std::cout << "[OK] Factory registration" << std::endl;
+    }
+
+    // Test 4: Handlers only look products up; registering happens on subscribe or connect
+    {
+        replay::ReplayFeed feed(config);
+        auto &registry = base::SymbolRegistry::getInstance();
+        check(feed.instrument_for("DOGE-USD") == base::NO_INSTRUMENT, "unknown product has no instrument");
+        check(registry.find("replay", "DOGE-USD") == base::NO_INSTRUMENT, "lookup does not register");
+        feed.subscribe_trades("DOGE-USD");
+        auto doge = feed.instrument_for("DOGE-USD");
+        check(doge != base::NO_INSTRUMENT && registry.find("replay", "DOGE-USD") == doge, "subscribe registers");
+        std::cout << "[OK] Lookup-only instruments" << std::endl;
+    }
+
+    std::filesystem::remove_all(root);
+
+    return test_support::finish("Replay feed");
+}
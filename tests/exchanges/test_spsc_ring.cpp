@@ -0,0 +1,130 @@
+#include "coinbase_dtc_core/exchanges/base/spsc_ring.hpp"
+#include "coinbase_dtc_core/exchanges/base/exchange_feed.hpp"
+#include "test_support.hpp"
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace open_dtc_server::exchanges::base;
+using test_support::check;
+
+namespace
+{
+    // Producer and consumer on their own threads, both blocking through Parkers on a small ring
+    bool transfer(WaitStrategy strategy, uint64_t count)
+    {
+        SpscRing<uint64_t> ring(64);
+        Parker ready(strategy), space(strategy);
+        bool in_order = true;
+
+        std::thread consumer([&]
+                             {
+            for (uint64_t expected = 0; expected < count; ++expected)
+            {
+                uint64_t *value = nullptr;
+                ready.wait([&] { return (value = ring.front()) != nullptr; });
+                in_order = in_order && *value == expected;
+                ring.pop();
+                space.notify();
+            } });
+
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            uint64_t *slot = nullptr;
+            space.wait([&] { return (slot = ring.claim()) != nullptr; });
+            *slot = i;
+            ring.publish();
+            ready.notify();
+        }
+        consumer.join();
+        return in_order && ring.empty() && ring.published() == count;
+    }
+}
+
+int main()
+{
+    std::cout << "[TEST] Testing SPSC ring..." << std::endl;
+
+    // Test 1: Capacity, full and empty
+    {
+        SpscRing<int> ring(5);
+        check(ring.capacity() == 8, "capacity rounded up to a power of two");
+        check(ring.front() == nullptr && ring.empty(), "starts empty");
+
+        for (int i = 0; i < 8; ++i)
+            check(ring.try_push(i), "push while not full");
+        check(!ring.try_push(8) && ring.claim() == nullptr, "full ring refuses");
+        check(ring.size() == 8 && ring.high_water() == 8, "size and high water");
+
+        int value = -1;
+        check(ring.try_pop(value) && value == 0, "oldest first");
+        check(ring.try_push(8), "room after a pop");
+        for (int expected = 1; expected <= 8; ++expected)
+            check(ring.try_pop(value) && value == expected, "FIFO across the wrap");
+        check(!ring.try_pop(value) && ring.empty(), "drained");
+        check(ring.published() == 9, "published count");
+    }
+
+    // Test 2: In-place slots keep their buffers
+    {
+        SpscRing<std::string> ring(2);
+        std::string *slot = ring.claim();
+        slot->assign(1000, 'x');
+        ring.publish();
+        ring.pop();
+        ring.claim();
+        ring.publish();
+        ring.pop();
+        slot = ring.claim();
+        check(slot->capacity() >= 1000, "reused slot keeps its capacity");
+    }
+
+    // Test 3: Two threads, every wait strategy
+    {
+        // Spinning threads sharing one core only hand over when the scheduler preempts them
+        uint64_t spin_count = std::thread::hardware_concurrency() > 1 ? 200000 : 200;
+        check(transfer(WaitStrategy::SPIN, spin_count), "spin transfer in order");
+        check(transfer(WaitStrategy::YIELD, 200000), "yield transfer in order");
+        check(transfer(WaitStrategy::FUTEX, 200000), "futex transfer in order");
+    }
+
+    // Test 4: Strategy names
+    {
+        WaitStrategy strategy = WaitStrategy::SPIN;
+        check(parse_wait_strategy("futex", strategy) && strategy == WaitStrategy::FUTEX, "parse futex");
+        check(!parse_wait_strategy("sleep", strategy) && strategy == WaitStrategy::FUTEX, "unknown name rejected");
+        check(std::string(to_string(WaitStrategy::YIELD)) == "yield", "to_string");
+    }
+
+    // Test 5: Market events through a ring, snapshot book alongside
+    {
+        SpscRing<MarketEvent> events(4);
+
+        MarketTrade trade;
+        trade.instrument = 7;
+        trade.price = 101.5;
+        trade.trade_id = 42;
+        events.try_push(MarketEvent(trade));
+
+        MarketDepthUpdate update;
+        update.instrument = 7;
+        update.action = MarketDepthUpdate::Action::SNAPSHOT;
+        update.sequence = 9;
+        update.delta.type = BookDelta::Type::INSERT;
+        events.try_push(MarketEvent(update));
+
+        MarketEvent event;
+        check(events.try_pop(event) && event.type == MarketEvent::Type::TRADE && event.trade.price == 101.5 &&
+                  event.trade.trade_id == 42,
+              "trade round trip");
+        check(events.try_pop(event) && event.type == MarketEvent::Type::DEPTH, "depth event");
+
+        auto book = std::make_shared<const OrderBook>();
+        MarketDepthUpdate restored = event.depth_update(book);
+        check(restored.instrument == 7 && restored.action == MarketDepthUpdate::Action::SNAPSHOT && restored.sequence == 9 &&
+                  restored.delta.type == BookDelta::Type::INSERT && restored.book == book,
+              "depth round trip with the book reattached");
+    }
+
+    return test_support::finish("SPSC ring");
+}
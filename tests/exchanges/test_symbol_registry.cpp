@@ -0,0 +1,107 @@
+#include "coinbase_dtc_core/exchanges/base/symbol_registry.hpp"
+#include "test_support.hpp"
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace open_dtc_server::exchanges::base;
+using test_support::check;
+
+int main()
+{
+    std::cout << "[TEST] Testing symbol registry..." << std::endl;
+
+    // Interning
+    {
+        SymbolRegistry registry;
+        InstrumentId btc = registry.intern("coinbase", "BTC-USD", "BTC/USD");
+        InstrumentId eth = registry.intern("coinbase", "ETH-USD", "ETH/USD");
+        InstrumentId binance_btc = registry.intern("binance", "BTCUSDT", "BTC/USDT");
+
+        check(btc == 1 && eth == 2 && binance_btc == 3, "ids are dense from 1");
+        check(registry.intern("coinbase", "BTC-USD", "ignored") == btc, "intern is idempotent");
+        check(registry.intern("kraken", "BTC-USD", "BTC/USD") != btc, "same spelling on another exchange is distinct");
+        check(registry.size() == 4, "size counts instruments");
+        std::cout << "[OK] Interning" << std::endl;
+    }
+
+    // Lookup
+    {
+        SymbolRegistry registry;
+        InstrumentId btc = registry.intern("coinbase", "BTC-USD", "BTC/USD");
+
+        check(registry.find("coinbase", "BTC-USD") == btc, "find registered");
+        check(registry.find("coinbase", "SOL-USD") == NO_INSTRUMENT, "find unknown");
+        check(registry.size() == 1, "find does not register");
+
+        const Instrument *instrument = registry.get(btc);
+        check(instrument && instrument->id == btc, "get registered");
+        check(registry.exchange(btc) == "coinbase", "exchange");
+        check(registry.exchange_symbol(btc) == "BTC-USD", "exchange symbol");
+        check(registry.symbol(btc) == "BTC/USD", "normalized symbol");
+
+        check(registry.get(NO_INSTRUMENT) == nullptr && registry.get(99) == nullptr, "get unknown");
+        check(registry.exchange_symbol(99).empty() && registry.symbol(NO_INSTRUMENT).empty(), "unknown spellings empty");
+        std::cout << "[OK] Lookup" << std::endl;
+    }
+
+    // Capacity
+    {
+        SymbolRegistry registry;
+        for (size_t i = 0; i < SymbolRegistry::MAX_INSTRUMENTS; ++i)
+            registry.intern("test", std::to_string(i), std::to_string(i));
+        check(registry.size() == SymbolRegistry::MAX_INSTRUMENTS, "fills to capacity");
+        check(registry.intern("test", "overflow", "overflow") == NO_INSTRUMENT, "full registry refuses");
+        check(registry.intern("test", "0", "0") == 1, "existing still found when full");
+        std::cout << "[OK] Capacity" << std::endl;
+    }
+
+    // Per-feed instrument table
+    {
+        SymbolRegistry registry;
+        InstrumentTable table;
+        InstrumentId btc = registry.intern("coinbase", "BTC-USD", "BTC/USD");
+        InstrumentId eth = registry.intern("coinbase", "ETH-USD", "ETH/USD");
+
+        check(table.find("BTC-USD") == NO_INSTRUMENT, "empty table finds nothing");
+        check(table.add(registry.get(btc)) && table.add(registry.get(eth)), "products added");
+        check(table.add(registry.get(btc)) && table.size() == 2, "adding twice keeps one entry");
+        check(table.find("BTC-USD") == btc && table.find("ETH-USD") == eth, "products found");
+        check(table.find("BTC-USDC") == NO_INSTRUMENT && table.find("") == NO_INSTRUMENT, "other spellings not found");
+        check(!table.add(nullptr), "unregistered instrument refused");
+
+        // Concurrent adds of overlapping products leave one entry each
+        std::vector<InstrumentId> ids;
+        for (int i = 0; i < 1000; ++i)
+            ids.push_back(registry.intern("coinbase", "P" + std::to_string(i) + "-USD", "P" + std::to_string(i) + "/USD"));
+        InstrumentTable shared;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+            threads.emplace_back([&]
+                                 {
+                                     for (InstrumentId id : ids)
+                                         shared.add(registry.get(id)); });
+        for (auto &thread : threads)
+            thread.join();
+        bool all_found = shared.size() == ids.size();
+        for (InstrumentId id : ids)
+            all_found = all_found && shared.find(registry.exchange_symbol(id)) == id;
+        check(all_found, "concurrent adds found once each");
+
+        // Past three quarters full the table refuses and callers fall back to the registry
+        InstrumentTable full;
+        size_t added = 0;
+        for (size_t i = 0; i < InstrumentTable::CAPACITY; ++i)
+        {
+            InstrumentId id = registry.intern("full", std::to_string(i), std::to_string(i));
+            added += full.add(registry.get(id)) ? 1 : 0;
+        }
+        check(added == InstrumentTable::CAPACITY / 4 * 3 && full.size() == added, "table stops at three quarters");
+        check(full.find("0") != NO_INSTRUMENT && full.find(std::to_string(InstrumentTable::CAPACITY - 1)) == NO_INSTRUMENT,
+              "entries before the limit found, later ones not");
+        std::cout << "[OK] Instrument table" << std::endl;
+    }
+
+    return test_support::finish("Symbol registry");
+}
@@ -0,0 +1,80 @@
+#include "coinbase_dtc_core/exchanges/base/timestamp.hpp"
+#include "test_support.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <random>
+#include <string>
+
+using namespace open_dtc_server::exchanges::base;
+using test_support::check;
+
+namespace
+{
+    bool parses_to(const char *text, uint64_t expected)
+    {
+        uint64_t micros = 0;
+        return timestamp::parse_iso8601(text, micros) && micros == expected;
+    }
+}
+
+int main()
+{
+    std::cout << "[TEST] Testing exchange timestamps..." << std::endl;
+
+    // Exchange formats
+    {
+        check(parses_to("1970-01-01T00:00:00Z", 0), "epoch");
+        check(parses_to("2023-11-14T22:13:20Z", 1700000000000000ULL), "whole seconds");
+        check(parses_to("2023-11-14T22:13:20.123456Z", 1700000000123456ULL), "microseconds");
+        check(parses_to("2023-11-14T22:13:20.5Z", 1700000000500000ULL), "short fraction");
+        check(parses_to("2023-11-14T22:13:20.123456789Z", 1700000000123456ULL), "nanoseconds truncated");
+        check(parses_to("2023-11-14T23:13:20+01:00", 1700000000000000ULL), "positive offset");
+        check(parses_to("2023-11-14T21:43:20.25-00:30", 1700000000250000ULL), "negative offset");
+        check(parses_to("2024-02-29T00:00:00Z", 1709164800000000ULL), "leap day");
+        std::cout << "[OK] Exchange formats" << std::endl;
+    }
+
+    // Malformed input is rejected and leaves the output alone
+    {
+        uint64_t micros = 7;
+        check(!timestamp::parse_iso8601("", micros), "empty");
+        check(!timestamp::parse_iso8601("2023-11-14T22:13:20", micros), "missing zone");
+        check(!timestamp::parse_iso8601("2023-11-14T22:13:20.Z", micros), "empty fraction");
+        check(!timestamp::parse_iso8601("2023-13-14T22:13:20Z", micros), "month out of range");
+        check(!timestamp::parse_iso8601("2023-11-14T22:13:20Zx", micros), "trailing garbage");
+        check(!timestamp::parse_iso8601("1969-12-31T23:59:59Z", micros), "before epoch");
+        check(micros == 7, "output untouched on failure");
+        std::cout << "[OK] Malformed input" << std::endl;
+    }
+
+    // Agrees with timegm on random times
+    {
+        std::mt19937_64 rng(7);
+        int mismatches = 0;
+        char text[64];
+        for (int i = 0; i < 100000; ++i)
+        {
+            time_t seconds = static_cast<time_t>(rng() % 4102444800ULL); // Up to 2100
+            unsigned fraction = static_cast<unsigned>(rng() % 1000000);
+            std::tm tm{};
+#ifdef _WIN32
+            gmtime_s(&tm, &seconds);
+#else
+            gmtime_r(&seconds, &tm);
+#endif
+            size_t length = std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%S", &tm);
+            std::snprintf(text + length, sizeof(text) - length, ".%06uZ", fraction);
+
+            if (!parses_to(text, static_cast<uint64_t>(seconds) * 1000000 + fraction))
+                mismatches++;
+        }
+        check(mismatches == 0, "matches gmtime (" + std::to_string(mismatches) + " mismatches)");
+        std::cout << "[OK] Calendar conversion" << std::endl;
+    }
+
+    check(timestamp::now_us() > 1700000000000000ULL, "now in microseconds");
+
+    return test_support::finish("Timestamp");
+}
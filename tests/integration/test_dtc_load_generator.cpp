@@ -0,0 +1,269 @@
+#include "dtc_load_generator/dtc_load_generator.hpp"
+#include "coinbase_dtc_core/core/dtc/protocol.hpp"
+#include "test_support.hpp"
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace open_dtc_server;
+using namespace open_dtc_server::loadgen;
+namespace dtc = open_dtc_server::core::dtc;
+using test_support::check;
+
+namespace
+{
+    uint64_t now_microseconds()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+
+    void send_all(int fd, const std::vector<uint8_t> &bytes)
+    {
+        size_t offset = 0;
+        while (offset < bytes.size())
+        {
+            ssize_t sent = ::send(fd, bytes.data() + offset, bytes.size() - offset, MSG_NOSIGNAL);
+            if (sent <= 0)
+                return;
+            offset += static_cast<size_t>(sent);
+        }
+    }
+
+    /**
+     * Minimal DTC responder: accepts logons and subscriptions and streams
+     * microsecond-stamped trade updates to every subscribed client.
+     */
+    class FakeDTCServer
+    {
+    public:
+        bool start()
+        {
+            listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+            int one = 1;
+            setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port = 0;
+            if (::bind(listen_fd_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+                ::listen(listen_fd_, 128) < 0)
+                return false;
+            socklen_t length = sizeof(address);
+            getsockname(listen_fd_, reinterpret_cast<sockaddr *>(&address), &length);
+            port_ = ntohs(address.sin_port);
+            running_ = true;
+            thread_ = std::thread(&FakeDTCServer::loop, this);
+            return true;
+        }
+
+        void stop()
+        {
+            running_ = false;
+            if (thread_.joinable())
+                thread_.join();
+            for (auto &client : clients_)
+                ::close(client.fd);
+            ::close(listen_fd_);
+        }
+
+        uint16_t port() const { return port_; }
+        std::atomic<int> logons{0};
+        std::atomic<int> subscriptions{0};
+
+    private:
+        struct Client
+        {
+            int fd;
+            std::vector<uint8_t> input;
+            std::vector<uint16_t> symbol_ids;
+        };
+
+        void loop()
+        {
+            auto next_trade = std::chrono::steady_clock::now();
+            while (running_)
+            {
+                std::vector<pollfd> fds{{listen_fd_, POLLIN, 0}};
+                for (auto &client : clients_)
+                    fds.push_back({client.fd, POLLIN, 0});
+                ::poll(fds.data(), fds.size(), 1);
+
+                if (fds[0].revents & POLLIN)
+                {
+                    int fd = ::accept(listen_fd_, nullptr, nullptr);
+                    if (fd >= 0)
+                        clients_.push_back({fd, {}, {}});
+                }
+                for (size_t i = 1; i < fds.size(); i++)
+                {
+                    if (fds[i].revents & POLLIN)
+                        read_client(clients_[i - 1]);
+                }
+
+                // One trade per subscription every millisecond
+                if (std::chrono::steady_clock::now() >= next_trade)
+                {
+                    next_trade += std::chrono::milliseconds(1);
+                    for (auto &client : clients_)
+                    {
+                        for (uint16_t symbol_id : client.symbol_ids)
+                        {
+                            dtc::MarketDataUpdateTrade trade;
+                            trade.symbol_id = symbol_id;
+                            trade.price = 50000.0;
+                            trade.volume = 0.1;
+                            trade.date_time = now_microseconds();
+                            send_all(client.fd, trade.serialize());
+                        }
+                    }
+                }
+            }
+        }
+
+        void read_client(Client &client)
+        {
+            uint8_t buffer[4096];
+            ssize_t received = ::recv(client.fd, buffer, sizeof(buffer), 0);
+            if (received <= 0)
+                return;
+            client.input.insert(client.input.end(), buffer, buffer + received);
+
+            while (client.input.size() >= sizeof(dtc::MessageHeader))
+            {
+                auto *header = reinterpret_cast<const dtc::MessageHeader *>(client.input.data());
+                if (client.input.size() < header->size)
+                    break;
+
+                if (header->type == static_cast<uint16_t>(dtc::MessageType::LOGON_REQUEST))
+                {
+                    logons++;
+                    dtc::LogonResponse response;
+                    response.result = 1;
+                    send_all(client.fd, response.serialize());
+                }
+                else if (header->type == static_cast<uint16_t>(dtc::MessageType::MARKET_DATA_REQUEST))
+                {
+                    dtc::MarketDataRequest request;
+                    request.deserialize(client.input.data(), header->size);
+                    subscriptions++;
+
+                    dtc::MarketDataResponse response;
+                    response.symbol_id = request.symbol_id;
+                    response.symbol = request.symbol;
+                    response.exchange = request.exchange;
+                    response.result = 1;
+                    send_all(client.fd, response.serialize());
+                    client.symbol_ids.push_back(request.symbol_id);
+                }
+                client.input.erase(client.input.begin(), client.input.begin() + header->size);
+            }
+        }
+
+        int listen_fd_ = -1;
+        uint16_t port_ = 0;
+        std::atomic<bool> running_{false};
+        std::thread thread_;
+        std::vector<Client> clients_;
+    };
+}
+
+int main()
+{
+    std::cout << "[TEST] Testing DTC load generator..." << std::endl;
+
+    // Test 1: Histogram percentiles stay within the sub-bucket resolution
+    {
+        LatencyHistogram histogram;
+        for (uint64_t value = 1; value <= 100000; value++)
+            histogram.record(value);
+
+        auto within = [](uint64_t actual, uint64_t expected)
+        { return actual >= expected && actual <= expected + expected / 100; };
+        check(histogram.count() == 100000 && histogram.max() == 100000, "count and max");
+        check(within(histogram.percentile(50.0), 50000), "p50");
+        check(within(histogram.percentile(99.0), 99000), "p99");
+        check(within(histogram.percentile(99.9), 99900), "p999");
+        check(histogram.percentile(100.0) == 100000, "p100 is the max");
+
+        LatencyHistogram small;
+        small.record(7);
+        small.merge(histogram);
+        check(small.count() == 100001 && small.percentile(0.0) == 1, "merge");
+        std::cout << "[OK] Histogram" << std::endl;
+    }
+
+    // Test 2: Symbol mix parsing and validation
+    {
+        std::vector<std::pair<std::string, uint32_t>> symbols;
+        check(LoadGenerator::parse_symbol_mix("BTC-USD:3,ETH-USD", symbols) && symbols.size() == 2 &&
+                  symbols[0].second == 3 && symbols[1].second == 1,
+              "weighted mix parsed");
+        check(!LoadGenerator::parse_symbol_mix("BTC-USD:x", symbols), "bad weight rejected");
+        check(!LoadGenerator::parse_symbol_mix("", symbols), "empty mix rejected");
+        std::cout << "[OK] Symbol mix" << std::endl;
+    }
+
+    // Test 3: Swarm against a local responder
+    {
+        FakeDTCServer server;
+        check(server.start(), "responder starts");
+
+        LoadGeneratorConfig config;
+        config.port = server.port();
+        config.sessions = 20;
+        config.threads = 2;
+        config.symbol_mix = "BTC-USD:3,ETH-USD:1";
+        config.symbols_per_session = 2;
+        config.connect_rate = 0;
+        config.duration_seconds = 1;
+
+        LoadGenerator generator(config);
+        LoadReport report = generator.run();
+        server.stop();
+
+        check(report.sessions_connected == 20 && report.sessions_logged_on == 20, "all sessions logged on");
+        check(server.logons == 20 && report.subscriptions_accepted == 40, "every session subscribed to two symbols");
+        check(report.dropped_connections == 0 && report.connect_failures == 0, "no failures");
+        check(report.trade_updates > 1000 && report.latency_us.count() == report.trade_updates, "trades timed");
+        check(report.timestamp_resolution == "microseconds", "microsecond timestamps detected");
+        check(report.messages_per_second > 0, "rate computed");
+
+        auto json = nlohmann::json::parse(report.to_json());
+        check(json["sessions_logged_on"] == 20 && json["latency_us"]["samples"] == report.latency_us.count(),
+              "report JSON parses");
+        std::cout << "[OK] Swarm (" << report.trade_updates << " trades, p99 "
+                  << report.latency_us.percentile(99.0) << "us)" << std::endl;
+    }
+
+    // Test 4: Unreachable server counts connect failures
+    {
+        FakeDTCServer server;
+        server.start();
+        uint16_t closed_port = server.port();
+        server.stop();
+
+        LoadGeneratorConfig config;
+        config.port = closed_port;
+        config.sessions = 5;
+        config.threads = 1;
+        config.connect_rate = 0;
+        config.duration_seconds = 1;
+        LoadReport report = LoadGenerator(config).run();
+        check(report.connect_failures == 5 && report.sessions_connected == 0, "refused connections counted");
+        std::cout << "[OK] Connect failures" << std::endl;
+    }
+
+    return test_support::finish("DTC load generator");
+}
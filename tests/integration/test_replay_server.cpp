@@ -0,0 +1,170 @@
+#include "coinbase_dtc_core/core/server/server.hpp"
+#include "coinbase_dtc_core/core/dtc/protocol.hpp"
+#include "coinbase_dtc_core/exchanges/base/market_journal.hpp"
+#include "test_support.hpp"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace open_dtc_server;
+namespace dtc = open_dtc_server::core::dtc;
+using test_support::check;
+
+namespace
+{
+    // 80 BTC-USD trades 50 ms apart: the replay is still running when the client subscribes
+    void record_session(const std::string &directory)
+    {
+        exchanges::base::JournalConfig config;
+        config.directory = directory;
+        config.sync_policy = exchanges::base::JournalConfig::SyncPolicy::NONE;
+        exchanges::base::MarketJournal journal(config);
+        journal.open();
+
+        auto btc = exchanges::base::SymbolRegistry::getInstance().intern("coinbase", "BTC-USD", "BTC/USD");
+        const uint64_t start = 1700000000000000ULL;
+        for (int i = 0; i < 80; ++i)
+        {
+            exchanges::base::MarketTrade trade;
+            trade.instrument = btc;
+            trade.price = 100.0 + i;
+            trade.volume = 1.0;
+            trade.side = exchanges::base::TradeSide::BUY;
+            trade.exchange_time_us = start + i * 50000;
+            journal.record_trade(trade);
+        }
+    }
+
+    bool send_all(int fd, const std::vector<uint8_t> &bytes)
+    {
+        size_t offset = 0;
+        while (offset < bytes.size())
+        {
+            ssize_t sent = ::send(fd, bytes.data() + offset, bytes.size() - offset, MSG_NOSIGNAL);
+            if (sent <= 0)
+                return false;
+            offset += static_cast<size_t>(sent);
+        }
+        return true;
+    }
+
+    /** Reads whole DTC messages until one of the wanted type arrives or the deadline passes */
+    class MessageReader
+    {
+    public:
+        explicit MessageReader(int fd) : fd_(fd) {}
+
+        bool wait_for(dtc::MessageType type, std::vector<uint8_t> &message, std::chrono::steady_clock::time_point deadline)
+        {
+            while (std::chrono::steady_clock::now() < deadline)
+            {
+                while (buffer_.size() >= sizeof(dtc::MessageHeader))
+                {
+                    dtc::MessageHeader header;
+                    std::memcpy(&header, buffer_.data(), sizeof(header));
+                    if (header.size < sizeof(header) || buffer_.size() < header.size)
+                        break;
+                    std::vector<uint8_t> next(buffer_.begin(), buffer_.begin() + header.size);
+                    buffer_.erase(buffer_.begin(), buffer_.begin() + header.size);
+                    if (static_cast<dtc::MessageType>(header.type) == type)
+                    {
+                        message = std::move(next);
+                        return true;
+                    }
+                }
+
+                pollfd readable{fd_, POLLIN, 0};
+                if (poll(&readable, 1, 50) <= 0)
+                    continue;
+                uint8_t chunk[4096];
+                ssize_t received = ::recv(fd_, chunk, sizeof(chunk), 0);
+                if (received <= 0)
+                    return false;
+                buffer_.insert(buffer_.end(), chunk, chunk + received);
+            }
+            return false;
+        }
+
+    private:
+        int fd_;
+        std::vector<uint8_t> buffer_;
+    };
+}
+
+int main()
+{
+    std::cout << "[TEST] Testing DTC server on a replayed session..." << std::endl;
+
+    auto journal_dir = std::filesystem::temp_directory_path() / "test_replay_server_journal";
+    std::filesystem::remove_all(journal_dir);
+    record_session(journal_dir.string());
+
+    coinbase_dtc_core::core::server::ServerConfig config;
+    config.bind_address = "127.0.0.1";
+    config.port = 11397;
+    config.enable_order_entry = false;
+    config.enable_order_tracking = false;
+    config.enable_historical_data = false;
+    config.credentials_file_path = "";
+
+    coinbase_dtc_core::core::server::DTCServer server(config);
+    check(server.start(), "server starts");
+
+    exchanges::base::ExchangeConfig replay_config;
+    replay_config.name = "replay";
+    replay_config.replay_path = journal_dir.string();
+    replay_config.replay_speed = 1.0;
+    check(server.add_exchange(replay_config), "replay feed added");
+
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(config.port);
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+    bool connected = ::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0;
+    check(connected, "client connects");
+
+    if (connected)
+    {
+        MessageReader reader(fd);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+        std::vector<uint8_t> message;
+
+        dtc::LogonRequest logon;
+        logon.client_name = "replay-test";
+        check(send_all(fd, logon.serialize()), "logon sent");
+        check(reader.wait_for(dtc::MessageType::LOGON_RESPONSE, message, deadline), "logon response");
+
+        // The client names the live exchange; the replay is the only feed, so it serves the request
+        dtc::MarketDataRequest request;
+        request.request_action = dtc::RequestAction::SUBSCRIBE;
+        request.symbol_id = 7;
+        request.symbol = "BTC-USD";
+        request.exchange = "coinbase";
+        check(send_all(fd, request.serialize()), "subscription sent");
+        check(reader.wait_for(dtc::MessageType::MARKET_DATA_RESPONSE, message, deadline), "subscription accepted");
+
+        dtc::MarketDataUpdateTrade trade;
+        bool traded = reader.wait_for(dtc::MessageType::MARKET_DATA_UPDATE_TRADE, message, deadline) &&
+                      trade.deserialize(message.data(), static_cast<uint16_t>(message.size()));
+        check(traded, "replayed trade delivered");
+        check(!traded || (trade.symbol_id == 7 && trade.price >= 100.0 && trade.price < 180.0), "trade carries the client's symbol ID");
+        if (traded)
+            std::cout << "[OK] Replayed trade at " << trade.price << " for symbol ID " << trade.symbol_id << std::endl;
+    }
+
+    ::close(fd);
+    server.stop();
+    std::filesystem::remove_all(journal_dir);
+
+    return test_support::finish("Replay server");
+}
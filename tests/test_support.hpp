@@ -0,0 +1,35 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+
+/**
+ * Helpers shared by the main()-based tests. A failed check prints an [ERROR]
+ * line and is counted; finish() reports the suite and gives main its exit code.
+ */
+namespace test_support
+{
+    inline int failures = 0;
+
+    inline void check(bool condition, const std::string &what)
+    {
+        if (!condition)
+        {
+            std::cout << "[ERROR] " << what << std::endl;
+            failures++;
+        }
+    }
+
+    /** @return 0 when every check passed, 1 otherwise */
+    inline int finish(const std::string &suite)
+    {
+        if (failures > 0)
+        {
+            std::cout << "[ERROR] " << suite << " tests failed: " << failures << std::endl;
+            return 1;
+        }
+
+        std::cout << "[SUCCESS] " << suite << " tests passed!" << std::endl;
+        return 0;
+    }
+}